@@ -36,6 +36,12 @@
 #include <errno.h>
 #include <unistd.h>
 #include <assert.h>
+#include <limits.h>
+#include <poll.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include "fpga_dma_internal.h"
 #include "fpga_dma.h"
 #include "tbb/concurrent_queue.h"
@@ -328,6 +334,7 @@ static void assign_hw_desc(msgdma_sw_desc_t *sw_desc,
 		hw_descp->hw_desc->ctrl.generate_eop = 0;
 	}
 	hw_descp->hw_desc->ctrl.go = 1;
+	hw_descp->hw_desc->ctrl.transfer_irq_en = 0;
 	if (set_owned_by_hw)
 		hw_descp->hw_desc->owned_by_hw = 1;
 	else
@@ -379,6 +386,128 @@ static fpga_result destroy_sw_desc(msgdma_sw_desc *sw_desc) {
 	return FPGA_OK;
 }
 
+// Wait strategies
+static inline void dma_cpu_relax(void)
+{
+	__asm__ __volatile__("pause\n" : : : "memory");
+}
+
+// Wake the worker, if any, sleeping on bell. Called after each push
+// to the queue that bell guards.
+static void dma_ring(dma_doorbell_t *bell)
+{
+	__atomic_add_fetch(&bell->seq, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&bell->sleepers, __ATOMIC_SEQ_CST))
+		syscall(SYS_futex, &bell->seq, FUTEX_WAKE_PRIVATE, INT_MAX,
+			NULL, NULL, 0);
+}
+
+// Poll ready() with pause, then with sched_yield(). Returns true as
+// soon as ready() holds, false if it still doesn't after both phases.
+template <typename Ready>
+static bool dma_spin_then_yield(Ready ready)
+{
+	int i;
+
+	for (i = 0; i < FPGA_DMA_SPIN_ITERS; i++) {
+		if (ready())
+			return true;
+		dma_cpu_relax();
+	}
+
+	for (i = 0; i < FPGA_DMA_YIELD_ITERS; i++) {
+		if (ready())
+			return true;
+		sched_yield();
+	}
+
+	return ready();
+}
+
+// Wait until ready() holds. ready() must become true only after a
+// push to the queue guarded by bell.
+template <typename Ready>
+static void dma_wait(fpga_dma_handle_t dma_h, dma_doorbell_t *bell, Ready ready)
+{
+	if (dma_h->wait_mode == FPGA_DMA_WAIT_SPIN) {
+		while (!ready());
+		return;
+	}
+
+	if (dma_spin_then_yield(ready))
+		return;
+
+	while (!ready()) {
+		uint32_t seq = __atomic_load_n(&bell->seq, __ATOMIC_SEQ_CST);
+
+		__atomic_add_fetch(&bell->sleepers, 1, __ATOMIC_SEQ_CST);
+		if (!ready())
+			syscall(SYS_futex, &bell->seq, FUTEX_WAIT_PRIVATE, seq,
+				NULL, NULL, 0);
+		__atomic_sub_fetch(&bell->sleepers, 1, __ATOMIC_SEQ_CST);
+	}
+}
+
+// Block for up to FPGA_DMA_INTR_POLL_MSEC on the channel interrupt.
+static fpga_result dma_wait_intr(fpga_dma_handle_t dma_h)
+{
+	struct pollfd pfd;
+	fpga_result res;
+	int poll_res;
+
+	memset(&pfd, 0, sizeof(pfd));
+	res = fpgaGetOSObjectFromEventHandle(dma_h->eh, &pfd.fd);
+	ON_ERR_RETURN(res, "fpgaGetOSObjectFromEventHandle");
+
+	pfd.events = POLLIN;
+	poll_res = poll(&pfd, 1, FPGA_DMA_INTR_POLL_MSEC);
+	if (poll_res < 0)
+		return FPGA_EXCEPTION;
+
+	if (poll_res > 0) {
+		uint64_t count = 0;
+		msgdma_status_t status;
+
+		if (read(pfd.fd, &count, sizeof(count)) < 0)
+			return FPGA_EXCEPTION;
+
+		// clear interrupt by writing 1 to IRQ bit in status register
+		status.reg = 0;
+		status.st.irq = 1;
+		return MMIOWrite32Blk(dma_h, CSR_STATUS(dma_h),
+				      (uint64_t)&status.reg, sizeof(status.reg));
+	}
+
+	return FPGA_OK;
+}
+
+// Wait until the hardware hands hw_desc back to software.
+static void dma_wait_hw(fpga_dma_handle_t dma_h, msgdma_hw_desc_t *hw_desc)
+{
+	long nsec = FPGA_DMA_BACKOFF_MIN_NSEC;
+	auto released = [hw_desc]() { return hw_desc->owned_by_hw != 1; };
+
+	if (dma_h->wait_mode == FPGA_DMA_WAIT_SPIN) {
+		while (!released());
+		return;
+	}
+
+	if (dma_spin_then_yield(released))
+		return;
+
+	while (!released()) {
+		if (dma_h->wait_mode == FPGA_DMA_WAIT_INTERRUPT &&
+		    dma_h->intr_enabled &&
+		    dma_wait_intr(dma_h) == FPGA_OK)
+			continue;
+
+		struct timespec ts = { 0, nsec };
+		nanosleep(&ts, NULL);
+		if (nsec < FPGA_DMA_BACKOFF_MAX_NSEC)
+			nsec <<= 1;
+	}
+}
+
 // debug utilities
 #if FPGA_DMA_DEBUG
 static void dump_hw_desc(int i, msgdma_hw_desc_t *desc)
@@ -464,11 +593,13 @@ static void *dispatcherWorker(void* dma_handle) {
 	debug_print("started dispatcher worker\n");
 	while (1) {
 		// wait for a valid transfer
-		while(dma_h->ingress_queue.empty());
+		dma_wait(dma_h, &dma_h->ingress_bell,
+			 [dma_h]() { return !dma_h->ingress_queue.empty(); });
 		if (dma_h->ingress_queue.try_pop(sw_desc[desc_count])) {
 			if (sw_desc[desc_count]->kill_worker) {
 				disp_log.close();
 				dma_h->pending_queue.push(sw_desc[desc_count]);
+				dma_ring(&dma_h->pending_bell);
 				debug_print("Killing worker\n");
 				break;
 			}
@@ -491,7 +622,8 @@ static void *dispatcherWorker(void* dma_handle) {
 			
 			// assign a free hardware descriptor to this transfer
 			// if a free descriptor isn't available, wait here
-			while(dma_h->free_desc.empty());
+			dma_wait(dma_h, &dma_h->free_bell,
+				 [dma_h]() { return !dma_h->free_desc.empty(); });
 			dma_h->free_desc.try_pop(hw_descp);
 
 			sw_desc[desc_count]->id = desc_count;
@@ -502,6 +634,10 @@ static void *dispatcherWorker(void* dma_handle) {
 				sw_desc[desc_count]->transfer->is_last_buf /*app. requested block dispatch for this transfer*/
 				) {
 
+				// in interrupt mode, ask for an interrupt when the block completes
+				sw_desc[desc_count]->hw_descp->hw_desc->ctrl.transfer_irq_en =
+					(dma_h->wait_mode == FPGA_DMA_WAIT_INTERRUPT) ? 1 : 0;
+
 				first_sw_desc->hw_descp->hw_desc->block_size = desc_count - 1;
 				first_sw_desc->hw_descp->hw_desc->owned_by_hw = 1;
 
@@ -513,11 +649,13 @@ static void *dispatcherWorker(void* dma_handle) {
 						sw_desc[k]->last = 1;
 					dma_h->pending_queue.push(sw_desc[k]);
 				}
+				dma_ring(&dma_h->pending_bell);
 
 				// Skip invalid descriptors
 				for(k=1; k<= (FPGA_DMA_BLOCK_SIZE-desc_count); k++) {
 					msgdma_hw_descp_t *unused_hw_descp = nullptr;
-					while(dma_h->free_desc.empty());
+					dma_wait(dma_h, &dma_h->free_bell,
+						 [dma_h]() { return !dma_h->free_desc.empty(); });
 					dma_h->free_desc.try_pop(unused_hw_descp);
 					dump_hw_desc_log(0, unused_hw_descp->hw_desc, disp_log);
 					dma_h->invalid_desc_queue.push(unused_hw_descp);
@@ -548,11 +686,12 @@ static void *completionWorker(void* dma_handle) {
 
 	debug_print("started completion worker\n");
 	while (1) {
-		while(dma_h->pending_queue.empty());
+		dma_wait(dma_h, &dma_h->pending_bell,
+			 [dma_h]() { return !dma_h->pending_queue.empty(); });
 		if (dma_h->pending_queue.try_pop(sw_desc)) {
 			if (sw_desc->kill_worker)
 				break;
-			while(sw_desc->hw_descp->hw_desc->owned_by_hw == 1);
+			dma_wait_hw(dma_h, sw_desc->hw_descp->hw_desc);
 			sw_desc->hw_descp->hw_desc->owned_by_hw = 0;
 
 			// return hw_descp to free pool
@@ -565,6 +704,7 @@ static void *completionWorker(void* dma_handle) {
 					dma_h->free_desc.push(unused_hw_descp);
 				}
 			}
+			dma_ring(&dma_h->free_bell);
 
 			if (sw_desc->transfer->cb) {
 				fpga_dma_transfer_status_t status;
@@ -695,6 +835,9 @@ fpga_result fpgaDMAOpen(fpga_handle fpga, uint64_t dma_channel_index, fpga_dma_h
 	dma_h->fpga_h = fpga;
 	dma_h->mmio_num = 0;
 	dma_h->mmio_offset = 0;
+	dma_h->wait_mode = FPGA_DMA_WAIT_ADAPTIVE;
+	dma_h->eh = NULL;
+	dma_h->intr_enabled = false;
 
 #ifndef USE_ASE
 	res = fpgaMapMMIO(dma_h->fpga_h, 0, (uint64_t **)&dma_h->mmio_va);
@@ -864,6 +1007,7 @@ fpga_result fpgaDMAOpen(fpga_handle fpga, uint64_t dma_channel_index, fpga_dma_h
 			ON_ERR_GOTO(FPGA_NO_MEMORY, rel_buf, "init sw desc");
 		sw_desc->kill_worker = true;
 		dma_h->ingress_queue.push(sw_desc);
+		dma_ring(&dma_h->ingress_bell);
 
 		// wait workers to die
 		if (pthread_join(dma_h->ingress_id, &th_retval))
@@ -957,6 +1101,7 @@ fpga_result fpgaDMAClose(fpga_dma_handle_t dma_h) {
 	}
 	sw_desc->kill_worker = true;
 	dma_h->ingress_queue.push(sw_desc);
+	dma_ring(&dma_h->ingress_bell);
 
 	// wait workers to die
 	if (pthread_join(dma_h->ingress_id, &th_retval)) {
@@ -968,6 +1113,15 @@ fpga_result fpgaDMAClose(fpga_dma_handle_t dma_h) {
 	}
 	fpgaDMATransferDestroy(&dummy_transfer);
 
+	if (dma_h->eh) {
+		res = fpgaUnregisterEvent(dma_h->fpga_h, FPGA_EVENT_INTERRUPT, dma_h->eh);
+		if (res != FPGA_OK)
+			FPGA_DMA_ERR("fpgaUnregisterEvent");
+		res = fpgaDestroyEventHandle(&dma_h->eh);
+		if (res != FPGA_OK)
+			FPGA_DMA_ERR("fpgaDestroyEventHandle");
+	}
+
 	// stop dispatcher
 	msgdma_ctrl_t ctrl;
 	ctrl = {0};
@@ -1030,6 +1184,54 @@ fpga_result fpgaGetDMAChannelType(fpga_dma_handle_t dma, fpga_dma_channel_type_t
 	return FPGA_OK;
 }
 
+fpga_result fpgaDMASetWaitMode(fpga_dma_handle_t dma, fpga_dma_wait_mode_t mode) {
+	fpga_result res = FPGA_OK;
+	msgdma_ctrl_t ctrl;
+
+	if (!dma) {
+		FPGA_DMA_ERR("Invalid DMA handle");
+		return FPGA_INVALID_PARAM;
+	}
+
+	if (mode != FPGA_DMA_WAIT_SPIN &&
+	    mode != FPGA_DMA_WAIT_ADAPTIVE &&
+	    mode != FPGA_DMA_WAIT_INTERRUPT) {
+		FPGA_DMA_ERR("Invalid wait mode");
+		return FPGA_INVALID_PARAM;
+	}
+
+	// The interrupt stays registered until fpgaDMAClose(), so that
+	// a worker blocked on it is never left polling a stale event.
+	if (mode == FPGA_DMA_WAIT_INTERRUPT && !dma->intr_enabled) {
+		res = fpgaCreateEventHandle(&dma->eh);
+		ON_ERR_RETURN(res, "fpgaCreateEventHandle");
+
+		res = fpgaRegisterEvent(dma->fpga_h, FPGA_EVENT_INTERRUPT, dma->eh,
+					(uint32_t)dma->dma_channel);
+		if (res != FPGA_OK) {
+			FPGA_DMA_ERR("fpgaRegisterEvent");
+			fpgaDestroyEventHandle(&dma->eh);
+			return res;
+		}
+
+		// turn on global interrupts
+		ctrl = {0};
+		ctrl.ct.global_intr_en_mask = 1;
+		res = MMIOWrite32Blk(dma, CSR_CONTROL(dma), (uint64_t)&ctrl.reg, sizeof(ctrl.reg));
+		if (res != FPGA_OK) {
+			FPGA_DMA_ERR("MMIOWrite32Blk");
+			fpgaUnregisterEvent(dma->fpga_h, FPGA_EVENT_INTERRUPT, dma->eh);
+			fpgaDestroyEventHandle(&dma->eh);
+			return res;
+		}
+
+		dma->intr_enabled = true;
+	}
+
+	dma->wait_mode = mode;
+	return FPGA_OK;
+}
+
 fpga_result fpgaDMATransferInit(fpga_dma_transfer_t *transfer_p) {
 	fpga_result res = FPGA_OK;
 	fpga_dma_transfer_t tmp;
@@ -1389,6 +1591,7 @@ fpga_result fpgaDMATransfer(fpga_dma_handle_t dma, fpga_dma_transfer_t transfer)
 	if (!sw_desc)
 		return FPGA_EXCEPTION;
 	dma->ingress_queue.push(sw_desc);
+	dma_ring(&dma->ingress_bell);
 
 	// Blocking transfer
 	if (!sw_desc->transfer->cb) {
@@ -1432,6 +1635,7 @@ fpga_result fpgaDMAInvalidate(fpga_dma_handle_t dma) {
 
 	// reenable dispatcher
 	ctrl = {0};
+	ctrl.ct.global_intr_en_mask = dma->intr_enabled ? 1 : 0;
 	res = MMIOWrite32Blk(dma, CSR_CONTROL(dma), (uint64_t)&ctrl.reg, sizeof(ctrl.reg));
 	return res;
 }
@@ -93,6 +93,29 @@ fpga_result fpgaDMAClose(fpga_dma_handle_t dma);
 */
 fpga_result fpgaGetDMAChannelType(fpga_dma_handle_t dma, fpga_dma_channel_type_t *ch_type);
 
+/**
+* fpgaDMASetWaitMode
+*
+* @brief                  Select how the channel's worker threads wait
+*
+*                         FPGA_DMA_WAIT_SPIN busy-polls the channel's queues
+*                         and descriptors, occupying a core per worker thread
+*                         even when the channel is idle. FPGA_DMA_WAIT_ADAPTIVE
+*                         (the default) spins briefly, then yields, then sleeps
+*                         until new work is queued or, for hardware completions,
+*                         polls with exponential backoff. FPGA_DMA_WAIT_INTERRUPT
+*                         behaves like FPGA_DMA_WAIT_ADAPTIVE, but hardware
+*                         completions are awaited on the channel's DMA interrupt,
+*                         whose vector is the channel index.
+*
+* @param[in]  dma         DMA channel handle
+* @param[in]  mode        Wait mode
+* @returns                FPGA_OK on success, return code otherwise. When the
+*                         interrupt cannot be registered, the previous mode is
+*                         kept and the error is returned.
+*/
+fpga_result fpgaDMASetWaitMode(fpga_dma_handle_t dma, fpga_dma_wait_mode_t mode);
+
 /**
 * fpgaDMATransferInit
 *
@@ -119,6 +119,16 @@ using namespace tbb;
 
 #define HOST_MEM_MASK(dma_h) (dma_h->ch_type == MM ? 0x1000000000000 : 0x0)
 
+// Adaptive wait: pause-spin iterations, then sched_yield() iterations,
+// before a worker sleeps. Hardware completion polling backs off from
+// FPGA_DMA_BACKOFF_MIN_NSEC up to FPGA_DMA_BACKOFF_MAX_NSEC per sleep.
+#define FPGA_DMA_SPIN_ITERS 4096
+#define FPGA_DMA_YIELD_ITERS 64
+#define FPGA_DMA_BACKOFF_MIN_NSEC 1000
+#define FPGA_DMA_BACKOFF_MAX_NSEC 64000
+// Upper bound on one interrupt wait, after which the descriptor is re-polled
+#define FPGA_DMA_INTR_POLL_MSEC 10
+
 // Convenience macros
 #ifdef FPGA_DMA_DEBUG
 #define debug_print(fmt, ...) \
@@ -324,6 +334,14 @@ typedef struct msgdma_hw_descp {
 	msgdma_hw_desc_t *hw_desc; // ptr to desc in hw chain
 } msgdma_hw_descp_t;
 
+// Wakes a worker sleeping until a host-side queue becomes non-empty.
+// The producer bumps seq after each push; a sleeping consumer waits on
+// seq with futex(2) and is woken only when sleepers is non-zero.
+typedef struct {
+	volatile uint32_t seq;
+	volatile uint32_t sleepers;
+} dma_doorbell_t;
+
 // Software descriptor
 typedef struct msgdma_sw_desc {
 	uint64_t id;
@@ -351,6 +369,12 @@ struct fpga_dma_handle {
 	concurrent_queue<struct msgdma_sw_desc*> pending_queue;	
 	concurrent_queue<struct msgdma_hw_descp*> free_desc;
 	concurrent_queue<struct msgdma_hw_descp*> invalid_desc_queue;
+	dma_doorbell_t ingress_bell;
+	dma_doorbell_t pending_bell;
+	dma_doorbell_t free_bell;
+	volatile fpga_dma_wait_mode_t wait_mode;
+	fpga_event_handle eh;
+	volatile bool intr_enabled;
 	// channel type
 	fpga_dma_channel_type_t ch_type;
         #define INVALID_CHANNEL (0x7fffffffffffffffULL)
@@ -56,7 +56,7 @@ static void printUsage()
 "     fpga_dma_test [-h] [-B <bus>] [-D <device>] [-F <function>] [-S <segment>]\n"
 "                   -l <loopback on/off> -s <data size (bytes)> -p <payload size (bytes)>\n"
 "                   -r <transfer direction> -t <transfer type> [-f <decimation factor>]\n"
-"                   -a <FPGA local memory address>\n\n"
+"                   -a <FPGA local memory address> [-w <wait mode>]\n\n"
 "         -h,--help           Print this help\n"
 "         -v,--version        Print version and exit\n"
 "         -B,--bus            Set target bus number\n"
@@ -65,6 +65,10 @@ static void printUsage()
 "         -S,--segment        Set PCIe segment\n"
 "         -s,--data_size      Total data size\n"
 "         -p,--payload_size   Payload size per DMA transfer\n"
+"         -w,--wait_mode      How DMA worker threads wait (default adaptive)\n"
+"            spin             Busy-poll\n"
+"            adaptive         Spin, then yield, then sleep\n"
+"            interrupt        As adaptive, but block on the DMA interrupt\n"
 "         -r,--direction      Transfer direction\n"
 "            mtos             Memory to stream (valid for streaming DMA)\n"
 "            stom             Stream to memory (valid for streaming DMA)\n"
@@ -105,13 +109,14 @@ static void parse_args(struct config *config, int argc, char *argv[])
 			{"loopback", required_argument, 0, 'l'},
 			{"decim_factor", required_argument, 0, 'f'},
 			{"fpga_addr", required_argument, 0, 'a'},
+			{"wait_mode", required_argument, 0, 'w'},
       {"version", no_argument, 0, 'v'},
 			{0, 0, 0, 0}
 		};
 		char *endptr;
 		const char *tmp_optarg;
 
-		c = getopt_long(argc, argv, "hB:D:F:S:s:p:r:l:f:t:a:v", options, NULL);
+		c = getopt_long(argc, argv, "hB:D:F:S:s:p:r:l:f:t:a:w:v", options, NULL);
 		if (c == -1) {
 			break;
 		}
@@ -258,6 +263,22 @@ static void parse_args(struct config *config, int argc, char *argv[])
 			debug_print("fpga local memory address = %lx\n", (uint64_t)config->fpga_addr);
 			break;
 
+		case 'w':    /* wait mode */
+			if (NULL == tmp_optarg)
+				break;
+			if (!STR_CONST_CMP(tmp_optarg, "spin")) {
+				config->wait_mode = FPGA_DMA_WAIT_SPIN;
+			} else if (!STR_CONST_CMP(tmp_optarg, "adaptive")) {
+				config->wait_mode = FPGA_DMA_WAIT_ADAPTIVE;
+			} else if (!STR_CONST_CMP(tmp_optarg, "interrupt")) {
+				config->wait_mode = FPGA_DMA_WAIT_INTERRUPT;
+			} else {
+				fprintf(stderr, "Invalid wait mode\n");
+				printUsage();
+			}
+			debug_print("wait mode = %d\n", config->wait_mode);
+			break;
+
     case 'v':    /* version */
         cout << "fpga_dma_test " << OPAE_VERSION
              << " " << OPAE_GIT_COMMIT_HASH;
@@ -290,6 +311,7 @@ int main(int argc, char *argv[]) {
 	 	.loopback = DMA_INVAL_LOOPBACK,
 		.decim_factor = CONFIG_UNINIT,
 		.fpga_addr = CONFIG_UNINIT,
+		.wait_mode = FPGA_DMA_WAIT_ADAPTIVE,
 	};
 
 	parse_args(&config, argc, argv);
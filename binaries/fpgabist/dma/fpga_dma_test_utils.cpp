@@ -29,6 +29,10 @@
  */
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <sys/resource.h>
 #include "fpga_dma_test_utils.h"
 #include "fpga_dma_common.h"
 
@@ -49,10 +53,21 @@ static int err_cnt = 0;
 		}\
 	} while (0)
 
+// Timing, CPU usage and per-transfer latency of one measured run
+struct run_stats {
+	struct timespec start;
+	struct timespec end;
+	struct rusage ru_start;
+	struct rusage ru_end;
+	std::deque<struct timespec> submitted;
+	std::deque<struct timespec> completed;
+};
+
+// ctx is the completion slot returned by stats_submit()
 static void transferComplete(void *ctx, fpga_dma_transfer_status_t status) {
-	UNUSED(ctx);
 	UNUSED(status);
-	return;
+	if (ctx)
+		clock_gettime(CLOCK_MONOTONIC, (struct timespec *)ctx);
 }
 
 //Verify repeating pattern 0x00...0xFF of payload_size
@@ -117,6 +132,66 @@ static double getTime(struct timespec start, struct timespec end) {
 	return (double) diff/(double)1000000000L;
 }
 
+static void stats_begin(struct run_stats *st) {
+	st->submitted.clear();
+	st->completed.clear();
+	getrusage(RUSAGE_SELF, &st->ru_start);
+	clock_gettime(CLOCK_MONOTONIC, &st->start);
+}
+
+// Record the submission of a transfer. Returns the slot that receives its
+// completion time, for use as the transfer callback context. Slots never
+// move, so the completion worker may fill earlier ones meanwhile.
+static struct timespec *stats_submit(struct run_stats *st) {
+	struct timespec now;
+	struct timespec none = { 0, 0 };
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	st->submitted.push_back(now);
+	st->completed.push_back(none);
+	return &st->completed.back();
+}
+
+// Record the completion of a blocking transfer
+static void stats_complete(struct timespec *slot) {
+	clock_gettime(CLOCK_MONOTONIC, slot);
+}
+
+static void stats_end(struct run_stats *st) {
+	clock_gettime(CLOCK_MONOTONIC, &st->end);
+	getrusage(RUSAGE_SELF, &st->ru_end);
+}
+
+static double tv_seconds(struct timeval tv) {
+	return (double)tv.tv_sec + (double)tv.tv_usec / 1000000.0;
+}
+
+// Report process CPU time (including the DMA worker threads) per GB moved,
+// and submission-to-completion latency percentiles.
+static void print_stats(struct run_stats *st, uint64_t bytes) {
+	double cpu = tv_seconds(st->ru_end.ru_utime) - tv_seconds(st->ru_start.ru_utime) +
+		     tv_seconds(st->ru_end.ru_stime) - tv_seconds(st->ru_start.ru_stime);
+	std::vector<double> lat;
+	size_t i;
+
+	for (i = 0; i < st->completed.size(); i++) {
+		if (st->completed[i].tv_sec || st->completed[i].tv_nsec)
+			lat.push_back(getTime(st->submitted[i], st->completed[i]) * 1000000.0);
+	}
+
+	std::cout << "CPU = " << cpu / ((double)bytes / 1000000000.0) << " s/GB" << std::endl;
+	if (lat.empty())
+		return;
+
+	std::sort(lat.begin(), lat.end());
+	auto pct = [&lat](double p) {
+		return lat[std::min(lat.size() - 1, (size_t)(p * lat.size() / 100.0))];
+	};
+	std::cout << "Latency (us): p50 = " << pct(50) << ", p90 = " << pct(90)
+		  << ", p99 = " << pct(99) << ", max = " << lat.back()
+		  << " (" << lat.size() << " transfers)" << std::endl;
+}
+
 static fpga_result prepare_checker(fpga_handle afc_h, uint64_t size)
 {
 	fpga_result res;
@@ -232,7 +307,7 @@ static fpga_result loopback_test(fpga_handle afc_h, fpga_dma_handle_t tx_dma_h,
 	uint64_t src;
 	fpga_dma_transfer_t transfer;
 	fpga_result res = FPGA_OK;
-	struct timespec start, end;
+	struct run_stats st;
 
 	// configure loopback on
 	uint64_t loopback_en = (uint64_t)0x1;
@@ -283,7 +358,7 @@ static fpga_result loopback_test(fpga_handle afc_h, fpga_dma_handle_t tx_dma_h,
 	tid = ceil((double)config->data_size / (double)config->payload_size);
 	src = battrs_src.iova;
 
-	clock_gettime(CLOCK_MONOTONIC, &start);
+	stats_begin(&st);
 	fpga_dma_tx_ctrl_t tx_ctrl;
 	if(config->transfer_type == DMA_TRANSFER_FIXED)
 		tx_ctrl = TX_NO_PACKET;
@@ -291,6 +366,7 @@ static fpga_result loopback_test(fpga_handle afc_h, fpga_dma_handle_t tx_dma_h,
 		tx_ctrl = GENERATE_SOP_AND_EOP;
 	while(total_size > 0) {
 		uint64_t transfer_bytes = MIN(total_size, config->payload_size);
+		struct timespec *lat = stats_submit(&st);
 		//debug_print("Transfer src=%lx, dst=%lx, bytes=%ld\n", (uint64_t)src, (uint64_t)0, transfer_bytes);
 
 		fpgaDMATransferSetSrc(transfer, src);
@@ -303,7 +379,7 @@ static fpga_result loopback_test(fpga_handle afc_h, fpga_dma_handle_t tx_dma_h,
 			fpgaDMATransferSetLast(transfer, true);
 		else
 			fpgaDMATransferSetLast(transfer, false);
-		fpgaDMATransferSetTransferCallback(transfer, transferComplete, NULL);
+		fpgaDMATransferSetTransferCallback(transfer, transferComplete, lat);
 
 		res = fpgaDMATransfer(tx_dma_h, transfer);
 		ON_ERR_GOTO(res, free_transfer, "transfer error");
@@ -342,6 +418,7 @@ static fpga_result loopback_test(fpga_handle afc_h, fpga_dma_handle_t tx_dma_h,
 	dst = battrs_dst.iova;
 	while(total_size > 0) {
 		uint64_t transfer_bytes = MIN(total_size, config->payload_size);
+		struct timespec *lat = stats_submit(&st);
 		fpgaDMATransferSetSrc(transfer, (uint64_t)0);
 		fpgaDMATransferSetDst(transfer, dst);
 		fpgaDMATransferSetLen(transfer, transfer_bytes);
@@ -352,20 +429,23 @@ static fpga_result loopback_test(fpga_handle afc_h, fpga_dma_handle_t tx_dma_h,
 			fpgaDMATransferSetTransferCallback(transfer, NULL, NULL);
 		} else {
 			fpgaDMATransferSetLast(transfer, false);
-			fpgaDMATransferSetTransferCallback(transfer, transferComplete, NULL);
+			fpgaDMATransferSetTransferCallback(transfer, transferComplete, lat);
 		}
 
 		res = fpgaDMATransfer(rx_dma_h, transfer);
 		ON_ERR_GOTO(res, free_transfer, "transfer error");
+		if(tid == 1)
+			stats_complete(lat);
 		total_size -= transfer_bytes;
 		dst += transfer_bytes;
 		tid--;	
 	}
-	clock_gettime(CLOCK_MONOTONIC, &end);
+	stats_end(&st);
 
 	res = verify_buffer((unsigned char *)battrs_dst.va, tsize, config->decim_factor);
 	ON_ERR_GOTO(res, free_transfer, "buffer verify failed");
-	std::cout << "PASS! Bandwidth = " << getBandwidth(config->data_size+tsize, getTime(start,end)) << " MB/s" << std::endl;
+	std::cout << "PASS! Bandwidth = " << getBandwidth(config->data_size+tsize, getTime(st.start,st.end)) << " MB/s" << std::endl;
+	print_stats(&st, config->data_size+tsize);
 
 free_transfer:
 	debug_print("destroying transfer\n");
@@ -389,11 +469,7 @@ out:
 static fpga_result non_loopback_test(fpga_handle afc_h, fpga_dma_handle_t dma_h, struct config *config) {
 	fpga_dma_transfer_t transfer;
 	fpga_result res = FPGA_OK;
-	struct timespec start, end;
-	memset((void *)&start, 0, sizeof(timespec));
-	memset((void *)&end, 0, sizeof(timespec));
-	//start = (struct timespec){ 0 };
-	//end = (struct timespec){ 0 };
+	struct run_stats st;
 
 	struct buf_attrs battrs = {
 		.va = NULL,
@@ -422,13 +498,14 @@ static fpga_result non_loopback_test(fpga_handle afc_h, fpga_dma_handle_t dma_h,
 		fill_buffer((unsigned char *)battrs.va, config->data_size);
 		debug_print("filled test buffer\n");
 
-		clock_gettime(CLOCK_MONOTONIC, &start);
+		stats_begin(&st);
 		uint64_t total_size = config->data_size;
 		int64_t tid = ceil((double)config->data_size /(double)config->payload_size);
 		uint64_t src = battrs.iova; // host memory addr
 		uint64_t dst = config->fpga_addr; // fpga memory addr
 		while(total_size > 0) {
 			uint64_t transfer_bytes = MIN(total_size, config->payload_size);
+			struct timespec *lat = stats_submit(&st);
 			//debug_print("Transfer src=%lx, dst=%lx, bytes=%ld\n", (uint64_t)src, (uint64_t)0, transfer_bytes);
 
 			fpgaDMATransferSetSrc(transfer, src);
@@ -440,30 +517,33 @@ static fpga_result non_loopback_test(fpga_handle afc_h, fpga_dma_handle_t dma_h,
 				fpgaDMATransferSetLast(transfer, true);
 				fpgaDMATransferSetTransferCallback(transfer, NULL, NULL);
 			} else {
-				fpgaDMATransferSetTransferCallback(transfer, transferComplete, NULL);
+				fpgaDMATransferSetTransferCallback(transfer, transferComplete, lat);
 			}
 
 			res = fpgaDMATransfer(dma_h, transfer);
 			ON_ERR_GOTO(res, free_transfer, "transfer error");
+			if(tid == 1)
+				stats_complete(lat);
 			total_size -= transfer_bytes;
 			src += transfer_bytes;
 			dst += transfer_bytes;
 			tid--;
 		}
-		clock_gettime(CLOCK_MONOTONIC, &end);
+		stats_end(&st);
 
 		// clear recieve buffer
 		memset(battrs.va, 0, battrs.size);
 		fpgaDMATransferReset(transfer);
 		ON_ERR_GOTO(res, free_transfer, "transfer reset error");
 
-		clock_gettime(CLOCK_MONOTONIC, &start);
+		stats_begin(&st);
 		total_size = config->data_size;
 		tid = ceil((double)config->data_size / (double)config->payload_size);
 		src = config->fpga_addr;
 		dst = battrs.iova;
 		while(total_size > 0) {
 			uint64_t transfer_bytes = MIN(total_size, config->payload_size);
+			struct timespec *lat = stats_submit(&st);
 
 			fpgaDMATransferSetSrc(transfer, src);
 			fpgaDMATransferSetDst(transfer, dst);
@@ -473,18 +553,20 @@ static fpga_result non_loopback_test(fpga_handle afc_h, fpga_dma_handle_t dma_h,
 				fpgaDMATransferSetLast(transfer, true);
 				fpgaDMATransferSetTransferCallback(transfer, NULL, NULL);
 			} else {
-				fpgaDMATransferSetTransferCallback(transfer, transferComplete, NULL);
+				fpgaDMATransferSetTransferCallback(transfer, transferComplete, lat);
 			}
 
 			res = fpgaDMATransfer(dma_h, transfer);
 			ON_ERR_GOTO(res, free_transfer, "transfer error");
+			if(tid == 1)
+				stats_complete(lat);
 			total_size -= transfer_bytes;
 			dst += transfer_bytes;
 			src += transfer_bytes;
 			tid--;
 		}
 		ON_ERR_GOTO(res, free_transfer, "transfer error");
-		clock_gettime(CLOCK_MONOTONIC, &end);
+		stats_end(&st);
 
 		res = verify_buffer((unsigned char *)battrs.va, config->data_size, 0/*decimation factor*/);
 		ON_ERR_GOTO(res, free_transfer, "buffer verify failed");
@@ -505,12 +587,13 @@ static fpga_result non_loopback_test(fpga_handle afc_h, fpga_dma_handle_t dma_h,
 		debug_print("checker prepared\n");
 		#endif
 
-		clock_gettime(CLOCK_MONOTONIC, &start);
+		stats_begin(&st);
 		uint64_t total_size = config->data_size;
 		int64_t tid = ceil(config->data_size / config->payload_size);
 		uint64_t src = battrs.iova;
 		while(total_size > 0) {
 			uint64_t transfer_bytes = MIN(total_size, config->payload_size);
+			struct timespec *lat = stats_submit(&st);
 			//debug_print("Transfer src=%lx, dst=%lx, bytes=%ld\n", (uint64_t)src, (uint64_t)0, transfer_bytes);
 
 			fpgaDMATransferSetSrc(transfer, src);
@@ -523,16 +606,18 @@ static fpga_result non_loopback_test(fpga_handle afc_h, fpga_dma_handle_t dma_h,
 				fpgaDMATransferSetLast(transfer, true);
 				fpgaDMATransferSetTransferCallback(transfer, NULL, NULL);
 			} else {
-				fpgaDMATransferSetTransferCallback(transfer, transferComplete, NULL);
+				fpgaDMATransferSetTransferCallback(transfer, transferComplete, lat);
 			}
 
 			res = fpgaDMATransfer(dma_h, transfer);
 			ON_ERR_GOTO(res, free_transfer, "transfer error");
+			if(tid == 1)
+				stats_complete(lat);
 			total_size -= transfer_bytes;
 			src += transfer_bytes;
 			tid--;
 		}
-		clock_gettime(CLOCK_MONOTONIC, &end);
+		stats_end(&st);
 
 		#if !EMU_MODE
 		res = wait_checker(afc_h);
@@ -552,12 +637,13 @@ static fpga_result non_loopback_test(fpga_handle afc_h, fpga_dma_handle_t dma_h,
 		ON_ERR_GOTO(res, free_transfer, "preparing generator");
 		debug_print("generator prepared\n");
 
-		clock_gettime(CLOCK_MONOTONIC, &start);
+		stats_begin(&st);
 		uint64_t total_size = config->data_size;
 		int64_t tid = ceil(config->data_size / config->payload_size);
 		uint64_t dst = battrs.iova;
 		while(total_size > 0) {
 			uint64_t transfer_bytes = MIN(total_size, config->payload_size);
+			struct timespec *lat = stats_submit(&st);
 
 			fpgaDMATransferSetSrc(transfer, (uint64_t)0);
 			fpgaDMATransferSetDst(transfer, dst);
@@ -568,17 +654,19 @@ static fpga_result non_loopback_test(fpga_handle afc_h, fpga_dma_handle_t dma_h,
 				fpgaDMATransferSetLast(transfer, true);
 				fpgaDMATransferSetTransferCallback(transfer, NULL, NULL);
 			} else {
-				fpgaDMATransferSetTransferCallback(transfer, transferComplete, NULL);
+				fpgaDMATransferSetTransferCallback(transfer, transferComplete, lat);
 			}
 
 			res = fpgaDMATransfer(dma_h, transfer);
 			ON_ERR_GOTO(res, free_transfer, "transfer error");
+			if(tid == 1)
+				stats_complete(lat);
 			total_size -= transfer_bytes;
 			dst += transfer_bytes;
 			tid--;
 		}
 		ON_ERR_GOTO(res, free_transfer, "transfer error");
-		clock_gettime(CLOCK_MONOTONIC, &end);
+		stats_end(&st);
 
 		res = wait_generator(afc_h);
 		ON_ERR_GOTO(res, free_transfer, "wait generator");
@@ -587,7 +675,8 @@ static fpga_result non_loopback_test(fpga_handle afc_h, fpga_dma_handle_t dma_h,
 		res = verify_buffer((unsigned char *)battrs.va, config->data_size, 0/*decimation factor*/);
 		ON_ERR_GOTO(res, free_transfer, "buffer verify failed");
 	}
-	std::cout << "PASS! Bandwidth = " << getBandwidth(config->data_size, getTime(start,end)) << " MB/s" << std::endl;
+	std::cout << "PASS! Bandwidth = " << getBandwidth(config->data_size, getTime(st.start,st.end)) << " MB/s" << std::endl;
+	print_stats(&st, config->data_size);
 
 free_transfer:
 	if(transfer) {
@@ -774,6 +863,8 @@ fpga_result do_action(struct config *config, fpga_token afc_tok)
 	if(config->direction == DMA_MTOM) {
 		res = fpgaDMAOpen(afc_h, 0, &dma_h);
 		ON_ERR_GOTO(res, out_dma_close, "fpgaDMAOpen");
+		res = fpgaDMASetWaitMode(dma_h, config->wait_mode);
+		ON_ERR_GOTO(res, out_dma_close, "fpgaDMASetWaitMode");
 		debug_print("opened memory to memory channel\n");
 
 		// Run test
@@ -786,11 +877,15 @@ fpga_result do_action(struct config *config, fpga_token afc_tok)
 				// Memory to stream -> Channel 0
 				res = fpgaDMAOpen(afc_h, 0, &dma_h);
 				ON_ERR_GOTO(res, out_dma_close, "fpgaDMAOpen");
+				res = fpgaDMASetWaitMode(dma_h, config->wait_mode);
+				ON_ERR_GOTO(res, out_dma_close, "fpgaDMASetWaitMode");
 				debug_print("opened memory to stream channel\n");
 			} else {
 				// Stream to memory -> Channel 1
 				res = fpgaDMAOpen(afc_h, 1, &dma_h);
 				ON_ERR_GOTO(res, out_dma_close, "fpgaDMAOpen");
+				res = fpgaDMASetWaitMode(dma_h, config->wait_mode);
+				ON_ERR_GOTO(res, out_dma_close, "fpgaDMASetWaitMode");
 				debug_print("opened stream to memory channel\n");
 			}
 
@@ -801,9 +896,13 @@ fpga_result do_action(struct config *config, fpga_token afc_tok)
 		} else {
 			res = fpgaDMAOpen(afc_h, 0, &tx_dma_h);
 			ON_ERR_GOTO(res, out_tx_close, "fpgaDMAOpen tx");
+			res = fpgaDMASetWaitMode(tx_dma_h, config->wait_mode);
+			ON_ERR_GOTO(res, out_tx_close, "fpgaDMASetWaitMode");
 
 			res = fpgaDMAOpen(afc_h, 1, &rx_dma_h);
 			ON_ERR_GOTO(res, out_rx_close, "fpgaDMAOpen rx");
+			res = fpgaDMASetWaitMode(rx_dma_h, config->wait_mode);
+			ON_ERR_GOTO(res, out_rx_close, "fpgaDMASetWaitMode");
 
 			// Run test
 			res = loopback_test(afc_h, tx_dma_h, rx_dma_h, config);
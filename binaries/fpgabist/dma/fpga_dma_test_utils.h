@@ -99,6 +99,7 @@ struct config {
 	enum dma_loopback loopback;
 	uint16_t decim_factor;
 	uint64_t fpga_addr;
+	fpga_dma_wait_mode_t wait_mode;
 };
 
 typedef union {
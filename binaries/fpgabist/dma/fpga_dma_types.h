@@ -81,6 +81,13 @@ typedef enum {
 	MM
 } fpga_dma_channel_type_t;
 
+// How a channel's worker threads wait for work and for completions
+typedef enum {
+	FPGA_DMA_WAIT_SPIN = 0,  // busy-poll; lowest latency, a core per worker
+	FPGA_DMA_WAIT_ADAPTIVE,  // spin, then yield, then sleep until woken
+	FPGA_DMA_WAIT_INTERRUPT  // adaptive; hw completions block on DMA interrupt
+} fpga_dma_wait_mode_t;
+
 // Opaque object that describes a DMA transfer
 typedef struct fpga_dma_transfer *fpga_dma_transfer_t;
 
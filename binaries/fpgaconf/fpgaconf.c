@@ -35,6 +35,7 @@
  * Features:
  *   * Auto-discovery of compatible slots for supplied bitstream
  *   * Dry-run mode ("what would happen if...?")
+ *   * Parallel programming of every matching FPGA (--all)
  */
 #define _GNU_SOURCE
 #ifdef HAVE_CONFIG_H
@@ -46,6 +47,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
 #include <sys/stat.h>
 
 #include <uuid/uuid.h>
@@ -70,6 +73,13 @@
  * Global configuration, set during parse_args()
  */
 #define MAX_FILENAME_LEN 256
+#define MAX_TARGETS 64
+struct pci_address {
+	int segment;
+	int bus;
+	int device;
+	int function;
+};
 struct config {
 	unsigned int verbosity;
 	bool dry_run;
@@ -79,11 +89,16 @@ struct config {
 	} mode;
 	int flags;
 	char *filename;
+	bool all;
+	uint32_t num_targets;
+	struct pci_address targets[MAX_TARGETS];
 } config = {.verbosity = 0,
 	    .dry_run = false,
 	    .mode = NORMAL,
 	    .flags = 0,
-	    .filename = NULL };
+	    .filename = NULL,
+	    .all = false,
+	    .num_targets = 0 };
 
 /*
  * Print readable error message for fpga_results
@@ -113,10 +128,12 @@ void help(void)
 	       "\n"
 	       "Usage:\n"
 	       "        fpgaconf [-hVvn] [-S <segment>] [-B <bus>] [-D <device>] [-F <function>] [PCI_ADDR] <gbs>\n"
+	       "        fpgaconf -a [-hVvn] [-S <segment>] [-B <bus>] [-D <device>] [-F <function>] [PCI_ADDR...] <gbs>\n"
 	       "\n"
 	       "                -h,--help           Print this help\n"
 	       "                -V,--verbose        Increase verbosity\n"
 	       "                -n,--dry-run        Don't actually perform actions\n"
+	       "                -a,--all            Program every matching FPGA in parallel\n"
 	       "                --force             Attempt to reconfigure even if in use\n"
 	       "                --skip-usrclk       Don't program user clocks\n"
 	       "                -S,--segment        Set target segment number\n"
@@ -127,16 +144,51 @@ void help(void)
 	       "\n");
 }
 
+/*
+ * Parse a PCI address of the form [ssss:]bb:dd.f
+ *
+ * @returns true if the whole string is a PCI address
+ */
+bool parse_pci_address(const char *s, struct pci_address *addr)
+{
+	unsigned int segment = 0;
+	unsigned int bus;
+	unsigned int device;
+	unsigned int function;
+	int n = -1;
+
+	if (sscanf(s, "%4x:%2x:%2x.%1u%n",
+		   &segment, &bus, &device, &function, &n) != 4 ||
+	    s[n] != '\0') {
+		segment = 0;
+		n = -1;
+		if (sscanf(s, "%2x:%2x.%1u%n",
+			   &bus, &device, &function, &n) != 3 ||
+		    s[n] != '\0')
+			return false;
+	}
+
+	if (function > 7)
+		return false;
+
+	addr->segment = (int)segment;
+	addr->bus = (int)bus;
+	addr->device = (int)device;
+	addr->function = (int)function;
+	return true;
+}
+
 /*
  * Parse command line arguments
  */
-#define GETOPT_STRING ":hVvnAIQ"
+#define GETOPT_STRING ":hVvnaAIQ"
 int parse_args(int argc, char *argv[])
 {
 	struct option longopts[] = {
 		{"help",        no_argument,       NULL, 'h'},
 		{"verbose",     no_argument,       NULL, 'V'},
 		{"dry-run",     no_argument,       NULL, 'n'},
+		{"all",         no_argument,       NULL, 'a'},
 		{"force",       no_argument,       NULL, 0xf},
 		{"skip-usrclk", no_argument,       NULL, 0x5},
 		{"version",     no_argument,       NULL, 'v'},
@@ -167,6 +219,10 @@ int parse_args(int argc, char *argv[])
 			config.dry_run = true;
 			break;
 
+		case 'a': /* all */
+			config.all = true;
+			break;
+
 		case 0xf: /* force */
 			config.flags |= FPGA_RECONF_FORCE;
 			break;
@@ -205,6 +261,23 @@ int parse_args(int argc, char *argv[])
 		}
 	}
 
+	/*
+	 * With --all, any further PCI addresses add targets. The first
+	 * non-address argument is the GBS filename.
+	 */
+	if (config.all) {
+		while (optind < argc &&
+		       parse_pci_address(argv[optind],
+					 &config.targets[config.num_targets])) {
+			if (++config.num_targets == MAX_TARGETS) {
+				fprintf(stderr, "Too many PCI addresses (max %d)\n",
+					MAX_TARGETS);
+				return -1;
+			}
+			++optind;
+		}
+	}
+
 	/* use first non-option argument as GBS filename */
 	if (optind == argc) {
 		fprintf(stderr, "No GBS file\n");
@@ -393,6 +466,295 @@ out_err:
 	return -1;
 }
 
+/*
+ * Find all FPGAs matching the interface ID of the GBS and any one of
+ * the given filters
+ *
+ * @returns the number of tokens stored in *fpgas, or -1 on error
+ */
+int find_fpgas(fpga_properties *device_filters,
+	       uint32_t num_filters,
+	       fpga_guid interface_id,
+	       fpga_token **fpgas)
+{
+	fpga_properties *filters;
+	fpga_token *tokens = NULL;
+	uint32_t num_matches = 0;
+	uint32_t max_tokens;
+	uint32_t num_cloned = 0;
+	uint32_t i;
+	fpga_result res;
+	int retval = -1;
+
+	*fpgas = NULL;
+
+	filters = opae_calloc(num_filters, sizeof(fpga_properties));
+	if (!filters) {
+		fprintf(stderr, "Error allocating filters\n");
+		return -1;
+	}
+
+	for (i = 0 ; i < num_filters ; ++i) {
+		res = fpgaCloneProperties(device_filters[i], &filters[i]);
+		ON_ERR_GOTO(res, out_destroy, "cloning properties");
+		++num_cloned;
+
+		res = fpgaPropertiesSetObjectType(filters[i], FPGA_DEVICE);
+		ON_ERR_GOTO(res, out_destroy, "setting object type");
+
+		res = fpgaPropertiesSetGUID(filters[i], interface_id);
+		ON_ERR_GOTO(res, out_destroy, "setting interface ID");
+	}
+
+	res = fpgaEnumerate(filters, num_filters, NULL, 0, &num_matches);
+	ON_ERR_GOTO(res, out_destroy, "enumerating FPGAs");
+
+	if (!num_matches) {
+		retval = 0; /* no FPGA found */
+		goto out_destroy;
+	}
+
+	tokens = opae_calloc(num_matches, sizeof(fpga_token));
+	if (!tokens) {
+		fprintf(stderr, "Error allocating tokens\n");
+		goto out_destroy;
+	}
+
+	max_tokens = num_matches;
+	res = fpgaEnumerate(filters, num_filters,
+			    tokens, max_tokens, &num_matches);
+	ON_ERR_GOTO(res, out_free, "enumerating FPGAs");
+
+	/* devices may have come and gone since the first pass */
+	if (num_matches > max_tokens)
+		num_matches = max_tokens;
+
+	*fpgas = tokens;
+	retval = (int)num_matches;
+	goto out_destroy;
+
+out_free:
+	opae_free(tokens);
+out_destroy:
+	for (i = 0 ; i < num_cloned ; ++i)
+		fpgaDestroyProperties(&filters[i]);
+	opae_free(filters);
+	return retval;
+}
+
+/*
+ * One reconfiguration, run on its own thread by program_bitstreams()
+ */
+struct pr_job {
+	pthread_t thread;
+	bool started;
+	fpga_token token;
+	uint32_t slot_num;
+	opae_bitstream_info *info;
+	int flags;
+	fpga_result result;
+	double seconds;
+	char address[16];
+};
+
+static double elapsed_seconds(const struct timespec *start,
+			      const struct timespec *end)
+{
+	return (double)(end->tv_sec - start->tv_sec) +
+	       (double)(end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void token_address(fpga_token token, char *buf, size_t len)
+{
+	fpga_properties props = NULL;
+	uint16_t segment = 0;
+	uint8_t bus = 0;
+	uint8_t device = 0;
+	uint8_t function = 0;
+
+	snprintf(buf, len, "unknown");
+
+	if (fpgaGetProperties(token, &props) != FPGA_OK)
+		return;
+
+	if (fpgaPropertiesGetSegment(props, &segment) == FPGA_OK &&
+	    fpgaPropertiesGetBus(props, &bus) == FPGA_OK &&
+	    fpgaPropertiesGetDevice(props, &device) == FPGA_OK &&
+	    fpgaPropertiesGetFunction(props, &function) == FPGA_OK)
+		snprintf(buf, len, "%04x:%02x:%02x.%u",
+			 segment, bus, device, function);
+
+	fpgaDestroyProperties(&props);
+}
+
+void *program_job(void *arg)
+{
+	struct pr_job *job = (struct pr_job *)arg;
+	fpga_handle handle = NULL;
+	struct timespec start;
+	struct timespec end;
+	fpga_result res;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	job->result = fpgaOpen(job->token, &handle, 0);
+	if (job->result == FPGA_OK) {
+		if (!config.dry_run)
+			job->result = fpgaReconfigureSlot(handle,
+							  job->slot_num,
+							  job->info->data,
+							  job->info->data_len,
+							  job->flags);
+		res = fpgaClose(handle);
+		if (job->result == FPGA_OK)
+			job->result = res;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	job->seconds = elapsed_seconds(&start, &end);
+	return NULL;
+}
+
+/*
+ * Program the same bitstream into each of the given FPGAs, one thread
+ * per FPGA, and report the outcome for each
+ *
+ * @returns the number of FPGAs that failed, or -1 on error
+ */
+int program_bitstreams(fpga_token *tokens, uint32_t num_tokens,
+		       uint32_t slot_num, opae_bitstream_info *info,
+		       int flags)
+{
+	struct pr_job *jobs;
+	struct timespec start;
+	struct timespec end;
+	uint32_t failed = 0;
+	uint32_t i;
+
+	jobs = opae_calloc(num_tokens, sizeof(struct pr_job));
+	if (!jobs) {
+		fprintf(stderr, "Error allocating jobs\n");
+		return -1;
+	}
+
+	if (config.dry_run)
+		print_msg(1, "[--dry-run] Skipping reconfiguration");
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for (i = 0 ; i < num_tokens ; ++i) {
+		jobs[i].token = tokens[i];
+		jobs[i].slot_num = slot_num;
+		jobs[i].info = info;
+		jobs[i].flags = flags;
+		token_address(tokens[i], jobs[i].address,
+			      sizeof(jobs[i].address));
+
+		if (pthread_create(&jobs[i].thread, NULL,
+				   program_job, &jobs[i])) {
+			/* run it here rather than skip the device */
+			print_msg(2, "Thread creation failed, programming inline");
+			program_job(&jobs[i]);
+		} else {
+			jobs[i].started = true;
+		}
+	}
+
+	for (i = 0 ; i < num_tokens ; ++i) {
+		if (jobs[i].started)
+			pthread_join(jobs[i].thread, NULL);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	for (i = 0 ; i < num_tokens ; ++i) {
+		if (jobs[i].result == FPGA_OK) {
+			printf("%-14s OK      %8.3f s\n",
+			       jobs[i].address, jobs[i].seconds);
+		} else {
+			printf("%-14s FAILED  %8.3f s  (%s)\n",
+			       jobs[i].address, jobs[i].seconds,
+			       fpgaErrStr(jobs[i].result));
+			++failed;
+		}
+	}
+
+	printf("Programmed %u of %u FPGAs in %.3f s\n",
+	       num_tokens - failed, num_tokens,
+	       elapsed_seconds(&start, &end));
+
+	opae_free(jobs);
+	return (int)failed;
+}
+
+/*
+ * Program every FPGA matching the device filter or one of the PCI
+ * addresses given on the command line
+ *
+ * @returns the fpgaconf exit code
+ */
+int program_all(fpga_properties device_filter, uint32_t slot_num,
+		opae_bitstream_info *info, int flags)
+{
+	fpga_properties filters[MAX_TARGETS + 1] = { device_filter };
+	uint32_t num_filters = 1;
+	fpga_token *tokens = NULL;
+	uint32_t i;
+	fpga_result result = FPGA_OK;
+	int res;
+	int retval = 0;
+
+	for (i = 0 ; i < config.num_targets ; ++i) {
+		fpga_properties f = NULL;
+
+		result = fpgaGetProperties(NULL, &f);
+		ON_ERR_GOTO(result, out_destroy, "allocating properties");
+		filters[num_filters++] = f;
+
+		result = fpgaPropertiesSetSegment(f,
+						  config.targets[i].segment);
+		ON_ERR_GOTO(result, out_destroy, "setting segment");
+		result = fpgaPropertiesSetBus(f, config.targets[i].bus);
+		ON_ERR_GOTO(result, out_destroy, "setting bus");
+		result = fpgaPropertiesSetDevice(f, config.targets[i].device);
+		ON_ERR_GOTO(result, out_destroy, "setting device");
+		result = fpgaPropertiesSetFunction(f,
+						   config.targets[i].function);
+		ON_ERR_GOTO(result, out_destroy, "setting function");
+	}
+
+	print_msg(1, "Looking for slots");
+	res = find_fpgas(filters, num_filters, info->pr_interface_id, &tokens);
+	if (res < 0) {
+		retval = 3;
+		goto out_destroy;
+	}
+	if (res == 0) {
+		fprintf(stderr, "No suitable slots found.\n");
+		retval = 4;
+		if (config.verbosity > 0)
+			print_interface_id(device_filter,
+					   info->pr_interface_id);
+		goto out_destroy;
+	}
+
+	print_msg(1, "Programming bitstream");
+	if (program_bitstreams(tokens, (uint32_t)res, slot_num,
+			       info, flags))
+		retval = 5;
+
+	for (i = 0 ; i < (uint32_t)res ; ++i)
+		fpgaDestroyToken(&tokens[i]);
+	opae_free(tokens);
+
+out_destroy:
+	if (result != FPGA_OK)
+		retval = 6;
+	for (i = 1 ; i < num_filters ; ++i)
+		fpgaDestroyProperties(&filters[i]);
+	return retval;
+}
+
 
 int main(int argc, char *argv[])
 {
@@ -434,14 +796,22 @@ int main(int argc, char *argv[])
 	if (config.dry_run)
 		printf("--dry-run is set\n");
 
-	/* allocate memory and read bitstream data */
+	/* map the bitstream and parse its metadata in place */
 	print_msg(1, "Reading bitstream");
-	result = opae_load_bitstream(config.filename, &info);
+	result = opae_map_bitstream(config.filename, &info);
 	if (result != FPGA_OK) {
 		retval = 2;
 		goto out_exit;
 	}
 
+	if (config.all) {
+		retval = program_all(device_filter, slot_num,
+				     &info, config.flags);
+		if (!retval)
+			print_msg(1, "Done");
+		goto out_free;
+	}
+
 	/* find suitable slot */
 	print_msg(1, "Looking for slot");
 	res = find_fpga(device_filter, info.pr_interface_id, &token);
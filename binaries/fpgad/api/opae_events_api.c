@@ -39,8 +39,27 @@
 #define LOG(format, ...) \
 log_printf("opae_events_api: " format, ##__VA_ARGS__)
 
+// Registrations are indexed twice: by (event, object_id), which is
+// the lookup made when an event is sent, and by conn_socket, which
+// is the lookup made when a client unregisters or disconnects.
+#define EVENT_REGISTRY_BUCKETS 1024
+
 STATIC pthread_mutex_t list_lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
-STATIC api_client_event_registry *event_registry_list;
+STATIC api_client_event_registry *event_registry_table[EVENT_REGISTRY_BUCKETS];
+STATIC api_client_event_registry *client_registry_table[EVENT_REGISTRY_BUCKETS];
+STATIC size_t event_registry_count;
+
+STATIC unsigned event_registry_hash(fpga_event_type e, uint64_t object_id)
+{
+	uint64_t h = (object_id ^ ((uint64_t)e << 56)) * 0x9e3779b97f4a7c15ULL;
+
+	return (unsigned)(h >> 32) & (EVENT_REGISTRY_BUCKETS - 1);
+}
+
+STATIC unsigned client_registry_hash(int conn_socket)
+{
+	return (unsigned)conn_socket & (EVENT_REGISTRY_BUCKETS - 1);
+}
 
 int opae_api_register_event(int conn_socket,
 			    int fd,
@@ -49,6 +68,7 @@ int opae_api_register_event(int conn_socket,
 {
 	api_client_event_registry *r =
 		(api_client_event_registry *) opae_malloc(sizeof(*r));
+	unsigned bucket;
 	int err;
 
 	if (!r)
@@ -62,8 +82,15 @@ int opae_api_register_event(int conn_socket,
 
 	fpgad_mutex_lock(err, &list_lock);
 
-	r->next = event_registry_list;
-	event_registry_list = r;
+	bucket = event_registry_hash(e, object_id);
+	r->next = event_registry_table[bucket];
+	event_registry_table[bucket] = r;
+
+	bucket = client_registry_hash(conn_socket);
+	r->next_for_client = client_registry_table[bucket];
+	client_registry_table[bucket] = r;
+
+	++event_registry_count;
 
 	fpgad_mutex_unlock(err, &list_lock);
 
@@ -76,55 +103,51 @@ STATIC void release_event_registry(api_client_event_registry *r)
 	opae_free(r);
 }
 
+// Unlinks r from its conn_socket bucket.
+STATIC void unlink_client_registry(api_client_event_registry *r)
+{
+	api_client_event_registry **pp;
+
+	pp = &client_registry_table[client_registry_hash(r->conn_socket)];
+	while (*pp && *pp != r)
+		pp = &(*pp)->next_for_client;
+
+	if (*pp)
+		*pp = r->next_for_client;
+}
+
 int opae_api_unregister_event(int conn_socket,
 			      fpga_event_type e,
 			      uint64_t object_id)
 {
+	api_client_event_registry **pp;
 	api_client_event_registry *trash;
-	api_client_event_registry *save;
 	int err;
 	int res = 0;
 
 	fpgad_mutex_lock(err, &list_lock);
 
-	trash = event_registry_list;
-
-	if (!trash) { // empty list
-		res = 1;
-		goto out_unlock;
-	}
-
-	if ((conn_socket == trash->conn_socket) &&
-		(e == trash->event) &&
-		(object_id == trash->object_id)) {
-
-		// found at head of list
-
-		event_registry_list = event_registry_list->next;
-		release_event_registry(trash);
-		goto out_unlock;
-	}
-
-	save = trash;
-	trash = trash->next;
-	while (trash) {
+	pp = &event_registry_table[event_registry_hash(e, object_id)];
+	while (*pp) {
+		trash = *pp;
 
 		if ((conn_socket == trash->conn_socket) &&
 			(e == trash->event) &&
 			(object_id == trash->object_id))
 			break;
 
-		save = trash;
-		trash = trash->next;
+		pp = &trash->next;
 	}
 
-	if (!trash) { // not found
+	if (!*pp) { // not found
 		res = 1;
 		goto out_unlock;
 	}
 
-	// found at trash
-	save->next = trash->next;
+	trash = *pp;
+	*pp = trash->next;
+	unlink_client_registry(trash);
+	--event_registry_count;
 	release_event_registry(trash);
 
 out_unlock:
@@ -137,7 +160,8 @@ find_event_for(int conn_socket)
 {
 	api_client_event_registry *r;
 
-	for (r = event_registry_list ; r ; r = r->next)
+	for (r = client_registry_table[client_registry_hash(conn_socket)] ;
+	     r ; r = r->next_for_client)
 		if (conn_socket == r->conn_socket)
 			break;
 
@@ -163,18 +187,24 @@ void opae_api_unregister_all_events_for(int conn_socket)
 void opae_api_unregister_all_events(void)
 {
 	api_client_event_registry *r;
+	unsigned i;
 	int err;
 
 	fpgad_mutex_lock(err, &list_lock);
 
-	for (r = event_registry_list ; r != NULL ; ) {
-		api_client_event_registry *trash;
-		trash = r;
-		r = r->next;
-		release_event_registry(trash);
+	for (i = 0 ; i < EVENT_REGISTRY_BUCKETS ; ++i) {
+		for (r = event_registry_table[i] ; r != NULL ; ) {
+			api_client_event_registry *trash;
+			trash = r;
+			r = r->next;
+			release_event_registry(trash);
+		}
+
+		event_registry_table[i] = NULL;
+		client_registry_table[i] = NULL;
 	}
 
-	event_registry_list = NULL;
+	event_registry_count = 0;
 
 	fpgad_mutex_unlock(err, &list_lock);
 }
@@ -184,17 +214,52 @@ void opae_api_for_each_registered_event
 void *context)
 {
 	api_client_event_registry *r;
+	unsigned i;
 	int err;
 
 	fpgad_mutex_lock(err, &list_lock);
 
-	for (r = event_registry_list; r != NULL; r = r->next) {
-		cb(r, context);
+	for (i = 0 ; i < EVENT_REGISTRY_BUCKETS ; ++i) {
+		for (r = event_registry_table[i]; r != NULL; r = r->next) {
+			cb(r, context);
+		}
 	}
 
 	fpgad_mutex_unlock(err, &list_lock);
 }
 
+void opae_api_for_each_registration_of(fpga_event_type e,
+				       uint64_t object_id,
+				       void (*cb)(api_client_event_registry *r,
+						  void *context),
+				       void *context)
+{
+	api_client_event_registry *r;
+	int err;
+
+	fpgad_mutex_lock(err, &list_lock);
+
+	for (r = event_registry_table[event_registry_hash(e, object_id)] ;
+	     r != NULL ; r = r->next) {
+		if ((r->event == e) && (r->object_id == object_id))
+			cb(r, context);
+	}
+
+	fpgad_mutex_unlock(err, &list_lock);
+}
+
+size_t opae_api_num_registered_events(void)
+{
+	size_t count;
+	int err;
+
+	fpgad_mutex_lock(err, &list_lock);
+	count = event_registry_count;
+	fpgad_mutex_unlock(err, &list_lock);
+
+	return count;
+}
+
 STATIC void check_and_send_EVENT_ERROR(api_client_event_registry *r,
 				       void *context)
 {
@@ -213,8 +278,10 @@ STATIC void check_and_send_EVENT_ERROR(api_client_event_registry *r,
 
 void opae_api_send_EVENT_ERROR(fpgad_monitored_device *d)
 {
-	opae_api_for_each_registered_event(check_and_send_EVENT_ERROR,
-					   d);
+	opae_api_for_each_registration_of(FPGA_EVENT_ERROR,
+					  d->object_id,
+					  check_and_send_EVENT_ERROR,
+					  d);
 }
 
 STATIC void check_and_send_EVENT_POWER_THERMAL(api_client_event_registry *r,
@@ -235,6 +302,8 @@ STATIC void check_and_send_EVENT_POWER_THERMAL(api_client_event_registry *r,
 
 void opae_api_send_EVENT_POWER_THERMAL(fpgad_monitored_device *d)
 {
-	opae_api_for_each_registered_event(check_and_send_EVENT_POWER_THERMAL,
-					   d);
+	opae_api_for_each_registration_of(FPGA_EVENT_POWER_THERMAL,
+					  d->object_id,
+					  check_and_send_EVENT_POWER_THERMAL,
+					  d);
 }
@@ -56,7 +56,10 @@ typedef struct _api_client_event_registry {
 	uint64_t data;
 	fpga_event_type event;
 	uint64_t object_id;
+	// chain of the (event, object_id) hash bucket
 	struct _api_client_event_registry *next;
+	// chain of the conn_socket hash bucket
+	struct _api_client_event_registry *next_for_client;
 } api_client_event_registry;
 
 // 0 on success
@@ -78,6 +81,15 @@ void opae_api_for_each_registered_event(void (*cb)(api_client_event_registry *r,
 						   void *context),
 					void *context);
 
+// Calls cb only for the registrations of event e on object_id.
+void opae_api_for_each_registration_of(fpga_event_type e,
+				       uint64_t object_id,
+				       void (*cb)(api_client_event_registry *r,
+						  void *context),
+				       void *context);
+
+size_t opae_api_num_registered_events(void);
+
 void opae_api_send_EVENT_ERROR(fpgad_monitored_device *d);
 
 void opae_api_send_EVENT_POWER_THERMAL(fpgad_monitored_device *d);
@@ -47,7 +47,7 @@
 #define LOG(format, ...) \
 log_printf("args: " format, ##__VA_ARGS__)
 
-#define OPT_STR ":hdl:p:s:n:v"
+#define OPT_STR ":hdl:p:s:n:ve"
 
 STATIC struct option longopts[] = {
 	{ "help",           no_argument,       NULL, 'h' },
@@ -57,6 +57,7 @@ STATIC struct option longopts[] = {
 	{ "socket",         required_argument, NULL, 's' },
 	{ "null-bitstream", required_argument, NULL, 'n' },
 	{ "version",        no_argument,       NULL, 'v' },
+	{ "event-monitor",  no_argument,       NULL, 'e' },
 
 	{ 0, 0, 0, 0 }
 };
@@ -77,6 +78,8 @@ void cmd_show_help(FILE *fptr)
 	fprintf(fptr, "\t-n,--null-bitstream <file>  NULL bitstream (for AP6 handling, may be\n"
 		      "\t                            given multiple times).\n");
 	fprintf(fptr, "\t-v,--version                display the version and exit.\n");
+	fprintf(fptr, "\t-e,--event-monitor          wait on plugin fds and per-detection\n"
+		      "\t                            timers instead of polling every device.\n");
 }
 
 STATIC bool cmd_register_null_gbs(struct fpgad_config *c, char *null_gbs_path)
@@ -186,6 +189,11 @@ int cmd_parse_args(struct fpgad_config *c, int argc, char *argv[])
 			}
 			break;
 
+		case 'e':
+			c->event_monitor = true;
+			LOG("event monitor requested\n");
+			break;
+
 		case 'v':
 			fprintf(stdout, "fpgad %s %s%s\n",
 					OPAE_VERSION,
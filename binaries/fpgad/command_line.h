@@ -38,6 +38,7 @@
 
 struct fpgad_config {
 	useconds_t poll_interval_usec;
+	bool event_monitor;
 
 	bool daemon;
 	char directory[PATH_MAX];
@@ -37,7 +37,7 @@
 
 #include <sys/socket.h>
 #include <sys/un.h>
-#include <poll.h>
+#include <sys/epoll.h>
 #include <inttypes.h>
 #include "events_api_thread.h"
 #include "api/opae_events_api.h"
@@ -55,38 +55,61 @@ events_api_thread_config events_api_config = {
 	.sched_priority = 10,
 };
 
-#define MAX_CLIENT_CONNECTIONS 1023
-#define SRV_SOCKET             0
-#define FIRST_CLIENT_SOCKET    1
+#define MAX_CLIENT_CONNECTIONS 8192
+#define MAX_EPOLL_EVENTS       64
 
-/* array keeping track of all connection file descriptors (plus server socket) */
-STATIC struct pollfd pollfds[MAX_CLIENT_CONNECTIONS+1];
-STATIC nfds_t num_fds = 1;
+/* per-connection state, the epoll data of each client socket */
+typedef struct _api_client {
+	int conn_socket;
+	uint64_t num_requests;
+	struct _api_client *prev;
+	struct _api_client *next;
+} api_client;
+
+STATIC api_client *client_list;
+STATIC unsigned num_clients;
 
-STATIC void remove_client(int conn_socket)
+STATIC api_client *add_client(int conn_socket)
 {
-	nfds_t i, j;
-	nfds_t removed = 0;
-
-	opae_api_unregister_all_events_for(conn_socket);
-	LOG("closing connection conn_socket=%d.\n", conn_socket);
-	opae_close(conn_socket);
-
-	for (i = j = FIRST_CLIENT_SOCKET ; i < num_fds ; ++i) {
-		if (conn_socket != pollfds[i].fd) {
-			if (j != i)
-				pollfds[j] = pollfds[i];
-			++j;
-		} else {
-			++removed;
-		}
-	}
+	api_client *client;
+
+	client = (api_client *)opae_calloc(1, sizeof(api_client));
+	if (!client)
+		return NULL;
+
+	client->conn_socket = conn_socket;
+
+	client->next = client_list;
+	if (client_list)
+		client_list->prev = client;
+	client_list = client;
+	++num_clients;
 
-	num_fds -= removed;
+	return client;
 }
 
-STATIC int handle_message(int conn_socket)
+STATIC void remove_client(api_client *client)
 {
+	opae_api_unregister_all_events_for(client->conn_socket);
+	LOG("closing connection conn_socket=%d after %" PRIu64
+	    " requests.\n", client->conn_socket, client->num_requests);
+	// close() also removes the socket from the epoll set.
+	opae_close(client->conn_socket);
+
+	if (client->prev)
+		client->prev->next = client->next;
+	else
+		client_list = client->next;
+	if (client->next)
+		client->next->prev = client->prev;
+	--num_clients;
+
+	opae_free(client);
+}
+
+STATIC int handle_message(api_client *client)
+{
+	int conn_socket = client->conn_socket;
 	struct msghdr mh;
 	struct cmsghdr *cmh;
 	struct iovec iov[1];
@@ -114,14 +137,18 @@ STATIC int handle_message(int conn_socket)
 	n = recvmsg(conn_socket, &mh, 0);
 	if (n < 0) {
 		LOG("recvmsg() failed: %s\n", strerror(errno));
+		if (errno != EINTR && errno != EAGAIN)
+			remove_client(client);
 		return (int)n;
 	}
 
 	if (!n) { // socket closed by peer
-		remove_client(conn_socket);
+		remove_client(client);
 		return (int)n;
 	}
 
+	++client->num_requests;
+
 	switch (req.type) {
 
 	case REGISTER_EVENT:
@@ -169,6 +196,48 @@ bool events_api_is_ready(void)
 	return evt_api_is_ready;
 }
 
+STATIC void accept_clients(int server_socket, int epfd)
+{
+	struct epoll_event ev;
+	api_client *client;
+	int conn_socket;
+
+	// The server socket is non-blocking: accept the whole backlog.
+	while (1) {
+		conn_socket = accept4(server_socket, NULL, NULL, SOCK_CLOEXEC);
+		if (conn_socket < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				LOG("failed to accept new connection!\n");
+			return;
+		}
+
+		if (num_clients == MAX_CLIENT_CONNECTIONS) {
+			LOG("exceeded max connections!\n");
+			opae_close(conn_socket);
+			continue;
+		}
+
+		client = add_client(conn_socket);
+		if (!client) {
+			LOG("failed to allocate client state!\n");
+			opae_close(conn_socket);
+			continue;
+		}
+
+		memset(&ev, 0, sizeof(ev));
+		ev.events = EPOLLIN | EPOLLPRI | EPOLLRDHUP;
+		ev.data.ptr = client;
+
+		if (epoll_ctl(epfd, EPOLL_CTL_ADD, conn_socket, &ev) < 0) {
+			LOG("epoll_ctl() failed: %s\n", strerror(errno));
+			remove_client(client);
+			continue;
+		}
+
+		LOG("accepting connection %d.\n", conn_socket);
+	}
+}
+
 void *events_api_thread(void *thread_context)
 {
 	events_api_thread_config *c =
@@ -177,10 +246,12 @@ void *events_api_thread(void *thread_context)
 	int policy = 0;
 	int res;
 
-	nfds_t i;
+	int i;
 	struct sockaddr_un addr;
+	struct epoll_event ev;
+	struct epoll_event events[MAX_EPOLL_EVENTS];
 	int server_socket;
-	int conn_socket;
+	int epfd;
 	size_t len;
 
 	LOG("starting\n");
@@ -203,7 +274,9 @@ void *events_api_thread(void *thread_context)
 
 	unlink(c->global->api_socket);
 
-	server_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+	server_socket = socket(AF_UNIX,
+			       SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+			       0);
 	if (server_socket < 0) {
 		LOG("failed to create server socket.\n");
 		goto out_exit;
@@ -222,61 +295,54 @@ void *events_api_thread(void *thread_context)
 	}
 	LOG("server socket bind success.\n");
 
-	if (listen(server_socket, 20) < 0) {
+	if (listen(server_socket, SOMAXCONN) < 0) {
 		LOG("failed to listen on socket.\n");
 		goto out_close_server;
 	}
 	LOG("listening for connections.\n");
 
-	evt_api_is_ready = true;
+	epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (epfd < 0) {
+		LOG("epoll_create1() failed: %s\n", strerror(errno));
+		goto out_close_server;
+	}
 
-	pollfds[SRV_SOCKET].fd = server_socket;
-	pollfds[SRV_SOCKET].events = POLLIN | POLLPRI;
-	num_fds = 1;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.ptr = NULL; // the server socket
+	if (epoll_ctl(epfd, EPOLL_CTL_ADD, server_socket, &ev) < 0) {
+		LOG("epoll_ctl() failed: %s\n", strerror(errno));
+		goto out_close_epoll;
+	}
+
+	evt_api_is_ready = true;
 
 	while (c->global->running) {
 
-		res = poll(pollfds, num_fds, 100);
+		res = epoll_wait(epfd, events, MAX_EPOLL_EVENTS, 100);
 		if (res < 0) {
-			LOG("poll error\n");
+			if (errno != EINTR)
+				LOG("epoll_wait error\n");
 			continue;
 		}
 
-		if (0 == res) // timeout
-			continue;
-
-		if ((nfds_t)res > num_fds) { // weird
-			LOG("something bad happened during poll!\n");
-			continue;
-		}
-
-		// handle requests on existing sockets
-		for (i = FIRST_CLIENT_SOCKET ; i < num_fds ; ++i) {
-			if (pollfds[i].revents) {
-				handle_message(pollfds[i].fd);
-			}
-		}
-
-		// handle new connection requests
-		if (pollfds[SRV_SOCKET].revents) {
+		for (i = 0 ; i < res ; ++i) {
+			api_client *client = (api_client *)events[i].data.ptr;
 
-			if (num_fds == MAX_CLIENT_CONNECTIONS+1) {
-				LOG("exceeded max connections!\n");
+			if (!client) {
+				// handle new connection requests
+				accept_clients(server_socket, epfd);
 				continue;
 			}
 
-			conn_socket = accept(server_socket, NULL, NULL);
-
-			if (conn_socket < 0) {
-				LOG("failed to accept new connection!\n");
-			} else {
-				LOG("accepting connection %d.\n", conn_socket);
-
-				pollfds[num_fds].fd = conn_socket;
-				pollfds[num_fds].events = POLLIN | POLLPRI;
-				++num_fds;
+			// handle requests on existing sockets
+			if (events[i].events & (EPOLLIN | EPOLLPRI)) {
+				// reads 0 and removes the client on hang-up
+				handle_message(client);
+			} else if (events[i].events &
+				   (EPOLLHUP | EPOLLERR | EPOLLRDHUP)) {
+				remove_client(client);
 			}
-
 		}
 
 	}
@@ -284,10 +350,16 @@ void *events_api_thread(void *thread_context)
 	opae_api_unregister_all_events();
 
 	// close any active client sockets
-	for (i = FIRST_CLIENT_SOCKET ; i < num_fds ; ++i) {
-		opae_close(pollfds[i].fd);
+	while (client_list) {
+		api_client *client = client_list;
+		client_list = client->next;
+		opae_close(client->conn_socket);
+		opae_free(client);
 	}
+	num_clients = 0;
 
+out_close_epoll:
+	opae_close(epfd);
 out_close_server:
 	evt_api_is_ready = false;
 	opae_close(server_socket);
@@ -30,6 +30,9 @@
 
 #include <dlfcn.h>
 #include <sched.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
 #include "monitored_device.h"
 #include "monitor_thread.h"
 #include "event_dispatcher_thread.h"
@@ -78,6 +81,36 @@ STATIC void mon_queue_response(fpgad_detection_status status,
 	}
 }
 
+STATIC fpgad_detection_status mon_detect(fpgad_monitored_device *d,
+					 unsigned i)
+{
+	fpgad_detection_status result;
+	fpgad_detect_event_t detect =
+		d->detections[i];
+	void *detect_context =
+		d->detection_contexts ?
+		d->detection_contexts[i] : NULL;
+
+	result = detect(d, detect_context);
+
+	if (result != FPGAD_STATUS_NOT_DETECTED && d->responses) {
+		fpgad_respond_event_t response =
+			d->responses[i];
+		void *response_context =
+			d->response_contexts ?
+			d->response_contexts[i] : NULL;
+
+		if (response) {
+			mon_queue_response(result,
+					   response,
+					   d,
+					   response_context);
+		}
+	}
+
+	return result;
+}
+
 STATIC void mon_monitor(fpgad_monitored_device *d)
 {
 	unsigned i;
@@ -85,31 +118,418 @@ STATIC void mon_monitor(fpgad_monitored_device *d)
 	if (!d->detections)
 		return;
 
-	for (i = 0 ; d->detections[i] ; ++i) {
-		fpgad_detection_status result;
-		fpgad_detect_event_t detect =
-			d->detections[i];
-		void *detect_context =
-			d->detection_contexts ?
-			d->detection_contexts[i] : NULL;
-
-		result = detect(d, detect_context);
-
-		if (result != FPGAD_STATUS_NOT_DETECTED && d->responses) {
-			fpgad_respond_event_t response =
-				d->responses[i];
-			void *response_context =
-				d->response_contexts ?
-				d->response_contexts[i] : NULL;
-
-			if (response) {
-				mon_queue_response(result,
-						   response,
-						   d,
-						   response_context);
+	for (i = 0 ; d->detections[i] ; ++i)
+		mon_detect(d, i);
+}
+
+// Event mode
+//
+// Each detection is attached to a wake source. Detections that give
+// a pollable fd share a source with the other detections of their
+// device that give the same fd, events and period; the source's
+// timer is a backstop for the fd. Timer-only detections share one
+// source per period across all devices. The thread sleeps in
+// epoll_wait() until a source is ready, then runs its detections.
+
+#define MON_EPOLL_MAX_EVENTS      16
+// bounds the time to notice global->running == false
+#define MON_EPOLL_TIMEOUT_MSEC    1000
+#define MON_STATS_INTERVAL_SEC    60
+#define MON_STATS_EVENT           UINT64_MAX
+
+typedef struct _mon_detection_stats {
+	uint64_t calls;
+	uint64_t detected;
+	uint64_t latency_nsec;      // sum of wake-to-detection-done times
+	uint64_t max_latency_nsec;
+	uint64_t cpu_nsec;          // thread CPU time spent in detections
+} mon_detection_stats;
+
+typedef struct _mon_wake_entry {
+	fpgad_monitored_device *device;
+	unsigned detection;
+	mon_detection_stats stats;  // since startup
+} mon_wake_entry;
+
+typedef struct _mon_wake_source {
+	int fd;                     // plugin fd, or -1 for a timer only
+	uint32_t events;
+	uint32_t period_usec;
+	int timer_fd;
+	mon_wake_entry *entries;
+	unsigned num_entries;
+	mon_detection_stats interval; // since the last stats log
+} mon_wake_source;
+
+STATIC mon_wake_source *mon_wake_sources;
+STATIC unsigned mon_num_wake_sources;
+
+STATIC uint64_t mon_clock_nsec(clockid_t clk)
+{
+	struct timespec ts;
+
+	clock_gettime(clk, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+STATIC void mon_stats_add(mon_detection_stats *s,
+			  fpgad_detection_status status,
+			  uint64_t latency_nsec,
+			  uint64_t cpu_nsec)
+{
+	++s->calls;
+	if (status != FPGAD_STATUS_NOT_DETECTED)
+		++s->detected;
+	s->latency_nsec += latency_nsec;
+	if (latency_nsec > s->max_latency_nsec)
+		s->max_latency_nsec = latency_nsec;
+	s->cpu_nsec += cpu_nsec;
+}
+
+STATIC void mon_stats_log(const char *prefix,
+			  const mon_detection_stats *s)
+{
+	LOG("%s: calls %lu detected %lu latency avg %lu us"
+	    " max %lu us cpu %lu us\n",
+	    prefix,
+	    s->calls,
+	    s->detected,
+	    s->calls ? s->latency_nsec / s->calls / 1000 : 0,
+	    s->max_latency_nsec / 1000,
+	    s->cpu_nsec / 1000);
+}
+
+STATIC const char *mon_device_name(fpgad_monitored_device *d)
+{
+	return d->supported && d->supported->module_library ?
+		d->supported->module_library : "unknown";
+}
+
+STATIC void mon_log_wake_stats(bool per_detection)
+{
+	char prefix[256];
+	unsigned i;
+	unsigned j;
+
+	for (i = 0 ; i < mon_num_wake_sources ; ++i) {
+		mon_wake_source *src = &mon_wake_sources[i];
+
+		if (src->fd >= 0)
+			snprintf(prefix, sizeof(prefix),
+				 "fd %d (%u detections)",
+				 src->fd, src->num_entries);
+		else
+			snprintf(prefix, sizeof(prefix),
+				 "timer %u ms (%u detections)",
+				 src->period_usec / 1000, src->num_entries);
+
+		mon_stats_log(prefix, &src->interval);
+		memset(&src->interval, 0, sizeof(src->interval));
+
+		if (!per_detection)
+			continue;
+
+		for (j = 0 ; j < src->num_entries ; ++j) {
+			mon_wake_entry *e = &src->entries[j];
+
+			snprintf(prefix, sizeof(prefix),
+				 "  %s objid=0x%lx detection %u",
+				 mon_device_name(e->device),
+				 e->device->object_id,
+				 e->detection);
+
+			mon_stats_log(prefix, &e->stats);
+		}
+	}
+}
+
+STATIC mon_wake_source *mon_find_wake_source(fpgad_monitored_device *d,
+					     int fd,
+					     uint32_t events,
+					     uint32_t period_usec)
+{
+	unsigned i;
+
+	for (i = 0 ; i < mon_num_wake_sources ; ++i) {
+		mon_wake_source *src = &mon_wake_sources[i];
+
+		if (src->fd != fd ||
+		    src->events != events ||
+		    src->period_usec != period_usec)
+			continue;
+
+		// fd sources belong to a single device
+		if (fd >= 0 && src->entries[0].device != d)
+			continue;
+
+		return src;
+	}
+
+	return NULL;
+}
+
+STATIC int mon_add_wake_entry(fpgad_monitored_device *d,
+			      unsigned detection,
+			      uint32_t default_period_usec)
+{
+	fpgad_detection_source *ds = d->detection_sources ?
+		&d->detection_sources[detection] : NULL;
+	int fd = ds ? ds->fd : -1;
+	uint32_t events = fd >= 0 ? ds->events : 0;
+	uint32_t period_usec = ds && ds->period_usec ?
+		ds->period_usec : default_period_usec;
+	mon_wake_source *src;
+	mon_wake_entry *entries;
+
+	src = mon_find_wake_source(d, fd, events, period_usec);
+	if (!src) {
+		src = realloc(mon_wake_sources,
+				   (mon_num_wake_sources + 1) *
+				   sizeof(mon_wake_source));
+		if (!src)
+			return 1;
+		mon_wake_sources = src;
+
+		src = &mon_wake_sources[mon_num_wake_sources++];
+		memset(src, 0, sizeof(*src));
+		src->fd = fd;
+		src->events = events;
+		src->period_usec = period_usec;
+		src->timer_fd = -1;
+	}
+
+	entries = realloc(src->entries,
+			       (src->num_entries + 1) * sizeof(mon_wake_entry));
+	if (!entries)
+		return 1;
+	src->entries = entries;
+
+	memset(&entries[src->num_entries], 0, sizeof(mon_wake_entry));
+	entries[src->num_entries].device = d;
+	entries[src->num_entries].detection = detection;
+	++src->num_entries;
+
+	return 0;
+}
+
+STATIC int mon_create_timer(uint32_t period_usec, bool immediate)
+{
+	struct itimerspec its;
+	int fd;
+
+	fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (fd < 0) {
+		LOG("timerfd_create failed: %s\n", strerror(errno));
+		return -1;
+	}
+
+	its.it_interval.tv_sec = period_usec / 1000000;
+	its.it_interval.tv_nsec = (period_usec % 1000000) * 1000;
+	if (immediate) {
+		// run once right away, as the polling loop does
+		its.it_value.tv_sec = 0;
+		its.it_value.tv_nsec = 1;
+	} else {
+		its.it_value = its.it_interval;
+	}
+
+	if (timerfd_settime(fd, 0, &its, NULL)) {
+		LOG("timerfd_settime failed: %s\n", strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+STATIC int mon_epoll_add(int epfd, int fd, uint32_t events, uint64_t data)
+{
+	struct epoll_event ev;
+
+	memset(&ev, 0, sizeof(ev));
+	ev.events = events;
+	ev.data.u64 = data;
+
+	if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev)) {
+		LOG("epoll_ctl(%d) failed: %s\n", fd, strerror(errno));
+		return 1;
+	}
+
+	return 0;
+}
+
+STATIC void mon_free_wake_sources(void)
+{
+	unsigned i;
+
+	for (i = 0 ; i < mon_num_wake_sources ; ++i) {
+		// plugins own src->fd
+		if (mon_wake_sources[i].timer_fd >= 0)
+			close(mon_wake_sources[i].timer_fd);
+		if (mon_wake_sources[i].entries)
+			free(mon_wake_sources[i].entries);
+	}
+
+	if (mon_wake_sources)
+		free(mon_wake_sources);
+	mon_wake_sources = NULL;
+	mon_num_wake_sources = 0;
+}
+
+// wake source i is registered as (i << 1) for its fd
+// and (i << 1) | 1 for its timer
+STATIC int mon_build_wake_sources(struct fpgad_config *c, int epfd)
+{
+	fpgad_monitored_device *d;
+	unsigned i;
+	int err;
+	int res = 0;
+
+	fpgad_mutex_lock(err, &mon_list_lock);
+
+	for (d = monitored_device_list ; d && !res ; d = d->next) {
+		if (d->type != FPGAD_PLUGIN_TYPE_CALLBACK || !d->detections)
+			continue;
+
+		for (i = 0 ; d->detections[i] && !res ; ++i)
+			res = mon_add_wake_entry(d, i, c->poll_interval_usec);
+	}
+
+	for (i = 0 ; i < mon_num_wake_sources && !res ; ++i) {
+		mon_wake_source *src = &mon_wake_sources[i];
+
+		if (src->fd >= 0)
+			res = mon_epoll_add(epfd, src->fd, src->events,
+					    (uint64_t)i << 1);
+		if (res)
+			break;
+
+		src->timer_fd = mon_create_timer(src->period_usec, true);
+		if (src->timer_fd < 0) {
+			res = 1;
+			break;
+		}
+
+		res = mon_epoll_add(epfd, src->timer_fd, EPOLLIN,
+				    ((uint64_t)i << 1) | 1);
+	}
+
+	fpgad_mutex_unlock(err, &mon_list_lock);
+
+	return res;
+}
+
+STATIC void mon_drain(int fd, uint32_t events)
+{
+	char buf[64];
+	uint64_t count;
+
+	if (events & EPOLLPRI) {
+		// sysfs_notify() stays pending until the
+		// attribute is read again from the start.
+		if (pread(fd, buf, sizeof(buf), 0) < 0)
+			LOG("pread(%d) failed: %s\n", fd, strerror(errno));
+	} else {
+		if (read(fd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+			LOG("read(%d) failed: %s\n", fd, strerror(errno));
+	}
+}
+
+STATIC void mon_wake(mon_wake_source *src, bool timer, uint64_t wake_nsec)
+{
+	unsigned i;
+	int err;
+
+	mon_drain(timer ? src->timer_fd : src->fd,
+		  timer ? EPOLLIN : src->events);
+
+	fpgad_mutex_lock(err, &mon_list_lock);
+
+	for (i = 0 ; i < src->num_entries ; ++i) {
+		mon_wake_entry *e = &src->entries[i];
+		fpgad_detection_status status;
+		uint64_t cpu_start;
+		uint64_t latency;
+		uint64_t cpu;
+
+		cpu_start = mon_clock_nsec(CLOCK_THREAD_CPUTIME_ID);
+
+		status = mon_detect(e->device, e->detection);
+
+		cpu = mon_clock_nsec(CLOCK_THREAD_CPUTIME_ID) - cpu_start;
+		latency = mon_clock_nsec(CLOCK_MONOTONIC) - wake_nsec;
+
+		mon_stats_add(&e->stats, status, latency, cpu);
+		mon_stats_add(&src->interval, status, latency, cpu);
+	}
+
+	fpgad_mutex_unlock(err, &mon_list_lock);
+}
+
+// 0 when the loop ran until global->running went false
+STATIC int mon_event_loop(monitor_thread_config *c)
+{
+	struct epoll_event events[MON_EPOLL_MAX_EVENTS];
+	int stats_fd = -1;
+	int epfd;
+	int res = 1;
+	int n;
+	int i;
+
+	epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (epfd < 0) {
+		LOG("epoll_create1 failed: %s\n", strerror(errno));
+		return 1;
+	}
+
+	if (mon_build_wake_sources(c->global, epfd))
+		goto out_free;
+
+	stats_fd = mon_create_timer(MON_STATS_INTERVAL_SEC * 1000000, false);
+	if (stats_fd < 0 ||
+	    mon_epoll_add(epfd, stats_fd, EPOLLIN, MON_STATS_EVENT))
+		goto out_free;
+
+	LOG("event monitor waiting on %u wake sources\n",
+	    mon_num_wake_sources);
+
+	while (c->global->running) {
+		uint64_t now;
+
+		n = epoll_wait(epfd, events, MON_EPOLL_MAX_EVENTS,
+			       MON_EPOLL_TIMEOUT_MSEC);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			LOG("epoll_wait failed: %s\n", strerror(errno));
+			goto out_free;
+		}
+
+		now = mon_clock_nsec(CLOCK_MONOTONIC);
+
+		for (i = 0 ; i < n ; ++i) {
+			uint64_t data = events[i].data.u64;
+
+			if (data == MON_STATS_EVENT) {
+				mon_drain(stats_fd, EPOLLIN);
+				mon_log_wake_stats(false);
+				continue;
 			}
+
+			mon_wake(&mon_wake_sources[data >> 1],
+				 data & 1, now);
 		}
 	}
+
+	mon_log_wake_stats(true);
+	res = 0;
+
+out_free:
+	if (stats_fd >= 0)
+		close(stats_fd);
+	mon_free_wake_sources();
+	close(epfd);
+	return res;
 }
 
 STATIC volatile bool mon_is_ready = (bool)0;
@@ -148,6 +568,12 @@ void *monitor_thread(void *thread_context)
 
 	mon_is_ready = true;
 
+	if (c->global->event_monitor && c->global->running) {
+		if (!mon_event_loop(c))
+			goto out_stop;
+		LOG("event monitor failed. Falling back to polling.\n");
+	}
+
 	while (c->global->running) {
 		fpgad_mutex_lock(err, &mon_list_lock);
 
@@ -160,6 +586,7 @@ void *monitor_thread(void *thread_context)
 		usleep(c->global->poll_interval_usec);
 	}
 
+out_stop:
 	while (evt_dispatcher_is_ready()) {
 		// Wait for the event dispatcher to complete
 		// before we destroy the monitored devices.
@@ -48,6 +48,18 @@ typedef fpgad_detection_status
 typedef void (*fpgad_respond_event_t)(struct _fpgad_monitored_device *dev,
 				      void *context);
 
+// Wake source for one detection, used when the monitor runs in
+// event mode (fpgad --event-monitor). The detection is called when
+// fd becomes ready for events, and every period_usec in any case.
+// The monitor drains fd before calling the detection: it reads the
+// 8-byte count of an eventfd (EPOLLIN), and re-reads a sysfs
+// attribute from offset 0 (EPOLLPRI).
+typedef struct _fpgad_detection_source {
+	int fd;               // pollable fd, or -1 for a timer only
+	uint32_t events;      // EPOLLIN or EPOLLPRI
+	uint32_t period_usec; // 0 selects the global poll interval
+} fpgad_detection_source;
+
 typedef void * (*fpgad_plugin_thread_t)(void *context);
 typedef void (*fpgad_plugin_thread_stop_t)(void);
 
@@ -70,6 +82,10 @@ typedef struct _fpgad_monitored_device {
 	fpgad_respond_event_t *responses;
 	void **response_contexts;
 
+	// optional, parallel to detections. When NULL, each
+	// detection runs at the global poll interval.
+	fpgad_detection_source *detection_sources;
+
 	// }
 
 	// for type FPGAD_PLUGIN_TYPE_THREAD {
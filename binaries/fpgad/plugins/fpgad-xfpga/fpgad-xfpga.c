@@ -28,8 +28,12 @@
 #include <config.h>
 #endif // HAVE_CONFIG_H
 
+#include <stddef.h>
+#include <sys/epoll.h>
+
 #include "fpgad/api/opae_events_api.h"
 #include "fpgad/api/device_monitoring.h"
+#include "mock/opae_std.h"
 
 #ifdef LOG
 #undef LOG
@@ -951,6 +955,132 @@ STATIC void *fpgad_xfpga_fme_response_contexts[] = {
 	NULL
 };
 
+// Event monitor wake sources. FME errors, AP6 included, wake on the
+// FME error interrupt when the hardware has one, backed by a timer at
+// FPGAD_XFPGA_ERROR_PERIOD_USEC. Without the interrupt, FME AP6 stays
+// at the global poll interval and the other errors use the timer.
+//
+// Port power state, AP1/AP2 and AP6 detections always poll at the
+// global interval. The ap1_event, ap2_event and power_state attributes
+// are never sysfs_notify()'d by the driver, so POLLPRI does not fire
+// for them, and the port error interrupt can only be registered
+// through an open port handle. Holding the port open, even shared,
+// would make every exclusive fpgaOpen() of the AFU fail with
+// FPGA_BUSY. The remaining port errors only log and use the timer.
+#define FPGAD_XFPGA_ERROR_PERIOD_USEC (1000 * 1000)
+
+typedef struct _fpgad_xfpga_events {
+	fpga_handle handle;
+	fpga_event_handle event_handle;
+	fpgad_detection_source sources[];
+} fpgad_xfpga_events;
+
+STATIC int fpgad_xfpga_error_eventfd(fpgad_monitored_device *d,
+				     fpgad_xfpga_events *ev)
+{
+	fpga_result res;
+	int fd = -1;
+
+	res = fpgaOpen(d->token, &ev->handle, FPGA_OPEN_SHARED);
+	if (res != FPGA_OK) {
+		LOG("failed to open FME for error events\n");
+		return -1;
+	}
+
+	res = fpgaCreateEventHandle(&ev->event_handle);
+	if (res != FPGA_OK) {
+		LOG("failed to create event handle\n");
+		goto out_close;
+	}
+
+	res = fpgaRegisterEvent(ev->handle, FPGA_EVENT_ERROR,
+				ev->event_handle, 0);
+	if (res != FPGA_OK) {
+		LOG("no FME error interrupt. Using timers only.\n");
+		goto out_destroy;
+	}
+
+	res = fpgaGetOSObjectFromEventHandle(ev->event_handle, &fd);
+	if (res == FPGA_OK)
+		return fd;
+
+	LOG("failed to get event fd from event handle\n");
+	fpgaUnregisterEvent(ev->handle, FPGA_EVENT_ERROR, ev->event_handle);
+out_destroy:
+	fpgaDestroyEventHandle(&ev->event_handle);
+out_close:
+	fpgaClose(ev->handle);
+	ev->handle = NULL;
+	return -1;
+}
+
+STATIC void fpgad_xfpga_add_sources(fpgad_monitored_device *d)
+{
+	fpgad_xfpga_events *ev;
+	unsigned num_detections;
+	unsigned i;
+	int fd = -1;
+
+	for (num_detections = 0 ;
+	     d->detections[num_detections] ;
+	     ++num_detections)
+		/* count */ ;
+
+	ev = opae_calloc(1, sizeof(fpgad_xfpga_events) +
+			    num_detections * sizeof(fpgad_detection_source));
+	if (!ev) {
+		LOG("calloc failed\n");
+		return;
+	}
+
+	if (d->object_type == FPGA_DEVICE)
+		fd = fpgad_xfpga_error_eventfd(d, ev);
+
+	for (i = 0 ; i < num_detections ; ++i) {
+		fpgad_detect_event_t detect = d->detections[i];
+
+		ev->sources[i].fd = -1;
+
+		if (detect == fpgad_xfpga_detect_AP1_or_AP2 ||
+		    detect == fpgad_xfpga_detect_PowerStateChange ||
+		    detect == fpgad_xfpga_detect_High_Priority_Error)
+			continue;
+
+		if (fd < 0 && d->responses[i] == fpgad_xfpga_respond_AP6)
+			continue;
+
+		ev->sources[i].period_usec = FPGAD_XFPGA_ERROR_PERIOD_USEC;
+
+		if (fd >= 0) {
+			ev->sources[i].fd = fd;
+			ev->sources[i].events = EPOLLIN;
+		}
+	}
+
+	d->detection_sources = ev->sources;
+}
+
+STATIC void fpgad_xfpga_remove_sources(fpgad_monitored_device *d)
+{
+	fpgad_xfpga_events *ev;
+
+	if (!d->detection_sources)
+		return;
+
+	ev = (fpgad_xfpga_events *)((char *)d->detection_sources -
+				    offsetof(fpgad_xfpga_events, sources));
+
+	if (ev->handle) {
+		fpgaUnregisterEvent(ev->handle, FPGA_EVENT_ERROR,
+				    ev->event_handle);
+		fpgaDestroyEventHandle(&ev->event_handle);
+		fpgaClose(ev->handle);
+	}
+
+	d->detection_sources = NULL;
+	opae_free(ev);
+}
+
 int fpgad_plugin_configure(fpgad_monitored_device *d,
 			   const char *cfg)
 {
@@ -977,6 +1107,9 @@ int fpgad_plugin_configure(fpgad_monitored_device *d,
 		d->response_contexts = fpgad_xfpga_fme_response_contexts;
 	}
 
+	if (d->config && d->config->event_monitor)
+		fpgad_xfpga_add_sources(d);
+
 	return 0;
 }
 
@@ -988,4 +1121,6 @@ void fpgad_plugin_destroy(fpgad_monitored_device *d)
 			d->object_id,
 			d->object_type == FPGA_ACCELERATOR ?
 			"accelerator" : "device");
+
+	fpgad_xfpga_remove_sources(d);
 }
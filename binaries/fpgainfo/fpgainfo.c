@@ -55,6 +55,7 @@ STATIC const char *fpgainfo_interface_to_str(fpga_interface ifc)
 	case FPGA_IFC_SIM_DFL: return "Simulated DFL";
 	case FPGA_IFC_SIM_VFIO: return "Simulated VFIO";
 	case FPGA_IFC_UIO: return "UIO";
+	case FPGA_IFC_EMU: return "Emulated";
 	default: return "<unknown>";
 	}
 }
@@ -0,0 +1,580 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif // _GNU_SOURCE
+#include <errno.h>
+#include <getopt.h>
+#include <grp.h>
+#include <poll.h>
+#include <pwd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fpgaremoted.h"
+#include "opae_remote.h"
+#include "mock/opae_std.h"
+
+#ifdef LOG
+#undef LOG
+#endif
+#define LOG(format, ...) \
+log_printf("main: " format, ##__VA_ARGS__)
+
+#define OPT_STR ":hdl:p:s:t:k:ig:Sv"
+
+STATIC struct option longopts[] = {
+	{ "help",         no_argument,       NULL, 'h' },
+	{ "daemon",       no_argument,       NULL, 'd' },
+	{ "logfile",      required_argument, NULL, 'l' },
+	{ "pidfile",      required_argument, NULL, 'p' },
+	{ "socket",       required_argument, NULL, 's' },
+	{ "tcp",          required_argument, NULL, 't' },
+	{ "token-file",   required_argument, NULL, 'k' },
+	{ "tcp-insecure", no_argument,       NULL, 'i' },
+	{ "group",        required_argument, NULL, 'g' },
+	{ "no-shm",       no_argument,       NULL, 'S' },
+	{ "version",      no_argument,       NULL, 'v' },
+
+	{ 0, 0, 0, 0 }
+};
+
+#define DEFAULT_DIR_ROOT "/var/lib/opae"
+#define DEFAULT_LOG      "fpgaremoted.log"
+#define DEFAULT_PID      "fpgaremoted.pid"
+
+struct remoted_config remoted_config;
+
+STATIC char endpoint_storage[REMOTED_LISTEN_MAX][PATH_MAX];
+
+void sig_handler(int sig, siginfo_t *info, void *unused)
+{
+	UNUSED_PARAM(info);
+	UNUSED_PARAM(unused);
+	switch (sig) {
+	case SIGINT:
+		LOG("Got SIGINT. Exiting.\n");
+		remoted_config.running = false;
+		break;
+	case SIGTERM:
+		LOG("Got SIGTERM. Exiting.\n");
+		remoted_config.running = false;
+		break;
+	}
+}
+
+STATIC void show_help(FILE *fptr)
+{
+	fprintf(fptr, "Usage: fpgaremoted <options>\n");
+	fprintf(fptr, "\n");
+	fprintf(fptr, "\t-s,--socket <path>          listen on a unix domain socket [%s].\n",
+		REMOTE_SOCKET_DEFAULT);
+	fprintf(fptr, "\t-t,--tcp [<host>:]<port>    listen on a TCP port (may be given\n"
+		      "\t                            multiple times). Without a host, only\n"
+		      "\t                            on 127.0.0.1. Needs --token-file or\n"
+		      "\t                            --tcp-insecure.\n");
+	fprintf(fptr, "\t-k,--token-file <file>      admit only TCP clients that present\n"
+		      "\t                            the secret held in file, which must be\n"
+		      "\t                            private to its owner. Traffic is still\n"
+		      "\t                            not encrypted.\n");
+	fprintf(fptr, "\t-i,--tcp-insecure           admit any TCP client. Even on\n"
+		      "\t                            127.0.0.1, every local user can then\n"
+		      "\t                            drive the FPGAs with the daemon's rights.\n");
+	fprintf(fptr, "\t-g,--group <group>          also admit members of group on unix\n"
+		      "\t                            sockets (by default, only root and the\n"
+		      "\t                            daemon's own user).\n");
+	fprintf(fptr, "\t-S,--no-shm                 never share buffer memory with local\n"
+		      "\t                            clients; copy it instead.\n");
+	fprintf(fptr, "\t-d,--daemon                 run as daemon process.\n");
+	fprintf(fptr, "\t-l,--logfile <file>         the log file for daemon mode [%s].\n", DEFAULT_LOG);
+	fprintf(fptr, "\t-p,--pidfile <file>         the pid file for daemon mode [%s].\n", DEFAULT_PID);
+	fprintf(fptr, "\t-v,--version                display the version and exit.\n");
+	fprintf(fptr, "\n");
+	fprintf(fptr, "With neither --socket nor --tcp, the default socket is used.\n");
+}
+
+STATIC int add_endpoint(struct remoted_config *c, const char *kind,
+			const char *arg)
+{
+	char *ep;
+
+	if (c->num_endpoints >= REMOTED_LISTEN_MAX) {
+		LOG("at most %d listeners are supported.\n",
+		    REMOTED_LISTEN_MAX);
+		return 1;
+	}
+
+	ep = endpoint_storage[c->num_endpoints];
+
+	// TCP traffic is not encrypted, so a port with no host
+	// listens on the loopback address only. Listening on every
+	// address takes an explicit 0.0.0.0 or [::].
+	if (!strcmp(kind, "tcp") && !strchr(arg, ':'))
+		snprintf(ep, PATH_MAX, "tcp:127.0.0.1:%s", arg);
+	else if (!strcmp(kind, "tcp") && arg[0] == ':')
+		snprintf(ep, PATH_MAX, "tcp:127.0.0.1%s", arg);
+	else
+		snprintf(ep, PATH_MAX, "%s:%s", kind, arg);
+
+	c->endpoints[c->num_endpoints++] = ep;
+	return 0;
+}
+
+STATIC bool tcp_is_loopback(const char *ep)
+{
+	return !strncmp(ep, "tcp:127.0.0.1:", 14) ||
+	       !strncmp(ep, "tcp:localhost:", 14) ||
+	       !strncmp(ep, "tcp:[::1]:", 10);
+}
+
+/*
+ * Nothing but the token tells one TCP client from another: not even
+ * on the loopback address, which every local user can reach. So TCP
+ * takes a token, or --tcp-insecure to do without one.
+ */
+STATIC int check_tcp_endpoints(struct remoted_config *c)
+{
+	int i;
+
+	for (i = 0 ; i < c->num_endpoints ; ++i) {
+		const char *ep = c->endpoints[i];
+
+		if (strncmp(ep, "tcp:", 4))
+			continue;
+
+		if (!c->token_len && !c->tcp_insecure) {
+			LOG("%s needs --token-file or --tcp-insecure.\n", ep);
+			return 1;
+		}
+
+		if (!c->token_len)
+			LOG("warning: %s admits any %s, with the daemon's "
+			    "access to the FPGAs.\n", ep,
+			    tcp_is_loopback(ep) ? "local user" :
+			    "client that can reach it");
+		else if (!tcp_is_loopback(ep))
+			LOG("warning: traffic on %s, the token included, "
+			    "is not encrypted.\n", ep);
+	}
+
+	return 0;
+}
+
+STATIC int parse_group(struct remoted_config *c, const char *arg)
+{
+	struct group *grp;
+	char *endptr = NULL;
+	unsigned long gid;
+
+	grp = getgrnam(arg);
+	if (grp) {
+		c->group = grp->gr_gid;
+		c->have_group = true;
+		return 0;
+	}
+
+	gid = strtoul(arg, &endptr, 0);
+	if (!*arg || *endptr) {
+		LOG("unknown group %s\n", arg);
+		return 1;
+	}
+
+	c->group = (gid_t)gid;
+	c->have_group = true;
+	return 0;
+}
+
+STATIC int parse_args(struct remoted_config *c, int argc, char *argv[])
+{
+	int getopt_ret;
+	int option_index;
+	size_t len;
+
+	while (-1 != (getopt_ret = getopt_long(argc, argv, OPT_STR, longopts, &option_index))) {
+		const char *tmp_optarg = optarg;
+
+		if (optarg && ('=' == *tmp_optarg))
+			++tmp_optarg;
+
+		switch (getopt_ret) {
+		case 'h':
+			show_help(stdout);
+			return -2;
+
+		case 'd':
+			c->daemon = true;
+			break;
+
+		case 'l':
+			len = strnlen(tmp_optarg, PATH_MAX - 1);
+			memcpy(c->logfile, tmp_optarg, len);
+			c->logfile[len] = '\0';
+			break;
+
+		case 'p':
+			len = strnlen(tmp_optarg, PATH_MAX - 1);
+			memcpy(c->pidfile, tmp_optarg, len);
+			c->pidfile[len] = '\0';
+			break;
+
+		case 's':
+			if (add_endpoint(c, "unix", tmp_optarg))
+				return 1;
+			break;
+
+		case 't':
+			if (add_endpoint(c, "tcp", tmp_optarg))
+				return 1;
+			break;
+
+		case 'k':
+			if (remote_read_token(tmp_optarg, c->token,
+					      &c->token_len)) {
+				LOG("failed to read token from %s\n",
+				    tmp_optarg);
+				return 1;
+			}
+			break;
+
+		case 'i':
+			c->tcp_insecure = true;
+			break;
+
+		case 'g':
+			if (parse_group(c, tmp_optarg))
+				return 1;
+			break;
+
+		case 'S':
+			c->shm = false;
+			break;
+
+		case 'v':
+			fprintf(stdout, "fpgaremoted %s %s%s\n",
+					OPAE_VERSION,
+					OPAE_GIT_COMMIT_HASH,
+					OPAE_GIT_SRC_TREE_DIRTY ? "*":"");
+			return -2;
+
+		case ':':
+			LOG("Missing option argument.\n");
+			return 1;
+
+		default:
+			LOG("Invalid command option.\n");
+			return 1;
+		}
+	}
+
+	if (!c->num_endpoints)
+		return add_endpoint(c, "unix", REMOTE_SOCKET_DEFAULT);
+
+	return check_tcp_endpoints(c);
+}
+
+/*
+ * Run from /var/lib/opae as root and from ~/.opae otherwise, as
+ * fpgad does. Relative log and pid file names are kept there.
+ */
+STATIC int canonicalize_paths(struct remoted_config *c)
+{
+	struct passwd *passwd;
+	char path[PATH_MAX];
+	mode_t mode = 0755;
+
+	if (!geteuid()) {
+		snprintf(c->directory, sizeof(c->directory), "%s",
+			 DEFAULT_DIR_ROOT);
+		c->filemode = 0026;
+	} else {
+		passwd = getpwuid(geteuid());
+		if (!passwd || !passwd->pw_dir) {
+			LOG("failed to find home directory.\n");
+			return 1;
+		}
+		snprintf(c->directory, sizeof(c->directory), "%s/.opae",
+			 passwd->pw_dir);
+		mode = 0775;
+		c->filemode = 0022;
+	}
+
+	if (mkdir(c->directory, mode) && errno != EEXIST) {
+		LOG("mkdir(%s) failed: %s\n", c->directory, strerror(errno));
+		return 1;
+	}
+
+	if (!c->logfile[0])
+		snprintf(c->logfile, sizeof(c->logfile), "%s", DEFAULT_LOG);
+	if (c->logfile[0] != '/') {
+		if (snprintf(path, sizeof(path), "%s/%s",
+			     c->directory, c->logfile) >= (int)sizeof(path)) {
+			LOG("log file path too long.\n");
+			return 1;
+		}
+		memcpy(c->logfile, path, sizeof(path));
+	}
+
+	if (!c->pidfile[0])
+		snprintf(c->pidfile, sizeof(c->pidfile), "%s", DEFAULT_PID);
+	if (c->pidfile[0] != '/') {
+		if (snprintf(path, sizeof(path), "%s/%s",
+			     c->directory, c->pidfile) >= (int)sizeof(path)) {
+			LOG("pid file path too long.\n");
+			return 1;
+		}
+		memcpy(c->pidfile, path, sizeof(path));
+	}
+
+	return 0;
+}
+
+/*
+ * Anyone who can connect to a UNIX socket could otherwise drive the
+ * FPGAs with the daemon's rights, so the peer must be root, the
+ * daemon's own user, or (with --group) a member of the group.
+ */
+STATIC bool unix_peer_allowed(int sock)
+{
+	struct ucred cred;
+	socklen_t len = sizeof(cred);
+
+	if (getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &len)) {
+		LOG("SO_PEERCRED failed: %s\n", strerror(errno));
+		return false;
+	}
+
+	if (!cred.uid || cred.uid == geteuid())
+		return true;
+
+	if (remoted_config.have_group) {
+		if (cred.gid == remoted_config.group)
+			return true;
+#ifdef SO_PEERGROUPS
+		{
+			gid_t groups[256];
+			socklen_t glen = sizeof(groups);
+			size_t i;
+
+			if (!getsockopt(sock, SOL_SOCKET, SO_PEERGROUPS,
+					groups, &glen)) {
+				for (i = 0 ; i < glen / sizeof(gid_t) ; ++i) {
+					if (groups[i] == remoted_config.group)
+						return true;
+				}
+			}
+		}
+#endif // SO_PEERGROUPS
+	}
+
+	LOG("refused unix client pid %d uid %u gid %u\n",
+	    cred.pid, cred.uid, cred.gid);
+	return false;
+}
+
+/*
+ * With --group, hand the socket to the group so that its members
+ * can connect; otherwise only its owner can.
+ */
+STATIC int unix_socket_access(const char *endpoint)
+{
+	const char *path = endpoint;
+
+	if (!strncmp(path, "unix:", 5))
+		path += 5;
+
+	if (remoted_config.have_group &&
+	    chown(path, (uid_t)-1, remoted_config.group)) {
+		LOG("chown(%s) failed: %s\n", path, strerror(errno));
+		return 1;
+	}
+
+	if (chmod(path, remoted_config.have_group ? 0660 : 0600)) {
+		LOG("chmod(%s) failed: %s\n", path, strerror(errno));
+		return 1;
+	}
+
+	return 0;
+}
+
+STATIC void accept_loop(struct pollfd *pfds, int num)
+{
+	int i;
+
+	while (remoted_config.running) {
+		int res = poll(pfds, num, 1000);
+
+		if (res < 0) {
+			if (errno != EINTR)
+				LOG("poll failed: %s\n", strerror(errno));
+			continue;
+		}
+
+		session_reap();
+
+		for (i = 0 ; i < num && res > 0 ; ++i) {
+			bool is_unix;
+			int sock;
+
+			if (!(pfds[i].revents & POLLIN))
+				continue;
+
+			sock = accept4(pfds[i].fd, NULL, NULL, SOCK_CLOEXEC);
+			if (sock < 0) {
+				LOG("accept failed: %s\n", strerror(errno));
+				continue;
+			}
+
+			is_unix = strncmp(remoted_config.endpoints[i], "tcp:", 4);
+			if (is_unix && !unix_peer_allowed(sock)) {
+				opae_close(sock);
+				continue;
+			}
+
+			if (session_start(sock, is_unix))
+				opae_close(sock);
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	struct pollfd pfds[REMOTED_LISTEN_MAX];
+	int num_listening = 0;
+	int res;
+	int i;
+	FILE *fp;
+
+	memset(&remoted_config, 0, sizeof(remoted_config));
+	remoted_config.shm = true;
+	remoted_config.running = true;
+
+	log_set(stdout);
+
+	res = parse_args(&remoted_config, argc, argv);
+	if (res != 0) {
+		if (res == -2)
+			res = 0;
+		else
+			LOG("error parsing command line.\n");
+		goto out_log_close;
+	}
+
+	// Keep libopae-remote from connecting to this (or any) server
+	// when it is enabled in the configuration this process loads.
+	setenv(REMOTE_SERVER_ENV, "1", 1);
+
+	if (canonicalize_paths(&remoted_config)) {
+		res = 1;
+		goto out_log_close;
+	}
+
+	if (remoted_config.daemon) {
+		res = daemonize(sig_handler,
+				remoted_config.filemode,
+				remoted_config.directory);
+		if (res != 0) {
+			LOG("daemonize failed: %s\n", strerror(res));
+			goto out_log_close;
+		}
+	} else {
+		struct sigaction sa;
+
+		memset(&sa, 0, sizeof(sa));
+		sa.sa_flags = SA_SIGINFO | SA_RESETHAND;
+		sa.sa_sigaction = sig_handler;
+
+		if (sigaction(SIGINT, &sa, NULL) < 0 ||
+		    sigaction(SIGTERM, &sa, NULL) < 0) {
+			LOG("failed to register signal handlers.\n");
+			res = 1;
+			goto out_log_close;
+		}
+	}
+
+	if (remoted_config.daemon && log_open(remoted_config.logfile) < 0) {
+		LOG("failed to open log file\n");
+		res = 1;
+		goto out_log_close;
+	}
+
+	fp = opae_fopen(remoted_config.pidfile, "w");
+	if (NULL == fp) {
+		LOG("failed to open pid file\n");
+		res = 1;
+		goto out_log_close;
+	}
+	fprintf(fp, "%d\n", getpid());
+	opae_fclose(fp);
+
+	for (i = 0 ; i < remoted_config.num_endpoints ; ++i) {
+		pfds[i].fd = remote_listen(remoted_config.endpoints[i]);
+		pfds[i].events = POLLIN;
+		pfds[i].revents = 0;
+		if (pfds[i].fd < 0) {
+			LOG("failed to listen on %s\n",
+			    remoted_config.endpoints[i]);
+			res = 1;
+			goto out_close;
+		}
+		++num_listening;
+
+		if (strncmp(remoted_config.endpoints[i], "tcp:", 4) &&
+		    unix_socket_access(remoted_config.endpoints[i])) {
+			res = 1;
+			goto out_close;
+		}
+
+		LOG("listening on %s\n", remoted_config.endpoints[i]);
+	}
+
+	accept_loop(pfds, num_listening);
+
+	session_stop_all();
+
+out_close:
+	for (i = 0 ; i < num_listening ; ++i) {
+		opae_close(pfds[i].fd);
+		if (strncmp(remoted_config.endpoints[i], "tcp:", 4)) {
+			const char *path = remoted_config.endpoints[i];
+
+			if (!strncmp(path, "unix:", 5))
+				path += 5;
+			unlink(path);
+		}
+	}
+	unlink(remoted_config.pidfile);
+out_log_close:
+	log_close();
+	return res;
+}
@@ -0,0 +1,76 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifndef __FPGAREMOTED_H__
+#define __FPGAREMOTED_H__
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <opae/fpga.h>
+
+#include "fpgad/api/logging.h"
+#include "remote_proto.h"
+
+#define REMOTED_LISTEN_MAX 8
+
+struct remoted_config {
+	const char *endpoints[REMOTED_LISTEN_MAX];
+	int num_endpoints;
+	bool shm;
+	bool daemon;
+	char directory[PATH_MAX];
+	char logfile[PATH_MAX];
+	char pidfile[PATH_MAX];
+	mode_t filemode;
+	bool have_group;
+	gid_t group; //< Also admitted on UNIX sockets, with have_group.
+	uint8_t token[REMOTE_TOKEN_MAX]; //< Required of TCP clients.
+	uint32_t token_len;
+	bool tcp_insecure;
+
+	volatile bool running;
+};
+
+extern struct remoted_config remoted_config;
+
+/*
+ * Serve one client connection on a thread of its own. The session
+ * owns sock from here on.
+ */
+int session_start(int sock, bool is_unix);
+
+// Join the threads of sessions whose client has disconnected.
+void session_reap(void);
+
+// Disconnect every client and release what they held open.
+void session_stop_all(void);
+
+#endif /* __FPGAREMOTED_H__ */
@@ -0,0 +1,1205 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif // _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fpgaremoted.h"
+#include "opae_int.h"
+#include "mock/opae_std.h"
+
+#ifdef LOG
+#undef LOG
+#endif
+#define LOG(format, ...) \
+log_printf("session: " format, ##__VA_ARGS__)
+
+#define SESSION_PAGE_SIZE 4096
+#define SESSION_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#define SESSION_ROUND(__len, __size) \
+	(((__len) + (__size) - 1) & ~((uint64_t)(__size) - 1))
+
+typedef struct _session_token {
+	uint64_t id;
+	fpga_token token;
+	fpga_objtype objtype;
+	uint64_t object_id;
+	struct _session_token *next;
+} session_token;
+
+typedef struct _session_handle {
+	uint64_t id;
+	fpga_handle handle;
+	struct _session_handle *next;
+} session_handle;
+
+typedef struct _session_buffer {
+	uint64_t handle_id;
+	fpga_handle handle;
+	uint64_t wsid;
+	uint8_t *virt;
+	uint64_t len;
+	uint64_t map_len;  //< Shared buffers only: size of the memfd mapping.
+	uint8_t *shadow;   //< Copy-mode buffers only.
+	struct _session_buffer *next;
+} session_buffer;
+
+typedef struct _session_event {
+	uint64_t handle_id;
+	fpga_handle handle;
+	uint64_t event_id; //< The client's name for the event.
+	fpga_event_type type;
+	fpga_event_handle eh;
+	int fd;
+	struct _session_event *next;
+} session_event;
+
+/*
+ * All of the state of one client. Only the session's own thread
+ * touches it, save for sock, finished and next, which the accept
+ * loop uses to stop and reap sessions.
+ */
+typedef struct _session {
+	int sock;
+	bool is_unix;
+	bool ready;        //< A HELLO has succeeded.
+	bool shm;
+	uint32_t sync_usec;
+	pthread_t thread;
+	volatile bool finished;
+
+	remote_buf in;
+	remote_buf resp;
+	remote_buf out;
+
+	uint64_t next_id;
+	session_token *tokens;
+	session_handle *handles;
+	session_buffer *buffers;
+	uint32_t num_copy_buffers;
+	session_event *events;
+	uint32_t num_events;
+
+	struct pollfd *pfds;
+	uint32_t pfds_cap;
+
+	struct _session *next;
+} session;
+
+STATIC pthread_mutex_t sessions_lock = PTHREAD_MUTEX_INITIALIZER;
+STATIC session *sessions;
+
+STATIC uint64_t session_now_usec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+STATIC session_token *session_find_token(session *s, uint64_t id)
+{
+	session_token *t;
+
+	for (t = s->tokens ; t ; t = t->next)
+		if (t->id == id)
+			return t;
+	return NULL;
+}
+
+STATIC session_handle *session_find_handle(session *s, uint64_t id)
+{
+	session_handle *h;
+
+	for (h = s->handles ; h ; h = h->next)
+		if (h->id == id)
+			return h;
+	return NULL;
+}
+
+STATIC session_buffer **session_find_buffer(session *s, uint64_t handle_id,
+				    uint64_t wsid)
+{
+	session_buffer **pb;
+
+	for (pb = &s->buffers ; *pb ; pb = &(*pb)->next)
+		if ((*pb)->handle_id == handle_id && (*pb)->wsid == wsid)
+			return pb;
+	return NULL;
+}
+
+STATIC session_event **session_find_event(session *s, uint64_t handle_id,
+				  uint64_t event_id)
+{
+	session_event **pe;
+
+	for (pe = &s->events ; *pe ; pe = &(*pe)->next)
+		if ((*pe)->handle_id == handle_id &&
+		    (*pe)->event_id == event_id)
+			return pe;
+	return NULL;
+}
+
+STATIC void session_free_buffer(session *s, session_buffer *b)
+{
+	fpgaReleaseBuffer(b->handle, b->wsid);
+
+	if (b->shadow) {
+		opae_free(b->shadow);
+		--s->num_copy_buffers;
+	} else {
+		munmap(b->virt, b->map_len);
+	}
+
+	opae_free(b);
+}
+
+STATIC void session_free_event(session *s, session_event *e)
+{
+	fpgaUnregisterEvent(e->handle, e->type, e->eh);
+	fpgaDestroyEventHandle(&e->eh);
+	--s->num_events;
+	opae_free(e);
+}
+
+// Release everything opened through handle h, then h itself.
+STATIC void session_close_handle(session *s, session_handle *h)
+{
+	session_buffer **pb = &s->buffers;
+	session_event **pe = &s->events;
+	session_handle **ph;
+
+	while (*pe) {
+		session_event *e = *pe;
+
+		if (e->handle_id == h->id) {
+			*pe = e->next;
+			session_free_event(s, e);
+		} else {
+			pe = &e->next;
+		}
+	}
+
+	while (*pb) {
+		session_buffer *b = *pb;
+
+		if (b->handle_id == h->id) {
+			*pb = b->next;
+			session_free_buffer(s, b);
+		} else {
+			pb = &b->next;
+		}
+	}
+
+	for (ph = &s->handles ; *ph ; ph = &(*ph)->next) {
+		if (*ph == h) {
+			*ph = h->next;
+			break;
+		}
+	}
+
+	fpgaClose(h->handle);
+	opae_free(h);
+}
+
+STATIC void session_cleanup(session *s)
+{
+	while (s->handles)
+		session_close_handle(s, s->handles);
+
+	while (s->tokens) {
+		session_token *t = s->tokens;
+
+		s->tokens = t->next;
+		fpgaDestroyToken(&t->token);
+		opae_free(t);
+	}
+
+	remote_buf_free(&s->in);
+	remote_buf_free(&s->resp);
+	remote_buf_free(&s->out);
+
+	if (s->pfds)
+		opae_free(s->pfds);
+	s->pfds = NULL;
+}
+
+// Queue the changed pages of every copy-mode buffer onto out.
+STATIC void session_queue_diffs(session *s)
+{
+	session_buffer *b;
+
+	for (b = s->buffers ; b ; b = b->next) {
+		if (b->shadow)
+			remote_put_buffer_diff(&s->out, b->handle_id, b->wsid,
+					       b->virt, b->shadow, b->len);
+	}
+}
+
+STATIC fpga_result op_hello(session *s, remote_reader *r, remote_buf *resp)
+{
+	uint32_t magic = remote_get_u32(r);
+	uint32_t version = remote_get_u32(r);
+	uint32_t caps = remote_get_u32(r);
+	uint32_t sync_usec = remote_get_u32(r);
+	uint32_t token_len = remote_get_u32(r);
+	const uint8_t *token;
+
+	if (r->err || magic != REMOTE_PROTO_MAGIC)
+		return FPGA_INVALID_PARAM;
+
+	if (version != REMOTE_PROTO_VERSION) {
+		LOG("client speaks protocol version %u, not %u\n",
+		    version, REMOTE_PROTO_VERSION);
+		return FPGA_NOT_SUPPORTED;
+	}
+
+	if (token_len > REMOTE_TOKEN_MAX)
+		return FPGA_INVALID_PARAM;
+	token = remote_get_bytes(r, token_len);
+	if (r->err)
+		return FPGA_INVALID_PARAM;
+
+	// UNIX clients were admitted by their credentials on accept.
+	if (!s->is_unix && remoted_config.token_len &&
+	    !remote_token_equal(remoted_config.token,
+				remoted_config.token_len,
+				token, token_len)) {
+		LOG("refused tcp client: wrong token\n");
+		return FPGA_NO_ACCESS;
+	}
+
+	// Shared memory only works between processes on the same host.
+	s->shm = (caps & REMOTE_CAP_SHM) && s->is_unix && remoted_config.shm;
+	s->sync_usec = sync_usec;
+
+	remote_put_u32(resp, REMOTE_PROTO_VERSION);
+	remote_put_u32(resp, s->shm ? REMOTE_CAP_SHM : 0);
+
+	s->ready = true;
+	return FPGA_OK;
+}
+
+STATIC fpga_result put_token_props(fpga_token token, remote_buf *b,
+				   remote_props *p)
+{
+	fpga_properties props = NULL;
+	fpga_result res;
+
+	res = fpgaGetProperties(token, &props);
+	if (res != FPGA_OK)
+		return res;
+
+	remote_props_from_properties(props, p);
+	fpgaDestroyProperties(&props);
+
+	remote_put_props(b, p);
+	return FPGA_OK;
+}
+
+/*
+ * Tokens keep their id for the life of the session, so that a
+ * client may hold on to tokens across fpgaEnumerateRefresh().
+ */
+STATIC fpga_result op_enumerate(session *s, remote_buf *resp)
+{
+	fpga_token *tokens = NULL;
+	uint32_t num_matches = 0;
+	uint32_t count = 0;
+	remote_buf entries;
+	fpga_result res;
+	uint32_t i;
+
+	res = fpgaEnumerate(NULL, 0, NULL, 0, &num_matches);
+	if (res != FPGA_OK)
+		return res;
+
+	if (num_matches) {
+		tokens = opae_calloc(num_matches, sizeof(fpga_token));
+		if (!tokens)
+			return FPGA_NO_MEMORY;
+
+		res = fpgaEnumerate(NULL, 0, tokens, num_matches,
+				    &num_matches);
+		if (res != FPGA_OK) {
+			opae_free(tokens);
+			return res;
+		}
+	}
+
+	remote_buf_init(&entries);
+
+	for (i = 0 ; i < num_matches && tokens[i] ; ++i) {
+		session_token *t;
+		remote_props p;
+		size_t mark = entries.len;
+
+		remote_put_u64(&entries, 0);
+		if (put_token_props(tokens[i], &entries, &p) != FPGA_OK) {
+			entries.len = mark;
+			fpgaDestroyToken(&tokens[i]);
+			continue;
+		}
+
+		for (t = s->tokens ; t ; t = t->next)
+			if (t->objtype == p.objtype &&
+			    t->object_id == p.object_id)
+				break;
+
+		if (t) {
+			fpgaDestroyToken(&tokens[i]);
+		} else {
+			t = opae_calloc(1, sizeof(session_token));
+			if (!t) {
+				entries.len = mark;
+				fpgaDestroyToken(&tokens[i]);
+				continue;
+			}
+			t->id = ++s->next_id;
+			t->token = tokens[i];
+			t->objtype = p.objtype;
+			t->object_id = p.object_id;
+			t->next = s->tokens;
+			s->tokens = t;
+		}
+
+		// Patch in the token id.
+		entries.len = mark;
+		remote_put_u64(&entries, t->id);
+		remote_put_props(&entries, &p);
+		++count;
+	}
+
+	if (tokens)
+		opae_free(tokens);
+
+	remote_put_u32(resp, count);
+	remote_put_bytes(resp, entries.data, entries.len);
+	res = entries.err || resp->err ? FPGA_NO_MEMORY : FPGA_OK;
+
+	remote_buf_free(&entries);
+	return res;
+}
+
+STATIC fpga_result op_get_properties(session *s, remote_reader *r,
+				     remote_buf *resp)
+{
+	session_token *t = session_find_token(s, remote_get_u64(r));
+	remote_props p;
+
+	if (r->err || !t)
+		return FPGA_INVALID_PARAM;
+
+	return put_token_props(t->token, resp, &p);
+}
+
+STATIC fpga_result op_open(session *s, remote_reader *r, remote_buf *resp)
+{
+	session_token *t = session_find_token(s, remote_get_u64(r));
+	int flags = (int)remote_get_u32(r);
+	session_handle *h;
+	fpga_result res;
+
+	if (r->err || !t)
+		return FPGA_INVALID_PARAM;
+
+	h = opae_calloc(1, sizeof(session_handle));
+	if (!h)
+		return FPGA_NO_MEMORY;
+
+	res = fpgaOpen(t->token, &h->handle, flags);
+	if (res != FPGA_OK) {
+		opae_free(h);
+		return res;
+	}
+
+	h->id = ++s->next_id;
+	h->next = s->handles;
+	s->handles = h;
+
+	remote_put_u64(resp, h->id);
+	return FPGA_OK;
+}
+
+#define GET_HANDLE(__s, __r, __h)                             \
+	do {                                                  \
+		(__h) = session_find_handle((__s), remote_get_u64(__r)); \
+		if (!(__h))                                   \
+			return FPGA_INVALID_PARAM;            \
+	} while (0)
+
+STATIC fpga_result op_mmio(session *s, uint16_t op, remote_reader *r,
+			   remote_buf *resp)
+{
+	session_handle *h;
+	uint32_t mmio_num;
+	uint64_t offset;
+	uint64_t value = 0;
+	uint32_t value32 = 0;
+	const uint8_t *value512 = NULL;
+	fpga_result res = FPGA_INVALID_PARAM;
+
+	GET_HANDLE(s, r, h);
+	mmio_num = remote_get_u32(r);
+	offset = remote_get_u64(r);
+
+	if (op == REMOTE_OP_WRITE_MMIO512)
+		value512 = remote_get_bytes(r, 64);
+	else if (op != REMOTE_OP_READ_MMIO32 && op != REMOTE_OP_READ_MMIO64)
+		value = remote_get_u64(r);
+
+	if (r->err)
+		return FPGA_INVALID_PARAM;
+
+	switch (op) {
+	case REMOTE_OP_READ_MMIO32:
+		res = fpgaReadMMIO32(h->handle, mmio_num, offset, &value32);
+		value = value32;
+		break;
+	case REMOTE_OP_READ_MMIO64:
+		res = fpgaReadMMIO64(h->handle, mmio_num, offset, &value);
+		break;
+	case REMOTE_OP_WRITE_MMIO32:
+		return fpgaWriteMMIO32(h->handle, mmio_num, offset,
+				       (uint32_t)value);
+	case REMOTE_OP_WRITE_MMIO64:
+		return fpgaWriteMMIO64(h->handle, mmio_num, offset, value);
+	case REMOTE_OP_WRITE_MMIO512:
+		return fpgaWriteMMIO512(h->handle, mmio_num, offset, value512);
+	}
+
+	if (res == FPGA_OK)
+		remote_put_u64(resp, value);
+
+	return res;
+}
+
+STATIC fpga_result op_mmio_batch(session *s, bool is_write,
+				 remote_reader *r, remote_buf *resp)
+{
+	session_handle *h;
+	fpga_mmio_op *ops;
+	uint32_t count;
+	uint32_t i;
+	fpga_result res;
+
+	GET_HANDLE(s, r, h);
+	count = remote_get_u32(r);
+	if (r->err || !count || count > REMOTE_BATCH_MAX)
+		return FPGA_INVALID_PARAM;
+
+	ops = opae_calloc(count, sizeof(fpga_mmio_op));
+	if (!ops)
+		return FPGA_NO_MEMORY;
+
+	for (i = 0 ; i < count ; ++i) {
+		ops[i].mmio_num = remote_get_u32(r);
+		ops[i].width = remote_get_u32(r);
+		ops[i].offset = remote_get_u64(r);
+		if (is_write)
+			ops[i].value = remote_get_u64(r);
+	}
+
+	if (r->err) {
+		res = FPGA_INVALID_PARAM;
+	} else if (is_write) {
+		res = fpgaWriteMMIOBatch(h->handle, ops, count);
+	} else {
+		res = fpgaReadMMIOBatch(h->handle, ops, count);
+		for (i = 0 ; res == FPGA_OK && i < count ; ++i)
+			remote_put_u64(resp, ops[i].value);
+	}
+
+	opae_free(ops);
+	return res;
+}
+
+/*
+ * A shared buffer lives in a memfd that the client maps too, so
+ * that device writes are visible to it without any copying. Huge
+ * pages are tried first for large buffers, as with local buffers.
+ */
+STATIC int session_memfd(uint64_t len, uint64_t *map_len)
+{
+	int fd = -1;
+
+#ifdef MFD_HUGETLB
+	if (len >= SESSION_HUGE_PAGE_SIZE) {
+		*map_len = SESSION_ROUND(len, SESSION_HUGE_PAGE_SIZE);
+		fd = memfd_create("opae_remote", MFD_CLOEXEC | MFD_HUGETLB);
+		if (fd >= 0 && ftruncate(fd, *map_len)) {
+			opae_close(fd);
+			fd = -1;
+		}
+	}
+#endif
+
+	if (fd < 0) {
+		*map_len = SESSION_ROUND(len, SESSION_PAGE_SIZE);
+		fd = memfd_create("opae_remote", MFD_CLOEXEC);
+		if (fd >= 0 && ftruncate(fd, *map_len)) {
+			LOG("ftruncate failed: %s\n", strerror(errno));
+			opae_close(fd);
+			fd = -1;
+		}
+	}
+
+	return fd;
+}
+
+STATIC fpga_result op_prepare_buffer(session *s, remote_reader *r,
+				     remote_buf *resp, int *resp_fd)
+{
+	session_handle *h;
+	session_buffer *b;
+	uint64_t len;
+	uint64_t iova = 0;
+	int flags;
+	bool shm;
+	int fd = -1;
+	fpga_result res;
+
+	GET_HANDLE(s, r, h);
+	len = remote_get_u64(r);
+	flags = (int)remote_get_u32(r);
+	shm = remote_get_u32(r) & REMOTE_BUF_SHM;
+
+	if (r->err || !len || (shm && !s->shm) ||
+	    (flags & FPGA_BUF_PREALLOCATED))
+		return FPGA_INVALID_PARAM;
+
+	b = opae_calloc(1, sizeof(session_buffer));
+	if (!b)
+		return FPGA_NO_MEMORY;
+
+	b->handle_id = h->id;
+	b->handle = h->handle;
+	b->len = len;
+
+	if (shm) {
+		fd = session_memfd(len, &b->map_len);
+		if (fd < 0) {
+			res = FPGA_NO_MEMORY;
+			goto out_free;
+		}
+
+		b->virt = mmap(NULL, b->map_len, PROT_READ | PROT_WRITE,
+			       MAP_SHARED | MAP_POPULATE, fd, 0);
+		if (b->virt == MAP_FAILED) {
+			LOG("mmap failed: %s\n", strerror(errno));
+			res = FPGA_NO_MEMORY;
+			goto out_close;
+		}
+
+		res = fpgaPrepareBuffer(h->handle, len, (void **)&b->virt,
+					&b->wsid,
+					flags | FPGA_BUF_PREALLOCATED);
+		if (res != FPGA_OK) {
+			munmap(b->virt, b->map_len);
+			goto out_close;
+		}
+	} else {
+		b->shadow = opae_calloc(1, len);
+		if (!b->shadow) {
+			res = FPGA_NO_MEMORY;
+			goto out_free;
+		}
+
+		res = fpgaPrepareBuffer(h->handle, len, (void **)&b->virt,
+					&b->wsid, flags);
+		if (res != FPGA_OK) {
+			opae_free(b->shadow);
+			goto out_free;
+		}
+
+		// The client's mirror and both shadows start out zeroed.
+		memset(b->virt, 0, len);
+		++s->num_copy_buffers;
+	}
+
+	res = fpgaGetIOAddress(h->handle, b->wsid, &iova);
+	if (res != FPGA_OK && res != FPGA_NOT_SUPPORTED) {
+		session_free_buffer(s, b);
+		if (fd >= 0)
+			opae_close(fd);
+		return res;
+	}
+
+	b->next = s->buffers;
+	s->buffers = b;
+
+	remote_put_u64(resp, b->wsid);
+	remote_put_u64(resp, iova);
+	remote_put_u64(resp, b->map_len);
+
+	*resp_fd = fd;
+	return FPGA_OK;
+
+out_close:
+	opae_close(fd);
+out_free:
+	opae_free(b);
+	return res;
+}
+
+STATIC fpga_result op_release_buffer(session *s, remote_reader *r)
+{
+	uint64_t handle_id = remote_get_u64(r);
+	uint64_t wsid = remote_get_u64(r);
+	session_buffer **pb;
+	session_buffer *b;
+
+	pb = session_find_buffer(s, handle_id, wsid);
+	if (r->err || !pb)
+		return FPGA_INVALID_PARAM;
+
+	b = *pb;
+	*pb = b->next;
+	session_free_buffer(s, b);
+
+	return FPGA_OK;
+}
+
+STATIC fpga_result op_get_numa_node(session *s, remote_reader *r,
+				    remote_buf *resp)
+{
+	uint64_t handle_id = remote_get_u64(r);
+	uint64_t wsid = remote_get_u64(r);
+	session_buffer **pb;
+	fpga_result res;
+	int node = -1;
+
+	pb = session_find_buffer(s, handle_id, wsid);
+	if (r->err || !pb)
+		return FPGA_INVALID_PARAM;
+
+	res = fpgaGetBufferNumaNode((*pb)->handle, wsid, &node);
+	if (res == FPGA_OK)
+		remote_put_u32(resp, (uint32_t)node);
+
+	return res;
+}
+
+STATIC fpga_result op_buffer_data(session *s, remote_reader *r)
+{
+	uint64_t handle_id = remote_get_u64(r);
+	uint64_t wsid = remote_get_u64(r);
+	uint64_t offset = remote_get_u64(r);
+	uint32_t len = remote_get_u32(r);
+	const uint8_t *data = remote_get_bytes(r, len);
+	session_buffer **pb;
+	session_buffer *b;
+
+	pb = session_find_buffer(s, handle_id, wsid);
+	if (r->err || !pb)
+		return FPGA_INVALID_PARAM;
+
+	b = *pb;
+	if (!b->shadow || offset > b->len || len > b->len - offset)
+		return FPGA_INVALID_PARAM;
+
+	remote_merge_buffer(b->virt + offset, b->shadow + offset, data, len);
+	return FPGA_OK;
+}
+
+STATIC fpga_result op_register_event(session *s, remote_reader *r)
+{
+	session_handle *h;
+	session_event *e;
+	uint32_t flags;
+	fpga_result res;
+
+	GET_HANDLE(s, r, h);
+
+	e = opae_calloc(1, sizeof(session_event));
+	if (!e)
+		return FPGA_NO_MEMORY;
+
+	e->handle_id = h->id;
+	e->handle = h->handle;
+	e->type = (fpga_event_type)remote_get_u32(r);
+	flags = remote_get_u32(r);
+	e->event_id = remote_get_u64(r);
+
+	if (r->err || session_find_event(s, e->handle_id, e->event_id)) {
+		opae_free(e);
+		return FPGA_INVALID_PARAM;
+	}
+
+	res = fpgaCreateEventHandle(&e->eh);
+	if (res != FPGA_OK) {
+		opae_free(e);
+		return res;
+	}
+
+	res = fpgaRegisterEvent(h->handle, e->type, e->eh, flags);
+	if (res != FPGA_OK) {
+		fpgaDestroyEventHandle(&e->eh);
+		opae_free(e);
+		return res;
+	}
+
+	res = fpgaGetOSObjectFromEventHandle(e->eh, &e->fd);
+	if (res != FPGA_OK) {
+		fpgaUnregisterEvent(h->handle, e->type, e->eh);
+		fpgaDestroyEventHandle(&e->eh);
+		opae_free(e);
+		return res;
+	}
+
+	e->next = s->events;
+	s->events = e;
+	++s->num_events;
+
+	return FPGA_OK;
+}
+
+STATIC fpga_result op_unregister_event(session *s, remote_reader *r)
+{
+	uint64_t handle_id = remote_get_u64(r);
+	session_event **pe;
+	session_event *e;
+
+	remote_get_u32(r); // event type: implied by the event id
+	pe = session_find_event(s, handle_id, remote_get_u64(r));
+	if (r->err || !pe)
+		return FPGA_INVALID_PARAM;
+
+	e = *pe;
+	*pe = e->next;
+	session_free_event(s, e);
+
+	return FPGA_OK;
+}
+
+STATIC fpga_result op_error(session *s, uint16_t op, remote_reader *r,
+			    remote_buf *resp)
+{
+	session_token *t = session_find_token(s, remote_get_u64(r));
+	struct fpga_error_info info;
+	uint32_t error_num = 0;
+	uint64_t value = 0;
+	fpga_result res;
+
+	if (op != REMOTE_OP_CLEAR_ALL_ERRORS)
+		error_num = remote_get_u32(r);
+
+	if (r->err || !t)
+		return FPGA_INVALID_PARAM;
+
+	switch (op) {
+	case REMOTE_OP_READ_ERROR:
+		res = fpgaReadError(t->token, error_num, &value);
+		if (res == FPGA_OK)
+			remote_put_u64(resp, value);
+		return res;
+	case REMOTE_OP_CLEAR_ERROR:
+		return fpgaClearError(t->token, error_num);
+	case REMOTE_OP_CLEAR_ALL_ERRORS:
+		return fpgaClearAllErrors(t->token);
+	default:
+		memset(&info, 0, sizeof(info));
+		res = fpgaGetErrorInfo(t->token, error_num, &info);
+		if (res == FPGA_OK) {
+			remote_put_bytes(resp, info.name, FPGA_ERROR_NAME_MAX);
+			remote_put_u8(resp, info.can_clear ? 1 : 0);
+		}
+		return res;
+	}
+}
+
+STATIC fpga_result session_dispatch(session *s, uint16_t op,
+				    remote_reader *r, remote_buf *resp,
+				    int *resp_fd)
+{
+	session_handle *h;
+
+	if (!s->ready && op != REMOTE_OP_HELLO)
+		return FPGA_NO_ACCESS;
+
+	switch (op) {
+	case REMOTE_OP_HELLO:
+		return s->ready ? FPGA_INVALID_PARAM : op_hello(s, r, resp);
+	case REMOTE_OP_ENUMERATE:
+		return op_enumerate(s, resp);
+	case REMOTE_OP_GET_PROPERTIES:
+		return op_get_properties(s, r, resp);
+	case REMOTE_OP_OPEN:
+		return op_open(s, r, resp);
+	case REMOTE_OP_CLOSE:
+		GET_HANDLE(s, r, h);
+		session_close_handle(s, h);
+		return FPGA_OK;
+	case REMOTE_OP_RESET:
+		GET_HANDLE(s, r, h);
+		return fpgaReset(h->handle);
+	case REMOTE_OP_READ_MMIO32:
+	case REMOTE_OP_READ_MMIO64:
+	case REMOTE_OP_WRITE_MMIO32:
+	case REMOTE_OP_WRITE_MMIO64:
+	case REMOTE_OP_WRITE_MMIO512:
+		return op_mmio(s, op, r, resp);
+	case REMOTE_OP_READ_MMIO_BATCH:
+		return op_mmio_batch(s, false, r, resp);
+	case REMOTE_OP_WRITE_MMIO_BATCH:
+		return op_mmio_batch(s, true, r, resp);
+	case REMOTE_OP_PREPARE_BUFFER:
+		return op_prepare_buffer(s, r, resp, resp_fd);
+	case REMOTE_OP_RELEASE_BUFFER:
+		return op_release_buffer(s, r);
+	case REMOTE_OP_GET_NUMA_NODE:
+		return op_get_numa_node(s, r, resp);
+	case REMOTE_OP_BUFFER_DATA:
+		return op_buffer_data(s, r);
+	case REMOTE_OP_REGISTER_EVENT:
+		return op_register_event(s, r);
+	case REMOTE_OP_UNREGISTER_EVENT:
+		return op_unregister_event(s, r);
+	case REMOTE_OP_READ_ERROR:
+	case REMOTE_OP_CLEAR_ERROR:
+	case REMOTE_OP_CLEAR_ALL_ERRORS:
+	case REMOTE_OP_GET_ERROR_INFO:
+		return op_error(s, op, r, resp);
+	}
+
+	return FPGA_NOT_SUPPORTED;
+}
+
+/*
+ * Finding what the device changed takes a full compare of every
+ * copy-mode buffer, so it is done only before answering the requests
+ * after which the client looks for device writes: an MMIO read of a
+ * status register, say, or a reset. The client then sees the data
+ * that the device wrote before the request was served.
+ */
+STATIC bool session_op_syncs(uint16_t op)
+{
+	switch (op) {
+	case REMOTE_OP_RESET:
+	case REMOTE_OP_READ_MMIO32:
+	case REMOTE_OP_READ_MMIO64:
+	case REMOTE_OP_READ_MMIO_BATCH:
+		return true;
+	}
+
+	return false;
+}
+
+// Handle one request.
+STATIC int session_request(session *s, const remote_msg_hdr *h)
+{
+	remote_reader r;
+	fpga_result res;
+	bool posted = h->flags & REMOTE_F_POSTED;
+	int resp_fd = -1;
+	size_t hdr_off;
+	int ret = 0;
+
+	s->resp.len = 0;
+	s->resp.err = 0;
+	s->out.len = 0;
+	s->out.err = 0;
+
+	remote_reader_init(&r, s->in.data, s->in.len);
+
+	res = session_dispatch(s, h->op, &r, &s->resp, &resp_fd);
+	if (s->resp.err)
+		res = FPGA_NO_MEMORY;
+
+	if (posted && res == FPGA_OK)
+		return 0;
+
+	if (!posted && session_op_syncs(h->op))
+		session_queue_diffs(s);
+
+	hdr_off = remote_msg_begin(&s->out, h->op,
+				   posted ? REMOTE_F_POSTED : 0,
+				   h->seq, res);
+	if (res == FPGA_OK) {
+		remote_put_bytes(&s->out, s->resp.data, s->resp.len);
+	} else if (posted) {
+		// Name the handle, so that the client reports the
+		// failure to the caller that owns it.
+		remote_reader_init(&r, s->in.data, s->in.len);
+		remote_put_u64(&s->out, remote_get_u64(&r));
+	}
+	remote_msg_end(&s->out, hdr_off);
+
+	if (s->out.err ||
+	    remote_send(s->sock, s->out.data, s->out.len,
+			res == FPGA_OK ? resp_fd : -1))
+		ret = -1;
+
+	// A client that has not said HELLO gets its answer, and then
+	// is disconnected.
+	if (!s->ready)
+		ret = -1;
+
+	if (resp_fd >= 0)
+		opae_close(resp_fd);
+
+	return ret;
+}
+
+// Sent every sync_usec, for clients that ask for that in HELLO.
+STATIC int session_push(session *s)
+{
+	s->out.len = 0;
+	s->out.err = 0;
+
+	session_queue_diffs(s);
+
+	if (s->out.err)
+		return -1;
+
+	return s->out.len ?
+		remote_send(s->sock, s->out.data, s->out.len, -1) : 0;
+}
+
+STATIC int session_signal(session *s, session_event *e)
+{
+	uint64_t count = 0;
+	size_t hdr_off;
+
+	if (read(e->fd, &count, sizeof(count)) != sizeof(count))
+		count = 1;
+
+	s->out.len = 0;
+	s->out.err = 0;
+
+	// As with responses, the data precedes the notification.
+	session_queue_diffs(s);
+
+	hdr_off = remote_msg_begin(&s->out, REMOTE_OP_EVENT, 0, 0, 0);
+	remote_put_u64(&s->out, e->event_id);
+	remote_put_u64(&s->out, count);
+	remote_msg_end(&s->out, hdr_off);
+
+	if (s->out.err)
+		return -1;
+
+	return remote_send(s->sock, s->out.data, s->out.len, -1);
+}
+
+STATIC int session_poll(session *s)
+{
+	struct timespec ts;
+	struct timespec *timeout = NULL;
+	session_event *e;
+	uint32_t n = 1;
+
+	if (s->pfds_cap < s->num_events + 1) {
+		struct pollfd *pfds;
+
+		pfds = opae_calloc(s->num_events + 1, sizeof(struct pollfd));
+		if (!pfds)
+			return -1;
+		if (s->pfds)
+			opae_free(s->pfds);
+		s->pfds = pfds;
+		s->pfds_cap = s->num_events + 1;
+	}
+
+	s->pfds[0].fd = s->sock;
+	s->pfds[0].events = POLLIN;
+	s->pfds[0].revents = 0;
+
+	for (e = s->events ; e ; e = e->next, ++n) {
+		s->pfds[n].fd = e->fd;
+		s->pfds[n].events = POLLIN;
+		s->pfds[n].revents = 0;
+	}
+
+	if (s->num_copy_buffers && s->sync_usec) {
+		ts.tv_sec = s->sync_usec / 1000000;
+		ts.tv_nsec = (s->sync_usec % 1000000) * 1000;
+		timeout = &ts;
+	}
+
+	return ppoll(s->pfds, n, timeout, NULL);
+}
+
+STATIC void *session_thread(void *arg)
+{
+	session *s = (session *)arg;
+	uint64_t last_push = session_now_usec();
+
+	while (1) {
+		session_event *e;
+		remote_msg_hdr h;
+		uint32_t i;
+		int fd = -1;
+		int res;
+
+		res = session_poll(s);
+		if (res < 0) {
+			if (errno == EINTR)
+				continue;
+			LOG("poll failed: %s\n", strerror(errno));
+			break;
+		}
+
+		if (s->pfds[0].revents) {
+			res = remote_recv(s->sock, &h, &s->in, &fd);
+			if (fd >= 0)
+				opae_close(fd);
+			if (res)
+				break;
+			if (session_request(s, &h))
+				break;
+		}
+
+		// Events registered by the request just handled have
+		// no slot in pfds yet; they are polled next time.
+		for (e = s->events, i = 1 ; e && i < s->pfds_cap ;
+		     e = e->next, ++i) {
+			if (s->pfds[i].fd == e->fd &&
+			    (s->pfds[i].revents & POLLIN) &&
+			    session_signal(s, e))
+				goto out_cleanup;
+		}
+
+		if (s->num_copy_buffers && s->sync_usec &&
+		    session_now_usec() - last_push >= s->sync_usec) {
+			if (session_push(s))
+				break;
+			last_push = session_now_usec();
+		}
+	}
+
+out_cleanup:
+	session_cleanup(s);
+	// The socket is closed when the session is reaped; the client
+	// learns now that it was dropped.
+	shutdown(s->sock, SHUT_RDWR);
+	LOG("client disconnected\n");
+	s->finished = true;
+	return NULL;
+}
+
+int session_start(int sock, bool is_unix)
+{
+	sigset_t block;
+	sigset_t old;
+	session *s;
+	int res;
+
+	s = opae_calloc(1, sizeof(session));
+	if (!s) {
+		LOG("out of memory\n");
+		return 1;
+	}
+
+	s->sock = sock;
+	s->is_unix = is_unix;
+	remote_buf_init(&s->in);
+	remote_buf_init(&s->resp);
+	remote_buf_init(&s->out);
+
+	// Leave SIGINT and SIGTERM to the accept loop.
+	sigemptyset(&block);
+	sigaddset(&block, SIGINT);
+	sigaddset(&block, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &block, &old);
+
+	res = pthread_create(&s->thread, NULL, session_thread, s);
+
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+	if (res) {
+		LOG("failed to create session thread: %s\n", strerror(res));
+		opae_free(s);
+		return 1;
+	}
+
+	LOG("client connected\n");
+
+	opae_mutex_lock(res, &sessions_lock);
+	s->next = sessions;
+	sessions = s;
+	opae_mutex_unlock(res, &sessions_lock);
+
+	return 0;
+}
+
+void session_reap(void)
+{
+	session **ps;
+	int res;
+
+	opae_mutex_lock(res, &sessions_lock);
+
+	ps = &sessions;
+	while (*ps) {
+		session *s = *ps;
+
+		if (s->finished) {
+			*ps = s->next;
+			pthread_join(s->thread, NULL);
+			opae_close(s->sock);
+			opae_free(s);
+		} else {
+			ps = &s->next;
+		}
+	}
+
+	opae_mutex_unlock(res, &sessions_lock);
+}
+
+void session_stop_all(void)
+{
+	session *s;
+	int res;
+
+	opae_mutex_lock(res, &sessions_lock);
+
+	// Each session thread sees its peer go away and cleans up.
+	for (s = sessions ; s ; s = s->next)
+		shutdown(s->sock, SHUT_RDWR);
+
+	while (sessions) {
+		s = sessions;
+		sessions = s->next;
+		pthread_join(s->thread, NULL);
+		opae_close(s->sock);
+		opae_free(s);
+	}
+
+	opae_mutex_unlock(res, &sessions_lock);
+}
@@ -26,7 +26,10 @@
 
 #pragma once
 
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 #include <sys/ioctl.h>
 #include <opae/vfio.h>
 
@@ -69,6 +72,85 @@ struct mmio_region {
   {
     *reinterpret_cast<uint64_t *>(ptr + offset) = value;
   }
+
+  // Device registers want whole, aligned accesses, so a block is
+  // moved with 64-bit loads/stores when offset and size allow it,
+  // and 32-bit ones otherwise - never with memcpy().
+  void check_block(uint64_t offset, size_t count) const
+  {
+    if ((offset % 4) || (count % 4))
+      throw std::invalid_argument("offset and size must be 4-byte aligned");
+    if ((offset > size) || (count > size - offset))
+      throw std::out_of_range("block exceeds the region");
+  }
+
+  void read_block(uint64_t offset, uint8_t *dst, size_t count) const
+  {
+    check_block(offset, count);
+    if (!(offset % 8) && !(count % 8)) {
+      volatile uint64_t *src = reinterpret_cast<volatile uint64_t *>(ptr + offset);
+      for (size_t i = 0 ; i < count / 8 ; ++i) {
+        uint64_t value = src[i];
+        std::memcpy(dst + i * 8, &value, 8);
+      }
+    } else {
+      volatile uint32_t *src = reinterpret_cast<volatile uint32_t *>(ptr + offset);
+      for (size_t i = 0 ; i < count / 4 ; ++i) {
+        uint32_t value = src[i];
+        std::memcpy(dst + i * 4, &value, 4);
+      }
+    }
+  }
+
+  void write_block(uint64_t offset, const uint8_t *src, size_t count)
+  {
+    check_block(offset, count);
+    if (!(offset % 8) && !(count % 8)) {
+      volatile uint64_t *dst = reinterpret_cast<volatile uint64_t *>(ptr + offset);
+      for (size_t i = 0 ; i < count / 8 ; ++i) {
+        uint64_t value;
+        std::memcpy(&value, src + i * 8, 8);
+        dst[i] = value;
+      }
+    } else {
+      volatile uint32_t *dst = reinterpret_cast<volatile uint32_t *>(ptr + offset);
+      for (size_t i = 0 ; i < count / 4 ; ++i) {
+        uint32_t value;
+        std::memcpy(&value, src + i * 4, 4);
+        dst[i] = value;
+      }
+    }
+  }
+
+  // Gather count width-bit registers, one every stride bytes from
+  // offset 0, each with a single volatile load.
+  template <typename T>
+  void read_strided(size_t stride, T *dst, size_t count) const
+  {
+    for (size_t i = 0 ; i < count ; ++i)
+      dst[i] = *reinterpret_cast<volatile T *>(ptr + i * stride);
+  }
+};
+
+// A read-only snapshot of an MMIO region: every stride bytes, one
+// width-bit register, exposed through the buffer protocol. The
+// registers are copied out when the view is made; exporting the
+// mapping itself would let NumPy or bytes() copy it with memcpy().
+struct mmio_view {
+  uint32_t width;
+  size_t count;
+  std::vector<uint64_t> data;
+
+  mmio_view(const mmio_region &r, uint32_t width, size_t stride, size_t count)
+  : width(width)
+  , count(count)
+  , data((count * (width / 8) + 7) / 8)
+  {
+    if (width == 32)
+      r.read_strided(stride, reinterpret_cast<uint32_t *>(data.data()), count);
+    else
+      r.read_strided(stride, data.data(), count);
+  }
 };
 
 struct system_buffer {
@@ -34,6 +34,70 @@
 
 namespace py = pybind11;
 
+static py::bytes region_read_block(mmio_region *r, uint64_t offset, size_t size)
+{
+  r->check_block(offset, size);
+
+  py::bytes out = py::reinterpret_steal<py::bytes>(
+    PyBytes_FromStringAndSize(nullptr, static_cast<Py_ssize_t>(size)));
+  if (!out)
+    throw py::error_already_set();
+
+  uint8_t *dst = reinterpret_cast<uint8_t *>(PyBytes_AS_STRING(out.ptr()));
+  {
+    py::gil_scoped_release release;
+    r->read_block(offset, dst, size);
+  }
+  return out;
+}
+
+// Copy between a region and any contiguous Python buffer (bytearray,
+// NumPy array, system_buffer, ...) without holding the GIL.
+static void region_block_io(mmio_region *r, uint64_t offset, py::buffer data,
+                            bool write)
+{
+  Py_buffer view;
+  int flags = write ? PyBUF_SIMPLE : (PyBUF_SIMPLE | PyBUF_WRITABLE);
+
+  if (PyObject_GetBuffer(data.ptr(), &view, flags))
+    throw py::error_already_set();
+
+  try {
+    r->check_block(offset, static_cast<size_t>(view.len));
+  } catch (...) {
+    PyBuffer_Release(&view);
+    throw;
+  }
+
+  {
+    py::gil_scoped_release release;
+    if (write)
+      r->write_block(offset, static_cast<const uint8_t *>(view.buf),
+                     static_cast<size_t>(view.len));
+    else
+      r->read_block(offset, static_cast<uint8_t *>(view.buf),
+                    static_cast<size_t>(view.len));
+  }
+
+  PyBuffer_Release(&view);
+}
+
+static mmio_view region_view(mmio_region *r, uint32_t width, size_t stride)
+{
+  if (width != 32 && width != 64)
+    throw std::invalid_argument("width must be 32 or 64");
+
+  size_t itemsize = width / 8;
+  if (!stride)
+    stride = itemsize;
+  if (stride % itemsize)
+    throw std::invalid_argument("stride must be a multiple of width/8");
+
+  size_t count = r->size < itemsize ? 0 : (r->size - itemsize) / stride + 1;
+  py::gil_scoped_release release;
+  return mmio_view(*r, width, stride, count);
+}
+
 
 #ifdef LIBVFIO_EMBED
 #include <pybind11/embed.h>
@@ -66,12 +130,52 @@ PYBIND11_MODULE(libvfio, m)
           .def("write64", &mmio_region::write64)
           .def("read32", &mmio_region::read32)
           .def("read64", &mmio_region::read64)
+          .def("read_block", &region_read_block,
+               "Read size bytes at offset, using 64-bit (or 32-bit) MMIO reads.",
+               py::arg("offset"), py::arg("size"))
+          .def("read_block",
+               [](mmio_region *r, uint64_t offset, py::buffer out) {
+                 region_block_io(r, offset, out, false);
+               },
+               "Fill the writable buffer out from offset.",
+               py::arg("offset"), py::arg("out"))
+          .def("write_block",
+               [](mmio_region *r, uint64_t offset, py::buffer data) {
+                 region_block_io(r, offset, data, true);
+               },
+               "Write the contents of data at offset.",
+               py::arg("offset"), py::arg("data"))
+          .def("view", &region_view,
+               "Snapshot of width-bit registers, one every stride bytes, as a read-only buffer.",
+               py::arg("width") = 64, py::arg("stride") = 0)
           .def("index", [](mmio_region *r) { return r->index; })
           .def("__repr__", [](mmio_region *r) { return std::to_string(r->index); })
           .def("__len__", [](mmio_region *r) { return r->size; });
 
-  py::class_<system_buffer> pybuffer(m, "system_buffer", "");
-  pybuffer.def_property_readonly("size", [](system_buffer *b) -> size_t { return b->size; })
+  py::class_<mmio_view> pyview(m, "mmio_view", py::buffer_protocol());
+  pyview.def_buffer([](mmio_view &v) -> py::buffer_info {
+           return py::buffer_info(v.data.data(),
+                                  static_cast<py::ssize_t>(v.width / 8),
+                                  v.width == 32 ?
+                                    py::format_descriptor<uint32_t>::format() :
+                                    py::format_descriptor<uint64_t>::format(),
+                                  1,
+                                  { static_cast<py::ssize_t>(v.count) },
+                                  { static_cast<py::ssize_t>(v.width / 8) },
+                                  true);
+         })
+        .def("__len__", [](mmio_view *v) { return v->count; });
+
+  py::class_<system_buffer> pybuffer(m, "system_buffer", py::buffer_protocol());
+  pybuffer.def_buffer([](system_buffer &b) -> py::buffer_info {
+             return py::buffer_info(b.buf,
+                                    1,
+                                    py::format_descriptor<uint8_t>::format(),
+                                    1,
+                                    { static_cast<py::ssize_t>(b.size) },
+                                    { static_cast<py::ssize_t>(1) });
+           })
+          .def_property_readonly("size", [](system_buffer *b) -> size_t { return b->size; })
           .def_property_readonly("address", [](system_buffer *b) -> uint64_t { return reinterpret_cast<uint64_t>(b->buf); })
           .def_property_readonly("io_address", [](system_buffer *b) -> uint64_t { return b->iova; })
           .def("__getitem__", &system_buffer::get_uint64)
@@ -0,0 +1,618 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif // _GNU_SOURCE
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <json-c/json.h>
+
+#define OPT_STR "+ho:f:p:S:s:at:"
+
+static struct option longopts[] = {
+	{ "help",    no_argument,       NULL, 'h' },
+	{ "output",  required_argument, NULL, 'o' },
+	{ "file",    required_argument, NULL, 'f' },
+	{ "pid",     required_argument, NULL, 'p' },
+	{ "signal",  required_argument, NULL, 'S' },
+	{ "sort",    required_argument, NULL, 's' },
+	{ "all",     no_argument,       NULL, 'a' },
+	{ "timeout", required_argument, NULL, 't' },
+
+	{ 0, 0, 0, 0 }
+};
+
+// The name libopae-c gives its statistics when signaled, unless
+// LIBOPAE_STATS_FILE says otherwise (see opae_stats_default_file()).
+#define DEFAULT_STATS_NAME "opae-stats-%p.json"
+
+enum sort_key {
+	SORT_TOTAL = 0,
+	SORT_CALLS,
+	SORT_ERRORS,
+	SORT_MEAN,
+	SORT_P99,
+	SORT_MAX,
+	SORT_NAME
+};
+
+static const char * const sort_names[] = {
+	"total", "calls", "errors", "mean", "p99", "max", "name"
+};
+
+static struct opaestat_config {
+	const char *output;
+	const char *file;
+	pid_t pid;
+	int signum;
+	enum sort_key sort;
+	bool all;
+	int timeout_ms;
+} opaestat_config = {
+	.signum = SIGUSR2,
+	.sort = SORT_TOTAL,
+	.timeout_ms = 5000,
+};
+
+struct api_row {
+	const char *api;
+	uint64_t calls;
+	uint64_t errors;
+	uint64_t total_ns;
+	uint64_t max_ns;
+	uint64_t p50_ns;
+	uint64_t p99_ns;
+};
+
+static void show_help(FILE *fptr)
+{
+	fprintf(fptr, "Usage: opaestat [<options>] -- <command> [<args>]\n");
+	fprintf(fptr, "       opaestat [<options>] -f <file>\n");
+	fprintf(fptr, "       opaestat [<options>] -p <pid>\n");
+	fprintf(fptr, "\n");
+	fprintf(fptr, "Show the OPAE API call statistics of a program.\n");
+	fprintf(fptr, "\n");
+	fprintf(fptr, "\t-o,--output <file>          run <command> and keep its statistics in <file>.\n");
+	fprintf(fptr, "\t-f,--file <file>            show the statistics in <file>.\n");
+	fprintf(fptr, "\t-p,--pid <pid>              signal <pid> to write its statistics and\n"
+		      "\t                            show them. <pid> must have been started with\n"
+		      "\t                            LIBOPAE_STATS_SIGNAL set.\n");
+	fprintf(fptr, "\t-S,--signal <signal>        the signal for --pid [SIGUSR2].\n");
+	fprintf(fptr, "\t-t,--timeout <ms>           how long to wait for --pid [%d].\n",
+		opaestat_config.timeout_ms);
+	fprintf(fptr, "\t-s,--sort <key>             sort by total, calls, errors, mean, p99,\n"
+		      "\t                            max or name [total].\n");
+	fprintf(fptr, "\t-a,--all                    also show each handle.\n");
+	fprintf(fptr, "\t-h,--help                   display this help and exit.\n");
+	fprintf(fptr, "\n");
+	fprintf(fptr, "With --pid and no --file, the statistics are read from\n"
+		      "$XDG_RUNTIME_DIR/opae-stats-<pid>.json, or else (except for root)\n"
+		      "/tmp/opae-stats-<pid>.json. A %%p in a file name stands for the pid.\n");
+}
+
+// The directory libopae-c saves signaled statistics to by default:
+// $XDG_RUNTIME_DIR, else /tmp for anyone but root, who has to name
+// a file.
+static const char *stats_dir(void)
+{
+	const char *dir = getenv("XDG_RUNTIME_DIR");
+
+	if (dir && *dir)
+		return dir;
+	return geteuid() ? "/tmp" : NULL;
+}
+
+static int parse_signal(const char *s)
+{
+	static const struct {
+		const char *name;
+		int signum;
+	} signals[] = {
+		{ "USR1", SIGUSR1 },
+		{ "USR2", SIGUSR2 },
+		{ "HUP",  SIGHUP  },
+		{ "QUIT", SIGQUIT },
+		{ "PROF", SIGPROF },
+	};
+	char *endptr = NULL;
+	long n;
+	size_t i;
+
+	n = strtol(s, &endptr, 0);
+	if (*s && *endptr == '\0')
+		return (n > 0 && n < NSIG) ? (int)n : 0;
+
+	if (!strncasecmp(s, "SIG", 3))
+		s += 3;
+
+	for (i = 0 ; i < sizeof(signals) / sizeof(signals[0]) ; ++i) {
+		if (!strcasecmp(s, signals[i].name))
+			return signals[i].signum;
+	}
+
+	return 0;
+}
+
+static int parse_args(struct opaestat_config *c, int argc, char *argv[])
+{
+	int getopt_ret;
+	int option_index;
+	char *endptr;
+	size_t i;
+
+	while (-1 != (getopt_ret = getopt_long(argc, argv, OPT_STR, longopts, &option_index))) {
+		const char *tmp_optarg = optarg;
+
+		if (optarg && ('=' == *tmp_optarg))
+			++tmp_optarg;
+
+		switch (getopt_ret) {
+		case 'h':
+			show_help(stdout);
+			return -2;
+
+		case 'o':
+			c->output = tmp_optarg;
+			break;
+
+		case 'f':
+			c->file = tmp_optarg;
+			break;
+
+		case 'p':
+			c->pid = (pid_t)strtol(tmp_optarg, &endptr, 0);
+			if (*endptr || c->pid <= 0) {
+				fprintf(stderr, "invalid pid: %s\n", tmp_optarg);
+				return 1;
+			}
+			break;
+
+		case 'S':
+			c->signum = parse_signal(tmp_optarg);
+			if (!c->signum) {
+				fprintf(stderr, "invalid signal: %s\n", tmp_optarg);
+				return 1;
+			}
+			break;
+
+		case 't':
+			c->timeout_ms = (int)strtol(tmp_optarg, &endptr, 0);
+			if (*endptr || c->timeout_ms < 0) {
+				fprintf(stderr, "invalid timeout: %s\n", tmp_optarg);
+				return 1;
+			}
+			break;
+
+		case 's':
+			for (i = 0 ; i < sizeof(sort_names) / sizeof(sort_names[0]) ; ++i) {
+				if (!strcmp(tmp_optarg, sort_names[i]))
+					break;
+			}
+			if (i == sizeof(sort_names) / sizeof(sort_names[0])) {
+				fprintf(stderr, "invalid sort key: %s\n", tmp_optarg);
+				return 1;
+			}
+			c->sort = (enum sort_key)i;
+			break;
+
+		case 'a':
+			c->all = true;
+			break;
+
+		default:
+			fprintf(stderr, "invalid command option\n");
+			show_help(stderr);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static uint64_t get_u64(json_object *parent, const char *name)
+{
+	json_object *j = NULL;
+
+	if (!json_object_object_get_ex(parent, name, &j))
+		return 0;
+	return (uint64_t)json_object_get_int64(j);
+}
+
+static const char *get_string(json_object *parent, const char *name)
+{
+	json_object *j = NULL;
+
+	if (!json_object_object_get_ex(parent, name, &j) ||
+	    !json_object_is_type(j, json_type_string))
+		return "";
+	return json_object_get_string(j);
+}
+
+static uint64_t row_key(const struct api_row *r)
+{
+	switch (opaestat_config.sort) {
+	case SORT_CALLS:
+		return r->calls;
+	case SORT_ERRORS:
+		return r->errors;
+	case SORT_MEAN:
+		return r->calls ? r->total_ns / r->calls : 0;
+	case SORT_P99:
+		return r->p99_ns;
+	case SORT_MAX:
+		return r->max_ns;
+	default:
+		return r->total_ns;
+	}
+}
+
+static int compare_rows(const void *a, const void *b)
+{
+	const struct api_row *ra = (const struct api_row *)a;
+	const struct api_row *rb = (const struct api_row *)b;
+	uint64_t ka;
+	uint64_t kb;
+
+	if (opaestat_config.sort == SORT_NAME)
+		return strcmp(ra->api, rb->api);
+
+	// Largest first.
+	ka = row_key(ra);
+	kb = row_key(rb);
+	if (ka != kb)
+		return ka < kb ? 1 : -1;
+	return strcmp(ra->api, rb->api);
+}
+
+static void print_apis(json_object *scope)
+{
+	json_object *j_apis = NULL;
+	struct api_row *rows;
+	size_t num;
+	size_t i;
+
+	if (!json_object_object_get_ex(scope, "apis", &j_apis) ||
+	    !json_object_is_type(j_apis, json_type_array))
+		return;
+
+	num = json_object_array_length(j_apis);
+	if (!num) {
+		printf("  (no calls)\n");
+		return;
+	}
+
+	rows = calloc(num, sizeof(*rows));
+	if (!rows) {
+		fprintf(stderr, "out of memory\n");
+		return;
+	}
+
+	for (i = 0 ; i < num ; ++i) {
+		json_object *j_api = json_object_array_get_idx(j_apis, i);
+
+		rows[i].api = get_string(j_api, "api");
+		rows[i].calls = get_u64(j_api, "calls");
+		rows[i].errors = get_u64(j_api, "errors");
+		rows[i].total_ns = get_u64(j_api, "total_ns");
+		rows[i].max_ns = get_u64(j_api, "max_ns");
+		rows[i].p50_ns = get_u64(j_api, "p50_ns");
+		rows[i].p99_ns = get_u64(j_api, "p99_ns");
+	}
+
+	qsort(rows, num, sizeof(*rows), compare_rows);
+
+	printf("  %-30s %10s %8s %12s %10s %10s %10s %10s\n",
+	       "API", "calls", "errors", "total(ms)",
+	       "mean(us)", "p50(us)", "p99(us)", "max(us)");
+
+	for (i = 0 ; i < num ; ++i) {
+		const struct api_row *r = &rows[i];
+
+		printf("  %-30s %10" PRIu64 " %8" PRIu64 " %12.3f "
+		       "%10.3f %10.3f %10.3f %10.3f\n",
+		       r->api, r->calls, r->errors, r->total_ns / 1e6,
+		       r->calls ? (double)r->total_ns / r->calls / 1e3 : 0.0,
+		       r->p50_ns / 1e3, r->p99_ns / 1e3, r->max_ns / 1e3);
+	}
+
+	free(rows);
+}
+
+static int print_stats(const char *path)
+{
+	json_object *root;
+	json_object *j_list = NULL;
+	size_t num;
+	size_t i;
+
+	root = json_object_from_file(path);
+	if (!root) {
+		fprintf(stderr, "failed to read statistics from %s\n", path);
+		return 1;
+	}
+
+	printf("OPAE API statistics of process %" PRIu64 "\n",
+	       get_u64(root, "pid"));
+
+	if (json_object_object_get_ex(root, "plugins", &j_list)) {
+		num = json_object_array_length(j_list);
+		for (i = 0 ; i < num ; ++i) {
+			json_object *j_plugin = json_object_array_get_idx(j_list, i);
+
+			printf("\nplugin %s\n", get_string(j_plugin, "name"));
+			print_apis(j_plugin);
+		}
+	}
+
+	if (opaestat_config.all &&
+	    json_object_object_get_ex(root, "handles", &j_list)) {
+		num = json_object_array_length(j_list);
+		for (i = 0 ; i < num ; ++i) {
+			json_object *j_handle = json_object_array_get_idx(j_list, i);
+			json_object *j_open = NULL;
+			bool open = false;
+
+			if (json_object_object_get_ex(j_handle, "open", &j_open))
+				open = json_object_get_boolean(j_open);
+
+			printf("\nhandle %" PRIu64 " %s (%s)%s\n",
+			       get_u64(j_handle, "id"),
+			       get_string(j_handle, "device"),
+			       get_string(j_handle, "plugin"),
+			       open ? "" : " closed");
+			print_apis(j_handle);
+		}
+	}
+
+	json_object_put(root);
+	return 0;
+}
+
+// Replace %p in pattern with pid, as libopae-c does.
+static void expand_path(const char *pattern, pid_t pid, char *out, size_t len)
+{
+	size_t n = 0;
+
+	for ( ; *pattern && n + 1 < len ; ++pattern) {
+		if (pattern[0] == '%' && pattern[1] == 'p') {
+			int w = snprintf(out + n, len - n, "%d", (int)pid);
+
+			if (w < 0 || (size_t)w >= len - n)
+				break;
+			n += w;
+			++pattern;
+		} else {
+			out[n++] = *pattern;
+		}
+	}
+
+	out[n] = '\0';
+}
+
+static int run_command(char *argv[])
+{
+	const char *pattern = opaestat_config.output;
+	const char *dir = getenv("XDG_RUNTIME_DIR");
+	struct sigaction ignore;
+	struct sigaction old_int;
+	struct sigaction old_quit;
+	char tmpdir[PATH_MAX] = { 0 };
+	char tmp_pattern[PATH_MAX];
+	char path[PATH_MAX];
+	pid_t pid;
+	int status;
+	int res;
+
+	// Without --output, collect into a private directory, so that
+	// nobody else can plant or read the file.
+	if (!pattern) {
+		if (!dir || !*dir)
+			dir = "/tmp";
+		if (snprintf(tmpdir, sizeof(tmpdir), "%s/opaestat-XXXXXX",
+			     dir) >= (int)sizeof(tmpdir) ||
+		    !mkdtemp(tmpdir)) {
+			fprintf(stderr, "failed to create a directory in %s: %s\n",
+				dir, strerror(errno));
+			return 1;
+		}
+		if (snprintf(tmp_pattern, sizeof(tmp_pattern), "%s/%s",
+			     tmpdir, DEFAULT_STATS_NAME) >=
+		    (int)sizeof(tmp_pattern)) {
+			fprintf(stderr, "%s: path too long\n", tmpdir);
+			rmdir(tmpdir);
+			return 1;
+		}
+		pattern = tmp_pattern;
+	}
+
+	// The command's own process writes to pattern at exit, with its
+	// pid in place of %p; so do any children it runs with libopae-c.
+	if (setenv("LIBOPAE_STATS", "1", 1) ||
+	    setenv("LIBOPAE_STATS_FILE", pattern, 1)) {
+		fprintf(stderr, "setenv failed: %s\n", strerror(errno));
+		return 1;
+	}
+
+	// Like time(1), let ^C reach the command only.
+	memset(&ignore, 0, sizeof(ignore));
+	ignore.sa_handler = SIG_IGN;
+	sigaction(SIGINT, &ignore, &old_int);
+	sigaction(SIGQUIT, &ignore, &old_quit);
+
+	pid = fork();
+	if (pid < 0) {
+		fprintf(stderr, "fork failed: %s\n", strerror(errno));
+		return 1;
+	}
+
+	if (!pid) {
+		sigaction(SIGINT, &old_int, NULL);
+		sigaction(SIGQUIT, &old_quit, NULL);
+		execvp(argv[0], argv);
+		fprintf(stderr, "failed to run %s: %s\n", argv[0], strerror(errno));
+		_exit(127);
+	}
+
+	while (waitpid(pid, &status, 0) < 0) {
+		if (errno != EINTR) {
+			fprintf(stderr, "waitpid failed: %s\n", strerror(errno));
+			return 1;
+		}
+	}
+
+	sigaction(SIGINT, &old_int, NULL);
+	sigaction(SIGQUIT, &old_quit, NULL);
+
+	if (WIFEXITED(status))
+		res = WEXITSTATUS(status);
+	else if (WIFSIGNALED(status))
+		res = 128 + WTERMSIG(status);
+	else
+		res = 1;
+
+	expand_path(pattern, pid, path, sizeof(path));
+
+	if (access(path, R_OK)) {
+		fprintf(stderr, "%s wrote no statistics", argv[0]);
+		if (WIFSIGNALED(status))
+			fprintf(stderr, ": it was killed by signal %d\n",
+				WTERMSIG(status));
+		else
+			fprintf(stderr, "; is it linked with libopae-c?\n");
+		if (tmpdir[0])
+			rmdir(tmpdir);
+		return res ? res : 1;
+	}
+
+	fprintf(stderr, "\n");
+	print_stats(path);
+
+	if (tmpdir[0]) {
+		unlink(path);
+		rmdir(tmpdir);
+	}
+
+	return res;
+}
+
+static int signal_process(void)
+{
+	const char *dir = stats_dir();
+	char pattern[PATH_MAX];
+	char path[PATH_MAX];
+	struct stat before;
+	struct stat after;
+	bool existed;
+	int waited;
+
+	if (opaestat_config.file) {
+		snprintf(pattern, sizeof(pattern), "%s", opaestat_config.file);
+	} else if (dir) {
+		snprintf(pattern, sizeof(pattern), "%s/%s",
+			 dir, DEFAULT_STATS_NAME);
+	} else {
+		fprintf(stderr, "as root, --pid needs --file: libopae-c has "
+			"no default statistics file\n");
+		return 1;
+	}
+
+	expand_path(pattern, opaestat_config.pid, path, sizeof(path));
+
+	existed = !stat(path, &before);
+
+	if (kill(opaestat_config.pid, opaestat_config.signum)) {
+		fprintf(stderr, "failed to signal %d: %s\n",
+			(int)opaestat_config.pid, strerror(errno));
+		return 1;
+	}
+
+	// libopae-c replaces the file with a new one when it is done.
+	for (waited = 0 ; waited <= opaestat_config.timeout_ms ; waited += 10) {
+		if (!stat(path, &after) &&
+		    (!existed ||
+		     after.st_ino != before.st_ino ||
+		     after.st_mtim.tv_sec != before.st_mtim.tv_sec ||
+		     after.st_mtim.tv_nsec != before.st_mtim.tv_nsec))
+			return print_stats(path);
+		usleep(10000);
+	}
+
+	fprintf(stderr, "%d wrote no statistics to %s; was it started "
+		"with LIBOPAE_STATS_SIGNAL set?\n",
+		(int)opaestat_config.pid, path);
+	return 1;
+}
+
+int main(int argc, char *argv[])
+{
+	int res;
+
+	res = parse_args(&opaestat_config, argc, argv);
+	if (res == -2)
+		return 0;
+	if (res)
+		return res;
+
+	if (opaestat_config.pid) {
+		if (optind < argc) {
+			fprintf(stderr, "--pid does not take a command\n");
+			return 1;
+		}
+		return signal_process();
+	}
+
+	if (optind < argc) {
+		if (opaestat_config.file) {
+			fprintf(stderr, "--file does not take a command\n");
+			return 1;
+		}
+		return run_command(&argv[optind]);
+	}
+
+	if (opaestat_config.file)
+		return print_stats(opaestat_config.file);
+
+	show_help(stderr);
+	return 1;
+}
@@ -68,6 +68,21 @@ extern "C" {
  * 'wsid' an fpga_buffer object that can be used to program address registers
  * in the accelerator for shared access to the memory.
  *
+ * Memory allocated by this function is placed on the NUMA node local to the
+ * accelerator, when the platform reports one. Pass FPGA_BUF_NUMA_ANY to
+ * place it according to the calling thread's memory policy instead, for
+ * example one set with numactl(8) or set_mempolicy(2). The node that backs
+ * a buffer can be queried with fpgaGetBufferNumaNode().
+ *
+ * Buffers larger than 2MB are normally backed by 1GB huge pages, so their
+ * length is rounded up to a multiple of 1GB. FPGA_BUF_SCATTER_GATHER backs
+ * such a buffer with 2MB huge pages instead (or 4KB pages when no 2MB pages
+ * are free), rounding its length up to a multiple of 2MB. The pages need not
+ * be physically contiguous: the IOMMU maps them to one contiguous IO address
+ * range, which is what fpgaGetIOAddress() returns. Scatter-gather buffers
+ * require a plugin that programs the IOMMU directly, such as vfio; others
+ * return FPGA_NOT_SUPPORTED.
+ *
  * When using FPGA_BUF_PREALLOCATED, the input len must be a non-zero multiple
  * of the page size, else the function returns FPGA_INVALID_PARAM. When not
  * using FPGA_BUF_PREALLOCATED, the input len is rounded up to the nearest
@@ -84,9 +99,14 @@ extern "C" {
  *                        pointed at in '*buf_addr' is already allocated an
  *                        mapped into virtual memory. FPGA_BUF_READ_ONLY
  *                        pins pages with only read access from the FPGA.
+ *                        FPGA_BUF_NUMA_ANY leaves page placement to the
+ *                        calling thread's memory policy.
+ *                        FPGA_BUF_SCATTER_GATHER backs a large buffer with
+ *                        2MB or 4KB pages behind a contiguous IO address.
  * @returns FPGA_OK on success. FPGA_NO_MEMORY if the requested memory could
  * not be allocated. FPGA_INVALID_PARAM if invalid parameters were provided, or
- * if the parameter combination is not valid. FPGA_EXCEPTION if an internal
+ * if the parameter combination is not valid. FPGA_NOT_SUPPORTED if the
+ * plugin can't provide a scatter-gather buffer. FPGA_EXCEPTION if an internal
  * exception occurred while trying to access the handle.
  *
  * @note As a special case, when FPGA_BUF_PREALLOCATED is present in flags,
@@ -135,6 +155,26 @@ fpga_result fpgaReleaseBuffer(fpga_handle handle, uint64_t wsid);
 fpga_result fpgaGetIOAddress(fpga_handle handle, uint64_t wsid,
 			     uint64_t *ioaddr);
 
+/**
+ * Retrieve the NUMA node of a shared buffer
+ *
+ * Reports the NUMA node of the system memory that backs the shared buffer
+ * identified by wsid. Buffers larger than a page may span nodes, in which
+ * case the node of the first page is returned.
+ *
+ * @param[in]  handle   Handle to previously opened accelerator resource
+ * @param[in]  wsid     Buffer handle / workspace ID referring to the buffer
+ * @param[out] node     Pointer to memory where the node will be returned.
+ *                      -1 is returned when the node cannot be determined,
+ *                      for instance on a system without NUMA support.
+ * @returns FPGA_OK on success. FPGA_INVALID_PARAM if invalid parameters were
+ * provided. FPGA_NOT_FOUND if `wsid` does not refer to a previously shared
+ * buffer. FPGA_NOT_SUPPORTED if the plugin serving `handle` cannot report
+ * buffer placement.
+ */
+fpga_result fpgaGetBufferNumaNode(fpga_handle handle, uint64_t wsid,
+				  int *node);
+
 /**
  * Bind IOMMU shared virtual addressing
  *
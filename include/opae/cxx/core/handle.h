@@ -136,6 +136,28 @@ class handle {
    */
   void write_csr512(uint64_t offset, const void *value, uint32_t csr_space = 0);
 
+  /**
+   * @brief Read a sequence of CSRs belonging to a resource associated
+   * with a handle, using a single library call.
+   *
+   * @param[in,out] ops The reads to perform. Each element names its CSR
+   * space, offset and width (32 or 64). On return, the value field of
+   * each element holds the value read.
+   *
+   * @throws invalid_param if any element is invalid.
+   */
+  void read_csr_batch(std::vector<fpga_mmio_op> &ops) const;
+
+  /**
+   * @brief Write a sequence of CSRs belonging to a resource associated
+   * with a handle, using a single library call.
+   *
+   * @param[in] ops The writes to perform, in order.
+   *
+   * @throws invalid_param if any element is invalid.
+   */
+  void write_csr_batch(const std::vector<fpga_mmio_op> &ops);
+
   /** Retrieve a pointer to the MMIO region.
    * @param[in] offset The byte offset to add to MMIO base.
    * @param[in] csr_space The desired CSR space. Default is 0.
@@ -68,6 +68,19 @@ class shared_buffer {
   static shared_buffer::ptr_t allocate(handle::ptr_t handle, size_t len,
                                        bool read_only = false);
 
+  /** shared_buffer factory method - allocate a shared_buffer,
+   * passing additional flags to fpgaPrepareBuffer().
+   * @param[in] handle    The handle used to allocate the buffer.
+   * @param[in] len       The length in bytes of the requested buffer.
+   * @param[in] read_only Whether the buffer is read-only to the device.
+   * @param[in] flags     Additional fpga_buffer_flags, for example
+   *                      FPGA_BUF_NUMA_ANY.
+   * @return A valid shared_buffer smart pointer on success, or an
+   * empty smart pointer on failure.
+   */
+  static shared_buffer::ptr_t allocate(handle::ptr_t handle, size_t len,
+                                       bool read_only, int flags);
+
   /** Attach a pre-allocated buffer to a shared_buffer object.
    *
    * @param[in] handle The handle used to attach the buffer.
@@ -121,6 +134,11 @@ class shared_buffer {
    */
   uint64_t io_address() const { return io_address_; }
 
+  /** Retrieve the NUMA node of the memory that backs the buffer,
+   * or -1 if it cannot be determined.
+   */
+  int numa_node() const;
+
   /** Write c to each byte location in the buffer.
    */
   void fill(int c);
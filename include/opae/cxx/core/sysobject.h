@@ -136,6 +136,18 @@ class sysobject {
    */
   uint64_t read64(int flags = 0) const;
 
+  /**
+   * @brief Read 64-bit values from several FPGA objects in one call.
+   *
+   * @param[in] objs The attribute objects to read.
+   * @param[in] flags Flags that control how the objects are read, as for
+   * read64(). Flags are defaulted to 0 meaning no flags.
+   *
+   * @return A vector holding the value of each object, in order.
+   */
+  static std::vector<uint64_t> read_many(
+      const std::vector<sysobject::ptr_t> &objs, int flags = 0);
+
   /**
    * @brief Write 64-bit value to an FPGA object.
    * The value will be converted to string before writing. See flags below for
@@ -102,6 +102,27 @@ fpga_result fpgaEnumerate(const fpga_properties *filters,
 			  uint32_t num_filters, fpga_token *tokens,
 			  uint32_t max_tokens, uint32_t *num_matches);
 
+/**
+ * Discard cached enumeration data
+ *
+ * Plugins may cache the device tree they discover, so that repeated calls
+ * to fpgaEnumerate() do not rescan the system. A plugin's cache is dropped
+ * automatically when the plugin is notified that device nodes were added or
+ * removed. Changes it cannot observe, such as a partial reconfiguration
+ * performed by another process, are picked up after calling
+ * fpgaEnumerateRefresh(). The next fpgaEnumerate() rediscovers all devices.
+ *
+ * Caching is enabled by default. Set the environment variable
+ * LIBOPAE_ENUM_CACHE to 0 before initializing the library to disable it.
+ *
+ * Tokens returned by earlier calls to fpgaEnumerate() remain valid.
+ *
+ * @returns              FPGA_OK on success.
+ *                       FPGA_EXCEPTION if any plugin failed to discard its
+ *                       cache.
+ */
+fpga_result fpgaEnumerateRefresh(void);
+
 /**
  * Clone a fpga_token object
  *
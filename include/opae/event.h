@@ -153,6 +153,77 @@ fpga_result fpgaUnregisterEvent(fpga_handle handle,
 					     fpga_event_type event_type,
 					     fpga_event_handle event_handle);
 
+/**
+ * Wait for any of several FPGA events
+ *
+ * Blocks until at least one of the given events has fired, or until the
+ * timeout expires. Every event that fired is consumed: its counter is read
+ * and cleared, and returned in the matching element of counts. On Linux, the
+ * counter of an interrupt event is the number of interrupts delivered since
+ * it was last consumed, so a burst of completions costs a single wakeup.
+ *
+ * The events are watched through an epoll set owned by the calling thread.
+ * The set is kept between calls, so waiting repeatedly on the same array
+ * costs one epoll_wait(2) plus one read(2) per ready event. Passing a
+ * different array, or destroying any event handle, rebuilds the set on the
+ * next call.
+ *
+ * Each event handle must have been registered with fpgaRegisterEvent(), and
+ * may appear in the array only once.
+ *
+ * @param[in]  event_handles Array of registered event handles.
+ * @param[in]  num_events    Number of elements in event_handles.
+ * @param[in]  timeout       Timeout in milliseconds. -1 waits forever. 0
+ *                           returns immediately.
+ * @param[out] counts        Array of num_events counters. counts[i] is zero
+ *                           when event_handles[i] did not fire.
+ * @param[out] num_ready     Number of events that fired. Zero on timeout, or
+ *                           when the wait was interrupted by a signal.
+ * @returns FPGA_OK on success. FPGA_INVALID_PARAM if any pointer is NULL,
+ * num_events is zero, an event handle is not registered, or an event handle
+ * appears twice. FPGA_NO_MEMORY if the epoll set can't be allocated.
+ * FPGA_EXCEPTION if an internal error occurred.
+ */
+fpga_result fpgaWaitEvents(const fpga_event_handle *event_handles,
+			   uint32_t num_events,
+			   int timeout,
+			   uint64_t *counts,
+			   uint32_t *num_ready);
+
+/**
+ * Wait for any of several FPGA events, spinning first
+ *
+ * Polls the completion word before sleeping: for up to spin_usec
+ * microseconds, the calling thread spins on *completion. If the word
+ * becomes non-zero, the function returns FPGA_OK at once, with *num_ready
+ * set to zero and no system call made. Otherwise, it waits as
+ * fpgaWaitEvents() does.
+ *
+ * completion is typically a flag in a shared buffer (see fpgaPrepareBuffer())
+ * that the accelerator writes along with raising its interrupt. The
+ * interrupt for a completion observed while spinning is still delivered, and
+ * is returned by a later wait, so callers should test their completion flag
+ * after every return rather than counting interrupts.
+ *
+ * @param[in]  event_handles Array of registered event handles.
+ * @param[in]  num_events    Number of elements in event_handles.
+ * @param[in]  timeout       Timeout in milliseconds for the wait that follows
+ *                           the spin. -1 waits forever.
+ * @param[out] counts        Array of num_events counters.
+ * @param[out] num_ready     Number of events that fired.
+ * @param[in]  completion    Word to spin on.
+ * @param[in]  spin_usec     Longest time to spin, in microseconds. 0 only
+ *                           samples *completion once.
+ * @returns As for fpgaWaitEvents(). FPGA_INVALID_PARAM if completion is NULL.
+ */
+fpga_result fpgaWaitEventsHybrid(const fpga_event_handle *event_handles,
+				 uint32_t num_events,
+				 int timeout,
+				 uint64_t *counts,
+				 uint32_t *num_ready,
+				 const volatile uint64_t *completion,
+				 uint64_t spin_usec);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif // __cplusplus
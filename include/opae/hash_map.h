@@ -32,6 +32,11 @@
  * Both keys and values may be arbitrary data structures. The user supplies
  * the means by which the hash of values is generated and by which the
  * keys are compared to each other.
+ *
+ * By default, the map is a fixed-size array of buckets, each holding a
+ * list of heap-allocated items. When initialized with
+ * OPAE_HASH_MAP_OPEN_ADDRESSING, the map is instead a resizable
+ * open-addressing (Robin Hood) table that stores keys and values inline.
  */
 
 #ifndef __OPAE_HASH_MAP_H__
@@ -56,9 +61,20 @@ extern "C" {
  * unique, opae_hash_map_add() can implement a small performance improvement.
  */
 typedef enum _opae_hash_map_flags {
-	OPAE_HASH_MAP_UNIQUE_KEYSPACE = (1u << 0)
+	OPAE_HASH_MAP_UNIQUE_KEYSPACE = (1u << 0),
+	OPAE_HASH_MAP_OPEN_ADDRESSING = (1u << 1)
 } opae_hash_map_flags;
 
+/**
+ * Hash value range for open addressing.
+ *
+ * When OPAE_HASH_MAP_OPEN_ADDRESSING is given, the table size changes
+ * as the map grows, so key_hash is always called with this value as
+ * its num_buckets parameter. The result is mixed and then reduced to
+ * the current table size.
+ */
+#define OPAE_HASH_MAP_HASH_RANGE UINT32_MAX
+
 /**
  * List link item.
  *
@@ -73,6 +89,19 @@ typedef struct _opae_hash_map_item {
 	struct _opae_hash_map_item *next;
 } opae_hash_map_item;
 
+/**
+ * Open-addressing slot.
+ *
+ * Stores one key/value association inline in the table, along with the
+ * key's hash and its distance from its home slot.
+ */
+typedef struct _opae_hash_map_slot {
+	void *key;
+	void *value;
+	uint32_t hash;
+	uint32_t dist; ///< Probe distance plus one. Zero for an empty slot.
+} opae_hash_map_slot;
+
 /**
  * Hash map object.
  *
@@ -85,6 +114,8 @@ typedef struct _opae_hash_map {
 	uint32_t num_buckets;
 	uint32_t hash_seed;
 	opae_hash_map_item **buckets;
+	opae_hash_map_slot *slots;	///< Table for OPAE_HASH_MAP_OPEN_ADDRESSING
+	uint32_t num_items;		///< Item count for OPAE_HASH_MAP_OPEN_ADDRESSING
 	int flags;
 	void *cleanup_context; ///< Optional second parameter to key_cleanup and value_cleanup
 	uint32_t (*key_hash)(uint32_t num_buckets,	   ///< (required)
@@ -106,6 +137,9 @@ typedef struct _opae_hash_map {
  *                           entry may be empty (NULL), or may contain a list
  *                           of opae_hash_map_item structures for which the given
  *                           key_hash function returned the same key hash value.
+ *                           With OPAE_HASH_MAP_OPEN_ADDRESSING, the initial table
+ *                           size, which is rounded up to a power of two and
+ *                           doubled whenever the table becomes 7/8 full.
  * @param[in]  hash_seed     A seed value used during key hash computation. This
  *                           value will be the hash_seed parameter to the key hash
  *                           function.
@@ -113,6 +147,10 @@ typedef struct _opae_hash_map {
  * @param[in]  key_hash      A pointer to a function that produces the hash value,
  *                           given the number of buckets, the hash seed, and the key.
  *                           Valid values are between 0 and num_buckets - 1, inclusively.
+ *                           See OPAE_HASH_MAP_HASH_RANGE for open addressing. When
+ *                           open addressing is used with opae_u64_key_hash and
+ *                           opae_u64_key_compare, the map hashes and compares the
+ *                           keys inline instead of calling them.
  * @param[in]  key_compare   A pointer to a function that compares two keys. The return
  *                           value is similar to that of strcmp(), where a negative value
  *                           means that keya < keyb, 0 means that keya == keyb, and a positive
@@ -150,8 +188,9 @@ fpga_result opae_hash_map_init(opae_hash_map *hm,
  * @param[in]      key   The hash map key.
  * @param[in]      value The hash map value.
  * @returns FPGA_OK on success, FPGA_INVALID_PARAM if hm is NULL, FPGA_NO_MEMORY
- *          if malloc() fails when allocating the list item, or FPGA_INVALID_PARAM
- *          if the key hash produced by key_hash is out of bounds.
+ *          if malloc() fails when allocating the list item or growing the
+ *          open-addressing table, or FPGA_INVALID_PARAM if the key hash
+ *          produced by key_hash is out of bounds.
  */
 fpga_result opae_hash_map_add(opae_hash_map *hm,
 			      void *key,
@@ -35,21 +35,38 @@
 * returned for each allocation request, and that an allocation can be freed,
 * ie released back to the available pool of logical address space for future
 * allocations. The memory backing the allocator's internal data structures
-* is managed by malloc()/free().
+* is managed by malloc()/free(), in blocks of nodes.
+*
+* Free ranges are kept in two balanced (AVL) trees, one ordered by address
+* for coalescing and one ordered by size for best-fit allocation.
+* Allocated ranges are kept in a third tree, ordered by address. Each
+* operation is O(log n) in the number of ranges.
 */
 
 #include <stdint.h>
 
+struct mem_tree {
+	struct mem_tree *left;
+	struct mem_tree *right;
+	int height;
+};
+
 struct mem_link {
 	uint64_t address;
 	uint64_t size;
-	struct mem_link *prev;
-	struct mem_link *next;
+	struct mem_tree by_addr;	/**< Free or allocated address tree. */
+	struct mem_tree by_size;	/**< Free size tree. */
+	struct mem_link *next;		/**< Spare node list. */
 };
 
+struct mem_link_block;
+
 struct mem_alloc {
-	struct mem_link free;
-	struct mem_link allocated;
+	struct mem_tree *free_by_addr;	/**< Free ranges, by address. */
+	struct mem_tree *free_by_size;	/**< Free ranges, by size. */
+	struct mem_tree *allocated;	/**< Allocated ranges, by address. */
+	struct mem_link *spare;		/**< Unused nodes. */
+	struct mem_link_block *blocks;	/**< Node storage. */
 };
 
 #ifdef __cplusplus
@@ -105,7 +122,10 @@ int mem_alloc_add_free(struct mem_alloc *m,
 /** Allocate memory
  *
  * Retrieve an available memory address for a free block
- * that is at least size bytes.
+ * that is at least size bytes. The address is aligned to the
+ * largest power of two that does not exceed size. The request is
+ * served best-fit: the smallest free block that can hold it is
+ * preferred over larger ones.
  *
  * @param[in, out] m       The memory allocator object.
  * @param[out]     address The retrieved address for the allocation.
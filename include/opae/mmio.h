@@ -138,6 +138,53 @@ fpga_result fpgaWriteMMIO512(fpga_handle handle,
 			    uint32_t mmio_num, uint64_t offset,
 			    const void *value);
 
+/**
+ * Read a batch of values from MMIO space
+ *
+ * This function performs the reads described by ops, in array order,
+ * with a single handle validation and, where the plugin requires one,
+ * a single lock acquisition. Each element names its own MMIO space,
+ * offset and access width (32 or 64 bits); on success its value field
+ * holds the value read.
+ *
+ * Processing stops at the first element that fails, whose error is
+ * returned. The value fields of the elements before it are valid.
+ *
+ * @param[in]     handle  Handle to previously opened accelerator resource
+ * @param[in,out] ops     Array of num_ops MMIO read operations
+ * @param[in]     num_ops Number of elements in ops
+ * @returns FPGA_OK on success. FPGA_INVALID_PARAM if any of the supplied
+ * parameters is invalid, including an element with a width other than
+ * 32 or 64. FPGA_EXCEPTION if an internal exception occurred while trying
+ * to access the handle.
+ */
+fpga_result fpgaReadMMIOBatch(fpga_handle handle,
+			      fpga_mmio_op *ops,
+			      uint32_t num_ops);
+
+/**
+ * Write a batch of values to MMIO space
+ *
+ * This function performs the writes described by ops, in array order,
+ * with a single handle validation and, where the plugin requires one,
+ * a single lock acquisition. Register programming sequences can be
+ * issued this way without crossing into the plugin once per register.
+ *
+ * Processing stops at the first element that fails, whose error is
+ * returned. The elements before it have been written.
+ *
+ * @param[in]  handle  Handle to previously opened accelerator resource
+ * @param[in]  ops     Array of num_ops MMIO write operations
+ * @param[in]  num_ops Number of elements in ops
+ * @returns FPGA_OK on success. FPGA_INVALID_PARAM if any of the supplied
+ * parameters is invalid, including an element with a width other than
+ * 32 or 64. FPGA_EXCEPTION if an internal exception occurred while trying
+ * to access the handle.
+ */
+fpga_result fpgaWriteMMIOBatch(fpga_handle handle,
+			       const fpga_mmio_op *ops,
+			       uint32_t num_ops);
+
 /**
  * Map MMIO space
  *
@@ -0,0 +1,86 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file stats.h
+ * @brief Functions for reading per-API call statistics
+ *
+ * When statistics are enabled, libopae-c counts the calls, the failed
+ * calls and the latency of each API function it forwards to a plugin,
+ * for each plugin and for each open handle. Statistics are enabled by
+ * setting LIBOPAE_STATS=1 in the environment, or with an "enabled"
+ * key in the "stats" section of the libopae configuration file.
+ * When they are disabled, the functions below return
+ * FPGA_NOT_SUPPORTED.
+ */
+
+#ifndef __FPGA_STATS_H__
+#define __FPGA_STATS_H__
+
+#include <opae/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Retrieve call statistics
+ *
+ * Fills stats with one entry for each API that has been called at
+ * least once, in the order of the library's API list.
+ *
+ * @param[in] handle Handle to a previously opened resource, whose
+ * calls are reported. When NULL, the calls made through all plugins
+ * are reported.
+ * @param[out] stats Array of max_stats entries. May be NULL when
+ * max_stats is 0.
+ * @param[in] max_stats Number of entries in stats.
+ * @param[out] num_stats Number of APIs that have been called. When
+ * larger than max_stats, only the first max_stats were returned.
+ *
+ * @returns FPGA_OK on success. FPGA_INVALID_PARAM if handle is not
+ * a valid handle, or num_stats is NULL. FPGA_NOT_SUPPORTED if
+ * statistics are not enabled.
+ */
+fpga_result fpgaGetStats(fpga_handle handle, fpga_api_stats *stats,
+			 uint32_t max_stats, uint32_t *num_stats);
+
+/**
+ * Reset call statistics
+ *
+ * @param[in] handle Handle whose statistics are reset. When NULL,
+ * the statistics of all plugins and handles are reset.
+ *
+ * @returns FPGA_OK on success. FPGA_INVALID_PARAM if handle is not
+ * a valid handle. FPGA_NOT_SUPPORTED if statistics are not enabled.
+ */
+fpga_result fpgaResetStats(fpga_handle handle);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif // __cplusplus
+
+#endif // __FPGA_STATS_H__
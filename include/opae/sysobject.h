@@ -218,6 +218,26 @@ fpga_result fpgaObjectRead(fpga_object obj, uint8_t *buffer, size_t offset,
  */
 fpga_result fpgaObjectRead64(fpga_object obj, uint64_t *value, int flags);
 
+/**
+ * @brief Read 64-bit values from several FPGA objects in one call.
+ * Equivalent to calling fpgaObjectRead64() on each object in turn, but
+ * for FPGA_OBJECT_SYNC each object keeps its underlying file open, so a
+ * refresh costs one read system call per object.
+ *
+ * @param[in] objs Array of count fpga_object instances, each an attribute
+ * @param[out] values Array of count 64-bit variables; values[i] receives
+ * the value of objs[i]
+ * @param[in] count The number of objects in objs
+ * @param[in] flags Flags that control how the objects are read, as for
+ * fpgaObjectRead64()
+ *
+ * @return FPGA_OK on success, FPGA_INVALID_PARAM if any of the supplied
+ * parameters is invalid. Reading stops at the first object that fails,
+ * and that object's result is returned.
+ */
+fpga_result fpgaObjectReadMany(fpga_object *objs, uint64_t *values,
+			       size_t count, int flags);
+
 /**
  * @brief Write 64-bit value to an FPGA object.
  * The value will be converted to string before writing. See flags below for
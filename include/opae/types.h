@@ -252,6 +252,41 @@ typedef struct metric_threshold {
 	threshold hysteresis;                          // Hysteresis
 } metric_threshold;
 
+/** Batched MMIO operation
+ *
+ * One element of the array passed to fpgaReadMMIOBatch() or
+ * fpgaWriteMMIOBatch(). width selects a 32- or 64-bit access.
+ * For writes, value holds the data to write (the low 32 bits
+ * for a 32-bit access). For reads, value receives the data read.
+ */
+typedef struct fpga_mmio_op {
+	uint32_t mmio_num;      // Number of MMIO space to access
+	uint32_t width;         // Access width in bits: 32 or 64
+	uint64_t offset;        // Byte offset into MMIO space
+	uint64_t value;         // Value written or read
+} fpga_mmio_op;
+
+#define FPGA_API_NAME_SIZE 48
+
+/** Call statistics of one API function
+ *
+ * Filled in by fpgaGetStats(). Latencies are in nanoseconds and
+ * cover the time spent in the plugin. The percentiles are read from
+ * a histogram whose buckets are at most 1/8 of their value wide.
+ */
+typedef struct fpga_api_stats {
+	char api[FPGA_API_NAME_SIZE];  // Name of the API, eg "fpgaReadMMIO64"
+	uint64_t calls;                // Number of calls
+	uint64_t errors;               // Calls that did not return FPGA_OK
+	uint64_t total_ns;             // Sum of the latencies
+	uint64_t min_ns;               // Lowest latency
+	uint64_t max_ns;               // Highest latency
+	uint64_t p50_ns;               // Median latency
+	uint64_t p90_ns;               // 90th percentile latency
+	uint64_t p99_ns;               // 99th percentile latency
+	uint64_t p999_ns;              // 99.9th percentile latency
+} fpga_api_stats;
+
 /** Internal token type header
  *
  * Each plugin (dfl: libxfpga.so, vfio: libopae-v.so) implements its own
@@ -135,6 +135,9 @@ typedef enum {
 	/** FPGA_IFC_UIO indicates that the plugin interface is the
 	 * uio-dfl driver. */
 	FPGA_IFC_UIO,
+	/** FPGA_IFC_EMU indicates that the plugin interface is the
+	 * in-process AFU emulation of libopae-sim. */
+	FPGA_IFC_EMU,
 } fpga_interface;
 
 /**
@@ -145,7 +148,9 @@ typedef enum {
 enum fpga_buffer_flags {
 	FPGA_BUF_PREALLOCATED = (1u << 0), /**< Use existing buffer */
 	FPGA_BUF_QUIET = (1u << 1),        /**< Suppress error messages */
-	FPGA_BUF_READ_ONLY = (1u << 2)     /**< Buffer is read-only */
+	FPGA_BUF_READ_ONLY = (1u << 2),    /**< Buffer is read-only */
+	FPGA_BUF_NUMA_ANY = (1u << 3),     /**< Don't place on device's node */
+	FPGA_BUF_SCATTER_GATHER = (1u << 4) /**< Back with 2MB/4KB pages */
 };
 
 /**
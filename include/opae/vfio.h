@@ -137,6 +137,52 @@ struct opae_vfio_buffer {
 	size_t buffer_size;		/**< Buffer size. */
 	uint64_t buffer_iova;		/**< Buffer IOVA address. */
 	int flags;			/**< See opae_vfio_buffer_flags. */
+	struct opae_vfio_buffer *next;	/**< Pool free list link. */
+};
+
+/** Number of buffer pool size classes (4KB, 64KB, 2MB). */
+#define OPAE_VFIO_POOL_CLASSES 3
+
+/** Size of each DMA-mapped buffer pool slab. */
+#define OPAE_VFIO_POOL_SLAB_SIZE (2 * 1024 * 1024)
+
+/**
+ * Buffer pool slab
+ *
+ * A region of system memory that is mapped for DMA once and carved
+ * into equal-size buffers of a single size class.
+ */
+struct opae_vfio_pool_slab {
+	uint8_t *slab_ptr;			/**< Slab virtual address. */
+	size_t slab_size;			/**< Slab size. */
+	uint64_t slab_iova;			/**< Slab IOVA address. */
+	struct opae_vfio_buffer *chunks;	/**< Buffer info for each chunk. */
+	struct opae_vfio_pool_slab *next;	/**< Pointer to next in list. */
+};
+
+/**
+ * Buffer pool statistics
+ *
+ * Retrieved by opae_vfio_buffer_pool_stats().
+ */
+struct opae_vfio_pool_stats {
+	uint64_t hits;			/**< Allocations served from a free list. */
+	uint64_t misses;		/**< Allocations that mapped a new slab. */
+	uint64_t bytes_resident;	/**< Slab bytes currently mapped for DMA. */
+	uint64_t bytes_in_use;		/**< Pool bytes currently allocated. */
+};
+
+/**
+ * DMA buffer pool
+ *
+ * Caches DMA-mapped slabs so that small, short-lived buffers can be
+ * allocated and freed without an mmap/munmap and an IOMMU map/unmap.
+ */
+struct opae_vfio_pool {
+	struct opae_vfio_pool_slab *slabs;	/**< List of mapped slabs. */
+	struct opae_vfio_buffer *free_list[OPAE_VFIO_POOL_CLASSES];
+						/**< Free buffers per size class. */
+	struct opae_vfio_pool_stats stats;	/**< Pool statistics. */
 };
 
 /**
@@ -156,6 +202,8 @@ struct opae_vfio {
 	struct opae_vfio_group group;			/**< The VFIO device group. */
 	struct opae_vfio_device device;			/**< The VFIO device. */
 	opae_hash_map cont_buffers;		/**< Map of allocated DMA buffers. */
+	struct opae_vfio_pool pool;			/**< Cache of DMA-mapped slabs. */
+	int numa_node;					/**< Device-local NUMA node, or -1. */
 };
 
 #ifdef __cplusplus
@@ -269,11 +317,14 @@ int opae_vfio_region_get(struct opae_vfio *v,
  * is not explicitly freed by opae_vfio_buffer_free, it will be
  * freed during opae_vfio_close.
  *
- * mmap is used for the allocation. If the size is greater than 2MB,
- * then the allocation request is fulfilled by a 1GB huge page. Else,
- * if the size is greater than 4096, then the request is fulfilled by
- * a 2MB huge page. Else, the request is fulfilled by the non-huge
- * page pool.
+ * Requests of 2MB or less are served from the buffer pool: the size
+ * is rounded up to the nearest size class (4KB, 64KB or 2MB) and the
+ * buffer is carved from a 2MB slab that is mapped for DMA once and
+ * reused after opae_vfio_buffer_free. Pool buffers are zeroed on
+ * allocation. Slabs remain mapped until opae_vfio_close.
+ *
+ * Larger requests are allocated with mmap and fulfilled by a 1GB huge
+ * page.
  *
  * @note Allocations from the huge page pool require that huge pages
  * be configured on the system. Huge pages may be configured on the
@@ -339,6 +390,10 @@ int opae_vfio_buffer_allocate(struct opae_vfio *v,
  */
 enum opae_vfio_buffer_flags {
 	OPAE_VFIO_BUF_PREALLOCATED = 1, /**< Use existing buffer */
+	OPAE_VFIO_BUF_NOPOOL = 0x100,   /**< Bypass the buffer pool */
+	OPAE_VFIO_BUF_POOLED = 0x200,   /**< Set on buffers owned by the pool */
+	OPAE_VFIO_BUF_NUMA_ANY = 0x400, /**< Don't place on the device's node */
+	OPAE_VFIO_BUF_SCATTER_GATHER = 0x800, /**< Back with 2MB/4K pages */
 };
 
 /**
@@ -350,11 +405,26 @@ enum opae_vfio_buffer_flags {
  * freed during opae_vfio_close, unless OPAE_VFIO_BUF_PREALLOCATED
  * is used in which case the buffer is not freed by this library.
  *
- * When not using OPAE_VFIO_BUF_PREALLOCATED, mmap is used for the
- * allocation. If the size is greater than 2MB, then the allocation
- * request is fulfilled by a 1GB huge page. Else, if the size is
- * greater than 4096, then the request is fulfilled by a 2MB huge
- * page. Else, the request is fulfilled by the non-huge page pool.
+ * When not using OPAE_VFIO_BUF_PREALLOCATED, requests of 2MB or less
+ * are served from the buffer pool, as described for
+ * opae_vfio_buffer_allocate, unless OPAE_VFIO_BUF_NOPOOL is given.
+ * Otherwise, mmap is used for the allocation. If the size is greater
+ * than 2MB, then the allocation request is fulfilled by a 1GB huge
+ * page. Else, if the size is greater than 4096, then the request is
+ * fulfilled by a 2MB huge page. Else, the request is fulfilled by the
+ * non-huge page pool.
+ *
+ * Given OPAE_VFIO_BUF_SCATTER_GATHER, a request greater than 2MB is
+ * instead backed by 2MB huge pages, falling back to 4K pages when no
+ * 2MB pages are available, and the size is rounded up to the page
+ * size. The pages need not be physically contiguous; the IOMMU maps
+ * them to one contiguous IOVA range, so the device sees a single
+ * buffer while at most one page goes partly unused.
+ *
+ * Memory allocated by this function, including the buffer pool, is
+ * placed on v->numa_node when the device reports one. Given
+ * OPAE_VFIO_BUF_NUMA_ANY, the buffer bypasses the pool and its pages
+ * are placed according to the calling thread's memory policy.
  *
  * @param[in, out] v    The open OPAE VFIO device.
  * @param[in, out] size A pointer to the requested size. The size
@@ -447,6 +517,29 @@ struct opae_vfio_buffer *opae_vfio_buffer_info(struct opae_vfio *v,
 int opae_vfio_buffer_free(struct opae_vfio *v,
 			  uint8_t *buf);
 
+/**
+ * Retrieve buffer pool statistics
+ *
+ * @param[in]  v     The open OPAE VFIO device.
+ * @param[out] stats Receives a snapshot of the pool statistics.
+ * @returns Non-zero on error. Zero on success.
+ */
+int opae_vfio_buffer_pool_stats(struct opae_vfio *v,
+				struct opae_vfio_pool_stats *stats);
+
+/**
+ * Retrieve the NUMA node of a buffer
+ *
+ * @param[in]  v     The open OPAE VFIO device.
+ * @param[in]  buf   The virtual address of a buffer returned by
+ *                   opae_vfio_buffer_allocate() or
+ *                   opae_vfio_buffer_allocate_ex().
+ * @returns The node that backs the first page of buf, or -1 if
+ * it cannot be determined.
+ */
+int opae_vfio_buffer_numa_node(struct opae_vfio *v,
+			       uint8_t *buf);
+
 /**
  * Enable an IRQ
  *
@@ -30,6 +30,9 @@
 
 #include <stdio.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -288,33 +291,265 @@ fpga_result opae_load_bitstream(const char *file, opae_bitstream_info *info)
 	return opae_resolve_bitstream(info);
 }
 
-fpga_result opae_unload_bitstream(opae_bitstream_info *info)
+STATIC fpga_result opae_bitstream_release_metadata(opae_bitstream_info *info)
 {
-	fpga_result res = FPGA_OK;
+	if (!info->parsed_metadata)
+		return FPGA_OK;
 
-	if (!info)
-		return FPGA_INVALID_PARAM;
+	switch (info->metadata_version) {
 
-	if (info->data)
-		opae_free(info->data);
+	case 1:
+		opae_bitstream_release_metadata_v1(
+		(opae_bitstream_metadata_v1 *)info->parsed_metadata);
+	break;
+
+	default:
+		OPAE_ERR("metadata: unsupported version: %d",
+			 info->metadata_version);
+		return FPGA_EXCEPTION;
+	}
+
+	return FPGA_OK;
+}
 
-	if (info->parsed_metadata) {
+/*
+ * Validated, mapped bitstreams, keyed on the identity and modification
+ * time of their file. An entry is shared by every opae_bitstream_info
+ * that opae_map_bitstream() filled from it, and stays cached after the
+ * last of those is unloaded, so that mapping the same unchanged file
+ * again skips reading and validating it.
+ */
+typedef struct _opae_bitstream_cache_entry {
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	struct timespec mtime;
+	opae_bitstream_info info;
+	uint32_t refs;
+	struct _opae_bitstream_cache_entry *next;
+} opae_bitstream_cache_entry;
+
+#define OPAE_BITSTREAM_CACHE_MAX 4
+
+STATIC pthread_mutex_t bitstream_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+STATIC opae_bitstream_cache_entry *bitstream_cache;
+
+STATIC void opae_bitstream_cache_free(opae_bitstream_cache_entry *e)
+{
+	opae_bitstream_release_metadata(&e->info);
+	munmap(e->info.data, e->info.data_len);
+	opae_free(e);
+}
 
-		switch (info->metadata_version) {
+// Drop unreferenced entries beyond the first keep. Called locked.
+STATIC void opae_bitstream_cache_trim(uint32_t keep)
+{
+	opae_bitstream_cache_entry **pe = &bitstream_cache;
+	uint32_t count = 0;
+
+	while (*pe) {
+		opae_bitstream_cache_entry *e = *pe;
 
-		case 1:
-			opae_bitstream_release_metadata_v1(
-			(opae_bitstream_metadata_v1 *)info->parsed_metadata);
-		break;
+		if (!e->refs && (++count > keep)) {
+			*pe = e->next;
+			opae_bitstream_cache_free(e);
+		} else {
+			pe = &e->next;
+		}
+	}
+}
 
-		default:
-			OPAE_ERR("metadata: unsupported version: %d",
-				 info->metadata_version);
-			res = FPGA_EXCEPTION;
+STATIC bool opae_bitstream_cache_get(const struct stat *st,
+				     opae_bitstream_info *info)
+{
+	opae_bitstream_cache_entry **pe;
+	bool found = false;
+
+	pthread_mutex_lock(&bitstream_cache_lock);
+
+	for (pe = &bitstream_cache ; *pe ; pe = &(*pe)->next) {
+		opae_bitstream_cache_entry *e = *pe;
+
+		if ((e->dev == st->st_dev) &&
+		    (e->ino == st->st_ino) &&
+		    (e->size == st->st_size) &&
+		    (e->mtime.tv_sec == st->st_mtim.tv_sec) &&
+		    (e->mtime.tv_nsec == st->st_mtim.tv_nsec)) {
+			++e->refs;
+			*info = e->info;
+			// Most recently used first.
+			*pe = e->next;
+			e->next = bitstream_cache;
+			bitstream_cache = e;
+			found = true;
+			break;
 		}
+	}
+
+	pthread_mutex_unlock(&bitstream_cache_lock);
+
+	return found;
+}
+
+STATIC fpga_result opae_bitstream_cache_add(const struct stat *st,
+					    const opae_bitstream_info *info)
+{
+	opae_bitstream_cache_entry *e;
+
+	e = (opae_bitstream_cache_entry *)
+		opae_calloc(1, sizeof(opae_bitstream_cache_entry));
+	if (!e) {
+		OPAE_ERR("calloc failed");
+		return FPGA_NO_MEMORY;
+	}
+
+	e->dev = st->st_dev;
+	e->ino = st->st_ino;
+	e->size = st->st_size;
+	e->mtime = st->st_mtim;
+	e->info = *info;
+	e->info.filename = NULL;
+	e->refs = 1;
+
+	pthread_mutex_lock(&bitstream_cache_lock);
+	e->next = bitstream_cache;
+	bitstream_cache = e;
+	opae_bitstream_cache_trim(OPAE_BITSTREAM_CACHE_MAX);
+	pthread_mutex_unlock(&bitstream_cache_lock);
+
+	return FPGA_OK;
+}
+
+// Release the reference held by info, if its data is a cached mapping.
+STATIC bool opae_bitstream_cache_put(const opae_bitstream_info *info)
+{
+	opae_bitstream_cache_entry *e;
+	bool found = false;
+
+	pthread_mutex_lock(&bitstream_cache_lock);
+
+	for (e = bitstream_cache ; e ; e = e->next) {
+		if (e->info.data == info->data) {
+			if (e->refs)
+				--e->refs;
+			found = true;
+			break;
+		}
+	}
+
+	opae_bitstream_cache_trim(OPAE_BITSTREAM_CACHE_MAX);
+
+	pthread_mutex_unlock(&bitstream_cache_lock);
+
+	return found;
+}
+
+void opae_bitstream_cache_flush(void)
+{
+	pthread_mutex_lock(&bitstream_cache_lock);
+	opae_bitstream_cache_trim(0);
+	pthread_mutex_unlock(&bitstream_cache_lock);
+}
+
+fpga_result opae_map_bitstream(const char *file, opae_bitstream_info *info)
+{
+	fpga_result res;
+	struct stat st;
+	uint8_t *addr;
+	int fd;
+
+	if (!file || !info)
+		return FPGA_INVALID_PARAM;
+
+	if (!opae_bitstream_path_is_valid(file,
+					  OPAE_BITSTREAM_PATH_NO_SYMLINK)) {
+		OPAE_ERR("invalid bitstream path \"%s\"", file);
+		return FPGA_INVALID_PARAM;
+	}
+
+	memset(info, 0, sizeof(opae_bitstream_info));
+
+	fd = opae_open(file, O_RDONLY);
+	if (fd < 0) {
+		OPAE_ERR("open failed");
+		return FPGA_EXCEPTION;
+	}
+
+	if (fstat(fd, &st)) {
+		OPAE_ERR("fstat failed");
+		opae_close(fd);
+		return FPGA_EXCEPTION;
+	}
+
+	if (opae_bitstream_cache_get(&st, info)) {
+		opae_close(fd);
+		info->filename = file;
+		return FPGA_OK;
+	}
+
+	if (st.st_size <= 0) {
+		OPAE_ERR("empty bitstream \"%s\"", file);
+		opae_close(fd);
+		return FPGA_INVALID_PARAM;
+	}
+
+	// Fault the whole image in now, rather than page by page
+	// while the driver copies it.
+	addr = (uint8_t *)mmap(NULL, (size_t)st.st_size, PROT_READ,
+			       MAP_PRIVATE|MAP_POPULATE, fd, 0);
+	opae_close(fd);
 
+	if (addr == MAP_FAILED) {
+		OPAE_ERR("mmap failed");
+		return FPGA_EXCEPTION;
 	}
 
+	madvise(addr, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+	info->data = addr;
+	info->data_len = (size_t)st.st_size;
+	info->filename = file;
+
+	if (opae_is_legacy_bitstream(info)) {
+		opae_resolve_legacy_bitstream(info);
+		OPAE_MSG("Legacy bitstream (GBS) format detected.");
+		OPAE_MSG("Legacy GBS support is deprecated "
+			 "and will be removed in a future release.");
+		res = FPGA_OK;
+	} else {
+		res = opae_resolve_bitstream(info);
+	}
+
+	if (res == FPGA_OK)
+		res = opae_bitstream_cache_add(&st, info);
+
+	if (res != FPGA_OK) {
+		opae_bitstream_release_metadata(info);
+		munmap(addr, (size_t)st.st_size);
+		memset(info, 0, sizeof(opae_bitstream_info));
+	}
+
+	return res;
+}
+
+fpga_result opae_unload_bitstream(opae_bitstream_info *info)
+{
+	fpga_result res = FPGA_OK;
+
+	if (!info)
+		return FPGA_INVALID_PARAM;
+
+	// The mapping and its metadata belong to the cache.
+	if (info->data && opae_bitstream_cache_put(info)) {
+		memset(info, 0, sizeof(opae_bitstream_info));
+		return FPGA_OK;
+	}
+
+	if (info->data)
+		opae_free(info->data);
+
+	res = opae_bitstream_release_metadata(info);
+
 	memset(info, 0, sizeof(opae_bitstream_info));
 
 	return res;
@@ -110,6 +110,35 @@ extern "C" {
  */
 fpga_result opae_load_bitstream(const char *file, opae_bitstream_info *info);
 
+/**
+ * Map a GBS file from disk into memory
+ *
+ * Like opae_load_bitstream(), but the file is mapped read-only rather
+ * than copied into a heap buffer, and the header and metadata are parsed
+ * in place. `info->data` may be passed directly to fpgaReconfigureSlot().
+ *
+ * Validated mappings are cached, keyed on the file's device, inode, size
+ * and modification time. Mapping the same unchanged file again shares the
+ * cached mapping and parsed metadata instead of re-reading and
+ * re-validating the file. The file must not be truncated while mapped.
+ *
+ * @param[in] file Location of the GBS file on disk.
+ * @param[out] info Storage for the mapped GBS file contents
+ *                  and its expanded metadata. Release it with
+ *                  opae_unload_bitstream().
+ *
+ * @returns As for opae_load_bitstream(). FPGA_EXCEPTION if the file
+ * can't be opened or mapped.
+ */
+fpga_result opae_map_bitstream(const char *file, opae_bitstream_info *info);
+
+/**
+ * Release cached GBS mappings that are no longer in use
+ *
+ * Mappings still referenced by an opae_bitstream_info are kept.
+ */
+void opae_bitstream_cache_flush(void);
+
 /**
  * @deprecated Determine whether a loaded GBS is in legacy format.
  *
@@ -120,7 +149,8 @@ bool opae_is_legacy_bitstream(opae_bitstream_info *info);
 /**
  * Unload a memory-resident GBS
  *
- * Used to free the resources allocated by `opae_load_bitstream`.
+ * Used to free the resources allocated by `opae_load_bitstream` or
+ * `opae_map_bitstream`.
  *
  * @param[in] info The loaded GBS info to be released.
  *
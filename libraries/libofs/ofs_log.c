@@ -39,6 +39,7 @@
 #include <pthread.h>
 
 #include "mock/opae_std.h"
+#include "libopae-c/async-log.h"
 
 static int log_level = OFS_DEFAULT_LOG_LEVEL;
 static FILE *log_file;
@@ -59,6 +60,11 @@ void ofs_print(int level, const char *fmt, ...)
 		fp = log_file ? log_file : stdout;
 
 	va_start(argp, fmt);
+	if (!opae_async_log_vprint(fp, fmt, argp)) {
+		// queued for (or dropped by) the async log thread
+		va_end(argp);
+		return;
+	}
 	err = pthread_mutex_lock(&log_lock);
 	if (err)
 		fprintf(stderr, "ofs_print(): pthread_mutex_lock() failed: %s",
@@ -104,10 +110,23 @@ __attribute__((constructor)) STATIC void ofs_init(void)
 
 	if (!log_file)
 		log_file = stdout;
+
+	s = getenv("LIBOFS_LOG_ASYNC");
+	if (s && strcmp(s, "0")) {
+		uint32_t rate_limit = OPAE_ASYNC_LOG_DEFAULT_RATE;
+
+		s = getenv("LIBOFS_LOG_RATE");
+		if (s)
+			rate_limit = (uint32_t)strtoul(s, NULL, 0);
+		if (opae_async_log_start("ofs-log", rate_limit))
+			fprintf(stderr, "Could not start the async log "
+				"thread. Logging synchronously.\n");
+	}
 }
 
 __attribute__((destructor)) STATIC void ofs_release(void)
 {
+	opae_async_log_stop();
 	if (log_file && log_file != stdout)
 		opae_fclose(log_file);
 	log_file = NULL;
@@ -71,6 +71,14 @@ typedef struct _opae_api_adapter_table {
 	fpga_result (*fpgaWriteMMIO512)(fpga_handle handle, uint32_t mmio_num,
 				       uint64_t offset, const void *value);
 
+	fpga_result (*fpgaReadMMIOBatch)(fpga_handle handle,
+					 fpga_mmio_op *ops,
+					 uint32_t num_ops);
+
+	fpga_result (*fpgaWriteMMIOBatch)(fpga_handle handle,
+					  const fpga_mmio_op *ops,
+					  uint32_t num_ops);
+
 	fpga_result (*fpgaMapMMIO)(fpga_handle handle, uint32_t mmio_num,
 				   uint64_t **mmio_ptr);
 
@@ -81,6 +89,8 @@ typedef struct _opae_api_adapter_table {
 				     uint32_t max_tokens,
 				     uint32_t *num_matches);
 
+	fpga_result (*fpgaEnumerateRefresh)(void);
+
 	fpga_result (*fpgaCloneToken)(fpga_token src, fpga_token *dst);
 
 	fpga_result (*fpgaDestroyToken)(fpga_token *token);
@@ -103,6 +113,9 @@ typedef struct _opae_api_adapter_table {
 	fpga_result (*fpgaGetIOAddress)(fpga_handle handle, uint64_t wsid,
 					uint64_t *ioaddr);
 
+	fpga_result (*fpgaGetBufferNumaNode)(fpga_handle handle, uint64_t wsid,
+					     int *node);
+
 	fpga_result (*fpgaBindSVA)(fpga_handle handle, uint32_t *pasid);
 
 	// Internal methods between shell and plugin to pin/unpin an existing
@@ -194,6 +207,9 @@ typedef struct _opae_api_adapter_table {
 	fpga_result (*fpgaObjectRead64)(fpga_object obj, uint64_t *value,
 					int flags);
 
+	fpga_result (*fpgaObjectReadMany)(fpga_object *objs, uint64_t *values,
+					  size_t count, int flags);
+
 	fpga_result (*fpgaObjectGetSize)(fpga_object obj, uint64_t *value,
 					 int flags);
 
@@ -233,6 +249,10 @@ typedef struct _opae_api_adapter_table {
 	int (*initialize)(void);
 	int (*finalize)(void);
 
+	// Call statistics of the plugin, owned by libopae-c (stats.h).
+	// NULL unless statistics are enabled.
+	struct _opae_stats *stats;
+
 } opae_api_adapter_table;
 
 int opae_plugin_mgr_register_plugin(const char *name, const char *cfg);
@@ -33,6 +33,7 @@
 #endif // _GNU_SOURCE
 
 #include <stdio.h>
+#include <string.h>
 
 #include <opae/properties.h>
 #include <opae/types_enum.h>
@@ -41,8 +42,21 @@
 #include "opae_int.h"
 #include "props.h"
 #include "multi-port-afu.h"
+#include "wait-events.h"
+#include "stats.h"
 #include "mock/opae_std.h"
 
+/* Forward an API call to the plugin that owns a wrapped handle,
+ * charging it to both the plugin and the handle statistics scope.
+ */
+#define OPAE_HANDLE_CALL(__wh, __fn, ...)                           \
+	OPAE_STATS_CALL((__wh)->adapter_table, (__wh)->stats, __fn, \
+			__VA_ARGS__)
+
+/* Forward an API call to a plugin where no handle is involved. */
+#define OPAE_ADAPTER_CALL(__table, __fn, ...) \
+	OPAE_STATS_CALL(__table, NULL, __fn, ##__VA_ARGS__)
+
 const char *
 __OPAE_API__ fpgaErrStr(fpga_result e)
 {
@@ -138,8 +152,9 @@ fpga_result opae_downref_wrapped_token(opae_wrapped_token *wt)
 		wt->magic = 0;
 
 		if (wt->adapter_table->fpgaDestroyToken)
-			fres = wt->adapter_table->fpgaDestroyToken(
-					&wt->opae_token);
+			fres = OPAE_ADAPTER_CALL(
+				wt->adapter_table, fpgaDestroyToken,
+				&wt->opae_token);
 		else
 			fres = FPGA_NOT_SUPPORTED;
 
@@ -198,6 +213,8 @@ opae_allocate_wrapped_handle(opae_wrapped_token *wt, fpga_handle opae_handle,
 		whan->adapter_table = adapter;
 		whan->parent = NULL;
 		whan->child_next = NULL;
+		whan->stats = opae_stats_handle(adapter->stats,
+				(fpga_token_header *)wt->opae_token);
 
 		opae_upref_wrapped_token(wt);
 	}
@@ -291,8 +308,8 @@ fpga_result __OPAE_API__ fpgaOpen(fpga_token token, fpga_handle *handle,
 	ASSERT_NOT_NULL_RESULT(wrapped_token->adapter_table->fpgaClose,
 			       FPGA_NOT_SUPPORTED);
 
-	res = wrapped_token->adapter_table->fpgaOpen(wrapped_token->opae_token,
-						     &opae_handle, flags);
+	res = OPAE_ADAPTER_CALL(wrapped_token->adapter_table, fpgaOpen,
+				wrapped_token->opae_token, &opae_handle, flags);
 
 	ASSERT_RESULT(res);
 
@@ -317,6 +334,7 @@ fpga_result __OPAE_API__ fpgaOpen(fpga_token token, fpga_handle *handle,
 				wrapped_handle->adapter_table->fpgaClose(
 					wrapped_handle->opae_handle);
 
+			opae_stats_handle_closed(wrapped_handle->stats);
 			opae_destroy_wrapped_handle(wrapped_handle);
 			return res;
 		}
@@ -372,10 +390,11 @@ fpga_result __OPAE_API__ fpgaClose(fpga_handle handle)
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaClose,
 			       FPGA_NOT_SUPPORTED);
 
-	res = wrapped_handle->adapter_table->fpgaClose(
+	res = OPAE_HANDLE_CALL(wrapped_handle, fpgaClose,
 		wrapped_handle->opae_handle);
 
 	afu_close_children(wrapped_handle);
+	opae_stats_handle_closed(wrapped_handle->stats);
 	opae_destroy_wrapped_handle(wrapped_handle);
 
 	return res;
@@ -390,7 +409,7 @@ fpga_result __OPAE_API__ fpgaReset(fpga_handle handle)
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaReset,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaReset(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaReset,
 		wrapped_handle->opae_handle);
 }
 
@@ -442,7 +461,7 @@ fpga_result __OPAE_API__ fpgaGetPropertiesFromHandle(fpga_handle handle,
 		wrapped_handle->adapter_table->fpgaGetPropertiesFromHandle,
 		FPGA_NOT_SUPPORTED);
 
-	res = wrapped_handle->adapter_table->fpgaGetPropertiesFromHandle(
+	res = OPAE_HANDLE_CALL(wrapped_handle, fpgaGetPropertiesFromHandle,
 		wrapped_handle->opae_handle, prop);
 
 	ASSERT_RESULT(res);
@@ -492,7 +511,8 @@ fpga_result __OPAE_API__ fpgaGetProperties(fpga_token token,
 			wrapped_token->adapter_table->fpgaGetProperties,
 			FPGA_NOT_SUPPORTED);
 
-		res = wrapped_token->adapter_table->fpgaGetProperties(
+		res = OPAE_ADAPTER_CALL(
+			wrapped_token->adapter_table, fpgaGetProperties,
 			wrapped_token->opae_token, prop);
 
 		ASSERT_RESULT(res);
@@ -542,7 +562,8 @@ fpga_result __OPAE_API__ fpgaUpdateProperties(fpga_token token,
 		p->parent = NULL;
 	}
 
-	res = wrapped_token->adapter_table->fpgaUpdateProperties(
+	res = OPAE_ADAPTER_CALL(
+		wrapped_token->adapter_table, fpgaUpdateProperties,
 		wrapped_token->opae_token, prop);
 
 	if (res != FPGA_OK) {
@@ -571,7 +592,7 @@ fpga_result __OPAE_API__ fpgaWriteMMIO64(fpga_handle handle, uint32_t mmio_num,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaWriteMMIO64,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaWriteMMIO64(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaWriteMMIO64,
 		wrapped_handle->opae_handle, mmio_num, offset, value);
 }
 
@@ -585,7 +606,7 @@ fpga_result __OPAE_API__ fpgaReadMMIO64(fpga_handle handle, uint32_t mmio_num,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaReadMMIO64,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaReadMMIO64(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaReadMMIO64,
 		wrapped_handle->opae_handle, mmio_num, offset, value);
 }
 
@@ -599,7 +620,7 @@ fpga_result __OPAE_API__ fpgaWriteMMIO32(fpga_handle handle, uint32_t mmio_num,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaWriteMMIO32,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaWriteMMIO32(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaWriteMMIO32,
 		wrapped_handle->opae_handle, mmio_num, offset, value);
 }
 
@@ -613,7 +634,7 @@ fpga_result __OPAE_API__ fpgaReadMMIO32(fpga_handle handle, uint32_t mmio_num,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaReadMMIO32,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaReadMMIO32(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaReadMMIO32,
 		wrapped_handle->opae_handle, mmio_num, offset, value);
 }
 
@@ -627,10 +648,105 @@ fpga_result __OPAE_API__ fpgaWriteMMIO512(fpga_handle handle,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaWriteMMIO512,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaWriteMMIO512(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaWriteMMIO512,
 		wrapped_handle->opae_handle, mmio_num, offset, value);
 }
 
+fpga_result __OPAE_API__ fpgaReadMMIOBatch(fpga_handle handle,
+	fpga_mmio_op *ops, uint32_t num_ops)
+{
+	fpga_result res = FPGA_OK;
+	uint32_t i;
+	opae_wrapped_handle *wrapped_handle =
+		opae_validate_wrapped_handle(handle);
+
+	ASSERT_NOT_NULL(wrapped_handle);
+	if (!num_ops)
+		return FPGA_OK;
+	ASSERT_NOT_NULL(ops);
+
+	if (wrapped_handle->adapter_table->fpgaReadMMIOBatch)
+		return OPAE_HANDLE_CALL(wrapped_handle, fpgaReadMMIOBatch,
+			wrapped_handle->opae_handle, ops, num_ops);
+
+	// The plugin has no batch entry point: issue one read per op.
+	for (i = 0 ; (i < num_ops) && (res == FPGA_OK) ; ++i) {
+		uint32_t value32 = 0;
+
+		switch (ops[i].width) {
+		case 32:
+			ASSERT_NOT_NULL_RESULT(
+				wrapped_handle->adapter_table->fpgaReadMMIO32,
+				FPGA_NOT_SUPPORTED);
+			res = OPAE_HANDLE_CALL(wrapped_handle, fpgaReadMMIO32,
+				wrapped_handle->opae_handle, ops[i].mmio_num,
+				ops[i].offset, &value32);
+			ops[i].value = value32;
+			break;
+		case 64:
+			ASSERT_NOT_NULL_RESULT(
+				wrapped_handle->adapter_table->fpgaReadMMIO64,
+				FPGA_NOT_SUPPORTED);
+			res = OPAE_HANDLE_CALL(wrapped_handle, fpgaReadMMIO64,
+				wrapped_handle->opae_handle, ops[i].mmio_num,
+				ops[i].offset, &ops[i].value);
+			break;
+		default:
+			OPAE_ERR("invalid MMIO width: %u", ops[i].width);
+			res = FPGA_INVALID_PARAM;
+			break;
+		}
+	}
+
+	return res;
+}
+
+fpga_result __OPAE_API__ fpgaWriteMMIOBatch(fpga_handle handle,
+	const fpga_mmio_op *ops, uint32_t num_ops)
+{
+	fpga_result res = FPGA_OK;
+	uint32_t i;
+	opae_wrapped_handle *wrapped_handle =
+		opae_validate_wrapped_handle(handle);
+
+	ASSERT_NOT_NULL(wrapped_handle);
+	if (!num_ops)
+		return FPGA_OK;
+	ASSERT_NOT_NULL(ops);
+
+	if (wrapped_handle->adapter_table->fpgaWriteMMIOBatch)
+		return OPAE_HANDLE_CALL(wrapped_handle, fpgaWriteMMIOBatch,
+			wrapped_handle->opae_handle, ops, num_ops);
+
+	// The plugin has no batch entry point: issue one write per op.
+	for (i = 0 ; (i < num_ops) && (res == FPGA_OK) ; ++i) {
+		switch (ops[i].width) {
+		case 32:
+			ASSERT_NOT_NULL_RESULT(
+				wrapped_handle->adapter_table->fpgaWriteMMIO32,
+				FPGA_NOT_SUPPORTED);
+			res = OPAE_HANDLE_CALL(wrapped_handle, fpgaWriteMMIO32,
+				wrapped_handle->opae_handle, ops[i].mmio_num,
+				ops[i].offset, (uint32_t)ops[i].value);
+			break;
+		case 64:
+			ASSERT_NOT_NULL_RESULT(
+				wrapped_handle->adapter_table->fpgaWriteMMIO64,
+				FPGA_NOT_SUPPORTED);
+			res = OPAE_HANDLE_CALL(wrapped_handle, fpgaWriteMMIO64,
+				wrapped_handle->opae_handle, ops[i].mmio_num,
+				ops[i].offset, ops[i].value);
+			break;
+		default:
+			OPAE_ERR("invalid MMIO width: %u", ops[i].width);
+			res = FPGA_INVALID_PARAM;
+			break;
+		}
+	}
+
+	return res;
+}
+
 fpga_result __OPAE_API__ fpgaMapMMIO(fpga_handle handle, uint32_t mmio_num,
 			uint64_t **mmio_ptr)
 {
@@ -641,7 +757,7 @@ fpga_result __OPAE_API__ fpgaMapMMIO(fpga_handle handle, uint32_t mmio_num,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaMapMMIO,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaMapMMIO(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaMapMMIO,
 		wrapped_handle->opae_handle, mmio_num, mmio_ptr);
 }
 
@@ -654,7 +770,7 @@ fpga_result __OPAE_API__ fpgaUnmapMMIO(fpga_handle handle, uint32_t mmio_num)
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaUnmapMMIO,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaUnmapMMIO(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaUnmapMMIO,
 		wrapped_handle->opae_handle, mmio_num);
 }
 
@@ -691,9 +807,10 @@ static int opae_enumerate(const opae_api_adapter_table *adapter, void *context)
 		return OPAE_ENUM_CONTINUE;
 	}
 
-	res = adapter->fpgaEnumerate(ctx->filters, ctx->num_filters,
-				     ctx->adapter_tokens, space_remaining,
-				     &num_matches);
+	res = OPAE_ADAPTER_CALL(adapter, fpgaEnumerate,
+				ctx->filters, ctx->num_filters,
+				ctx->adapter_tokens, space_remaining,
+				&num_matches);
 
 	if (res != FPGA_OK) {
 		OPAE_DBG("fpgaEnumerate() failed for \"%s\": %s",
@@ -877,6 +994,34 @@ out_free_tokens:
 	return res;
 }
 
+static int opae_enumerate_refresh(const opae_api_adapter_table *adapter,
+				  void *context)
+{
+	uint32_t *errors = (uint32_t *)context;
+	fpga_result res;
+
+	if (!adapter->fpgaEnumerateRefresh)
+		return OPAE_ENUM_CONTINUE;
+
+	res = OPAE_ADAPTER_CALL(adapter, fpgaEnumerateRefresh);
+	if (res != FPGA_OK) {
+		OPAE_DBG("fpgaEnumerateRefresh() failed for \"%s\": %s",
+			 adapter->plugin.path, fpgaErrStr(res));
+		++*errors;
+	}
+
+	return OPAE_ENUM_CONTINUE;
+}
+
+fpga_result __OPAE_API__ fpgaEnumerateRefresh(void)
+{
+	uint32_t errors = 0;
+
+	opae_plugin_mgr_for_each_adapter(opae_enumerate_refresh, &errors);
+
+	return errors ? FPGA_EXCEPTION : FPGA_OK;
+}
+
 fpga_result __OPAE_API__ fpgaCloneToken(fpga_token src, fpga_token *dst)
 {
 	fpga_result res;
@@ -894,7 +1039,8 @@ fpga_result __OPAE_API__ fpgaCloneToken(fpga_token src, fpga_token *dst)
 		wrapped_src_token->adapter_table->fpgaDestroyToken,
 		FPGA_NOT_SUPPORTED);
 
-	res = wrapped_src_token->adapter_table->fpgaCloneToken(
+	res = OPAE_ADAPTER_CALL(
+		wrapped_src_token->adapter_table, fpgaCloneToken,
 		wrapped_src_token->opae_token, &cloned_token);
 
 	ASSERT_RESULT(res);
@@ -983,7 +1129,7 @@ fpga_result __OPAE_API__ fpgaPrepareBuffer(fpga_handle handle,
 		return FPGA_NOT_SUPPORTED;
 	}
 
-	res = wrapped_handle->adapter_table->fpgaPrepareBuffer(
+	res = OPAE_HANDLE_CALL(wrapped_handle, fpgaPrepareBuffer,
 		wrapped_handle->opae_handle, len, buf_addr, wsid, flags);
 	if (res != FPGA_OK)
 		return res;
@@ -1014,7 +1160,7 @@ fpga_result __OPAE_API__ fpgaReleaseBuffer(fpga_handle handle, uint64_t wsid)
 
 	ret_res = afu_unpin_buffer(wrapped_handle, wsid);
 
-	res = wrapped_handle->adapter_table->fpgaReleaseBuffer(
+	res = OPAE_HANDLE_CALL(wrapped_handle, fpgaReleaseBuffer,
 		wrapped_handle->opae_handle, wsid);
 	ret_res = (ret_res == FPGA_OK ? res : ret_res);
 
@@ -1032,10 +1178,27 @@ fpga_result __OPAE_API__ fpgaGetIOAddress(fpga_handle handle, uint64_t wsid,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaGetIOAddress,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaGetIOAddress(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaGetIOAddress,
 		wrapped_handle->opae_handle, wsid, ioaddr);
 }
 
+fpga_result __OPAE_API__ fpgaGetBufferNumaNode(fpga_handle handle,
+					       uint64_t wsid,
+					       int *node)
+{
+	opae_wrapped_handle *wrapped_handle =
+		opae_validate_wrapped_handle(handle);
+
+	ASSERT_NOT_NULL(wrapped_handle);
+	ASSERT_NOT_NULL(node);
+	ASSERT_NOT_NULL_RESULT(
+		wrapped_handle->adapter_table->fpgaGetBufferNumaNode,
+		FPGA_NOT_SUPPORTED);
+
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaGetBufferNumaNode,
+		wrapped_handle->opae_handle, wsid, node);
+}
+
 fpga_result __OPAE_API__ fpgaBindSVA(fpga_handle handle, uint32_t *pasid)
 {
 	fpga_result res;
@@ -1047,7 +1210,7 @@ fpga_result __OPAE_API__ fpgaBindSVA(fpga_handle handle, uint32_t *pasid)
 	if (!wrapped_handle->adapter_table->fpgaBindSVA)
 		return FPGA_NOT_SUPPORTED;
 
-	res = wrapped_handle->adapter_table->fpgaBindSVA(
+	res = OPAE_HANDLE_CALL(wrapped_handle, fpgaBindSVA,
 		wrapped_handle->opae_handle, pasid);
 	if (res != FPGA_OK)
 		return res;
@@ -1057,7 +1220,7 @@ fpga_result __OPAE_API__ fpgaBindSVA(fpga_handle handle, uint32_t *pasid)
 		if (!wrapped_child->adapter_table->fpgaBindSVA)
 			return FPGA_NOT_SUPPORTED;
 
-		res = wrapped_child->adapter_table->fpgaBindSVA(
+		res = OPAE_HANDLE_CALL(wrapped_child, fpgaBindSVA,
 			wrapped_child->opae_handle, pasid);
 		if (res != FPGA_OK)
 			return res;
@@ -1116,7 +1279,7 @@ fpga_result __OPAE_API__ fpgaReadError(fpga_token token,
 	ASSERT_NOT_NULL_RESULT(wrapped_token->adapter_table->fpgaReadError,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_token->adapter_table->fpgaReadError(
+	return OPAE_ADAPTER_CALL(wrapped_token->adapter_table, fpgaReadError,
 		wrapped_token->opae_token, error_num, value);
 }
 
@@ -1128,7 +1291,7 @@ fpga_result __OPAE_API__ fpgaClearError(fpga_token token, uint32_t error_num)
 	ASSERT_NOT_NULL_RESULT(wrapped_token->adapter_table->fpgaClearError,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_token->adapter_table->fpgaClearError(
+	return OPAE_ADAPTER_CALL(wrapped_token->adapter_table, fpgaClearError,
 		wrapped_token->opae_token, error_num);
 }
 
@@ -1140,7 +1303,8 @@ fpga_result __OPAE_API__ fpgaClearAllErrors(fpga_token token)
 	ASSERT_NOT_NULL_RESULT(wrapped_token->adapter_table->fpgaClearAllErrors,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_token->adapter_table->fpgaClearAllErrors(
+	return OPAE_ADAPTER_CALL(
+		wrapped_token->adapter_table, fpgaClearAllErrors,
 		wrapped_token->opae_token);
 }
 
@@ -1154,7 +1318,7 @@ fpga_result __OPAE_API__ fpgaGetErrorInfo(fpga_token token, uint32_t error_num,
 	ASSERT_NOT_NULL_RESULT(wrapped_token->adapter_table->fpgaGetErrorInfo,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_token->adapter_table->fpgaGetErrorInfo(
+	return OPAE_ADAPTER_CALL(wrapped_token->adapter_table, fpgaGetErrorInfo,
 		wrapped_token->opae_token, error_num, error_info);
 }
 
@@ -1204,13 +1368,15 @@ fpga_result __OPAE_API__ fpgaDestroyEventHandle(fpga_event_handle *event_handle)
 			return FPGA_INVALID_PARAM;
 		}
 
-		res = wrapped_event_handle->adapter_table
-			      ->fpgaDestroyEventHandle(
-				      &wrapped_event_handle->opae_event_handle);
+		res = OPAE_ADAPTER_CALL(
+			wrapped_event_handle->adapter_table,
+			fpgaDestroyEventHandle,
+			&wrapped_event_handle->opae_event_handle);
 	}
 
 	opae_mutex_unlock(ires, &wrapped_event_handle->lock);
 
+	opae_wait_events_invalidate();
 	opae_destroy_wrapped_event_handle(wrapped_event_handle);
 
 	return res;
@@ -1250,9 +1416,9 @@ fpga_result __OPAE_API__ fpgaGetOSObjectFromEventHandle(
 		return FPGA_NOT_SUPPORTED;
 	}
 
-	res = wrapped_event_handle->adapter_table
-		      ->fpgaGetOSObjectFromEventHandle(
-			      wrapped_event_handle->opae_event_handle, fd);
+	res = OPAE_ADAPTER_CALL(wrapped_event_handle->adapter_table,
+				fpgaGetOSObjectFromEventHandle,
+				wrapped_event_handle->opae_event_handle, fd);
 
 	opae_mutex_unlock(ires, &wrapped_event_handle->lock);
 
@@ -1286,7 +1452,7 @@ fpga_result __OPAE_API__ fpgaRegisterEvent(fpga_handle handle,
 			return FPGA_NOT_SUPPORTED;
 		}
 
-		res = wrapped_handle->adapter_table->fpgaCreateEventHandle(
+		res = OPAE_HANDLE_CALL(wrapped_handle, fpgaCreateEventHandle,
 			&wrapped_event_handle->opae_event_handle);
 
 		if (res != FPGA_OK) {
@@ -1319,9 +1485,10 @@ fpga_result __OPAE_API__ fpgaRegisterEvent(fpga_handle handle,
 		return FPGA_NOT_SUPPORTED;
 	}
 
-	res = wrapped_event_handle->adapter_table->fpgaRegisterEvent(
-		wrapped_handle->opae_handle, event_type,
-		wrapped_event_handle->opae_event_handle, flags);
+	res = OPAE_STATS_CALL(wrapped_event_handle->adapter_table,
+			      wrapped_handle->stats, fpgaRegisterEvent,
+			      wrapped_handle->opae_handle, event_type,
+			      wrapped_event_handle->opae_event_handle, flags);
 
 	opae_mutex_unlock(ires, &wrapped_event_handle->lock);
 
@@ -1363,9 +1530,10 @@ fpga_result __OPAE_API__ fpgaUnregisterEvent(fpga_handle handle,
 		return FPGA_NOT_SUPPORTED;
 	}
 
-	res = wrapped_event_handle->adapter_table->fpgaUnregisterEvent(
-		wrapped_handle->opae_handle, event_type,
-		wrapped_event_handle->opae_event_handle);
+	res = OPAE_STATS_CALL(wrapped_event_handle->adapter_table,
+			      wrapped_handle->stats, fpgaUnregisterEvent,
+			      wrapped_handle->opae_handle, event_type,
+			      wrapped_event_handle->opae_event_handle);
 
 	opae_mutex_unlock(ires, &wrapped_event_handle->lock);
 
@@ -1383,7 +1551,7 @@ fpga_result __OPAE_API__ fpgaAssignPortToInterface(fpga_handle fpga,
 		wrapped_handle->adapter_table->fpgaAssignPortToInterface,
 		FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaAssignPortToInterface(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaAssignPortToInterface,
 		wrapped_handle->opae_handle, interface_num, slot_num, flags);
 }
 
@@ -1401,7 +1569,7 @@ fpga_result __OPAE_API__ fpgaAssignToInterface(fpga_handle fpga,
 		wrapped_handle->adapter_table->fpgaAssignToInterface,
 		FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaAssignToInterface(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaAssignToInterface,
 		wrapped_handle->opae_handle, wrapped_token->opae_token,
 		host_interface, flags);
 }
@@ -1420,7 +1588,7 @@ fpga_result __OPAE_API__ fpgaReleaseFromInterface(fpga_handle fpga,
 		wrapped_handle->adapter_table->fpgaReleaseFromInterface,
 		FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaReleaseFromInterface(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaReleaseFromInterface,
 		wrapped_handle->opae_handle, wrapped_token->opae_token);
 }
 
@@ -1437,7 +1605,7 @@ fpga_result __OPAE_API__ fpgaReconfigureSlot(fpga_handle fpga, uint32_t slot,
 		wrapped_handle->adapter_table->fpgaReconfigureSlot,
 		FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaReconfigureSlot(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaReconfigureSlot,
 		wrapped_handle->opae_handle, slot, bitstream, bitstream_len,
 		flags);
 }
@@ -1459,7 +1627,8 @@ fpga_result __OPAE_API__ fpgaTokenGetObject(fpga_token token, const char *name,
 	ASSERT_NOT_NULL_RESULT(wrapped_token->adapter_table->fpgaDestroyObject,
 			       FPGA_NOT_SUPPORTED);
 
-	res = wrapped_token->adapter_table->fpgaTokenGetObject(
+	res = OPAE_ADAPTER_CALL(
+		wrapped_token->adapter_table, fpgaTokenGetObject,
 		wrapped_token->opae_token, name, &obj, flags);
 
 	ASSERT_RESULT(res);
@@ -1497,7 +1666,7 @@ fpga_result __OPAE_API__ fpgaHandleGetObject(fpga_handle handle,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaDestroyObject,
 			       FPGA_NOT_SUPPORTED);
 
-	res = wrapped_handle->adapter_table->fpgaHandleGetObject(
+	res = OPAE_HANDLE_CALL(wrapped_handle, fpgaHandleGetObject,
 		wrapped_handle->opae_handle, name, &obj, flags);
 
 	ASSERT_RESULT(res);
@@ -1534,7 +1703,8 @@ fpga_result __OPAE_API__ fpgaObjectGetObjectAt(fpga_object parent,
 	ASSERT_NOT_NULL_RESULT(wrapped_object->adapter_table->fpgaDestroyObject,
 			       FPGA_NOT_SUPPORTED);
 
-	res = wrapped_object->adapter_table->fpgaObjectGetObjectAt(
+	res = OPAE_ADAPTER_CALL(
+		wrapped_object->adapter_table, fpgaObjectGetObjectAt,
 		wrapped_object->opae_object, index, &obj);
 
 	ASSERT_RESULT(res);
@@ -1573,7 +1743,8 @@ fpga_result __OPAE_API__ fpgaObjectGetObject(fpga_object parent,
 	ASSERT_NOT_NULL_RESULT(wrapped_object->adapter_table->fpgaDestroyObject,
 			       FPGA_NOT_SUPPORTED);
 
-	res = wrapped_object->adapter_table->fpgaObjectGetObject(
+	res = OPAE_ADAPTER_CALL(
+		wrapped_object->adapter_table, fpgaObjectGetObject,
 		wrapped_object->opae_object, name, &obj, flags);
 
 	ASSERT_RESULT(res);
@@ -1605,7 +1776,8 @@ fpga_result __OPAE_API__ fpgaDestroyObject(fpga_object *obj)
 	ASSERT_NOT_NULL_RESULT(wrapped_object->adapter_table->fpgaDestroyObject,
 			       FPGA_NOT_SUPPORTED);
 
-	res = wrapped_object->adapter_table->fpgaDestroyObject(
+	res = OPAE_ADAPTER_CALL(
+		wrapped_object->adapter_table, fpgaDestroyObject,
 		&wrapped_object->opae_object);
 
 	opae_destroy_wrapped_object(wrapped_object);
@@ -1623,7 +1795,7 @@ fpga_result __OPAE_API__ fpgaObjectRead(fpga_object obj, uint8_t *buffer,
 	ASSERT_NOT_NULL_RESULT(wrapped_object->adapter_table->fpgaObjectRead,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_object->adapter_table->fpgaObjectRead(
+	return OPAE_ADAPTER_CALL(wrapped_object->adapter_table, fpgaObjectRead,
 		wrapped_object->opae_object, buffer, offset, len, flags);
 }
 
@@ -1637,7 +1809,8 @@ fpga_result __OPAE_API__ fpgaObjectGetSize(fpga_object obj, uint64_t *value,
 	ASSERT_NOT_NULL_RESULT(wrapped_object->adapter_table->fpgaObjectGetSize,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_object->adapter_table->fpgaObjectGetSize(
+	return OPAE_ADAPTER_CALL(
+		wrapped_object->adapter_table, fpgaObjectGetSize,
 		wrapped_object->opae_object, value, flags);
 }
 
@@ -1651,7 +1824,8 @@ fpga_result __OPAE_API__ fpgaObjectGetType(fpga_object obj,
 	ASSERT_NOT_NULL_RESULT(wrapped_object->adapter_table->fpgaObjectGetType,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_object->adapter_table->fpgaObjectGetType(
+	return OPAE_ADAPTER_CALL(
+		wrapped_object->adapter_table, fpgaObjectGetType,
 		wrapped_object->opae_object, type);
 }
 
@@ -1665,10 +1839,77 @@ fpga_result __OPAE_API__ fpgaObjectRead64(fpga_object obj, uint64_t *value,
 	ASSERT_NOT_NULL_RESULT(wrapped_object->adapter_table->fpgaObjectRead64,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_object->adapter_table->fpgaObjectRead64(
+	return OPAE_ADAPTER_CALL(
+		wrapped_object->adapter_table, fpgaObjectRead64,
 		wrapped_object->opae_object, value, flags);
 }
 
+#define OBJECT_READ_MANY_CHUNK 64
+fpga_result __OPAE_API__ fpgaObjectReadMany(fpga_object *objs,
+					    uint64_t *values,
+					    size_t count,
+					    int flags)
+{
+	fpga_object plugin_objs[OBJECT_READ_MANY_CHUNK];
+	opae_api_adapter_table *adapter;
+	opae_wrapped_object *wrapped_object;
+	fpga_result res;
+	size_t i = 0;
+	size_t n;
+
+	if (!count)
+		return FPGA_OK;
+	ASSERT_NOT_NULL(objs);
+	ASSERT_NOT_NULL(values);
+
+	// Hand each run of objects that share a plugin to that plugin
+	// in one call.
+	while (i < count) {
+		wrapped_object = opae_validate_wrapped_object(objs[i]);
+		ASSERT_NOT_NULL(wrapped_object);
+		adapter = wrapped_object->adapter_table;
+
+		n = 0;
+		do {
+			plugin_objs[n++] = wrapped_object->opae_object;
+			if (i + n == count)
+				break;
+			wrapped_object =
+				opae_validate_wrapped_object(objs[i + n]);
+			ASSERT_NOT_NULL(wrapped_object);
+		} while (wrapped_object->adapter_table == adapter &&
+			 n < OBJECT_READ_MANY_CHUNK);
+
+		if (adapter->fpgaObjectReadMany) {
+			res = OPAE_ADAPTER_CALL(adapter, fpgaObjectReadMany,
+						plugin_objs, &values[i],
+						n, flags);
+			if (res != FPGA_OK)
+				return res;
+		} else {
+			size_t j;
+
+			// The plugin has no batch entry point:
+			// read each object on its own.
+			ASSERT_NOT_NULL_RESULT(adapter->fpgaObjectRead64,
+					       FPGA_NOT_SUPPORTED);
+			for (j = 0 ; j < n ; ++j) {
+				res = OPAE_ADAPTER_CALL(adapter,
+							fpgaObjectRead64,
+							plugin_objs[j],
+							&values[i + j],
+							flags);
+				if (res != FPGA_OK)
+					return res;
+			}
+		}
+
+		i += n;
+	}
+
+	return FPGA_OK;
+}
+
 fpga_result __OPAE_API__ fpgaObjectWrite64(fpga_object obj, uint64_t value,
 					   int flags)
 {
@@ -1678,7 +1919,8 @@ fpga_result __OPAE_API__ fpgaObjectWrite64(fpga_object obj, uint64_t value,
 	ASSERT_NOT_NULL_RESULT(wrapped_object->adapter_table->fpgaObjectWrite64,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_object->adapter_table->fpgaObjectWrite64(
+	return OPAE_ADAPTER_CALL(
+		wrapped_object->adapter_table, fpgaObjectWrite64,
 		wrapped_object->opae_object, value, flags);
 }
 
@@ -1692,7 +1934,7 @@ fpga_result __OPAE_API__ fpgaSetUserClock(fpga_handle handle,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaSetUserClock,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaSetUserClock(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaSetUserClock,
 		wrapped_handle->opae_handle, high_clk, low_clk, flags);
 }
 
@@ -1708,7 +1950,7 @@ fpga_result __OPAE_API__ fpgaGetUserClock(fpga_handle handle,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaGetUserClock,
 			       FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaGetUserClock(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaGetUserClock,
 		wrapped_handle->opae_handle, high_clk, low_clk, flags);
 }
 
@@ -1724,7 +1966,7 @@ fpga_result __OPAE_API__ fpgaGetNumMetrics(fpga_handle handle,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaGetNumMetrics,
 			     FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaGetNumMetrics(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaGetNumMetrics,
 		wrapped_handle->opae_handle, num_metrics);
 }
 
@@ -1741,7 +1983,7 @@ fpga_result __OPAE_API__ fpgaGetMetricsInfo(fpga_handle handle,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaGetMetricsInfo,
 			    FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaGetMetricsInfo(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaGetMetricsInfo,
 		wrapped_handle->opae_handle, metric_info, num_metrics);
 }
 
@@ -1760,7 +2002,7 @@ fpga_result __OPAE_API__ fpgaGetMetricsByIndex(fpga_handle handle,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaGetMetricsByIndex,
 			   FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaGetMetricsByIndex(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaGetMetricsByIndex,
 		wrapped_handle->opae_handle, metric_num, num_metric_indexes, metrics);
 }
 
@@ -1779,7 +2021,7 @@ fpga_result __OPAE_API__ fpgaGetMetricsByName(fpga_handle handle,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaGetMetricsByName,
 			   FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaGetMetricsByName(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaGetMetricsByName,
 		wrapped_handle->opae_handle, metrics_names, num_metric_names, metrics);
 }
 
@@ -1796,6 +2038,87 @@ fpga_result __OPAE_API__ fpgaGetMetricsThresholdInfo(fpga_handle handle,
 	ASSERT_NOT_NULL_RESULT(wrapped_handle->adapter_table->fpgaGetMetricsThresholdInfo,
 		FPGA_NOT_SUPPORTED);
 
-	return wrapped_handle->adapter_table->fpgaGetMetricsThresholdInfo(
+	return OPAE_HANDLE_CALL(wrapped_handle, fpgaGetMetricsThresholdInfo,
 		wrapped_handle->opae_handle, metric_thresholds, num_thresholds);
 }
+
+fpga_result __OPAE_API__ fpgaGetStats(fpga_handle handle,
+	fpga_api_stats *stats,
+	uint32_t max_stats,
+	uint32_t *num_stats)
+{
+	opae_wrapped_handle *wrapped_handle = NULL;
+	opae_api_counters c;
+	unsigned api;
+
+	ASSERT_NOT_NULL(num_stats);
+
+	if (handle) {
+		wrapped_handle = opae_validate_wrapped_handle(handle);
+		ASSERT_NOT_NULL(wrapped_handle);
+	}
+
+	if ((max_stats > 0) && !stats) {
+		OPAE_ERR("max_stats > 0 with NULL stats");
+		return FPGA_INVALID_PARAM;
+	}
+
+	if (!opae_stats_enabled)
+		return FPGA_NOT_SUPPORTED;
+
+	*num_stats = 0;
+
+	if (wrapped_handle && !wrapped_handle->stats)
+		return FPGA_OK;
+
+	for (api = 0 ; api < OPAE_STATS_API_MAX ; ++api) {
+		fpga_api_stats *s;
+
+		if (!opae_stats_sum(wrapped_handle ?
+				    wrapped_handle->stats : NULL,
+				    api, &c))
+			continue;
+
+		if (*num_stats < max_stats) {
+			s = &stats[*num_stats];
+			memset(s, 0, sizeof(*s));
+			strncpy(s->api, opae_stats_api_name(api),
+				sizeof(s->api) - 1);
+			s->calls = c.calls;
+			s->errors = c.errors;
+			s->total_ns = c.total_ns;
+			s->min_ns = c.min_ns;
+			s->max_ns = c.max_ns;
+			s->p50_ns = opae_stats_percentile(&c, 0.5);
+			s->p90_ns = opae_stats_percentile(&c, 0.9);
+			s->p99_ns = opae_stats_percentile(&c, 0.99);
+			s->p999_ns = opae_stats_percentile(&c, 0.999);
+		}
+
+		*num_stats += 1;
+	}
+
+	return FPGA_OK;
+}
+
+fpga_result __OPAE_API__ fpgaResetStats(fpga_handle handle)
+{
+	opae_wrapped_handle *wrapped_handle = NULL;
+
+	if (handle) {
+		wrapped_handle = opae_validate_wrapped_handle(handle);
+		ASSERT_NOT_NULL(wrapped_handle);
+	}
+
+	if (!opae_stats_enabled)
+		return FPGA_NOT_SUPPORTED;
+
+	if (wrapped_handle) {
+		if (wrapped_handle->stats)
+			opae_stats_reset(wrapped_handle->stats);
+	} else {
+		opae_stats_reset(NULL);
+	}
+
+	return FPGA_OK;
+}
@@ -0,0 +1,367 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+#define _GNU_SOURCE
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "async-log.h"
+
+#define ASYNC_LOG_MSG_MAX       512
+#define ASYNC_LOG_RING_SLOTS    64 // power of 2
+#define ASYNC_LOG_SITES         256 // power of 2
+#define ASYNC_LOG_IDLE_MIN_NSEC 1000000
+#define ASYNC_LOG_IDLE_MAX_NSEC 16000000
+
+typedef struct _async_log_record {
+	FILE *fp;
+	uint32_t len;
+	char text[ASYNC_LOG_MSG_MAX];
+} async_log_record;
+
+/*
+ * Single producer (the owning thread), single consumer (the drain
+ * thread). head and tail increase without wrapping; slot i is at
+ * records[i % ASYNC_LOG_RING_SLOTS].
+ */
+typedef struct _async_log_ring {
+	unsigned head;
+	unsigned tail;
+	bool orphaned; // the owning thread has exited
+	struct _async_log_ring *next;
+	async_log_record records[ASYNC_LOG_RING_SLOTS];
+} async_log_ring;
+
+// Per call site (format string) message count for the current second.
+typedef struct _async_log_site {
+	uintptr_t fmt;
+	uint64_t second;
+	unsigned count;
+} async_log_site;
+
+static struct {
+	bool running;
+	pthread_t thread;
+	char name[16];
+	uint32_t rate_limit;
+	pthread_key_t key;
+	pthread_mutex_t lock; // protects rings
+	async_log_ring *rings;
+	uint64_t dropped;
+	uint64_t rate_limited;
+	uint64_t dropped_reported;
+	uint64_t rate_limited_reported;
+	async_log_site sites[ASYNC_LOG_SITES];
+} async_log = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+// serializes start and stop
+static pthread_mutex_t async_log_ctl_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t async_log_once = PTHREAD_ONCE_INIT;
+static __thread async_log_ring *async_log_thread_ring;
+
+static uint64_t async_log_now_sec(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+	return (uint64_t)now.tv_sec;
+}
+
+static void async_log_orphan_ring(void *ring)
+{
+	__atomic_store_n(&((async_log_ring *)ring)->orphaned, true,
+			 __ATOMIC_RELEASE);
+}
+
+static void async_log_atfork_child(void)
+{
+	// The drain thread does not exist in the child.
+	__atomic_store_n(&async_log.running, false, __ATOMIC_SEQ_CST);
+}
+
+static void async_log_init_once(void)
+{
+	pthread_key_create(&async_log.key, async_log_orphan_ring);
+	pthread_atfork(NULL, NULL, async_log_atfork_child);
+}
+
+static async_log_ring *async_log_get_ring(void)
+{
+	async_log_ring *ring = async_log_thread_ring;
+
+	if (ring)
+		return ring;
+
+	ring = calloc(1, sizeof(async_log_ring));
+	if (!ring)
+		return NULL;
+
+	if (pthread_setspecific(async_log.key, ring)) {
+		free(ring);
+		return NULL;
+	}
+
+	pthread_mutex_lock(&async_log.lock);
+	ring->next = async_log.rings;
+	async_log.rings = ring;
+	pthread_mutex_unlock(&async_log.lock);
+
+	async_log_thread_ring = ring;
+	return ring;
+}
+
+static bool async_log_allow(const char *fmt)
+{
+	uintptr_t key = (uintptr_t)fmt;
+	async_log_site *site;
+	uint64_t now;
+
+	if (!async_log.rate_limit)
+		return true;
+
+	site = &async_log.sites[((key >> 3) ^ (key >> 11)) &
+				(ASYNC_LOG_SITES - 1)];
+	now = async_log_now_sec();
+
+	// Claim the site for this format, or start a new second. Races
+	// here only make the limit approximate.
+	if (__atomic_load_n(&site->fmt, __ATOMIC_RELAXED) != key ||
+	    __atomic_load_n(&site->second, __ATOMIC_RELAXED) != now) {
+		__atomic_store_n(&site->fmt, key, __ATOMIC_RELAXED);
+		__atomic_store_n(&site->second, now, __ATOMIC_RELAXED);
+		__atomic_store_n(&site->count, 1, __ATOMIC_RELAXED);
+		return true;
+	}
+
+	return __atomic_fetch_add(&site->count, 1, __ATOMIC_RELAXED) <
+		async_log.rate_limit;
+}
+
+int opae_async_log_vprint(FILE *fp, const char *fmt, va_list argp)
+{
+	async_log_ring *ring;
+	async_log_record *rec;
+	unsigned head;
+	unsigned tail;
+	int n;
+
+	if (!__atomic_load_n(&async_log.running, __ATOMIC_ACQUIRE))
+		return 1;
+
+	ring = async_log_get_ring();
+	if (!ring)
+		return 1;
+
+	if (!async_log_allow(fmt)) {
+		__atomic_fetch_add(&async_log.rate_limited, 1,
+				   __ATOMIC_RELAXED);
+		return 0;
+	}
+
+	head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+	tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	if (head - tail == ASYNC_LOG_RING_SLOTS) {
+		__atomic_fetch_add(&async_log.dropped, 1, __ATOMIC_RELAXED);
+		return 0;
+	}
+
+	rec = &ring->records[head & (ASYNC_LOG_RING_SLOTS - 1)];
+	n = vsnprintf(rec->text, sizeof(rec->text), fmt, argp);
+	if (n < 0)
+		n = 0;
+	if (n >= (int)sizeof(rec->text)) {
+		// truncated: keep the line ending
+		n = sizeof(rec->text) - 1;
+		rec->text[n - 1] = '\n';
+	}
+	rec->fp = fp;
+	rec->len = (uint32_t)n;
+
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+static size_t async_log_drain_ring(async_log_ring *ring)
+{
+	unsigned tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	unsigned head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	size_t count = head - tail;
+
+	while (tail != head) {
+		async_log_record *rec =
+			&ring->records[tail & (ASYNC_LOG_RING_SLOTS - 1)];
+
+		fwrite(rec->text, 1, rec->len, rec->fp);
+		++tail;
+		__atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+	}
+
+	return count;
+}
+
+static size_t async_log_drain_all(void)
+{
+	async_log_ring **pp;
+	size_t count = 0;
+
+	pthread_mutex_lock(&async_log.lock);
+
+	pp = &async_log.rings;
+	while (*pp) {
+		async_log_ring *ring = *pp;
+		bool orphaned = __atomic_load_n(&ring->orphaned,
+						__ATOMIC_ACQUIRE);
+
+		count += async_log_drain_ring(ring);
+
+		if (orphaned) {
+			// The owner exited before we drained: nothing
+			// more will be written to this ring.
+			*pp = ring->next;
+			free(ring);
+		} else {
+			pp = &ring->next;
+		}
+	}
+
+	pthread_mutex_unlock(&async_log.lock);
+
+	return count;
+}
+
+static void async_log_report_drops(void)
+{
+	uint64_t dropped = opae_async_log_dropped();
+	uint64_t rate_limited = opae_async_log_rate_limited();
+
+	if (dropped == async_log.dropped_reported &&
+	    rate_limited == async_log.rate_limited_reported)
+		return;
+
+	fprintf(stderr, "%s: %" PRIu64 " log messages dropped"
+		" (%" PRIu64 " ring full, %" PRIu64 " rate limited)\n",
+		async_log.name,
+		(dropped - async_log.dropped_reported) +
+		(rate_limited - async_log.rate_limited_reported),
+		dropped - async_log.dropped_reported,
+		rate_limited - async_log.rate_limited_reported);
+
+	async_log.dropped_reported = dropped;
+	async_log.rate_limited_reported = rate_limited;
+}
+
+static void *async_log_drain_thread(void *arg)
+{
+	struct timespec idle = { 0, ASYNC_LOG_IDLE_MIN_NSEC };
+	uint64_t reported = async_log_now_sec();
+	uint64_t now;
+
+	(void)arg;
+
+	while (__atomic_load_n(&async_log.running, __ATOMIC_ACQUIRE)) {
+		if (async_log_drain_all()) {
+			idle.tv_nsec = ASYNC_LOG_IDLE_MIN_NSEC;
+		} else {
+			nanosleep(&idle, NULL);
+			if (idle.tv_nsec < ASYNC_LOG_IDLE_MAX_NSEC)
+				idle.tv_nsec *= 2;
+		}
+
+		now = async_log_now_sec();
+		if (now != reported) {
+			async_log_report_drops();
+			reported = now;
+		}
+	}
+
+	return NULL;
+}
+
+int opae_async_log_start(const char *name, uint32_t rate_limit)
+{
+	int res = 0;
+
+	pthread_once(&async_log_once, async_log_init_once);
+
+	pthread_mutex_lock(&async_log_ctl_lock);
+
+	if (__atomic_load_n(&async_log.running, __ATOMIC_SEQ_CST))
+		goto out_unlock;
+
+	strncpy(async_log.name, name, sizeof(async_log.name) - 1);
+	async_log.rate_limit = rate_limit;
+
+	__atomic_store_n(&async_log.running, true, __ATOMIC_SEQ_CST);
+	res = pthread_create(&async_log.thread, NULL,
+			     async_log_drain_thread, NULL);
+	if (res) {
+		__atomic_store_n(&async_log.running, false, __ATOMIC_SEQ_CST);
+		goto out_unlock;
+	}
+
+	pthread_setname_np(async_log.thread, async_log.name);
+
+out_unlock:
+	pthread_mutex_unlock(&async_log_ctl_lock);
+	return res;
+}
+
+void opae_async_log_stop(void)
+{
+	pthread_mutex_lock(&async_log_ctl_lock);
+
+	if (__atomic_exchange_n(&async_log.running, false, __ATOMIC_SEQ_CST)) {
+		pthread_join(async_log.thread, NULL);
+		async_log_drain_all();
+		async_log_report_drops();
+		fflush(stdout);
+		fflush(stderr);
+	}
+
+	pthread_mutex_unlock(&async_log_ctl_lock);
+}
+
+bool opae_async_log_running(void)
+{
+	return __atomic_load_n(&async_log.running, __ATOMIC_SEQ_CST);
+}
+
+uint64_t opae_async_log_dropped(void)
+{
+	return __atomic_load_n(&async_log.dropped, __ATOMIC_SEQ_CST);
+}
+
+uint64_t opae_async_log_rate_limited(void)
+{
+	return __atomic_load_n(&async_log.rate_limited, __ATOMIC_SEQ_CST);
+}
@@ -0,0 +1,72 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifndef __OPAE_ASYNC_LOG_H__
+#define __OPAE_ASYNC_LOG_H__
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Asynchronous log backend shared by libopae-c (opae_print) and
+ * libofs (ofs_print). Each library compiles its own copy, so each
+ * has its own drain thread and counters.
+ *
+ * A logging thread formats its message into a ring owned by that
+ * thread and returns; no lock is taken and no stdio call is made.
+ * A background thread drains the rings of all threads to their
+ * FILE streams. A message is dropped, and counted, when its thread's
+ * ring is full or when its call site (format string) has already
+ * logged rate_limit messages in the current second.
+ */
+
+#define OPAE_ASYNC_LOG_DEFAULT_RATE 100
+
+#define ASYNC_LOG_API __attribute__((visibility("hidden")))
+
+// Start the drain thread. rate_limit is the maximum number of
+// messages per call site per second (0 means no limit).
+// Returns 0 on success.
+ASYNC_LOG_API int opae_async_log_start(const char *name, uint32_t rate_limit);
+
+// Drain every ring, then stop the drain thread.
+ASYNC_LOG_API void opae_async_log_stop(void);
+
+ASYNC_LOG_API bool opae_async_log_running(void);
+
+// Queue a message for fp. Returns 0 when the message was queued or
+// dropped, non-zero when the caller should print it itself (the
+// logger is not running, or this thread has no ring).
+ASYNC_LOG_API int opae_async_log_vprint(FILE *fp,
+					const char *fmt,
+					va_list argp);
+
+// The number of messages dropped because a ring was full, and
+// the number dropped by the per call site rate limit.
+ASYNC_LOG_API uint64_t opae_async_log_dropped(void);
+ASYNC_LOG_API uint64_t opae_async_log_rate_limited(void);
+
+#endif // __OPAE_ASYNC_LOG_H__
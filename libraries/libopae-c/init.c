@@ -45,6 +45,8 @@
 #include <opae/utils.h>
 #include "pluginmgr.h"
 #include "opae_int.h"
+#include "async-log.h"
+#include "stats.h"
 #include "mock/opae_std.h"
 
 /* global loglevel */
@@ -83,6 +85,11 @@ void opae_print(int loglevel, const char *fmt, ...)
 		fp = g_logfile == NULL ? stdout : g_logfile;
 
 	va_start(argp, fmt);
+	if (!opae_async_log_vprint(fp, fmt, argp)) {
+		/* queued for (or dropped by) the async log thread */
+		va_end(argp);
+		return;
+	}
 	err = pthread_mutex_lock(
 		&log_lock); /* ignore failure and print anyway */
 	if (err)
@@ -215,6 +222,36 @@ __attribute__((constructor(1000))) STATIC void opae_init(void)
 	if (g_logfile == NULL)
 		g_logfile = stdout;
 
+	s = getenv("LIBOPAE_LOG_ASYNC");
+	if (s && strcmp(s, "0")) {
+		uint32_t rate_limit = OPAE_ASYNC_LOG_DEFAULT_RATE;
+
+		s = getenv("LIBOPAE_LOG_RATE");
+		if (s)
+			rate_limit = (uint32_t)strtoul(s, NULL, 0);
+		if (opae_async_log_start("opae-log", rate_limit))
+			fprintf(stderr, "Could not start the async log "
+				"thread. Logging synchronously.\n");
+	}
+
+	/* LIBOPAE_STATS_FILE and LIBOPAE_STATS_SIGNAL imply LIBOPAE_STATS */
+	s = getenv("LIBOPAE_STATS");
+	if ((s && strcmp(s, "0")) ||
+	    getenv("LIBOPAE_STATS_FILE") ||
+	    getenv("LIBOPAE_STATS_SIGNAL")) {
+		int signum = 0;
+
+		s = getenv("LIBOPAE_STATS_SIGNAL");
+		if (s) {
+			signum = opae_stats_parse_signal(s);
+			if (!signum)
+				fprintf(stderr, "Invalid LIBOPAE_STATS_SIGNAL: "
+					"%s\n", s);
+		}
+		if (opae_stats_start(getenv("LIBOPAE_STATS_FILE"), signum))
+			fprintf(stderr, "Could not enable API statistics.\n");
+	}
+
 	with_ase = getenv("WITH_ASE");
 	if (with_ase) {
 		cfg_path = find_ase_cfg();
@@ -231,9 +268,11 @@ __attribute__((constructor(1000))) STATIC void opae_init(void)
 		opae_free(cfg_path);
 	}
 	// If the environment hasn't requested explicit initialization,
-	// perform the initialization implicitly here.
+	// initialize implicitly. Platform detection and plugin loading
+	// are deferred to the first API call that needs an adapter, so
+	// that merely linking libopae-c costs nothing at load time.
 	else if (getenv("OPAE_EXPLICIT_INITIALIZE") == NULL)
-		fpgaInitialize(NULL);
+		opae_plugin_mgr_defer_initialize();
 }
 
 __attribute__((destructor)) STATIC void opae_release(void)
@@ -246,6 +285,9 @@ __attribute__((destructor)) STATIC void opae_release(void)
 	if (res != FPGA_OK)
 		OPAE_ERR("fpgaFinalize: %s", fpgaErrStr(res));
 
+	opae_stats_stop();
+	opae_async_log_stop();
+
 	if (g_logfile != NULL && g_logfile != stdout) {
 		opae_fclose(g_logfile);
 	}
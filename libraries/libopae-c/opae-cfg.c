@@ -32,6 +32,8 @@
 #include <opae/log.h>
 #include "mock/opae_std.h"
 #include "cfg-file.h"
+#include "async-log.h"
+#include "stats.h"
 
 typedef struct _libopae_parse_context {
 	libopae_config_data *cfg;
@@ -338,6 +340,54 @@ out_free:
 	return res;
 }
 
+// Optional top-level logging settings:
+// "logging": { "async": true, "rate_limit": 100 }
+STATIC void parse_logging_config(json_object *root)
+{
+	json_object *j_logging = NULL;
+	json_object *j_rate_limit = NULL;
+	bool async = false;
+	uint32_t rate_limit = OPAE_ASYNC_LOG_DEFAULT_RATE;
+
+	if (!json_object_object_get_ex(root, "logging", &j_logging))
+		return;
+
+	if (!parse_json_boolean(j_logging, "async", &async) || !async)
+		return;
+
+	if (json_object_object_get_ex(j_logging, "rate_limit", &j_rate_limit))
+		rate_limit = (uint32_t)json_object_get_int(j_rate_limit);
+
+	if (opae_async_log_start("opae-log", rate_limit))
+		OPAE_MSG("failed to start the async log thread");
+}
+
+STATIC void parse_stats_config(json_object *root)
+{
+	json_object *j_stats = NULL;
+	bool enabled = false;
+	char *file = NULL;
+	char *sig = NULL;
+	int signum = 0;
+
+	if (!json_object_object_get_ex(root, "stats", &j_stats))
+		return;
+
+	if (!parse_json_boolean(j_stats, "enabled", &enabled) || !enabled)
+		return;
+
+	parse_json_string(j_stats, "file", &file);
+
+	if (parse_json_string(j_stats, "signal", &sig)) {
+		signum = opae_stats_parse_signal(sig);
+		if (!signum)
+			OPAE_ERR("invalid stats signal: %s", sig);
+	}
+
+	if (opae_stats_start(file, signum))
+		OPAE_MSG("failed to enable API statistics");
+}
+
 libopae_config_data *
 opae_parse_libopae_json(const char *cfgfile, const char *json_input)
 {
@@ -357,6 +407,9 @@ opae_parse_libopae_json(const char *cfgfile, const char *json_input)
 		goto out_free;
 	}
 
+	parse_logging_config(root);
+	parse_stats_config(root);
+
 	j_configs = parse_json_array(root, "configs", &num_configs);
 	if (!j_configs) {
 		OPAE_ERR("Failed to find \"configs\" in \"%s\".",
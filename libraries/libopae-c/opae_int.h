@@ -154,6 +154,8 @@ typedef struct _opae_wrapped_handle {
 	// Linked list of children, starting at the parent. The list order
 	// matches the order of the parent's child AFU GUID parameter.
 	struct _opae_wrapped_handle *child_next;
+	// Call statistics of the handle. NULL unless enabled.
+	struct _opae_stats *stats;
 } opae_wrapped_handle;
 
 opae_wrapped_handle *
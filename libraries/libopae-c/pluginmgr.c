@@ -38,10 +38,12 @@
 #include <linux/limits.h>
 #include <pthread.h>
 #include <pwd.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 #include "pluginmgr.h"
 #include "opae_int.h"
+#include "stats.h"
 #include "mock/opae_std.h"
 #include "cfg-file.h"
 
@@ -52,6 +54,7 @@ static libopae_config_data *platform_data_table;
 
 int initialized;
 STATIC int finalizing;
+STATIC int initialize_deferred;
 
 STATIC opae_api_adapter_table *adapter_list = (void *)0;
 static pthread_mutex_t adapter_list_lock =
@@ -110,6 +113,7 @@ STATIC opae_api_adapter_table *opae_plugin_mgr_alloc_adapter(const char *lib_pat
 	}
 
 	adapter->plugin.dl_handle = dl_handle;
+	adapter->stats = opae_stats_plugin(lib_path);
 
 	return adapter;
 }
@@ -206,6 +210,7 @@ int opae_plugin_mgr_finalize_all(void)
 	}
 
 	adapter_list = NULL;
+	initialize_deferred = 0;
 
 	if (platform_data_table) {
 		for (cfg = platform_data_table ; cfg->module_library ; ++cfg) {
@@ -287,13 +292,131 @@ STATIC void opae_plugin_mgr_detect_platform(opae_pci_device *dev)
 	}
 }
 
+#define PCI_CFG_VENDOR_ID           0x00
+#define PCI_CFG_DEVICE_ID           0x02
+#define PCI_CFG_HEADER_TYPE         0x0e
+#define PCI_CFG_SUBSYSTEM_VENDOR_ID 0x2c
+#define PCI_CFG_SUBSYSTEM_ID        0x2e
+#define PCI_CFG_HEADER_SIZE         0x30
+
+STATIC int opae_plugin_mgr_read_pci_attr(int dir_fd,
+					 const char *name,
+					 const char *attr,
+					 uint16_t *value)
+{
+	char path[PATH_MAX];
+	char buf[32];
+	ssize_t len;
+	int fd;
+
+	if (snprintf(path, sizeof(path), "%s/%s", name, attr) < 0) {
+		OPAE_ERR("snprintf buffer overflow");
+		return 1;
+	}
+
+	fd = openat(dir_fd, path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		OPAE_ERR("Failed to open %s. Aborting platform detection.", path);
+		return 1;
+	}
+
+	len = pread(fd, buf, sizeof(buf) - 1, 0);
+	close(fd);
+
+	if (len <= 0) {
+		OPAE_ERR("Failed to read %s. Aborting platform detection.", path);
+		return 1;
+	}
+
+	buf[len] = '\0';
+	*value = (uint16_t)strtoul(buf, NULL, 16);
+
+	return 0;
+}
+
+/*
+ * Read the vendor, device and subsystem IDs of the PCI function
+ * dir_fd/name with a single read of its config space header, which
+ * sysfs makes readable to all users. Functions whose header does not
+ * carry the IDs (bridges, and SR-IOV VFs whose vendor ID reads as
+ * all ones) fall back to the individual sysfs attributes.
+ */
+STATIC int opae_plugin_mgr_read_pci_ids(int dir_fd,
+					const char *name,
+					opae_pci_device *dev)
+{
+	char path[PATH_MAX];
+	uint8_t cfg[PCI_CFG_HEADER_SIZE];
+	ssize_t len = -1;
+	int fd;
+
+	if (snprintf(path, sizeof(path), "%s/config", name) < 0) {
+		OPAE_ERR("snprintf buffer overflow");
+		return 1;
+	}
+
+	fd = openat(dir_fd, path, O_RDONLY | O_CLOEXEC);
+	if (fd >= 0) {
+		len = pread(fd, cfg, sizeof(cfg), 0);
+		close(fd);
+	}
+
+#define CFG16(__off) ((uint16_t)(cfg[__off] | (cfg[(__off) + 1] << 8)))
+	if ((len == (ssize_t)sizeof(cfg)) &&
+	    (CFG16(PCI_CFG_VENDOR_ID) != 0xffff) &&
+	    !(cfg[PCI_CFG_HEADER_TYPE] & 0x7f)) {
+		dev->vendor_id = CFG16(PCI_CFG_VENDOR_ID);
+		dev->device_id = CFG16(PCI_CFG_DEVICE_ID);
+		dev->subsystem_vendor_id = CFG16(PCI_CFG_SUBSYSTEM_VENDOR_ID);
+		dev->subsystem_device_id = CFG16(PCI_CFG_SUBSYSTEM_ID);
+		return 0;
+	}
+#undef CFG16
+
+	if (opae_plugin_mgr_read_pci_attr(dir_fd, name, "vendor",
+					  &dev->vendor_id) ||
+	    opae_plugin_mgr_read_pci_attr(dir_fd, name, "device",
+					  &dev->device_id) ||
+	    opae_plugin_mgr_read_pci_attr(dir_fd, name, "subsystem_vendor",
+					  &dev->subsystem_vendor_id) ||
+	    opae_plugin_mgr_read_pci_attr(dir_fd, name, "subsystem_device",
+					  &dev->subsystem_device_id))
+		return 1;
+
+	return 0;
+}
+
 STATIC int opae_plugin_mgr_detect_platforms(bool with_ase)
 {
 	DIR *dir;
-	char base_dir[PATH_MAX];
-	char file_path[PATH_MAX];
+	const char *base_dir = "/sys/bus/pci/devices";
 	struct dirent *dirent;
+	int dir_fd;
 	int errors = 0;
+	opae_pci_device soft_devices[] = {
+		{
+			.name = "opae_sim",
+			.vendor_id = 0x8086,
+			.device_id = 0x0a5d,
+			.subsystem_vendor_id = 0x8086,
+			.subsystem_device_id = 0x0a5d
+		},
+		{
+			.name = "opae_remote",
+			.vendor_id = 0x8086,
+			.device_id = 0x0a5c,
+			.subsystem_vendor_id = 0x8086,
+			.subsystem_device_id = 0x0a5c
+		}
+	};
+	size_t i;
+
+	// The emulated devices of libopae-sim and the devices reached
+	// through libopae-remote have no local PCIe function to find.
+	// Always report their IDs, so that each plugin is loaded exactly
+	// when an enabled opae.cfg configuration names them.
+	for (i = 0 ; i < sizeof(soft_devices) / sizeof(soft_devices[0]) ; ++i)
+		opae_plugin_mgr_detect_platform(&soft_devices[i]);
 
 	if (with_ase) {
 		opae_pci_device ase_pf = {
@@ -318,10 +441,10 @@ STATIC int opae_plugin_mgr_detect_platforms(bool with_ase)
 
 	// Iterate over the directories in /sys/bus/pci/devices.
 	// This directory contains symbolic links to device directories
-	// where 'vendor', 'device', 'subsystem_vendor', and
-	// 'subsystem_device' files exist.
-
-	memcpy(base_dir, "/sys/bus/pci/devices", 21);
+	// whose 'config' file (or 'vendor', 'device', 'subsystem_vendor',
+	// and 'subsystem_device' files) give the IDs. All reads are made
+	// relative to the directory fd, so that each device costs one
+	// openat()/pread() rather than a path walk per attribute.
 
 	dir = opae_opendir(base_dir);
 	if (!dir) {
@@ -329,128 +452,21 @@ STATIC int opae_plugin_mgr_detect_platforms(bool with_ase)
 		return 1;
 	}
 
+	dir_fd = dirfd(dir);
+
 	while ((dirent = readdir(dir)) != NULL) {
-		FILE *fp;
 		opae_pci_device dev = { NULL, 0, 0, 0, 0 };
-		unsigned vendor_id = 0;
-		unsigned device_id = 0;
-		unsigned subsystem_vendor_id = 0;
-		unsigned subsystem_device_id = 0;
 
 		if (!strcmp(dirent->d_name, ".") ||
 		    !strcmp(dirent->d_name, ".."))
 			continue;
 
-		// Read the 'vendor' file.
-		if (snprintf(file_path, sizeof(file_path),
-			     "%s/%s/vendor",
-			     base_dir,
-			     dirent->d_name) < 0) {
-			OPAE_ERR("snprintf buffer overflow");
-			++errors;
-			goto out_close;
-		}
-
-		fp = opae_fopen(file_path, "r");
-		if (!fp) {
-			OPAE_ERR("Failed to open %s. Aborting platform detection.", file_path);
-			++errors;
-			goto out_close;
-		}
-
-		if (EOF == fscanf(fp, "%x", &vendor_id)) {
-			OPAE_ERR("Failed to read %s. Aborting platform detection.", file_path);
-			opae_fclose(fp);
-			++errors;
-			goto out_close;
-		}
-
-		opae_fclose(fp);
-
-		// Read the 'device' file.
-		if (snprintf(file_path, sizeof(file_path),
-			     "%s/%s/device",
-			     base_dir,
-			     dirent->d_name) < 0) {
-			OPAE_ERR("snprintf buffer overflow");
-			++errors;
-			goto out_close;
-		}
-
-		fp = opae_fopen(file_path, "r");
-		if (!fp) {
-			OPAE_ERR("Failed to open %s. Aborting platform detection.", file_path);
-			++errors;
-			goto out_close;
-		}
-
-		if (EOF == fscanf(fp, "%x", &device_id)) {
-			OPAE_ERR("Failed to read %s. Aborting platform detection.", file_path);
-			opae_fclose(fp);
-			++errors;
-			goto out_close;
-		}
-
-		opae_fclose(fp);
-
-		// Read the 'subsystem_vendor' file.
-		if (snprintf(file_path, sizeof(file_path),
-			     "%s/%s/subsystem_vendor",
-			     base_dir,
-			     dirent->d_name) < 0) {
-			OPAE_ERR("snprintf buffer overflow");
-			++errors;
-			goto out_close;
-		}
-
-		fp = opae_fopen(file_path, "r");
-		if (!fp) {
-			OPAE_ERR("Failed to open %s. Aborting platform detection.", file_path);
-			++errors;
-			goto out_close;
-		}
-
-		if (EOF == fscanf(fp, "%x", &subsystem_vendor_id)) {
-			OPAE_ERR("Failed to read %s. Aborting platform detection.", file_path);
-			opae_fclose(fp);
+		if (opae_plugin_mgr_read_pci_ids(dir_fd, dirent->d_name, &dev)) {
 			++errors;
 			goto out_close;
 		}
 
-		opae_fclose(fp);
-
-		// Read the 'subsystem_device' file.
-		if (snprintf(file_path, sizeof(file_path),
-			     "%s/%s/subsystem_device",
-			     base_dir,
-			     dirent->d_name) < 0) {
-			OPAE_ERR("snprintf buffer overflow");
-			++errors;
-			goto out_close;
-		}
-
-		fp = opae_fopen(file_path, "r");
-		if (!fp) {
-			OPAE_ERR("Failed to open %s. Aborting platform detection.", file_path);
-			++errors;
-			goto out_close;
-		}
-
-		if (EOF == fscanf(fp, "%x", &subsystem_device_id)) {
-			OPAE_ERR("Failed to read %s. Aborting platform detection.", file_path);
-			opae_fclose(fp);
-			++errors;
-			goto out_close;
-		}
-
-		opae_fclose(fp);
-
 		// Detect platform for this opae_pci_device.
-		dev.vendor_id = (uint16_t)vendor_id;
-		dev.device_id = (uint16_t)device_id;
-		dev.subsystem_vendor_id = (uint16_t)subsystem_vendor_id;
-		dev.subsystem_device_id = (uint16_t)subsystem_device_id;
-
 		opae_plugin_mgr_detect_platform(&dev);
 	}
 
@@ -539,6 +555,8 @@ int opae_plugin_mgr_initialize(const char *cfg_file)
 
 	opae_mutex_lock(res, &adapter_list_lock);
 
+	initialize_deferred = 0;
+
 	if (initialized) { // prevent multiple init.
 		opae_mutex_unlock(res, &adapter_list_lock);
 		return 0;
@@ -592,6 +610,16 @@ out_unlock:
 	return errors;
 }
 
+void opae_plugin_mgr_defer_initialize(void)
+{
+	int res;
+
+	opae_mutex_lock(res, &adapter_list_lock);
+	if (!initialized)
+		initialize_deferred = 1;
+	opae_mutex_unlock(res, &adapter_list_lock);
+}
+
 int opae_plugin_mgr_for_each_adapter
 	(int (*callback)(const opae_api_adapter_table *, void *), void *context)
 {
@@ -606,6 +634,9 @@ int opae_plugin_mgr_for_each_adapter
 
 	opae_mutex_lock(res, &adapter_list_lock);
 
+	if (initialize_deferred)
+		opae_plugin_mgr_initialize(NULL);
+
 	for (aptr = adapter_list; aptr; aptr = aptr->next) {
 		cb_res = callback(aptr, context);
 		switch (cb_res) {
@@ -32,6 +32,10 @@
 // non-zero on failure.
 int opae_plugin_mgr_initialize(const char *cfg_file);
 
+// Arrange for opae_plugin_mgr_initialize(NULL) to run on the first
+// call to opae_plugin_mgr_for_each_adapter(), rather than now.
+void opae_plugin_mgr_defer_initialize(void);
+
 // non-zero on failure.
 int opae_plugin_mgr_finalize_all(void);
 
@@ -0,0 +1,827 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <linux/limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <opae/log.h>
+#include "stats.h"
+#include "opae_int.h"
+#include "mock/opae_std.h"
+
+bool opae_stats_enabled;
+
+#define OPAE_STATS_API_NAME(__name) #__name,
+static const char * const opae_stats_api_names[OPAE_STATS_API_MAX] = {
+	OPAE_STATS_API_LIST(OPAE_STATS_API_NAME)
+};
+#undef OPAE_STATS_API_NAME
+
+static struct {
+	pthread_mutex_t lock; // protects everything but next_shard
+	opae_stats *plugins;
+	opae_stats *handles;
+	uint32_t next_handle_id;
+	uint32_t next_shard;
+	char *dump_file;
+	char default_file[PATH_MAX]; // for signals when dump_file is NULL
+	int signum;
+	struct sigaction old_action;
+	int pipe[2];
+	pthread_t thread;
+	bool thread_started;
+} opae_stats_state = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.pipe = { -1, -1 },
+};
+
+static __thread int opae_stats_thread_shard = -1;
+
+const char *opae_stats_api_name(enum opae_stats_api api)
+{
+	return api < OPAE_STATS_API_MAX ? opae_stats_api_names[api] : "?";
+}
+
+unsigned opae_stats_bucket(uint64_t ns)
+{
+	unsigned msb;
+
+	if (ns < OPAE_STATS_SUB_BUCKETS)
+		return (unsigned)ns;
+
+	msb = 63 - __builtin_clzll(ns);
+	if (msb >= OPAE_STATS_MAX_BITS)
+		return OPAE_STATS_BUCKETS - 1;
+
+	return (msb - OPAE_STATS_SUB_BITS + 1) * OPAE_STATS_SUB_BUCKETS +
+	       (unsigned)((ns >> (msb - OPAE_STATS_SUB_BITS)) &
+			  (OPAE_STATS_SUB_BUCKETS - 1));
+}
+
+uint64_t opae_stats_bucket_min(unsigned bucket)
+{
+	unsigned msb;
+
+	if (bucket < OPAE_STATS_SUB_BUCKETS)
+		return bucket;
+
+	msb = bucket / OPAE_STATS_SUB_BUCKETS + OPAE_STATS_SUB_BITS - 1;
+	return (uint64_t)(OPAE_STATS_SUB_BUCKETS +
+			  bucket % OPAE_STATS_SUB_BUCKETS) <<
+	       (msb - OPAE_STATS_SUB_BITS);
+}
+
+uint64_t opae_stats_percentile(const opae_api_counters *c, double q)
+{
+	uint64_t target;
+	uint64_t seen = 0;
+	unsigned b;
+
+	if (!c->calls)
+		return 0;
+
+	target = (uint64_t)(q * (double)c->calls + 0.5);
+	if (target < 1)
+		target = 1;
+
+	for (b = 0 ; b < OPAE_STATS_BUCKETS - 1 ; ++b) {
+		seen += c->hist[b];
+		if (seen >= target) {
+			// Report the top of the bucket, within what was seen.
+			uint64_t v = opae_stats_bucket_min(b + 1) - 1;
+
+			if (v > c->max_ns)
+				v = c->max_ns;
+			if (v < c->min_ns)
+				v = c->min_ns;
+			return v;
+		}
+	}
+
+	return c->max_ns;
+}
+
+static inline unsigned opae_stats_shard(void)
+{
+	if (opae_stats_thread_shard < 0)
+		opae_stats_thread_shard = (int)
+			(__atomic_fetch_add(&opae_stats_state.next_shard, 1,
+					    __ATOMIC_RELAXED) &
+			 (OPAE_STATS_SHARDS - 1));
+	return (unsigned)opae_stats_thread_shard;
+}
+
+STATIC opae_api_counters *opae_stats_counters(opae_stats *s, unsigned shard,
+					      enum opae_stats_api api)
+{
+	opae_api_counters **slot = &s->counters[shard][api];
+	opae_api_counters *expected = NULL;
+	opae_api_counters *c;
+
+	c = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+	if (c)
+		return c;
+
+	c = opae_calloc(1, sizeof(opae_api_counters));
+	if (!c)
+		return NULL;
+	c->min_ns = UINT64_MAX;
+
+	// Another thread of the same shard may have won the race.
+	if (!__atomic_compare_exchange_n(slot, &expected, c, false,
+					 __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+		opae_free(c);
+		c = expected;
+	}
+
+	return c;
+}
+
+STATIC void opae_stats_add(opae_stats *s, unsigned shard,
+			   enum opae_stats_api api, fpga_result res,
+			   uint64_t ns, unsigned bucket)
+{
+	opae_api_counters *c = opae_stats_counters(s, shard, api);
+	uint64_t old;
+
+	if (!c)
+		return;
+
+	__atomic_fetch_add(&c->calls, 1, __ATOMIC_RELAXED);
+	if (res != FPGA_OK)
+		__atomic_fetch_add(&c->errors, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&c->total_ns, ns, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&c->hist[bucket], 1, __ATOMIC_RELAXED);
+
+	old = __atomic_load_n(&c->min_ns, __ATOMIC_RELAXED);
+	while (ns < old &&
+	       !__atomic_compare_exchange_n(&c->min_ns, &old, ns, true,
+					    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+
+	old = __atomic_load_n(&c->max_ns, __ATOMIC_RELAXED);
+	while (ns > old &&
+	       !__atomic_compare_exchange_n(&c->max_ns, &old, ns, true,
+					    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+void opae_stats_record(opae_stats *plugin, opae_stats *handle,
+		       enum opae_stats_api api,
+		       fpga_result res, uint64_t start_ns)
+{
+	uint64_t ns = opae_stats_now() - start_ns;
+	unsigned shard = opae_stats_shard();
+	unsigned bucket = opae_stats_bucket(ns);
+
+	if (plugin)
+		opae_stats_add(plugin, shard, api, res, ns, bucket);
+	if (handle)
+		opae_stats_add(handle, shard, api, res, ns, bucket);
+}
+
+STATIC void opae_stats_sum_scope(const opae_stats *s,
+				 enum opae_stats_api api,
+				 opae_api_counters *out)
+{
+	unsigned shard;
+	unsigned b;
+
+	for (shard = 0 ; shard < OPAE_STATS_SHARDS ; ++shard) {
+		const opae_api_counters *c =
+			__atomic_load_n(&s->counters[shard][api],
+					__ATOMIC_ACQUIRE);
+		uint64_t v;
+
+		if (!c)
+			continue;
+
+		out->calls += __atomic_load_n(&c->calls, __ATOMIC_RELAXED);
+		out->errors += __atomic_load_n(&c->errors, __ATOMIC_RELAXED);
+		out->total_ns += __atomic_load_n(&c->total_ns,
+						 __ATOMIC_RELAXED);
+
+		v = __atomic_load_n(&c->min_ns, __ATOMIC_RELAXED);
+		if (v < out->min_ns)
+			out->min_ns = v;
+		v = __atomic_load_n(&c->max_ns, __ATOMIC_RELAXED);
+		if (v > out->max_ns)
+			out->max_ns = v;
+
+		for (b = 0 ; b < OPAE_STATS_BUCKETS ; ++b)
+			out->hist[b] += __atomic_load_n(&c->hist[b],
+							__ATOMIC_RELAXED);
+	}
+}
+
+bool opae_stats_sum(const opae_stats *s,
+		    enum opae_stats_api api,
+		    opae_api_counters *out)
+{
+	int err;
+
+	memset(out, 0, sizeof(*out));
+	out->min_ns = UINT64_MAX;
+
+	if (s) {
+		opae_stats_sum_scope(s, api, out);
+	} else {
+		opae_mutex_lock(err, &opae_stats_state.lock);
+		for (s = opae_stats_state.plugins ; s ; s = s->next)
+			opae_stats_sum_scope(s, api, out);
+		opae_mutex_unlock(err, &opae_stats_state.lock);
+	}
+
+	if (!out->calls) {
+		out->min_ns = 0;
+		return false;
+	}
+
+	return true;
+}
+
+STATIC void opae_stats_reset_scope(opae_stats *s)
+{
+	unsigned shard;
+	unsigned api;
+	unsigned b;
+
+	for (shard = 0 ; shard < OPAE_STATS_SHARDS ; ++shard) {
+		for (api = 0 ; api < OPAE_STATS_API_MAX ; ++api) {
+			opae_api_counters *c =
+				__atomic_load_n(&s->counters[shard][api],
+						__ATOMIC_ACQUIRE);
+
+			if (!c)
+				continue;
+
+			__atomic_store_n(&c->calls, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&c->errors, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&c->total_ns, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&c->min_ns, UINT64_MAX,
+					 __ATOMIC_RELAXED);
+			__atomic_store_n(&c->max_ns, 0, __ATOMIC_RELAXED);
+			for (b = 0 ; b < OPAE_STATS_BUCKETS ; ++b)
+				__atomic_store_n(&c->hist[b], 0,
+						 __ATOMIC_RELAXED);
+		}
+	}
+}
+
+void opae_stats_reset(opae_stats *s)
+{
+	int err;
+
+	if (s) {
+		opae_stats_reset_scope(s);
+		return;
+	}
+
+	opae_mutex_lock(err, &opae_stats_state.lock);
+
+	for (s = opae_stats_state.plugins ; s ; s = s->next)
+		opae_stats_reset_scope(s);
+	for (s = opae_stats_state.handles ; s ; s = s->next)
+		opae_stats_reset_scope(s);
+
+	opae_mutex_unlock(err, &opae_stats_state.lock);
+}
+
+STATIC opae_stats *opae_stats_alloc(const char *name, const char *plugin)
+{
+	opae_stats *s = opae_calloc(1, sizeof(opae_stats));
+
+	if (!s) {
+		OPAE_ERR("out of memory");
+		return NULL;
+	}
+
+	s->name = opae_strdup(name);
+	s->plugin = plugin ? opae_strdup(plugin) : NULL;
+	if (!s->name || (plugin && !s->plugin)) {
+		OPAE_ERR("out of memory");
+		opae_free(s->name);
+		opae_free(s->plugin);
+		opae_free(s);
+		return NULL;
+	}
+
+	return s;
+}
+
+STATIC void opae_stats_free(opae_stats *s)
+{
+	unsigned shard;
+	unsigned api;
+
+	for (shard = 0 ; shard < OPAE_STATS_SHARDS ; ++shard)
+		for (api = 0 ; api < OPAE_STATS_API_MAX ; ++api)
+			opae_free(s->counters[shard][api]);
+
+	opae_free(s->name);
+	opae_free(s->plugin);
+	opae_free(s);
+}
+
+opae_stats *opae_stats_plugin(const char *name)
+{
+	opae_stats *s;
+	int err;
+
+	if (!opae_stats_enabled)
+		return NULL;
+
+	opae_mutex_lock(err, &opae_stats_state.lock);
+
+	for (s = opae_stats_state.plugins ; s ; s = s->next) {
+		if (!strcmp(s->name, name))
+			goto out_unlock;
+	}
+
+	s = opae_stats_alloc(name, NULL);
+	if (s) {
+		s->next = opae_stats_state.plugins;
+		opae_stats_state.plugins = s;
+	}
+
+out_unlock:
+	opae_mutex_unlock(err, &opae_stats_state.lock);
+	return s;
+}
+
+opae_stats *opae_stats_handle(opae_stats *plugin,
+			      const fpga_token_header *token_hdr)
+{
+	opae_stats *s;
+	opae_stats **tail;
+	char device[32];
+	int err;
+
+	if (!opae_stats_enabled)
+		return NULL;
+
+	snprintf(device, sizeof(device), "%04x:%02x:%02x.%d",
+		 token_hdr->segment, token_hdr->bus,
+		 token_hdr->device, token_hdr->function);
+
+	s = opae_stats_alloc(device, plugin ? plugin->name : NULL);
+	if (!s)
+		return NULL;
+	s->open = true;
+
+	opae_mutex_lock(err, &opae_stats_state.lock);
+
+	s->id = ++opae_stats_state.next_handle_id;
+	for (tail = &opae_stats_state.handles ; *tail ; tail = &(*tail)->next)
+		;
+	*tail = s;
+
+	opae_mutex_unlock(err, &opae_stats_state.lock);
+	return s;
+}
+
+void opae_stats_handle_closed(opae_stats *handle)
+{
+	opae_stats **prev;
+	opae_stats **oldest = NULL;
+	opae_stats *s;
+	unsigned closed = 0;
+	int err;
+
+	if (!handle)
+		return;
+
+	opae_mutex_lock(err, &opae_stats_state.lock);
+
+	handle->open = false;
+
+	// Bound the memory held by programs that open and close often.
+	for (prev = &opae_stats_state.handles ; *prev ; prev = &(*prev)->next) {
+		if ((*prev)->open)
+			continue;
+		if (!oldest)
+			oldest = prev;
+		++closed;
+	}
+
+	if (closed > OPAE_STATS_MAX_CLOSED) {
+		s = *oldest;
+		*oldest = s->next;
+		opae_stats_free(s);
+	}
+
+	opae_mutex_unlock(err, &opae_stats_state.lock);
+}
+
+STATIC void opae_stats_dump_string(FILE *fp, const char *s)
+{
+	fputc('"', fp);
+	for ( ; *s ; ++s) {
+		if (*s == '"' || *s == '\\')
+			fprintf(fp, "\\%c", *s);
+		else if ((unsigned char)*s < 0x20)
+			fprintf(fp, "\\u%04x", (unsigned char)*s);
+		else
+			fputc(*s, fp);
+	}
+	fputc('"', fp);
+}
+
+STATIC void opae_stats_dump_apis(FILE *fp, const opae_stats *s)
+{
+	opae_api_counters c;
+	const char *sep = "";
+	unsigned api;
+	unsigned b;
+
+	fprintf(fp, "      \"apis\": [");
+
+	for (api = 0 ; api < OPAE_STATS_API_MAX ; ++api) {
+		const char *hsep = "";
+
+		if (!opae_stats_sum(s, api, &c))
+			continue;
+
+		fprintf(fp, "%s\n        { \"api\": \"%s\", "
+			"\"calls\": %" PRIu64 ", \"errors\": %" PRIu64 ", "
+			"\"total_ns\": %" PRIu64 ", "
+			"\"min_ns\": %" PRIu64 ", \"max_ns\": %" PRIu64 ", "
+			"\"p50_ns\": %" PRIu64 ", \"p90_ns\": %" PRIu64 ", "
+			"\"p99_ns\": %" PRIu64 ", \"p999_ns\": %" PRIu64 ",\n"
+			"          \"histogram\": [",
+			sep, opae_stats_api_name(api),
+			c.calls, c.errors, c.total_ns, c.min_ns, c.max_ns,
+			opae_stats_percentile(&c, 0.50),
+			opae_stats_percentile(&c, 0.90),
+			opae_stats_percentile(&c, 0.99),
+			opae_stats_percentile(&c, 0.999));
+
+		// [lowest latency of the bucket, count] for non-empty ones.
+		for (b = 0 ; b < OPAE_STATS_BUCKETS ; ++b) {
+			if (!c.hist[b])
+				continue;
+			fprintf(fp, "%s[%" PRIu64 ", %" PRIu64 "]", hsep,
+				opae_stats_bucket_min(b), c.hist[b]);
+			hsep = ", ";
+		}
+
+		fprintf(fp, "] }");
+		sep = ",";
+	}
+
+	fprintf(fp, "%s]\n", *sep ? "\n      " : "");
+}
+
+STATIC void opae_stats_expand_path(const char *path, char *out, size_t len)
+{
+	size_t n = 0;
+
+	for ( ; *path && n + 1 < len ; ++path) {
+		if (path[0] == '%' && path[1] == 'p') {
+			int w = snprintf(out + n, len - n, "%d", (int)getpid());
+
+			if (w < 0 || (size_t)w >= len - n)
+				break;
+			n += w;
+			++path;
+		} else {
+			out[n++] = *path;
+		}
+	}
+
+	out[n] = '\0';
+}
+
+int opae_stats_dump(const char *path)
+{
+	char file[PATH_MAX];
+	char tmp[PATH_MAX + 8];
+	const char *sep;
+	opae_stats *s;
+	FILE *fp;
+	int fd;
+	int err;
+	int res = 0;
+
+	opae_stats_expand_path(path, file, sizeof(file));
+	snprintf(tmp, sizeof(tmp), "%s.XXXXXX", file);
+
+	// Write a temporary file beside the target and rename it over
+	// the target, so that a reader never sees a partial dump.
+	// mkstemp() creates a new file of mode 0600 with O_EXCL, so
+	// nothing planted at a predictable name, such as a symlink,
+	// is opened or followed. rename() replaces a link, not its
+	// target.
+	fd = mkstemp(tmp);
+	if (fd < 0) {
+		OPAE_ERR("failed to create %s: %s", tmp, strerror(errno));
+		return 1;
+	}
+
+	fp = fdopen(fd, "w");
+	if (!fp) {
+		OPAE_ERR("fdopen() failed: %s", strerror(errno));
+		close(fd);
+		unlink(tmp);
+		return 1;
+	}
+
+	opae_mutex_lock(err, &opae_stats_state.lock);
+
+	fprintf(fp, "{\n  \"pid\": %d,\n  \"plugins\": [", (int)getpid());
+	sep = "";
+	for (s = opae_stats_state.plugins ; s ; s = s->next) {
+		fprintf(fp, "%s\n    {\n      \"name\": ", sep);
+		opae_stats_dump_string(fp, s->name);
+		fprintf(fp, ",\n");
+		opae_stats_dump_apis(fp, s);
+		fprintf(fp, "    }");
+		sep = ",";
+	}
+	fprintf(fp, "%s],\n  \"handles\": [", *sep ? "\n  " : "");
+
+	sep = "";
+	for (s = opae_stats_state.handles ; s ; s = s->next) {
+		fprintf(fp, "%s\n    {\n      \"id\": %u,\n      \"device\": ",
+			sep, s->id);
+		opae_stats_dump_string(fp, s->name);
+		fprintf(fp, ",\n      \"plugin\": ");
+		opae_stats_dump_string(fp, s->plugin ? s->plugin : "");
+		fprintf(fp, ",\n      \"open\": %s,\n",
+			s->open ? "true" : "false");
+		opae_stats_dump_apis(fp, s);
+		fprintf(fp, "    }");
+		sep = ",";
+	}
+	fprintf(fp, "%s]\n}\n", *sep ? "\n  " : "");
+
+	opae_mutex_unlock(err, &opae_stats_state.lock);
+
+	if (ferror(fp))
+		res = 1;
+	if (opae_fclose(fp))
+		res = 1;
+
+	if (!res && rename(tmp, file)) {
+		OPAE_ERR("failed to rename %s: %s", tmp, strerror(errno));
+		res = 1;
+	}
+
+	if (res)
+		unlink(tmp);
+
+	return res;
+}
+
+int opae_stats_parse_signal(const char *s)
+{
+	static const struct {
+		const char *name;
+		int signum;
+	} signals[] = {
+		{ "USR1", SIGUSR1 },
+		{ "USR2", SIGUSR2 },
+		{ "HUP",  SIGHUP  },
+		{ "QUIT", SIGQUIT },
+		{ "PROF", SIGPROF },
+	};
+	char *endptr = NULL;
+	long n;
+	size_t i;
+
+	if (!s || !*s)
+		return 0;
+
+	n = strtol(s, &endptr, 0);
+	if (*endptr == '\0')
+		return (n > 0 && n < NSIG) ? (int)n : 0;
+
+	if (!strncasecmp(s, "SIG", 3))
+		s += 3;
+
+	for (i = 0 ; i < sizeof(signals) / sizeof(signals[0]) ; ++i) {
+		if (!strcasecmp(s, signals[i].name))
+			return signals[i].signum;
+	}
+
+	return 0;
+}
+
+static void opae_stats_signal_handler(int signum)
+{
+	int saved_errno = errno;
+	char c = 'd';
+
+	(void)signum;
+	if (write(opae_stats_state.pipe[1], &c, 1) < 0) {
+		// Nothing can be done here.
+	}
+	errno = saved_errno;
+}
+
+// Dumps on behalf of the signal handler, which cannot.
+static void *opae_stats_signal_thread(void *arg)
+{
+	char c;
+	ssize_t n;
+
+	(void)arg;
+
+	// Returns 0 when opae_stats_stop() closes the write end.
+	while ((n = read(opae_stats_state.pipe[0], &c, 1)) != 0) {
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		opae_stats_dump(opae_stats_state.dump_file ?
+				opae_stats_state.dump_file :
+				opae_stats_state.default_file);
+	}
+
+	return NULL;
+}
+
+STATIC int opae_stats_start_signal(int signum)
+{
+	struct sigaction action;
+	sigset_t all;
+	sigset_t saved;
+	int res;
+
+	if (pipe2(opae_stats_state.pipe, O_CLOEXEC)) {
+		OPAE_ERR("pipe2() failed: %s", strerror(errno));
+		return 1;
+	}
+
+	// The thread inherits a mask that blocks every signal, so that
+	// it never runs the application's handlers.
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &saved);
+	res = pthread_create(&opae_stats_state.thread, NULL,
+			     opae_stats_signal_thread, NULL);
+	pthread_sigmask(SIG_SETMASK, &saved, NULL);
+
+	if (res) {
+		OPAE_ERR("pthread_create() failed: %s", strerror(res));
+		goto out_close;
+	}
+	pthread_setname_np(opae_stats_state.thread, "opae-stats");
+	opae_stats_state.thread_started = true;
+
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = opae_stats_signal_handler;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+
+	if (sigaction(signum, &action, &opae_stats_state.old_action)) {
+		OPAE_ERR("sigaction() failed: %s", strerror(errno));
+		close(opae_stats_state.pipe[1]);
+		opae_stats_state.pipe[1] = -1;
+		pthread_join(opae_stats_state.thread, NULL);
+		opae_stats_state.thread_started = false;
+		goto out_close;
+	}
+
+	opae_stats_state.signum = signum;
+	return 0;
+
+out_close:
+	if (opae_stats_state.pipe[1] >= 0)
+		close(opae_stats_state.pipe[1]);
+	close(opae_stats_state.pipe[0]);
+	opae_stats_state.pipe[0] = opae_stats_state.pipe[1] = -1;
+	return 1;
+}
+
+int opae_stats_default_file(char *path, size_t len)
+{
+	const char *dir = getenv("XDG_RUNTIME_DIR");
+	int n;
+
+	// A predictable name in a shared directory is only offered to
+	// unprivileged users; root must choose the file.
+	if (dir && *dir)
+		n = snprintf(path, len, "%s/%s", dir, OPAE_STATS_DEFAULT_NAME);
+	else if (geteuid())
+		n = snprintf(path, len, "/tmp/%s", OPAE_STATS_DEFAULT_NAME);
+	else
+		return 1;
+
+	return (n < 0 || (size_t)n >= len) ? 1 : 0;
+}
+
+int opae_stats_start(const char *dump_file, int signum)
+{
+	int res = 0;
+	int err;
+
+	opae_mutex_lock(err, &opae_stats_state.lock);
+
+	// Settings made first (the environment) win.
+	if (dump_file && !opae_stats_state.dump_file) {
+		opae_stats_state.dump_file = opae_strdup(dump_file);
+		if (!opae_stats_state.dump_file) {
+			OPAE_ERR("out of memory");
+			res = 1;
+		}
+	}
+
+	if (!res && signum && !opae_stats_state.signum) {
+		if (!opae_stats_state.dump_file &&
+		    opae_stats_default_file(opae_stats_state.default_file,
+					    sizeof(opae_stats_state.default_file))) {
+			OPAE_ERR("as root, signal dumps need a statistics file "
+				 "(LIBOPAE_STATS_FILE or XDG_RUNTIME_DIR)");
+			res = 1;
+		} else {
+			res = opae_stats_start_signal(signum);
+		}
+	}
+
+	if (!res)
+		opae_stats_enabled = true;
+
+	opae_mutex_unlock(err, &opae_stats_state.lock);
+	return res;
+}
+
+void opae_stats_stop(void)
+{
+	opae_stats *s;
+	int err;
+
+	if (opae_stats_state.signum) {
+		sigaction(opae_stats_state.signum,
+			  &opae_stats_state.old_action, NULL);
+		opae_stats_state.signum = 0;
+	}
+
+	if (opae_stats_state.thread_started) {
+		close(opae_stats_state.pipe[1]);
+		pthread_join(opae_stats_state.thread, NULL);
+		close(opae_stats_state.pipe[0]);
+		opae_stats_state.pipe[0] = opae_stats_state.pipe[1] = -1;
+		opae_stats_state.thread_started = false;
+	}
+
+	if (opae_stats_enabled && opae_stats_state.dump_file)
+		opae_stats_dump(opae_stats_state.dump_file);
+
+	opae_stats_enabled = false;
+
+	opae_mutex_lock(err, &opae_stats_state.lock);
+
+	while (opae_stats_state.plugins) {
+		s = opae_stats_state.plugins;
+		opae_stats_state.plugins = s->next;
+		opae_stats_free(s);
+	}
+
+	while (opae_stats_state.handles) {
+		s = opae_stats_state.handles;
+		opae_stats_state.handles = s->next;
+		opae_stats_free(s);
+	}
+
+	opae_stats_state.next_handle_id = 0;
+	opae_free(opae_stats_state.dump_file);
+	opae_stats_state.dump_file = NULL;
+
+	opae_mutex_unlock(err, &opae_stats_state.lock);
+}
@@ -0,0 +1,248 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifndef __OPAE_STATS_H__
+#define __OPAE_STATS_H__
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <opae/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/*
+ * Per API call statistics. api-shell.c routes each call into a plugin
+ * through OPAE_STATS_CALL(), which times it when statistics are on
+ * and records it against the plugin's adapter and, for calls made on
+ * a handle, against the handle as well.
+ *
+ * Each scope keeps a set of counters per shard, and each thread
+ * updates the shard it was assigned on first use, so that threads
+ * working on the same handle seldom share a cache line. Updates are
+ * relaxed atomic adds; no lock is taken on the call path. When
+ * statistics are off, OPAE_STATS_CALL() costs one predicted branch.
+ */
+
+#define OPAE_STATS_API_LIST(X)            \
+	X(fpgaOpen)                       \
+	X(fpgaClose)                      \
+	X(fpgaReset)                      \
+	X(fpgaGetPropertiesFromHandle)    \
+	X(fpgaGetProperties)              \
+	X(fpgaUpdateProperties)           \
+	X(fpgaWriteMMIO64)                \
+	X(fpgaReadMMIO64)                 \
+	X(fpgaWriteMMIO32)                \
+	X(fpgaReadMMIO32)                 \
+	X(fpgaWriteMMIO512)               \
+	X(fpgaReadMMIOBatch)              \
+	X(fpgaWriteMMIOBatch)             \
+	X(fpgaMapMMIO)                    \
+	X(fpgaUnmapMMIO)                  \
+	X(fpgaEnumerate)                  \
+	X(fpgaEnumerateRefresh)           \
+	X(fpgaCloneToken)                 \
+	X(fpgaDestroyToken)               \
+	X(fpgaPrepareBuffer)              \
+	X(fpgaReleaseBuffer)              \
+	X(fpgaGetIOAddress)               \
+	X(fpgaGetBufferNumaNode)          \
+	X(fpgaBindSVA)                    \
+	X(fpgaReadError)                  \
+	X(fpgaClearError)                 \
+	X(fpgaClearAllErrors)             \
+	X(fpgaGetErrorInfo)               \
+	X(fpgaCreateEventHandle)          \
+	X(fpgaDestroyEventHandle)         \
+	X(fpgaGetOSObjectFromEventHandle) \
+	X(fpgaRegisterEvent)              \
+	X(fpgaUnregisterEvent)            \
+	X(fpgaAssignPortToInterface)      \
+	X(fpgaAssignToInterface)          \
+	X(fpgaReleaseFromInterface)       \
+	X(fpgaReconfigureSlot)            \
+	X(fpgaTokenGetObject)             \
+	X(fpgaHandleGetObject)            \
+	X(fpgaObjectGetObject)            \
+	X(fpgaObjectGetObjectAt)          \
+	X(fpgaDestroyObject)              \
+	X(fpgaObjectRead)                 \
+	X(fpgaObjectRead64)               \
+	X(fpgaObjectReadMany)             \
+	X(fpgaObjectGetSize)              \
+	X(fpgaObjectGetType)              \
+	X(fpgaObjectWrite64)              \
+	X(fpgaSetUserClock)               \
+	X(fpgaGetUserClock)               \
+	X(fpgaGetNumMetrics)              \
+	X(fpgaGetMetricsInfo)             \
+	X(fpgaGetMetricsByIndex)          \
+	X(fpgaGetMetricsByName)           \
+	X(fpgaGetMetricsThresholdInfo)
+
+#define OPAE_STATS_API_ENUM(__name) OPAE_STATS_##__name,
+enum opae_stats_api {
+	OPAE_STATS_API_LIST(OPAE_STATS_API_ENUM)
+	OPAE_STATS_API_MAX
+};
+#undef OPAE_STATS_API_ENUM
+
+#define OPAE_STATS_SHARDS 16 // power of 2
+
+/*
+ * Latencies are binned HDR style: values below 8 ns get a bucket
+ * each, and every power of two above that is split into 8 buckets,
+ * so a bucket is never wider than 1/8 of its lower bound. Values of
+ * 2^40 ns (about 18 minutes) and above share the last bucket.
+ */
+#define OPAE_STATS_SUB_BITS 3
+#define OPAE_STATS_SUB_BUCKETS (1 << OPAE_STATS_SUB_BITS)
+#define OPAE_STATS_MAX_BITS 40
+#define OPAE_STATS_BUCKETS \
+	((OPAE_STATS_MAX_BITS - OPAE_STATS_SUB_BITS + 1) * OPAE_STATS_SUB_BUCKETS)
+
+typedef struct _opae_api_counters {
+	uint64_t calls;
+	uint64_t errors;
+	uint64_t total_ns;
+	uint64_t min_ns;
+	uint64_t max_ns;
+	uint64_t hist[OPAE_STATS_BUCKETS];
+} opae_api_counters;
+
+typedef struct _opae_stats {
+	char *name;    // The plugin's library, or the device of a handle.
+	char *plugin;  // Handles: the name of the plugin's scope.
+	uint32_t id;   // Handles: numbered in the order opened.
+	bool open;     // Handles: cleared by fpgaClose().
+	// Allocated on the first call of an API from a shard.
+	opae_api_counters *counters[OPAE_STATS_SHARDS][OPAE_STATS_API_MAX];
+	struct _opae_stats *next;
+} opae_stats;
+
+#define OPAE_STATS_API __attribute__((visibility("hidden")))
+
+extern OPAE_STATS_API bool opae_stats_enabled;
+
+static inline uint64_t opae_stats_now(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+OPAE_STATS_API void opae_stats_record(opae_stats *plugin, opae_stats *handle,
+				      enum opae_stats_api api,
+				      fpga_result res, uint64_t start_ns);
+
+/*
+ * Call __table->__fn(...) and return its result, recording the call
+ * against the plugin of __table and against __handle_stats (which
+ * may be NULL) when statistics are enabled.
+ */
+#define OPAE_STATS_CALL(__table, __handle_stats, __fn, ...)               \
+	(__builtin_expect(!opae_stats_enabled, 1) ?                       \
+	 (__table)->__fn(__VA_ARGS__) :                                   \
+	 ({                                                               \
+		uint64_t __start = opae_stats_now();                      \
+		fpga_result __res = (__table)->__fn(__VA_ARGS__);         \
+		opae_stats_record((__table)->stats, (__handle_stats),     \
+				  OPAE_STATS_##__fn, __res, __start);     \
+		__res;                                                    \
+	 }))
+
+// The bucket of a latency, and the lowest latency in a bucket.
+OPAE_STATS_API unsigned opae_stats_bucket(uint64_t ns);
+OPAE_STATS_API uint64_t opae_stats_bucket_min(unsigned bucket);
+
+OPAE_STATS_API const char *opae_stats_api_name(enum opae_stats_api api);
+
+// The latency below which a fraction q of the calls in c completed.
+OPAE_STATS_API uint64_t opae_stats_percentile(const opae_api_counters *c,
+					      double q);
+
+/*
+ * The file that signal dumps go to when no dump file is given:
+ * OPAE_STATS_DEFAULT_NAME in $XDG_RUNTIME_DIR, or else in /tmp.
+ * Root gets no default outside $XDG_RUNTIME_DIR. Returns 0 when
+ * path holds the file name.
+ */
+#define OPAE_STATS_DEFAULT_NAME "opae-stats-%p.json"
+OPAE_STATS_API int opae_stats_default_file(char *path, size_t len);
+
+/*
+ * Turn statistics on. When dump_file is not NULL, they are written
+ * to it at exit. When signum is not 0, they are also written each
+ * time the process receives that signal, to dump_file or else to
+ * the default file, which fails if there is none. A %p in the file
+ * name is replaced by the process ID. Returns 0 on success.
+ */
+OPAE_STATS_API int opae_stats_start(const char *dump_file, int signum);
+
+// Write the dump file if one was requested, then release everything.
+OPAE_STATS_API void opae_stats_stop(void);
+
+// Parse a signal given as a number, "SIGUSR2" or "usr2". 0 if invalid.
+OPAE_STATS_API int opae_stats_parse_signal(const char *s);
+
+/*
+ * The scope of a plugin, created on first use and kept across
+ * fpgaFinalize(), so that a plugin loaded again continues to count.
+ * NULL when statistics are off.
+ */
+OPAE_STATS_API opae_stats *opae_stats_plugin(const char *name);
+
+/*
+ * A new scope for a handle on the device described by token_hdr,
+ * opened through the plugin of scope plugin. It is kept after the
+ * handle is closed, so that it appears in the dump, until more than
+ * OPAE_STATS_MAX_CLOSED closed handles are kept.
+ */
+#define OPAE_STATS_MAX_CLOSED 64
+OPAE_STATS_API opae_stats *opae_stats_handle(opae_stats *plugin,
+					     const fpga_token_header *token_hdr);
+OPAE_STATS_API void opae_stats_handle_closed(opae_stats *handle);
+
+// Sum the shards of one API of s into *out; of all plugin scopes
+// when s is NULL. false if never called.
+OPAE_STATS_API bool opae_stats_sum(const opae_stats *s,
+				   enum opae_stats_api api,
+				   opae_api_counters *out);
+
+// Zero every counter of s; of every scope when s is NULL.
+OPAE_STATS_API void opae_stats_reset(opae_stats *s);
+
+// Write every scope to path as JSON. Returns 0 on success.
+OPAE_STATS_API int opae_stats_dump(const char *path);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __OPAE_STATS_H__
@@ -0,0 +1,321 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <time.h>
+
+#include <opae/event.h>
+#include "opae_int.h"
+#include "wait-events.h"
+#include "mock/opae_std.h"
+
+typedef struct _wait_events_set {
+	int epfd;
+	uint64_t generation;
+	uint32_t num_events;
+	uint32_t capacity;
+	fpga_event_handle *events;
+	int *fds;
+	struct epoll_event *ready;
+} wait_events_set;
+
+static uint64_t wait_events_generation;
+static pthread_once_t wait_events_once = PTHREAD_ONCE_INIT;
+static pthread_key_t wait_events_key;
+static __thread wait_events_set *wait_events_thread_set;
+
+void opae_wait_events_invalidate(void)
+{
+	__atomic_add_fetch(&wait_events_generation, 1, __ATOMIC_RELEASE);
+}
+
+static void wait_events_free_set(void *p)
+{
+	wait_events_set *set = (wait_events_set *)p;
+
+	if (set->epfd >= 0)
+		opae_close(set->epfd);
+	opae_free(set->events);
+	opae_free(set->fds);
+	opae_free(set->ready);
+	opae_free(set);
+}
+
+static void wait_events_init_once(void)
+{
+	pthread_key_create(&wait_events_key, wait_events_free_set);
+	// A child shares its parent's epoll sets; give it its own.
+	pthread_atfork(NULL, NULL, opae_wait_events_invalidate);
+}
+
+static wait_events_set *wait_events_get_set(void)
+{
+	wait_events_set *set = wait_events_thread_set;
+
+	if (set)
+		return set;
+
+	pthread_once(&wait_events_once, wait_events_init_once);
+
+	set = opae_calloc(1, sizeof(wait_events_set));
+	if (!set)
+		return NULL;
+	set->epfd = -1;
+
+	if (pthread_setspecific(wait_events_key, set)) {
+		opae_free(set);
+		return NULL;
+	}
+
+	wait_events_thread_set = set;
+	return set;
+}
+
+/*
+ * Make set watch exactly event_handles. When the array matches the
+ * one from the previous call, and no event handle has been destroyed
+ * since, the set is reused as is.
+ */
+static fpga_result wait_events_prepare(wait_events_set *set,
+				       const fpga_event_handle *event_handles,
+				       uint32_t num_events)
+{
+	uint64_t generation;
+	uint32_t i;
+
+	generation = __atomic_load_n(&wait_events_generation,
+				     __ATOMIC_ACQUIRE);
+
+	if ((set->epfd >= 0) &&
+	    (set->generation == generation) &&
+	    (set->num_events == num_events) &&
+	    !memcmp(set->events, event_handles,
+		    num_events * sizeof(fpga_event_handle)))
+		return FPGA_OK;
+
+	if (set->epfd >= 0) {
+		opae_close(set->epfd);
+		set->epfd = -1;
+	}
+	set->num_events = 0;
+
+	if (num_events > set->capacity) {
+		fpga_event_handle *events;
+		int *fds;
+		struct epoll_event *ready;
+
+		events = opae_malloc(num_events * sizeof(fpga_event_handle));
+		fds = opae_malloc(num_events * sizeof(int));
+		ready = opae_malloc(num_events * sizeof(struct epoll_event));
+		if (!events || !fds || !ready) {
+			OPAE_ERR("malloc failed");
+			opae_free(events);
+			opae_free(fds);
+			opae_free(ready);
+			return FPGA_NO_MEMORY;
+		}
+
+		opae_free(set->events);
+		opae_free(set->fds);
+		opae_free(set->ready);
+		set->events = events;
+		set->fds = fds;
+		set->ready = ready;
+		set->capacity = num_events;
+	}
+
+	set->epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (set->epfd < 0) {
+		OPAE_ERR("epoll_create1() failed: %s", strerror(errno));
+		return FPGA_EXCEPTION;
+	}
+
+	for (i = 0 ; i < num_events ; ++i) {
+		struct epoll_event ev;
+		int fd = -1;
+
+		if (fpgaGetOSObjectFromEventHandle(event_handles[i], &fd)) {
+			OPAE_ERR("event %u is not registered", i);
+			goto out_close;
+		}
+
+		memset(&ev, 0, sizeof(ev));
+		ev.events = EPOLLIN;
+		ev.data.u32 = i;
+
+		if (epoll_ctl(set->epfd, EPOLL_CTL_ADD, fd, &ev)) {
+			OPAE_ERR("epoll_ctl(ADD, %d) for event %u failed: %s",
+				 fd, i, strerror(errno));
+			goto out_close;
+		}
+
+		set->fds[i] = fd;
+	}
+
+	memcpy(set->events, event_handles,
+	       num_events * sizeof(fpga_event_handle));
+	set->num_events = num_events;
+	set->generation = generation;
+
+	return FPGA_OK;
+
+out_close:
+	opae_close(set->epfd);
+	set->epfd = -1;
+	return FPGA_INVALID_PARAM;
+}
+
+static fpga_result wait_events(const fpga_event_handle *event_handles,
+			       uint32_t num_events,
+			       int timeout,
+			       uint64_t *counts,
+			       uint32_t *num_ready)
+{
+	wait_events_set *set;
+	fpga_result res;
+	int i;
+	int n;
+
+	set = wait_events_get_set();
+	ASSERT_NOT_NULL_RESULT(set, FPGA_NO_MEMORY);
+
+	res = wait_events_prepare(set, event_handles, num_events);
+	if (res)
+		return res;
+
+	n = epoll_wait(set->epfd, set->ready, (int)num_events, timeout);
+	if (n < 0) {
+		if (errno == EINTR)
+			return FPGA_OK;
+		OPAE_ERR("epoll_wait() failed: %s", strerror(errno));
+		return FPGA_EXCEPTION;
+	}
+
+	for (i = 0 ; i < n ; ++i) {
+		uint32_t idx = set->ready[i].data.u32;
+		uint64_t count = 0;
+
+		// Not every OS object is an eventfd; treat a short
+		// read as a single event.
+		if (opae_read(set->fds[idx], &count, sizeof(count)) !=
+		    sizeof(count))
+			count = (errno == EAGAIN) ? 0 : 1;
+
+		counts[idx] = count;
+		if (count)
+			++*num_ready;
+	}
+
+	return FPGA_OK;
+}
+
+fpga_result __OPAE_API__ fpgaWaitEvents(const fpga_event_handle *event_handles,
+					uint32_t num_events,
+					int timeout,
+					uint64_t *counts,
+					uint32_t *num_ready)
+{
+	ASSERT_NOT_NULL(event_handles);
+	ASSERT_NOT_NULL(counts);
+	ASSERT_NOT_NULL(num_ready);
+
+	if (!num_events) {
+		OPAE_ERR("num_events must be > 0");
+		return FPGA_INVALID_PARAM;
+	}
+
+	memset(counts, 0, num_events * sizeof(uint64_t));
+	*num_ready = 0;
+
+	return wait_events(event_handles, num_events,
+			   timeout, counts, num_ready);
+}
+
+static inline void wait_events_cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#endif
+}
+
+static uint64_t wait_events_now_usec(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+fpga_result __OPAE_API__
+fpgaWaitEventsHybrid(const fpga_event_handle *event_handles,
+		     uint32_t num_events,
+		     int timeout,
+		     uint64_t *counts,
+		     uint32_t *num_ready,
+		     const volatile uint64_t *completion,
+		     uint64_t spin_usec)
+{
+	uint64_t deadline;
+	uint32_t spins = 0;
+
+	ASSERT_NOT_NULL(event_handles);
+	ASSERT_NOT_NULL(counts);
+	ASSERT_NOT_NULL(num_ready);
+	ASSERT_NOT_NULL(completion);
+
+	if (!num_events) {
+		OPAE_ERR("num_events must be > 0");
+		return FPGA_INVALID_PARAM;
+	}
+
+	memset(counts, 0, num_events * sizeof(uint64_t));
+	*num_ready = 0;
+
+	if (*completion)
+		return FPGA_OK;
+
+	if (spin_usec) {
+		deadline = wait_events_now_usec() + spin_usec;
+
+		// Read the clock only every 64 polls.
+		do {
+			wait_events_cpu_relax();
+			if (*completion)
+				return FPGA_OK;
+		} while ((++spins & 63) ||
+			 (wait_events_now_usec() < deadline));
+	}
+
+	return wait_events(event_handles, num_events,
+			   timeout, counts, num_ready);
+}
@@ -116,6 +116,16 @@ void handle::write_csr512(uint64_t offset, const void *value,
   ASSERT_FPGA_OK(fpgaWriteMMIO512(handle_, csr_space, offset, value));
 }
 
+void handle::read_csr_batch(std::vector<fpga_mmio_op> &ops) const {
+  ASSERT_FPGA_OK(fpgaReadMMIOBatch(handle_, ops.data(),
+                                   static_cast<uint32_t>(ops.size())));
+}
+
+void handle::write_csr_batch(const std::vector<fpga_mmio_op> &ops) {
+  ASSERT_FPGA_OK(fpgaWriteMMIOBatch(handle_, ops.data(),
+                                    static_cast<uint32_t>(ops.size())));
+}
+
 uint8_t *handle::mmio_ptr(uint64_t offset, uint32_t csr_space) const {
   uint8_t *base = nullptr;
 
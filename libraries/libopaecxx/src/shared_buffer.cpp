@@ -37,6 +37,11 @@ shared_buffer::~shared_buffer() { release(); }
 
 shared_buffer::ptr_t shared_buffer::allocate(handle::ptr_t handle, size_t len,
                                              bool read_only) {
+  return allocate(handle, len, read_only, 0);
+}
+
+shared_buffer::ptr_t shared_buffer::allocate(handle::ptr_t handle, size_t len,
+                                             bool read_only, int flags) {
   ptr_t p;
 
   if (!handle) {
@@ -51,7 +56,6 @@ shared_buffer::ptr_t shared_buffer::allocate(handle::ptr_t handle, size_t len,
   uint64_t io_address = 0;
   uint64_t wsid = 0;
 
-  int flags = 0;
   if (read_only) {
     flags |= FPGA_BUF_READ_ONLY;
   }
@@ -106,6 +110,15 @@ void shared_buffer::release() {
   }
 }
 
+int shared_buffer::numa_node() const {
+  int node = -1;
+  if (virt_ && handle_ &&
+      fpgaGetBufferNumaNode(handle_->c_type(), wsid_, &node) != FPGA_OK) {
+    node = -1;
+  }
+  return node;
+}
+
 void shared_buffer::fill(int c) { std::fill(virt_, virt_ + len_, c); }
 
 int shared_buffer::compare(shared_buffer::ptr_t other, size_t len) const {
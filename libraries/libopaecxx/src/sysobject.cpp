@@ -112,6 +112,19 @@ uint64_t sysobject::read64(int flags) const {
   return value;
 }
 
+std::vector<uint64_t> sysobject::read_many(
+    const std::vector<sysobject::ptr_t> &objs, int flags) {
+  std::vector<fpga_object> c_objs;
+  std::vector<uint64_t> values(objs.size());
+  c_objs.reserve(objs.size());
+  for (auto &o : objs) {
+    c_objs.push_back(o->sysobject_);
+  }
+  ASSERT_FPGA_OK(
+      fpgaObjectReadMany(c_objs.data(), values.data(), c_objs.size(), flags));
+  return values;
+}
+
 void sysobject::write64(uint64_t value, int flags) const {
   ASSERT_FPGA_OK(fpgaObjectWrite64(sysobject_, value, flags));
 }
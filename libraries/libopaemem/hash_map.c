@@ -52,6 +52,252 @@
 fprintf(stderr, "%s:%u:%s() **ERROR** [%s] : " format, \
 	__SHORT_FILE__, __LINE__, __func__, strerror(errno), ##__VA_ARGS__)
 
+#define OA_MIN_SIZE 8
+#define OA_MAX_SIZE (1u << 31)
+
+// Smallest power of two >= num_buckets, within [OA_MIN_SIZE, OA_MAX_SIZE].
+STATIC uint32_t opae_hash_map_oa_size(uint32_t num_buckets)
+{
+	uint32_t size = OA_MIN_SIZE;
+
+	while ((size < num_buckets) && (size < OA_MAX_SIZE))
+		size <<= 1;
+
+	return size;
+}
+
+static inline bool opae_hash_map_oa_u64(opae_hash_map *hm)
+{
+	return (hm->key_hash == opae_u64_key_hash) &&
+	       (hm->key_compare == opae_u64_key_compare);
+}
+
+static inline uint32_t opae_hash_map_oa_hash(opae_hash_map *hm, void *key)
+{
+	uint64_t h;
+
+	if (opae_hash_map_oa_u64(hm))
+		h = (uint64_t)key;
+	else
+		h = hm->key_hash(OPAE_HASH_MAP_HASH_RANGE,
+				 hm->hash_seed,
+				 key);
+
+	// 64-bit finalizer from MurmurHash3, so that pointer keys, whose
+	// low bits are mostly zero, spread across the table.
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+
+	return (uint32_t)h;
+}
+
+static inline bool opae_hash_map_oa_equal(opae_hash_map *hm,
+					  void *keya,
+					  void *keyb)
+{
+	if (opae_hash_map_oa_u64(hm))
+		return keya == keyb;
+	return !hm->key_compare(keya, keyb);
+}
+
+// Index of the slot holding key, or -1.
+STATIC int64_t opae_hash_map_oa_lookup(opae_hash_map *hm,
+				       void *key,
+				       uint32_t hash)
+{
+	uint32_t mask = hm->num_buckets - 1;
+	uint32_t i = hash & mask;
+	uint32_t dist = 1;
+
+	while (1) {
+		opae_hash_map_slot *slot = &hm->slots[i];
+
+		// Robin Hood invariant: once we pass a slot closer to its
+		// home than we are to ours, the key can't be further on.
+		if (slot->dist < dist)
+			return -1;
+
+		if ((slot->hash == hash) &&
+		    opae_hash_map_oa_equal(hm, key, slot->key))
+			return i;
+
+		i = (i + 1) & mask;
+		++dist;
+	}
+}
+
+STATIC void opae_hash_map_oa_place(opae_hash_map_slot *slots,
+				   uint32_t mask,
+				   opae_hash_map_slot entry)
+{
+	uint32_t i = entry.hash & mask;
+
+	entry.dist = 1;
+
+	while (slots[i].dist) {
+		if (slots[i].dist < entry.dist) {
+			opae_hash_map_slot tmp = slots[i];
+			slots[i] = entry;
+			entry = tmp;
+		}
+		i = (i + 1) & mask;
+		++entry.dist;
+	}
+
+	slots[i] = entry;
+}
+
+STATIC fpga_result opae_hash_map_oa_grow(opae_hash_map *hm)
+{
+	opae_hash_map_slot *slots;
+	uint32_t num_buckets;
+	uint32_t i;
+
+	if (hm->num_buckets >= OA_MAX_SIZE) {
+		ERR("hash map is full");
+		return FPGA_NO_MEMORY;
+	}
+
+	num_buckets = hm->num_buckets << 1;
+
+	slots = (opae_hash_map_slot *)
+		opae_calloc(num_buckets, sizeof(opae_hash_map_slot));
+	if (!slots) {
+		ERR("calloc() failed");
+		return FPGA_NO_MEMORY;
+	}
+
+	for (i = 0 ; i < hm->num_buckets ; ++i) {
+		if (hm->slots[i].dist)
+			opae_hash_map_oa_place(slots,
+					       num_buckets - 1,
+					       hm->slots[i]);
+	}
+
+	opae_free(hm->slots);
+	hm->slots = slots;
+	hm->num_buckets = num_buckets;
+
+	return FPGA_OK;
+}
+
+STATIC fpga_result opae_hash_map_oa_add(opae_hash_map *hm,
+					void *key,
+					void *value)
+{
+	opae_hash_map_slot entry;
+	fpga_result res;
+
+	entry.key = key;
+	entry.value = value;
+	entry.hash = opae_hash_map_oa_hash(hm, key);
+	entry.dist = 0;
+
+	// The user has guaranteed us a unique keyspace, so there
+	// is no existing key to look for.
+	if (!(hm->flags & OPAE_HASH_MAP_UNIQUE_KEYSPACE)) {
+		int64_t i = opae_hash_map_oa_lookup(hm, key, entry.hash);
+
+		if (i >= 0) {
+			// Key collision.
+			if (hm->value_cleanup)
+				hm->value_cleanup(hm->slots[i].value,
+						  hm->cleanup_context);
+			hm->slots[i].value = value; // Replace value only.
+			return FPGA_OK;
+		}
+	}
+
+	// Keep the load factor at or below 7/8.
+	if (((uint64_t)hm->num_items + 1) * 8 >
+	    (uint64_t)hm->num_buckets * 7) {
+		res = opae_hash_map_oa_grow(hm);
+		if (res)
+			return res;
+	}
+
+	opae_hash_map_oa_place(hm->slots, hm->num_buckets - 1, entry);
+	++hm->num_items;
+
+	return FPGA_OK;
+}
+
+STATIC fpga_result opae_hash_map_oa_find(opae_hash_map *hm,
+					 void *key,
+					 void **value)
+{
+	int64_t i;
+
+	i = opae_hash_map_oa_lookup(hm, key, opae_hash_map_oa_hash(hm, key));
+	if (i < 0)
+		return FPGA_NOT_FOUND;
+
+	if (value)
+		*value = hm->slots[i].value;
+
+	return FPGA_OK;
+}
+
+STATIC fpga_result opae_hash_map_oa_remove(opae_hash_map *hm,
+					   void *key)
+{
+	uint32_t mask = hm->num_buckets - 1;
+	opae_hash_map_slot removed;
+	uint32_t i;
+	uint32_t next;
+	int64_t found;
+
+	found = opae_hash_map_oa_lookup(hm, key,
+					opae_hash_map_oa_hash(hm, key));
+	if (found < 0)
+		return FPGA_NOT_FOUND;
+
+	i = (uint32_t)found;
+	removed = hm->slots[i];
+
+	// Backward-shift deletion: pull each displaced follower
+	// one slot closer to its home, leaving no tombstones.
+	next = (i + 1) & mask;
+	while (hm->slots[next].dist > 1) {
+		hm->slots[i] = hm->slots[next];
+		--hm->slots[i].dist;
+		i = next;
+		next = (next + 1) & mask;
+	}
+
+	memset(&hm->slots[i], 0, sizeof(opae_hash_map_slot));
+	--hm->num_items;
+
+	if (hm->key_cleanup)
+		hm->key_cleanup(removed.key, hm->cleanup_context);
+	if (hm->value_cleanup)
+		hm->value_cleanup(removed.value, hm->cleanup_context);
+
+	return FPGA_OK;
+}
+
+STATIC void opae_hash_map_oa_destroy(opae_hash_map *hm)
+{
+	uint32_t i;
+
+	for (i = 0 ; i < hm->num_buckets ; ++i) {
+		opae_hash_map_slot *slot = &hm->slots[i];
+
+		if (!slot->dist)
+			continue;
+
+		if (hm->key_cleanup)
+			hm->key_cleanup(slot->key, hm->cleanup_context);
+		if (hm->value_cleanup)
+			hm->value_cleanup(slot->value, hm->cleanup_context);
+	}
+
+	opae_free(hm->slots);
+}
+
 fpga_result opae_hash_map_init(opae_hash_map *hm,
 			       uint32_t num_buckets,
 			       uint32_t hash_seed,
@@ -70,12 +316,23 @@ fpga_result opae_hash_map_init(opae_hash_map *hm,
 
 	memset(hm, 0, sizeof(*hm));
 
-	hm->buckets = (opae_hash_map_item **)
-			opae_calloc(num_buckets,
-				    sizeof(opae_hash_map_item *));
-	if (!hm->buckets) {
-		ERR("calloc() failed");
-		return FPGA_NO_MEMORY;
+	if (flags & OPAE_HASH_MAP_OPEN_ADDRESSING) {
+		num_buckets = opae_hash_map_oa_size(num_buckets);
+		hm->slots = (opae_hash_map_slot *)
+				opae_calloc(num_buckets,
+					    sizeof(opae_hash_map_slot));
+		if (!hm->slots) {
+			ERR("calloc() failed");
+			return FPGA_NO_MEMORY;
+		}
+	} else {
+		hm->buckets = (opae_hash_map_item **)
+				opae_calloc(num_buckets,
+					    sizeof(opae_hash_map_item *));
+		if (!hm->buckets) {
+			ERR("calloc() failed");
+			return FPGA_NO_MEMORY;
+		}
 	}
 
 	hm->num_buckets = num_buckets;
@@ -117,6 +374,9 @@ fpga_result opae_hash_map_add(opae_hash_map *hm,
 		return FPGA_INVALID_PARAM;
 	}
 
+	if (hm->flags & OPAE_HASH_MAP_OPEN_ADDRESSING)
+		return opae_hash_map_oa_add(hm, key, value);
+
 	key_hash = hm->key_hash(hm->num_buckets,
 				hm->hash_seed,
 				key);
@@ -191,6 +451,9 @@ fpga_result opae_hash_map_find(opae_hash_map *hm,
 		return FPGA_INVALID_PARAM;
 	}
 
+	if (hm->flags & OPAE_HASH_MAP_OPEN_ADDRESSING)
+		return opae_hash_map_oa_find(hm, key, value);
+
 	key_hash = hm->key_hash(hm->num_buckets,
 				hm->hash_seed,
 				key);
@@ -235,6 +498,9 @@ fpga_result opae_hash_map_remove(opae_hash_map *hm,
 		return FPGA_INVALID_PARAM;
 	}
 
+	if (hm->flags & OPAE_HASH_MAP_OPEN_ADDRESSING)
+		return opae_hash_map_oa_remove(hm, key);
+
 	key_hash = hm->key_hash(hm->num_buckets,
 				hm->hash_seed,
 				key);
@@ -292,6 +558,12 @@ fpga_result opae_hash_map_destroy(opae_hash_map *hm)
 		return FPGA_INVALID_PARAM;
 	}
 
+	if (hm->flags & OPAE_HASH_MAP_OPEN_ADDRESSING) {
+		opae_hash_map_oa_destroy(hm);
+		memset(hm, 0, sizeof(*hm));
+		return FPGA_OK;
+	}
+
 	for (i = 0 ; i < hm->num_buckets ; ++i) {
 		opae_hash_map_item *item;
 		item = hm->buckets[i];
@@ -317,6 +589,9 @@ bool opae_hash_map_is_empty(opae_hash_map *hm)
 {
 	uint32_t i;
 
+	if (hm->flags & OPAE_HASH_MAP_OPEN_ADDRESSING)
+		return !hm->num_items;
+
 	for (i = 0 ; i < hm->num_buckets ; ++i) {
 		if (hm->buckets[i])
 			return false;
@@ -29,6 +29,7 @@
 #endif // HAVE_CONFIG_H
 
 #include <stdio.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
@@ -55,284 +56,501 @@ fprintf(stderr, "%s:%u:%s() **ERROR** [%s] : " format, \
 
 #define ALIGNED(__addr, __size) ((__addr + __size - 1) & ~(__size - 1))
 
-void mem_alloc_init(struct mem_alloc *m)
+// Nodes are carved from blocks of this many.
+#define MEM_LINK_BLOCK_SIZE 128
+
+// Number of too-small best-fit candidates to try before falling back
+// to a block that is guaranteed to hold the aligned request.
+#define MEM_ALLOC_BEST_FIT_PROBES 16
+
+struct mem_link_block {
+	struct mem_link_block *next;
+	struct mem_link links[MEM_LINK_BLOCK_SIZE];
+};
+
+typedef int (*mem_tree_compare)(const struct mem_tree *a,
+				const struct mem_tree *b);
+
+#define link_of(__t, __member) \
+	((struct mem_link *)((char *)(__t) - offsetof(struct mem_link, __member)))
+
+STATIC int mem_tree_addr_compare(const struct mem_tree *a,
+				 const struct mem_tree *b)
 {
-	m->free.address = 0;
-	m->free.size = 0;
-	m->free.prev = &m->free;
-	m->free.next = &m->free;
-	m->allocated.address = 0;
-	m->allocated.size = 0;
-	m->allocated.prev = &m->allocated;
-	m->allocated.next = &m->allocated;
+	const struct mem_link *la = link_of(a, by_addr);
+	const struct mem_link *lb = link_of(b, by_addr);
+
+	if (la->address < lb->address)
+		return -1;
+	return la->address > lb->address ? 1 : 0;
 }
 
-void mem_alloc_destroy(struct mem_alloc *m)
+STATIC int mem_tree_size_compare(const struct mem_tree *a,
+				 const struct mem_tree *b)
 {
-	struct mem_link *p;
-	struct mem_link *trash;
+	const struct mem_link *la = link_of(a, by_size);
+	const struct mem_link *lb = link_of(b, by_size);
+
+	if (la->size != lb->size)
+		return la->size < lb->size ? -1 : 1;
+	if (la->address < lb->address)
+		return -1;
+	return la->address > lb->address ? 1 : 0;
+}
 
-	for (p = m->free.next ; p != &m->free ; ) {
-		trash = p;
-		p = p->next;
-		opae_free(trash);
+static inline int mem_tree_height(const struct mem_tree *t)
+{
+	return t ? t->height : 0;
+}
+
+static inline void mem_tree_update(struct mem_tree *t)
+{
+	int l = mem_tree_height(t->left);
+	int r = mem_tree_height(t->right);
+
+	t->height = 1 + (l > r ? l : r);
+}
+
+STATIC struct mem_tree *mem_tree_rotate_right(struct mem_tree *t)
+{
+	struct mem_tree *l = t->left;
+
+	t->left = l->right;
+	l->right = t;
+	mem_tree_update(t);
+	mem_tree_update(l);
+	return l;
+}
+
+STATIC struct mem_tree *mem_tree_rotate_left(struct mem_tree *t)
+{
+	struct mem_tree *r = t->right;
+
+	t->right = r->left;
+	r->left = t;
+	mem_tree_update(t);
+	mem_tree_update(r);
+	return r;
+}
+
+STATIC struct mem_tree *mem_tree_balance(struct mem_tree *t)
+{
+	int bf;
+
+	mem_tree_update(t);
+	bf = mem_tree_height(t->left) - mem_tree_height(t->right);
+
+	if (bf > 1) {
+		if (mem_tree_height(t->left->left) <
+		    mem_tree_height(t->left->right))
+			t->left = mem_tree_rotate_left(t->left);
+		return mem_tree_rotate_right(t);
 	}
 
-	for (p = m->allocated.next ; p != &m->allocated ; ) {
-		trash = p;
-		p = p->next;
-		opae_free(trash);
+	if (bf < -1) {
+		if (mem_tree_height(t->right->right) <
+		    mem_tree_height(t->right->left))
+			t->right = mem_tree_rotate_right(t->right);
+		return mem_tree_rotate_left(t);
 	}
 
-	mem_alloc_init(m);
+	return t;
 }
 
-STATIC struct mem_link *mem_link_alloc(uint64_t address, uint64_t size)
+STATIC struct mem_tree *mem_tree_insert(struct mem_tree *root,
+					struct mem_tree *n,
+					mem_tree_compare compare)
 {
-	struct mem_link *m;
-	m = opae_malloc(sizeof(struct mem_link));
-	if (m) {
-		m->address = address;
-		m->size = size;
-		m->prev = m;
-		m->next = m;
+	if (!root) {
+		n->left = NULL;
+		n->right = NULL;
+		n->height = 1;
+		return n;
 	}
-	return m;
+
+	if (compare(n, root) < 0)
+		root->left = mem_tree_insert(root->left, n, compare);
+	else
+		root->right = mem_tree_insert(root->right, n, compare);
+
+	return mem_tree_balance(root);
 }
 
-static inline void link_before(struct mem_link *a, struct mem_link *b)
+STATIC struct mem_tree *mem_tree_remove_min(struct mem_tree *t,
+					    struct mem_tree **min)
 {
-	a->prev = b->prev;
-	a->next = b;
-	b->prev = a;
-	a->prev->next = a;
+	if (!t->left) {
+		*min = t;
+		return t->right;
+	}
+
+	t->left = mem_tree_remove_min(t->left, min);
+	return mem_tree_balance(t);
 }
 
-static inline void link_after(struct mem_link *a, struct mem_link *b)
+STATIC struct mem_tree *mem_tree_remove(struct mem_tree *root,
+					struct mem_tree *n,
+					mem_tree_compare compare)
 {
-	a->next = b->next;
-	a->prev = b;
-	b->next->prev = a;
-	b->next = a;
+	int c;
+
+	if (!root)
+		return NULL;
+
+	c = compare(n, root);
+	if (c < 0) {
+		root->left = mem_tree_remove(root->left, n, compare);
+	} else if (c > 0) {
+		root->right = mem_tree_remove(root->right, n, compare);
+	} else {
+		struct mem_tree *l = root->left;
+		struct mem_tree *r = root->right;
+		struct mem_tree *min = NULL;
+
+		if (!r)
+			return l;
+
+		r = mem_tree_remove_min(r, &min);
+		min->left = l;
+		min->right = r;
+		return mem_tree_balance(min);
+	}
+
+	return mem_tree_balance(root);
 }
 
-static inline void link_unlink(struct mem_link *x)
+// The link whose address equals address, or NULL.
+STATIC struct mem_link *mem_tree_find(struct mem_tree *t, uint64_t address)
 {
-	x->next->prev = x->prev;
-	x->prev->next = x->next;
+	while (t) {
+		struct mem_link *l = link_of(t, by_addr);
+
+		if (address == l->address)
+			return l;
+		t = (address < l->address) ? t->left : t->right;
+	}
+
+	return NULL;
 }
 
-STATIC void mem_alloc_coalesce(struct mem_link *head,
-			       struct mem_link *l)
+// Find the links with the greatest address <= address (*prev) and
+// the least address > address (*next), either of which may be NULL.
+STATIC void mem_tree_neighbors(struct mem_tree *t,
+			       uint64_t address,
+			       struct mem_link **prev,
+			       struct mem_link **next)
 {
-	struct mem_link *prev = l->prev;
-	struct mem_link *next = l->next;
-
-	if (prev == head && next == head)
-		return;
-
-	if (prev != head) {
-		if (prev->address + prev->size == l->address) {
-			l->address = prev->address;
-			l->size += prev->size;
-			link_unlink(prev);
-			opae_free(prev);
+	*prev = NULL;
+	*next = NULL;
+
+	while (t) {
+		struct mem_link *l = link_of(t, by_addr);
+
+		if (l->address <= address) {
+			*prev = l;
+			t = t->right;
+		} else {
+			*next = l;
+			t = t->left;
 		}
 	}
+}
+
+// The link with the least (size, address) > (size, address), or NULL.
+STATIC struct mem_link *mem_tree_size_higher(struct mem_tree *t,
+					     uint64_t size,
+					     uint64_t address)
+{
+	struct mem_link *res = NULL;
+
+	while (t) {
+		struct mem_link *l = link_of(t, by_size);
 
-	next = l->next;
-	if (next != head) {
-		if (l->address + l->size == next->address) {
-			next->address = l->address;
-			next->size += l->size;
-			link_unlink(l);
-			opae_free(l);
+		if ((l->size > size) ||
+		    ((l->size == size) && (l->address > address))) {
+			res = l;
+			t = t->left;
+		} else {
+			t = t->right;
 		}
 	}
+
+	return res;
 }
 
-int mem_alloc_add_free(struct mem_alloc *m, uint64_t address, uint64_t size)
+void mem_alloc_init(struct mem_alloc *m)
 {
-	struct mem_link *node;
-	struct mem_link *p;
+	m->free_by_addr = NULL;
+	m->free_by_size = NULL;
+	m->allocated = NULL;
+	m->spare = NULL;
+	m->blocks = NULL;
+}
 
-	node = mem_link_alloc(address, size);
-	if (!node) {
-		ERR("malloc() failed\n");
-		return 1;
+void mem_alloc_destroy(struct mem_alloc *m)
+{
+	struct mem_link_block *b;
+	struct mem_link_block *trash;
+
+	for (b = m->blocks ; b ; ) {
+		trash = b;
+		b = b->next;
+		opae_free(trash);
 	}
 
-	for (p = m->free.next ; p != &m->free ; p = p->next) {
-		if (address < p->address) {
-			link_before(node, p);
-			mem_alloc_coalesce(&m->free, node);
-			return 0;
-		} else if (address == p->address) {
-			// double free
-			opae_free(node);
-			ERR("double free detected 0x%lx\n", address);
-			return 2;
-		} else {
-			// address > p->address
-			break;
+	mem_alloc_init(m);
+}
+
+STATIC struct mem_link *mem_link_alloc(struct mem_alloc *m,
+				       uint64_t address,
+				       uint64_t size)
+{
+	struct mem_link *l;
+
+	if (!m->spare) {
+		struct mem_link_block *b;
+		int i;
+
+		b = opae_malloc(sizeof(struct mem_link_block));
+		if (!b)
+			return NULL;
+
+		b->next = m->blocks;
+		m->blocks = b;
+
+		for (i = 0 ; i < MEM_LINK_BLOCK_SIZE ; ++i) {
+			b->links[i].next = m->spare;
+			m->spare = &b->links[i];
 		}
+	}
+
+	l = m->spare;
+	m->spare = l->next;
+
+	l->address = address;
+	l->size = size;
+	l->next = NULL;
+
+	return l;
+}
+
+STATIC void mem_link_free(struct mem_alloc *m, struct mem_link *l)
+{
+	l->next = m->spare;
+	m->spare = l;
+}
+
+static inline void free_insert(struct mem_alloc *m, struct mem_link *l)
+{
+	m->free_by_addr = mem_tree_insert(m->free_by_addr, &l->by_addr,
+					  mem_tree_addr_compare);
+	m->free_by_size = mem_tree_insert(m->free_by_size, &l->by_size,
+					  mem_tree_size_compare);
+}
+
+static inline void free_remove(struct mem_alloc *m, struct mem_link *l)
+{
+	m->free_by_addr = mem_tree_remove(m->free_by_addr, &l->by_addr,
+					  mem_tree_addr_compare);
+	m->free_by_size = mem_tree_remove(m->free_by_size, &l->by_size,
+					  mem_tree_size_compare);
+}
 
+// Add node to the free trees, merging it with its neighbors.
+STATIC int mem_alloc_insert_free(struct mem_alloc *m,
+				 struct mem_link *node)
+{
+	struct mem_link *prev;
+	struct mem_link *next;
+
+	mem_tree_neighbors(m->free_by_addr, node->address, &prev, &next);
+
+	if ((prev && (prev->address + prev->size > node->address)) ||
+	    (next && (node->address + node->size > next->address))) {
+		ERR("double free detected 0x%lx\n", node->address);
+		return 2;
 	}
 
-	while ((address > p->address) && (p != &m->free)) {
-		p = p->next;
+	if (prev && (prev->address + prev->size == node->address)) {
+		// Grow prev in place; its address order doesn't change.
+		m->free_by_size = mem_tree_remove(m->free_by_size,
+						  &prev->by_size,
+						  mem_tree_size_compare);
+		prev->size += node->size;
+		mem_link_free(m, node);
+		node = prev;
+	} else {
+		m->free_by_addr = mem_tree_insert(m->free_by_addr,
+						  &node->by_addr,
+						  mem_tree_addr_compare);
 	}
 
-	link_before(node, p);
-	mem_alloc_coalesce(&m->free, node);
+	if (next && (node->address + node->size == next->address)) {
+		free_remove(m, next);
+		node->size += next->size;
+		mem_link_free(m, next);
+	}
 
+	m->free_by_size = mem_tree_insert(m->free_by_size, &node->by_size,
+					  mem_tree_size_compare);
 	return 0;
 }
 
-STATIC int mem_alloc_allocate_node(struct mem_alloc *m,
-				   struct mem_link *node,
-				   uint64_t *address,
-				   uint64_t size)
+int mem_alloc_add_free(struct mem_alloc *m, uint64_t address, uint64_t size)
 {
-	struct mem_link *p;
+	struct mem_link *node;
+	int res;
 
-	if (node->size == size) {
-		// If we have an exact fit, recycle the node struct.
-		link_unlink(node);
-		link_before(node, &m->allocated);
-		*address = node->address;
-		return 0;
+	node = mem_link_alloc(m, address, size);
+	if (!node) {
+		ERR("malloc() failed\n");
+		return 1;
 	}
 
-	// node->size > size
+	res = mem_alloc_insert_free(m, node);
+	if (res)
+		mem_link_free(m, node);
 
-	p = mem_link_alloc(node->address, size);
-	if (!p) {
-		ERR("malloc() failed\n");
-		return 1;
+	return res;
+}
+
+// The largest power of two that does not exceed size.
+static inline uint64_t mem_alloc_alignment(uint64_t size)
+{
+	return 1ULL << (63 - __builtin_clzll(size));
+}
+
+static inline int mem_link_fits(const struct mem_link *l,
+				uint64_t size,
+				uint64_t align)
+{
+	uint64_t aligned_addr = ALIGNED(l->address, align);
+
+	return (aligned_addr >= l->address) &&
+	       (aligned_addr + size <= l->address + l->size);
+}
+
+// Find a best-fit free block for size bytes, aligned to align.
+STATIC struct mem_link *mem_alloc_best_fit(struct mem_alloc *m,
+					   uint64_t size,
+					   uint64_t align)
+{
+	struct mem_link *l;
+	int probes = 0;
+
+	l = mem_tree_size_higher(m->free_by_size, size - 1, UINT64_MAX);
+
+	while (l && (probes++ < MEM_ALLOC_BEST_FIT_PROBES)) {
+		if (mem_link_fits(l, size, align))
+			return l;
+		l = mem_tree_size_higher(m->free_by_size, l->size, l->address);
 	}
 
-	node->address += size;
-	node->size -= size;
+	if (!l || (size + align - 1 < size))
+		return NULL;
 
-	link_before(p, &m->allocated);
-	*address = p->address;
+	// Any block of at least size + align - 1 bytes holds the request.
+	l = mem_tree_size_higher(m->free_by_size, size + align - 2, UINT64_MAX);
 
-	return 0;
+	return (l && mem_link_fits(l, size, align)) ? l : NULL;
 }
 
-STATIC int mem_alloc_allocate_split_node(struct mem_alloc *m,
-					 struct mem_link *node,
-					 uint64_t aligned_addr,
-					 uint64_t *address,
-					 uint64_t size)
+int mem_alloc_get(struct mem_alloc *m, uint64_t *address, uint64_t size)
 {
+	struct mem_link *node;
 	struct mem_link *p;
-	struct mem_link *p2;
+	struct mem_link *p2 = NULL;
+	uint64_t aligned_addr;
 	uint64_t first_size;
 	uint64_t second_size;
-	uint64_t second_addr;
-
-	if ((aligned_addr + size) == (node->address + node->size)) {
-		// We're consuming from aligned_addr to the end of node.
-		p = mem_link_alloc(aligned_addr, size);
-		if (!p) {
-			ERR("malloc() failed\n");
-			return 1;
-		}
 
-		link_before(p, &m->allocated);
-		*address = p->address;
-
-		node->size -= size;
+	if (!size) {
+		ERR("invalid size 0\n");
+		return 1;
+	}
 
-		return 0;
+	node = mem_alloc_best_fit(m, size, mem_alloc_alignment(size));
+	if (!node) {
+		ERR("no free block of sufficient size found\n");
+		return 1; // Out of memory.
 	}
 
+	aligned_addr = ALIGNED(node->address, mem_alloc_alignment(size));
 	first_size = aligned_addr - node->address;
 	second_size = node->size - (first_size + size);
-	second_addr = aligned_addr + size;
 
-	// We need to split node into three nodes:
+	// We may split node into three parts:
 	//
 	// first_size         size              second_size
 	// -----------------  ----------------  -----------------------
 	// | node->address |  | aligned_addr |  | aligned_addr + size |
 	// -----------------  ----------------  -----------------------
 
-	p = mem_link_alloc(aligned_addr, size);
+	if (!first_size && !second_size) {
+		// Exact fit: recycle the node struct.
+		free_remove(m, node);
+		m->allocated = mem_tree_insert(m->allocated, &node->by_addr,
+					       mem_tree_addr_compare);
+		*address = node->address;
+		return 0;
+	}
+
+	p = mem_link_alloc(m, aligned_addr, size);
 	if (!p) {
 		ERR("malloc() failed\n");
 		return 2;
 	}
 
-	p2 = mem_link_alloc(second_addr, second_size);
-	if (!p2) {
-		ERR("malloc() failed\n");
-		opae_free(p);
-		return 3;
+	if (first_size && second_size) {
+		p2 = mem_link_alloc(m, aligned_addr + size, second_size);
+		if (!p2) {
+			ERR("malloc() failed\n");
+			mem_link_free(m, p);
+			return 3;
+		}
 	}
 
-	node->size = first_size;
-
-	link_before(p, &m->allocated);
-	*address = p->address;
-
-	link_after(p2, node);
+	m->free_by_size = mem_tree_remove(m->free_by_size, &node->by_size,
+					  mem_tree_size_compare);
 
-	return 0;
-}
-
-int mem_alloc_get(struct mem_alloc *m, uint64_t *address, uint64_t size)
-{
-	struct mem_link *p;
-
-	for (p = m->free.next ; p != &m->free ; p = p->next) {
-		uint64_t aligned_addr = ALIGNED(p->address, size);
-		if ((aligned_addr + size) <= (p->address + p->size)) { // First fit.
-			if (aligned_addr == p->address)
-				return mem_alloc_allocate_node(m,
-							       p,
-							       address,
-							       size);
-			else
-				return mem_alloc_allocate_split_node(m,
-								     p,
-								     aligned_addr,
-								     address,
-								     size);
-		}
+	// Shrinking node within its own range keeps its address order.
+	if (first_size) {
+		node->size = first_size;
+	} else {
+		node->address += size;
+		node->size -= size;
 	}
 
-	ERR("no free block of sufficient size found\n");
-	return 1; // Out of memory.
-}
-
-STATIC int mem_alloc_free_node(struct mem_alloc *m,
-			       struct mem_link *node)
-{
-	uint64_t address;
-	uint64_t size;
+	m->free_by_size = mem_tree_insert(m->free_by_size, &node->by_size,
+					  mem_tree_size_compare);
 
-	address = node->address;
-	size = node->size;
+	if (p2)
+		free_insert(m, p2);
 
-	link_unlink(node);
-	opae_free(node);
+	m->allocated = mem_tree_insert(m->allocated, &p->by_addr,
+				       mem_tree_addr_compare);
+	*address = p->address;
 
-	return mem_alloc_add_free(m, address, size);
+	return 0;
 }
 
 int mem_alloc_put(struct mem_alloc *m, uint64_t address)
 {
-	struct mem_link *p;
+	struct mem_link *node;
 
-	for (p = m->allocated.next ; p != &m->allocated ; p = p->next) {
-		if (address == p->address) {
-			return mem_alloc_free_node(m, p);
-		}
+	node = mem_tree_find(m->allocated, address);
+	if (!node) {
+		ERR("attempt to free non-allocated 0x%lx\n", address);
+		return 1; // Address not found.
 	}
 
-	ERR("attempt to free non-allocated 0x%lx\n", address);
-	return 1; // Address not found.
+	m->allocated = mem_tree_remove(m->allocated, &node->by_addr,
+				       mem_tree_addr_compare);
+
+	if (mem_alloc_insert_free(m, node)) {
+		mem_link_free(m, node);
+		return 2;
+	}
+
+	return 0;
 }
@@ -37,8 +37,10 @@
 #include <string.h>
 #include <errno.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
 #include <regex.h>
 #include <linux/pci_regs.h>
+#include <linux/mempolicy.h>
 
 #include <opae/vfio.h>
 #include "mock/opae_std.h"
@@ -479,11 +481,13 @@ STATIC void opae_vfio_destroy_iova_range(struct opae_vfio_iova_range *r)
 
 STATIC void
 opae_vfio_destroy_buffer(struct opae_vfio *, struct opae_vfio_buffer *);
+STATIC void opae_vfio_pool_destroy(struct opae_vfio *);
 
 STATIC void opae_vfio_destroy(struct opae_vfio *v)
 {
 	// destroy buffers before we close any FDs
 	opae_hash_map_destroy(&v->cont_buffers);
+	opae_vfio_pool_destroy(v);
 
 	opae_vfio_device_destroy(&v->device);
 	opae_vfio_group_destroy(&v->group);
@@ -628,16 +632,253 @@ opae_vfio_create_buffer(uint8_t *vaddr,
 		b->buffer_size = size;
 		b->buffer_iova = iova;
 		b->flags = flags;
+		b->next = NULL;
 	}
 	return b;
 }
 
+#ifndef MAP_HUGETLB
+#define MAP_HUGETLB 0x40000
+#endif
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#define MAP_2M_HUGEPAGE (0x15 << MAP_HUGE_SHIFT)
+#define MAP_1G_HUGEPAGE (0x1e << MAP_HUGE_SHIFT)
+#ifdef __ia64__
+#define ADDR ((void *)(0x8000000000000000UL))
+#define FLAGS_4K (MAP_PRIVATE|MAP_ANONYMOUS|MAP_FIXED)
+#define FLAGS_2M (FLAGS_4K|MAP_2M_HUGEPAGE|MAP_HUGETLB)
+#define FLAGS_1G (FLAGS_4K|MAP_1G_HUGEPAGE|MAP_HUGETLB)
+#else
+#define ADDR ((void *)(0x0UL))
+#define FLAGS_4K (MAP_PRIVATE|MAP_ANONYMOUS)
+#define FLAGS_2M (FLAGS_4K|MAP_2M_HUGEPAGE|MAP_HUGETLB)
+#define FLAGS_1G (FLAGS_4K|MAP_1G_HUGEPAGE|MAP_HUGETLB)
+#endif
+
+#define OPAE_VFIO_MAX_NUMA_NODES 1024
+#define ULONG_BITS (8 * sizeof(unsigned long))
+
+/*
+ * Ask the kernel to back [addr, addr + size) with pages from the
+ * device's node. This must happen before the pages are first touched,
+ * which for us is the VFIO_IOMMU_MAP_DMA pin. MPOL_PREFERRED rather
+ * than MPOL_BIND, so that a node without free huge pages falls back
+ * to another node instead of failing the fault with SIGBUS. size must
+ * cover whole pages of the mapping.
+ */
+STATIC void opae_vfio_numa_prefer(struct opae_vfio *v,
+				  void *addr,
+				  size_t size)
+{
+	unsigned long mask[OPAE_VFIO_MAX_NUMA_NODES / ULONG_BITS];
+	int node = v->numa_node;
+
+	if ((node < 0) || (node >= OPAE_VFIO_MAX_NUMA_NODES))
+		return;
+
+	memset(mask, 0, sizeof(mask));
+	mask[node / ULONG_BITS] = 1UL << (node % ULONG_BITS);
+
+	if (syscall(SYS_mbind, addr, size, MPOL_PREFERRED,
+		    mask, OPAE_VFIO_MAX_NUMA_NODES + 1, 0))
+		ERR("mbind(%p, %lu, node %d) failed\n", addr, size, node);
+}
+
+STATIC const size_t opae_vfio_pool_class_size[OPAE_VFIO_POOL_CLASSES] = {
+	4 * 1024,
+	64 * 1024,
+	OPAE_VFIO_POOL_SLAB_SIZE
+};
+
+STATIC int opae_vfio_pool_class(size_t size)
+{
+	int c;
+
+	for (c = 0 ; c < OPAE_VFIO_POOL_CLASSES ; ++c) {
+		if (size <= opae_vfio_pool_class_size[c])
+			return c;
+	}
+
+	return -1;
+}
+
+STATIC int opae_vfio_pool_grow(struct opae_vfio *v, int c)
+{
+	size_t chunk_size = opae_vfio_pool_class_size[c];
+	size_t num_chunks = OPAE_VFIO_POOL_SLAB_SIZE / chunk_size;
+	struct opae_vfio_pool_slab *slab;
+	struct vfio_iommu_type1_dma_map dma_map;
+	size_t i;
+	int res;
+
+	slab = opae_calloc(1, sizeof(*slab));
+	if (!slab) {
+		ERR("calloc failed\n");
+		return 1;
+	}
+
+	slab->chunks = opae_calloc(num_chunks, sizeof(struct opae_vfio_buffer));
+	if (!slab->chunks) {
+		ERR("calloc failed\n");
+		res = 2;
+		goto out_free_slab;
+	}
+
+	slab->slab_size = OPAE_VFIO_POOL_SLAB_SIZE;
+
+	if (mem_alloc_get(&v->iova_alloc, &slab->slab_iova, slab->slab_size)) {
+		ERR("mem_alloc_get(..., 0x%lx) failed\n", slab->slab_size);
+		res = 3;
+		goto out_free_chunks;
+	}
+
+	slab->slab_ptr = mmap(ADDR, slab->slab_size, PROT_READ|PROT_WRITE,
+			      FLAGS_2M, 0, 0);
+
+	// Sub-hugepage classes don't need a huge page to back the slab.
+	if ((slab->slab_ptr == MAP_FAILED) && (chunk_size < slab->slab_size))
+		slab->slab_ptr = mmap(ADDR, slab->slab_size,
+				      PROT_READ|PROT_WRITE, FLAGS_4K, 0, 0);
+
+	if (slab->slab_ptr == MAP_FAILED) {
+		ERR("mmap() failed\n");
+		res = 4;
+		goto out_put_iova;
+	}
+
+	opae_vfio_numa_prefer(v, slab->slab_ptr, slab->slab_size);
+
+	memset(&dma_map, 0, sizeof(dma_map));
+
+	dma_map.argsz = sizeof(dma_map);
+	dma_map.vaddr = (uint64_t) slab->slab_ptr;
+	dma_map.size = slab->slab_size;
+	dma_map.iova = slab->slab_iova;
+	dma_map.flags = VFIO_DMA_MAP_FLAG_READ|VFIO_DMA_MAP_FLAG_WRITE;
+
+	if (opae_ioctl(v->cont_fd, VFIO_IOMMU_MAP_DMA, &dma_map) < 0) {
+		ERR("ioctl(%d, VFIO_IOMMU_MAP_DMA, &dma_map)\n", v->cont_fd);
+		res = 5;
+		goto out_munmap;
+	}
+
+	// Push in reverse so that the lowest address is popped first.
+	for (i = num_chunks ; i-- ; ) {
+		struct opae_vfio_buffer *b = &slab->chunks[i];
+
+		b->buffer_ptr = slab->slab_ptr + (i * chunk_size);
+		b->buffer_size = chunk_size;
+		b->buffer_iova = slab->slab_iova + (i * chunk_size);
+		b->flags = OPAE_VFIO_BUF_POOLED;
+		b->next = v->pool.free_list[c];
+		v->pool.free_list[c] = b;
+	}
+
+	slab->next = v->pool.slabs;
+	v->pool.slabs = slab;
+	v->pool.stats.bytes_resident += slab->slab_size;
+
+	return 0;
+
+out_munmap:
+	munmap(slab->slab_ptr, slab->slab_size);
+out_put_iova:
+	mem_alloc_put(&v->iova_alloc, slab->slab_iova);
+out_free_chunks:
+	opae_free(slab->chunks);
+out_free_slab:
+	opae_free(slab);
+	return res;
+}
+
+STATIC int opae_vfio_pool_get(struct opae_vfio *v,
+			      size_t *size,
+			      struct opae_vfio_buffer **node)
+{
+	int c = opae_vfio_pool_class(*size);
+	struct opae_vfio_buffer *b;
+
+	if (c < 0)
+		return 1;
+
+	if (v->pool.free_list[c]) {
+		++v->pool.stats.hits;
+		b = v->pool.free_list[c];
+		// A recycled buffer must look like freshly-mapped memory.
+		memset(b->buffer_ptr, 0, b->buffer_size);
+	} else {
+		if (opae_vfio_pool_grow(v, c))
+			return 2;
+		++v->pool.stats.misses;
+		b = v->pool.free_list[c];
+	}
+
+	v->pool.free_list[c] = b->next;
+	b->next = NULL;
+	v->pool.stats.bytes_in_use += b->buffer_size;
+
+	*size = b->buffer_size;
+	*node = b;
+
+	return 0;
+}
+
+STATIC void opae_vfio_pool_put(struct opae_vfio *v,
+			       struct opae_vfio_buffer *b)
+{
+	int c = opae_vfio_pool_class(b->buffer_size);
+
+	b->next = v->pool.free_list[c];
+	v->pool.free_list[c] = b;
+	v->pool.stats.bytes_in_use -= b->buffer_size;
+}
+
+STATIC void opae_vfio_pool_destroy(struct opae_vfio *v)
+{
+	struct opae_vfio_pool_slab *slab = v->pool.slabs;
+	struct vfio_iommu_type1_dma_unmap dma_unmap;
+
+	while (slab) {
+		struct opae_vfio_pool_slab *trash = slab;
+		slab = slab->next;
+
+		memset(&dma_unmap, 0, sizeof(dma_unmap));
+		dma_unmap.argsz = sizeof(dma_unmap);
+		dma_unmap.iova = trash->slab_iova;
+		dma_unmap.size = trash->slab_size;
+
+		if (opae_ioctl(v->cont_fd, VFIO_IOMMU_UNMAP_DMA, &dma_unmap) < 0)
+			ERR("ioctl(%d, VFIO_IOMMU_UNMAP_DMA, &dma_unmap)\n",
+			    v->cont_fd);
+
+		if (munmap(trash->slab_ptr, trash->slab_size) < 0)
+			ERR("munmap(%p, %lu) failed\n",
+			    trash->slab_ptr, trash->slab_size);
+
+		if (mem_alloc_put(&v->iova_alloc, trash->slab_iova))
+			ERR("mem_alloc_put(..., 0x%lx) failed\n",
+			    trash->slab_iova);
+
+		opae_free(trash->chunks);
+		opae_free(trash);
+	}
+
+	memset(&v->pool, 0, sizeof(v->pool));
+}
+
 STATIC void
 opae_vfio_destroy_buffer(struct opae_vfio *v,
 			 struct opae_vfio_buffer *b)
 {
 	struct vfio_iommu_type1_dma_unmap dma_unmap;
 
+	if (b->flags & OPAE_VFIO_BUF_POOLED) {
+		opae_vfio_pool_put(v, b);
+		return;
+	}
+
 	memset(&dma_unmap, 0, sizeof(dma_unmap));
 	dma_unmap.argsz = sizeof(dma_unmap);
 	dma_unmap.iova = b->buffer_iova;
@@ -659,26 +900,6 @@ opae_vfio_destroy_buffer(struct opae_vfio *v,
 	opae_free(b);
 }
 
-#ifndef MAP_HUGETLB
-#define MAP_HUGETLB 0x40000
-#endif
-#ifndef MAP_HUGE_SHIFT
-#define MAP_HUGE_SHIFT 26
-#endif
-#define MAP_2M_HUGEPAGE (0x15 << MAP_HUGE_SHIFT)
-#define MAP_1G_HUGEPAGE (0x1e << MAP_HUGE_SHIFT)
-#ifdef __ia64__
-#define ADDR ((void *)(0x8000000000000000UL))
-#define FLAGS_4K (MAP_PRIVATE|MAP_ANONYMOUS|MAP_FIXED)
-#define FLAGS_2M (FLAGS_4K|MAP_2M_HUGEPAGE|MAP_HUGETLB)
-#define FLAGS_1G (FLAGS_4K|MAP_1G_HUGEPAGE|MAP_HUGETLB)
-#else
-#define ADDR ((void *)(0x0UL))
-#define FLAGS_4K (MAP_PRIVATE|MAP_ANONYMOUS)
-#define FLAGS_2M (FLAGS_4K|MAP_2M_HUGEPAGE|MAP_HUGETLB)
-#define FLAGS_1G (FLAGS_4K|MAP_1G_HUGEPAGE|MAP_HUGETLB)
-#endif
-
 STATIC int
 opae_vfio_buffer_mmap(struct opae_vfio *v,
 		      size_t *size,
@@ -689,32 +910,62 @@ opae_vfio_buffer_mmap(struct opae_vfio *v,
 {
 	uint8_t *vaddr = NULL;
 	uint64_t ioaddr = 0;
+	size_t page = 4096;
 	int res;
 	struct vfio_iommu_type1_dma_map dma_map;
 	struct vfio_iommu_type1_dma_unmap dma_unmap;
 
+	if (!(flags & OPAE_VFIO_BUF_PREALLOCATED)) {
+		if ((*size > (2 * 1024 * 1024)) &&
+		    !(flags & OPAE_VFIO_BUF_SCATTER_GATHER))
+			page = 1024 * 1024 * 1024;
+		else if (*size > 4096)
+			page = 2 * 1024 * 1024;
+
+		// A scatter-gather buffer is a run of independent pages
+		// behind a single IOVA range, so it only needs to cover
+		// the request to the next page boundary.
+		if (flags & OPAE_VFIO_BUF_SCATTER_GATHER)
+			*size = (*size + page - 1) & ~(page - 1);
+	}
+
 	if (opae_vfio_iova_reserve(v, size, &ioaddr)) {
 		return 1;
 	}
 
 	if (!(flags & OPAE_VFIO_BUF_PREALLOCATED)) {
 
-		if (*size > (2 * 1024 * 1024))
+		if (page == 1024 * 1024 * 1024)
 			vaddr = mmap(ADDR, *size, PROT_READ|PROT_WRITE,
 				     FLAGS_1G, 0, 0);
-		else if (*size > 4096)
+		else if (page == 2 * 1024 * 1024)
 			vaddr = mmap(ADDR, *size, PROT_READ|PROT_WRITE,
 				     FLAGS_2M, 0, 0);
 		else
 			vaddr = mmap(ADDR, *size, PROT_READ|PROT_WRITE,
 				     FLAGS_4K, 0, 0);
 
+		// No 2MB pages left: the IOMMU doesn't care, so fall back
+		// to 4K pages at the cost of more IOTLB misses.
+		if ((vaddr == MAP_FAILED) &&
+		    (flags & OPAE_VFIO_BUF_SCATTER_GATHER) &&
+		    (page == 2 * 1024 * 1024)) {
+			page = 4096;
+			vaddr = mmap(ADDR, *size, PROT_READ|PROT_WRITE,
+				     FLAGS_4K, 0, 0);
+		}
+
 		if (vaddr == MAP_FAILED) {
 			ERR("mmap() failed\n");
 			mem_alloc_put(&v->iova_alloc, ioaddr);
 			return 2;
 		}
 
+		// Cover whole pages, or mbind() can't split a huge mapping.
+		if (!(flags & OPAE_VFIO_BUF_NUMA_ANY))
+			opae_vfio_numa_prefer(v, vaddr,
+					      (*size + page - 1) & ~(page - 1));
+
 	} else if (!buf || !*buf) {
 		ERR("got OPAE_VFIO_BUF_PREALLOCATED, but buf is NULL.\n");
 		mem_alloc_put(&v->iova_alloc, ioaddr);
@@ -789,19 +1040,33 @@ int opae_vfio_buffer_allocate_ex(struct opae_vfio *v,
 		return 3;
 	}
 
-	if (opae_vfio_buffer_mmap(v,
-				  size,
-				  buf,
-				  iova,
-				  flags,
-				  &node)) {
+	if (!(flags & (OPAE_VFIO_BUF_PREALLOCATED|OPAE_VFIO_BUF_NOPOOL|
+		       OPAE_VFIO_BUF_NUMA_ANY)) &&
+	    (*size <= OPAE_VFIO_POOL_SLAB_SIZE)) {
+		if (opae_vfio_pool_get(v, size, &node)) {
+			if (pthread_mutex_unlock(&v->lock))
+				ERR("pthread_mutex_unlock() failed\n");
+			return 4;
+		}
+
+		if (buf)
+			*buf = node->buffer_ptr;
+		if (iova)
+			*iova = node->buffer_iova;
+	} else if (opae_vfio_buffer_mmap(v,
+					 size,
+					 buf,
+					 iova,
+					 flags,
+					 &node)) {
 		if (pthread_mutex_unlock(&v->lock))
 			ERR("pthread_mutex_unlock() failed\n");
 		return 4;
 	}
 
-	if (opae_hash_map_add(&v->cont_buffers, *buf, node)) {
+	if (opae_hash_map_add(&v->cont_buffers, node->buffer_ptr, node)) {
 		ERR("opae_hash_map_add() failed\n");
+		opae_vfio_destroy_buffer(v, node);
 		res = 5;
 	}
 
@@ -875,6 +1140,46 @@ int opae_vfio_buffer_free(struct opae_vfio *v,
 	return res;
 }
 
+int opae_vfio_buffer_pool_stats(struct opae_vfio *v,
+				struct opae_vfio_pool_stats *stats)
+{
+	if (!v || !stats) {
+		ERR("NULL param\n");
+		return 1;
+	}
+
+	if (pthread_mutex_lock(&v->lock)) {
+		ERR("pthread_mutex_lock() failed\n");
+		return 2;
+	}
+
+	*stats = v->pool.stats;
+
+	if (pthread_mutex_unlock(&v->lock))
+		ERR("pthread_mutex_unlock() failed\n");
+
+	return 0;
+}
+
+int opae_vfio_buffer_numa_node(struct opae_vfio *v,
+			       uint8_t *buf)
+{
+	int node = -1;
+
+	if (!v || !buf) {
+		ERR("NULL param\n");
+		return -1;
+	}
+
+	if (syscall(SYS_get_mempolicy, &node, NULL, 0, buf,
+		    MPOL_F_NODE|MPOL_F_ADDR)) {
+		ERR("get_mempolicy(%p) failed\n", buf);
+		return -1;
+	}
+
+	return node;
+}
+
 STATIC int
 opae_vfio_device_set_irqs(struct opae_vfio *v,
 			  uint32_t index,
@@ -1117,6 +1422,31 @@ STATIC char *opae_vfio_group_for(const char *pciaddr)
 	return opae_strdup(path);
 }
 
+STATIC int opae_vfio_numa_node_for(const char *pciaddr)
+{
+	char path[256];
+	char buf[32];
+	ssize_t len;
+	int fd;
+
+	snprintf(path, sizeof(path),
+		 "/sys/bus/pci/devices/%s/numa_node", pciaddr);
+
+	fd = opae_open(path, O_RDONLY);
+	if (fd < 0)
+		return -1;
+
+	len = opae_read(fd, buf, sizeof(buf) - 1);
+	opae_close(fd);
+
+	if (len <= 0)
+		return -1;
+	buf[len] = '\0';
+
+	// -1 when the platform doesn't report a node.
+	return (int)strtol(buf, NULL, 10);
+}
+
 STATIC
 void opae_vfio_value_cleanup(void *value, void *context)
 {
@@ -1141,13 +1471,15 @@ STATIC int opae_vfio_init(struct opae_vfio *v,
 	v->cont_fd = -1;
 	v->group.group_fd = -1;
 	v->device.device_fd = -1;
+	v->numa_node = opae_vfio_numa_node_for(pciaddr);
 
 	mem_alloc_init(&v->iova_alloc);
 
 	result = opae_hash_map_init(&v->cont_buffers,
-				    19441, // num_buckets
+				    1024,  // initial table size
 				    0,     // hash_seed
-				    OPAE_HASH_MAP_UNIQUE_KEYSPACE,
+				    OPAE_HASH_MAP_UNIQUE_KEYSPACE |
+				    OPAE_HASH_MAP_OPEN_ADDRESSING,
 				    opae_u64_key_hash,
 				    opae_u64_key_compare,
 				    NULL,  // key_cleanup
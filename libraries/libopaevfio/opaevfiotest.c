@@ -25,6 +25,7 @@
 // POSSIBILITY OF SUCH DAMAGE.
 
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 #include <sys/eventfd.h>
 #include <unistd.h>
@@ -138,6 +139,67 @@ void allocate_bufs(struct opae_vfio *v)
 	}
 }
 
+#define POOL_ITERATIONS 10000
+
+double pool_bench_one(struct opae_vfio *v, size_t size, int flags)
+{
+	struct timespec start;
+	struct timespec end;
+	double elapsed;
+	int i;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for (i = 0 ; i < POOL_ITERATIONS ; ++i) {
+		size_t sz = size;
+		uint8_t *virt = NULL;
+		uint64_t iova = 0;
+
+		if (opae_vfio_buffer_allocate_ex(v, &sz, &virt, &iova, flags)) {
+			printf("whoops alloc %lu!\n", size);
+			return 0.0;
+		}
+
+		if (opae_vfio_buffer_free(v, virt)) {
+			printf("whoops free %lu!\n", size);
+			return 0.0;
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	elapsed = (end.tv_sec - start.tv_sec) +
+		  (end.tv_nsec - start.tv_nsec) / 1e9;
+
+	return POOL_ITERATIONS / elapsed;
+}
+
+void pool_bench(struct opae_vfio *v)
+{
+	size_t sizes[] = { 4096, 64 * 1024, 2 * 1024 * 1024 };
+	struct opae_vfio_pool_stats stats;
+	size_t i;
+
+	printf("%-10s %16s %16s\n", "size", "pooled ops/s", "unpooled ops/s");
+
+	for (i = 0 ; i < sizeof(sizes) / sizeof(sizes[0]) ; ++i) {
+		double pooled = pool_bench_one(v, sizes[i], 0);
+		double unpooled = pool_bench_one(v, sizes[i],
+						 OPAE_VFIO_BUF_NOPOOL);
+
+		printf("%-10lu %16.0f %16.0f\n", sizes[i], pooled, unpooled);
+	}
+
+	if (opae_vfio_buffer_pool_stats(v, &stats)) {
+		printf("whoops pool stats!\n");
+		return;
+	}
+
+	printf("pool hits: %lu misses: %lu resident: %lu in use: %lu\n",
+	       stats.hits, stats.misses,
+	       stats.bytes_resident, stats.bytes_in_use);
+}
+
 #define CSR_SRC_ADDR      (AFU_OFFSET + 0x0120)
 #define CSR_DST_ADDR      (AFU_OFFSET + 0x0128)
 #define CSR_CTL           (AFU_OFFSET + 0x0138)
@@ -362,7 +424,7 @@ int main(int argc, char *argv[])
 
 	if (argc < 3) {
 		printf("usage: opaevfiotest 0000:00:00.0 <test>\n");
-		printf("\n\twhere <test> is one of { dfh, buf, nlb0, irqinfo, errinj }\n");
+		printf("\n\twhere <test> is one of { dfh, buf, pool, nlb0, irqinfo, errinj }\n");
 		return 1;
 	}
 
@@ -375,6 +437,8 @@ int main(int argc, char *argv[])
 		print_dfhs(&v);
 	else if (!strcmp(argv[2], "buf"))
 		allocate_bufs(&v);
+	else if (!strcmp(argv[2], "pool"))
+		pool_bench(&v);
 	else if (!strcmp(argv[2], "nlb0"))
 		nlb0(&v);
 	else if (!strcmp(argv[2], "irqinfo"))
@@ -0,0 +1,1786 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif // _GNU_SOURCE
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#undef _GNU_SOURCE
+
+#include <opae/fpga.h>
+
+#include "opae_remote.h"
+
+#include "opae_int.h"
+#include "props.h"
+#include "cfg-file.h"
+#include "mock/opae_std.h"
+
+#ifndef __REMOTE_API__
+#define __REMOTE_API__
+#endif
+
+#define REMOTE_TOKEN_MAGIC 0x52454d4f
+#define REMOTE_HANDLE_MAGIC (~(uint32_t)REMOTE_TOKEN_MAGIC)
+#define REMOTE_EVENT_HANDLE_MAGIC 0x5a7452a5
+
+#define REMOTE_PAGE_ROUND(__len) (((__len) + 4095) & ~(uint64_t)4095)
+
+STATIC char *remote_endpoints[REMOTE_ENDPOINTS_MAX];
+STATIC uint32_t remote_num_endpoints;
+STATIC bool remote_shm = true;
+STATIC uint32_t remote_sync_usec = REMOTE_SYNC_USEC_DEFAULT;
+STATIC uint8_t remote_secret[REMOTE_TOKEN_MAX];
+STATIC uint32_t remote_secret_len;
+
+STATIC remote_conn *remote_conns[REMOTE_ENDPOINTS_MAX];
+STATIC pthread_mutex_t remote_enum_lock = PTHREAD_MUTEX_INITIALIZER;
+
+STATIC void remote_free_config(void)
+{
+	uint32_t i;
+
+	for (i = 0 ; i < remote_num_endpoints ; ++i) {
+		opae_free(remote_endpoints[i]);
+		remote_endpoints[i] = NULL;
+	}
+	remote_num_endpoints = 0;
+	remote_shm = true;
+	remote_sync_usec = REMOTE_SYNC_USEC_DEFAULT;
+	memset(remote_secret, 0, sizeof(remote_secret));
+	remote_secret_len = 0;
+}
+
+/*
+ * The plugin "configuration" from opae.cfg:
+ *
+ *   {
+ *     "endpoints": [ "unix:/tmp/opae_remote_socket",
+ *                    "tcp:fpga-host:5530" ],
+ *     "shm": true,
+ *     "sync_usec": 0,
+ *     "token_file": "/home/user/.opae/remote_token"
+ *   }
+ *
+ * Each endpoint names an fpgaremoted to connect to. When
+ * "endpoints" is absent, the default UNIX socket is used. "shm"
+ * allows buffers to be shared with a server reached over a UNIX
+ * socket. A nonzero "sync_usec" also synchronizes copy-mode buffers
+ * between client and server at that period, for applications that
+ * poll buffer memory; by default they are synchronized only around
+ * MMIO accesses, resets and events, since each exchange compares
+ * every copy-mode buffer in full. "token_file" holds the secret
+ * that a server started with --token-file requires of TCP clients.
+ */
+int remote_parse_config(const char *json)
+{
+	json_object *root = NULL;
+	json_object *j_endpoints = NULL;
+	json_object *j_value = NULL;
+	enum json_tokener_error j_err = json_tokener_success;
+	int num_endpoints = 0;
+	int res = 1;
+	int i;
+
+	remote_free_config();
+
+	if (json) {
+		root = json_tokener_parse_verbose(json, &j_err);
+		if (!root) {
+			OPAE_ERR("error parsing plugin configuration: %s",
+				 json_tokener_error_desc(j_err));
+			return 1;
+		}
+	}
+
+	if (root && json_object_object_get_ex(root, "shm", &j_value)) {
+		if (!json_object_is_type(j_value, json_type_boolean)) {
+			OPAE_ERR("\"shm\" must be true or false");
+			goto out_put;
+		}
+		remote_shm = json_object_get_boolean(j_value);
+	}
+
+	if (root && json_object_object_get_ex(root, "sync_usec", &j_value)) {
+		if (!json_object_is_type(j_value, json_type_int) ||
+		    json_object_get_int(j_value) < 0) {
+			OPAE_ERR("\"sync_usec\" must be a non-negative integer");
+			goto out_put;
+		}
+		remote_sync_usec = (uint32_t)json_object_get_int(j_value);
+	}
+
+	if (root &&
+	    json_object_object_get_ex(root, "token_file", &j_value)) {
+		if (!json_object_is_type(j_value, json_type_string)) {
+			OPAE_ERR("\"token_file\" must be a string");
+			goto out_put;
+		}
+		if (remote_read_token(json_object_get_string(j_value),
+				      remote_secret, &remote_secret_len))
+			goto out_put;
+	}
+
+	if (root)
+		j_endpoints = parse_json_array(root, "endpoints", &num_endpoints);
+
+	if (!j_endpoints) {
+		remote_endpoints[0] = opae_strdup("unix:" REMOTE_SOCKET_DEFAULT);
+		if (!remote_endpoints[0]) {
+			OPAE_ERR("strdup failed");
+			goto out_put;
+		}
+		remote_num_endpoints = 1;
+		res = 0;
+		goto out_put;
+	}
+
+	if (num_endpoints > REMOTE_ENDPOINTS_MAX) {
+		OPAE_ERR("at most %d remote endpoints are supported",
+			 REMOTE_ENDPOINTS_MAX);
+		goto out_put;
+	}
+
+	for (i = 0 ; i < num_endpoints ; ++i) {
+		json_object *j_ep = json_object_array_get_idx(j_endpoints, i);
+
+		if (!json_object_is_type(j_ep, json_type_string)) {
+			OPAE_ERR("Non-string JSON item found in 'endpoints[%d]'",
+				 i);
+			goto out_put;
+		}
+
+		remote_endpoints[remote_num_endpoints] =
+			opae_strdup(json_object_get_string(j_ep));
+		if (!remote_endpoints[remote_num_endpoints]) {
+			OPAE_ERR("strdup failed");
+			goto out_put;
+		}
+		++remote_num_endpoints;
+	}
+
+	res = 0;
+
+out_put:
+	if (root)
+		json_object_put(root);
+	if (res)
+		remote_free_config();
+	return res;
+}
+
+int remote_connect_all(void)
+{
+	uint32_t i;
+
+	if (getenv(REMOTE_SERVER_ENV)) {
+		OPAE_DBG("running inside fpgaremoted: not connecting");
+		return 0;
+	}
+
+	if (!remote_num_endpoints && remote_parse_config(NULL))
+		return 1;
+
+	// An unreachable server leaves its slot empty, so that the
+	// segment numbers of the others do not depend on it.
+	for (i = 0 ; i < remote_num_endpoints ; ++i) {
+		remote_conns[i] = remote_conn_open(remote_endpoints[i], i,
+						   remote_shm,
+						   remote_sync_usec,
+						   remote_secret,
+						   remote_secret_len);
+		if (!remote_conns[i])
+			OPAE_ERR("failed to connect to %s",
+				 remote_endpoints[i]);
+	}
+
+	return 0;
+}
+
+void remote_disconnect_all(void)
+{
+	uint32_t i;
+
+	for (i = 0 ; i < REMOTE_ENDPOINTS_MAX ; ++i) {
+		if (remote_conns[i]) {
+			remote_conn_close(remote_conns[i]);
+			remote_conns[i] = NULL;
+		}
+	}
+
+	remote_free_config();
+}
+
+STATIC remote_token *clone_token(const remote_token *src)
+{
+	remote_token *token;
+
+	ASSERT_NOT_NULL_RESULT(src, NULL);
+
+	token = (remote_token *)opae_malloc(sizeof(remote_token));
+	if (!token) {
+		OPAE_ERR("Failed to allocate memory for remote_token");
+		return NULL;
+	}
+
+	memcpy(token, src, sizeof(remote_token));
+
+	return token;
+}
+
+STATIC remote_token *token_check(fpga_token token)
+{
+	remote_token *t;
+
+	ASSERT_NOT_NULL_RESULT(token, NULL);
+
+	t = (remote_token *)token;
+	if (t->hdr.magic != REMOTE_TOKEN_MAGIC) {
+		OPAE_ERR("invalid token magic");
+		return NULL;
+	}
+
+	return t;
+}
+
+STATIC remote_handle *handle_check(fpga_handle handle)
+{
+	remote_handle *h;
+
+	ASSERT_NOT_NULL_RESULT(handle, NULL);
+
+	h = (remote_handle *)handle;
+	if (h->magic != REMOTE_HANDLE_MAGIC) {
+		OPAE_ERR("invalid handle magic");
+		return NULL;
+	}
+
+	return h;
+}
+
+STATIC remote_event_handle *
+event_handle_check(fpga_event_handle event_handle)
+{
+	remote_event_handle *eh;
+
+	ASSERT_NOT_NULL_RESULT(event_handle, NULL);
+
+	eh = (remote_event_handle *)event_handle;
+	if (eh->magic != REMOTE_EVENT_HANDLE_MAGIC) {
+		OPAE_ERR("invalid event handle magic");
+		return NULL;
+	}
+
+	return eh;
+}
+
+STATIC remote_handle *handle_check_and_lock(fpga_handle handle)
+{
+	int res;
+	remote_handle *h;
+
+	h = handle_check(handle);
+	if (h)
+		return opae_mutex_lock(res, &h->lock) ? NULL : h;
+
+	return NULL;
+}
+
+/*
+ * Make a call for h. A posted request of h that failed since its
+ * last such call turns success into that failure, so the error
+ * reaches the owner of the handle rather than whoever calls next
+ * on the connection.
+ */
+STATIC fpga_result remote_handle_call(remote_handle *h, uint16_t op,
+				      const remote_buf *req, bool push,
+				      remote_buf *resp, int *resp_fd)
+{
+	fpga_result res;
+
+	res = remote_conn_call(h->conn, op, req, push, resp, resp_fd);
+	if (res == FPGA_OK)
+		res = remote_conn_take_posted(h->conn, h->remote_id);
+
+	return res;
+}
+
+STATIC remote_event_handle *
+event_handle_check_and_lock(fpga_event_handle event_handle)
+{
+	int res;
+	remote_event_handle *eh;
+
+	eh = event_handle_check(event_handle);
+	if (eh)
+		return opae_mutex_lock(res, &eh->lock) ? NULL : eh;
+
+	return NULL;
+}
+
+STATIC void remote_fill_token(remote_token *t, remote_conn *c,
+			      uint64_t remote_id, const remote_props *p)
+{
+	memset(t, 0, sizeof(*t));
+
+	t->conn = c;
+	t->remote_id = remote_id;
+	t->props = *p;
+	t->props.segment = REMOTE_SEGMENT(c->index, p->segment);
+
+	t->hdr.magic = REMOTE_TOKEN_MAGIC;
+	t->hdr.vendor_id = p->vendor_id;
+	t->hdr.device_id = p->device_id;
+	t->hdr.segment = t->props.segment;
+	t->hdr.bus = p->bus;
+	t->hdr.device = p->device;
+	t->hdr.function = p->function;
+	t->hdr.interface = p->interface;
+	t->hdr.objtype = p->objtype;
+	t->hdr.object_id = p->object_id;
+	memcpy(t->hdr.guid, p->guid, sizeof(fpga_guid));
+	t->hdr.subsystem_vendor_id = p->subsystem_vendor_id;
+	t->hdr.subsystem_device_id = p->subsystem_device_id;
+}
+
+// Fetch the token list of c. Called with remote_enum_lock held.
+STATIC fpga_result remote_enumerate_conn(remote_conn *c)
+{
+	remote_buf resp;
+	remote_reader r;
+	remote_token *tokens = NULL;
+	fpga_result res;
+	uint32_t count;
+	uint32_t i;
+
+	remote_buf_init(&resp);
+
+	res = remote_conn_call(c, REMOTE_OP_ENUMERATE, NULL, false,
+			       &resp, NULL);
+	if (res != FPGA_OK)
+		goto out_free;
+
+	remote_reader_init(&r, resp.data, resp.len);
+	count = remote_get_u32(&r);
+
+	if (count) {
+		tokens = opae_calloc(count, sizeof(remote_token));
+		if (!tokens) {
+			OPAE_ERR("out of memory");
+			res = FPGA_NO_MEMORY;
+			goto out_free;
+		}
+	}
+
+	for (i = 0 ; i < count && !r.err ; ++i) {
+		uint64_t id = remote_get_u64(&r);
+		remote_props p;
+
+		remote_get_props(&r, &p);
+		remote_fill_token(&tokens[i], c, id, &p);
+	}
+
+	if (r.err) {
+		OPAE_ERR("malformed enumeration from %s", c->endpoint);
+		opae_free(tokens);
+		res = FPGA_EXCEPTION;
+		goto out_free;
+	}
+
+	if (c->tokens)
+		opae_free(c->tokens);
+	c->tokens = tokens;
+	c->num_tokens = count;
+	c->enumerated = true;
+
+out_free:
+	remote_buf_free(&resp);
+	return res;
+}
+
+STATIC bool matches_filter(const fpga_properties filter, remote_token *t)
+{
+	struct _fpga_properties *_prop = (struct _fpga_properties *)filter;
+	const remote_props *p = &t->props;
+
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_PARENT)) {
+		fpga_token_header *parent = (fpga_token_header *)_prop->parent;
+
+		if (!parent || (parent->magic != REMOTE_TOKEN_MAGIC) ||
+		    !fpga_is_parent_child(parent, &t->hdr))
+			return false;
+	}
+
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_OBJTYPE)) {
+		if (_prop->objtype != p->objtype)
+			return false;
+
+		if (p->objtype == FPGA_DEVICE) {
+			if (FIELD_VALID(_prop, FPGA_PROPERTY_NUM_SLOTS))
+				if (_prop->u.fpga.num_slots != p->num_slots)
+					return false;
+			if (FIELD_VALID(_prop, FPGA_PROPERTY_BBSID))
+				if (_prop->u.fpga.bbs_id != p->bbs_id)
+					return false;
+			if (FIELD_VALID(_prop, FPGA_PROPERTY_BBSVERSION))
+				if (memcmp(&_prop->u.fpga.bbs_version,
+					   &p->bbs_version,
+					   sizeof(fpga_version)))
+					return false;
+		} else {
+			if (FIELD_VALID(_prop, FPGA_PROPERTY_ACCELERATOR_STATE))
+				if (_prop->u.accelerator.state != p->state)
+					return false;
+			if (FIELD_VALID(_prop, FPGA_PROPERTY_NUM_MMIO))
+				if (_prop->u.accelerator.num_mmio !=
+				    p->num_mmio)
+					return false;
+			if (FIELD_VALID(_prop, FPGA_PROPERTY_NUM_INTERRUPTS))
+				if (_prop->u.accelerator.num_interrupts !=
+				    p->num_interrupts)
+					return false;
+		}
+	}
+
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_SEGMENT))
+		if (_prop->segment != p->segment)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_BUS))
+		if (_prop->bus != p->bus)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_DEVICE))
+		if (_prop->device != p->device)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_FUNCTION))
+		if (_prop->function != p->function)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_SOCKETID))
+		if (_prop->socket_id != p->socket_id)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_VENDORID))
+		if (_prop->vendor_id != p->vendor_id)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_DEVICEID))
+		if (_prop->device_id != p->device_id)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_SUB_VENDORID))
+		if (_prop->subsystem_vendor_id != p->subsystem_vendor_id)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_SUB_DEVICEID))
+		if (_prop->subsystem_device_id != p->subsystem_device_id)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_OBJECTID))
+		if (_prop->object_id != p->object_id)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_NUM_ERRORS))
+		if (_prop->num_errors != p->num_errors)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_GUID))
+		if (memcmp(_prop->guid, p->guid, sizeof(fpga_guid)))
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_INTERFACE))
+		if (_prop->interface != p->interface)
+			return false;
+
+	return true;
+}
+
+STATIC bool matches_filters(const fpga_properties *filters,
+			    uint32_t num_filters,
+			    remote_token *t)
+{
+	if (!filters)
+		return true;
+
+	for (uint32_t i = 0; i < num_filters; ++i) {
+		if (matches_filter(filters[i], t))
+			return true;
+	}
+
+	return false;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaEnumerate(const fpga_properties *filters,
+						uint32_t num_filters,
+						fpga_token *tokens,
+						uint32_t max_tokens,
+						uint32_t *num_matches)
+{
+	uint32_t matches = 0;
+	uint32_t i;
+	uint32_t j;
+	int err;
+
+	opae_mutex_lock(err, &remote_enum_lock);
+
+	for (i = 0 ; i < REMOTE_ENDPOINTS_MAX ; ++i) {
+		remote_conn *c = remote_conns[i];
+
+		if (!c || c->dead)
+			continue;
+
+		// The token list is fetched once; fpgaEnumerateRefresh()
+		// fetches it again.
+		if (!c->enumerated && remote_enumerate_conn(c) != FPGA_OK)
+			continue;
+
+		for (j = 0 ; j < c->num_tokens ; ++j) {
+			remote_token *t = &c->tokens[j];
+
+			if (matches_filters(filters, num_filters, t)) {
+				if (matches < max_tokens)
+					tokens[matches] = clone_token(t);
+				++matches;
+			}
+		}
+	}
+
+	opae_mutex_unlock(err, &remote_enum_lock);
+
+	*num_matches = matches;
+
+	return FPGA_OK;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaEnumerateRefresh(void)
+{
+	fpga_result res = FPGA_OK;
+	uint32_t i;
+	int err;
+
+	opae_mutex_lock(err, &remote_enum_lock);
+
+	for (i = 0 ; i < REMOTE_ENDPOINTS_MAX ; ++i) {
+		remote_conn *c = remote_conns[i];
+
+		if (c && !c->dead) {
+			fpga_result r = remote_enumerate_conn(c);
+			if (r != FPGA_OK)
+				res = r;
+		}
+	}
+
+	opae_mutex_unlock(err, &remote_enum_lock);
+
+	return res;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaCloneToken(fpga_token src,
+						 fpga_token *dst)
+{
+	remote_token *token;
+
+	ASSERT_NOT_NULL(dst);
+
+	token = token_check(src);
+	ASSERT_NOT_NULL(token);
+
+	*dst = clone_token(token);
+	return *dst ? FPGA_OK : FPGA_NO_MEMORY;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaDestroyToken(fpga_token *token)
+{
+	remote_token *t;
+
+	ASSERT_NOT_NULL(token);
+
+	t = token_check(*token);
+	ASSERT_NOT_NULL(t);
+
+	t->hdr.magic = 0;
+	opae_free(t);
+	*token = NULL;
+
+	return FPGA_OK;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaUpdateProperties(fpga_token token,
+						       fpga_properties prop)
+{
+	struct _fpga_properties *_prop;
+	remote_token *t;
+	remote_buf req;
+	remote_buf resp;
+	remote_reader r;
+	remote_props p;
+	fpga_result res;
+	int err;
+
+	t = token_check(token);
+	ASSERT_NOT_NULL(t);
+
+	remote_buf_init(&req);
+	remote_buf_init(&resp);
+
+	remote_put_u64(&req, t->remote_id);
+
+	res = remote_conn_call(t->conn, REMOTE_OP_GET_PROPERTIES, &req,
+			       false, &resp, NULL);
+	if (res != FPGA_OK)
+		goto out_free;
+
+	remote_reader_init(&r, resp.data, resp.len);
+	remote_get_props(&r, &p);
+	if (r.err) {
+		res = FPGA_EXCEPTION;
+		goto out_free;
+	}
+
+	_prop = opae_validate_and_lock_properties(prop);
+	if (!_prop) {
+		OPAE_ERR("Invalid properties object");
+		res = FPGA_INVALID_PARAM;
+		goto out_free;
+	}
+
+	// The parent, if any, is filled in by the API shell.
+	_prop->valid_fields = p.valid_fields &
+		~((uint64_t)1 << FPGA_PROPERTY_PARENT);
+	_prop->parent = NULL;
+
+	memcpy(_prop->guid, p.guid, sizeof(fpga_guid));
+	_prop->objtype = p.objtype;
+	_prop->segment = REMOTE_SEGMENT(t->conn->index, p.segment);
+	_prop->bus = p.bus;
+	_prop->device = p.device;
+	_prop->function = p.function;
+	_prop->socket_id = p.socket_id;
+	_prop->object_id = p.object_id;
+	_prop->vendor_id = p.vendor_id;
+	_prop->device_id = p.device_id;
+	_prop->num_errors = p.num_errors;
+	_prop->interface = p.interface;
+	_prop->subsystem_vendor_id = p.subsystem_vendor_id;
+	_prop->subsystem_device_id = p.subsystem_device_id;
+
+	if (p.objtype == FPGA_DEVICE) {
+		_prop->u.fpga.num_slots = p.num_slots;
+		_prop->u.fpga.bbs_id = p.bbs_id;
+		_prop->u.fpga.bbs_version = p.bbs_version;
+	} else {
+		_prop->u.accelerator.state = p.state;
+		_prop->u.accelerator.num_mmio = p.num_mmio;
+		_prop->u.accelerator.num_interrupts = p.num_interrupts;
+	}
+
+	opae_mutex_unlock(err, &_prop->lock);
+
+out_free:
+	remote_buf_free(&req);
+	remote_buf_free(&resp);
+	return res;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaGetProperties(fpga_token token,
+						    fpga_properties *prop)
+{
+	struct _fpga_properties *_prop = NULL;
+	fpga_result result = FPGA_OK;
+	int err;
+
+	ASSERT_NOT_NULL(prop);
+
+	result = fpgaGetProperties(NULL, (fpga_properties *)&_prop);
+	if (result)
+		return result;
+
+	if (token) {
+		result = remote_fpgaUpdateProperties(token, _prop);
+		if (result)
+			goto out_free;
+	}
+
+	*prop = (fpga_properties)_prop;
+	return result;
+
+out_free:
+	err = pthread_mutex_destroy(&_prop->lock);
+	if (err)
+		OPAE_ERR("pthread_mutex_destroy() failed");
+	opae_free(_prop);
+	return result;
+}
+
+fpga_result __REMOTE_API__
+remote_fpgaGetPropertiesFromHandle(fpga_handle handle, fpga_properties *prop)
+{
+	remote_handle *h;
+	fpga_result res;
+	int err;
+
+	ASSERT_NOT_NULL(prop);
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	res = remote_fpgaGetProperties(h->token, prop);
+
+	opae_mutex_unlock(err, &h->lock);
+
+	return res;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaOpen(fpga_token token,
+					   fpga_handle *handle,
+					   int flags)
+{
+	fpga_result res;
+	remote_token *t;
+	remote_handle *h;
+	remote_buf req;
+	remote_buf resp;
+	remote_reader r;
+	uint64_t handle_id;
+	pthread_mutexattr_t mattr;
+
+	ASSERT_NOT_NULL(token);
+	ASSERT_NOT_NULL(handle);
+
+	t = token_check(token);
+	ASSERT_NOT_NULL(t);
+
+	remote_buf_init(&req);
+	remote_buf_init(&resp);
+
+	remote_put_u64(&req, t->remote_id);
+	remote_put_u32(&req, (uint32_t)flags);
+
+	res = remote_conn_call(t->conn, REMOTE_OP_OPEN, &req, false,
+			       &resp, NULL);
+	if (res != FPGA_OK)
+		goto out_free;
+
+	remote_reader_init(&r, resp.data, resp.len);
+	handle_id = remote_get_u64(&r);
+	if (r.err) {
+		res = FPGA_EXCEPTION;
+		goto out_free;
+	}
+
+	h = opae_calloc(1, sizeof(remote_handle));
+	if (!h) {
+		OPAE_ERR("Failed to allocate memory for handle");
+		res = FPGA_NO_MEMORY;
+		goto out_close;
+	}
+
+	if (pthread_mutexattr_init(&mattr)) {
+		OPAE_ERR("Failed to init handle mutex attr");
+		res = FPGA_EXCEPTION;
+		goto out_free_handle;
+	}
+
+	if (pthread_mutexattr_settype(&mattr, PTHREAD_MUTEX_RECURSIVE) ||
+	    pthread_mutex_init(&h->lock, &mattr)) {
+		OPAE_ERR("Failed to init handle mutex");
+		pthread_mutexattr_destroy(&mattr);
+		res = FPGA_EXCEPTION;
+		goto out_free_handle;
+	}
+	pthread_mutexattr_destroy(&mattr);
+
+	h->token = clone_token(t);
+	if (!h->token) {
+		pthread_mutex_destroy(&h->lock);
+		res = FPGA_NO_MEMORY;
+		goto out_free_handle;
+	}
+
+	h->magic = REMOTE_HANDLE_MAGIC;
+	h->conn = t->conn;
+	h->remote_id = handle_id;
+
+	*handle = h;
+	goto out_free;
+
+out_free_handle:
+	opae_free(h);
+out_close:
+	req.len = 0;
+	remote_put_u64(&req, handle_id);
+	remote_conn_call(t->conn, REMOTE_OP_CLOSE, &req, false, NULL, NULL);
+out_free:
+	remote_buf_free(&req);
+	remote_buf_free(&resp);
+	return res;
+}
+
+// Called with buf_lock held.
+STATIC void remote_free_buffer(remote_conn *c, remote_buffer *b)
+{
+	if (b->shadow) {
+		opae_free(b->shadow);
+		--c->num_copy_buffers;
+	}
+
+	if (!b->preallocated)
+		munmap(b->virt, b->map_len);
+
+	opae_free(b);
+}
+
+fpga_result __REMOTE_API__ remote_fpgaClose(fpga_handle handle)
+{
+	fpga_result res;
+	remote_handle *h;
+	remote_conn *c;
+	remote_buffer **pb;
+	remote_event_handle **pe;
+	remote_buf req;
+	int err;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	c = h->conn;
+
+	remote_buf_init(&req);
+	remote_put_u64(&req, h->remote_id);
+
+	// The server releases the handle's buffers and events.
+	res = remote_handle_call(h, REMOTE_OP_CLOSE, &req, false, NULL, NULL);
+	remote_conn_take_posted(c, h->remote_id);
+
+	remote_buf_free(&req);
+
+	opae_mutex_lock(err, &c->buf_lock);
+
+	pb = &c->buffers;
+	while (*pb) {
+		remote_buffer *b = *pb;
+
+		if (b->handle_id == h->remote_id) {
+			*pb = b->next;
+			remote_free_buffer(c, b);
+		} else {
+			pb = &b->next;
+		}
+	}
+
+	pe = &c->events;
+	while (*pe) {
+		remote_event_handle *e = *pe;
+
+		if (e->handle_id == h->remote_id) {
+			*pe = e->next;
+			e->next = NULL;
+			e->conn = NULL;
+		} else {
+			pe = &e->next;
+		}
+	}
+
+	opae_mutex_unlock(err, &c->buf_lock);
+
+	opae_free(h->token);
+
+	if (pthread_mutex_unlock(&h->lock) ||
+	    pthread_mutex_destroy(&h->lock)) {
+		OPAE_ERR("error unlocking/destroying handle mutex");
+		res = FPGA_EXCEPTION;
+	}
+
+	h->magic = 0;
+	opae_free(h);
+	return res;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaReset(fpga_handle handle)
+{
+	fpga_result res;
+	remote_handle *h;
+	remote_buf req;
+	int err;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	remote_buf_init(&req);
+	remote_put_u64(&req, h->remote_id);
+
+	res = remote_handle_call(h, REMOTE_OP_RESET, &req, true,
+				 NULL, NULL);
+
+	remote_buf_free(&req);
+
+	opae_mutex_unlock(err, &h->lock);
+
+	return res;
+}
+
+STATIC fpga_result remote_read_mmio(fpga_handle handle, uint16_t op,
+				    uint32_t mmio_num, uint64_t offset,
+				    uint64_t *value)
+{
+	fpga_result res;
+	remote_handle *h;
+	remote_buf req;
+	remote_buf resp;
+	remote_reader r;
+
+	ASSERT_NOT_NULL(value);
+
+	h = handle_check(handle);
+	ASSERT_NOT_NULL(h);
+
+	remote_buf_init(&req);
+	remote_buf_init(&resp);
+
+	remote_put_u64(&req, h->remote_id);
+	remote_put_u32(&req, mmio_num);
+	remote_put_u64(&req, offset);
+
+	res = remote_handle_call(h, op, &req, false, &resp, NULL);
+	if (res == FPGA_OK) {
+		remote_reader_init(&r, resp.data, resp.len);
+		*value = remote_get_u64(&r);
+		if (r.err)
+			res = FPGA_EXCEPTION;
+	}
+
+	remote_buf_free(&req);
+	remote_buf_free(&resp);
+	return res;
+}
+
+/*
+ * MMIO writes are posted: they return once queued on the socket.
+ * Buffers are pushed first, since a write may be a doorbell telling
+ * the AFU to read them. What can be checked here is, so that the
+ * caller gets the error directly; anything else the server rejects
+ * is reported by the next call on the handle.
+ */
+STATIC fpga_result remote_write_mmio(fpga_handle handle, uint16_t op,
+				     uint32_t mmio_num, uint64_t offset,
+				     const void *value, size_t size)
+{
+	fpga_result res;
+	remote_handle *h;
+	remote_buf req;
+
+	h = handle_check(handle);
+	ASSERT_NOT_NULL(h);
+
+	if (offset % size) {
+		OPAE_ERR("MMIO offset 0x%lx not aligned to %zu bytes",
+			 offset, size);
+		return FPGA_INVALID_PARAM;
+	}
+
+	remote_buf_init(&req);
+
+	remote_put_u64(&req, h->remote_id);
+	remote_put_u32(&req, mmio_num);
+	remote_put_u64(&req, offset);
+	if (size == sizeof(uint64_t))
+		remote_put_u64(&req, *(const uint64_t *)value);
+	else
+		remote_put_bytes(&req, value, size);
+
+	res = remote_conn_post(h->conn, op, &req, true);
+
+	remote_buf_free(&req);
+	return res;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaReadMMIO64(fpga_handle handle,
+						 uint32_t mmio_num,
+						 uint64_t offset,
+						 uint64_t *value)
+{
+	return remote_read_mmio(handle, REMOTE_OP_READ_MMIO64,
+				mmio_num, offset, value);
+}
+
+fpga_result __REMOTE_API__ remote_fpgaReadMMIO32(fpga_handle handle,
+						 uint32_t mmio_num,
+						 uint64_t offset,
+						 uint32_t *value)
+{
+	fpga_result res;
+	uint64_t v = 0;
+
+	ASSERT_NOT_NULL(value);
+
+	res = remote_read_mmio(handle, REMOTE_OP_READ_MMIO32,
+			       mmio_num, offset, &v);
+	if (res == FPGA_OK)
+		*value = (uint32_t)v;
+
+	return res;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaWriteMMIO64(fpga_handle handle,
+						  uint32_t mmio_num,
+						  uint64_t offset,
+						  uint64_t value)
+{
+	return remote_write_mmio(handle, REMOTE_OP_WRITE_MMIO64,
+				 mmio_num, offset, &value, sizeof(value));
+}
+
+fpga_result __REMOTE_API__ remote_fpgaWriteMMIO32(fpga_handle handle,
+						  uint32_t mmio_num,
+						  uint64_t offset,
+						  uint32_t value)
+{
+	uint64_t v = value;
+
+	return remote_write_mmio(handle, REMOTE_OP_WRITE_MMIO32,
+				 mmio_num, offset, &v, sizeof(v));
+}
+
+fpga_result __REMOTE_API__ remote_fpgaWriteMMIO512(fpga_handle handle,
+						   uint32_t mmio_num,
+						   uint64_t offset,
+						   const void *value)
+{
+	ASSERT_NOT_NULL(value);
+
+	return remote_write_mmio(handle, REMOTE_OP_WRITE_MMIO512,
+				 mmio_num, offset, value, 64);
+}
+
+fpga_result __REMOTE_API__ remote_fpgaReadMMIOBatch(fpga_handle handle,
+						    fpga_mmio_op *ops,
+						    uint32_t num_ops)
+{
+	fpga_result res = FPGA_OK;
+	remote_handle *h;
+	remote_buf req;
+	remote_buf resp;
+	uint32_t done = 0;
+
+	ASSERT_NOT_NULL(ops);
+
+	h = handle_check(handle);
+	ASSERT_NOT_NULL(h);
+
+	remote_buf_init(&req);
+	remote_buf_init(&resp);
+
+	while (done < num_ops) {
+		uint32_t n = num_ops - done;
+		remote_reader r;
+		uint32_t i;
+
+		if (n > REMOTE_BATCH_MAX)
+			n = REMOTE_BATCH_MAX;
+
+		req.len = 0;
+		remote_put_u64(&req, h->remote_id);
+		remote_put_u32(&req, n);
+		for (i = 0 ; i < n ; ++i) {
+			remote_put_u32(&req, ops[done + i].mmio_num);
+			remote_put_u32(&req, ops[done + i].width);
+			remote_put_u64(&req, ops[done + i].offset);
+		}
+
+		res = remote_handle_call(h, REMOTE_OP_READ_MMIO_BATCH,
+					 &req, false, &resp, NULL);
+		if (res != FPGA_OK)
+			break;
+
+		remote_reader_init(&r, resp.data, resp.len);
+		for (i = 0 ; i < n ; ++i)
+			ops[done + i].value = remote_get_u64(&r);
+		if (r.err) {
+			res = FPGA_EXCEPTION;
+			break;
+		}
+
+		done += n;
+	}
+
+	remote_buf_free(&req);
+	remote_buf_free(&resp);
+	return res;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaWriteMMIOBatch(fpga_handle handle,
+						     const fpga_mmio_op *ops,
+						     uint32_t num_ops)
+{
+	fpga_result res = FPGA_OK;
+	remote_handle *h;
+	remote_buf req;
+	uint32_t done = 0;
+	uint32_t i;
+
+	ASSERT_NOT_NULL(ops);
+
+	h = handle_check(handle);
+	ASSERT_NOT_NULL(h);
+
+	for (i = 0 ; i < num_ops ; ++i) {
+		if ((ops[i].width != 32 && ops[i].width != 64) ||
+		    (ops[i].offset % (ops[i].width / 8))) {
+			OPAE_ERR("invalid MMIO op %u: width %u offset 0x%lx",
+				 i, ops[i].width, ops[i].offset);
+			return FPGA_INVALID_PARAM;
+		}
+	}
+
+	remote_buf_init(&req);
+
+	while (done < num_ops && res == FPGA_OK) {
+		uint32_t n = num_ops - done;
+		uint32_t i;
+
+		if (n > REMOTE_BATCH_MAX)
+			n = REMOTE_BATCH_MAX;
+
+		req.len = 0;
+		remote_put_u64(&req, h->remote_id);
+		remote_put_u32(&req, n);
+		for (i = 0 ; i < n ; ++i) {
+			remote_put_u32(&req, ops[done + i].mmio_num);
+			remote_put_u32(&req, ops[done + i].width);
+			remote_put_u64(&req, ops[done + i].offset);
+			remote_put_u64(&req, ops[done + i].value);
+		}
+
+		res = remote_conn_post(h->conn, REMOTE_OP_WRITE_MMIO_BATCH,
+				       &req, true);
+		done += n;
+	}
+
+	remote_buf_free(&req);
+	return res;
+}
+
+STATIC remote_buffer *find_buffer(remote_conn *c, uint64_t handle_id,
+				  uint64_t wsid)
+{
+	remote_buffer *b;
+
+	for (b = c->buffers ; b ; b = b->next) {
+		if (b->handle_id == handle_id && b->wsid == wsid)
+			return b;
+	}
+
+	return NULL;
+}
+
+STATIC void remote_release_remote(remote_handle *h, uint64_t wsid)
+{
+	remote_buf req;
+
+	remote_buf_init(&req);
+	remote_put_u64(&req, h->remote_id);
+	remote_put_u64(&req, wsid);
+
+	remote_conn_call(h->conn, REMOTE_OP_RELEASE_BUFFER, &req, false,
+			 NULL, NULL);
+
+	remote_buf_free(&req);
+}
+
+/*
+ * With a shared-memory connection the server allocates the buffer
+ * in a memfd that both processes map, so it is coherent with the
+ * device. Otherwise (and always for FPGA_BUF_PREALLOCATED) the
+ * buffer is a local mirror of the server's, kept in sync a page
+ * run at a time.
+ */
+fpga_result __REMOTE_API__ remote_fpgaPrepareBuffer(fpga_handle handle,
+						    uint64_t len,
+						    void **buf_addr,
+						    uint64_t *wsid,
+						    int flags)
+{
+	fpga_result res;
+	remote_handle *h;
+	remote_conn *c;
+	remote_buffer *b = NULL;
+	remote_buf req;
+	remote_buf resp;
+	remote_reader r;
+	uint64_t remote_wsid;
+	uint64_t iova;
+	uint64_t map_len;
+	bool shm;
+	int fd = -1;
+	int err;
+
+	if (flags & FPGA_BUF_PREALLOCATED) {
+		if (!buf_addr && !len) {
+			return FPGA_OK;
+			/* Special case: respond FPGA_OK when
+			** !buf_addr and !len as an indication that
+			** FPGA_BUF_PREALLOCATED is supported by the
+			** library.
+			*/
+		} else if (!buf_addr || !*buf_addr) {
+			OPAE_ERR("got FPGA_BUF_PREALLOCATED but NULL buf");
+			return FPGA_INVALID_PARAM;
+		}
+	}
+
+	ASSERT_NOT_NULL(buf_addr);
+	ASSERT_NOT_NULL(wsid);
+
+	if (!len) {
+		OPAE_ERR("buffer length must be non-zero");
+		return FPGA_INVALID_PARAM;
+	}
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	c = h->conn;
+	shm = c->shm && !(flags & FPGA_BUF_PREALLOCATED);
+
+	remote_buf_init(&req);
+	remote_buf_init(&resp);
+
+	remote_put_u64(&req, h->remote_id);
+	remote_put_u64(&req, len);
+	remote_put_u32(&req, (uint32_t)(flags & ~FPGA_BUF_PREALLOCATED));
+	remote_put_u32(&req, shm ? REMOTE_BUF_SHM : 0);
+
+	res = remote_conn_call(c, REMOTE_OP_PREPARE_BUFFER, &req, false,
+			       &resp, &fd);
+	if (res != FPGA_OK)
+		goto out_free;
+
+	remote_reader_init(&r, resp.data, resp.len);
+	remote_wsid = remote_get_u64(&r);
+	iova = remote_get_u64(&r);
+	map_len = remote_get_u64(&r);
+	if (r.err) {
+		OPAE_ERR("malformed buffer response from %s", c->endpoint);
+		res = FPGA_EXCEPTION;
+		goto out_free;
+	}
+
+	if (shm && (fd < 0 || map_len < len)) {
+		OPAE_ERR("malformed buffer response from %s", c->endpoint);
+		res = FPGA_EXCEPTION;
+		goto out_release;
+	}
+
+	b = opae_calloc(1, sizeof(remote_buffer));
+	if (!b) {
+		OPAE_ERR("out of memory");
+		res = FPGA_NO_MEMORY;
+		goto out_release;
+	}
+
+	b->wsid = remote_wsid;
+	b->iova = iova;
+	b->map_len = map_len;
+	b->handle_id = h->remote_id;
+	b->len = len;
+
+	if (shm) {
+		b->virt = mmap(NULL, b->map_len, PROT_READ | PROT_WRITE,
+			       MAP_SHARED, fd, 0);
+	} else if (flags & FPGA_BUF_PREALLOCATED) {
+		b->virt = (uint8_t *)*buf_addr;
+		b->preallocated = true;
+	} else {
+		b->map_len = REMOTE_PAGE_ROUND(len);
+		b->virt = mmap(NULL, b->map_len, PROT_READ | PROT_WRITE,
+			       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	}
+
+	if (b->virt == MAP_FAILED) {
+		OPAE_ERR("failed to map buffer: %s", strerror(errno));
+		b->virt = NULL;
+		res = FPGA_NO_MEMORY;
+		goto out_release;
+	}
+
+	if (!shm) {
+		// The server starts its copy zeroed, and so does the shadow.
+		b->shadow = opae_calloc(1, len);
+		if (!b->shadow) {
+			OPAE_ERR("out of memory");
+			res = FPGA_NO_MEMORY;
+			goto out_release;
+		}
+	}
+
+	opae_mutex_lock(err, &c->buf_lock);
+	b->next = c->buffers;
+	c->buffers = b;
+	if (b->shadow)
+		++c->num_copy_buffers;
+	opae_mutex_unlock(err, &c->buf_lock);
+
+	*buf_addr = b->virt;
+	*wsid = b->wsid;
+	b = NULL;
+	goto out_free;
+
+out_release:
+	remote_release_remote(h, remote_wsid);
+	if (b) {
+		if (b->virt && !b->preallocated)
+			munmap(b->virt, b->map_len);
+		opae_free(b);
+	}
+out_free:
+	if (fd >= 0)
+		opae_close(fd);
+	remote_buf_free(&req);
+	remote_buf_free(&resp);
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaReleaseBuffer(fpga_handle handle,
+						    uint64_t wsid)
+{
+	fpga_result res;
+	remote_handle *h;
+	remote_conn *c;
+	remote_buffer **pb;
+	remote_buffer *b = NULL;
+	remote_buf req;
+	int err;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	c = h->conn;
+
+	opae_mutex_lock(err, &c->buf_lock);
+	for (pb = &c->buffers ; *pb ; pb = &(*pb)->next) {
+		if ((*pb)->handle_id == h->remote_id && (*pb)->wsid == wsid) {
+			b = *pb;
+			*pb = b->next;
+			break;
+		}
+	}
+	opae_mutex_unlock(err, &c->buf_lock);
+
+	if (!b) {
+		OPAE_ERR("unknown wsid 0x%lx", wsid);
+		opae_mutex_unlock(err, &h->lock);
+		return FPGA_INVALID_PARAM;
+	}
+
+	remote_buf_init(&req);
+	remote_put_u64(&req, h->remote_id);
+	remote_put_u64(&req, wsid);
+
+	res = remote_conn_call(c, REMOTE_OP_RELEASE_BUFFER, &req, false,
+			       NULL, NULL);
+
+	remote_buf_free(&req);
+
+	opae_mutex_lock(err, &c->buf_lock);
+	remote_free_buffer(c, b);
+	opae_mutex_unlock(err, &c->buf_lock);
+
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaGetIOAddress(fpga_handle handle,
+						   uint64_t wsid,
+						   uint64_t *ioaddr)
+{
+	fpga_result res = FPGA_NOT_FOUND;
+	remote_handle *h;
+	remote_buffer *b;
+	int err;
+
+	ASSERT_NOT_NULL(ioaddr);
+
+	h = handle_check(handle);
+	ASSERT_NOT_NULL(h);
+
+	opae_mutex_lock(err, &h->conn->buf_lock);
+	b = find_buffer(h->conn, h->remote_id, wsid);
+	if (b) {
+		*ioaddr = b->iova;
+		res = FPGA_OK;
+	}
+	opae_mutex_unlock(err, &h->conn->buf_lock);
+
+	return res;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaGetBufferNumaNode(fpga_handle handle,
+							uint64_t wsid,
+							int *node)
+{
+	fpga_result res;
+	remote_handle *h;
+	remote_buf req;
+	remote_buf resp;
+	remote_reader r;
+
+	ASSERT_NOT_NULL(node);
+
+	h = handle_check(handle);
+	ASSERT_NOT_NULL(h);
+
+	remote_buf_init(&req);
+	remote_buf_init(&resp);
+
+	remote_put_u64(&req, h->remote_id);
+	remote_put_u64(&req, wsid);
+
+	res = remote_conn_call(h->conn, REMOTE_OP_GET_NUMA_NODE, &req, false,
+			       &resp, NULL);
+	if (res == FPGA_OK) {
+		remote_reader_init(&r, resp.data, resp.len);
+		*node = (int)remote_get_u32(&r);
+		if (r.err)
+			res = FPGA_EXCEPTION;
+	}
+
+	remote_buf_free(&req);
+	remote_buf_free(&resp);
+	return res;
+}
+
+fpga_result __REMOTE_API__
+remote_fpgaCreateEventHandle(fpga_event_handle *event_handle)
+{
+	remote_event_handle *eh;
+	fpga_result res = FPGA_OK;
+	pthread_mutexattr_t mattr;
+	int err = 0;
+
+	ASSERT_NOT_NULL(event_handle);
+
+	eh = (remote_event_handle *)opae_calloc(1, sizeof(*eh));
+	if (!eh) {
+		OPAE_ERR("Out of memory");
+		return FPGA_NO_MEMORY;
+	}
+
+	eh->magic = REMOTE_EVENT_HANDLE_MAGIC;
+
+	eh->fd = eventfd(0, 0);
+	if (eh->fd < 0) {
+		OPAE_ERR("eventfd : %s", strerror(errno));
+		res = FPGA_EXCEPTION;
+		goto out_free;
+	}
+
+	if (pthread_mutexattr_init(&mattr)) {
+		OPAE_MSG("Failed to init event handle mutex attr");
+		res = FPGA_EXCEPTION;
+		goto out_close;
+	}
+
+	if (pthread_mutexattr_settype(&mattr, PTHREAD_MUTEX_RECURSIVE) ||
+	    pthread_mutex_init(&eh->lock, &mattr)) {
+		OPAE_MSG("Failed to init event handle mutex");
+		res = FPGA_EXCEPTION;
+		goto out_attr_destroy;
+	}
+
+	pthread_mutexattr_destroy(&mattr);
+
+	*event_handle = (fpga_event_handle)eh;
+	return FPGA_OK;
+
+out_attr_destroy:
+	err = pthread_mutexattr_destroy(&mattr);
+	if (err)
+		OPAE_ERR("pthread_mutexattr_destroy() failed: %s",
+			 strerror(err));
+out_close:
+	opae_close(eh->fd);
+out_free:
+	opae_free(eh);
+	return res;
+}
+
+// Drop e from its connection's list. Called with e->lock held.
+STATIC void remote_detach_event(remote_event_handle *e)
+{
+	remote_conn *c = e->conn;
+	remote_event_handle **pe;
+	int err;
+
+	if (!c)
+		return;
+
+	opae_mutex_lock(err, &c->buf_lock);
+	for (pe = &c->events ; *pe ; pe = &(*pe)->next) {
+		if (*pe == e) {
+			*pe = e->next;
+			break;
+		}
+	}
+	opae_mutex_unlock(err, &c->buf_lock);
+
+	e->next = NULL;
+	e->conn = NULL;
+}
+
+fpga_result __REMOTE_API__
+remote_fpgaDestroyEventHandle(fpga_event_handle *event_handle)
+{
+	remote_event_handle *eh;
+	fpga_result res = FPGA_OK;
+	int err = 0;
+
+	ASSERT_NOT_NULL(event_handle);
+
+	eh = event_handle_check_and_lock(*event_handle);
+	ASSERT_NOT_NULL(eh);
+
+	remote_detach_event(eh);
+
+	if (opae_close(eh->fd) < 0) {
+		OPAE_ERR("eventfd close : %s", strerror(errno));
+		if (errno == EBADF)
+			res = FPGA_INVALID_PARAM;
+		else
+			res = FPGA_EXCEPTION;
+	}
+
+	eh->magic = 0;
+
+	opae_mutex_unlock(err, &eh->lock);
+
+	if (pthread_mutex_destroy(&eh->lock))
+		OPAE_ERR("pthread_mutex_destroy() failed");
+
+	opae_free(eh);
+	*event_handle = NULL;
+
+	return res;
+}
+
+fpga_result __REMOTE_API__
+remote_fpgaGetOSObjectFromEventHandle(const fpga_event_handle eh, int *fd)
+{
+	remote_event_handle *_eh;
+	int err = 0;
+
+	ASSERT_NOT_NULL(fd);
+
+	_eh = event_handle_check_and_lock(eh);
+	ASSERT_NOT_NULL(_eh);
+
+	*fd = _eh->fd;
+
+	opae_mutex_unlock(err, &_eh->lock);
+
+	return FPGA_OK;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaRegisterEvent(fpga_handle handle,
+						    fpga_event_type event_type,
+						    fpga_event_handle event_handle,
+						    uint32_t flags)
+{
+	remote_handle *h;
+	remote_event_handle *e;
+	remote_buf req;
+	fpga_result res;
+	int err;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	e = event_handle_check_and_lock(event_handle);
+	if (!e) {
+		opae_mutex_unlock(err, &h->lock);
+		return FPGA_INVALID_PARAM;
+	}
+
+	if (e->conn) {
+		OPAE_ERR("event handle is already registered");
+		res = FPGA_INVALID_PARAM;
+		goto out_unlock;
+	}
+
+	remote_buf_init(&req);
+	remote_put_u64(&req, h->remote_id);
+	remote_put_u32(&req, event_type);
+	remote_put_u32(&req, flags);
+	remote_put_u64(&req, (uint64_t)(uintptr_t)e);
+
+	res = remote_conn_call(h->conn, REMOTE_OP_REGISTER_EVENT, &req, false,
+			       NULL, NULL);
+
+	remote_buf_free(&req);
+
+	if (res == FPGA_OK) {
+		e->conn = h->conn;
+		e->handle_id = h->remote_id;
+
+		opae_mutex_lock(err, &h->conn->buf_lock);
+		e->next = h->conn->events;
+		h->conn->events = e;
+		opae_mutex_unlock(err, &h->conn->buf_lock);
+	}
+
+out_unlock:
+	opae_mutex_unlock(err, &e->lock);
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaUnregisterEvent(fpga_handle handle,
+						      fpga_event_type event_type,
+						      fpga_event_handle event_handle)
+{
+	remote_handle *h;
+	remote_event_handle *e;
+	remote_buf req;
+	fpga_result res;
+	int err;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	e = event_handle_check_and_lock(event_handle);
+	if (!e) {
+		opae_mutex_unlock(err, &h->lock);
+		return FPGA_INVALID_PARAM;
+	}
+
+	remote_buf_init(&req);
+	remote_put_u64(&req, h->remote_id);
+	remote_put_u32(&req, event_type);
+	remote_put_u64(&req, (uint64_t)(uintptr_t)e);
+
+	res = remote_conn_call(h->conn, REMOTE_OP_UNREGISTER_EVENT, &req,
+			       false, NULL, NULL);
+
+	remote_buf_free(&req);
+
+	if (res == FPGA_OK)
+		remote_detach_event(e);
+
+	opae_mutex_unlock(err, &e->lock);
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+STATIC fpga_result remote_error_call(fpga_token token, uint16_t op,
+				     bool with_num, uint32_t error_num,
+				     remote_buf *resp)
+{
+	remote_token *t;
+	remote_buf req;
+	fpga_result res;
+
+	t = token_check(token);
+	ASSERT_NOT_NULL(t);
+
+	remote_buf_init(&req);
+	remote_put_u64(&req, t->remote_id);
+	if (with_num)
+		remote_put_u32(&req, error_num);
+
+	res = remote_conn_call(t->conn, op, &req, false, resp, NULL);
+
+	remote_buf_free(&req);
+	return res;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaReadError(fpga_token token,
+						uint32_t error_num,
+						uint64_t *value)
+{
+	remote_buf resp;
+	remote_reader r;
+	fpga_result res;
+
+	ASSERT_NOT_NULL(value);
+
+	remote_buf_init(&resp);
+
+	res = remote_error_call(token, REMOTE_OP_READ_ERROR, true,
+				error_num, &resp);
+	if (res == FPGA_OK) {
+		remote_reader_init(&r, resp.data, resp.len);
+		*value = remote_get_u64(&r);
+		if (r.err)
+			res = FPGA_EXCEPTION;
+	}
+
+	remote_buf_free(&resp);
+	return res;
+}
+
+fpga_result __REMOTE_API__ remote_fpgaClearError(fpga_token token,
+						 uint32_t error_num)
+{
+	return remote_error_call(token, REMOTE_OP_CLEAR_ERROR, true,
+				 error_num, NULL);
+}
+
+fpga_result __REMOTE_API__ remote_fpgaClearAllErrors(fpga_token token)
+{
+	return remote_error_call(token, REMOTE_OP_CLEAR_ALL_ERRORS, false,
+				 0, NULL);
+}
+
+fpga_result __REMOTE_API__ remote_fpgaGetErrorInfo(fpga_token token,
+						   uint32_t error_num,
+						   struct fpga_error_info *error_info)
+{
+	remote_buf resp;
+	remote_reader r;
+	fpga_result res;
+	const uint8_t *name;
+
+	ASSERT_NOT_NULL(error_info);
+
+	remote_buf_init(&resp);
+
+	res = remote_error_call(token, REMOTE_OP_GET_ERROR_INFO, true,
+				error_num, &resp);
+	if (res == FPGA_OK) {
+		remote_reader_init(&r, resp.data, resp.len);
+		name = remote_get_bytes(&r, FPGA_ERROR_NAME_MAX);
+		error_info->can_clear = remote_get_u8(&r) != 0;
+		if (r.err) {
+			res = FPGA_EXCEPTION;
+		} else {
+			memcpy(error_info->name, name, FPGA_ERROR_NAME_MAX);
+			error_info->name[FPGA_ERROR_NAME_MAX - 1] = '\0';
+		}
+	}
+
+	remote_buf_free(&resp);
+	return res;
+}
@@ -0,0 +1,174 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifndef _OPAE_REMOTE_PLUGIN_H
+#define _OPAE_REMOTE_PLUGIN_H
+#include <pthread.h>
+#include <stdbool.h>
+
+#include <opae/fpga.h>
+
+#include "remote_proto.h"
+
+// The PCIe IDs opae.cfg uses to select this plugin. Like those of
+// libopae-sim, the plugin manager always reports them present.
+#define REMOTE_VENDOR_ID 0x8086
+#define REMOTE_DEVICE_ID 0x0a5c
+
+#define REMOTE_ENDPOINTS_MAX 16
+#define REMOTE_SYNC_USEC_DEFAULT 0
+
+// The daemon sets this in its own environment, so that a remote
+// configuration enabled on the server host cannot loop back.
+#define REMOTE_SERVER_ENV "LIBOPAE_REMOTED"
+
+/*
+ * Remote tokens keep their PCIe bus, device and function, but move
+ * to segment 0xf<E><S>, where E is the index of the endpoint in the
+ * configuration and S the low byte of the remote segment. This keeps
+ * them apart from local devices and from those of other endpoints.
+ */
+#define REMOTE_SEGMENT(__endpoint, __segment) \
+	((uint16_t)(0xf000 | (((__endpoint) & 0xf) << 8) | ((__segment) & 0xff)))
+
+typedef struct _remote_conn remote_conn;
+
+typedef struct _remote_token {
+	fpga_token_header hdr; //< Must appear at offset 0!
+	remote_conn *conn;
+	uint64_t remote_id;
+	remote_props props;
+} remote_token;
+
+typedef struct _remote_buffer {
+	uint8_t *virt;
+	uint64_t len;
+	uint64_t map_len;
+	uint64_t handle_id;
+	uint64_t wsid;
+	uint64_t iova;
+	uint8_t *shadow; //< Copy mode only: last exchanged contents.
+	bool preallocated;
+	struct _remote_buffer *next;
+} remote_buffer;
+
+typedef struct _remote_handle {
+	uint32_t magic;
+	remote_token *token;
+	remote_conn *conn;
+	uint64_t remote_id;
+	pthread_mutex_t lock;
+} remote_handle;
+
+typedef struct _remote_event_handle {
+	uint32_t magic;
+	pthread_mutex_t lock;
+	int fd;
+	remote_conn *conn; //< Set while registered.
+	uint64_t handle_id;
+	struct _remote_event_handle *next;
+} remote_event_handle;
+
+// A posted request on handle_id failed and is not yet reported.
+typedef struct _remote_posted_error {
+	uint64_t handle_id;
+	fpga_result result;
+	struct _remote_posted_error *next;
+} remote_posted_error;
+
+typedef struct _remote_call {
+	uint32_t seq;
+	bool done;
+	int32_t result;
+	remote_buf payload;
+	int fd;
+	struct _remote_call *next;
+} remote_call;
+
+struct _remote_conn {
+	char *endpoint;
+	uint32_t index;
+	int sock;
+	bool shm;
+	uint32_t sync_usec;
+
+	pthread_mutex_t send_lock; //< Guards out and the socket's writes.
+	remote_buf out;
+
+	pthread_mutex_t lock;  //< Guards the fields below.
+	pthread_cond_t cond;
+	uint32_t next_seq;
+	remote_call *calls;
+	bool dead;
+	remote_posted_error *posted_errors;
+
+	pthread_mutex_t buf_lock; //< Guards buffers and events.
+	remote_buffer *buffers;
+	uint32_t num_copy_buffers;
+	remote_event_handle *events;
+
+	remote_token *tokens;
+	uint32_t num_tokens;
+	bool enumerated;
+
+	pthread_t rx_thread;
+	bool rx_started;
+};
+
+remote_conn *remote_conn_open(const char *endpoint, uint32_t index,
+			      bool want_shm, uint32_t sync_usec,
+			      const uint8_t *token, uint32_t token_len);
+void remote_conn_close(remote_conn *c);
+
+/*
+ * Send one request and wait for its response. When push is set,
+ * copy-mode buffers are synchronized to the server first, in the
+ * same write. The response payload replaces the contents of resp
+ * (which may be NULL), and a descriptor passed with it is returned
+ * in *resp_fd (which may be NULL).
+ */
+fpga_result remote_conn_call(remote_conn *c, uint16_t op,
+			     const remote_buf *req, bool push,
+			     remote_buf *resp, int *resp_fd);
+
+/*
+ * Send one request without waiting for a response.
+ */
+fpga_result remote_conn_post(remote_conn *c, uint16_t op,
+			     const remote_buf *req, bool push);
+
+/*
+ * Return, and forget, the first failure of a posted request on
+ * handle_id since the last time this was called for it.
+ */
+fpga_result remote_conn_take_posted(remote_conn *c, uint64_t handle_id);
+
+// Push the changed pages of every copy-mode buffer.
+fpga_result remote_conn_push(remote_conn *c);
+
+int remote_parse_config(const char *json);
+int remote_connect_all(void);
+void remote_disconnect_all(void);
+#endif // _OPAE_REMOTE_PLUGIN_H
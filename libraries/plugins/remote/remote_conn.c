@@ -0,0 +1,638 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+
+#include "opae_remote.h"
+
+#include "opae_int.h"
+#include "mock/opae_std.h"
+
+/*
+ * Each connection has a receiver thread that reads every message
+ * the server sends. Responses are matched to waiting callers by
+ * sequence number, so any number of threads may have requests in
+ * flight on one connection. Unsolicited event and buffer data
+ * messages are applied as they arrive. With a nonzero sync_usec,
+ * the receiver also pushes the changed pages of copy-mode buffers
+ * at that period.
+ */
+
+STATIC uint64_t remote_now_usec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+STATIC void remote_conn_mark_dead(remote_conn *c)
+{
+	int err;
+
+	opae_mutex_lock(err, &c->lock);
+	if (!c->dead)
+		OPAE_ERR("lost connection to %s", c->endpoint);
+	c->dead = true;
+	pthread_cond_broadcast(&c->cond);
+	opae_mutex_unlock(err, &c->lock);
+}
+
+// Called with send_lock held.
+STATIC void remote_conn_queue_diffs(remote_conn *c)
+{
+	remote_buffer *b;
+	int err;
+
+	opae_mutex_lock(err, &c->buf_lock);
+	for (b = c->buffers ; b ; b = b->next) {
+		if (b->shadow)
+			remote_put_buffer_diff(&c->out, b->handle_id, b->wsid,
+					       b->virt, b->shadow, b->len);
+	}
+	opae_mutex_unlock(err, &c->buf_lock);
+}
+
+STATIC fpga_result remote_conn_send(remote_conn *c, uint16_t op,
+				    uint16_t flags, const remote_buf *req,
+				    bool push, remote_call *call)
+{
+	fpga_result res = FPGA_OK;
+	uint32_t seq = 0;
+	size_t hdr_off;
+	int err;
+
+	opae_mutex_lock(err, &c->send_lock);
+
+	c->out.len = 0;
+	c->out.err = 0;
+
+	if (push && c->num_copy_buffers)
+		remote_conn_queue_diffs(c);
+
+	// Posted requests are numbered too, so that a failure
+	// reported for one can be told apart in the log.
+	opae_mutex_lock(err, &c->lock);
+	seq = ++c->next_seq;
+	if (!seq) // 0 marks unsolicited messages.
+		seq = ++c->next_seq;
+	if (call) {
+		call->seq = seq;
+		call->next = c->calls;
+		c->calls = call;
+	}
+	opae_mutex_unlock(err, &c->lock);
+
+	hdr_off = remote_msg_begin(&c->out, op, flags, seq, 0);
+	if (req)
+		remote_put_bytes(&c->out, req->data, req->len);
+	remote_msg_end(&c->out, hdr_off);
+
+	if (c->out.err || (req && req->err))
+		res = FPGA_NO_MEMORY;
+	else if (remote_send(c->sock, c->out.data, c->out.len, -1))
+		res = FPGA_NO_DAEMON;
+
+	opae_mutex_unlock(err, &c->send_lock);
+
+	if (res != FPGA_OK && call) {
+		remote_call **pp;
+
+		opae_mutex_lock(err, &c->lock);
+		for (pp = &c->calls ; *pp ; pp = &(*pp)->next) {
+			if (*pp == call) {
+				*pp = call->next;
+				break;
+			}
+		}
+		opae_mutex_unlock(err, &c->lock);
+	}
+
+	if (res == FPGA_NO_DAEMON)
+		remote_conn_mark_dead(c);
+
+	return res;
+}
+
+fpga_result remote_conn_call(remote_conn *c, uint16_t op,
+			     const remote_buf *req, bool push,
+			     remote_buf *resp, int *resp_fd)
+{
+	remote_call call;
+	fpga_result res;
+	int err;
+
+	memset(&call, 0, sizeof(call));
+	call.fd = -1;
+
+	if (c->dead)
+		return FPGA_NO_DAEMON;
+
+	res = remote_conn_send(c, op, 0, req, push, &call);
+	if (res != FPGA_OK)
+		return res;
+
+	opae_mutex_lock(err, &c->lock);
+
+	while (!call.done && !c->dead)
+		pthread_cond_wait(&c->cond, &c->lock);
+
+	if (!call.done) {
+		remote_call **pp;
+
+		for (pp = &c->calls ; *pp ; pp = &(*pp)->next) {
+			if (*pp == &call) {
+				*pp = call.next;
+				break;
+			}
+		}
+		res = FPGA_NO_DAEMON;
+	} else {
+		res = (fpga_result)call.result;
+	}
+
+	opae_mutex_unlock(err, &c->lock);
+
+	if (resp) {
+		remote_buf_free(resp);
+		*resp = call.payload;
+	} else {
+		remote_buf_free(&call.payload);
+	}
+
+	if (resp_fd)
+		*resp_fd = call.fd;
+	else if (call.fd >= 0)
+		opae_close(call.fd);
+
+	return res;
+}
+
+fpga_result remote_conn_post(remote_conn *c, uint16_t op,
+			     const remote_buf *req, bool push)
+{
+	if (c->dead)
+		return FPGA_NO_DAEMON;
+
+	return remote_conn_send(c, op, REMOTE_F_POSTED, req, push, NULL);
+}
+
+fpga_result remote_conn_take_posted(remote_conn *c, uint64_t handle_id)
+{
+	remote_posted_error **pp;
+	fpga_result res = FPGA_OK;
+	int err;
+
+	opae_mutex_lock(err, &c->lock);
+
+	for (pp = &c->posted_errors ; *pp ; pp = &(*pp)->next) {
+		remote_posted_error *e = *pp;
+
+		if (e->handle_id == handle_id) {
+			*pp = e->next;
+			res = e->result;
+			opae_free(e);
+			break;
+		}
+	}
+
+	opae_mutex_unlock(err, &c->lock);
+
+	return res;
+}
+
+// Called with send_lock held.
+STATIC fpga_result remote_conn_push_locked(remote_conn *c)
+{
+	fpga_result res = FPGA_OK;
+
+	c->out.len = 0;
+	c->out.err = 0;
+
+	remote_conn_queue_diffs(c);
+
+	if (c->out.err)
+		res = FPGA_NO_MEMORY;
+	else if (c->out.len &&
+		 remote_send(c->sock, c->out.data, c->out.len, -1))
+		res = FPGA_NO_DAEMON;
+
+	if (res == FPGA_NO_DAEMON)
+		remote_conn_mark_dead(c);
+
+	return res;
+}
+
+fpga_result remote_conn_push(remote_conn *c)
+{
+	fpga_result res;
+	int err;
+
+	if (c->dead)
+		return FPGA_NO_DAEMON;
+
+	opae_mutex_lock(err, &c->send_lock);
+	res = remote_conn_push_locked(c);
+	opae_mutex_unlock(err, &c->send_lock);
+
+	return res;
+}
+
+STATIC void remote_conn_event(remote_conn *c, const remote_buf *msg)
+{
+	remote_event_handle *e;
+	remote_reader r;
+	uint64_t id;
+	uint64_t count;
+	int err;
+
+	remote_reader_init(&r, msg->data, msg->len);
+	id = remote_get_u64(&r);
+	count = remote_get_u64(&r);
+	if (r.err)
+		return;
+
+	opae_mutex_lock(err, &c->buf_lock);
+	for (e = c->events ; e ; e = e->next) {
+		if ((uint64_t)(uintptr_t)e == id) {
+			if (write(e->fd, &count, sizeof(count)) < 0)
+				OPAE_ERR("failed to signal event: %s",
+					 strerror(errno));
+			break;
+		}
+	}
+	opae_mutex_unlock(err, &c->buf_lock);
+}
+
+STATIC void remote_conn_buffer_data(remote_conn *c, const remote_buf *msg)
+{
+	remote_buffer *b;
+	remote_reader r;
+	uint64_t handle_id;
+	uint64_t wsid;
+	uint64_t offset;
+	uint32_t len;
+	const uint8_t *data;
+	int err;
+
+	remote_reader_init(&r, msg->data, msg->len);
+	handle_id = remote_get_u64(&r);
+	wsid = remote_get_u64(&r);
+	offset = remote_get_u64(&r);
+	len = remote_get_u32(&r);
+	data = remote_get_bytes(&r, len);
+	if (r.err)
+		return;
+
+	opae_mutex_lock(err, &c->buf_lock);
+	for (b = c->buffers ; b ; b = b->next) {
+		if (b->handle_id == handle_id && b->wsid == wsid) {
+			if (b->shadow && offset <= b->len &&
+			    len <= b->len - offset)
+				remote_merge_buffer(b->virt + offset,
+						    b->shadow + offset,
+						    data, len);
+			break;
+		}
+	}
+	opae_mutex_unlock(err, &c->buf_lock);
+}
+
+// Called with lock held. Keeps the first failure per handle.
+STATIC void remote_conn_posted_failed(remote_conn *c,
+				      const remote_msg_hdr *h,
+				      const remote_buf *msg)
+{
+	remote_posted_error *e;
+	remote_reader r;
+	uint64_t handle_id;
+
+	OPAE_ERR("posted request %u (op %u) failed on %s: %s",
+		 h->seq, h->op, c->endpoint,
+		 fpgaErrStr((fpga_result)h->result));
+
+	remote_reader_init(&r, msg->data, msg->len);
+	handle_id = remote_get_u64(&r);
+	if (r.err)
+		return;
+
+	for (e = c->posted_errors ; e ; e = e->next) {
+		if (e->handle_id == handle_id)
+			return;
+	}
+
+	e = opae_malloc(sizeof(remote_posted_error));
+	if (!e) {
+		OPAE_ERR("out of memory");
+		return;
+	}
+
+	e->handle_id = handle_id;
+	e->result = (fpga_result)h->result;
+	e->next = c->posted_errors;
+	c->posted_errors = e;
+}
+
+// Returns true when the call took ownership of fd.
+STATIC bool remote_conn_complete(remote_conn *c, const remote_msg_hdr *h,
+				 remote_buf *msg, int fd)
+{
+	remote_call **pp;
+	bool taken = false;
+	int err;
+
+	opae_mutex_lock(err, &c->lock);
+
+	for (pp = &c->calls ; *pp ; pp = &(*pp)->next) {
+		remote_call *call = *pp;
+
+		if (call->seq == h->seq) {
+			remote_buf tmp = call->payload;
+
+			*pp = call->next;
+			call->result = h->result;
+			call->payload = *msg;
+			*msg = tmp;
+			call->fd = fd;
+			call->done = true;
+			taken = true;
+			pthread_cond_broadcast(&c->cond);
+			break;
+		}
+	}
+
+	if (!taken && (h->flags & REMOTE_F_POSTED))
+		remote_conn_posted_failed(c, h, msg);
+
+	opae_mutex_unlock(err, &c->lock);
+
+	return taken;
+}
+
+STATIC void *remote_conn_rx(void *arg)
+{
+	remote_conn *c = (remote_conn *)arg;
+	uint64_t last_push = remote_now_usec();
+	remote_buf msg;
+
+	remote_buf_init(&msg);
+
+	while (1) {
+		struct pollfd pfd;
+		remote_msg_hdr h;
+		bool syncing;
+		int timeout = -1;
+		int fd = -1;
+		int res;
+
+		syncing = c->sync_usec && c->num_copy_buffers;
+		if (syncing)
+			timeout = (c->sync_usec + 999) / 1000;
+
+		pfd.fd = c->sock;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+
+		res = poll(&pfd, 1, timeout);
+		if (res < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+
+		if (res > 0) {
+			if (remote_recv(c->sock, &h, &msg, &fd))
+				break;
+
+			switch (h.op) {
+			case REMOTE_OP_EVENT:
+				remote_conn_event(c, &msg);
+				break;
+			case REMOTE_OP_BUFFER_DATA:
+				remote_conn_buffer_data(c, &msg);
+				break;
+			default:
+				if (remote_conn_complete(c, &h, &msg, fd))
+					fd = -1;
+				break;
+			}
+
+			if (fd >= 0)
+				opae_close(fd);
+		}
+
+		// Never block on send_lock here: a sender stalled on a
+		// full socket waits for this thread to drain the other
+		// direction.
+		if (syncing &&
+		    remote_now_usec() - last_push >= c->sync_usec &&
+		    !pthread_mutex_trylock(&c->send_lock)) {
+			remote_conn_push_locked(c);
+			pthread_mutex_unlock(&c->send_lock);
+			last_push = remote_now_usec();
+		}
+	}
+
+	remote_conn_mark_dead(c);
+	remote_buf_free(&msg);
+	return NULL;
+}
+
+STATIC fpga_result remote_conn_hello(remote_conn *c, bool want_shm,
+				     const uint8_t *token, uint32_t token_len)
+{
+	remote_buf req;
+	remote_buf resp;
+	remote_reader r;
+	fpga_result res;
+	uint32_t version;
+	uint32_t caps;
+
+	remote_buf_init(&req);
+	remote_buf_init(&resp);
+
+	remote_put_u32(&req, REMOTE_PROTO_MAGIC);
+	remote_put_u32(&req, REMOTE_PROTO_VERSION);
+	remote_put_u32(&req, want_shm ? REMOTE_CAP_SHM : 0);
+	remote_put_u32(&req, c->sync_usec);
+	remote_put_u32(&req, token_len);
+	remote_put_bytes(&req, token, token_len);
+
+	res = remote_conn_call(c, REMOTE_OP_HELLO, &req, false, &resp, NULL);
+	if (res == FPGA_NO_ACCESS)
+		OPAE_ERR("%s refused the connection: check \"token_file\"",
+			 c->endpoint);
+	if (res != FPGA_OK)
+		goto out_free;
+
+	remote_reader_init(&r, resp.data, resp.len);
+	version = remote_get_u32(&r);
+	caps = remote_get_u32(&r);
+
+	if (r.err || version != REMOTE_PROTO_VERSION) {
+		OPAE_ERR("%s speaks protocol version %u, not %u",
+			 c->endpoint, version, REMOTE_PROTO_VERSION);
+		res = FPGA_NOT_SUPPORTED;
+		goto out_free;
+	}
+
+	c->shm = (caps & REMOTE_CAP_SHM) != 0;
+
+out_free:
+	remote_buf_free(&req);
+	remote_buf_free(&resp);
+	return res;
+}
+
+remote_conn *remote_conn_open(const char *endpoint, uint32_t index,
+			      bool want_shm, uint32_t sync_usec,
+			      const uint8_t *token, uint32_t token_len)
+{
+	remote_conn *c;
+	bool is_unix = false;
+
+	c = opae_calloc(1, sizeof(remote_conn));
+	if (!c) {
+		OPAE_ERR("out of memory");
+		return NULL;
+	}
+
+	c->endpoint = opae_strdup(endpoint);
+	c->index = index;
+	c->sync_usec = sync_usec;
+	remote_buf_init(&c->out);
+
+	if (!c->endpoint) {
+		OPAE_ERR("out of memory");
+		goto out_free;
+	}
+
+	c->sock = remote_connect(endpoint, &is_unix);
+	if (c->sock < 0)
+		goto out_free;
+
+	if (pthread_mutex_init(&c->send_lock, NULL) ||
+	    pthread_mutex_init(&c->lock, NULL) ||
+	    pthread_mutex_init(&c->buf_lock, NULL) ||
+	    pthread_cond_init(&c->cond, NULL)) {
+		OPAE_ERR("failed to init connection locks");
+		goto out_close;
+	}
+
+	if (pthread_create(&c->rx_thread, NULL, remote_conn_rx, c)) {
+		OPAE_ERR("failed to start receiver for %s", endpoint);
+		goto out_close;
+	}
+	c->rx_started = true;
+
+	// Buffers are shared only with a server on this host.
+	if (remote_conn_hello(c, want_shm && is_unix,
+			      token, token_len) != FPGA_OK)
+		goto out_conn_close;
+
+	OPAE_DBG("connected to %s%s", endpoint,
+		 c->shm ? " (shared-memory buffers)" : "");
+	return c;
+
+out_conn_close:
+	remote_conn_close(c);
+	return NULL;
+
+out_close:
+	opae_close(c->sock);
+out_free:
+	if (c->endpoint)
+		opae_free(c->endpoint);
+	opae_free(c);
+	return NULL;
+}
+
+void remote_conn_close(remote_conn *c)
+{
+	remote_buffer *b;
+	uint32_t i;
+	int err;
+
+	// Going away on purpose is not a lost connection.
+	opae_mutex_lock(err, &c->lock);
+	c->dead = true;
+	opae_mutex_unlock(err, &c->lock);
+
+	if (c->rx_started) {
+		shutdown(c->sock, SHUT_RDWR);
+		pthread_join(c->rx_thread, NULL);
+	}
+	opae_close(c->sock);
+
+	while (c->buffers) {
+		b = c->buffers;
+		c->buffers = b->next;
+		if (!b->preallocated)
+			munmap(b->virt, b->map_len);
+		if (b->shadow)
+			opae_free(b->shadow);
+		opae_free(b);
+	}
+
+	// Registered event handles stay valid; they just never fire.
+	while (c->events) {
+		remote_event_handle *e = c->events;
+		c->events = e->next;
+		e->next = NULL;
+		e->conn = NULL;
+	}
+
+	for (i = 0 ; i < c->num_tokens ; ++i)
+		c->tokens[i].hdr.magic = 0;
+	if (c->tokens)
+		opae_free(c->tokens);
+
+	while (c->posted_errors) {
+		remote_posted_error *e = c->posted_errors;
+		c->posted_errors = e->next;
+		opae_free(e);
+	}
+
+	remote_buf_free(&c->out);
+
+	pthread_cond_destroy(&c->cond);
+	pthread_mutex_destroy(&c->buf_lock);
+	pthread_mutex_destroy(&c->lock);
+	pthread_mutex_destroy(&c->send_lock);
+
+	opae_free(c->endpoint);
+	opae_free(c);
+}
@@ -0,0 +1,813 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif // _GNU_SOURCE
+#include <endian.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <opae/properties.h>
+
+#include "remote_proto.h"
+
+#include "opae_int.h"
+#include "props.h"
+#include "mock/opae_std.h"
+
+#define REMOTE_PAGE_SIZE 4096
+
+void remote_buf_init(remote_buf *b)
+{
+	memset(b, 0, sizeof(*b));
+}
+
+void remote_buf_free(remote_buf *b)
+{
+	if (b->data)
+		opae_free(b->data);
+	memset(b, 0, sizeof(*b));
+}
+
+uint8_t *remote_buf_reserve(remote_buf *b, size_t n)
+{
+	uint8_t *p;
+
+	if (b->err)
+		return NULL;
+
+	if (b->len + n > b->cap) {
+		size_t cap = b->cap ? b->cap : 256;
+
+		while (cap < b->len + n)
+			cap *= 2;
+
+		p = opae_malloc(cap);
+		if (!p) {
+			OPAE_ERR("out of memory");
+			b->err = ENOMEM;
+			return NULL;
+		}
+
+		if (b->data) {
+			memcpy(p, b->data, b->len);
+			opae_free(b->data);
+		}
+		b->data = p;
+		b->cap = cap;
+	}
+
+	p = b->data + b->len;
+	b->len += n;
+	return p;
+}
+
+void remote_put_u8(remote_buf *b, uint8_t v)
+{
+	uint8_t *p = remote_buf_reserve(b, sizeof(v));
+	if (p)
+		*p = v;
+}
+
+void remote_put_u16(remote_buf *b, uint16_t v)
+{
+	uint8_t *p = remote_buf_reserve(b, sizeof(v));
+	if (p) {
+		v = htole16(v);
+		memcpy(p, &v, sizeof(v));
+	}
+}
+
+void remote_put_u32(remote_buf *b, uint32_t v)
+{
+	uint8_t *p = remote_buf_reserve(b, sizeof(v));
+	if (p) {
+		v = htole32(v);
+		memcpy(p, &v, sizeof(v));
+	}
+}
+
+void remote_put_u64(remote_buf *b, uint64_t v)
+{
+	uint8_t *p = remote_buf_reserve(b, sizeof(v));
+	if (p) {
+		v = htole64(v);
+		memcpy(p, &v, sizeof(v));
+	}
+}
+
+void remote_put_bytes(remote_buf *b, const void *data, size_t n)
+{
+	uint8_t *p = remote_buf_reserve(b, n);
+	if (p && n)
+		memcpy(p, data, n);
+}
+
+size_t remote_msg_begin(remote_buf *b, uint16_t op, uint16_t flags,
+			uint32_t seq, int32_t result)
+{
+	size_t hdr_off = b->len;
+
+	remote_put_u32(b, 0);
+	remote_put_u16(b, op);
+	remote_put_u16(b, flags);
+	remote_put_u32(b, seq);
+	remote_put_u32(b, (uint32_t)result);
+
+	return hdr_off;
+}
+
+void remote_msg_end(remote_buf *b, size_t hdr_off)
+{
+	uint32_t len;
+
+	if (b->err)
+		return;
+
+	len = htole32((uint32_t)(b->len - hdr_off - REMOTE_HDR_SIZE));
+	memcpy(b->data + hdr_off, &len, sizeof(len));
+}
+
+void remote_reader_init(remote_reader *r, const void *p, size_t len)
+{
+	r->p = (const uint8_t *)p;
+	r->left = len;
+	r->err = 0;
+}
+
+const uint8_t *remote_get_bytes(remote_reader *r, size_t n)
+{
+	const uint8_t *p;
+
+	if (r->err || r->left < n) {
+		r->err = EBADMSG;
+		return NULL;
+	}
+
+	p = r->p;
+	r->p += n;
+	r->left -= n;
+	return p;
+}
+
+uint8_t remote_get_u8(remote_reader *r)
+{
+	const uint8_t *p = remote_get_bytes(r, 1);
+	return p ? *p : 0;
+}
+
+uint16_t remote_get_u16(remote_reader *r)
+{
+	const uint8_t *p = remote_get_bytes(r, 2);
+	uint16_t v = 0;
+
+	if (p)
+		memcpy(&v, p, sizeof(v));
+	return le16toh(v);
+}
+
+uint32_t remote_get_u32(remote_reader *r)
+{
+	const uint8_t *p = remote_get_bytes(r, 4);
+	uint32_t v = 0;
+
+	if (p)
+		memcpy(&v, p, sizeof(v));
+	return le32toh(v);
+}
+
+uint64_t remote_get_u64(remote_reader *r)
+{
+	const uint8_t *p = remote_get_bytes(r, 8);
+	uint64_t v = 0;
+
+	if (p)
+		memcpy(&v, p, sizeof(v));
+	return le64toh(v);
+}
+
+void remote_decode_hdr(const uint8_t raw[REMOTE_HDR_SIZE], remote_msg_hdr *h)
+{
+	remote_reader r;
+
+	remote_reader_init(&r, raw, REMOTE_HDR_SIZE);
+	h->len = remote_get_u32(&r);
+	h->op = remote_get_u16(&r);
+	h->flags = remote_get_u16(&r);
+	h->seq = remote_get_u32(&r);
+	h->result = (int32_t)remote_get_u32(&r);
+}
+
+void remote_put_props(remote_buf *b, const remote_props *p)
+{
+	remote_put_u64(b, p->valid_fields);
+	remote_put_bytes(b, p->guid, sizeof(fpga_guid));
+	remote_put_u32(b, p->objtype);
+	remote_put_u16(b, p->segment);
+	remote_put_u8(b, p->bus);
+	remote_put_u8(b, p->device);
+	remote_put_u8(b, p->function);
+	remote_put_u8(b, p->socket_id);
+	remote_put_u64(b, p->object_id);
+	remote_put_u16(b, p->vendor_id);
+	remote_put_u16(b, p->device_id);
+	remote_put_u32(b, p->num_errors);
+	remote_put_u32(b, p->interface);
+	remote_put_u16(b, p->subsystem_vendor_id);
+	remote_put_u16(b, p->subsystem_device_id);
+
+	if (p->objtype == FPGA_DEVICE) {
+		remote_put_u32(b, p->num_slots);
+		remote_put_u64(b, p->bbs_id);
+		remote_put_u8(b, p->bbs_version.major);
+		remote_put_u8(b, p->bbs_version.minor);
+		remote_put_u16(b, p->bbs_version.patch);
+	} else {
+		remote_put_u32(b, p->state);
+		remote_put_u32(b, p->num_mmio);
+		remote_put_u32(b, p->num_interrupts);
+	}
+}
+
+void remote_get_props(remote_reader *r, remote_props *p)
+{
+	const uint8_t *guid;
+
+	memset(p, 0, sizeof(*p));
+
+	p->valid_fields = remote_get_u64(r);
+	guid = remote_get_bytes(r, sizeof(fpga_guid));
+	if (guid)
+		memcpy(p->guid, guid, sizeof(fpga_guid));
+	p->objtype = (fpga_objtype)remote_get_u32(r);
+	p->segment = remote_get_u16(r);
+	p->bus = remote_get_u8(r);
+	p->device = remote_get_u8(r);
+	p->function = remote_get_u8(r);
+	p->socket_id = remote_get_u8(r);
+	p->object_id = remote_get_u64(r);
+	p->vendor_id = remote_get_u16(r);
+	p->device_id = remote_get_u16(r);
+	p->num_errors = remote_get_u32(r);
+	p->interface = (fpga_interface)remote_get_u32(r);
+	p->subsystem_vendor_id = remote_get_u16(r);
+	p->subsystem_device_id = remote_get_u16(r);
+
+	if (p->objtype == FPGA_DEVICE) {
+		p->num_slots = remote_get_u32(r);
+		p->bbs_id = remote_get_u64(r);
+		p->bbs_version.major = remote_get_u8(r);
+		p->bbs_version.minor = remote_get_u8(r);
+		p->bbs_version.patch = remote_get_u16(r);
+	} else {
+		p->state = (fpga_accelerator_state)remote_get_u32(r);
+		p->num_mmio = remote_get_u32(r);
+		p->num_interrupts = remote_get_u32(r);
+	}
+}
+
+#define GET_FIELD(__field, __getter, __member) \
+do { \
+	if (__getter(prop, &p->__member) == FPGA_OK) \
+		SET_FIELD_VALID(p, __field); \
+} while (0)
+
+void remote_props_from_properties(fpga_properties prop, remote_props *p)
+{
+	memset(p, 0, sizeof(*p));
+
+	GET_FIELD(FPGA_PROPERTY_OBJTYPE, fpgaPropertiesGetObjectType, objtype);
+	GET_FIELD(FPGA_PROPERTY_SEGMENT, fpgaPropertiesGetSegment, segment);
+	GET_FIELD(FPGA_PROPERTY_BUS, fpgaPropertiesGetBus, bus);
+	GET_FIELD(FPGA_PROPERTY_DEVICE, fpgaPropertiesGetDevice, device);
+	GET_FIELD(FPGA_PROPERTY_FUNCTION, fpgaPropertiesGetFunction, function);
+	GET_FIELD(FPGA_PROPERTY_SOCKETID, fpgaPropertiesGetSocketID, socket_id);
+	GET_FIELD(FPGA_PROPERTY_VENDORID, fpgaPropertiesGetVendorID, vendor_id);
+	GET_FIELD(FPGA_PROPERTY_DEVICEID, fpgaPropertiesGetDeviceID, device_id);
+	GET_FIELD(FPGA_PROPERTY_GUID, fpgaPropertiesGetGUID, guid);
+	GET_FIELD(FPGA_PROPERTY_OBJECTID, fpgaPropertiesGetObjectID, object_id);
+	GET_FIELD(FPGA_PROPERTY_NUM_ERRORS, fpgaPropertiesGetNumErrors,
+		  num_errors);
+	GET_FIELD(FPGA_PROPERTY_INTERFACE, fpgaPropertiesGetInterface,
+		  interface);
+	GET_FIELD(FPGA_PROPERTY_SUB_VENDORID,
+		  fpgaPropertiesGetSubsystemVendorID, subsystem_vendor_id);
+	GET_FIELD(FPGA_PROPERTY_SUB_DEVICEID,
+		  fpgaPropertiesGetSubsystemDeviceID, subsystem_device_id);
+
+	if (p->objtype == FPGA_DEVICE) {
+		GET_FIELD(FPGA_PROPERTY_NUM_SLOTS, fpgaPropertiesGetNumSlots,
+			  num_slots);
+		GET_FIELD(FPGA_PROPERTY_BBSID, fpgaPropertiesGetBBSID, bbs_id);
+		GET_FIELD(FPGA_PROPERTY_BBSVERSION, fpgaPropertiesGetBBSVersion,
+			  bbs_version);
+	} else {
+		GET_FIELD(FPGA_PROPERTY_ACCELERATOR_STATE,
+			  fpgaPropertiesGetAcceleratorState, state);
+		GET_FIELD(FPGA_PROPERTY_NUM_MMIO, fpgaPropertiesGetNumMMIO,
+			  num_mmio);
+		GET_FIELD(FPGA_PROPERTY_NUM_INTERRUPTS,
+			  fpgaPropertiesGetNumInterrupts, num_interrupts);
+	}
+}
+
+size_t remote_put_buffer_diff(remote_buf *b, uint64_t handle_id,
+			      uint64_t wsid, const uint8_t *buf,
+			      uint8_t *shadow, size_t len)
+{
+	size_t queued = 0;
+	size_t offset = 0;
+
+	while (offset < len) {
+		size_t run;
+		size_t hdr_off;
+
+		// Find the next page that differs.
+		run = len - offset < REMOTE_PAGE_SIZE ?
+			len - offset : REMOTE_PAGE_SIZE;
+		if (!memcmp(buf + offset, shadow + offset, run)) {
+			offset += run;
+			continue;
+		}
+
+		// Extend the run over the following changed pages.
+		while ((offset + run < len) && (run < REMOTE_DATA_CHUNK)) {
+			size_t n = len - (offset + run);
+
+			if (n > REMOTE_PAGE_SIZE)
+				n = REMOTE_PAGE_SIZE;
+			if (!memcmp(buf + offset + run,
+				    shadow + offset + run, n))
+				break;
+			run += n;
+		}
+
+		// Snapshot into the shadow first, so that what is sent
+		// is exactly what the shadow records as exchanged.
+		memcpy(shadow + offset, buf + offset, run);
+
+		hdr_off = remote_msg_begin(b, REMOTE_OP_BUFFER_DATA,
+					   REMOTE_F_POSTED, 0, 0);
+		remote_put_u64(b, handle_id);
+		remote_put_u64(b, wsid);
+		remote_put_u64(b, offset);
+		remote_put_u32(b, (uint32_t)run);
+		remote_put_bytes(b, shadow + offset, run);
+		remote_msg_end(b, hdr_off);
+
+		queued += run;
+		offset += run;
+	}
+
+	return queued;
+}
+
+void remote_merge_buffer(volatile uint8_t *buf, uint8_t *shadow,
+			 const uint8_t *data, size_t len)
+{
+	size_t i;
+
+	for (i = 0 ; i + sizeof(uint64_t) <= len ; i += sizeof(uint64_t)) {
+		uint64_t d;
+		uint64_t s;
+
+		memcpy(&d, data + i, sizeof(d));
+		memcpy(&s, shadow + i, sizeof(s));
+		if (d != s) {
+			memcpy((uint8_t *)buf + i, &d, sizeof(d));
+			memcpy(shadow + i, &d, sizeof(d));
+		}
+	}
+
+	for ( ; i < len ; ++i) {
+		if (data[i] != shadow[i]) {
+			buf[i] = data[i];
+			shadow[i] = data[i];
+		}
+	}
+}
+
+int remote_read_token(const char *path, uint8_t token[REMOTE_TOKEN_MAX],
+		      uint32_t *len)
+{
+	uint8_t buf[REMOTE_TOKEN_MAX + 2];
+	struct stat st;
+	size_t n = 0;
+	int res = -1;
+	int fd;
+
+	fd = opae_open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		OPAE_ERR("failed to open token file %s: %s",
+			 path, strerror(errno));
+		return -1;
+	}
+
+	if (fstat(fd, &st)) {
+		OPAE_ERR("fstat(%s) failed: %s", path, strerror(errno));
+		goto out_close;
+	}
+
+	if (st.st_mode & (S_IRWXG | S_IRWXO)) {
+		OPAE_ERR("token file %s is accessible to other users", path);
+		goto out_close;
+	}
+
+	while (n < sizeof(buf)) {
+		ssize_t r = opae_read(fd, buf + n, sizeof(buf) - n);
+
+		if (r < 0 && errno == EINTR)
+			continue;
+		if (r < 0) {
+			OPAE_ERR("failed to read %s: %s",
+				 path, strerror(errno));
+			goto out_close;
+		}
+		if (!r)
+			break;
+		n += r;
+	}
+
+	while (n && (buf[n - 1] == '\n' || buf[n - 1] == '\r'))
+		--n;
+
+	if (!n || n > REMOTE_TOKEN_MAX) {
+		OPAE_ERR("the token in %s must be 1 to %d bytes",
+			 path, REMOTE_TOKEN_MAX);
+		goto out_close;
+	}
+
+	memcpy(token, buf, n);
+	*len = (uint32_t)n;
+	res = 0;
+
+out_close:
+	memset(buf, 0, sizeof(buf));
+	opae_close(fd);
+	return res;
+}
+
+bool remote_token_equal(const uint8_t *expected, uint32_t expected_len,
+			const uint8_t *token, uint32_t len)
+{
+	uint8_t diff = (expected_len != len);
+	uint32_t i;
+
+	for (i = 0 ; i < expected_len ; ++i)
+		diff |= expected[i] ^ (i < len ? token[i] : 0);
+
+	return !diff;
+}
+
+STATIC int remote_parse_endpoint(const char *endpoint,
+				 char *path, size_t path_len,
+				 char *host, size_t host_len,
+				 char *port, size_t port_len)
+{
+	const char *colon;
+	size_t n;
+
+	if (!strncmp(endpoint, "unix:", 5))
+		endpoint += 5;
+	else if (!strncmp(endpoint, "tcp:", 4))
+		goto tcp;
+
+	n = strnlen(endpoint, path_len);
+	if (!n || n >= path_len) {
+		OPAE_ERR("invalid UNIX socket path \"%s\"", endpoint);
+		return -1;
+	}
+	memcpy(path, endpoint, n + 1);
+	return 0;
+
+tcp:
+	endpoint += 4;
+
+	// [v6addr]:port, host:port or :port (any address)
+	if (*endpoint == '[') {
+		const char *end = strchr(endpoint, ']');
+
+		if (!end || end[1] != ':')
+			goto out_invalid;
+		n = end - (endpoint + 1);
+		if (n >= host_len)
+			goto out_invalid;
+		memcpy(host, endpoint + 1, n);
+		host[n] = '\0';
+		colon = end + 1;
+	} else {
+		colon = strrchr(endpoint, ':');
+		if (!colon)
+			goto out_invalid;
+		n = colon - endpoint;
+		if (n >= host_len)
+			goto out_invalid;
+		memcpy(host, endpoint, n);
+		host[n] = '\0';
+	}
+
+	n = strnlen(colon + 1, port_len);
+	if (!n || n >= port_len)
+		goto out_invalid;
+	memcpy(port, colon + 1, n + 1);
+	return 1;
+
+out_invalid:
+	OPAE_ERR("invalid TCP endpoint \"tcp:%s\"", endpoint);
+	return -1;
+}
+
+STATIC int remote_tcp_socket(const char *host, const char *port, bool server)
+{
+	struct addrinfo hints;
+	struct addrinfo *res = NULL;
+	struct addrinfo *ai;
+	int sock = -1;
+	int one = 1;
+	int err;
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = server ? AI_PASSIVE : 0;
+
+	err = getaddrinfo(*host ? host : NULL, port, &hints, &res);
+	if (err) {
+		OPAE_ERR("getaddrinfo(%s:%s): %s", host, port,
+			 gai_strerror(err));
+		return -1;
+	}
+
+	for (ai = res ; ai ; ai = ai->ai_next) {
+		sock = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC,
+			      ai->ai_protocol);
+		if (sock < 0)
+			continue;
+
+		if (server) {
+			setsockopt(sock, SOL_SOCKET, SO_REUSEADDR,
+				   &one, sizeof(one));
+			if (!bind(sock, ai->ai_addr, ai->ai_addrlen) &&
+			    !listen(sock, SOMAXCONN))
+				break;
+		} else if (!connect(sock, ai->ai_addr, ai->ai_addrlen)) {
+			// Requests are small and latency bound.
+			setsockopt(sock, IPPROTO_TCP, TCP_NODELAY,
+				   &one, sizeof(one));
+			break;
+		}
+
+		opae_close(sock);
+		sock = -1;
+	}
+
+	freeaddrinfo(res);
+
+	if (sock < 0)
+		OPAE_ERR("failed to %s tcp:%s:%s",
+			 server ? "listen on" : "connect to", host, port);
+	return sock;
+}
+
+STATIC int remote_unix_socket(const char *path, bool server)
+{
+	struct sockaddr_un addr;
+	int sock;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		OPAE_ERR("socket path too long: %s", path);
+		return -1;
+	}
+	strcpy(addr.sun_path, path);
+
+	sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (sock < 0) {
+		OPAE_ERR("socket() failed: %s", strerror(errno));
+		return -1;
+	}
+
+	if (server) {
+		unlink(path);
+		if (!bind(sock, (struct sockaddr *)&addr, sizeof(addr)) &&
+		    !listen(sock, SOMAXCONN))
+			return sock;
+	} else if (!connect(sock, (struct sockaddr *)&addr, sizeof(addr))) {
+		return sock;
+	}
+
+	OPAE_ERR("failed to %s %s: %s",
+		 server ? "listen on" : "connect to", path, strerror(errno));
+	opae_close(sock);
+	return -1;
+}
+
+int remote_connect(const char *endpoint, bool *is_unix)
+{
+	char path[108];
+	char host[256];
+	char port[16];
+	int kind;
+
+	kind = remote_parse_endpoint(endpoint, path, sizeof(path),
+				     host, sizeof(host), port, sizeof(port));
+	if (kind < 0)
+		return -1;
+
+	*is_unix = (kind == 0);
+
+	return kind ? remote_tcp_socket(host, port, false) :
+		      remote_unix_socket(path, false);
+}
+
+int remote_listen(const char *endpoint)
+{
+	char path[108];
+	char host[256];
+	char port[16];
+	int kind;
+
+	kind = remote_parse_endpoint(endpoint, path, sizeof(path),
+				     host, sizeof(host), port, sizeof(port));
+	if (kind < 0)
+		return -1;
+
+	return kind ? remote_tcp_socket(host, port, true) :
+		      remote_unix_socket(path, true);
+}
+
+int remote_send(int sock, const void *data, size_t len, int pass_fd)
+{
+	const uint8_t *p = (const uint8_t *)data;
+	char cbuf[CMSG_SPACE(sizeof(int))];
+
+	while (len) {
+		struct msghdr mh;
+		struct iovec iov;
+		ssize_t n;
+
+		iov.iov_base = (void *)p;
+		iov.iov_len = len;
+
+		memset(&mh, 0, sizeof(mh));
+		mh.msg_iov = &iov;
+		mh.msg_iovlen = 1;
+
+		if (pass_fd >= 0) {
+			struct cmsghdr *cmh;
+
+			memset(cbuf, 0, sizeof(cbuf));
+			mh.msg_control = cbuf;
+			mh.msg_controllen = sizeof(cbuf);
+			cmh = CMSG_FIRSTHDR(&mh);
+			cmh->cmsg_level = SOL_SOCKET;
+			cmh->cmsg_type = SCM_RIGHTS;
+			cmh->cmsg_len = CMSG_LEN(sizeof(int));
+			memcpy(CMSG_DATA(cmh), &pass_fd, sizeof(int));
+		}
+
+		n = sendmsg(sock, &mh, MSG_NOSIGNAL);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+
+		// The descriptor travels with the first byte only.
+		pass_fd = -1;
+		p += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+// Read exactly len bytes, collecting any passed descriptor.
+STATIC int remote_recv_all(int sock, void *data, size_t len, int *recv_fd)
+{
+	uint8_t *p = (uint8_t *)data;
+	char cbuf[CMSG_SPACE(sizeof(int))];
+
+	while (len) {
+		struct msghdr mh;
+		struct iovec iov;
+		struct cmsghdr *cmh;
+		ssize_t n;
+
+		iov.iov_base = p;
+		iov.iov_len = len;
+
+		memset(&mh, 0, sizeof(mh));
+		mh.msg_iov = &iov;
+		mh.msg_iovlen = 1;
+		mh.msg_control = cbuf;
+		mh.msg_controllen = sizeof(cbuf);
+
+		n = recvmsg(sock, &mh, MSG_CMSG_CLOEXEC);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		if (!n)
+			return 1;
+
+		for (cmh = CMSG_FIRSTHDR(&mh) ; cmh ;
+		     cmh = CMSG_NXTHDR(&mh, cmh)) {
+			if (cmh->cmsg_level == SOL_SOCKET &&
+			    cmh->cmsg_type == SCM_RIGHTS) {
+				int fd;
+
+				memcpy(&fd, CMSG_DATA(cmh), sizeof(int));
+				if (*recv_fd >= 0)
+					opae_close(*recv_fd);
+				*recv_fd = fd;
+			}
+		}
+
+		p += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+int remote_recv(int sock, remote_msg_hdr *h, remote_buf *b, int *recv_fd)
+{
+	uint8_t raw[REMOTE_HDR_SIZE];
+	uint8_t *payload;
+	int res;
+
+	*recv_fd = -1;
+	b->len = 0;
+	b->err = 0;
+
+	res = remote_recv_all(sock, raw, sizeof(raw), recv_fd);
+	if (res)
+		goto out_close_fd;
+
+	remote_decode_hdr(raw, h);
+	if (h->len > REMOTE_MSG_MAX) {
+		OPAE_ERR("message of %u bytes exceeds the maximum", h->len);
+		res = -1;
+		goto out_close_fd;
+	}
+
+	payload = remote_buf_reserve(b, h->len);
+	if (!payload && h->len) {
+		res = -1;
+		goto out_close_fd;
+	}
+
+	res = remote_recv_all(sock, payload, h->len, recv_fd);
+	if (res)
+		goto out_close_fd;
+
+	return 0;
+
+out_close_fd:
+	if (*recv_fd >= 0) {
+		opae_close(*recv_fd);
+		*recv_fd = -1;
+	}
+	// A connection closed mid-message is an error.
+	return (res > 0 && !b->len) ? 1 : -1;
+}
@@ -0,0 +1,256 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifndef _OPAE_REMOTE_PROTO_H
+#define _OPAE_REMOTE_PROTO_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <opae/types.h>
+
+/*
+ * Wire protocol spoken between libopae-remote and fpgaremoted.
+ *
+ * Every message is a 16-byte header followed by `len` bytes of
+ * payload. All integers are little endian:
+ *
+ *   u32 len     payload bytes that follow the header
+ *   u16 op      REMOTE_OP_*
+ *   u16 flags   REMOTE_F_*
+ *   u32 seq     chosen by the client; echoed in the response
+ *   i32 result  fpga_result of a response (0 in requests)
+ *
+ * Requests are processed strictly in the order they are received,
+ * so a client may pipeline any number of them. Requests sent with
+ * REMOTE_F_POSTED (MMIO writes, buffer data) get no response at
+ * all unless they fail, in which case the failure is reported with
+ * the request's seq. Every posted request starts with the id of the
+ * handle it acts on, and the failure carries that id as its payload.
+ * REMOTE_OP_EVENT and server-to-client
+ * REMOTE_OP_BUFFER_DATA messages are unsolicited and carry seq 0.
+ *
+ * The first request must be a HELLO:
+ *
+ *   u32 magic, u32 version, u32 caps, u32 sync_usec,
+ *   u32 token_len, token_len bytes of token
+ *
+ * The server refuses every other request until a HELLO succeeds,
+ * and drops the connection when one fails.
+ */
+
+#define REMOTE_PROTO_MAGIC 0x4541504f // "OPAE"
+#define REMOTE_PROTO_VERSION 1
+
+#define REMOTE_HDR_SIZE 16
+#define REMOTE_MSG_MAX (16 * 1024 * 1024)
+// Copy-mode buffer data is sent in runs of at most this many bytes.
+#define REMOTE_DATA_CHUNK (1024 * 1024)
+#define REMOTE_BATCH_MAX 4096
+// The longest shared secret that a HELLO may carry.
+#define REMOTE_TOKEN_MAX 256
+
+#define REMOTE_SOCKET_DEFAULT "/tmp/opae_remote_socket"
+#define REMOTE_TCP_PORT_DEFAULT 5530
+
+enum remote_op {
+	REMOTE_OP_HELLO = 1,
+	REMOTE_OP_ENUMERATE,
+	REMOTE_OP_GET_PROPERTIES,
+	REMOTE_OP_OPEN,
+	REMOTE_OP_CLOSE,
+	REMOTE_OP_RESET,
+	REMOTE_OP_READ_MMIO32,
+	REMOTE_OP_READ_MMIO64,
+	REMOTE_OP_WRITE_MMIO32,
+	REMOTE_OP_WRITE_MMIO64,
+	REMOTE_OP_WRITE_MMIO512,
+	REMOTE_OP_READ_MMIO_BATCH,
+	REMOTE_OP_WRITE_MMIO_BATCH,
+	REMOTE_OP_PREPARE_BUFFER,
+	REMOTE_OP_RELEASE_BUFFER,
+	REMOTE_OP_GET_NUMA_NODE,
+	REMOTE_OP_BUFFER_DATA,
+	REMOTE_OP_REGISTER_EVENT,
+	REMOTE_OP_UNREGISTER_EVENT,
+	REMOTE_OP_EVENT,
+	REMOTE_OP_READ_ERROR,
+	REMOTE_OP_CLEAR_ERROR,
+	REMOTE_OP_CLEAR_ALL_ERRORS,
+	REMOTE_OP_GET_ERROR_INFO,
+	REMOTE_OP_MAX
+};
+
+#define REMOTE_F_POSTED 0x0001
+
+// HELLO capabilities
+#define REMOTE_CAP_SHM 0x00000001
+
+// PREPARE_BUFFER request flags
+#define REMOTE_BUF_SHM 0x00000001
+
+typedef struct _remote_msg_hdr {
+	uint32_t len;
+	uint16_t op;
+	uint16_t flags;
+	uint32_t seq;
+	int32_t result;
+} remote_msg_hdr;
+
+/*
+ * A growable byte buffer used to build outgoing messages. A failed
+ * allocation sets err, after which all puts are ignored.
+ */
+typedef struct _remote_buf {
+	uint8_t *data;
+	size_t len;
+	size_t cap;
+	int err;
+} remote_buf;
+
+/*
+ * A cursor over a received payload. Reading past the end sets err
+ * and yields zeros.
+ */
+typedef struct _remote_reader {
+	const uint8_t *p;
+	size_t left;
+	int err;
+} remote_reader;
+
+/*
+ * The properties of one token, as carried by ENUMERATE and
+ * GET_PROPERTIES. valid_fields uses the FPGA_PROPERTY_* bit
+ * numbering of libopae-c; the parent is never sent.
+ */
+typedef struct _remote_props {
+	uint64_t valid_fields;
+	fpga_guid guid;
+	fpga_objtype objtype;
+	uint16_t segment;
+	uint8_t bus;
+	uint8_t device;
+	uint8_t function;
+	uint8_t socket_id;
+	uint64_t object_id;
+	uint16_t vendor_id;
+	uint16_t device_id;
+	uint32_t num_errors;
+	fpga_interface interface;
+	uint16_t subsystem_vendor_id;
+	uint16_t subsystem_device_id;
+	uint32_t num_slots;
+	uint64_t bbs_id;
+	fpga_version bbs_version;
+	fpga_accelerator_state state;
+	uint32_t num_mmio;
+	uint32_t num_interrupts;
+} remote_props;
+
+void remote_buf_init(remote_buf *b);
+void remote_buf_free(remote_buf *b);
+uint8_t *remote_buf_reserve(remote_buf *b, size_t n);
+
+void remote_put_u8(remote_buf *b, uint8_t v);
+void remote_put_u16(remote_buf *b, uint16_t v);
+void remote_put_u32(remote_buf *b, uint32_t v);
+void remote_put_u64(remote_buf *b, uint64_t v);
+void remote_put_bytes(remote_buf *b, const void *p, size_t n);
+
+// Append a message header; returns its offset for remote_msg_end().
+size_t remote_msg_begin(remote_buf *b, uint16_t op, uint16_t flags,
+			uint32_t seq, int32_t result);
+// Patch the length of the message begun at hdr_off.
+void remote_msg_end(remote_buf *b, size_t hdr_off);
+
+void remote_reader_init(remote_reader *r, const void *p, size_t len);
+uint8_t remote_get_u8(remote_reader *r);
+uint16_t remote_get_u16(remote_reader *r);
+uint32_t remote_get_u32(remote_reader *r);
+uint64_t remote_get_u64(remote_reader *r);
+const uint8_t *remote_get_bytes(remote_reader *r, size_t n);
+
+void remote_decode_hdr(const uint8_t raw[REMOTE_HDR_SIZE], remote_msg_hdr *h);
+
+void remote_put_props(remote_buf *b, const remote_props *p);
+void remote_get_props(remote_reader *r, remote_props *p);
+// Fill p from any fpga_properties, using the public accessors.
+void remote_props_from_properties(fpga_properties prop, remote_props *p);
+
+/*
+ * Copy-mode buffers are mirrored on both ends. Each end keeps a
+ * shadow holding the contents last exchanged with its peer.
+ *
+ * remote_put_buffer_diff() appends a posted BUFFER_DATA message for
+ * each run of pages of buf that differ from shadow, and brings
+ * shadow up to date. It returns the number of data bytes queued.
+ *
+ * remote_merge_buffer() applies received data to buf, but only the
+ * 64-bit words in which the data differs from shadow: a word that
+ * only this end changed since the last exchange keeps its value.
+ */
+size_t remote_put_buffer_diff(remote_buf *b, uint64_t handle_id,
+			      uint64_t wsid, const uint8_t *buf,
+			      uint8_t *shadow, size_t len);
+void remote_merge_buffer(volatile uint8_t *buf, uint8_t *shadow,
+			 const uint8_t *data, size_t len);
+
+/*
+ * Read the shared secret that TCP clients present in HELLO from
+ * path, less any trailing newline. The file must not be accessible
+ * to its group or to others. Returns 0 and sets *len on success.
+ */
+int remote_read_token(const char *path, uint8_t token[REMOTE_TOKEN_MAX],
+		      uint32_t *len);
+
+/*
+ * Compare a token received from a peer with the expected one, in a
+ * time that does not depend on where they differ.
+ */
+bool remote_token_equal(const uint8_t *expected, uint32_t expected_len,
+			const uint8_t *token, uint32_t len);
+
+/*
+ * Endpoints are "unix:<path>" or "tcp:<host>:<port>". A bare path
+ * is taken as a UNIX socket. Both return a socket fd or -1.
+ */
+int remote_connect(const char *endpoint, bool *is_unix);
+int remote_listen(const char *endpoint);
+
+/*
+ * Send len bytes, attaching pass_fd (when >= 0) as SCM_RIGHTS data.
+ * Returns 0 on success.
+ */
+int remote_send(int sock, const void *data, size_t len, int pass_fd);
+
+/*
+ * Receive one message. The payload lands in b (reset first). A file
+ * descriptor passed with the message is returned in *recv_fd, which
+ * is -1 otherwise. Returns 0 on success, 1 when the peer closed the
+ * connection and -1 on error.
+ */
+int remote_recv(int sock, remote_msg_hdr *h, remote_buf *b, int *recv_fd);
+
+#endif // _OPAE_REMOTE_PROTO_H
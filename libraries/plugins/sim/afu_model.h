@@ -0,0 +1,181 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace opae {
+namespace sim {
+
+/** The register space of an emulated AFU.
+ *
+ * Software reaches the same memory through fpgaReadMMIO*()/
+ * fpgaWriteMMIO*() and through the pointer from fpgaMapMMIO(),
+ * so a model cannot trap register writes. It observes them by
+ * polling, and acknowledges self-clearing bits (start, reset)
+ * with the atomic fetch_clear*() operations, so that a write
+ * racing with the acknowledgment is never lost.
+ */
+class mmio_space {
+ public:
+  mmio_space(uint8_t *base, size_t size) : base_(base), size_(size) {}
+
+  uint8_t *base() const { return base_; }
+  size_t size() const { return size_; }
+
+  uint64_t read64(uint64_t offset) const {
+    return __atomic_load_n(reinterpret_cast<uint64_t *>(base_ + offset),
+                           __ATOMIC_ACQUIRE);
+  }
+
+  void write64(uint64_t offset, uint64_t value) {
+    __atomic_store_n(reinterpret_cast<uint64_t *>(base_ + offset), value,
+                     __ATOMIC_RELEASE);
+  }
+
+  uint32_t read32(uint64_t offset) const {
+    return __atomic_load_n(reinterpret_cast<uint32_t *>(base_ + offset),
+                           __ATOMIC_ACQUIRE);
+  }
+
+  void write32(uint64_t offset, uint32_t value) {
+    __atomic_store_n(reinterpret_cast<uint32_t *>(base_ + offset), value,
+                     __ATOMIC_RELEASE);
+  }
+
+  /** Clear bits in a register, returning its previous value. */
+  uint64_t fetch_clear64(uint64_t offset, uint64_t bits) {
+    return __atomic_fetch_and(reinterpret_cast<uint64_t *>(base_ + offset),
+                              ~bits, __ATOMIC_ACQ_REL);
+  }
+
+  uint32_t fetch_clear32(uint64_t offset, uint32_t bits) {
+    return __atomic_fetch_and(reinterpret_cast<uint32_t *>(base_ + offset),
+                              ~bits, __ATOMIC_ACQ_REL);
+  }
+
+  void clear() { std::memset(base_, 0, size_); }
+
+ private:
+  uint8_t *base_;
+  size_t size_;
+};
+
+/** What the emulated device offers a model: DMA and interrupts.
+ */
+class host_port {
+ public:
+  virtual ~host_port() {}
+
+  /** Translate a device (IO) address to host memory.
+   *
+   * @return A pointer to len bytes of host memory, or nullptr
+   * when any part of [iova, iova + len) lies outside the buffers
+   * mapped with fpgaPrepareBuffer().
+   */
+  virtual uint8_t *translate(uint64_t iova, uint64_t len) = 0;
+
+  /** Signal the eventfd registered for vector, if any. */
+  virtual void interrupt(uint32_t vector) = 0;
+};
+
+/** A private feature following the AFU header in the DFH list.
+ */
+struct dfh_feature {
+  uint64_t offset;
+  uint16_t id;
+  uint8_t revision;
+};
+
+/** The behaviour of one emulated AFU.
+ *
+ * A model names the AFU ID it answers to, sizes its register
+ * space, and implements step(), which the device's worker
+ * thread calls whenever registers may have changed. The base
+ * class lays out the device feature header list; models add
+ * the power-on values of their own registers in reset().
+ *
+ * To add a model, derive from afu_model and add it to the
+ * table in models.cpp.
+ */
+class afu_model {
+ public:
+  typedef std::unique_ptr<afu_model> ptr_t;
+
+  afu_model(const char *name, const char *guid, size_t mmio_size,
+            uint32_t num_interrupts)
+      : name_(name),
+        guid_(guid),
+        mmio_size_(mmio_size),
+        num_interrupts_(num_interrupts) {}
+
+  virtual ~afu_model() {}
+
+  const char *name() const { return name_.c_str(); }
+  const char *guid() const { return guid_.c_str(); }
+  size_t mmio_size() const { return mmio_size_; }
+  uint32_t num_interrupts() const { return num_interrupts_; }
+
+  /** Return the register space to its power-on state.
+   *
+   * Overrides must call afu_model::reset() first.
+   */
+  virtual void reset(mmio_space &mmio);
+
+  /** Advance the model.
+   *
+   * Called from the worker thread with the device lock held.
+   *
+   * @return true when the model did work, so that the worker
+   * polls again immediately rather than sleeping.
+   */
+  virtual bool step(mmio_space &mmio, host_port &host) = 0;
+
+  /** Instantiate a built-in model by name.
+   *
+   * @return The model, or nullptr when name is not known.
+   */
+  static ptr_t create(const std::string &name);
+
+  /** The names of the built-in models, NULL terminated. */
+  static const char **names();
+
+ protected:
+  std::vector<dfh_feature> features_;
+
+ private:
+  std::string name_;
+  std::string guid_;
+  size_t mmio_size_;
+  uint32_t num_interrupts_;
+};
+
+}  // end of namespace sim
+}  // end of namespace opae
@@ -0,0 +1,375 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include <uuid/uuid.h>
+
+#include <chrono>
+
+#include "afu_model.h"
+
+namespace opae {
+namespace sim {
+
+// Device Feature Header fields
+#define DFH_ID(id) ((uint64_t)(id) & 0xfff)
+#define DFH_REVISION(rev) (((uint64_t)(rev) & 0xf) << 12)
+#define DFH_NEXT(offset) (((uint64_t)(offset) & 0xffffff) << 16)
+#define DFH_EOL ((uint64_t)1 << 40)
+#define DFH_TYPE(type) (((uint64_t)(type) & 0xf) << 60)
+#define DFH_TYPE_AFU 1
+#define DFH_TYPE_PRIVATE 3
+
+#define AFU_ID_L 0x0008
+#define AFU_ID_H 0x0010
+
+static uint64_t be64(const uint8_t *p) {
+  uint64_t v = 0;
+  for (int i = 0; i < 8; ++i) v = (v << 8) | p[i];
+  return v;
+}
+
+void afu_model::reset(mmio_space &mmio) {
+  uuid_t u;
+
+  mmio.clear();
+
+  // The AFU header at offset 0 leads the list of private features.
+  uint64_t next = features_.empty() ? 0 : features_.front().offset;
+  mmio.write64(0, DFH_TYPE(DFH_TYPE_AFU) | DFH_NEXT(next) |
+                      (features_.empty() ? DFH_EOL : 0));
+
+  if (!uuid_parse(guid_.c_str(), u)) {
+    mmio.write64(AFU_ID_L, be64(u + 8));
+    mmio.write64(AFU_ID_H, be64(u));
+  }
+
+  for (size_t i = 0; i < features_.size(); ++i) {
+    const dfh_feature &f = features_[i];
+    bool last = i + 1 == features_.size();
+    uint64_t dfh = DFH_TYPE(DFH_TYPE_PRIVATE) | DFH_ID(f.id) |
+                   DFH_REVISION(f.revision);
+    if (last)
+      dfh |= DFH_EOL;
+    else
+      dfh |= DFH_NEXT(features_[i + 1].offset - f.offset);
+    mmio.write64(f.offset, dfh);
+  }
+}
+
+/** The host exerciser loopback (he-lb) AFU.
+ *
+ * Implements the lpbk, read, write and trput test modes,
+ * continuous mode, forced test completion and completion
+ * interrupts. Transfers are memcpy()'s between the buffers
+ * named by HE_SRC_ADDR/HE_DST_ADDR, so the bandwidth that
+ * host_exerciser reports is that of host memory. The tick
+ * count written to the DSM is the elapsed time at the clock
+ * advertised in HE_INFO0. Atomics are not modelled, which
+ * HE_INFO0 reports.
+ */
+class he_lpbk : public afu_model {
+ public:
+  he_lpbk()
+      : afu_model("he_lpbk", "56e203e9-864f-49a7-b94b-12284c31e02b",
+                  0x1000, 4),
+        running_(false),
+        cfg_(0),
+        src_(0),
+        dst_(0),
+        lines_(0),
+        reads_(0),
+        writes_(0),
+        sink_(0) {}
+
+  void reset(mmio_space &mmio) override {
+    afu_model::reset(mmio);
+    mmio.write64(HE_INFO0, INFO0_NO_ATOMICS | (API_VERSION << 16) |
+                               CLOCK_MHZ);
+    running_ = false;
+  }
+
+  bool step(mmio_space &mmio, host_port &host) override {
+    uint32_t ctl = mmio.read32(HE_CTL);
+
+    if (!(ctl & CTL_RESET_L)) {
+      // Reset asserted: abandon any test in progress.
+      running_ = false;
+      return false;
+    }
+
+    if (ctl & CTL_FORCED_TEST_CMPL) {
+      mmio.fetch_clear32(HE_CTL, CTL_FORCED_TEST_CMPL);
+      complete(mmio, host);
+      return true;
+    }
+
+    if (!running_) {
+      if (!(mmio.fetch_clear32(HE_CTL, CTL_START) & CTL_START))
+        return false;
+      start(mmio);
+    }
+
+    if (!transfer(mmio, host)) {
+      mmio.write64(HE_ERROR, 1);
+      complete(mmio, host);
+      return true;
+    }
+
+    // Continuous mode runs until software forces completion.
+    if (!(cfg_ & CFG_CONTINUOUS))
+      complete(mmio, host);
+    return true;
+  }
+
+ private:
+  enum {
+    HE_DSM_BASEL = 0x0110,
+    HE_DSM_BASEH = 0x0114,
+    HE_SRC_ADDR = 0x0120,
+    HE_DST_ADDR = 0x0128,
+    HE_NUM_LINES = 0x0130,
+    HE_CTL = 0x0138,
+    HE_CFG = 0x0140,
+    HE_INTERRUPT0 = 0x0150,
+    HE_STATUS0 = 0x0160,
+    HE_ERROR = 0x0170,
+    HE_INFO0 = 0x0180,
+  };
+
+  enum {
+    CTL_RESET_L = 1u << 0,
+    CTL_START = 1u << 1,
+    CTL_FORCED_TEST_CMPL = 1u << 2,
+  };
+
+  enum { MODE_LPBK1 = 0, MODE_READ = 1, MODE_WRITE = 2, MODE_TRPUT = 3 };
+
+  static constexpr uint64_t CFG_CONTINUOUS = 1u << 1;
+  static constexpr uint64_t CFG_INTR_TEST_MODE = 1u << 29;
+  static constexpr uint64_t INFO0_NO_ATOMICS = 1u << 24;
+  static constexpr uint64_t API_VERSION = 2;
+  static constexpr uint64_t CLOCK_MHZ = 350;
+  static constexpr uint64_t CL = 64;
+  static constexpr size_t DSM_SIZE = 64;
+
+  void start(mmio_space &mmio) {
+    cfg_ = mmio.read64(HE_CFG);
+    // Addresses are programmed as cache line numbers.
+    src_ = mmio.read64(HE_SRC_ADDR) * CL;
+    dst_ = mmio.read64(HE_DST_ADDR) * CL;
+    lines_ = (mmio.read64(HE_NUM_LINES) & 0xffffffff) + 1;
+    reads_ = writes_ = 0;
+    mmio.write64(HE_STATUS0, 0);
+    mmio.write64(HE_ERROR, 0);
+    begin_ = std::chrono::steady_clock::now();
+    running_ = true;
+  }
+
+  bool transfer(mmio_space &mmio, host_port &host) {
+    uint64_t len = lines_ * CL;
+    uint32_t mode = (cfg_ >> 2) & 0x7;
+    bool reads = mode != MODE_WRITE;
+    bool writes = mode != MODE_READ;
+    uint8_t *src = reads ? host.translate(src_, len) : nullptr;
+    uint8_t *dst = writes ? host.translate(dst_, len) : nullptr;
+
+    if ((reads && !src) || (writes && !dst))
+      return false;
+
+    if (reads && writes) {
+      std::memcpy(dst, src, len);
+    } else if (reads) {
+      uint64_t sum = 0;
+      for (uint64_t i = 0; i < len; i += sizeof(uint64_t))
+        sum += *reinterpret_cast<volatile uint64_t *>(src + i);
+      sink_ = sum;
+    } else {
+      std::memset(dst, 0, len);
+    }
+
+    if (reads) reads_ += lines_;
+    if (writes) writes_ += lines_;
+    mmio.write64(HE_STATUS0, (reads_ & 0xffffffff) << 32 |
+                                 (writes_ & 0xffffffff));
+    return true;
+  }
+
+  void complete(mmio_space &mmio, host_port &host) {
+    uint64_t dsm_addr = ((uint64_t)mmio.read32(HE_DSM_BASEH) << 32 |
+                         mmio.read32(HE_DSM_BASEL)) * CL;
+    uint8_t *dsm = host.translate(dsm_addr, DSM_SIZE);
+
+    if (running_ && dsm) {
+      using namespace std::chrono;
+      uint64_t nsec = duration_cast<nanoseconds>(
+          steady_clock::now() - begin_).count();
+      uint64_t ticks = nsec * CLOCK_MHZ / 1000;
+      uint64_t *q = reinterpret_cast<uint64_t *>(dsm);
+
+      if (!ticks)
+        ticks = 1;
+
+      q[1] = (ticks & 0xffffffffff) |
+             ((reads_ >> 32) & 0xff) << 48 |
+             ((writes_ >> 32) & 0xff) << 56;
+      q[2] = (reads_ & 0xffffffff) | (writes_ & 0xffffffff) << 32;
+      // test_completed goes last: software polls it.
+      __atomic_store_n(&q[0], (mmio.read64(HE_ERROR) ? 1ull << 32 : 0) | 1,
+                       __ATOMIC_RELEASE);
+    } else if (dsm) {
+      __atomic_store_n(reinterpret_cast<uint64_t *>(dsm), 1ull,
+                       __ATOMIC_RELEASE);
+    }
+
+    if (running_ && (cfg_ & CFG_INTR_TEST_MODE))
+      host.interrupt(mmio.read32(HE_INTERRUPT0) >> 16);
+
+    running_ = false;
+  }
+
+  bool running_;
+  uint64_t cfg_;
+  uint64_t src_;
+  uint64_t dst_;
+  uint64_t lines_;
+  uint64_t reads_;
+  uint64_t writes_;
+  uint64_t sink_;
+  std::chrono::steady_clock::time_point begin_;
+};
+
+/** The dummy_afu test AFU.
+ *
+ * Backs the scratchpad registers with plain memory, copies one
+ * cache line from MEM_TEST_SRC_ADDR to MEM_TEST_DST_ADDR when
+ * MEM_TEST_CTRL is started and then raises interrupt 0, and
+ * passes every DDR bank that DDR_TEST_CTRL starts. Bank status
+ * is cleared by reset and whenever a DDR test is started.
+ */
+class dummy_afu : public afu_model {
+ public:
+  dummy_afu()
+      : afu_model("dummy_afu", "91c2a3a1-4a23-4e21-a7cd-2b36dbf2ed73",
+                  0x4000, 1),
+        pending_banks_(0) {}
+
+  void reset(mmio_space &mmio) override {
+    afu_model::reset(mmio);
+    mmio.write64(DDR_TEST_STAT, NUM_DDR_BANKS);
+    clear_banks(mmio);
+    pending_banks_ = 0;
+  }
+
+  bool step(mmio_space &mmio, host_port &host) override {
+    bool busy = false;
+
+    if (mmio.fetch_clear64(MEM_TEST_CTRL, 1) & 1) {
+      uint8_t *src = host.translate(mmio.read64(MEM_TEST_SRC_ADDR), CL);
+      uint8_t *dst = host.translate(mmio.read64(MEM_TEST_DST_ADDR), CL);
+
+      if (src && dst) {
+        std::memcpy(dst, src, CL);
+        mmio.write64(MEM_TEST_STAT, 0);
+      } else {
+        mmio.write64(MEM_TEST_STAT, 1);
+      }
+      host.interrupt(0);
+      busy = true;
+    }
+
+    // Starting a test clears the status of every bank, as the
+    // hardware does; the started banks then pass on the next step,
+    // so software never reads a previous run's result as this one's.
+    if (pending_banks_) {
+      for (uint64_t i = 0; i < NUM_DDR_BANKS; ++i) {
+        if (pending_banks_ & (1ull << i))
+          mmio.write64(DDR_TEST_BANK0_STAT + i * 8, BANK_PASS);
+      }
+      pending_banks_ = 0;
+      busy = true;
+    }
+
+    uint64_t banks = mmio.fetch_clear64(DDR_TEST_CTRL, 0xf) & 0xf;
+    if (banks) {
+      clear_banks(mmio);
+      pending_banks_ = banks;
+      busy = true;
+    }
+
+    return busy;
+  }
+
+ private:
+  enum {
+    MEM_TEST_CTRL = 0x2040,
+    MEM_TEST_STAT = 0x2048,
+    MEM_TEST_SRC_ADDR = 0x2050,
+    MEM_TEST_DST_ADDR = 0x2058,
+    DDR_TEST_CTRL = 0x3000,
+    DDR_TEST_STAT = 0x3008,
+    DDR_TEST_BANK0_STAT = 0x3010,
+  };
+
+  static constexpr uint64_t CL = 64;
+  static constexpr uint64_t NUM_DDR_BANKS = 4;
+  static constexpr uint64_t BANK_PASS = 1;
+
+  void clear_banks(mmio_space &mmio) {
+    for (uint64_t i = 0; i < NUM_DDR_BANKS; ++i)
+      mmio.write64(DDR_TEST_BANK0_STAT + i * 8, 0);
+  }
+
+  uint64_t pending_banks_;
+};
+
+struct model_entry {
+  const char *name;
+  afu_model *(*create)();
+};
+
+static const model_entry builtin_models[] = {
+  { "he_lpbk", []() -> afu_model * { return new he_lpbk(); } },
+  { "dummy_afu", []() -> afu_model * { return new dummy_afu(); } },
+  { nullptr, nullptr }
+};
+
+afu_model::ptr_t afu_model::create(const std::string &name) {
+  for (const model_entry *m = builtin_models; m->name; ++m) {
+    if (name == m->name)
+      return ptr_t(m->create());
+  }
+  return ptr_t();
+}
+
+const char **afu_model::names() {
+  static const char *names[sizeof(builtin_models) /
+                           sizeof(builtin_models[0])];
+  for (size_t i = 0; builtin_models[i].name; ++i)
+    names[i] = builtin_models[i].name;
+  return names;
+}
+
+}  // end of namespace sim
+}  // end of namespace opae
@@ -0,0 +1,1418 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif // _GNU_SOURCE
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#undef _GNU_SOURCE
+
+#include <opae/fpga.h>
+
+#include "opae_sim.h"
+
+#include "opae_int.h"
+#include "props.h"
+#include "cfg-file.h"
+#include "mock/opae_std.h"
+
+#ifndef __SIM_API__
+#define __SIM_API__
+#endif
+
+#define SIM_TOKEN_MAGIC 0x5151ABBA
+#define SIM_HANDLE_MAGIC (~(uint32_t)SIM_TOKEN_MAGIC)
+#define SIM_EVENT_HANDLE_MAGIC 0x5a7451a5
+
+#define SIM_MMIO_MAX 1
+
+STATIC char *sim_models[SIM_DEVICES_MAX];
+STATIC uint32_t sim_num_models;
+STATIC uint32_t sim_poll_usec = SIM_POLL_USEC_DEFAULT;
+
+STATIC sim_device *sim_devices[SIM_DEVICES_MAX];
+STATIC sim_token sim_tokens[SIM_DEVICES_MAX];
+STATIC uint32_t sim_num_devices;
+
+STATIC void sim_free_config(void)
+{
+	uint32_t i;
+
+	for (i = 0 ; i < sim_num_models ; ++i) {
+		opae_free(sim_models[i]);
+		sim_models[i] = NULL;
+	}
+	sim_num_models = 0;
+	sim_poll_usec = SIM_POLL_USEC_DEFAULT;
+}
+
+/*
+ * The plugin "configuration" from opae.cfg:
+ *
+ *   {
+ *     "devices": [ "he_lpbk", "dummy_afu" ],
+ *     "poll_usec": 20
+ *   }
+ *
+ * Each "devices" entry names the model of one emulated AFU. When
+ * "devices" is absent, one device of each built-in model is created.
+ * "poll_usec" is the period at which an idle device polls its MMIO
+ * space for writes made through fpgaMapMMIO() pointers.
+ */
+int sim_parse_config(const char *json)
+{
+	json_object *root = NULL;
+	json_object *j_devices = NULL;
+	json_object *j_poll = NULL;
+	enum json_tokener_error j_err = json_tokener_success;
+	int num_devices = 0;
+	int res = 1;
+	int i;
+
+	sim_free_config();
+
+	if (json) {
+		root = json_tokener_parse_verbose(json, &j_err);
+		if (!root) {
+			OPAE_ERR("error parsing plugin configuration: %s",
+				 json_tokener_error_desc(j_err));
+			return 1;
+		}
+	}
+
+	if (root && json_object_object_get_ex(root, "poll_usec", &j_poll)) {
+		if (!json_object_is_type(j_poll, json_type_int) ||
+		    json_object_get_int(j_poll) < 1) {
+			OPAE_ERR("\"poll_usec\" must be a positive integer");
+			goto out_put;
+		}
+		sim_poll_usec = (uint32_t)json_object_get_int(j_poll);
+	}
+
+	if (root)
+		j_devices = parse_json_array(root, "devices", &num_devices);
+
+	if (!j_devices) {
+		const char **m;
+
+		for (m = sim_device_models() ;
+		     *m && (sim_num_models < SIM_DEVICES_MAX) ; ++m)
+			sim_models[sim_num_models++] = opae_strdup(*m);
+
+		res = 0;
+		goto out_put;
+	}
+
+	if (num_devices > SIM_DEVICES_MAX) {
+		OPAE_ERR("at most %d sim devices are supported",
+			 SIM_DEVICES_MAX);
+		goto out_put;
+	}
+
+	for (i = 0 ; i < num_devices ; ++i) {
+		json_object *j_model = json_object_array_get_idx(j_devices, i);
+
+		if (!json_object_is_type(j_model, json_type_string)) {
+			OPAE_ERR("Non-string JSON item found in 'devices[%d]'",
+				 i);
+			goto out_put;
+		}
+
+		sim_models[sim_num_models] =
+			opae_strdup(json_object_get_string(j_model));
+		if (!sim_models[sim_num_models]) {
+			OPAE_ERR("strdup failed");
+			goto out_put;
+		}
+		++sim_num_models;
+	}
+
+	res = 0;
+
+out_put:
+	if (root)
+		json_object_put(root);
+	if (res)
+		sim_free_config();
+	return res;
+}
+
+int sim_create_devices(void)
+{
+	uint32_t i;
+
+	if (!sim_num_models && sim_parse_config(NULL))
+		return 1;
+
+	for (i = 0 ; i < sim_num_models ; ++i) {
+		sim_device *dev;
+		sim_token *t;
+		size_t size = 0;
+
+		dev = sim_device_create(sim_models[i], sim_poll_usec);
+		if (!dev) {
+			OPAE_ERR("failed to create sim model \"%s\"",
+				 sim_models[i]);
+			sim_free_devices();
+			return 1;
+		}
+
+		t = &sim_tokens[sim_num_devices];
+		memset(t, 0, sizeof(*t));
+
+		t->hdr.magic = SIM_TOKEN_MAGIC;
+		t->hdr.vendor_id = SIM_VENDOR_ID;
+		t->hdr.device_id = SIM_DEVICE_ID;
+		t->hdr.subsystem_vendor_id = SIM_VENDOR_ID;
+		t->hdr.subsystem_device_id = SIM_DEVICE_ID;
+		t->hdr.segment = SIM_SEGMENT;
+		t->hdr.bus = 0;
+		t->hdr.device = (uint8_t)sim_num_devices;
+		t->hdr.function = 0;
+		t->hdr.interface = FPGA_IFC_EMU;
+		t->hdr.objtype = FPGA_ACCELERATOR;
+		t->hdr.object_id = ((uint64_t)SIM_SEGMENT << 32) |
+				   sim_num_devices;
+		sim_device_guid(dev, t->hdr.guid);
+
+		t->index = sim_num_devices;
+		t->num_interrupts = sim_device_num_interrupts(dev);
+		sim_device_mmio(dev, &size);
+		t->mmio_size = size;
+
+		sim_devices[sim_num_devices++] = dev;
+
+		OPAE_DBG("sim device %04x:00:%02x.0 runs model %s",
+			 SIM_SEGMENT, t->index, sim_models[i]);
+	}
+
+	return 0;
+}
+
+void sim_free_devices(void)
+{
+	uint32_t i;
+
+	for (i = 0 ; i < sim_num_devices ; ++i) {
+		sim_device_destroy(sim_devices[i]);
+		sim_devices[i] = NULL;
+		sim_tokens[i].hdr.magic = 0;
+	}
+	sim_num_devices = 0;
+
+	sim_free_config();
+}
+
+STATIC sim_token *clone_token(const sim_token *src)
+{
+	sim_token *token;
+
+	ASSERT_NOT_NULL_RESULT(src, NULL);
+
+	token = (sim_token *)opae_malloc(sizeof(sim_token));
+	if (!token) {
+		OPAE_ERR("Failed to allocate memory for sim_token");
+		return NULL;
+	}
+
+	memcpy(token, src, sizeof(sim_token));
+
+	return token;
+}
+
+STATIC sim_token *token_check(fpga_token token)
+{
+	sim_token *t;
+
+	ASSERT_NOT_NULL_RESULT(token, NULL);
+
+	t = (sim_token *)token;
+	if (t->hdr.magic != SIM_TOKEN_MAGIC) {
+		OPAE_ERR("invalid token magic");
+		return NULL;
+	}
+
+	return t;
+}
+
+STATIC sim_handle *handle_check(fpga_handle handle)
+{
+	sim_handle *h;
+
+	ASSERT_NOT_NULL_RESULT(handle, NULL);
+
+	h = (sim_handle *)handle;
+	if (h->magic != SIM_HANDLE_MAGIC) {
+		OPAE_ERR("invalid handle magic");
+		return NULL;
+	}
+
+	return h;
+}
+
+STATIC sim_event_handle *event_handle_check(fpga_event_handle event_handle)
+{
+	sim_event_handle *eh;
+
+	ASSERT_NOT_NULL_RESULT(event_handle, NULL);
+
+	eh = (sim_event_handle *)event_handle;
+	if (eh->magic != SIM_EVENT_HANDLE_MAGIC) {
+		OPAE_ERR("invalid event handle magic");
+		return NULL;
+	}
+
+	return eh;
+}
+
+STATIC sim_handle *handle_check_and_lock(fpga_handle handle)
+{
+	int res;
+	sim_handle *h;
+
+	h = handle_check(handle);
+	if (h)
+		return opae_mutex_lock(res, &h->lock) ? NULL : h;
+
+	return NULL;
+}
+
+STATIC sim_event_handle *
+event_handle_check_and_lock(fpga_event_handle event_handle)
+{
+	int res;
+	sim_event_handle *eh;
+
+	eh = event_handle_check(event_handle);
+	if (eh)
+		return opae_mutex_lock(res, &eh->lock) ? NULL : eh;
+
+	return NULL;
+}
+
+STATIC sim_device *token_device(const sim_token *t)
+{
+	if ((t->index >= sim_num_devices) ||
+	    (sim_tokens[t->index].hdr.object_id != t->hdr.object_id)) {
+		OPAE_ERR("stale sim token");
+		return NULL;
+	}
+
+	return sim_devices[t->index];
+}
+
+fpga_result __SIM_API__ sim_fpgaOpen(fpga_token token, fpga_handle *handle, int flags)
+{
+	fpga_result res = FPGA_EXCEPTION;
+	sim_token *_token;
+	sim_handle *_handle;
+	sim_device *dev;
+	pthread_mutexattr_t mattr;
+
+	ASSERT_NOT_NULL(token);
+	ASSERT_NOT_NULL(handle);
+
+	_token = token_check(token);
+	ASSERT_NOT_NULL(_token);
+
+	dev = token_device(_token);
+	ASSERT_NOT_NULL(dev);
+
+	if (pthread_mutexattr_init(&mattr)) {
+		OPAE_ERR("Failed to init handle mutex attr");
+		return FPGA_EXCEPTION;
+	}
+
+	_handle = opae_calloc(1, sizeof(sim_handle));
+	if (!_handle) {
+		OPAE_ERR("Failed to allocate memory for handle");
+		res = FPGA_NO_MEMORY;
+		goto out_attr_destroy;
+	}
+
+	if (pthread_mutexattr_settype(&mattr, PTHREAD_MUTEX_RECURSIVE) ||
+	    pthread_mutex_init(&_handle->lock, &mattr)) {
+		OPAE_ERR("Failed to init handle mutex");
+		res = FPGA_EXCEPTION;
+		goto out_free;
+	}
+
+	if (sim_device_open(dev, !(flags & FPGA_OPEN_SHARED))) {
+		OPAE_MSG("sim device %u is busy", _token->index);
+		res = FPGA_BUSY;
+		goto out_mutex_destroy;
+	}
+
+	_handle->token = clone_token(_token);
+	if (!_handle->token) {
+		res = FPGA_NO_MEMORY;
+		sim_device_close(dev);
+		goto out_mutex_destroy;
+	}
+
+	_handle->magic = SIM_HANDLE_MAGIC;
+	_handle->device = dev;
+	_handle->mmio_base = sim_device_mmio(dev, &_handle->mmio_size);
+
+	*handle = _handle;
+	pthread_mutexattr_destroy(&mattr);
+	return FPGA_OK;
+
+out_mutex_destroy:
+	pthread_mutex_destroy(&_handle->lock);
+out_free:
+	opae_free(_handle);
+out_attr_destroy:
+	pthread_mutexattr_destroy(&mattr);
+	return res;
+}
+
+STATIC void release_buffer(sim_handle *h, sim_buffer *b)
+{
+	if (sim_device_unmap_buffer(h->device, b->iova))
+		OPAE_ERR("sim buffer 0x%lx was not mapped", b->iova);
+
+	if (!b->preallocated)
+		munmap(b->virt, b->len);
+
+	opae_free(b);
+}
+
+fpga_result __SIM_API__ sim_fpgaClose(fpga_handle handle)
+{
+	fpga_result res = FPGA_OK;
+	sim_handle *h;
+	sim_buffer *b;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	b = h->buffers;
+	while (b) {
+		sim_buffer *next = b->next;
+		release_buffer(h, b);
+		b = next;
+	}
+	h->buffers = NULL;
+
+	sim_device_close(h->device);
+
+	opae_free(h->token);
+
+	if (pthread_mutex_unlock(&h->lock) ||
+	    pthread_mutex_destroy(&h->lock)) {
+		OPAE_ERR("error unlocking/destroying handle mutex");
+		res = FPGA_EXCEPTION;
+	}
+
+	h->magic = 0;
+	opae_free(h);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaReset(fpga_handle handle)
+{
+	int err;
+	sim_handle *h;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	sim_device_reset(h->device);
+
+	opae_mutex_unlock(err, &h->lock);
+
+	return FPGA_OK;
+}
+
+fpga_result __SIM_API__ sim_fpgaUpdateProperties(fpga_token token, fpga_properties prop)
+{
+	sim_token *t;
+	struct _fpga_properties *_prop;
+	int err;
+
+	t = token_check(token);
+	ASSERT_NOT_NULL(t);
+
+	_prop = opae_validate_and_lock_properties(prop);
+	if (!_prop) {
+		OPAE_ERR("Invalid properties object");
+		return FPGA_INVALID_PARAM;
+	}
+
+	_prop->valid_fields = 0;
+
+	_prop->vendor_id = t->hdr.vendor_id;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_VENDORID);
+
+	_prop->device_id = t->hdr.device_id;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_DEVICEID);
+
+	_prop->subsystem_vendor_id = t->hdr.subsystem_vendor_id;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_SUB_VENDORID);
+
+	_prop->subsystem_device_id = t->hdr.subsystem_device_id;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_SUB_DEVICEID);
+
+	_prop->segment = t->hdr.segment;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_SEGMENT);
+
+	_prop->bus = t->hdr.bus;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_BUS);
+
+	_prop->device = t->hdr.device;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_DEVICE);
+
+	_prop->function = t->hdr.function;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_FUNCTION);
+
+	_prop->socket_id = 0;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_SOCKETID);
+
+	_prop->object_id = t->hdr.object_id;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_OBJECTID);
+
+	_prop->objtype = t->hdr.objtype;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_OBJTYPE);
+
+	_prop->interface = t->hdr.interface;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_INTERFACE);
+
+	_prop->parent = NULL;
+	CLEAR_FIELD_VALID(_prop, FPGA_PROPERTY_PARENT);
+
+	memcpy(_prop->guid, t->hdr.guid, sizeof(fpga_guid));
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_GUID);
+
+	_prop->u.accelerator.num_mmio = SIM_MMIO_MAX;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_NUM_MMIO);
+
+	_prop->u.accelerator.num_interrupts = t->num_interrupts;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_NUM_INTERRUPTS);
+
+	_prop->u.accelerator.state = FPGA_ACCELERATOR_UNASSIGNED;
+	SET_FIELD_VALID(_prop, FPGA_PROPERTY_ACCELERATOR_STATE);
+
+	opae_mutex_unlock(err, &_prop->lock);
+	return FPGA_OK;
+}
+
+fpga_result __SIM_API__ sim_fpgaGetProperties(fpga_token token, fpga_properties *prop)
+{
+	struct _fpga_properties *_prop = NULL;
+	fpga_result result = FPGA_OK;
+	int err;
+
+	ASSERT_NOT_NULL(prop);
+
+	result = fpgaGetProperties(NULL, (fpga_properties *)&_prop);
+	if (result)
+		return result;
+
+	if (token) {
+		result = sim_fpgaUpdateProperties(token, _prop);
+		if (result)
+			goto out_free;
+	}
+
+	*prop = (fpga_properties)_prop;
+	return result;
+
+out_free:
+	err = pthread_mutex_destroy(&_prop->lock);
+	if (err)
+		OPAE_ERR("pthread_mutex_destroy() failed");
+	opae_free(_prop);
+	return result;
+}
+
+fpga_result __SIM_API__ sim_fpgaGetPropertiesFromHandle(fpga_handle handle, fpga_properties *prop)
+{
+	sim_handle *h;
+	fpga_result res;
+	int err;
+
+	ASSERT_NOT_NULL(prop);
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	res = sim_fpgaGetProperties(h->token, prop);
+
+	opae_mutex_unlock(err, &h->lock);
+
+	return res;
+}
+
+/*
+ * Validate an MMIO access of width bytes, returning its address
+ * or NULL. Unlike a real BAR, the emulated space reports accesses
+ * that fall outside it instead of faulting.
+ */
+static inline volatile uint8_t *get_user_offset(sim_handle *h,
+						uint32_t mmio_num,
+						uint64_t offset,
+						uint64_t width)
+{
+	if ((mmio_num >= SIM_MMIO_MAX) ||
+	    (offset % width) ||
+	    (offset + width > h->mmio_size))
+		return NULL;
+
+	return h->mmio_base + offset;
+}
+
+fpga_result __SIM_API__ sim_fpgaWriteMMIO64(fpga_handle handle,
+					    uint32_t mmio_num,
+					    uint64_t offset,
+					    uint64_t value)
+{
+	sim_handle *h;
+	volatile uint8_t *addr;
+	fpga_result res = FPGA_OK;
+	int err;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	addr = get_user_offset(h, mmio_num, offset, sizeof(uint64_t));
+	if (!addr) {
+		res = FPGA_INVALID_PARAM;
+		goto out_unlock;
+	}
+
+	*((volatile uint64_t *)addr) = value;
+	sim_device_kick(h->device);
+
+out_unlock:
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaReadMMIO64(fpga_handle handle,
+					   uint32_t mmio_num,
+					   uint64_t offset,
+					   uint64_t *value)
+{
+	sim_handle *h;
+	volatile uint8_t *addr;
+	fpga_result res = FPGA_OK;
+	int err;
+
+	ASSERT_NOT_NULL(value);
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	addr = get_user_offset(h, mmio_num, offset, sizeof(uint64_t));
+	if (!addr) {
+		res = FPGA_INVALID_PARAM;
+		goto out_unlock;
+	}
+
+	*value = *((volatile uint64_t *)addr);
+
+out_unlock:
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaWriteMMIO32(fpga_handle handle,
+					    uint32_t mmio_num,
+					    uint64_t offset,
+					    uint32_t value)
+{
+	sim_handle *h;
+	volatile uint8_t *addr;
+	fpga_result res = FPGA_OK;
+	int err;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	addr = get_user_offset(h, mmio_num, offset, sizeof(uint32_t));
+	if (!addr) {
+		res = FPGA_INVALID_PARAM;
+		goto out_unlock;
+	}
+
+	*((volatile uint32_t *)addr) = value;
+	sim_device_kick(h->device);
+
+out_unlock:
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaReadMMIO32(fpga_handle handle,
+					   uint32_t mmio_num,
+					   uint64_t offset,
+					   uint32_t *value)
+{
+	sim_handle *h;
+	volatile uint8_t *addr;
+	fpga_result res = FPGA_OK;
+	int err;
+
+	ASSERT_NOT_NULL(value);
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	addr = get_user_offset(h, mmio_num, offset, sizeof(uint32_t));
+	if (!addr) {
+		res = FPGA_INVALID_PARAM;
+		goto out_unlock;
+	}
+
+	*value = *((volatile uint32_t *)addr);
+
+out_unlock:
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaWriteMMIO512(fpga_handle handle,
+					     uint32_t mmio_num,
+					     uint64_t offset,
+					     const void *value)
+{
+	sim_handle *h;
+	volatile uint8_t *addr;
+	fpga_result res = FPGA_OK;
+	int err;
+
+	ASSERT_NOT_NULL(value);
+
+	if ((offset % 64) != 0) {
+		OPAE_ERR("Misaligned MMIO access");
+		return FPGA_INVALID_PARAM;
+	}
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	addr = get_user_offset(h, mmio_num, offset, 64);
+	if (!addr) {
+		res = FPGA_INVALID_PARAM;
+		goto out_unlock;
+	}
+
+	memcpy((uint8_t *)addr, value, 64);
+	sim_device_kick(h->device);
+
+out_unlock:
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaReadMMIOBatch(fpga_handle handle,
+					      fpga_mmio_op *ops,
+					      uint32_t num_ops)
+{
+	sim_handle *h;
+	fpga_result res = FPGA_OK;
+	uint32_t i;
+	int err;
+
+	ASSERT_NOT_NULL(ops);
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	for (i = 0 ; i < num_ops ; ++i) {
+		volatile uint8_t *addr;
+
+		if ((ops[i].width != 64) && (ops[i].width != 32)) {
+			res = FPGA_INVALID_PARAM;
+			goto out_unlock;
+		}
+
+		addr = get_user_offset(h, ops[i].mmio_num, ops[i].offset,
+				       ops[i].width / 8);
+		if (!addr) {
+			res = FPGA_INVALID_PARAM;
+			goto out_unlock;
+		}
+
+		if (ops[i].width == 64)
+			ops[i].value = *((volatile uint64_t *)addr);
+		else
+			ops[i].value = *((volatile uint32_t *)addr);
+	}
+
+out_unlock:
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaWriteMMIOBatch(fpga_handle handle,
+					       const fpga_mmio_op *ops,
+					       uint32_t num_ops)
+{
+	sim_handle *h;
+	fpga_result res = FPGA_OK;
+	uint32_t i;
+	int err;
+
+	ASSERT_NOT_NULL(ops);
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	for (i = 0 ; i < num_ops ; ++i) {
+		volatile uint8_t *addr;
+
+		if ((ops[i].width != 64) && (ops[i].width != 32)) {
+			res = FPGA_INVALID_PARAM;
+			goto out_kick;
+		}
+
+		addr = get_user_offset(h, ops[i].mmio_num, ops[i].offset,
+				       ops[i].width / 8);
+		if (!addr) {
+			res = FPGA_INVALID_PARAM;
+			goto out_kick;
+		}
+
+		if (ops[i].width == 64)
+			*((volatile uint64_t *)addr) = ops[i].value;
+		else
+			*((volatile uint32_t *)addr) = (uint32_t)ops[i].value;
+	}
+
+out_kick:
+	if (i)
+		sim_device_kick(h->device);
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaMapMMIO(fpga_handle handle,
+					uint32_t mmio_num,
+					uint64_t **mmio_ptr)
+{
+	sim_handle *h;
+	fpga_result res = FPGA_OK;
+	int err;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	if (mmio_num >= SIM_MMIO_MAX) {
+		res = FPGA_INVALID_PARAM;
+		goto out_unlock;
+	}
+
+	/* Store return value only if return pointer has allocated memory */
+	if (mmio_ptr)
+		*mmio_ptr = (uint64_t *)h->mmio_base;
+
+out_unlock:
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaUnmapMMIO(fpga_handle handle,
+					  uint32_t mmio_num)
+{
+	sim_handle *h;
+	fpga_result res = FPGA_OK;
+	int err;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	if (mmio_num >= SIM_MMIO_MAX)
+		res = FPGA_INVALID_PARAM;
+
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+STATIC bool matches_filter(const fpga_properties filter, sim_token *t)
+{
+	struct _fpga_properties *_prop = (struct _fpga_properties *)filter;
+
+	// Emulated AFUs have no parent FPGA_DEVICE.
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_PARENT))
+		return false;
+
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_OBJTYPE)) {
+		if (_prop->objtype != t->hdr.objtype)
+			return false;
+
+		if (FIELD_VALID(_prop, FPGA_PROPERTY_ACCELERATOR_STATE))
+			if (_prop->u.accelerator.state !=
+			    FPGA_ACCELERATOR_UNASSIGNED)
+				return false;
+
+		if (FIELD_VALID(_prop, FPGA_PROPERTY_NUM_INTERRUPTS))
+			if (_prop->u.accelerator.num_interrupts !=
+			    t->num_interrupts)
+				return false;
+	}
+
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_SEGMENT))
+		if (_prop->segment != t->hdr.segment)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_BUS))
+		if (_prop->bus != t->hdr.bus)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_DEVICE))
+		if (_prop->device != t->hdr.device)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_FUNCTION))
+		if (_prop->function != t->hdr.function)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_SOCKETID))
+		if (_prop->socket_id != 0)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_VENDORID))
+		if (_prop->vendor_id != t->hdr.vendor_id)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_DEVICEID))
+		if (_prop->device_id != t->hdr.device_id)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_SUB_VENDORID))
+		if (_prop->subsystem_vendor_id != t->hdr.subsystem_vendor_id)
+			return false;
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_SUB_DEVICEID))
+		if (_prop->subsystem_device_id != t->hdr.subsystem_device_id)
+			return false;
+
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_OBJECTID))
+		if (_prop->object_id != t->hdr.object_id)
+			return false;
+
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_GUID))
+		if (memcmp(_prop->guid, t->hdr.guid, sizeof(fpga_guid)))
+			return false;
+
+	if (FIELD_VALID(_prop, FPGA_PROPERTY_INTERFACE))
+		if (_prop->interface != t->hdr.interface)
+			return false;
+
+	return true;
+}
+
+STATIC bool matches_filters(const fpga_properties *filters,
+			    uint32_t num_filters,
+			    sim_token *t)
+{
+	if (!filters)
+		return true;
+
+	for (uint32_t i = 0; i < num_filters; ++i) {
+		if (matches_filter(filters[i], t))
+			return true;
+	}
+
+	return false;
+}
+
+fpga_result __SIM_API__ sim_fpgaEnumerate(const fpga_properties *filters,
+			       uint32_t num_filters, fpga_token *tokens,
+			       uint32_t max_tokens, uint32_t *num_matches)
+{
+	uint32_t matches = 0;
+	uint32_t i;
+
+	for (i = 0 ; i < sim_num_devices ; ++i) {
+		sim_token *t = &sim_tokens[i];
+
+		if (matches_filters(filters, num_filters, t)) {
+			if (matches < max_tokens) {
+				tokens[matches] = clone_token(t);
+				if (!tokens[matches])
+					goto out_free;
+			}
+			++matches;
+		}
+	}
+
+	*num_matches = matches;
+
+	return FPGA_OK;
+
+out_free:
+	while (matches--) {
+		opae_free(tokens[matches]);
+		tokens[matches] = NULL;
+	}
+	return FPGA_NO_MEMORY;
+}
+
+fpga_result __SIM_API__ sim_fpgaCloneToken(fpga_token src, fpga_token *dst)
+{
+	sim_token *_src;
+	sim_token *_dst;
+
+	if (!src || !dst) {
+		OPAE_ERR("src or dst token is NULL");
+		return FPGA_INVALID_PARAM;
+	}
+
+	_src = token_check(src);
+	if (!_src)
+		return FPGA_INVALID_PARAM;
+
+	_dst = clone_token(_src);
+	if (!_dst)
+		return FPGA_NO_MEMORY;
+
+	*dst = _dst;
+	return FPGA_OK;
+}
+
+fpga_result __SIM_API__ sim_fpgaDestroyToken(fpga_token *token)
+{
+	sim_token *t;
+
+	if (!token || !*token) {
+		OPAE_ERR("invalid token pointer");
+		return FPGA_INVALID_PARAM;
+	}
+
+	t = (sim_token *)*token;
+	if (t->hdr.magic == SIM_TOKEN_MAGIC) {
+		t->hdr.magic = 0;
+		opae_free(t);
+		return FPGA_OK;
+	}
+
+	return FPGA_INVALID_PARAM;
+}
+
+#define ROUND_UP(N, M) ((N + M - 1) & ~(M-1))
+
+STATIC sim_buffer *find_buffer(sim_handle *h, uint64_t wsid)
+{
+	sim_buffer *b;
+
+	for (b = h->buffers ; b ; b = b->next) {
+		if ((uint64_t)b == wsid)
+			return b;
+	}
+
+	return NULL;
+}
+
+fpga_result __SIM_API__ sim_fpgaPrepareBuffer(fpga_handle handle,
+					      uint64_t len,
+					      void **buf_addr,
+					      uint64_t *wsid,
+					      int flags)
+{
+	sim_handle *h;
+	sim_buffer *b;
+	void *virt = NULL;
+	unsigned cpu = 0;
+	unsigned node = 0;
+	fpga_result res = FPGA_OK;
+	int err;
+
+	if (flags & FPGA_BUF_PREALLOCATED) {
+		if (!buf_addr && !len) {
+			return FPGA_OK;
+			/* Special case: respond FPGA_OK when
+			** !buf_addr and !len as an indication that
+			** FPGA_BUF_PREALLOCATED is supported by the
+			** library.
+			*/
+		} else if (!buf_addr) {
+			OPAE_ERR("got FPGA_BUF_PREALLOCATED but NULL buf");
+			return FPGA_INVALID_PARAM;
+		} else {
+			virt = *buf_addr;
+		}
+	}
+
+	ASSERT_NOT_NULL(buf_addr);
+	ASSERT_NOT_NULL(wsid);
+
+	if (!len) {
+		OPAE_ERR("buffer length is zero");
+		return FPGA_INVALID_PARAM;
+	}
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	b = opae_calloc(1, sizeof(sim_buffer));
+	if (!b) {
+		OPAE_ERR("Failed to allocate memory for sim_buffer");
+		res = FPGA_NO_MEMORY;
+		goto out_unlock;
+	}
+
+	if (virt) {
+		b->preallocated = true;
+		b->len = len;
+	} else {
+		// Fault the pages in now, as pinning them would,
+		// so that first touch is not charged to the device.
+		b->len = ROUND_UP(len, 4096);
+		virt = mmap(NULL, b->len, PROT_READ|PROT_WRITE,
+			    MAP_PRIVATE|MAP_ANONYMOUS|MAP_POPULATE, -1, 0);
+		if (virt == MAP_FAILED) {
+			if (!(flags & FPGA_BUF_QUIET))
+				OPAE_ERR("mmap failed: %s", strerror(errno));
+			res = FPGA_NO_MEMORY;
+			goto out_free;
+		}
+	}
+	b->virt = virt;
+
+	if (sim_device_map_buffer(h->device, b->virt, b->len, &b->iova)) {
+		OPAE_ERR("error mapping sim buffer");
+		res = FPGA_EXCEPTION;
+		goto out_unmap;
+	}
+
+	b->numa_node = syscall(SYS_getcpu, &cpu, &node, NULL) ? -1 : (int)node;
+
+	b->next = h->buffers;
+	h->buffers = b;
+
+	*buf_addr = virt;
+	*wsid = (uint64_t)b;
+	goto out_unlock;
+
+out_unmap:
+	if (!b->preallocated)
+		munmap(b->virt, b->len);
+out_free:
+	opae_free(b);
+out_unlock:
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaReleaseBuffer(fpga_handle handle,
+					      uint64_t wsid)
+{
+	sim_handle *h;
+	sim_buffer **pb;
+	fpga_result res = FPGA_NOT_FOUND;
+	int err;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	for (pb = &h->buffers ; *pb ; pb = &(*pb)->next) {
+		if ((uint64_t)*pb == wsid) {
+			sim_buffer *b = *pb;
+			*pb = b->next;
+			release_buffer(h, b);
+			res = FPGA_OK;
+			break;
+		}
+	}
+
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaGetIOAddress(fpga_handle handle,
+					     uint64_t wsid,
+					     uint64_t *ioaddr)
+{
+	sim_handle *h;
+	sim_buffer *b;
+	fpga_result res = FPGA_OK;
+	int err;
+
+	ASSERT_NOT_NULL(ioaddr);
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	b = find_buffer(h, wsid);
+	if (b)
+		*ioaddr = b->iova;
+	else
+		res = FPGA_NOT_FOUND;
+
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaGetBufferNumaNode(fpga_handle handle,
+						  uint64_t wsid,
+						  int *node)
+{
+	sim_handle *h;
+	sim_buffer *b;
+	fpga_result res = FPGA_OK;
+	int err;
+
+	ASSERT_NOT_NULL(node);
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	b = find_buffer(h, wsid);
+	if (b)
+		*node = b->numa_node;
+	else
+		res = FPGA_NOT_FOUND;
+
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaCreateEventHandle(fpga_event_handle *event_handle)
+{
+	sim_event_handle *_seh;
+	fpga_result res = FPGA_OK;
+	pthread_mutexattr_t mattr;
+	int err;
+
+	ASSERT_NOT_NULL(event_handle);
+
+	_seh = opae_malloc(sizeof(sim_event_handle));
+	if (!_seh) {
+		OPAE_ERR("Out of memory");
+		return FPGA_NO_MEMORY;
+	}
+
+	_seh->magic = SIM_EVENT_HANDLE_MAGIC;
+	_seh->flags = 0;
+	_seh->device = NULL;
+
+	_seh->fd = eventfd(0, 0);
+	if (_seh->fd < 0) {
+		OPAE_ERR("eventfd : %s", strerror(errno));
+		res = FPGA_EXCEPTION;
+		goto out_free;
+	}
+
+	if (pthread_mutexattr_init(&mattr)) {
+		OPAE_ERR("Failed to init event handle mutex attr");
+		res = FPGA_EXCEPTION;
+		goto out_close;
+	}
+
+	if (pthread_mutexattr_settype(&mattr, PTHREAD_MUTEX_RECURSIVE) ||
+	    pthread_mutex_init(&_seh->lock, &mattr)) {
+		OPAE_ERR("Failed to initialize event handle lock");
+		res = FPGA_EXCEPTION;
+		goto out_attr_destroy;
+	}
+
+	pthread_mutexattr_destroy(&mattr);
+
+	*event_handle = (fpga_event_handle)_seh;
+	return FPGA_OK;
+
+out_attr_destroy:
+	err = pthread_mutexattr_destroy(&mattr);
+	if (err) {
+		OPAE_ERR("pthread_mutexattr_destroy() failed: %s",
+			 strerror(err));
+	}
+out_close:
+	close(_seh->fd);
+out_free:
+	opae_free(_seh);
+	return res;
+}
+
+fpga_result __SIM_API__ sim_fpgaDestroyEventHandle(fpga_event_handle *event_handle)
+{
+	sim_event_handle *_seh;
+	int err;
+
+	ASSERT_NOT_NULL(event_handle);
+
+	_seh = event_handle_check_and_lock(*event_handle);
+	ASSERT_NOT_NULL(_seh);
+
+	// Disconnect the vector before the eventfd goes away.
+	if (_seh->device)
+		sim_device_set_interrupt(_seh->device, _seh->flags, -1);
+
+	if (close(_seh->fd) < 0) {
+		OPAE_ERR("eventfd : %s", strerror(errno));
+		err = pthread_mutex_unlock(&_seh->lock);
+		if (err)
+			OPAE_ERR("pthread_mutex_unlock() failed: %s",
+				 strerror(err));
+		return (errno == EBADF) ? FPGA_INVALID_PARAM : FPGA_EXCEPTION;
+	}
+
+	_seh->magic = 0;
+
+	opae_mutex_unlock(err, &_seh->lock);
+	err = pthread_mutex_destroy(&_seh->lock);
+	if (err)
+		OPAE_ERR("pthread_mutex_destroy() failed: %s",
+			 strerror(errno));
+
+	opae_free(_seh);
+
+	*event_handle = NULL;
+	return FPGA_OK;
+}
+
+fpga_result __SIM_API__ sim_fpgaGetOSObjectFromEventHandle(const fpga_event_handle eh,
+							   int *fd)
+{
+	sim_event_handle *_seh;
+	int err;
+
+	ASSERT_NOT_NULL(eh);
+	ASSERT_NOT_NULL(fd);
+
+	_seh = event_handle_check_and_lock(eh);
+	ASSERT_NOT_NULL(_seh);
+
+	*fd = _seh->fd;
+
+	opae_mutex_unlock(err, &_seh->lock);
+
+	return FPGA_OK;
+}
+
+STATIC fpga_result register_event(sim_handle *_h,
+				  fpga_event_type event_type,
+				  sim_event_handle *_seh,
+				  uint32_t flags)
+{
+	switch (event_type) {
+	case FPGA_EVENT_ERROR:
+		OPAE_ERR("Error interrupts are not currently supported.");
+		return FPGA_NOT_SUPPORTED;
+
+	case FPGA_EVENT_INTERRUPT:
+		if (sim_device_set_interrupt(_h->device, flags, _seh->fd)) {
+			OPAE_ERR("Invalid interrupt vector %u", flags);
+			return FPGA_INVALID_PARAM;
+		}
+		_seh->flags = flags;
+		_seh->device = _h->device;
+		return FPGA_OK;
+
+	case FPGA_EVENT_POWER_THERMAL:
+		OPAE_ERR("Thermal interrupts are not currently supported.");
+		return FPGA_NOT_SUPPORTED;
+	default:
+		OPAE_ERR("Invalid event type");
+		return FPGA_EXCEPTION;
+	}
+}
+
+fpga_result __SIM_API__ sim_fpgaRegisterEvent(fpga_handle handle,
+					      fpga_event_type event_type,
+					      fpga_event_handle event_handle,
+					      uint32_t flags)
+{
+	sim_handle *_h;
+	sim_event_handle *_seh;
+	fpga_result res = FPGA_EXCEPTION;
+	int err;
+
+	ASSERT_NOT_NULL(handle);
+	ASSERT_NOT_NULL(event_handle);
+
+	_h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(_h);
+
+	_seh = event_handle_check_and_lock(event_handle);
+	if (!_seh)
+		goto out_unlock_handle;
+
+	res = register_event(_h, event_type, _seh, flags);
+
+	opae_mutex_unlock(err, &_seh->lock);
+
+out_unlock_handle:
+	opae_mutex_unlock(err, &_h->lock);
+	return res;
+}
+
+STATIC fpga_result unregister_event(sim_handle *_h,
+				    fpga_event_type event_type,
+				    sim_event_handle *_seh)
+{
+	switch (event_type) {
+	case FPGA_EVENT_ERROR:
+		OPAE_ERR("Error interrupts are not currently supported.");
+		return FPGA_NOT_SUPPORTED;
+	case FPGA_EVENT_INTERRUPT:
+		sim_device_set_interrupt(_h->device, _seh->flags, -1);
+		_seh->device = NULL;
+		return FPGA_OK;
+	case FPGA_EVENT_POWER_THERMAL:
+		OPAE_ERR("Thermal interrupts are not currently supported.");
+		return FPGA_NOT_SUPPORTED;
+	default:
+		OPAE_ERR("Invalid event type");
+		return FPGA_EXCEPTION;
+	}
+}
+
+fpga_result __SIM_API__ sim_fpgaUnregisterEvent(fpga_handle handle,
+						fpga_event_type event_type,
+						fpga_event_handle event_handle)
+{
+	sim_handle *_h;
+	sim_event_handle *_seh;
+	fpga_result res = FPGA_EXCEPTION;
+	int err;
+
+	ASSERT_NOT_NULL(handle);
+	ASSERT_NOT_NULL(event_handle);
+
+	_h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(_h);
+
+	_seh = event_handle_check_and_lock(event_handle);
+	if (!_seh)
+		goto out_unlock_handle;
+
+	res = unregister_event(_h, event_type, _seh);
+
+	opae_mutex_unlock(err, &_seh->lock);
+
+out_unlock_handle:
+	opae_mutex_unlock(err, &_h->lock);
+	return res;
+}
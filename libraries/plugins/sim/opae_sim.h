@@ -0,0 +1,84 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifndef _OPAE_SIM_PLUGIN_H
+#define _OPAE_SIM_PLUGIN_H
+#include <pthread.h>
+#include <stdbool.h>
+
+#include <opae/fpga.h>
+
+#include "sim_device.h"
+
+// The PCIe IDs opae.cfg uses to select this plugin. No such
+// device is scanned for in sysfs: the plugin manager always
+// reports it present, so the plugin loads exactly when an
+// enabled configuration lists it.
+#define SIM_VENDOR_ID 0x8086
+#define SIM_DEVICE_ID 0x0a5d
+
+// Emulated devices appear at <SIM_SEGMENT>:00:<index>.0
+#define SIM_SEGMENT 0xfffe
+#define SIM_DEVICES_MAX 32
+#define SIM_POLL_USEC_DEFAULT 20
+
+typedef struct _sim_token {
+	fpga_token_header hdr; //< Must appear at offset 0!
+	uint32_t index;
+	uint32_t num_interrupts;
+	uint64_t mmio_size;
+} sim_token;
+
+typedef struct _sim_buffer {
+	void *virt;
+	uint64_t len;
+	uint64_t iova;
+	int numa_node;
+	bool preallocated;
+	struct _sim_buffer *next;
+} sim_buffer;
+
+typedef struct _sim_handle {
+	uint32_t magic;
+	sim_token *token;
+	sim_device *device;
+	volatile uint8_t *mmio_base;
+	size_t mmio_size;
+	sim_buffer *buffers;
+	pthread_mutex_t lock;
+} sim_handle;
+
+typedef struct _sim_event_handle {
+	uint32_t magic;
+	pthread_mutex_t lock;
+	int fd;
+	uint32_t flags;
+	sim_device *device;
+} sim_event_handle;
+
+int sim_parse_config(const char *json);
+int sim_create_devices(void);
+void sim_free_devices(void);
+#endif // _OPAE_SIM_PLUGIN_H
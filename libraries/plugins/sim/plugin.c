@@ -0,0 +1,127 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <stdlib.h>
+#include <dlfcn.h>
+
+#include <opae/types_enum.h>
+
+#include "adapter.h"
+#include "opae_int.h"
+#include "opae_sim.h"
+#include "mock/opae_std.h"
+
+#ifndef __SIM_API__
+#define __SIM_API__
+#endif
+
+int __SIM_API__ sim_plugin_initialize(void)
+{
+	int res;
+
+	res = sim_create_devices();
+	if (res) {
+		OPAE_ERR("error with sim_create_devices");
+	}
+
+	return res;
+}
+
+int __SIM_API__ sim_plugin_finalize(void)
+{
+	sim_free_devices();
+	return 0;
+}
+
+int __SIM_API__ opae_plugin_configure(opae_api_adapter_table *adapter,
+				      const char *jsonConfig)
+{
+	if (sim_parse_config(jsonConfig))
+		return 1;
+
+	adapter->fpgaOpen = dlsym(adapter->plugin.dl_handle, "sim_fpgaOpen");
+	adapter->fpgaClose = dlsym(adapter->plugin.dl_handle, "sim_fpgaClose");
+	adapter->fpgaReset = dlsym(adapter->plugin.dl_handle, "sim_fpgaReset");
+	adapter->fpgaGetPropertiesFromHandle =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaGetPropertiesFromHandle");
+	adapter->fpgaGetProperties =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaGetProperties");
+	adapter->fpgaUpdateProperties =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaUpdateProperties");
+	adapter->fpgaWriteMMIO64 =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaWriteMMIO64");
+	adapter->fpgaReadMMIO64 =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaReadMMIO64");
+	adapter->fpgaWriteMMIO32 =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaWriteMMIO32");
+	adapter->fpgaReadMMIO32 =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaReadMMIO32");
+	adapter->fpgaWriteMMIO512 =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaWriteMMIO512");
+	adapter->fpgaReadMMIOBatch =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaReadMMIOBatch");
+	adapter->fpgaWriteMMIOBatch =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaWriteMMIOBatch");
+	adapter->fpgaMapMMIO =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaMapMMIO");
+	adapter->fpgaUnmapMMIO =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaUnmapMMIO");
+	adapter->fpgaEnumerate =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaEnumerate");
+	adapter->fpgaCloneToken =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaCloneToken");
+	adapter->fpgaDestroyToken =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaDestroyToken");
+	adapter->fpgaPrepareBuffer =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaPrepareBuffer");
+	adapter->fpgaReleaseBuffer =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaReleaseBuffer");
+	adapter->fpgaGetIOAddress =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaGetIOAddress");
+	adapter->fpgaGetBufferNumaNode =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaGetBufferNumaNode");
+	adapter->fpgaCreateEventHandle =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaCreateEventHandle");
+	adapter->fpgaDestroyEventHandle =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaDestroyEventHandle");
+	adapter->fpgaGetOSObjectFromEventHandle =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaGetOSObjectFromEventHandle");
+	adapter->fpgaRegisterEvent =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaRegisterEvent");
+	adapter->fpgaUnregisterEvent =
+		dlsym(adapter->plugin.dl_handle, "sim_fpgaUnregisterEvent");
+
+	adapter->initialize =
+		dlsym(adapter->plugin.dl_handle, "sim_plugin_initialize");
+	adapter->finalize =
+		dlsym(adapter->plugin.dl_handle, "sim_plugin_finalize");
+
+	return 0;
+}
@@ -0,0 +1,309 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <uuid/uuid.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "afu_model.h"
+#include "sim_device.h"
+
+using opae::sim::afu_model;
+using opae::sim::host_port;
+using opae::sim::mmio_space;
+
+// First IO address handed out. Device addresses deliberately
+// differ from the virtual addresses of the buffers, so that
+// software passing a virtual address to the device is caught.
+#define SIM_IOVA_BASE 0x100000000ULL
+#define SIM_PAGE_SIZE 4096ULL
+// After doing work, the worker polls without sleeping for this
+// long before it falls back to sleeping poll_usec between polls.
+#define SIM_SPIN_USEC 1000
+
+struct _sim_device : public host_port {
+  _sim_device(afu_model::ptr_t m, uint8_t *base, uint32_t usec)
+    : model(std::move(m))
+    , mmio(base, model->mmio_size())
+    , poll_usec(usec)
+    , stop(false)
+    , open_count(0)
+    , exclusive(false)
+    , kicks(0)
+    , next_iova(SIM_IOVA_BASE)
+    , irq_fds(model->num_interrupts(), -1)
+  {
+  }
+
+  uint8_t *translate(uint64_t iova, uint64_t len) override
+  {
+    auto it = buffers.upper_bound(iova);
+    if (it == buffers.begin())
+      return nullptr;
+    --it;
+
+    const buffer &b = it->second;
+    if (iova + len < iova ||
+        iova + len > it->first + b.len)
+      return nullptr;
+
+    return b.virt + (iova - it->first);
+  }
+
+  void interrupt(uint32_t vector) override
+  {
+    uint64_t one = 1;
+
+    if (vector >= irq_fds.size() || irq_fds[vector] < 0)
+      return;
+
+    if (write(irq_fds[vector], &one, sizeof(one)) != sizeof(one)) {
+      // The eventfd counter saturated; the waiter will
+      // still see it readable.
+    }
+  }
+
+  void run()
+  {
+    using clock = std::chrono::steady_clock;
+    std::unique_lock<std::mutex> guard(lock);
+    auto active = clock::now();
+    uint64_t seen = kicks;
+
+    while (!stop) {
+      if (!open_count) {
+        cv.wait(guard, [this]{ return stop || open_count; });
+        active = clock::now();
+        continue;
+      }
+
+      if (model->step(mmio, *this)) {
+        active = clock::now();
+        continue;
+      }
+
+      if (clock::now() - active <
+          std::chrono::microseconds(SIM_SPIN_USEC)) {
+        guard.unlock();
+        std::this_thread::yield();
+        guard.lock();
+        continue;
+      }
+
+      // kicks is bumped without the lock, so a kick may land
+      // between the check and the wait. The timeout bounds the
+      // delay that costs.
+      cv.wait_for(guard, std::chrono::microseconds(poll_usec),
+                  [this, &seen]{ return stop || kicks != seen; });
+      if (kicks != seen) {
+        seen = kicks;
+        active = clock::now();
+      }
+    }
+  }
+
+  struct buffer {
+    uint8_t *virt;
+    uint64_t len;
+  };
+
+  afu_model::ptr_t model;
+  mmio_space mmio;
+  uint32_t poll_usec;
+
+  std::mutex lock;
+  std::condition_variable cv;
+  bool stop;
+  uint32_t open_count;
+  bool exclusive;
+  std::atomic<uint64_t> kicks;
+
+  std::map<uint64_t, buffer> buffers;
+  uint64_t next_iova;
+  std::vector<int> irq_fds;
+
+  std::thread worker;
+};
+
+sim_device *sim_device_create(const char *model, uint32_t poll_usec)
+{
+  void *base = MAP_FAILED;
+  size_t size = 0;
+  sim_device *dev = nullptr;
+
+  // Called from C: nothing may be thrown past here.
+  try {
+    afu_model::ptr_t m = afu_model::create(model);
+    if (!m)
+      return nullptr;
+
+    size = m->mmio_size();
+    base = mmap(nullptr, size, PROT_READ|PROT_WRITE,
+                MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+      return nullptr;
+
+    dev = new sim_device(std::move(m), static_cast<uint8_t *>(base),
+                         poll_usec);
+    dev->model->reset(dev->mmio);
+    dev->worker = std::thread(&sim_device::run, dev);
+  } catch (...) {
+    // The worker is started last, so it never needs joining here.
+    delete dev;
+    if (base != MAP_FAILED)
+      munmap(base, size);
+    return nullptr;
+  }
+
+  return dev;
+}
+
+void sim_device_destroy(sim_device *dev)
+{
+  {
+    std::lock_guard<std::mutex> guard(dev->lock);
+    dev->stop = true;
+  }
+  dev->cv.notify_one();
+  dev->worker.join();
+
+  munmap(dev->mmio.base(), dev->mmio.size());
+  delete dev;
+}
+
+const char **sim_device_models(void)
+{
+  return afu_model::names();
+}
+
+const char *sim_device_model(sim_device *dev)
+{
+  return dev->model->name();
+}
+
+void sim_device_guid(sim_device *dev, fpga_guid guid)
+{
+  if (uuid_parse(dev->model->guid(), guid))
+    uuid_clear(guid);
+}
+
+uint32_t sim_device_num_interrupts(sim_device *dev)
+{
+  return dev->model->num_interrupts();
+}
+
+volatile uint8_t *sim_device_mmio(sim_device *dev, size_t *size)
+{
+  if (size)
+    *size = dev->mmio.size();
+  return dev->mmio.base();
+}
+
+int sim_device_open(sim_device *dev, int exclusive)
+{
+  std::lock_guard<std::mutex> guard(dev->lock);
+
+  if (dev->exclusive || (exclusive && dev->open_count))
+    return 1;
+
+  dev->exclusive = exclusive != 0;
+  if (!dev->open_count++)
+    dev->cv.notify_one();
+
+  return 0;
+}
+
+void sim_device_close(sim_device *dev)
+{
+  std::lock_guard<std::mutex> guard(dev->lock);
+
+  if (dev->open_count && !--dev->open_count)
+    dev->exclusive = false;
+}
+
+void sim_device_kick(sim_device *dev)
+{
+  ++dev->kicks;
+  dev->cv.notify_one();
+}
+
+void sim_device_reset(sim_device *dev)
+{
+  std::lock_guard<std::mutex> guard(dev->lock);
+  dev->model->reset(dev->mmio);
+}
+
+int sim_device_map_buffer(sim_device *dev, void *virt,
+                          uint64_t len, uint64_t *iova)
+{
+  std::lock_guard<std::mutex> guard(dev->lock);
+  uint64_t offset = reinterpret_cast<uintptr_t>(virt) % SIM_PAGE_SIZE;
+  uint64_t addr = dev->next_iova + offset;
+
+  if (!len)
+    return 1;
+
+  try {
+    dev->buffers[addr] = { static_cast<uint8_t *>(virt), len };
+  } catch (...) {
+    return 1;
+  }
+
+  // Keep the page offset, as an IOMMU mapping would.
+  dev->next_iova = (addr + len + SIM_PAGE_SIZE - 1) & ~(SIM_PAGE_SIZE - 1);
+
+  *iova = addr;
+  return 0;
+}
+
+int sim_device_unmap_buffer(sim_device *dev, uint64_t iova)
+{
+  std::lock_guard<std::mutex> guard(dev->lock);
+
+  return dev->buffers.erase(iova) ? 0 : 1;
+}
+
+int sim_device_set_interrupt(sim_device *dev, uint32_t vector, int fd)
+{
+  std::lock_guard<std::mutex> guard(dev->lock);
+
+  if (vector >= dev->irq_fds.size())
+    return 1;
+
+  dev->irq_fds[vector] = fd < 0 ? -1 : fd;
+  return 0;
+}
@@ -0,0 +1,85 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifndef _OPAE_SIM_DEVICE_H
+#define _OPAE_SIM_DEVICE_H
+#include <stdint.h>
+#include <stddef.h>
+
+#include <opae/types.h>
+
+/*
+ * C interface between the plugin entry points (opae_sim.c) and the
+ * emulated device (sim_device.cpp). A sim_device owns the MMIO space
+ * of one AFU model, the table of DMA buffers the model may reach, the
+ * interrupt eventfd's and the worker thread that runs the model.
+ */
+typedef struct _sim_device sim_device;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Create a device running the named model, or NULL if the
+ * model is unknown or the device cannot be allocated. poll_usec
+ * is the worker's idle poll period. */
+sim_device *sim_device_create(const char *model, uint32_t poll_usec);
+void sim_device_destroy(sim_device *dev);
+
+/* The names of the built-in models, NULL terminated. */
+const char **sim_device_models(void);
+
+const char *sim_device_model(sim_device *dev);
+void sim_device_guid(sim_device *dev, fpga_guid guid);
+uint32_t sim_device_num_interrupts(sim_device *dev);
+volatile uint8_t *sim_device_mmio(sim_device *dev, size_t *size);
+
+/* Track the open handles. The worker thread only polls the MMIO
+ * space while the device is open. Returns non-zero when the device
+ * cannot be opened because of an exclusive open. */
+int sim_device_open(sim_device *dev, int exclusive);
+void sim_device_close(sim_device *dev);
+
+/* Wake the worker after an MMIO write made through the API. Writes
+ * made through fpgaMapMMIO() pointers are seen at the next poll. */
+void sim_device_kick(sim_device *dev);
+
+/* Return the model's registers to their power-on values. */
+void sim_device_reset(sim_device *dev);
+
+/* Make [virt, virt + len) reachable by device DMA. */
+int sim_device_map_buffer(sim_device *dev, void *virt,
+			  uint64_t len, uint64_t *iova);
+int sim_device_unmap_buffer(sim_device *dev, uint64_t iova);
+
+/* Signal fd (an eventfd) when the model raises vector. A
+ * negative fd disconnects the vector. */
+int sim_device_set_interrupt(sim_device *dev, uint32_t vector, int fd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _OPAE_SIM_DEVICE_H
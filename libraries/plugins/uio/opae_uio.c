@@ -1120,6 +1120,90 @@ out_unlock:
 	return res;
 }
 
+fpga_result __UIO_API__ uio_fpgaReadMMIOBatch(fpga_handle handle,
+					      fpga_mmio_op *ops,
+					      uint32_t num_ops)
+{
+	uio_handle *h;
+	fpga_result res = FPGA_OK;
+	uint32_t i;
+	int err;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	if (h->token->hdr.objtype == FPGA_DEVICE) {
+		res = FPGA_NOT_SUPPORTED;
+		goto out_unlock;
+	}
+
+	for (i = 0 ; i < num_ops ; ++i) {
+		volatile uint8_t *addr;
+
+		if (ops[i].mmio_num >= USER_MMIO_MAX) {
+			res = FPGA_INVALID_PARAM;
+			goto out_unlock;
+		}
+
+		addr = get_user_offset(h, ops[i].mmio_num, ops[i].offset);
+
+		if (ops[i].width == 64) {
+			ops[i].value = *((volatile uint64_t *)addr);
+		} else if (ops[i].width == 32) {
+			ops[i].value = *((volatile uint32_t *)addr);
+		} else {
+			res = FPGA_INVALID_PARAM;
+			goto out_unlock;
+		}
+	}
+
+out_unlock:
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
+fpga_result __UIO_API__ uio_fpgaWriteMMIOBatch(fpga_handle handle,
+					       const fpga_mmio_op *ops,
+					       uint32_t num_ops)
+{
+	uio_handle *h;
+	fpga_result res = FPGA_OK;
+	uint32_t i;
+	int err;
+
+	h = handle_check_and_lock(handle);
+	ASSERT_NOT_NULL(h);
+
+	if (h->token->hdr.objtype == FPGA_DEVICE) {
+		res = FPGA_NOT_SUPPORTED;
+		goto out_unlock;
+	}
+
+	for (i = 0 ; i < num_ops ; ++i) {
+		volatile uint8_t *addr;
+
+		if (ops[i].mmio_num >= USER_MMIO_MAX) {
+			res = FPGA_INVALID_PARAM;
+			goto out_unlock;
+		}
+
+		addr = get_user_offset(h, ops[i].mmio_num, ops[i].offset);
+
+		if (ops[i].width == 64) {
+			*((volatile uint64_t *)addr) = ops[i].value;
+		} else if (ops[i].width == 32) {
+			*((volatile uint32_t *)addr) = (uint32_t)ops[i].value;
+		} else {
+			res = FPGA_INVALID_PARAM;
+			goto out_unlock;
+		}
+	}
+
+out_unlock:
+	opae_mutex_unlock(err, &h->lock);
+	return res;
+}
+
 fpga_result __UIO_API__ uio_fpgaMapMMIO(fpga_handle handle,
 					uint32_t mmio_num,
 					uint64_t **mmio_ptr)
@@ -106,6 +106,10 @@ int __UIO_API__ opae_plugin_configure(opae_api_adapter_table *adapter,
 		dlsym(adapter->plugin.dl_handle, "uio_fpgaReadMMIO32");
 	adapter->fpgaWriteMMIO512 =
 		dlsym(adapter->plugin.dl_handle, "uio_fpgaWriteMMIO512");
+	adapter->fpgaReadMMIOBatch =
+		dlsym(adapter->plugin.dl_handle, "uio_fpgaReadMMIOBatch");
+	adapter->fpgaWriteMMIOBatch =
+		dlsym(adapter->plugin.dl_handle, "uio_fpgaWriteMMIOBatch");
 	adapter->fpgaMapMMIO =
 		dlsym(adapter->plugin.dl_handle, "uio_fpgaMapMMIO");
 	adapter->fpgaUnmapMMIO =
@@ -971,6 +971,14 @@ out_unlock:
 	return res;
 }
 
+/*
+ * The MMIO accessors below do not take h->lock. The handle's
+ * token is a private clone made by vfio_fpgaOpen(), and neither
+ * it (objtype, user_mmio[]) nor mmio_base changes until
+ * vfio_fpgaClose(), so validating the handle magic is sufficient.
+ * This lets many threads share one handle for CSR access without
+ * serializing on the handle mutex.
+ */
 static inline volatile uint8_t *get_user_offset(vfio_handle *h,
 						uint32_t mmio_num,
 						uint32_t offset)
@@ -980,7 +988,6 @@ static inline volatile uint8_t *get_user_offset(vfio_handle *h,
 	return h->mmio_base + user_mmio + offset;
 }
 
-
 fpga_result __VFIO_API__ vfio_fpgaWriteMMIO64(fpga_handle handle,
 					      uint32_t mmio_num,
 					      uint64_t offset,
@@ -988,29 +995,21 @@ fpga_result __VFIO_API__ vfio_fpgaWriteMMIO64(fpga_handle handle,
 {
 	vfio_handle *h;
 	vfio_token *t;
-	fpga_result res = FPGA_OK;
-	int err;
 
-	h = handle_check_and_lock(handle);
+	h = handle_check(handle);
 	ASSERT_NOT_NULL(h);
 
 	t = h->token;
 
-	if (t->hdr.objtype == FPGA_DEVICE) {
-		res = FPGA_NOT_SUPPORTED;
-		goto out_unlock;
-	}
+	if (t->hdr.objtype == FPGA_DEVICE)
+		return FPGA_NOT_SUPPORTED;
 
-	if (mmio_num >= USER_MMIO_MAX) {
-		res = FPGA_INVALID_PARAM;
-		goto out_unlock;
-	}
+	if (mmio_num >= USER_MMIO_MAX)
+		return FPGA_INVALID_PARAM;
 
 	*((volatile uint64_t *)get_user_offset(h, mmio_num, offset)) = value;
 
-out_unlock:
-	opae_mutex_unlock(err, &h->lock);
-	return res;
+	return FPGA_OK;
 }
 
 fpga_result __VFIO_API__ vfio_fpgaReadMMIO64(fpga_handle handle,
@@ -1020,29 +1019,21 @@ fpga_result __VFIO_API__ vfio_fpgaReadMMIO64(fpga_handle handle,
 {
 	vfio_handle *h;
 	vfio_token *t;
-	fpga_result res = FPGA_OK;
-	int err;
 
-	h = handle_check_and_lock(handle);
+	h = handle_check(handle);
 	ASSERT_NOT_NULL(h);
 
 	t = h->token;
 
-	if (t->hdr.objtype == FPGA_DEVICE) {
-		res = FPGA_NOT_SUPPORTED;
-		goto out_unlock;
-	}
+	if (t->hdr.objtype == FPGA_DEVICE)
+		return FPGA_NOT_SUPPORTED;
 
-	if (mmio_num >= USER_MMIO_MAX) {
-		res = FPGA_INVALID_PARAM;
-		goto out_unlock;
-	}
+	if (mmio_num >= USER_MMIO_MAX)
+		return FPGA_INVALID_PARAM;
 
 	*value = *((volatile uint64_t *)get_user_offset(h, mmio_num, offset));
 
-out_unlock:
-	opae_mutex_unlock(err, &h->lock);
-	return res;
+	return FPGA_OK;
 }
 
 fpga_result __VFIO_API__ vfio_fpgaWriteMMIO32(fpga_handle handle,
@@ -1052,29 +1043,21 @@ fpga_result __VFIO_API__ vfio_fpgaWriteMMIO32(fpga_handle handle,
 {
 	vfio_handle *h;
 	vfio_token *t;
-	fpga_result res = FPGA_OK;
-	int err;
 
-	h = handle_check_and_lock(handle);
+	h = handle_check(handle);
 	ASSERT_NOT_NULL(h);
 
 	t = h->token;
 
-	if (t->hdr.objtype == FPGA_DEVICE) {
-		res = FPGA_NOT_SUPPORTED;
-		goto out_unlock;
-	}
+	if (t->hdr.objtype == FPGA_DEVICE)
+		return FPGA_NOT_SUPPORTED;
 
-	if (mmio_num >= USER_MMIO_MAX) {
-		res = FPGA_INVALID_PARAM;
-		goto out_unlock;
-	}
+	if (mmio_num >= USER_MMIO_MAX)
+		return FPGA_INVALID_PARAM;
 
 	*((volatile uint32_t *)get_user_offset(h, mmio_num, offset)) = value;
 
-out_unlock:
-	opae_mutex_unlock(err, &h->lock);
-	return res;
+	return FPGA_OK;
 }
 
 fpga_result __VFIO_API__ vfio_fpgaReadMMIO32(fpga_handle handle,
@@ -1084,30 +1067,21 @@ fpga_result __VFIO_API__ vfio_fpgaReadMMIO32(fpga_handle handle,
 {
 	vfio_handle *h;
 	vfio_token *t;
-	fpga_result res = FPGA_OK;
-	int err;
 
-	h = handle_check_and_lock(handle);
+	h = handle_check(handle);
 	ASSERT_NOT_NULL(h);
 
 	t = h->token;
 
-	if (t->hdr.objtype == FPGA_DEVICE) {
-		res = FPGA_NOT_SUPPORTED;
-		goto out_unlock;
-	}
+	if (t->hdr.objtype == FPGA_DEVICE)
+		return FPGA_NOT_SUPPORTED;
 
-	if (mmio_num >= USER_MMIO_MAX) {
-		res = FPGA_INVALID_PARAM;
-		goto out_unlock;
-	}
+	if (mmio_num >= USER_MMIO_MAX)
+		return FPGA_INVALID_PARAM;
 
 	*value = *((volatile uint32_t *)get_user_offset(h, mmio_num, offset));
 
-out_unlock:
-	opae_mutex_unlock(err, &h->lock);
-
-	return res;
+	return FPGA_OK;
 }
 
 #if defined(__i386__) || defined(__x86_64__) || defined(__ia64__) && GCC_VERSION >= 40900
@@ -1133,35 +1107,91 @@ fpga_result __VFIO_API__ vfio_fpgaWriteMMIO512(fpga_handle handle,
 {
 	vfio_handle *h;
 	vfio_token *t;
-	fpga_result res = FPGA_OK;
-	int err;
 
 	if ((offset % 64) != 0) {
 		OPAE_ERR("Misaligned MMIO access");
 		return FPGA_INVALID_PARAM;
 	}
 
-	h = handle_check_and_lock(handle);
+	h = handle_check(handle);
 	ASSERT_NOT_NULL(h);
 
 	t = h->token;
 
 	if ((t->hdr.objtype == FPGA_DEVICE) ||
-	    !(h->flags & OPAE_FLAG_HAS_AVX512)) {
-		res = FPGA_NOT_SUPPORTED;
-		goto out_unlock;
-	}
+	    !(h->flags & OPAE_FLAG_HAS_AVX512))
+		return FPGA_NOT_SUPPORTED;
 
-	if (mmio_num >= USER_MMIO_MAX) {
-		res = FPGA_INVALID_PARAM;
-		goto out_unlock;
-	}
+	if (mmio_num >= USER_MMIO_MAX)
+		return FPGA_INVALID_PARAM;
 
 	copy512(value, (uint8_t *)get_user_offset(h, mmio_num, offset));
 
-out_unlock:
-	opae_mutex_unlock(err, &h->lock);
-	return res;
+	return FPGA_OK;
+}
+
+fpga_result __VFIO_API__ vfio_fpgaReadMMIOBatch(fpga_handle handle,
+						fpga_mmio_op *ops,
+						uint32_t num_ops)
+{
+	vfio_handle *h;
+	uint32_t i;
+
+	h = handle_check(handle);
+	ASSERT_NOT_NULL(h);
+
+	if (h->token->hdr.objtype == FPGA_DEVICE)
+		return FPGA_NOT_SUPPORTED;
+
+	for (i = 0 ; i < num_ops ; ++i) {
+		volatile uint8_t *addr;
+
+		if (ops[i].mmio_num >= USER_MMIO_MAX)
+			return FPGA_INVALID_PARAM;
+
+		addr = get_user_offset(h, ops[i].mmio_num, ops[i].offset);
+
+		if (ops[i].width == 64)
+			ops[i].value = *((volatile uint64_t *)addr);
+		else if (ops[i].width == 32)
+			ops[i].value = *((volatile uint32_t *)addr);
+		else
+			return FPGA_INVALID_PARAM;
+	}
+
+	return FPGA_OK;
+}
+
+fpga_result __VFIO_API__ vfio_fpgaWriteMMIOBatch(fpga_handle handle,
+						 const fpga_mmio_op *ops,
+						 uint32_t num_ops)
+{
+	vfio_handle *h;
+	uint32_t i;
+
+	h = handle_check(handle);
+	ASSERT_NOT_NULL(h);
+
+	if (h->token->hdr.objtype == FPGA_DEVICE)
+		return FPGA_NOT_SUPPORTED;
+
+	for (i = 0 ; i < num_ops ; ++i) {
+		volatile uint8_t *addr;
+
+		if (ops[i].mmio_num >= USER_MMIO_MAX)
+			return FPGA_INVALID_PARAM;
+
+		addr = get_user_offset(h, ops[i].mmio_num, ops[i].offset);
+
+		if (ops[i].width == 64)
+			*((volatile uint64_t *)addr) = ops[i].value;
+		else if (ops[i].width == 32)
+			*((volatile uint32_t *)addr) = (uint32_t)ops[i].value;
+		else
+			return FPGA_INVALID_PARAM;
+	}
+
+	return FPGA_OK;
 }
 
 fpga_result __VFIO_API__ vfio_fpgaMapMMIO(fpga_handle handle,
@@ -1377,18 +1407,48 @@ STATIC uint32_t vfio_irq_count(struct opae_vfio *device)
 	return 0;
 }
 
+// When set, each device is walked (and the interrupt count of each of
+// its tokens read) once, and later enumerations reuse the results until
+// vfio_fpgaEnumerateRefresh(). The accelerator state is not cached.
+bool opae_v_enum_cache;
+
+/// Determine if filters inspect fields that a cached walk or probe
+/// may no longer reflect: the AFU GUID, which changes with partial
+/// reconfiguration, and the interrupt count, which can only be read
+/// while no other process holds the device.
+STATIC bool filters_need_walk(const fpga_properties *filters,
+			      uint32_t num_filters)
+{
+	if (!filters)
+		return false;
+
+	for (uint32_t i = 0; i < num_filters; ++i) {
+		struct _fpga_properties *_prop =
+			(struct _fpga_properties *)filters[i];
+
+		if (FIELD_VALID(_prop, FPGA_PROPERTY_GUID) ||
+		    FIELD_VALID(_prop, FPGA_PROPERTY_NUM_INTERRUPTS))
+			return true;
+	}
+
+	return false;
+}
+
 fpga_result __VFIO_API__ vfio_fpgaEnumerate(const fpga_properties *filters,
 			       uint32_t num_filters, fpga_token *tokens,
 			       uint32_t max_tokens, uint32_t *num_matches)
 {
 	vfio_pci_device_t *dev = _pci_devices;
 	uint32_t matches = 0;
+	bool rewalk = !opae_v_enum_cache ||
+		      filters_need_walk(filters, num_filters);
 
 	while (dev) {
 		if (pci_matches_filters(filters, num_filters, dev)) {
 			vfio_token *tptr;
 
-			vfio_walk(dev);
+			if (rewalk || !dev->walked)
+				dev->walked = !vfio_walk(dev);
 			tptr = dev->tokens;
 
 			while (tptr) {
@@ -1409,9 +1469,15 @@ fpga_result __VFIO_API__ vfio_fpgaEnumerate(const fpga_properties *filters,
 				if (tptr->hdr.objtype == FPGA_DEVICE)
 					memcpy(tptr->hdr.guid, tptr->compat_id, sizeof(fpga_guid));
 
+				// Whether the device is held by a process changes
+				// with no event to invalidate a cache, so the state
+				// is read on every enumeration.
 				res = open_vfio_pair(tptr->device->addr, &pair);
 				if (res == FPGA_OK) {
-					tptr->num_afu_irqs = vfio_irq_count(pair->device);
+					if (rewalk || !tptr->probed) {
+						tptr->num_afu_irqs = vfio_irq_count(pair->device);
+						tptr->probed = true;
+					}
 
 					close_vfio_pair(&pair);
 					tptr->afu_state = FPGA_ACCELERATOR_UNASSIGNED;
@@ -1437,6 +1503,21 @@ fpga_result __VFIO_API__ vfio_fpgaEnumerate(const fpga_properties *filters,
 	return FPGA_OK;
 }
 
+fpga_result __VFIO_API__ vfio_fpgaEnumerateRefresh(void)
+{
+	vfio_pci_device_t *dev;
+
+	for (dev = _pci_devices ; dev ; dev = dev->next) {
+		vfio_token *tptr;
+
+		dev->walked = false;
+		for (tptr = dev->tokens ; tptr ; tptr = tptr->next)
+			tptr->probed = false;
+	}
+
+	return FPGA_OK;
+}
+
 fpga_result __VFIO_API__ vfio_fpgaCloneToken(fpga_token src, fpga_token *dst)
 {
 	vfio_token *_src;
@@ -1487,6 +1568,7 @@ fpga_result __VFIO_API__ vfio_fpgaDestroyToken(fpga_token *token)
 
 #define HUGE_1G (1*1024*1024*1024)
 #define HUGE_2M (2*1024*1024)
+#define POOL_64K (64*1024)
 #define ROUND_UP(N, M) ((N + M - 1) & ~(M-1))
 
 fpga_result __VFIO_API__ vfio_fpgaPrepareBuffer(fpga_handle handle,
@@ -1525,15 +1607,42 @@ fpga_result __VFIO_API__ vfio_fpgaPrepareBuffer(fpga_handle handle,
 	struct opae_vfio *v = h->vfio_pair->device;
 	uint64_t iova = 0;
 	size_t sz;
-	if (len > HUGE_2M)
+	int vfio_flags = 0;
+
+	if (flags & FPGA_BUF_PREALLOCATED)
+		vfio_flags |= OPAE_VFIO_BUF_PREALLOCATED;
+	if (flags & FPGA_BUF_NUMA_ANY)
+		vfio_flags |= OPAE_VFIO_BUF_NUMA_ANY;
+	if (flags & FPGA_BUF_SCATTER_GATHER)
+		vfio_flags |= OPAE_VFIO_BUF_SCATTER_GATHER;
+
+	if (len > HUGE_2M && !(flags & FPGA_BUF_SCATTER_GATHER))
 		sz = ROUND_UP(len, HUGE_1G);
-	else if (len > 4096)
+	else if (len > POOL_64K)
 		sz = ROUND_UP(len, HUGE_2M);
+	else if (len > 4096)
+		sz = POOL_64K;
 	else
 		sz = 4096;
-	if (opae_vfio_buffer_allocate_ex(v, &sz, &virt, &iova, flags)) {
-		OPAE_DBG("could not allocate buffer");
-		return FPGA_EXCEPTION;
+	if (opae_vfio_buffer_allocate_ex(v, &sz, &virt, &iova, vfio_flags)) {
+		if ((len <= HUGE_2M) ||
+		    (vfio_flags & (OPAE_VFIO_BUF_PREALLOCATED|
+				   OPAE_VFIO_BUF_SCATTER_GATHER))) {
+			OPAE_DBG("could not allocate buffer");
+			return FPGA_EXCEPTION;
+		}
+
+		// No 1GB page to be had. The IOMMU can stitch smaller
+		// pages into the same contiguous IOVA range.
+		OPAE_DBG("no 1GB page for 0x%lx bytes, using scatter-gather",
+			 len);
+		vfio_flags |= OPAE_VFIO_BUF_SCATTER_GATHER;
+		sz = ROUND_UP(len, HUGE_2M);
+		if (opae_vfio_buffer_allocate_ex(v, &sz, &virt,
+						 &iova, vfio_flags)) {
+			OPAE_DBG("could not allocate buffer");
+			return FPGA_EXCEPTION;
+		}
 	}
 	binfo = opae_vfio_buffer_info(v, virt);
 
@@ -1597,6 +1706,27 @@ fpga_result __VFIO_API__ vfio_fpgaGetIOAddress(fpga_handle handle,
 	return FPGA_OK;
 }
 
+fpga_result __VFIO_API__ vfio_fpgaGetBufferNumaNode(fpga_handle handle,
+						    uint64_t wsid,
+						    int *node)
+{
+	vfio_handle *h;
+
+	ASSERT_NOT_NULL(node);
+
+	struct opae_vfio_buffer *binfo = (struct opae_vfio_buffer *)wsid;
+
+	ASSERT_NOT_NULL(binfo);
+
+	h = handle_check(handle);
+	ASSERT_NOT_NULL(h);
+
+	*node = opae_vfio_buffer_numa_node(h->vfio_pair->device,
+					   binfo->buffer_ptr);
+
+	return FPGA_OK;
+}
+
 fpga_result __VFIO_API__ vfio_fpgaBindSVA(fpga_handle handle, uint32_t *pasid)
 {
 	vfio_handle *h;
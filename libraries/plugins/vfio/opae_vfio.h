@@ -58,6 +58,7 @@ typedef struct _vfio_pci_device {
 	uint32_t numa_node;
 	uint16_t subsystem_vendor;
 	uint16_t subsystem_device;
+	bool walked;
 	struct _vfio_token *tokens;
 	struct _vfio_pci_device *next;
 } vfio_pci_device_t;
@@ -80,6 +81,7 @@ typedef struct _vfio_token {
 	uint8_t num_ports;
 	fpga_accelerator_state afu_state;
 	uint32_t num_afu_irqs;
+	bool probed;
 	struct _vfio_token *parent;
 	struct _vfio_token *next;
 	vfio_ops ops;
@@ -29,6 +29,7 @@
 #endif // HAVE_CONFIG_H
 
 #include <stdlib.h>
+#include <string.h>
 #include <dlfcn.h>
 
 #include <opae/types_enum.h>
@@ -44,12 +45,14 @@
 #endif
 
 extern libopae_config_data *opae_v_supported_devices;
+extern bool opae_v_enum_cache;
 
 int __VFIO_API__ vfio_plugin_initialize(void)
 {
 	int res;
 	char *raw_cfg = NULL;
 	char *cfg_file;
+	const char *env;
 
 	cfg_file = opae_find_cfg_file();
 	if (cfg_file)
@@ -62,6 +65,9 @@ int __VFIO_API__ vfio_plugin_initialize(void)
 		cfg_file = NULL;
 	}
 
+	env = getenv("LIBOPAE_ENUM_CACHE");
+	opae_v_enum_cache = !env || strcmp(env, "0");
+
 	res = vfio_pci_discover(NULL);
 	if (res) {
 		OPAE_ERR("error with vfio_pci_discover");
@@ -73,6 +79,7 @@ int __VFIO_API__ vfio_plugin_initialize(void)
 int __VFIO_API__ vfio_plugin_finalize(void)
 {
 	vfio_free_device_list();
+	opae_v_enum_cache = false;
 
 	opae_free_libopae_config(opae_v_supported_devices);
 	opae_v_supported_devices = NULL;
@@ -106,12 +113,18 @@ int __VFIO_API__ opae_plugin_configure(opae_api_adapter_table *adapter,
 		dlsym(adapter->plugin.dl_handle, "vfio_fpgaReadMMIO32");
 	adapter->fpgaWriteMMIO512 =
 		dlsym(adapter->plugin.dl_handle, "vfio_fpgaWriteMMIO512");
+	adapter->fpgaReadMMIOBatch =
+		dlsym(adapter->plugin.dl_handle, "vfio_fpgaReadMMIOBatch");
+	adapter->fpgaWriteMMIOBatch =
+		dlsym(adapter->plugin.dl_handle, "vfio_fpgaWriteMMIOBatch");
 	adapter->fpgaMapMMIO =
 		dlsym(adapter->plugin.dl_handle, "vfio_fpgaMapMMIO");
 	adapter->fpgaUnmapMMIO =
 		dlsym(adapter->plugin.dl_handle, "vfio_fpgaUnmapMMIO");
 	adapter->fpgaEnumerate =
 		dlsym(adapter->plugin.dl_handle, "vfio_fpgaEnumerate");
+	adapter->fpgaEnumerateRefresh =
+		dlsym(adapter->plugin.dl_handle, "vfio_fpgaEnumerateRefresh");
 	adapter->fpgaCloneToken =
 		dlsym(adapter->plugin.dl_handle, "vfio_fpgaCloneToken");
 	adapter->fpgaDestroyToken =
@@ -122,6 +135,8 @@ int __VFIO_API__ opae_plugin_configure(opae_api_adapter_table *adapter,
 		dlsym(adapter->plugin.dl_handle, "vfio_fpgaReleaseBuffer");
 	adapter->fpgaGetIOAddress =
 		dlsym(adapter->plugin.dl_handle, "vfio_fpgaGetIOAddress");
+	adapter->fpgaGetBufferNumaNode =
+		dlsym(adapter->plugin.dl_handle, "vfio_fpgaGetBufferNumaNode");
 	adapter->fpgaBindSVA =
 		dlsym(adapter->plugin.dl_handle, "vfio_fpgaBindSVA");
 	adapter->fpgaCreateEventHandle =
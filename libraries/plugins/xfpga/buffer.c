@@ -39,6 +39,8 @@
 #include <sys/stat.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <unistd.h>
@@ -85,13 +87,13 @@ STATIC fpga_result buffer_allocate(void **addr, uint64_t len, int flags)
 }
 
 /*
- * Release (unmap) allocated buffer
+ * Length of the mapping made by buffer_allocate for len
  */
-STATIC fpga_result buffer_release(void *addr, uint64_t len)
+STATIC uint64_t buffer_mapped_len(uint64_t len)
 {
 	/* If the buffer allocation was backed by hugepages, then
 	 * len must be rounded up to the nearest hugepage size,
-	 * otherwise munmap will fail.
+	 * otherwise munmap (and mbind) will fail.
 	 *
 	 * Buffer with size larger than 2MB is backed by 1GB page(s),
 	 * round up the size to the nearest GB boundary.
@@ -108,6 +110,41 @@ STATIC fpga_result buffer_release(void *addr, uint64_t len)
 	else if (len > 4 * KB)
 		len = 2 * MB;
 
+	return len;
+}
+
+#define MAX_NUMA_NODES 1024
+#define ULONG_BITS (8 * sizeof(unsigned long))
+
+/*
+ * Prefer pages from node for the buffer at addr. This must happen
+ * before the pages are first touched, which for us is the DMA map
+ * ioctl that pins them. MPOL_PREFERRED rather than MPOL_BIND, so that
+ * a node without free huge pages falls back to another node instead
+ * of failing the fault with SIGBUS.
+ */
+STATIC void buffer_numa_prefer(void *addr, uint64_t len, int node)
+{
+	unsigned long mask[MAX_NUMA_NODES / ULONG_BITS];
+
+	if ((node < 0) || (node >= MAX_NUMA_NODES))
+		return;
+
+	memset(mask, 0, sizeof(mask));
+	mask[node / ULONG_BITS] = 1UL << (node % ULONG_BITS);
+
+	if (syscall(SYS_mbind, addr, buffer_mapped_len(len), MPOL_PREFERRED,
+		    mask, MAX_NUMA_NODES + 1, 0))
+		OPAE_DBG("mbind to node %d failed: %s", node, strerror(errno));
+}
+
+/*
+ * Release (unmap) allocated buffer
+ */
+STATIC fpga_result buffer_release(void *addr, uint64_t len)
+{
+	len = buffer_mapped_len(len);
+
 	if (munmap(addr, len)) {
 		OPAE_MSG("FPGA buffer munmap failed: %s",
 			 strerror(errno));
@@ -131,6 +168,7 @@ fpga_result __XFPGA_API__ xfpga_fpgaPrepareBuffer(fpga_handle handle, uint64_t l
 	bool quiet = (flags & FPGA_BUF_QUIET);
 
 	bool read_only = (flags & FPGA_BUF_READ_ONLY);
+	bool numa_any = (flags & FPGA_BUF_NUMA_ANY);
 	uint32_t map_flags = (read_only ? FPGA_DMA_TO_DEV : 0);
 
 	uint64_t pg_size;
@@ -147,12 +185,21 @@ fpga_result __XFPGA_API__ xfpga_fpgaPrepareBuffer(fpga_handle handle, uint64_t l
 	}
 
 	if (flags & (~(FPGA_BUF_PREALLOCATED | FPGA_BUF_QUIET |
-		       FPGA_BUF_READ_ONLY))) {
+		       FPGA_BUF_READ_ONLY | FPGA_BUF_NUMA_ANY |
+		       FPGA_BUF_SCATTER_GATHER))) {
 		OPAE_MSG("Unrecognized flags");
 		result = FPGA_INVALID_PARAM;
 		goto out_unlock;
 	}
 
+	/* The port DMA map wants physically contiguous pages, and picks
+	 * the IOVA itself, so it can't stitch pages into one range. */
+	if (flags & FPGA_BUF_SCATTER_GATHER) {
+		OPAE_MSG("Scatter-gather buffers not supported");
+		result = FPGA_NOT_SUPPORTED;
+		goto out_unlock;
+	}
+
 	pg_size = (uint64_t) sysconf(_SC_PAGE_SIZE);
 
 	if (preallocated) {
@@ -205,6 +252,9 @@ fpga_result __XFPGA_API__ xfpga_fpgaPrepareBuffer(fpga_handle handle, uint64_t l
 		if (result != FPGA_OK) {
 			goto out_unlock;
 		}
+
+		if (!numa_any)
+			buffer_numa_prefer(addr, len, _handle->numa_node);
 	}
 
 	if (opae_port_map(_handle->fddev, addr, len, map_flags, &io_addr)) {
@@ -341,3 +391,40 @@ fpga_result __XFPGA_API__ xfpga_fpgaGetIOAddress(fpga_handle handle, uint64_t ws
 	}
 	return result;
 }
+
+fpga_result __XFPGA_API__ xfpga_fpgaGetBufferNumaNode(fpga_handle handle,
+						      uint64_t wsid,
+						      int *node)
+{
+	struct _fpga_handle *_handle = (struct _fpga_handle *)handle;
+	struct wsid_map *wm;
+	fpga_result result = FPGA_OK;
+	int err;
+
+	ASSERT_NOT_NULL(node);
+
+	result = handle_check_and_lock(_handle);
+	if (result)
+		return result;
+
+	wm = wsid_find(_handle->wsid_root, wsid);
+	if (!wm) {
+		OPAE_MSG("WSID not found");
+		result = FPGA_NOT_FOUND;
+		goto out_unlock;
+	}
+
+	*node = -1;
+	if (syscall(SYS_get_mempolicy, node, NULL, 0, (void *)wm->addr,
+		    MPOL_F_NODE | MPOL_F_ADDR)) {
+		OPAE_DBG("get_mempolicy failed: %s", strerror(errno));
+		*node = -1;
+	}
+
+out_unlock:
+	err = pthread_mutex_unlock(&_handle->lock);
+	if (err) {
+		OPAE_ERR("pthread_mutex_unlock() failed: %s", strerror(err));
+	}
+	return result;
+}
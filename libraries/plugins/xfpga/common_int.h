@@ -88,4 +88,9 @@ fpga_result prop_check_and_lock(struct _fpga_properties *prop);
 fpga_result handle_check_and_lock(struct _fpga_handle *handle);
 fpga_result event_handle_check_and_lock(struct _fpga_event_handle *eh);
 
+/* Enumeration cache */
+int enum_cache_initialize(void);
+void enum_cache_finalize(void);
+void enum_cache_invalidate(void);
+
 #endif // ___FPGA_COMMON_INT_H__
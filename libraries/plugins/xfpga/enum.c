@@ -33,6 +33,7 @@
 #include <errno.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/inotify.h>
 #include <dirent.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -62,6 +63,10 @@ struct dev_list {
 	struct dev_list *next;
 	struct dev_list *parent;
 	struct dev_list *fme;
+
+	// Only used by the enumeration cache.
+	struct error_list *errors;
+	bool synced;
 };
 
 STATIC bool matches_filter(const struct dev_list *attr, const fpga_properties filter)
@@ -682,7 +687,10 @@ struct _fpga_token *token_add(struct dev_list *dev)
 	}
 
 	_tok->errors = NULL;
-	build_error_list(errpath, &_tok->errors);
+	if (dev->errors)
+		_tok->errors = clone_error_list(dev->errors);
+	else
+		build_error_list(errpath, &_tok->errors);
 
 	/* mark data structure as valid/populate header fields */
 	_tok->hdr = dev->hdr;
@@ -703,6 +711,265 @@ struct _fpga_token *token_add(struct dev_list *dev)
 	return _tok;
 }
 
+STATIC void free_dev_list(struct dev_list *head)
+{
+	struct dev_list *lptr;
+
+	for (lptr = head->next; NULL != lptr;) {
+		struct dev_list *trash = lptr;
+		struct error_list *err = lptr->errors;
+
+		while (err) {
+			struct error_list *e = err;
+			err = err->next;
+			opae_free(e);
+		}
+
+		lptr = lptr->next;
+		opae_free(trash);
+	}
+
+	head->next = NULL;
+}
+
+/*
+ * The enumeration cache holds the dev_list built by the last full scan,
+ * with every node already synced, so that a warm xfpga_fpgaEnumerate()
+ * only matches filters and copies tokens. The cache is dropped when an
+ * FME or port device node appears in or disappears from FPGA_DEV_PATH
+ * (observed through inotify), when the sysfs directory of a cached node
+ * is gone, after a successful reconfiguration, and on
+ * xfpga_fpgaEnumerateRefresh().
+ *
+ * The accelerator state, and the MMIO/IRQ counts learned by opening the
+ * port, change without any device node event, as does the AFU GUID after
+ * a partial reconfiguration by another process. Accelerators are resynced
+ * whenever a filter inspects one of those fields.
+ */
+STATIC struct dev_list _enum_cache;
+STATIC bool _enum_cache_valid;
+STATIC bool _enum_cache_enabled;
+STATIC int _enum_cache_notify = -1;
+STATIC pthread_mutex_t _enum_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+STATIC bool is_fpga_dev_name(const char *name)
+{
+	return !strncmp(name, "dfl-fme.", 8) ||
+	       !strncmp(name, "dfl-port.", 9) ||
+	       !strncmp(name, "intel-fpga-fme.", 15) ||
+	       !strncmp(name, "intel-fpga-port.", 16);
+}
+
+/// Drain pending inotify events, returning true if any of them
+/// concerns an FPGA device node.
+STATIC bool enum_cache_changed(void)
+{
+	char buf[4096]
+		__attribute__((aligned(__alignof__(struct inotify_event))));
+	bool changed = false;
+	ssize_t len;
+
+	while ((len = read(_enum_cache_notify, buf, sizeof(buf))) > 0) {
+		char *ptr = buf;
+
+		while (ptr < buf + len) {
+			struct inotify_event *event =
+				(struct inotify_event *)ptr;
+
+			if ((event->mask & IN_Q_OVERFLOW) ||
+			    (event->len && is_fpga_dev_name(event->name)))
+				changed = true;
+
+			ptr += sizeof(struct inotify_event) + event->len;
+		}
+	}
+
+	return changed;
+}
+
+/// Determine if any cached node lost its sysfs directory, which
+/// catches removals that do not reach FPGA_DEV_PATH.
+STATIC bool enum_cache_stale(void)
+{
+	struct dev_list *lptr;
+	struct stat st;
+
+	for (lptr = _enum_cache.next; NULL != lptr; lptr = lptr->next) {
+		if (!lptr->devpath[0])
+			continue;
+
+		if (opae_stat(lptr->sysfspath, &st))
+			return true;
+	}
+
+	return false;
+}
+
+STATIC fpga_result enum_scan(struct dev_list *head, bool include_port)
+{
+	fpga_result result;
+	struct dev_list *lptr;
+
+	result = enum_fpga_region_resources(head, include_port);
+	if (result != FPGA_OK)
+		return result;
+
+	for (lptr = head->next; NULL != lptr; lptr = lptr->next) {
+		// Skip the "container" device list nodes.
+		if (!lptr->devpath[0])
+			continue;
+
+		if (lptr->hdr.objtype == FPGA_DEVICE)
+			lptr->synced = sync_fme(lptr) == FPGA_OK;
+		else if (lptr->hdr.objtype == FPGA_ACCELERATOR)
+			lptr->synced = sync_afu(lptr) == FPGA_OK;
+	}
+
+	return FPGA_OK;
+}
+
+STATIC fpga_result enum_cache_fill(void)
+{
+	fpga_result result;
+	struct dev_list *lptr;
+
+	if (_enum_cache_notify >= 0 && enum_cache_changed())
+		_enum_cache_valid = false;
+
+	if (_enum_cache_valid && enum_cache_stale())
+		_enum_cache_valid = false;
+
+	if (_enum_cache_valid)
+		return FPGA_OK;
+
+	free_dev_list(&_enum_cache);
+
+	result = enum_scan(&_enum_cache, true);
+	if (result != FPGA_OK) {
+		free_dev_list(&_enum_cache);
+		return result;
+	}
+
+	for (lptr = _enum_cache.next; NULL != lptr; lptr = lptr->next) {
+		char errpath[SYSFS_PATH_MAX];
+
+		if (!lptr->synced)
+			continue;
+
+		if (snprintf(errpath, sizeof(errpath),
+			     "%s/errors", lptr->sysfspath) < 0)
+			continue;
+
+		build_error_list(errpath, &lptr->errors);
+	}
+
+	_enum_cache_valid = true;
+
+	return FPGA_OK;
+}
+
+/// Determine if filters inspect accelerator fields that may change
+/// while the cached device tree does not.
+STATIC bool filters_need_afu_sync(const fpga_properties *filters,
+				  uint32_t num_filters)
+{
+	uint32_t i;
+
+	for (i = 0; i < num_filters; ++i) {
+		struct _fpga_properties *_filter =
+			(struct _fpga_properties *)filters[i];
+
+		if (FIELD_VALID(_filter, FPGA_PROPERTY_GUID))
+			return true;
+
+		if (FIELD_VALID(_filter, FPGA_PROPERTY_OBJTYPE) &&
+		    (_filter->objtype == FPGA_ACCELERATOR) &&
+		    (FIELD_VALID(_filter, FPGA_PROPERTY_ACCELERATOR_STATE) ||
+		     FIELD_VALID(_filter, FPGA_PROPERTY_NUM_MMIO) ||
+		     FIELD_VALID(_filter, FPGA_PROPERTY_NUM_INTERRUPTS)))
+			return true;
+	}
+
+	return false;
+}
+
+int enum_cache_initialize(void)
+{
+	const char *env = getenv("LIBOPAE_ENUM_CACHE");
+	int res = 0;
+
+	enum_cache_finalize();
+
+	if (opae_mutex_lock(res, &_enum_cache_lock))
+		return res;
+
+	if (env && !strcmp(env, "0")) {
+		OPAE_DBG("enumeration cache disabled");
+		goto out_unlock;
+	}
+
+	_enum_cache_notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (_enum_cache_notify < 0) {
+		OPAE_DBG("inotify_init1() failed: %s", strerror(errno));
+		goto out_unlock;
+	}
+
+	if (inotify_add_watch(_enum_cache_notify, FPGA_DEV_PATH,
+			      IN_CREATE | IN_DELETE |
+			      IN_MOVED_FROM | IN_MOVED_TO) < 0) {
+		OPAE_DBG("inotify_add_watch(%s) failed: %s",
+			 FPGA_DEV_PATH, strerror(errno));
+		close(_enum_cache_notify);
+		_enum_cache_notify = -1;
+		goto out_unlock;
+	}
+
+	// Without notifications, the cache could go stale
+	// undetected, so it is only enabled when they work.
+	_enum_cache_enabled = true;
+
+out_unlock:
+	opae_mutex_unlock(res, &_enum_cache_lock);
+	return 0;
+}
+
+void enum_cache_finalize(void)
+{
+	int res = 0;
+
+	if (opae_mutex_lock(res, &_enum_cache_lock))
+		return;
+
+	free_dev_list(&_enum_cache);
+	_enum_cache_valid = false;
+	_enum_cache_enabled = false;
+
+	if (_enum_cache_notify >= 0) {
+		close(_enum_cache_notify);
+		_enum_cache_notify = -1;
+	}
+
+	opae_mutex_unlock(res, &_enum_cache_lock);
+}
+
+void enum_cache_invalidate(void)
+{
+	int res = 0;
+
+	if (opae_mutex_lock(res, &_enum_cache_lock))
+		return;
+
+	_enum_cache_valid = false;
+
+	opae_mutex_unlock(res, &_enum_cache_lock);
+}
+
+fpga_result __XFPGA_API__ xfpga_fpgaEnumerateRefresh(void)
+{
+	enum_cache_invalidate();
+	return FPGA_OK;
+}
+
 fpga_result __XFPGA_API__ xfpga_fpgaEnumerate(const fpga_properties *filters,
 				       uint32_t num_filters, fpga_token *tokens,
 				       uint32_t max_tokens,
@@ -711,7 +978,10 @@ fpga_result __XFPGA_API__ xfpga_fpgaEnumerate(const fpga_properties *filters,
 	fpga_result result = FPGA_NOT_FOUND;
 
 	struct dev_list head;
+	struct dev_list *list;
 	struct dev_list *lptr;
+	bool resync_afus = false;
+	int err = 0;
 
 	if (NULL == num_matches) {
 		OPAE_MSG("num_matches is NULL");
@@ -739,28 +1009,35 @@ fpga_result __XFPGA_API__ xfpga_fpgaEnumerate(const fpga_properties *filters,
 
 	memset(&head, 0, sizeof(head));
 
-	// enum FPGA regions & resources
-	result = enum_fpga_region_resources(&head,
-				include_afu(filters, num_filters));
+	if (opae_mutex_lock(err, &_enum_cache_lock))
+		return FPGA_EXCEPTION;
+
+	if (_enum_cache_enabled) {
+		result = enum_cache_fill();
+		list = &_enum_cache;
+		resync_afus = filters_need_afu_sync(filters, num_filters);
+	} else {
+		// enum FPGA regions & resources
+		result = enum_scan(&head, include_afu(filters, num_filters));
+		list = &head;
+	}
 
 	if (result != FPGA_OK) {
 		OPAE_MSG("No FPGA resources found");
-		return result;
+		goto out_free_trash;
 	}
 
 	/* create and populate token data structures */
-	for (lptr = head.next; NULL != lptr; lptr = lptr->next) {
+	for (lptr = list->next; NULL != lptr; lptr = lptr->next) {
 		// Skip the "container" device list nodes.
 		if (!lptr->devpath[0])
 			continue;
 
-		if (lptr->hdr.objtype == FPGA_DEVICE &&
-		    sync_fme(lptr) != FPGA_OK) {
-			continue;
-		} else if (lptr->hdr.objtype == FPGA_ACCELERATOR &&
-			   sync_afu(lptr) != FPGA_OK) {
+		if (resync_afus && lptr->hdr.objtype == FPGA_ACCELERATOR)
+			lptr->synced = sync_afu(lptr) == FPGA_OK;
+
+		if (!lptr->synced)
 			continue;
-		}
 
 		if (matches_filters(lptr, filters, num_filters)) {
 			if (*num_matches < max_tokens) {
@@ -785,11 +1062,8 @@ fpga_result __XFPGA_API__ xfpga_fpgaEnumerate(const fpga_properties *filters,
 	}
 
 out_free_trash:
-	for (lptr = head.next; NULL != lptr;) {
-		struct dev_list *trash = lptr;
-		lptr = lptr->next;
-		opae_free(trash);
-	}
+	free_dev_list(&head);
+	opae_mutex_unlock(err, &_enum_cache_lock);
 
 	return result;
 }
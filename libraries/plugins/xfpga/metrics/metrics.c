@@ -183,7 +183,6 @@ fpga_result __XFPGA_API__ xfpga_fpgaGetMetricsByIndex(fpga_handle handle,
 	struct _fpga_handle *_handle            = (struct _fpga_handle *)handle;
 	int err                                 = 0;
 	uint64_t i                              = 0;
-	fpga_objtype objtype;
 
 	if (_handle == NULL) {
 		OPAE_ERR("NULL fpga handle");
@@ -214,65 +213,33 @@ fpga_result __XFPGA_API__ xfpga_fpgaGetMetricsByIndex(fpga_handle handle,
 		goto out_unlock;
 	}
 
-	result = get_fpga_object_type(handle, &objtype);
+	result = metric_snapshot_init(handle);
 	if (result != FPGA_OK) {
-		OPAE_ERR("Failed to init vector");
-		result = FPGA_INVALID_PARAM;
+		OPAE_ERR("Failed to init metric snapshot");
 		goto out_unlock;
 	}
 
-	if (objtype == FPGA_ACCELERATOR) {
-		// get AFU metrics
-		for (i = 0; i < num_metric_indexes; i++) {
+	// get AFU or FME metrics
+	for (i = 0; i < num_metric_indexes; i++) {
 
-			result = get_afu_metric_value(handle,
-						&(_handle->fpga_enum_metric_vector),
+		result = metric_snapshot_get_value(handle,
 						metric_num[i],
 						&metrics[i]);
-			if (result != FPGA_OK) {
-				OPAE_MSG("Failed to get metric value  at Index = %ld", metric_num[i]);
-				metrics[i].metric_num = metric_num[i];
-				continue;
-			} else {
-				// found metrics num
-				found++;
-			}
-		}
-
-		// API returns not found if doesnot found any metric
-		if (found == 0 || num_metric_indexes == 0) {
-			result = FPGA_NOT_FOUND;
+		if (result != FPGA_OK) {
+			OPAE_MSG("Failed to get metric value  at Index = %ld", metric_num[i]);
+			metrics[i].metric_num = metric_num[i];
+			continue;
 		} else {
-			result = FPGA_OK;
-		}
-
-	} else if (objtype == FPGA_DEVICE) {
-		// get FME metrics
-		for (i = 0; i < num_metric_indexes; i++) {
-
-			result = get_fme_metric_value(handle,
-							&(_handle->fpga_enum_metric_vector),
-							metric_num[i],
-							&metrics[i]);
-			if (result != FPGA_OK) {
-				OPAE_MSG("Failed to get metric value  at Index = %ld", metric_num[i]);
-				metrics[i].metric_num = metric_num[i];
-				continue;
-			} else {
-				// found metrics num
-				found++;
-			}
-		}
-
-		// API returns not found if doesnot found any metric
-		if (found == 0 || num_metric_indexes == 0) {
-			result = FPGA_NOT_FOUND;
-		} else {
-			result = FPGA_OK;
+			// found metrics num
+			found++;
 		}
+	}
 
+	// API returns not found if doesnot found any metric
+	if (found == 0 || num_metric_indexes == 0) {
+		result = FPGA_NOT_FOUND;
 	} else {
-		result = FPGA_INVALID_PARAM;
+		result = FPGA_OK;
 	}
 
 out_unlock:
@@ -297,7 +264,6 @@ fpga_result __XFPGA_API__ xfpga_fpgaGetMetricsByName(fpga_handle handle,
 	int err                                = 0;
 	uint64_t i                             = 0;
 	uint64_t metric_num                    = 0;
-	fpga_objtype objtype;
 
 	if (_handle == NULL) {
 		OPAE_ERR("NULL fpga handle");
@@ -334,80 +300,41 @@ fpga_result __XFPGA_API__ xfpga_fpgaGetMetricsByName(fpga_handle handle,
 		goto out_unlock;
 	}
 
-
-	result = get_fpga_object_type(handle, &objtype);
+	result = metric_snapshot_init(handle);
 	if (result != FPGA_OK) {
-		OPAE_ERR("Failed to init vector");
-		result = FPGA_INVALID_PARAM;
+		OPAE_ERR("Failed to init metric snapshot");
 		goto out_unlock;
 	}
 
-	if (objtype == FPGA_ACCELERATOR) {
-		// get AFU metrics
-		for (i = 0; i < num_metric_names; i++) {
-			result = parse_metric_num_name(metrics_names[i],
-							&(_handle->fpga_enum_metric_vector),
-							&metric_num);
-			if (result != FPGA_OK) {
-				OPAE_MSG("Invalid input metrics string= %s", metrics_names[i]);
-				metrics[i].metric_num = METRIC_ARRAY_INVALID_INDEX;
-				continue;
-			}
-
-			result = get_afu_metric_value(handle, &(_handle->fpga_enum_metric_vector),
-				metric_num,
-				&metrics[i]);
-			if (result != FPGA_OK) {
-				OPAE_MSG("Failed to get metric value  for metric = %s", metrics_names[i]);
-				metrics[i].metric_num = METRIC_ARRAY_INVALID_INDEX;
-				continue;
-			} else {
-				// found metrics num
-				found++;
-			}
+	// get AFU or FME metrics
+	for (i = 0; i < num_metric_names; i++) {
+		result = metric_snapshot_find_name(_handle,
+						metrics_names[i],
+						&metric_num);
+		if (result != FPGA_OK) {
+			OPAE_MSG("Invalid input metrics string= %s", metrics_names[i]);
+			metrics[i].metric_num = METRIC_ARRAY_INVALID_INDEX;
+			continue;
 		}
 
-		// API returns not found if doesnot found any metric
-		if (found == 0 || num_metric_names == 0) {
-			result = FPGA_NOT_FOUND;
+		result = metric_snapshot_get_value(handle,
+						metric_num,
+						&metrics[i]);
+		if (result != FPGA_OK) {
+			OPAE_MSG("Failed to get metric value  for metric = %s", metrics_names[i]);
+			metrics[i].metric_num = METRIC_ARRAY_INVALID_INDEX;
+			continue;
 		} else {
-			result = FPGA_OK;
-		}
-	} else	if (objtype == FPGA_DEVICE) {
-		// get FME metrics
-		for (i = 0; i < num_metric_names; i++) {
-
-			result = parse_metric_num_name(metrics_names[i],
-							&(_handle->fpga_enum_metric_vector),
-							&metric_num);
-			if (result != FPGA_OK) {
-				OPAE_ERR("Invalid input metrics string= %s", metrics_names[i]);
-				metrics[i].metric_num = METRIC_ARRAY_INVALID_INDEX;
-				continue;
-			}
-
-			result = get_fme_metric_value(handle,
-							&(_handle->fpga_enum_metric_vector),
-							metric_num,
-							&metrics[i]);
-			if (result != FPGA_OK) {
-				OPAE_ERR("Failed to get metric value  for metric = %s \n", metrics_names[i]);
-				metrics[i].metric_num = METRIC_ARRAY_INVALID_INDEX;
-				continue;
-			} else {
-				// found metrics num
-				found++;
-			}
+			// found metrics num
+			found++;
 		}
+	}
 
-		// API returns not found if doesnot found any metric
-		if (found == 0 || num_metric_names == 0) {
-			result = FPGA_NOT_FOUND;
-		} else {
-			result = FPGA_OK;
-		}
+	// API returns not found if doesnot found any metric
+	if (found == 0) {
+		result = FPGA_NOT_FOUND;
 	} else {
-		result = FPGA_INVALID_PARAM;
+		result = FPGA_OK;
 	}
 
 out_unlock:
@@ -83,6 +83,26 @@
 
 #define BMC_LIB                             "libmodbmc.so"
 
+#define METRICS_SNAPSHOT_TTL_ENV            "LIBOPAE_METRICS_TTL_MS"
+
+// Last read of one metric
+struct _fpga_metric_sample {
+	fpga_result result;                      // result of the read
+	struct fpga_metric metric;               // value read
+};
+
+// Per-handle metric snapshot
+struct _fpga_metric_snapshot {
+	fpga_objtype objtype;                    // object type of the handle
+	uint64_t num_metrics;                    // entries in the enum vector
+	uint64_t *name_index;                    // name hash -> vector index + 1
+	uint64_t num_buckets;                    // size of name_index, power of 2
+	struct _fpga_metric_sample *samples;     // per vector index, NULL if no TTL
+	uint64_t ttl_nsec;                       // snapshot lifetime
+	uint64_t timestamp_nsec;                 // CLOCK_MONOTONIC of last refresh
+	bool valid;                              // samples hold a refresh
+};
+
 // AFU DFH Struct
 struct DFH {
 	union {
@@ -275,4 +295,17 @@ fpga_result xfpga_bmcGetSDRDetails(struct _fpga_handle *_handle,
 
 void *metrics_load_bmc_lib(void);
 
+// Metric snapshot
+fpga_result metric_snapshot_init(fpga_handle handle);
+
+void metric_snapshot_free(struct _fpga_handle *_handle);
+
+fpga_result metric_snapshot_find_name(struct _fpga_handle *_handle,
+				const char *metric_name,
+				uint64_t *metric_num);
+
+fpga_result metric_snapshot_get_value(fpga_handle handle,
+				uint64_t metric_num,
+				struct fpga_metric *fpga_metric);
+
 #endif // __FPGA_METRICS_INT_H__
@@ -0,0 +1,355 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+/**
+* \file metrics_snapshot.c
+* \brief fpga metric snapshot cache and name index
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common_int.h"
+#include "types_int.h"
+#include "metrics_int.h"
+#include "mock/opae_std.h"
+
+#define NSEC_PER_MSEC                   1000000ULL
+
+// case-insensitive FNV-1a, matching the strcasecmp() name compare
+STATIC uint64_t metric_name_hash(const char *name)
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+
+	while (*name) {
+		h ^= (uint64_t)tolower((unsigned char)*name++);
+		h *= 0x100000001b3ULL;
+	}
+
+	return h;
+}
+
+STATIC uint64_t metric_snapshot_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// snapshot TTL in nanoseconds; 0 (the default) disables value caching
+STATIC uint64_t metric_snapshot_ttl(void)
+{
+	const char *env = getenv(METRICS_SNAPSHOT_TTL_ENV);
+	unsigned long long ms;
+	char *endptr = NULL;
+
+	if (!env || !*env)
+		return 0;
+
+	ms = strtoull(env, &endptr, 0);
+	if (*endptr) {
+		OPAE_MSG("ignoring invalid %s: %s",
+			 METRICS_SNAPSHOT_TTL_ENV, env);
+		return 0;
+	}
+
+	return (uint64_t)ms * NSEC_PER_MSEC;
+}
+
+STATIC fpga_result metric_snapshot_index_names(struct _fpga_metric_snapshot *snap,
+					       fpga_metric_vector *vector)
+{
+	struct _fpga_enum_metric *_fpga_enum_metric = NULL;
+	uint64_t i;
+	uint64_t b;
+
+	// keep the load factor at or below one half
+	snap->num_buckets = 16;
+	while (snap->num_buckets < 2 * snap->num_metrics)
+		snap->num_buckets <<= 1;
+
+	snap->name_index = opae_calloc(snap->num_buckets, sizeof(uint64_t));
+	if (!snap->name_index) {
+		OPAE_ERR("Failed to allocate memory");
+		return FPGA_NO_MEMORY;
+	}
+
+	// Insert in vector order, so that a duplicate name resolves to
+	// its first entry, as with a linear scan.
+	for (i = 0; i < snap->num_metrics; i++) {
+		_fpga_enum_metric = (struct _fpga_enum_metric *)fpga_vector_get(vector, i);
+		if (!_fpga_enum_metric)
+			continue;
+
+		b = metric_name_hash(_fpga_enum_metric->metric_name) &
+			(snap->num_buckets - 1);
+		while (snap->name_index[b])
+			b = (b + 1) & (snap->num_buckets - 1);
+
+		snap->name_index[b] = i + 1;
+	}
+
+	return FPGA_OK;
+}
+
+fpga_result metric_snapshot_init(fpga_handle handle)
+{
+	struct _fpga_handle *_handle = (struct _fpga_handle *)handle;
+	struct _fpga_metric_snapshot *snap = NULL;
+	fpga_result result = FPGA_OK;
+
+	if (_handle->metric_snapshot)
+		return FPGA_OK;
+
+	snap = opae_calloc(1, sizeof(*snap));
+	if (!snap) {
+		OPAE_ERR("Failed to allocate memory");
+		return FPGA_NO_MEMORY;
+	}
+
+	result = get_fpga_object_type(handle, &snap->objtype);
+	if (result != FPGA_OK) {
+		OPAE_ERR("Failed to get object type");
+		result = FPGA_INVALID_PARAM;
+		goto out_free;
+	}
+
+	if ((snap->objtype != FPGA_ACCELERATOR) &&
+	    (snap->objtype != FPGA_DEVICE)) {
+		result = FPGA_INVALID_PARAM;
+		goto out_free;
+	}
+
+	result = fpga_vector_total(&(_handle->fpga_enum_metric_vector),
+				   &snap->num_metrics);
+	if (result != FPGA_OK) {
+		OPAE_ERR("Failed to get metric total");
+		goto out_free;
+	}
+
+	result = metric_snapshot_index_names(snap,
+					     &(_handle->fpga_enum_metric_vector));
+	if (result != FPGA_OK)
+		goto out_free;
+
+	snap->ttl_nsec = metric_snapshot_ttl();
+	if (snap->ttl_nsec && snap->num_metrics) {
+		snap->samples = opae_calloc(snap->num_metrics,
+					    sizeof(struct _fpga_metric_sample));
+		if (!snap->samples) {
+			OPAE_ERR("Failed to allocate memory");
+			result = FPGA_NO_MEMORY;
+			goto out_free;
+		}
+	}
+
+	_handle->metric_snapshot = snap;
+	return FPGA_OK;
+
+out_free:
+	if (snap->name_index)
+		opae_free(snap->name_index);
+	opae_free(snap);
+	return result;
+}
+
+void metric_snapshot_free(struct _fpga_handle *_handle)
+{
+	struct _fpga_metric_snapshot *snap = _handle->metric_snapshot;
+
+	if (!snap)
+		return;
+
+	if (snap->name_index)
+		opae_free(snap->name_index);
+	if (snap->samples)
+		opae_free(snap->samples);
+	opae_free(snap);
+
+	_handle->metric_snapshot = NULL;
+}
+
+fpga_result metric_snapshot_find_name(struct _fpga_handle *_handle,
+				      const char *metric_name,
+				      uint64_t *metric_num)
+{
+	struct _fpga_metric_snapshot *snap = _handle->metric_snapshot;
+	struct _fpga_enum_metric *_fpga_enum_metric = NULL;
+	uint64_t b;
+
+	if (!metric_name || !metric_num) {
+		OPAE_ERR("Invalid Input Paramters");
+		return FPGA_INVALID_PARAM;
+	}
+
+	if (!snap)
+		return parse_metric_num_name(metric_name,
+					     &(_handle->fpga_enum_metric_vector),
+					     metric_num);
+
+	b = metric_name_hash(metric_name) & (snap->num_buckets - 1);
+	while (snap->name_index[b]) {
+		_fpga_enum_metric = (struct _fpga_enum_metric *)
+			fpga_vector_get(&(_handle->fpga_enum_metric_vector),
+					snap->name_index[b] - 1);
+
+		if (_fpga_enum_metric &&
+		    !strcasecmp(_fpga_enum_metric->metric_name, metric_name)) {
+			*metric_num = _fpga_enum_metric->metric_num;
+			return FPGA_OK;
+		}
+
+		b = (b + 1) & (snap->num_buckets - 1);
+	}
+
+	return FPGA_NOT_FOUND;
+}
+
+// reads one metric from the device
+STATIC fpga_result metric_snapshot_read(fpga_handle handle,
+					fpga_objtype objtype,
+					uint64_t metric_num,
+					struct fpga_metric *fpga_metric)
+{
+	struct _fpga_handle *_handle = (struct _fpga_handle *)handle;
+
+	if (objtype == FPGA_ACCELERATOR)
+		return get_afu_metric_value(handle,
+					    &(_handle->fpga_enum_metric_vector),
+					    metric_num,
+					    fpga_metric);
+
+	return get_fme_metric_value(handle,
+				    &(_handle->fpga_enum_metric_vector),
+				    metric_num,
+				    fpga_metric);
+}
+
+// re-reads every metric into the sample array
+STATIC void metric_snapshot_refresh(fpga_handle handle,
+				    struct _fpga_metric_snapshot *snap)
+{
+	struct _fpga_handle *_handle = (struct _fpga_handle *)handle;
+	struct _fpga_enum_metric *_fpga_enum_metric = NULL;
+	struct _fpga_metric_sample *sample = NULL;
+	uint64_t i;
+
+	for (i = 0; i < snap->num_metrics; i++) {
+		sample = &snap->samples[i];
+		memset(&sample->metric, 0, sizeof(sample->metric));
+
+		_fpga_enum_metric = (struct _fpga_enum_metric *)
+			fpga_vector_get(&(_handle->fpga_enum_metric_vector), i);
+		if (!_fpga_enum_metric) {
+			sample->result = FPGA_NOT_FOUND;
+			continue;
+		}
+
+		sample->result = metric_snapshot_read(handle,
+						      snap->objtype,
+						      _fpga_enum_metric->metric_num,
+						      &sample->metric);
+		sample->metric.metric_num = _fpga_enum_metric->metric_num;
+	}
+
+	// The BMC values were loaded once for the whole sweep; drop
+	// them so that the next refresh reads the sensors again.
+	clear_cached_values(handle);
+
+	snap->timestamp_nsec = metric_snapshot_now();
+	snap->valid = true;
+}
+
+// maps a metric number to its position in the enum vector
+STATIC bool metric_snapshot_slot(struct _fpga_handle *_handle,
+				 struct _fpga_metric_snapshot *snap,
+				 uint64_t metric_num,
+				 uint64_t *slot)
+{
+	struct _fpga_enum_metric *_fpga_enum_metric = NULL;
+	uint64_t i;
+
+	// Metric numbers are assigned in enumeration order, so the
+	// number is normally the index.
+	if (metric_num < snap->num_metrics) {
+		_fpga_enum_metric = (struct _fpga_enum_metric *)
+			fpga_vector_get(&(_handle->fpga_enum_metric_vector),
+					metric_num);
+		if (_fpga_enum_metric &&
+		    _fpga_enum_metric->metric_num == metric_num) {
+			*slot = metric_num;
+			return true;
+		}
+	}
+
+	for (i = 0; i < snap->num_metrics; i++) {
+		_fpga_enum_metric = (struct _fpga_enum_metric *)
+			fpga_vector_get(&(_handle->fpga_enum_metric_vector), i);
+		if (_fpga_enum_metric &&
+		    _fpga_enum_metric->metric_num == metric_num) {
+			*slot = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+fpga_result metric_snapshot_get_value(fpga_handle handle,
+				      uint64_t metric_num,
+				      struct fpga_metric *fpga_metric)
+{
+	struct _fpga_handle *_handle = (struct _fpga_handle *)handle;
+	struct _fpga_metric_snapshot *snap = _handle->metric_snapshot;
+	uint64_t slot = 0;
+
+	if (!snap || !fpga_metric) {
+		OPAE_ERR("Invalid Input Paramters");
+		return FPGA_INVALID_PARAM;
+	}
+
+	if (!snap->samples)
+		return metric_snapshot_read(handle, snap->objtype,
+					    metric_num, fpga_metric);
+
+	if (!snap->valid ||
+	    (metric_snapshot_now() - snap->timestamp_nsec >= snap->ttl_nsec))
+		metric_snapshot_refresh(handle, snap);
+
+	if (!metric_snapshot_slot(_handle, snap, metric_num, &slot))
+		return FPGA_NOT_FOUND;
+
+	*fpga_metric = snap->samples[slot].metric;
+	return snap->samples[slot].result;
+}
@@ -420,6 +420,7 @@ fpga_result free_fpga_enum_metrics_vector(struct _fpga_handle *_handle)
 		_handle->bmc_handle = NULL;
 	}
 
+	metric_snapshot_free(_handle);
 	clear_cached_values(_handle);
 	_handle->metric_enum_status = false;
 
@@ -379,6 +379,111 @@ out_unlock:
 	return result;
 }
 
+/*
+ * Validate one element of a batch and return its virtual address.
+ * *wm caches the region of the previous element, so that a batch
+ * targeting a single MMIO space costs only one wsid lookup.
+ */
+STATIC fpga_result batch_op_addr(fpga_handle handle,
+				 const fpga_mmio_op *op,
+				 struct wsid_map **wm,
+				 volatile uint8_t **addr)
+{
+	fpga_result result;
+
+	if ((op->width != 32) && (op->width != 64)) {
+		OPAE_MSG("Invalid MMIO width: %u", op->width);
+		return FPGA_INVALID_PARAM;
+	}
+
+	if (op->offset % (op->width / 8) != 0) {
+		OPAE_MSG("Misaligned MMIO access");
+		return FPGA_INVALID_PARAM;
+	}
+
+	if (!*wm || ((*wm)->index != op->mmio_num)) {
+		result = find_or_map_wm(handle, op->mmio_num, wm);
+		if (result)
+			return result;
+	}
+
+	if (op->offset > (*wm)->len) {
+		OPAE_MSG("offset out of bounds");
+		return FPGA_INVALID_PARAM;
+	}
+
+	*addr = (volatile uint8_t *)(*wm)->offset + op->offset;
+	return FPGA_OK;
+}
+
+fpga_result __XFPGA_API__ xfpga_fpgaReadMMIOBatch(fpga_handle handle,
+						  fpga_mmio_op *ops,
+						  uint32_t num_ops)
+{
+	int err;
+	struct _fpga_handle *_handle = (struct _fpga_handle *) handle;
+	struct wsid_map *wm = NULL;
+	volatile uint8_t *addr = NULL;
+	fpga_result result = FPGA_OK;
+	uint32_t i;
+
+	result = handle_check_and_lock(_handle);
+	if (result)
+		return result;
+
+	for (i = 0 ; i < num_ops ; ++i) {
+		result = batch_op_addr(handle, &ops[i], &wm, &addr);
+		if (result)
+			goto out_unlock;
+
+		if (ops[i].width == 64)
+			ops[i].value = *((volatile uint64_t *)addr);
+		else
+			ops[i].value = *((volatile uint32_t *)addr);
+	}
+
+out_unlock:
+	err = pthread_mutex_unlock(&_handle->lock);
+	if (err) {
+		OPAE_ERR("pthread_mutex_unlock() failed: %s", strerror(err));
+	}
+	return result;
+}
+
+fpga_result __XFPGA_API__ xfpga_fpgaWriteMMIOBatch(fpga_handle handle,
+						   const fpga_mmio_op *ops,
+						   uint32_t num_ops)
+{
+	int err;
+	struct _fpga_handle *_handle = (struct _fpga_handle *) handle;
+	struct wsid_map *wm = NULL;
+	volatile uint8_t *addr = NULL;
+	fpga_result result = FPGA_OK;
+	uint32_t i;
+
+	result = handle_check_and_lock(_handle);
+	if (result)
+		return result;
+
+	for (i = 0 ; i < num_ops ; ++i) {
+		result = batch_op_addr(handle, &ops[i], &wm, &addr);
+		if (result)
+			goto out_unlock;
+
+		if (ops[i].width == 64)
+			*((volatile uint64_t *)addr) = ops[i].value;
+		else
+			*((volatile uint32_t *)addr) = (uint32_t)ops[i].value;
+	}
+
+out_unlock:
+	err = pthread_mutex_unlock(&_handle->lock);
+	if (err) {
+		OPAE_ERR("pthread_mutex_unlock() failed: %s", strerror(err));
+	}
+	return result;
+}
+
 fpga_result __XFPGA_API__ xfpga_fpgaMapMMIO(fpga_handle handle,
 				     uint32_t mmio_num,
 				     uint64_t **mmio_ptr)
@@ -86,6 +86,8 @@ xfpga_fpgaOpen(fpga_token token, fpga_handle *handle, int flags)
 
 	_handle->fdfpgad = -1;
 
+	_handle->numa_node = sysfs_get_numa_node(_token->sysfspath);
+
 	// Init MMIO table
 	_handle->mmio_root = wsid_tracker_init(4);
 	if (NULL == _handle->mmio_root) {
@@ -104,6 +106,7 @@ xfpga_fpgaOpen(fpga_token token, fpga_handle *handle, int flags)
 	_handle->metric_enum_status = false;
 	_handle->bmc_handle = NULL;
 	_handle->_bmc_metric_cache_value = NULL;
+	_handle->metric_snapshot = NULL;
 
 	// Open resources in exclusive mode unless FPGA_OPEN_SHARED is given
 	open_flags = O_RDWR | ((flags & FPGA_OPEN_SHARED) ? 0 : O_EXCL);
@@ -47,11 +47,13 @@ int __XFPGA_API__ xfpga_plugin_initialize(void)
 	if (res) {
 		return res;
 	}
-	return 0;
+
+	return enum_cache_initialize();
 }
 
 int __XFPGA_API__ xfpga_plugin_finalize(void)
 {
+	enum_cache_finalize();
 	sysfs_finalize();
 	return 0;
 }
@@ -82,12 +84,18 @@ int __XFPGA_API__ opae_plugin_configure(opae_api_adapter_table *adapter,
 		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaReadMMIO32");
 	adapter->fpgaWriteMMIO512 =
 		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaWriteMMIO512");
+	adapter->fpgaReadMMIOBatch =
+		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaReadMMIOBatch");
+	adapter->fpgaWriteMMIOBatch =
+		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaWriteMMIOBatch");
 	adapter->fpgaMapMMIO =
 		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaMapMMIO");
 	adapter->fpgaUnmapMMIO =
 		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaUnmapMMIO");
 	adapter->fpgaEnumerate =
 		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaEnumerate");
+	adapter->fpgaEnumerateRefresh =
+		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaEnumerateRefresh");
 	adapter->fpgaCloneToken =
 		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaCloneToken");
 	adapter->fpgaDestroyToken =
@@ -106,6 +114,8 @@ int __XFPGA_API__ opae_plugin_configure(opae_api_adapter_table *adapter,
 		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaReleaseBuffer");
 	adapter->fpgaGetIOAddress =
 		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaGetIOAddress");
+	adapter->fpgaGetBufferNumaNode =
+		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaGetBufferNumaNode");
 	/*
 	**	adapter->fpgaGetOPAECVersion = dlsym(adapter->plugin.dl_handle,
 	*"xfpga_fpgaGetOPAECVersion");
@@ -155,6 +165,8 @@ int __XFPGA_API__ opae_plugin_configure(opae_api_adapter_table *adapter,
 		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaObjectRead");
 	adapter->fpgaObjectRead64 =
 		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaObjectRead64");
+	adapter->fpgaObjectReadMany =
+		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaObjectReadMany");
 	adapter->fpgaObjectGetSize =
 		dlsym(adapter->plugin.dl_handle, "xfpga_fpgaObjectGetSize");
 	adapter->fpgaObjectGetType =
@@ -395,6 +395,10 @@ fpga_result __XFPGA_API__ xfpga_fpgaReconfigureSlot(fpga_handle fpga,
 	}
 
 out_unlock:
+	// The AFU GUID changed; make the next enumeration rescan.
+	if (result == FPGA_OK)
+		enum_cache_invalidate();
+
 	// close the accelerator opened during `open_accel`
 	if (accel && xfpga_fpgaClose(accel) != FPGA_OK) {
 		OPAE_ERR("Error closing accelerator after reconfiguration");
@@ -1070,11 +1070,6 @@ fpga_result sysfs_read_int(const char *path, int *i)
 		return FPGA_NOT_FOUND;
 	}
 
-	if ((off_t)-1 == lseek(fd, 0, SEEK_SET)) {
-		OPAE_MSG("seek failed");
-		goto out_close;
-	}
-
 	b = 0;
 
 	do {
@@ -1122,11 +1117,6 @@ fpga_result sysfs_read_u32(const char *path, uint32_t *u)
 		return FPGA_NOT_FOUND;
 	}
 
-	if ((off_t)-1 == lseek(fd, 0, SEEK_SET)) {
-		OPAE_MSG("seek failed");
-		goto out_close;
-	}
-
 	b = 0;
 
 	do {
@@ -1183,11 +1173,6 @@ fpga_result sysfs_read_u32_pair(const char *path, uint32_t *u1, uint32_t *u2,
 		return FPGA_NOT_FOUND;
 	}
 
-	if ((off_t)-1 == lseek(fd, 0, SEEK_SET)) {
-		OPAE_MSG("seek failed");
-		goto out_close;
-	}
-
 	b = 0;
 
 	do {
@@ -1250,11 +1235,6 @@ fpga_result sysfs_read_u64(const char *path, uint64_t *u)
 		return FPGA_NOT_FOUND;
 	}
 
-	if ((off_t)-1 == lseek(fd, 0, SEEK_SET)) {
-		OPAE_MSG("seek failed");
-		goto out_close;
-	}
-
 	do {
 		res = opae_read(fd, buf + b, sizeof(buf) - b);
 		if (res <= 0) {
@@ -1405,11 +1385,6 @@ fpga_result sysfs_read_guid(const char *path, fpga_guid guid)
 		return FPGA_NOT_FOUND;
 	}
 
-	if ((off_t)-1 == lseek(fd, 0, SEEK_SET)) {
-		OPAE_MSG("seek failed");
-		goto out_close;
-	}
-
 	b = 0;
 
 	do {
@@ -1538,6 +1513,34 @@ fpga_result sysfs_get_socket_id(int dev, int subdev, uint8_t *socket_id)
 	return FPGA_OK;
 }
 
+/*
+ * The NUMA node of the PCIe device that owns the FME/port at sysfspath,
+ * eg /sys/class/fpga_region/region0/dfl-port.0 -> region0/device/numa_node.
+ * Returns -1 when the platform doesn't report one.
+ */
+int sysfs_get_numa_node(const char *sysfspath)
+{
+	char spath[SYSFS_PATH_MAX] = { 0, };
+	char *p;
+	int node = -1;
+
+	if (snprintf(spath, sizeof(spath), "%s", sysfspath) < 0)
+		return -1;
+
+	p = strrchr(spath, '/');
+	if (!p)
+		return -1;
+
+	*p = '\0';
+	if (snprintf(p, sizeof(spath) - (p - spath), "/device/numa_node") < 0)
+		return -1;
+
+	if (sysfs_read_int(spath, &node) != FPGA_OK)
+		return -1;
+
+	return node;
+}
+
 fpga_result sysfs_get_afu_id(int dev, int subdev, fpga_guid guid)
 {
 	char spath[SYSFS_PATH_MAX] = { 0, };
@@ -1919,6 +1922,28 @@ ssize_t eintr_read(int fd, void *buf, size_t count)
 	return total_read;
 }
 
+ssize_t eintr_pread(int fd, void *buf, size_t count, off_t offset)
+{
+	ssize_t bytes_read = 0, total_read = 0;
+	char *ptr = buf;
+	while (total_read < (ssize_t)count) {
+		bytes_read = pread(fd, ptr + total_read, count - total_read,
+				   offset + total_read);
+
+		if (bytes_read < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return bytes_read;
+		} else if (bytes_read == 0) {
+			break;
+		} else {
+			total_read += bytes_read;
+		}
+	}
+	return total_read;
+}
+
 ssize_t eintr_write(int fd, void *buf, size_t count)
 {
 	ssize_t bytes_written = 0, total_written = 0;
@@ -2026,6 +2051,7 @@ struct _fpga_object *alloc_fpga_object(const char *sysfspath, const char *name)
 		obj->max_size = 0;
 		obj->buffer = NULL;
 		obj->objects = NULL;
+		obj->fd = -1;
 	}
 	return obj;
 out_err:
@@ -2051,6 +2077,8 @@ fpga_result destroy_fpga_object(struct _fpga_object *obj)
 		}
 	}
 	FREE_IF(obj->objects);
+	if (obj->fd >= 0)
+		opae_close(obj->fd);
 
 	if (pthread_mutex_unlock(&obj->lock)) {
 		OPAE_MSG("pthread_mutex_unlock() failed");
@@ -2151,12 +2179,11 @@ static ssize_t find_eof(int fd)
 	char buffer[pg_size];
 	ssize_t bytes_read = 0, total_read = 0;
 	while (total_read <= MAX_SYSOBJECT_FILESIZE) {
-		bytes_read = opae_read(fd, buffer, pg_size);
+		bytes_read = pread(fd, buffer, pg_size, total_read);
 		if (bytes_read < 0) {
 			if (errno == EINTR) {
 				continue;
 			}
-			lseek(fd, 0, SEEK_SET);
 			return bytes_read;
 		} else if (bytes_read == 0) {
 			break;
@@ -2164,7 +2191,6 @@ static ssize_t find_eof(int fd)
 			total_read += bytes_read;
 		}
 	}
-	lseek(fd, 0, SEEK_SET);
 	return total_read;
 }
 
@@ -2173,6 +2199,10 @@ static fpga_result sync_object_size(struct _fpga_object *_obj, int fd)
 	off_t size;
 	uint8_t *buffer;
 	size = find_eof(fd);
+	// A spare byte lets a later read that fills the buffer tell
+	// that the file has grown.
+	if (size > 0)
+		++size;
 	if (size < MIN_SYSOBJECT_FILESIZE)
 		size = MIN_SYSOBJECT_FILESIZE;
 	if (size > 0) {
@@ -2183,38 +2213,131 @@ static fpga_result sync_object_size(struct _fpga_object *_obj, int fd)
 		_obj->buffer = buffer;
 		_obj->max_size = size;
 	}
+	_obj->max_size_synced = true;
+	return FPGA_OK;
+}
+
+STATIC fpga_result sync_object_fd(struct _fpga_object *_obj, int fd)
+{
+	fpga_result res;
+	ssize_t bytes_read;
+
+	// The size is discovered (one full read of the file) only the
+	// first time, or when a read fills the whole buffer and the file
+	// may have grown past it.
+	if (!_obj->max_size_synced && _obj->max_size <= MIN_SYSOBJECT_FILESIZE) {
+		res = sync_object_size(_obj, fd);
+		if (res != FPGA_OK)
+			return res;
+	}
+
+	bytes_read = eintr_pread(fd, _obj->buffer, _obj->max_size, 0);
+	if (bytes_read < 0)
+		return FPGA_EXCEPTION;
+
+	if ((size_t)bytes_read == _obj->max_size &&
+	    _obj->max_size < MAX_SYSOBJECT_FILESIZE) {
+		size_t prev_size = _obj->max_size;
+
+		res = sync_object_size(_obj, fd);
+		if (res != FPGA_OK)
+			return res;
+
+		if (_obj->max_size > prev_size) {
+			bytes_read = eintr_pread(fd, _obj->buffer,
+						 _obj->max_size, 0);
+			if (bytes_read < 0)
+				return FPGA_EXCEPTION;
+		}
+	}
+
+	_obj->size = bytes_read;
 	return FPGA_OK;
 }
 
 fpga_result sync_object(fpga_object obj)
 {
 	struct _fpga_object *_obj;
-	int fd = -1;
 	fpga_result res = FPGA_OK;
-	ssize_t bytes_read = 0;
 	ASSERT_NOT_NULL(obj);
 	_obj = (struct _fpga_object *)obj;
-	fd = opae_open(_obj->path, _obj->perm);
-	if (fd < 0) {
-		OPAE_ERR("Error opening %s: %s", _obj->path, strerror(errno));
+
+	if (pthread_mutex_lock(&_obj->lock)) {
+		OPAE_ERR("pthread_mutex_lock() failed");
 		return FPGA_EXCEPTION;
 	}
 
-	if (_obj->max_size <= MIN_SYSOBJECT_FILESIZE) {
-		res = sync_object_size(_obj, fd);
-		if (res != FPGA_OK) {
-			opae_close(fd);
-			return res;
+	// Keep the file open across syncs: a refresh is then one pread().
+	if (_obj->fd < 0) {
+		_obj->fd = opae_open(_obj->path, _obj->perm | O_CLOEXEC);
+		if (_obj->fd < 0) {
+			OPAE_ERR("Error opening %s: %s",
+				 _obj->path, strerror(errno));
+			res = FPGA_EXCEPTION;
+			goto out_unlock;
 		}
 	}
 
-	bytes_read = eintr_read(fd, _obj->buffer, _obj->max_size);
-	if (bytes_read < 0) {
-		opae_close(fd);
+	res = sync_object_fd(_obj, _obj->fd);
+	if (res != FPGA_OK) {
+		// The file may be gone (device removed, driver reloaded).
+		// Open it again on the next sync.
+		opae_close(_obj->fd);
+		_obj->fd = -1;
+	}
+
+out_unlock:
+	if (pthread_mutex_unlock(&_obj->lock)) {
+		OPAE_ERR("pthread_mutex_unlock() failed");
+	}
+	return res;
+}
+
+STATIC fpga_result sync_new_object(struct _fpga_object *_obj)
+{
+	fpga_result res;
+	int fd;
+
+	// Objects made in bulk (groups, globs) are read once here and
+	// keep no descriptor until they are explicitly synced.
+	fd = opae_open(_obj->path, _obj->perm | O_CLOEXEC);
+	if (fd < 0) {
+		OPAE_ERR("Error opening %s: %s", _obj->path, strerror(errno));
 		return FPGA_EXCEPTION;
 	}
-	_obj->size = bytes_read;
+
+	res = sync_object_fd(_obj, fd);
 	opae_close(fd);
+	return res;
+}
+
+fpga_result sync_objects(fpga_object *objs, uint64_t *values,
+			 size_t count, int flags)
+{
+	fpga_result res;
+	size_t i;
+
+	for (i = 0 ; i < count ; ++i) {
+		struct _fpga_object *_obj = (struct _fpga_object *)objs[i];
+
+		ASSERT_NOT_NULL(_obj);
+		if (_obj->type != FPGA_SYSFS_FILE) {
+			OPAE_MSG("object %zu is not an attribute", i);
+			return FPGA_INVALID_PARAM;
+		}
+
+		if (flags & FPGA_OBJECT_SYNC) {
+			res = sync_object(objs[i]);
+			if (res)
+				return res;
+		}
+
+		if (flags & FPGA_OBJECT_RAW)
+			values[i] = *(uint64_t *)_obj->buffer;
+		else
+			values[i] = strtoull((char *)_obj->buffer, NULL, 0);
+	}
+
 	return FPGA_OK;
 }
 
@@ -2449,7 +2572,7 @@ fpga_result make_sysfs_object(char *sysfspath, const char *name,
 	}
 	*object = (fpga_object)obj;
 	if (obj->perm == O_RDONLY || obj->perm == O_RDWR) {
-		return sync_object((fpga_object)obj);
+		return sync_new_object(obj);
 	}
 
 	return FPGA_OK;
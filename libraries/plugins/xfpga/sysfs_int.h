@@ -112,6 +112,7 @@ fpga_result sysfs_read_u64(const char *path, uint64_t *u);
 fpga_result sysfs_write_u64(const char *path, uint64_t u);
 fpga_result sysfs_read_guid(const char *path, fpga_guid guid);
 fpga_result sysfs_get_socket_id(int dev, int subdev, uint8_t *socket_id);
+int sysfs_get_numa_node(const char *sysfspath);
 fpga_result sysfs_get_afu_id(int dev, int subdev, fpga_guid guid);
 fpga_result sysfs_get_pr_id(int dev, int subdev, fpga_guid guid);
 fpga_result sysfs_get_slots(int dev, int subdev, uint32_t *slots);
@@ -125,6 +126,7 @@ fpga_result sysfs_deviceid_from_path(const char *sysfspath,
 fpga_result sysfs_objectid_from_path(const char *sysfspath,
 				     uint64_t *object_id);
 ssize_t eintr_read(int fd, void *buf, size_t count);
+ssize_t eintr_pread(int fd, void *buf, size_t count, off_t offset);
 ssize_t eintr_write(int fd, void *buf, size_t count);
 fpga_result cat_token_sysfs_path(char *dest, fpga_token token,
 				 const char *path);
@@ -134,6 +136,10 @@ fpga_result cat_handle_sysfs_path(char *dest, fpga_handle handle,
 struct _fpga_object *alloc_fpga_object(const char *sysfspath, const char *name);
 fpga_result destroy_fpga_object(struct _fpga_object *obj);
 fpga_result sync_object(fpga_object object);
+// Read a 64-bit value from each of count attribute objects,
+// syncing each first when flags has FPGA_OBJECT_SYNC.
+fpga_result sync_objects(fpga_object *objs, uint64_t *values,
+			 size_t count, int flags);
 fpga_result make_sysfs_group(char *sysfspath, const char *name,
 			     fpga_object *object, int flags, fpga_handle handle);
 fpga_result make_sysfs_object(char *sysfspath, const char *name,
@@ -134,6 +134,7 @@ xfpga_fpgaCloneObject(fpga_object src, fpga_object *dst)
 	_dst->size = _src->size;
 	_dst->type = _src->type;
 	_dst->max_size = _src->max_size;
+	_dst->max_size_synced = _src->max_size_synced;
 	if (_src->type == FPGA_SYSFS_FILE) {
 		_dst->buffer = opae_calloc(_dst->max_size, sizeof(uint8_t));
 		memcpy(_dst->buffer, _src->buffer, _src->max_size);
@@ -247,6 +248,18 @@ fpga_result __XFPGA_API__ xfpga_fpgaObjectRead64(fpga_object obj,
 	return FPGA_OK;
 }
 
+fpga_result __XFPGA_API__ xfpga_fpgaObjectReadMany(fpga_object *objs,
+						  uint64_t *values,
+						  size_t count,
+						  int flags)
+{
+	if (!count)
+		return FPGA_OK;
+	ASSERT_NOT_NULL(objs);
+	ASSERT_NOT_NULL(values);
+	return sync_objects(objs, values, count, flags);
+}
+
 fpga_result __XFPGA_API__ xfpga_fpgaObjectRead(fpga_object obj,
 					      uint8_t *buffer,
 					      size_t offset,
@@ -145,6 +145,8 @@ struct _fpga_enum_metric {
 };
 
 
+struct _fpga_metric_snapshot;
+
 struct _fpga_bmc_metric {
 
 	char group_name[FPGA_METRIC_STR_SIZE];     // Metrics Group name
@@ -167,6 +169,7 @@ struct _fpga_handle {
 	void *umsg_virt;	        // umsg Virtual Memory pointer
 	uint64_t umsg_size;	        // umsg Virtual Memory Size
 	uint64_t *umsg_iova;	        // umsg IOVA from driver
+	int numa_node;                  // device-local NUMA node, or -1
 
 	// Metric
 	bool metric_enum_status;                             // metric enum status
@@ -174,6 +177,7 @@ struct _fpga_handle {
 	void *bmc_handle;                                    // bmc module handle
 	struct _fpga_bmc_metric *_bmc_metric_cache_value;    // bmc cache values
 	uint64_t num_bmc_metric;                             // num of bmc values
+	struct _fpga_metric_snapshot *metric_snapshot;       // name index, values
 #define OPAE_FLAG_HAS_MMX512 (1u << 0)
 	uint32_t flags;
 };
@@ -237,8 +241,10 @@ struct _fpga_object {
 	int perm;
 	size_t size;
 	size_t max_size;
+	bool max_size_synced;
 	uint8_t *buffer;
 	fpga_object *objects;
+	int fd; // kept open by sync_object(), -1 until first sync
 };
 
 typedef char max_path_t[PATH_MAX];
@@ -52,12 +52,18 @@ fpga_result xfpga_fpgaReadMMIO32(fpga_handle handle, uint32_t mmio_num,
 				 uint64_t offset, uint32_t *value);
 fpga_result xfpga_fpgaWriteMMIO512(fpga_handle handle, uint32_t mmio_num,
 				  uint64_t offset, const void *value);
+fpga_result xfpga_fpgaReadMMIOBatch(fpga_handle handle, fpga_mmio_op *ops,
+				    uint32_t num_ops);
+fpga_result xfpga_fpgaWriteMMIOBatch(fpga_handle handle,
+				     const fpga_mmio_op *ops,
+				     uint32_t num_ops);
 fpga_result xfpga_fpgaMapMMIO(fpga_handle handle, uint32_t mmio_num,
 			      uint64_t **mmio_ptr);
 fpga_result xfpga_fpgaUnmapMMIO(fpga_handle handle, uint32_t mmio_num);
 fpga_result xfpga_fpgaEnumerate(const fpga_properties *filters,
 				uint32_t num_filters, fpga_token *tokens,
 				uint32_t max_tokens, uint32_t *num_matches);
+fpga_result xfpga_fpgaEnumerateRefresh(void);
 fpga_result xfpga_fpgaCloneToken(fpga_token src, fpga_token *dst);
 fpga_result xfpga_fpgaDestroyToken(fpga_token *token);
 fpga_result xfpga_fpgaGetNumUmsg(fpga_handle handle, uint64_t *value);
@@ -69,6 +75,8 @@ fpga_result xfpga_fpgaPrepareBuffer(fpga_handle handle, uint64_t len,
 fpga_result xfpga_fpgaReleaseBuffer(fpga_handle handle, uint64_t wsid);
 fpga_result xfpga_fpgaGetIOAddress(fpga_handle handle, uint64_t wsid,
 				   uint64_t *ioaddr);
+fpga_result xfpga_fpgaGetBufferNumaNode(fpga_handle handle, uint64_t wsid,
+					int *node);
 fpga_result xfpga_fpgaGetOPAECVersion(fpga_version *version);
 fpga_result xfpga_fpgaGetOPAECVersionString(char *version_str, size_t len);
 fpga_result xfpga_fpgaGetOPAECBuildString(char *build_str, size_t len);
@@ -118,6 +126,8 @@ fpga_result xfpga_fpgaObjectGetSize(fpga_object obj, uint32_t *value,
 fpga_result xfpga_fpgaObjectRead(fpga_object obj, uint8_t *buffer,
 				 size_t offset, size_t len, int flags);
 fpga_result xfpga_fpgaObjectRead64(fpga_object obj, uint64_t *value, int flags);
+fpga_result xfpga_fpgaObjectReadMany(fpga_object *objs, uint64_t *values,
+				     size_t count, int flags);
 fpga_result xfpga_fpgaObjectWrite64(fpga_object obj, uint64_t value, int flags);
 fpga_result xfpga_fpgaSetUserClock(fpga_handle handle, uint64_t low_clk,
 				   uint64_t high_clk, int flags);
@@ -130,6 +130,7 @@ PYBIND11_MODULE(_opae, m) {
       .value("IFC_SIM_DFL", FPGA_IFC_SIM_DFL)
       .value("IFC_SIM_VFIO", FPGA_IFC_SIM_VFIO)
       .value("IFC_UIO", FPGA_IFC_UIO)
+      .value("IFC_EMU", FPGA_IFC_EMU)
       .export_values();
 
   // version method
@@ -227,6 +228,12 @@ PYBIND11_MODULE(_opae, m) {
            py::arg("offset"), py::arg("value"), py::arg("csr_space") = 0)
       .def("write_csr64", &handle::write_csr64, handle_doc_write_csr64(),
            py::arg("offset"), py::arg("value"), py::arg("csr_space") = 0)
+      .def("read_csr_batch", handle_read_csr_batch,
+           handle_doc_read_csr_batch(), py::arg("offsets"),
+           py::arg("width") = 64, py::arg("csr_space") = 0)
+      .def("write_csr_batch", handle_write_csr_batch,
+           handle_doc_write_csr_batch(), py::arg("writes"),
+           py::arg("width") = 64, py::arg("csr_space") = 0)
       .def("__getattr__", handle_get_sysobject, sysobject_doc_handle_get())
       .def("__getitem__", handle_get_sysobject, sysobject_doc_handle_get())
       .def("find", handle_find_sysobject, sysobject_doc_handle_find(),
@@ -42,7 +42,8 @@ from ._opae import (
 from ._opae import (DEVICE, ACCELERATOR, OPEN_SHARED, EVENT_ERROR,
                     EVENT_INTERRUPT, EVENT_POWER_THERMAL, ACCELERATOR_ASSIGNED,
                     ACCELERATOR_UNASSIGNED, RECONF_FORCE, SYSOBJECT_GLOB,
-                    IFC_DFL, IFC_VFIO, IFC_SIM_DFL, IFC_SIM_VFIO, IFC_UIO)
+                    IFC_DFL, IFC_VFIO, IFC_SIM_DFL, IFC_SIM_VFIO, IFC_UIO,
+                    IFC_EMU)
 __all__ = ['properties',
            'token',
            'handle',
@@ -73,4 +74,5 @@ __all__ = ['properties',
            'IFC_SIM_DFL',
            'IFC_SIM_VFIO',
            'IFC_UIO',
+           'IFC_EMU',
            ]
@@ -483,6 +483,7 @@ class ls_cmd():
         fpga.IFC_SIM_DFL: "DFL (ASE)",
         fpga.IFC_SIM_VFIO: "VFIO (ASE)",
         fpga.IFC_UIO: "UIO",
+        fpga.IFC_EMU: "Emulated",
     }
 
     str_to_ifc = {
@@ -491,6 +492,7 @@ class ls_cmd():
         "dfl_ase": fpga.IFC_SIM_DFL,
         "vfio_ase": fpga.IFC_SIM_VFIO,
         "uio": fpga.IFC_UIO,
+        "emu": fpga.IFC_EMU,
     }
 
     @staticmethod
@@ -176,6 +176,60 @@ const char *handle_doc_write_csr64() {
   )opaedoc";
 }
 
+const char *handle_doc_read_csr_batch() {
+  return R"opaedoc(
+    Read a list of CSRs belonging to a resource associated with a handle,
+    using a single library call. Returns the values read, in order.
+    Args:
+      offsets: The list of register offsets.
+      width: The access width in bits, 32 or 64. Default is 64.
+      csr_space: The CSR space to read from. Default is 0.
+  )opaedoc";
+}
+
+std::vector<uint64_t> handle_read_csr_batch(
+    handle::ptr_t hnd, const std::vector<uint64_t> &offsets, uint32_t width,
+    uint32_t csr_space) {
+  std::vector<fpga_mmio_op> ops(offsets.size());
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    ops[i].mmio_num = csr_space;
+    ops[i].width = width;
+    ops[i].offset = offsets[i];
+    ops[i].value = 0;
+  }
+
+  hnd->read_csr_batch(ops);
+
+  std::vector<uint64_t> values(ops.size());
+  for (size_t i = 0; i < ops.size(); ++i) values[i] = ops[i].value;
+  return values;
+}
+
+const char *handle_doc_write_csr_batch() {
+  return R"opaedoc(
+    Write a list of CSRs belonging to a resource associated with a handle,
+    using a single library call.
+    Args:
+      writes: The list of (offset, value) pairs to write, in order.
+      width: The access width in bits, 32 or 64. Default is 64.
+      csr_space: The CSR space to write to. Default is 0.
+  )opaedoc";
+}
+
+void handle_write_csr_batch(
+    handle::ptr_t hnd, const std::vector<std::pair<uint64_t, uint64_t>> &writes,
+    uint32_t width, uint32_t csr_space) {
+  std::vector<fpga_mmio_op> ops(writes.size());
+  for (size_t i = 0; i < writes.size(); ++i) {
+    ops[i].mmio_num = csr_space;
+    ops[i].width = width;
+    ops[i].offset = writes[i].first;
+    ops[i].value = writes[i].second;
+  }
+
+  hnd->write_csr_batch(ops);
+}
+
 const char *handle_doc_bind_sva() {
   return R"opaedoc(
     Bind IOMMU shared virtual addressing.
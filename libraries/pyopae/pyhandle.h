@@ -51,5 +51,14 @@ const char *handle_doc_read_csr32();
 const char *handle_doc_read_csr64();
 const char *handle_doc_write_csr32();
 const char *handle_doc_write_csr64();
+const char *handle_doc_read_csr_batch();
+std::vector<uint64_t> handle_read_csr_batch(
+    opae::fpga::types::handle::ptr_t hnd, const std::vector<uint64_t> &offsets,
+    uint32_t width = 64, uint32_t csr_space = 0);
+const char *handle_doc_write_csr_batch();
+void handle_write_csr_batch(
+    opae::fpga::types::handle::ptr_t hnd,
+    const std::vector<std::pair<uint64_t, uint64_t>> &writes,
+    uint32_t width = 64, uint32_t csr_space = 0);
 
 const char *handle_doc_bind_sva();
@@ -186,7 +186,122 @@ size_t pyopae_uio::get_size(uint32_t region_index) {
   return size;
 }
 
+// get a pointer to count bytes at offset, checking bounds and alignment
+uint8_t *pyopae_uio::get_block(uint32_t region_index, uint32_t offset,
+                               size_t count) {
+  uint8_t *vptr = nullptr;
+  size_t size = 0;
+
+  if ((offset % 4) || (count % 4)) {
+    throw std::invalid_argument("offset and size must be 4-byte aligned");
+  }
+
+  if (opae_uio_region_get(&uio_, region_index, &vptr, &size)) {
+    throw std::invalid_argument("Failed to get uio region");
+  }
+
+  if ((offset > size) || (count > size - offset)) {
+    throw std::out_of_range("block exceeds the uio region");
+  }
+
+  return vptr + offset;
+}
+
+// read a block using 64-bit (or 32-bit) accesses
+void pyopae_uio::read_block(uint32_t region_index, uint32_t offset,
+                            uint8_t *dst, size_t count) {
+  uint8_t *ptr = get_block(region_index, offset, count);
+
+  if (!(offset % 8) && !(count % 8)) {
+    volatile uint64_t *src = reinterpret_cast<volatile uint64_t *>(ptr);
+    for (size_t i = 0; i < count / 8; ++i) {
+      uint64_t value = src[i];
+      memcpy(dst + i * 8, &value, 8);
+    }
+  } else {
+    volatile uint32_t *src = reinterpret_cast<volatile uint32_t *>(ptr);
+    for (size_t i = 0; i < count / 4; ++i) {
+      uint32_t value = src[i];
+      memcpy(dst + i * 4, &value, 4);
+    }
+  }
+}
+
+// write a block using 64-bit (or 32-bit) accesses
+void pyopae_uio::write_block(uint32_t region_index, uint32_t offset,
+                             const uint8_t *src, size_t count) {
+  uint8_t *ptr = get_block(region_index, offset, count);
+
+  if (!(offset % 8) && !(count % 8)) {
+    volatile uint64_t *dst = reinterpret_cast<volatile uint64_t *>(ptr);
+    for (size_t i = 0; i < count / 8; ++i) {
+      uint64_t value;
+      memcpy(&value, src + i * 8, 8);
+      dst[i] = value;
+    }
+  } else {
+    volatile uint32_t *dst = reinterpret_cast<volatile uint32_t *>(ptr);
+    for (size_t i = 0; i < count / 4; ++i) {
+      uint32_t value;
+      memcpy(&value, src + i * 4, 4);
+      dst[i] = value;
+    }
+  }
+}
+
 namespace py = pybind11;
+
+// Copy between a region and a contiguous Python buffer without
+// holding the GIL.
+static void block_io(pyopae_uio *u, uint32_t region_index, uint32_t offset,
+                     py::buffer data, bool write) {
+  Py_buffer view;
+  int flags = write ? PyBUF_SIMPLE : (PyBUF_SIMPLE | PyBUF_WRITABLE);
+
+  if (PyObject_GetBuffer(data.ptr(), &view, flags)) {
+    throw py::error_already_set();
+  }
+
+  try {
+    u->get_block(region_index, offset, static_cast<size_t>(view.len));
+  } catch (...) {
+    PyBuffer_Release(&view);
+    throw;
+  }
+
+  {
+    py::gil_scoped_release release;
+    if (write) {
+      u->write_block(region_index, offset,
+                     static_cast<const uint8_t *>(view.buf),
+                     static_cast<size_t>(view.len));
+    } else {
+      u->read_block(region_index, offset, static_cast<uint8_t *>(view.buf),
+                    static_cast<size_t>(view.len));
+    }
+  }
+
+  PyBuffer_Release(&view);
+}
+
+static py::bytes read_block_bytes(pyopae_uio *u, uint32_t region_index,
+                                  uint32_t offset, size_t size) {
+  u->get_block(region_index, offset, size);
+
+  py::bytes out = py::reinterpret_steal<py::bytes>(
+      PyBytes_FromStringAndSize(nullptr, static_cast<Py_ssize_t>(size)));
+  if (!out) {
+    throw py::error_already_set();
+  }
+
+  uint8_t *dst = reinterpret_cast<uint8_t *>(PyBytes_AS_STRING(out.ptr()));
+  {
+    py::gil_scoped_release release;
+    u->read_block(region_index, offset, dst, size);
+  }
+  return out;
+}
+
 PYBIND11_MODULE(pyopaeuio, m) {
   m.doc() = "pybind11 pyopaeuio plugin";
   py::class_<pyopae_uio>(m, "pyopaeuio")
@@ -222,5 +337,19 @@ PYBIND11_MODULE(pyopaeuio, m) {
                pyopae_uio::write64)
       .def("getsize", (size_t(pyopae_uio::*)(uint32_t region_index)) &
                           pyopae_uio::get_size)
+      .def("read_block", &read_block_bytes, py::arg("region_index"),
+           py::arg("offset"), py::arg("size"))
+      .def("read_block",
+           [](pyopae_uio *u, uint32_t region_index, uint32_t offset,
+              py::buffer out) {
+             block_io(u, region_index, offset, out, false);
+           },
+           py::arg("region_index"), py::arg("offset"), py::arg("out"))
+      .def("write_block",
+           [](pyopae_uio *u, uint32_t region_index, uint32_t offset,
+              py::buffer data) {
+             block_io(u, region_index, offset, data, true);
+           },
+           py::arg("region_index"), py::arg("offset"), py::arg("data"))
       .def_readonly("numregions", &pyopae_uio::num_regions);
 }
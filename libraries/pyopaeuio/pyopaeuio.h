@@ -52,6 +52,11 @@ class pyopae_uio {
   uint64_t write32(uint32_t region_index, uint32_t offset, uint32_t value);
   uint64_t write64(uint32_t region_index, uint32_t offset, uint64_t value);
   size_t get_size(uint32_t region_index);
+  void read_block(uint32_t region_index, uint32_t offset, uint8_t *dst,
+                  size_t count);
+  void write_block(uint32_t region_index, uint32_t offset, const uint8_t *src,
+                   size_t count);
+  uint8_t *get_block(uint32_t region_index, uint32_t offset, size_t count);
   uint32_t num_regions;
 
  private:
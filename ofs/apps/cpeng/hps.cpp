@@ -25,7 +25,10 @@
 // POSSIBILITY OF SUCH DAMAGE.
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <mutex>
 #include <thread>
 #include <vector>
 #include <unistd.h>
@@ -65,6 +68,7 @@ public:
     , destination_offset_(0x2000000)
     , timeout_usec_(default_timeout_usec.count())
     , chunk_(pg_size)
+    , buffers_(2)
     , data_request_limit_(512)
     , soft_reset_(false)
     , skip_ssbl_verify_(false)
@@ -106,6 +110,12 @@ public:
       ->check(CLI::IsMember(limits));
     app->add_option("-c,--chunk", chunk_, "Chunk size. 0 indicates no chunks")
       ->default_str(std::to_string(chunk_));
+    app->add_option("-b,--buffers", buffers_,
+                    "Number of chunk buffers. With more than one, the next "
+                    "chunks are read from the file while the current one is "
+                    "copied")
+      ->default_str(std::to_string(buffers_))
+      ->check(CLI::Range(1, 64));
     app->add_flag("--soft-reset", soft_reset_, "Issue soft reset only");
     app->add_flag("--skip-ssbl-verify", skip_ssbl_verify_, "Do not wait for ssbl verify");
     app->add_flag("--skip-kernel-verify", skip_kernel_verify_, "Do not wait for kernel verify");
@@ -144,62 +154,47 @@ public:
     // if chunk_ CLI arg is 0, use the file size
     // otherwise, use the smaller of chunk_ and file size
     size_t chunk = chunk_ ? std::min(static_cast<size_t>(chunk_), sz) : sz;
-    shared_buffer::ptr_t buffer(0);
+    size_t total_chunks = chunk ? (sz + chunk - 1) / chunk : 0;
+    size_t n_buffers = std::max<size_t>(1, std::min<size_t>(buffers_, total_chunks));
     // make sure we align our buffer size to data request limit
-    try {
-      buffer = shared_buffer::allocate(afu->handle(),
-                                       aligned(chunk, data_request_limit_));
-    } catch (opae_exception &ex) {
-      log_->error("could not allocate {} bytes of memory", chunk);
-      if (chunk > pg_size) {
-        auto hugepage_sz = chunk <= MB(2) ? "2MB" : "1GB";
-        log_->error("might need {} hugepages reserved", hugepage_sz);
+    std::vector<shared_buffer::ptr_t> buffers;
+    while (buffers.size() < n_buffers) {
+      try {
+        buffers.push_back(shared_buffer::allocate(afu->handle(),
+                                                  aligned(chunk, data_request_limit_)));
+      } catch (opae_exception &ex) {
+        if (!buffers.empty()) {
+          log_->warn("could only allocate {} of {} buffers",
+                     buffers.size(), n_buffers);
+          break;
+        }
+        log_->error("could not allocate {} bytes of memory", chunk);
+        if (chunk > pg_size) {
+          auto hugepage_sz = chunk <= MB(2) ? "2MB" : "1GB";
+          log_->error("might need {} hugepages reserved", hugepage_sz);
+        }
+        return 3;
       }
-      return 3;
     }
-    // get a char* of the buffer so we can read into it every chunk iteration
-    auto ptr = reinterpret_cast<char*>(const_cast<uint8_t*>(buffer->c_type()));
 
-    memset(ptr, 0, buffer->size());
-    size_t written = 0;
-    log_->info("starting copy of file:{}, size: {}, chunk size: {}",
-               filename_, sz, chunk);
-    uint32_t n_chunks = 0;
-    // set our xfer size to chunk size
-    // but align it with req. limit size in case
-    // our chunk is the entire file
-    auto xfer_sz = aligned(chunk, data_request_limit_);
+    log_->info("starting copy of file:{}, size: {}, chunk size: {}, buffers: {}",
+               filename_, sz, chunk, buffers.size());
     // set the data req. limit to CLI arg (default arg is 512, default in HW is 1k)
     ofs_cpeng_set_data_req_limit(&cpeng, limit_map[data_request_limit_]);
-    while (written < sz) {
-        auto unread = sz-written;
-        inp.read(ptr, chunk);
-        if (ofs_cpeng_copy_chunk(
-              &cpeng, buffer->io_address(),
-              destination_offset_ + written,
-              xfer_sz,
-              timeout_usec_)) {
-          auto status = ofs_cpeng_dma_status(&cpeng);
-          log_->warn("copy chunk: {}, size: {}, unread: {}, dma_status: {:x}",
-                      n_chunks, xfer_sz, unread, status);
-          if (dmastatus_err(&cpeng)) {
-            return 4;
-          }
-        }
-        ++n_chunks;
-        written += chunk;
-        // if we're at the last chunk,
-        // 1. zero out our buffer
-        // 2. set 'chunk' to number of unread bytes
-        // 3. set 'xfer_sz' to the req. limit aligned value of the last chunk
-        if (unread < chunk) {
-          memset(ptr, 0, chunk);
-          chunk = unread;
-          xfer_sz = aligned(chunk, data_request_limit_);
-          log_->info("last chunk {}, aligned {}", chunk, xfer_sz);
-        }
+
+    auto start = std::chrono::steady_clock::now();
+    uint32_t n_chunks = 0;
+    int res = copy_file(&cpeng, inp, sz, chunk, buffers, n_chunks);
+    if (res) {
+      return res;
     }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
     log_->info("transferred file in {} chunk(s)", n_chunks);
+    log_->info("{:.3f} ms, {:.2f} MB/s (file read {:.3f} ms, copy engine {:.3f} ms)",
+               elapsed.count() * 1E3,
+               static_cast<double>(sz) / MB(1) / elapsed.count(),
+               read_time_.count() * 1E3, copy_time_.count() * 1E3);
     ofs_cpeng_image_complete(&cpeng);
 
     // wait for both ssbl and kernel verify (if not skipped)
@@ -215,6 +210,118 @@ public:
 
 
 private:
+  // A chunk read into one of the DMA buffers, ready to copy
+  struct filled_chunk {
+    size_t index;   // buffer index
+    size_t offset;  // offset of the chunk in the file
+    size_t size;    // bytes read from the file
+  };
+
+  // Copy the file in chunks of size chunk. A reader thread fills free
+  // buffers from the file while this thread hands filled buffers to the
+  // copy engine, so with more than one buffer the file I/O of later
+  // chunks overlaps the device copy of earlier ones.
+  int copy_file(ofs_cpeng *cpeng, std::ifstream &inp, size_t sz, size_t chunk,
+                std::vector<shared_buffer::ptr_t> &buffers, uint32_t &n_chunks)
+  {
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<size_t> free_buffers;
+    std::deque<filled_chunk> filled;
+    bool stop = false;
+    bool read_error = false;
+    int res = 0;
+
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      free_buffers.push_back(i);
+    }
+    read_time_ = std::chrono::duration<double>::zero();
+    copy_time_ = std::chrono::duration<double>::zero();
+
+    std::thread reader([&]() {
+      for (size_t offset = 0; offset < sz; offset += chunk) {
+        size_t index;
+        {
+          std::unique_lock<std::mutex> lock(mtx);
+          cv.wait(lock, [&]() { return stop || !free_buffers.empty(); });
+          if (stop) {
+            return;
+          }
+          index = free_buffers.front();
+          free_buffers.pop_front();
+        }
+
+        auto size = std::min(chunk, sz - offset);
+        auto ptr = reinterpret_cast<char*>(
+          const_cast<uint8_t*>(buffers[index]->c_type()));
+        auto start = std::chrono::steady_clock::now();
+        inp.read(ptr, size);
+        // zero the tail that the request limit alignment will transfer
+        memset(ptr + size, 0, buffers[index]->size() - size);
+        read_time_ += std::chrono::steady_clock::now() - start;
+
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!inp) {
+          read_error = true;
+          cv.notify_all();
+          return;
+        }
+        filled.push_back({index, offset, size});
+        cv.notify_all();
+      }
+    });
+
+    for (size_t written = 0; written < sz; ) {
+      filled_chunk next;
+      {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&]() { return read_error || !filled.empty(); });
+        if (filled.empty()) {
+          log_->error("error reading file: {}", filename_);
+          res = 5;
+          break;
+        }
+        next = filled.front();
+        filled.pop_front();
+      }
+
+      auto xfer_sz = aligned(next.size, data_request_limit_);
+      if (next.size < chunk) {
+        log_->info("last chunk {}, aligned {}", next.size, xfer_sz);
+      }
+      auto start = std::chrono::steady_clock::now();
+      int copy_res = ofs_cpeng_copy_chunk(
+            cpeng, buffers[next.index]->io_address(),
+            destination_offset_ + next.offset,
+            xfer_sz,
+            timeout_usec_);
+      copy_time_ += std::chrono::steady_clock::now() - start;
+      if (copy_res) {
+        auto status = ofs_cpeng_dma_status(cpeng);
+        log_->warn("copy chunk: {}, size: {}, unread: {}, dma_status: {:x}",
+                    n_chunks, xfer_sz, sz - next.offset, status);
+        if (dmastatus_err(cpeng)) {
+          res = 4;
+          break;
+        }
+      }
+      ++n_chunks;
+      written += next.size;
+
+      std::lock_guard<std::mutex> lock(mtx);
+      free_buffers.push_back(next.index);
+      cv.notify_all();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      stop = true;
+      cv.notify_all();
+    }
+    reader.join();
+    return res;
+  }
+
   bool dmastatus_err(ofs_cpeng *cpeng)
   {
     if (ofs_cpeng_dma_status_error(cpeng)) {
@@ -259,10 +366,13 @@ private:
   uint64_t destination_offset_;
   uint32_t timeout_usec_;
   uint32_t chunk_;
+  uint32_t buffers_;
   uint32_t data_request_limit_;
   bool soft_reset_;
   bool skip_ssbl_verify_;
   bool skip_kernel_verify_;
+  std::chrono::duration<double> read_time_;
+  std::chrono::duration<double> copy_time_;
   std::shared_ptr<spdlog::logger> log_;
 };
 
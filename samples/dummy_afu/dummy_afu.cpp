@@ -28,6 +28,7 @@
 
 #include "mmio.h"
 #include "lpbk.h"
+#include "lpbk_perf.h"
 #include "ddr.h"
 
 #include "dummy_afu.h"
@@ -40,6 +41,7 @@ int main(int argc, char* argv[])
   app.register_command<dummy_afu::mmio_test>();
   app.register_command<dummy_afu::ddr_test>();
   app.register_command<dummy_afu::lpbk_test>();
+  app.register_command<dummy_afu::lpbk_perf_test>();
   return app.main(argc, argv);
 }
 
@@ -0,0 +1,201 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <poll.h>
+#include <unistd.h>
+#include <opae/event.h>
+#include "afu_test.h"
+#include "dummy_afu.h"
+
+using test_afu = opae::afu_test::afu;
+using opae::fpga::types::shared_buffer;
+
+namespace dummy_afu {
+
+// Compare the ways of waiting for a loopback completion: poll(2)
+// and read(2) on the interrupt eventfd, fpgaWaitEvents, and
+// fpgaWaitEventsHybrid spinning on the copied cache line first.
+class lpbk_perf_test : public test_command
+{
+public:
+  lpbk_perf_test()
+  : iterations_(10000)
+  , mode_("all")
+  , spin_usec_(20)
+  , timeout_msec_(1000)
+  {
+  }
+  virtual ~lpbk_perf_test(){}
+  virtual const char *name() const
+  {
+    return "lpbk-perf";
+  }
+
+  virtual const char *description() const
+  {
+    return "measure loopback completion latency per interrupt wait mode";
+  }
+
+  virtual void add_options(CLI::App *app)
+  {
+    app->add_option("-i,--iterations",
+                    iterations_,
+                    "number of loopback copies per mode")->check(CLI::Range(1u, 100000000u))->default_str(std::to_string(iterations_));
+    auto opt = app->add_option("-m,--mode", mode_, "wait mode");
+    opt->check(CLI::IsMember({"poll", "events", "hybrid", "all"}))->default_str(mode_);
+    app->add_option("--spin-usec",
+                    spin_usec_,
+                    "hybrid mode spin time before sleeping")->default_str(std::to_string(spin_usec_));
+    app->add_option("--timeout",
+                    timeout_msec_,
+                    "per-copy timeout in msec")->default_str(std::to_string(timeout_msec_));
+  }
+
+  virtual int run(test_afu *afu, CLI::App *app)
+  {
+    (void)app;
+    auto d_afu = dynamic_cast<dummy_afu*>(afu);
+    auto log = spdlog::get(this->name());
+    auto done = d_afu->register_interrupt();
+    source_ = d_afu->allocate(64);
+    d_afu->fill(source_);
+    destination_ = d_afu->allocate(64);
+    d_afu->write64(MEM_TEST_SRC_ADDR, source_->io_address());
+    d_afu->write64(MEM_TEST_DST_ADDR, destination_->io_address());
+
+    std::vector<std::string> modes;
+    if (mode_ == "all")
+      modes = { "poll", "events", "hybrid" };
+    else
+      modes = { mode_ };
+
+    int res = 0;
+    for (auto &m : modes) {
+      res += run_mode(log, d_afu, done, m);
+    }
+    return res;
+  }
+
+protected:
+  int run_mode(std::shared_ptr<spdlog::logger> log, dummy_afu *afu,
+               event::ptr_t done, const std::string &mode)
+  {
+    using namespace std::chrono;
+    fpga_event_handle eh = done->get();
+    // The last qword of the destination line doubles as the
+    // completion flag: the copy makes it non-zero.
+    auto flag = reinterpret_cast<volatile uint64_t*>(
+      destination_->c_type() + 56);
+    bool use_poll = mode == "poll";
+    bool hybrid = mode == "hybrid";
+    std::vector<double> usec(iterations_);
+    uint32_t woken = 0;
+    uint64_t count = 0;
+    uint32_t ready = 0;
+
+    // Drop interrupts left over from a previous mode.
+    fpgaWaitEvents(&eh, 1, 0, &count, &ready);
+
+    auto begin = high_resolution_clock::now();
+    for (uint32_t i = 0; i < iterations_; ++i) {
+      source_->write<uint64_t>(i + 1, 56);
+      *flag = 0;
+
+      auto start = high_resolution_clock::now();
+      afu->write64(MEM_TEST_CTRL, 0x0);
+      afu->write64(MEM_TEST_CTRL, 0b1);
+
+      while (!*flag) {
+        if (use_poll) {
+          ready = poll_wait(done->os_object());
+        } else if (!hybrid) {
+          if (fpgaWaitEvents(&eh, 1, timeout_msec_, &count, &ready))
+            throw std::runtime_error("fpgaWaitEvents failed");
+        } else {
+          if (fpgaWaitEventsHybrid(&eh, 1, timeout_msec_, &count, &ready,
+                                   flag, spin_usec_))
+            throw std::runtime_error("fpgaWaitEventsHybrid failed");
+          if (!ready && *flag)
+            break;
+        }
+        if (!ready && !*flag)
+          throw std::runtime_error("timeout error");
+        ++woken;
+      }
+
+      auto end = high_resolution_clock::now();
+      usec[i] = duration_cast<duration<double, std::micro>>(end - start).count();
+
+      if (*flag != i + 1) {
+        log->error("{0}: copy {1} returned 0x{2:x}", mode, i, *flag);
+        return 1;
+      }
+    }
+    auto total = duration_cast<duration<double>>(
+      high_resolution_clock::now() - begin).count();
+
+    std::sort(usec.begin(), usec.end());
+    double sum = 0.0;
+    for (auto u : usec)
+      sum += u;
+
+    log->info("{0:>6}: {1} copies, {2:.0f} copies/sec, "
+              "latency usec mean {3:.2f} p50 {4:.2f} p99 {5:.2f} max {6:.2f}, "
+              "{7} wakeups",
+              mode, iterations_, iterations_ / total,
+              sum / iterations_, usec[iterations_ / 2],
+              usec[(iterations_ * 99) / 100], usec.back(), woken);
+    return 0;
+  }
+
+  uint32_t poll_wait(int fd)
+  {
+    struct pollfd pfd;
+    uint64_t count = 0;
+    pfd.events = POLLIN;
+    pfd.fd = fd;
+    auto ret = poll(&pfd, 1, timeout_msec_);
+    if (ret < 0)
+      throw std::runtime_error(strerror(errno));
+    if (ret == 0)
+      return 0;
+    if (read(fd, &count, sizeof(count)) != sizeof(count))
+      throw std::runtime_error(strerror(errno));
+    return 1;
+  }
+
+  uint32_t iterations_;
+  std::string mode_;
+  uint64_t spin_usec_;
+  int timeout_msec_;
+  shared_buffer::ptr_t source_;
+  shared_buffer::ptr_t destination_;
+};
+
+} // end of namespace dummy_afu
@@ -24,6 +24,10 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE.
 #pragma once
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include <unistd.h>
+
 #include <opae/cxx/core/events.h>
 #include <opae/cxx/core/shared_buffer.h>
 #include <opae/cxx/core/token.h>
@@ -379,6 +383,11 @@ public:
   , count_(1)
   , he_interleave_(0)
   , he_interrupt_(0xffff)
+  , he_numa_node_(-1)
+  , he_sweep_(false)
+  , he_sweep_repeat_(5)
+  , he_sweep_format_("json")
+  , he_sweep_output_("host_exerciser_sweep")
   {
     // Mode
     app_.add_option("-m,--mode", he_modes_, "host exerciser mode {lpbk,read, write, trput}")
@@ -419,16 +428,58 @@ public:
 
     app_.add_option("--clock-mhz", he_clock_mhz_,
         "Clock frequency (MHz) -- when zero, read the frequency from the AFU")->default_val("0");
+
+    // Buffer placement
+    app_.add_option("--numa-node", he_numa_node_,
+        "NUMA node for DMA buffers -- when negative, use the device's node")->default_val("-1");
+
+    // Sweep
+    app_.add_option("--sweep", he_sweep_,
+        "Run each combination of the --sweep-* lists and report statistics")->default_val("false");
+
+    app_.add_option("--sweep-modes", he_sweep_modes_,
+        "modes to sweep -- default is all")
+      ->transform(CLI::CheckedTransformer(he_modes));
+
+    app_.add_option("--sweep-cls", he_sweep_cls_,
+        "CLs per request to sweep -- default is all the platform supports")
+      ->transform(CLI::CheckedTransformer(he_req_cls_len));
+
+    app_.add_option("--sweep-sizes", he_sweep_sizes_,
+        "buffer sizes in KiB to sweep -- default is 64")
+      ->transform(CLI::Range(1, 1024 * 1024));
+
+    app_.add_option("--sweep-numa", he_sweep_numa_,
+        "NUMA nodes for DMA buffers to sweep -- default is --numa-node");
+
+    app_.add_option("--sweep-repeat", he_sweep_repeat_,
+        "repetitions of each point of the sweep")
+      ->transform(CLI::Range(1, 100000))->default_val("5");
+
+    app_.add_option("--sweep-format", he_sweep_format_,
+        "sweep report format {json, csv}")
+      ->check(CLI::IsMember({"json", "csv"}))->default_val("json");
+
+    app_.add_option("--sweep-output", he_sweep_output_,
+        "sweep report file, '.json' or '.csv' is appended -- '-' is stdout")
+      ->default_val("host_exerciser_sweep");
    }
 
   virtual int run(CLI::App *app, test_command::ptr_t test) override
   {
     int res = exit_codes::not_run;
 
+    // Keep stdout for the sweep report when it is written there.
+    if (he_sweep_ && he_sweep_output_ == "-") {
+      logger_->sinks().clear();
+      logger_->sinks().push_back(
+        std::make_shared<spdlog::sinks::stderr_color_sink_mt>());
+    }
+
     logger_->set_pattern("    %v");
     // Info prints details of an individual run. Turn it on if doing only one test
     // and the user hasn't changed level from the default.
-    if ((log_level_.compare("warning") == 0) && !he_test_all_)
+    if ((log_level_.compare("warning") == 0) && !he_test_all_ && !he_sweep_)
         logger_->set_level(spdlog::level::info);
 
     logger_->info("starting test run, count of {0:d}", count_);
@@ -476,7 +527,30 @@ public:
 
   shared_buffer::ptr_t allocate(size_t size)
   {
-    return shared_buffer::allocate(handle_, size);
+    if (he_numa_node_ < 0)
+      return shared_buffer::allocate(handle_, size);
+
+    // Prefer the requested node for this thread while the buffer is
+    // allocated and pinned, eg to measure the cost of a remote node.
+    unsigned long mask[1024 / (8 * sizeof(unsigned long))] = { 0 };
+    const size_t bits = 8 * sizeof(unsigned long);
+    if (he_numa_node_ >= 1024)
+      throw std::out_of_range("NUMA node out of range");
+    mask[he_numa_node_ / bits] = 1UL << (he_numa_node_ % bits);
+
+    if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, 1024 + 1))
+      throw std::runtime_error(strerror(errno));
+
+    shared_buffer::ptr_t buffer;
+    try {
+      buffer = shared_buffer::allocate(handle_, size, false,
+                                       FPGA_BUF_NUMA_ANY);
+    } catch (...) {
+      syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+      throw;
+    }
+    syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+    return buffer;
   }
 
   void fill(shared_buffer::ptr_t buffer)
@@ -554,6 +628,15 @@ public:
   uint32_t he_interrupt_;
   uint32_t he_contmodetime_;
   uint32_t he_clock_mhz_;
+  int he_numa_node_;
+  bool he_sweep_;
+  std::vector<uint32_t> he_sweep_modes_;
+  std::vector<uint32_t> he_sweep_cls_;
+  std::vector<uint32_t> he_sweep_sizes_;
+  std::vector<int> he_sweep_numa_;
+  uint32_t he_sweep_repeat_;
+  std::string he_sweep_format_;
+  std::string he_sweep_output_;
 
   std::map<uint32_t, uint32_t> limits_;
 
@@ -26,9 +26,12 @@
 #pragma once
 
 #include <unistd.h>
+#include <fstream>
+#include <iomanip>
 
 #include "afu_test.h"
 #include "host_exerciser.h"
+#include "host_exerciser_report.h"
 
 using test_afu = opae::afu_test::afu;
 using opae::fpga::types::shared_buffer;
@@ -59,6 +62,8 @@ public:
           he_lpbk_api_ver_ = 0;
           he_lpbk_atomics_supported_ = false;
           is_ase_sim_ = false;
+          buffer_size_ = LPBK1_BUFFER_SIZE;
+          stdout_buf_ = std::cout.rdbuf();
     }
     virtual ~host_exerciser_cmd() {}
 
@@ -143,6 +148,21 @@ public:
         return (uint64_t(dsm_status->num_writes_h) << 32) | dsm_status->num_writes_l;
     }
 
+    // Number of cache lines moved by the last test, for bandwidth
+    uint64_t dsm_num_cache_lines(const volatile he_dsm_status *dsm_status)
+    {
+        // calculate number of cache lines in continuous mode
+        if (host_exe_->he_continuousmode_) {
+            if (he_lpbk_cfg_.TestMode == HOST_EXEMODE_READ)
+                return dsm_num_reads(dsm_status);
+            else if (he_lpbk_cfg_.TestMode == HOST_EXEMODE_WRITE)
+                return dsm_num_writes(dsm_status);
+            else
+                return dsm_num_reads(dsm_status) + dsm_num_writes(dsm_status);
+        }
+        return buffer_size_ / (1 * CL);
+    }
+
     void he_perf_counters()
     {
         volatile he_dsm_status *dsm_status = NULL;
@@ -156,17 +176,7 @@ public:
             return;
 
         host_exe_->logger_->info("Host Exerciser Performance Counter:");
-        // calculate number of cache lines in continuous mode
-        if (host_exe_->he_continuousmode_) {
-            if (he_lpbk_cfg_.TestMode == HOST_EXEMODE_READ)
-                num_cache_lines = dsm_num_reads(dsm_status);
-            else if (he_lpbk_cfg_.TestMode == HOST_EXEMODE_WRITE)
-                num_cache_lines = (dsm_num_writes(dsm_status));
-            else
-                num_cache_lines = dsm_num_reads(dsm_status) + dsm_num_writes(dsm_status);
-        } else {
-            num_cache_lines = (LPBK1_BUFFER_SIZE / (1 * CL));
-        }
+        num_cache_lines = dsm_num_cache_lines(dsm_status);
 
         host_exerciser_status();
 
@@ -306,7 +316,7 @@ public:
 
         // Normal (non-atomic) is a simple comparison
         if (he_lpbk_cfg_.AtomicFunc == HOSTEXE_ATOMIC_OFF) {
-            return (source_->compare(destination_, source_->size()));
+            return (source_->compare(destination_, buffer_size_));
         }
 
         // Atomic mode is a far more complicated comparison. The source buffer
@@ -317,7 +327,7 @@ public:
         bool is_cas = (he_lpbk_cfg_.AtomicFunc & 0xc) == 8;
 
         // Ignore the last entry to work around an off by one copy error
-        for (uint64_t i = 0; i < source_->size()/CL; i += 1) {
+        for (uint64_t i = 0; i < buffer_size_/CL; i += 1) {
             // In source_, the first entry in every line is the atomically modified
             // value. The second entry holds the original value, hashed with a constant
             // so it isn't a simple repetition.
@@ -616,7 +626,7 @@ public:
 
             // Initialize buffer values
             he_init_src_buffer(source_);
-            std::fill_n(destination_->c_type(), LPBK1_BUFFER_SIZE, 0xBE);
+            std::fill_n(destination_->c_type(), buffer_size_, 0xBE);
 
             int test_status = run_single_test();
             status |= test_status;
@@ -637,7 +647,7 @@ public:
 
                 // Initialize buffer values
                 he_init_src_buffer(source_);
-                std::fill_n(destination_->c_type(), LPBK1_BUFFER_SIZE, 0xBE);
+                std::fill_n(destination_->c_type(), buffer_size_, 0xBE);
 
                 int test_status = run_single_test();
                 status |= test_status;
@@ -734,6 +744,12 @@ public:
         auto d_afu = dynamic_cast<host_exerciser*>(afu);
         host_exe_ = dynamic_cast<host_exerciser*>(afu);
 
+        // With --sweep-output -, stdout carries only the sweep report;
+        // progress messages go to stderr until the test is done.
+        stdout_for_report guard(host_exe_->he_sweep_ &&
+                                host_exe_->he_sweep_output_ == "-");
+        stdout_buf_ = guard.stdout_buf();
+
         token_ = d_afu->get_token();
 
         // Read HW details
@@ -782,10 +798,34 @@ public:
         he_lpbk_ctl_.ResetL = 1;
         d_afu->write32(HE_CTL, he_lpbk_ctl_.value);
 
+        allocate_buffers(LPBK1_BUFFER_ALLOCATION_SIZE);
+        set_buffer_size(LPBK1_BUFFER_SIZE);
+
+        int status = 0;
+        if (host_exe_->he_sweep_)
+            status = run_sweep();
+        else if (host_exe_->he_test_all_)
+            status = run_all_tests();
+        else
+            status = run_single_test();
+
+        return status;
+    }
+
+    // Allocate the source, destination and DSM buffers and point the
+    // AFU at them. Any previous buffers are released first.
+    void allocate_buffers(size_t size)
+    {
+        auto d_afu = host_exe_;
+
+        source_.reset();
+        destination_.reset();
+        dsm_.reset();
+
         /* Allocate Source Buffer
         Write to CSR_SRC_ADDR */
         std::cout << "Allocate SRC Buffer" << std::endl;
-        source_ = d_afu->allocate(LPBK1_BUFFER_ALLOCATION_SIZE);
+        source_ = d_afu->allocate(size);
         host_exe_->logger_->debug("    VA 0x{0}  IOVA 0x{1:x}",
                                   (void*)source_->c_type(), source_->io_address());
         d_afu->write64(HE_SRC_ADDR, cacheline_aligned_addr(source_->io_address()));
@@ -794,11 +834,11 @@ public:
         /* Allocate Destination Buffer
             Write to CSR_DST_ADDR */
         std::cout << "Allocate DST Buffer" << std::endl;
-        destination_ = d_afu->allocate(LPBK1_BUFFER_ALLOCATION_SIZE);
+        destination_ = d_afu->allocate(size);
         host_exe_->logger_->debug("    VA 0x{0}  IOVA 0x{1:x}",
                                   (void*)destination_->c_type(), destination_->io_address());
         d_afu->write64(HE_DST_ADDR, cacheline_aligned_addr(destination_->io_address()));
-        std::fill_n(destination_->c_type(), LPBK1_BUFFER_SIZE, 0xBE);
+        std::fill_n(destination_->c_type(), size, 0xBE);
 
         /* Allocate DSM Buffer
             Write to CSR_AFU_DSM_BASEL */
@@ -810,18 +850,152 @@ public:
         d_afu->write32(HE_DSM_BASEH, cacheline_aligned_addr(dsm_->io_address()) >> 32);
         std::fill_n(dsm_->c_type(), LPBK1_DSM_SIZE, 0x0);
 
+        // Report placement, so bandwidth can be compared across nodes
+        // with --numa-node.
+        std::cout << "Buffer NUMA node: SRC " << source_->numa_node()
+                  << " DST " << destination_->numa_node()
+                  << " DSM " << dsm_->numa_node() << std::endl;
+    }
+
+    // Use the first size bytes of the buffers for the following tests
+    void set_buffer_size(size_t size)
+    {
+        buffer_size_ = size;
+
         // Number of cache lines
-        d_afu->write64(HE_NUM_LINES, (LPBK1_BUFFER_SIZE / (1 * CL)) -1);
+        host_exe_->write64(HE_NUM_LINES, (buffer_size_ / (1 * CL)) -1);
+    }
 
+    // Run every combination of the --sweep-* lists, --sweep-repeat times
+    // each, and write the statistics to --sweep-output. The buffers are
+    // allocated once per NUMA node, at the largest size in the sweep.
+    int run_sweep()
+    {
+        std::vector<uint32_t> modes = host_exe_->he_sweep_modes_;
+        std::vector<uint32_t> cls = host_exe_->he_sweep_cls_;
+        std::vector<uint32_t> sizes = host_exe_->he_sweep_sizes_;
+        std::vector<int> nodes = host_exe_->he_sweep_numa_;
+        std::vector<sweep_point> points;
         int status = 0;
-        if (host_exe_->he_test_all_)
-            status = run_all_tests();
+
+        if (modes.empty()) {
+            for (auto m : he_modes)
+                modes.push_back(m.second);
+        }
+        if (cls.empty()) {
+            for (auto c : he_req_cls_len)
+                cls.push_back(c.second);
+        }
+        if (sizes.empty())
+            sizes.push_back(LPBK1_BUFFER_SIZE / KB);
+        if (nodes.empty())
+            nodes.push_back(host_exe_->he_numa_node_);
+
+        // Each point runs to completion. Atomics are not swept.
+        host_exe_->he_continuousmode_ = false;
+        he_lpbk_cfg_.Continuous = 0;
+        he_lpbk_cfg_.AtomicFunc = HOSTEXE_ATOMIC_OFF;
+
+        volatile he_dsm_status *dsm_status = nullptr;
+        size_t max_size = *std::max_element(sizes.begin(), sizes.end()) * KB;
+
+        for (auto node : nodes) {
+            host_exe_->he_numa_node_ = node;
+            allocate_buffers(max_size);
+            dsm_status = reinterpret_cast<he_dsm_status *>((uint8_t*)dsm_->c_type());
+
+            for (auto size : sizes) {
+                set_buffer_size(size * KB);
+
+                for (auto mode : modes) {
+                    he_lpbk_cfg_.TestMode = mode;
+
+                    for (auto len : cls) {
+                        if (len > he_lpbk_max_reqlen_) {
+                            host_exe_->logger_->warn("skipping {0}: not supported by this platform",
+                                                     key_of(he_req_cls_len, len));
+                            continue;
+                        }
+                        set_cfg_reqlen(len);
+
+                        sweep_point p;
+                        p.mode = key_of(he_modes, mode);
+                        p.cls = key_of(he_req_cls_len, len);
+                        p.size_kb = size;
+                        p.numa_node = source_->numa_node();
+                        p.failed = 0;
+                        p.reads = 0;
+                        p.writes = 0;
+
+                        if (mode == HOST_EXEMODE_LPBK1)
+                            he_init_src_buffer(source_);
+
+                        for (uint32_t i = 0; i < host_exe_->he_sweep_repeat_ && !g_he_exit; ++i) {
+                            if (mode == HOST_EXEMODE_LPBK1)
+                                std::fill_n(destination_->c_type(), buffer_size_, 0xBE);
+
+                            uint64_t ticks = 0;
+                            if (!run_single_test())
+                                ticks = dsm_num_ticks(dsm_status);
+                            if (!ticks) {
+                                ++p.failed;
+                                continue;
+                            }
+
+                            p.ticks.push_back(ticks);
+                            p.bandwidth.push_back(he_num_xfers_to_bw(dsm_num_cache_lines(dsm_status), ticks));
+                            p.reads = dsm_num_reads(dsm_status);
+                            p.writes = dsm_num_writes(dsm_status);
+                        }
+
+                        if (p.failed)
+                            status = -1;
+
+                        std::cerr << "  " << p.mode << " " << p.cls << " "
+                                  << p.size_kb << " KiB node " << p.numa_node << ": "
+                                  << std::fixed << std::setprecision(3)
+                                  << percentile(p.bandwidth, 50) << " GB/s median"
+                                  << (p.failed ? " (failures)" : "") << std::endl;
+                        points.push_back(p);
+                    }
+                }
+            }
+        }
+
+        std::ofstream file;
+        bool to_stdout = host_exe_->he_sweep_output_ == "-";
+        if (!to_stdout) {
+            std::string path = host_exe_->he_sweep_output_ + "." +
+                               host_exe_->he_sweep_format_;
+            file.open(path);
+            if (!file.is_open()) {
+                std::cerr << "Failed to open " << path << std::endl;
+                return -1;
+            }
+            std::cout << "Sweep report: " << path << std::endl;
+        }
+        std::ostream out(stdout_buf_);
+        std::ostream &os = to_stdout ? out : file;
+
+        if (host_exe_->he_sweep_format_ == "csv")
+            write_csv(os, points);
         else
-            status = run_single_test();
+            write_json(os, name(), he_lpbk_api_ver_,
+                       host_exe_->he_clock_mhz_, points);
 
         return status;
     }
 
+    template<typename M>
+    static std::string key_of(const M &m, uint32_t value)
+    {
+        for (auto it : m) {
+            if (it.second == value)
+                return it.first;
+        }
+        return std::to_string(value);
+    }
+
 protected:
     he_cfg he_lpbk_cfg_;
     he_ctl he_lpbk_ctl_;
@@ -835,6 +1009,8 @@ protected:
     uint8_t he_lpbk_api_ver_;
     bool he_lpbk_atomics_supported_;
     bool is_ase_sim_;
+    size_t buffer_size_;
+    std::streambuf *stdout_buf_;
 };
 
 } // end of namespace host_exerciser
@@ -0,0 +1,193 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace host_exerciser {
+
+// Results of the repetitions of one point of a sweep
+struct sweep_point {
+  std::string mode;
+  std::string cls;
+  uint64_t size_kb;
+  int numa_node;
+  uint32_t failed;
+  uint64_t reads;
+  uint64_t writes;
+  std::vector<double> bandwidth;
+  std::vector<uint64_t> ticks;
+};
+
+// Nearest-rank percentile of an unsorted sample, 0 when empty
+template<typename T>
+T percentile(std::vector<T> v, double p)
+{
+  if (v.empty())
+    return T();
+  std::sort(v.begin(), v.end());
+  size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * v.size()));
+  return v[rank ? rank - 1 : 0];
+}
+
+// While alive and active, sends std::cout to stderr, so that a report
+// written to stdout_buf() is all that reaches stdout.
+class stdout_for_report
+{
+public:
+  explicit stdout_for_report(bool active)
+    : stdout_(std::cout.rdbuf())
+    , active_(active)
+  {
+    if (active_)
+      std::cout.rdbuf(std::cerr.rdbuf());
+  }
+
+  ~stdout_for_report()
+  {
+    if (active_)
+      std::cout.rdbuf(stdout_);
+  }
+
+  std::streambuf *stdout_buf() const { return stdout_; }
+
+private:
+  std::streambuf *stdout_;
+  bool active_;
+};
+
+// Write s as a JSON string, quoted and escaped
+inline void write_json_string(std::ostream &os, const std::string &s)
+{
+  static const char hex[] = "0123456789abcdef";
+
+  os << '"';
+  for (unsigned char c : s) {
+    switch (c) {
+    case '"':  os << "\\\""; break;
+    case '\\': os << "\\\\"; break;
+    case '\n': os << "\\n"; break;
+    case '\r': os << "\\r"; break;
+    case '\t': os << "\\t"; break;
+    default:
+      if (c < 0x20)
+        os << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+      else
+        os << c;
+    }
+  }
+  os << '"';
+}
+
+// Write s as a CSV field, quoted when it holds a separator or quote
+inline void write_csv_field(std::ostream &os, const std::string &s)
+{
+  if (s.find_first_of(",\"\r\n") == std::string::npos) {
+    os << s;
+    return;
+  }
+
+  os << '"';
+  for (char c : s) {
+    if (c == '"')
+      os << '"';
+    os << c;
+  }
+  os << '"';
+}
+
+// Write sweep results as a JSON document
+inline void write_json(std::ostream &os, const std::string &afu,
+                       uint32_t api_version, uint32_t clock_mhz,
+                       const std::vector<sweep_point> &points)
+{
+  os << "{\n"
+     << "  \"afu\": ";
+  write_json_string(os, afu);
+  os << ",\n"
+     << "  \"api_version\": " << api_version << ",\n"
+     << "  \"clock_mhz\": " << clock_mhz << ",\n"
+     << "  \"results\": [";
+
+  for (size_t i = 0; i < points.size(); ++i) {
+    const sweep_point &p = points[i];
+    os << (i ? ",\n" : "\n")
+       << "    {\"mode\": ";
+    write_json_string(os, p.mode);
+    os << ", \"cls\": ";
+    write_json_string(os, p.cls);
+    os << ", \"size_kb\": " << p.size_kb
+       << ", \"numa_node\": " << p.numa_node
+       << ", \"repeat\": " << p.ticks.size() + p.failed
+       << ", \"failed\": " << p.failed
+       << ", \"reads\": " << p.reads
+       << ", \"writes\": " << p.writes
+       << ",\n     \"bandwidth_gbps\": {"
+       << "\"min\": " << percentile(p.bandwidth, 0)
+       << ", \"median\": " << percentile(p.bandwidth, 50)
+       << ", \"p99\": " << percentile(p.bandwidth, 99)
+       << ", \"max\": " << percentile(p.bandwidth, 100) << "}"
+       << ",\n     \"ticks\": {"
+       << "\"min\": " << percentile(p.ticks, 0)
+       << ", \"median\": " << percentile(p.ticks, 50)
+       << ", \"p99\": " << percentile(p.ticks, 99)
+       << ", \"max\": " << percentile(p.ticks, 100) << "}}";
+  }
+
+  os << "\n  ]\n}\n";
+}
+
+// Write sweep results as CSV, one row per point
+inline void write_csv(std::ostream &os, const std::vector<sweep_point> &points)
+{
+  os << "mode,cls,size_kb,numa_node,repeat,failed,reads,writes,"
+     << "bw_min_gbps,bw_median_gbps,bw_p99_gbps,bw_max_gbps,"
+     << "ticks_min,ticks_median,ticks_p99,ticks_max\n";
+
+  for (const sweep_point &p : points) {
+    write_csv_field(os, p.mode);
+    os << ",";
+    write_csv_field(os, p.cls);
+    os << "," << p.size_kb << ","
+       << p.numa_node << "," << p.ticks.size() + p.failed << ","
+       << p.failed << "," << p.reads << "," << p.writes << ","
+       << percentile(p.bandwidth, 0) << ","
+       << percentile(p.bandwidth, 50) << ","
+       << percentile(p.bandwidth, 99) << ","
+       << percentile(p.bandwidth, 100) << ","
+       << percentile(p.ticks, 0) << ","
+       << percentile(p.ticks, 50) << ","
+       << percentile(p.ticks, 99) << ","
+       << percentile(p.ticks, 100) << "\n";
+  }
+}
+
+} // end of namespace host_exerciser
@@ -35,6 +35,8 @@ namespace mem_tg {
 using opae::fpga::types::token;
 const char *AFU_ID  = "4DADEA34-2C78-48CB-A3DC-5B831F5CECBB";
 
+// How long tg_test waits for the channels, in microseconds per loop
+// and burst, and how long it sleeps between polls of MEM_TG_STAT.
 static const uint64_t MEM_TG_TEST_TIMEOUT = 30000;
 static const uint64_t TEST_SLEEP_INVL = 100;
 
@@ -181,6 +183,9 @@ public:
     app_.add_option("-f,--mem-frequency", mem_speed_, "Memory traffic clock frequency in MHz")
       ->default_val("0");
 
+    // JSON report
+    app_.add_option("--json", json_, "Write per-channel and aggregate results as JSON to this file ('-' is stdout)");
+
     // Add Address mode?
 
   }
@@ -188,6 +193,14 @@ public:
   virtual int run(CLI::App *app, test_command::ptr_t test) override
   {
     int res = exit_codes::not_run;
+
+    // Keep stdout for the JSON document when it is written there.
+    if (json_ == "-") {
+      logger_->sinks().clear();
+      logger_->sinks().push_back(
+        std::make_shared<spdlog::sinks::stderr_color_sink_mt>());
+    }
+
     logger_->info("starting test run, count of {0:d}", count_);
     uint32_t count = 0;
     try {
@@ -219,8 +232,7 @@ public:
   uint32_t stride_;
   uint32_t pattern_;
   uint32_t mem_speed_;
-  uint32_t status_;
-  uint64_t tg_offset_;
+  std::string json_;
 
   std::map<uint32_t, uint32_t> limits_;
 
@@ -239,27 +251,5 @@ public:
     return handle_->get_token();
   }
 
-  // Duplicate contents of this mem_tg to duplicate_obj.
-  // commands_, current_command_, app_ are ommited since they are not
-  // relevant to closed instances of mem_tg that don't interact with commands.
-  void duplicate(mem_tg *duplicate_obj) const {
-    duplicate_obj->count_        = this->count_;
-    duplicate_obj->loop_         = this->loop_;
-    duplicate_obj->wcnt_         = this->wcnt_;
-    duplicate_obj->rcnt_         = this->rcnt_;
-    duplicate_obj->bcnt_         = this->bcnt_;
-    duplicate_obj->stride_       = this->stride_;
-    duplicate_obj->pattern_      = this->pattern_;
-    duplicate_obj->mem_speed_    = this->mem_speed_;
-    duplicate_obj->name_         = this->name_;
-    duplicate_obj->afu_id_       = this->afu_id_;
-    duplicate_obj->pci_addr_     = this->pci_addr_;
-    duplicate_obj->log_level_    = this->log_level_;
-    duplicate_obj->shared_       = this->shared_;
-    duplicate_obj->timeout_msec_ = this->timeout_msec_;
-    duplicate_obj->handle_       = this->handle_;
-    duplicate_obj->logger_       = this->logger_;
-  }
-
 };
 } // end of namespace mem_tg
@@ -26,13 +26,12 @@
 #pragma once
 
 #include <unistd.h>
-#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <vector>
-#include <future>
 #include <string>
-#include <condition_variable> 
-#include <mutex>
 
 #include "afu_test.h"
 #include "mem_tg.h"
@@ -42,12 +41,15 @@ using opae::fpga::types::token;
 
 namespace mem_tg {
 
-// Shared static variables for synchornization
-std::mutex tg_print_mutex;
-std::mutex tg_start_write_mutex;
-std::condition_variable tg_cv;
-std::atomic<int> tg_waiting_threads_counter;
-int tg_num_threads = -1; // Written to once in run() then read-only
+// Result of one channel, filled in by the status poller
+struct tg_channel {
+  int channel;
+  uint64_t tg_offset;
+  uint32_t status;
+  uint64_t num_ticks;
+  uint64_t write_bytes;
+  uint64_t read_bytes;
+};
 
 class tg_test : public test_command
 {
@@ -77,142 +79,200 @@ public:
     // Convert number of transactions to bandwidth (GB/s)
     double bw_calc(uint64_t xfer_bytes, uint64_t num_ticks)
     {
+        if (!num_ticks)
+          return 0.0;
         return (double)(xfer_bytes) / ((1000.0 / (double)tg_exe_->mem_speed_ * (double)num_ticks));
     }
 
-    void tg_perf (mem_tg *tg_exe_) {
-      
-      // Lock mutex before printing so print statements don't collide between threads.
-      std::unique_lock<std::mutex> print_lock(tg_print_mutex);
-      std::cout << "Channel " << std::stoi(tg_exe_->mem_ch_[0]) << ":" << std::endl;
-
-      if (tg_exe_->status_ == TG_STATUS_TIMEOUT) {
-        std::cout << "TG TIMEOUT" << std::endl;
-      } else if (tg_exe_->status_ == (uint32_t)(-1)) {
-	std::cout << "Error: Timed out in TG_STATUS_ACTIVE state. Consider increasing MEM_TG_TEST_TIMEOUT." << std::endl; 
-      } else if (tg_exe_->status_ == TG_STATUS_ERROR) {
+    static const char *status_str(uint32_t status)
+    {
+      switch (status) {
+      case TG_STATUS_ACTIVE:  return "active";
+      case TG_STATUS_TIMEOUT: return "timeout";
+      case TG_STATUS_ERROR:   return "error";
+      case TG_STATUS_PASS:    return "pass";
+      default:                return "poll timeout";
+      }
+    }
+
+    // With --json -, stdout carries only the JSON document, so the
+    // human-readable report goes to stderr instead.
+    std::ostream &report() const
+    {
+      return tg_exe_->json_ == "-" ? std::cerr : std::cout;
+    }
+
+    void tg_perf(const tg_channel &ch)
+    {
+      std::ostream &out = report();
+
+      out << "Channel " << ch.channel << ":" << std::endl;
+
+      if (ch.status == TG_STATUS_TIMEOUT) {
+        out << "TG TIMEOUT" << std::endl;
+      } else if (ch.status == (uint32_t)(-1)) {
+        out << "Error: Timed out in TG_STATUS_ACTIVE state. Consider increasing MEM_TG_TEST_TIMEOUT." << std::endl;
+      } else if (ch.status == TG_STATUS_ERROR) {
         uint32_t tg_fail_exp;
         uint32_t tg_fail_act;
         uint64_t tg_fail_addr;
-        std::cout << "TG ERROR" << std::endl;
-        tg_fail_addr = tg_exe_->read64(tg_exe_->tg_offset_ + TG_FIRST_FAIL_ADDR_L);
-        tg_fail_exp  = tg_exe_->read64(tg_exe_->tg_offset_ + TG_FAIL_EXPECTED_DATA);
-        tg_fail_act  = tg_exe_->read64(tg_exe_->tg_offset_ + TG_FAIL_READ_DATA);
-        std::cout << "Failed at address 0x" << std::hex << tg_fail_addr << " exp=0x" << tg_fail_exp << " act=0x" << tg_fail_act << std::endl;
+        out << "TG ERROR" << std::endl;
+        tg_fail_addr = tg_exe_->read64(ch.tg_offset + TG_FIRST_FAIL_ADDR_L);
+        tg_fail_exp  = tg_exe_->read64(ch.tg_offset + TG_FAIL_EXPECTED_DATA);
+        tg_fail_act  = tg_exe_->read64(ch.tg_offset + TG_FAIL_READ_DATA);
+        out << "Failed at address 0x" << std::hex << tg_fail_addr << " exp=0x" << tg_fail_exp << " act=0x" << tg_fail_act << std::endl;
       } else {
-        std::cout << "TG PASS" << std::endl;
+        out << "TG PASS" << std::endl;
       }
 
-      uint32_t mem_ch_offset = (std::stoi(tg_exe_->mem_ch_[0])) << 0x3;
-      uint64_t num_ticks = tg_exe_->read64(MEM_TG_CLOCKS + mem_ch_offset);
-      std::cout << "Mem Clock Cycles: " << std::dec << num_ticks << std::endl;
-	
-      std::cout << "DEBUG: wcnt_ " << std::dec << tg_exe_->wcnt_ << std::endl;
-      std::cout << "DEBUG: rcnt_ " << std::dec << tg_exe_->rcnt_ << std::endl;
-      std::cout << "DEBUG: bcnt_ " << std::dec << tg_exe_->bcnt_ << std::endl;
-      std::cout << "DEBUG: loop_ " << std::dec << tg_exe_->loop_ << std::endl;
-      std::cout << "DEBUG: num_ticks " << std::dec << num_ticks << std::endl;
-
-      uint64_t write_bytes = 64 * (tg_exe_->loop_*tg_exe_->wcnt_*tg_exe_->bcnt_);
-      uint64_t read_bytes  = 64 * (tg_exe_->loop_*tg_exe_->rcnt_*tg_exe_->bcnt_);
-      std::cout << "Write BW: " << bw_calc(write_bytes,num_ticks) << " GB/s" << std::endl;
-      std::cout << "Read BW: "  << bw_calc(read_bytes,num_ticks)  << " GB/s\n" << std::endl;
-
-      print_lock.unlock();
+      out << "Mem Clock Cycles: " << std::dec << ch.num_ticks << std::endl;
+      out << "Write BW: " << bw_calc(ch.write_bytes, ch.num_ticks) << " GB/s" << std::endl;
+      out << "Read BW: "  << bw_calc(ch.read_bytes, ch.num_ticks)  << " GB/s\n" << std::endl;
     }
-  
-    bool tg_wait_test_completion (mem_tg *tg_exe_)
+
+    // Poll MEM_TG_STAT for every channel at once until none is active
+    // (channel status nibble = {pass,fail,timeout,active}). Channels
+    // still active when the deadline passes get status -1.
+    bool tg_wait_test_completion(std::vector<tg_channel> &channels)
     {
-        /* Wait for test completion */
-        uint32_t timeout = MEM_TG_TEST_TIMEOUT * tg_exe_->loop_ * tg_exe_->bcnt_;
-        // poll while active bit is set (channel status = {pass,fail,timeout,active})
-        uint32_t tg_status = 0x1;
-        tg_status = 0xF & (tg_exe_->read64(MEM_TG_STAT) >> (0x4*(std::stoi(tg_exe_->mem_ch_[0]))));
-        while (tg_status == TG_STATUS_ACTIVE) {
-          tg_status = 0xF & (tg_exe_->read64(MEM_TG_STAT) >> (0x4*(std::stoi(tg_exe_->mem_ch_[0]))));
-          std::this_thread::yield();
-          if (--timeout == 0) {
-            tg_exe_->status_ = -1;
-            std::cout << "DEBUG: timeout error" << std::endl;
-	    return false;
+        using clock = std::chrono::steady_clock;
+        auto deadline = clock::now() + std::chrono::microseconds(
+          MEM_TG_TEST_TIMEOUT * tg_exe_->loop_ * tg_exe_->bcnt_);
+        size_t active = channels.size();
+
+        for (auto &ch : channels)
+          ch.status = TG_STATUS_ACTIVE;
+
+        while (active) {
+          uint64_t tg_stat = tg_exe_->read64(MEM_TG_STAT);
+
+          for (auto &ch : channels) {
+            if (ch.status != TG_STATUS_ACTIVE)
+              continue;
+            uint32_t tg_status = 0xF & (tg_stat >> (0x4 * ch.channel));
+            if (tg_status != TG_STATUS_ACTIVE) {
+              ch.status = tg_status;
+              --active;
+            }
           }
-        }
-      	if (tg_status == TG_STATUS_TIMEOUT) {
-          tg_exe_->status_ = tg_status;
-	  std::cout << "DEBUG: status timeout" << std::endl;
-          return false;
+
+          if (!active)
+            break;
+
+          if (clock::now() >= deadline) {
+            for (auto &ch : channels) {
+              if (ch.status == TG_STATUS_ACTIVE)
+                ch.status = -1;
+            }
+            return false;
+          }
+          usleep(TEST_SLEEP_INVL);
         }
 
-        if (tg_status == TG_STATUS_ERROR) {
-          tg_exe_->status_ = tg_status;
-	  std::cout << "DEBUG: status error" << std::endl;
-          return false;
+        for (auto &ch : channels) {
+          if (ch.status != TG_STATUS_PASS)
+            return false;
         }
-        tg_exe_->status_ = tg_status;
         return true;
     }
 
-    int config_input_options(mem_tg *tg_exe_)
+    int config_input_options(tg_channel &ch)
     {
-        if (!tg_exe_)
-          return -1;
         uint64_t mem_capability = tg_exe_->read64(MEM_TG_CTRL);
-    	if ((mem_capability & (0x1 << std::stoi(tg_exe_->mem_ch_[0]))) == 0) { 
-          std::cerr << "No traffic generator for mem[" << std::stoi(tg_exe_->mem_ch_[0]) << "]" << std::endl;
+        if ((mem_capability & (0x1ULL << ch.channel)) == 0) {
+          std::cerr << "No traffic generator for mem[" << ch.channel << "]" << std::endl;
           return -1;
         }
 
-        tg_exe_->tg_offset_ = AFU_DFH + (MEM_TG_CFG_OFFSET * (1+std::stoi(tg_exe_->mem_ch_[0])));
+        ch.tg_offset = AFU_DFH + (MEM_TG_CFG_OFFSET * (1 + ch.channel));
 
-        tg_exe_->write32(tg_exe_->tg_offset_+TG_LOOP_COUNT,  tg_exe_->loop_);
-        tg_exe_->write32(tg_exe_->tg_offset_+TG_WRITE_COUNT, tg_exe_->wcnt_);
-        tg_exe_->write32(tg_exe_->tg_offset_+TG_READ_COUNT,  tg_exe_->rcnt_);
-        tg_exe_->write32(tg_exe_->tg_offset_+TG_BURST_LENGTH, tg_exe_->bcnt_);
-        tg_exe_->write32(tg_exe_->tg_offset_+TG_SEQ_ADDR_INCR, tg_exe_->stride_);
-        tg_exe_->write32(tg_exe_->tg_offset_+TG_PPPG_SEL, tg_exe_->pattern_);
+        tg_exe_->write32(ch.tg_offset+TG_LOOP_COUNT,  tg_exe_->loop_);
+        tg_exe_->write32(ch.tg_offset+TG_WRITE_COUNT, tg_exe_->wcnt_);
+        tg_exe_->write32(ch.tg_offset+TG_READ_COUNT,  tg_exe_->rcnt_);
+        tg_exe_->write32(ch.tg_offset+TG_BURST_LENGTH, tg_exe_->bcnt_);
+        tg_exe_->write32(ch.tg_offset+TG_SEQ_ADDR_INCR, tg_exe_->stride_);
+        tg_exe_->write32(ch.tg_offset+TG_PPPG_SEL, tg_exe_->pattern_);
 
         // address increment mode
-        tg_exe_->write32(tg_exe_->tg_offset_+TG_ADDR_MODE_WR, TG_ADDR_SEQ);
-        tg_exe_->write32(tg_exe_->tg_offset_+TG_ADDR_MODE_RD, TG_ADDR_SEQ);
+        tg_exe_->write32(ch.tg_offset+TG_ADDR_MODE_WR, TG_ADDR_SEQ);
+        tg_exe_->write32(ch.tg_offset+TG_ADDR_MODE_RD, TG_ADDR_SEQ);
+
+        ch.write_bytes = 64ULL * tg_exe_->loop_ * tg_exe_->wcnt_ * tg_exe_->bcnt_;
+        ch.read_bytes  = 64ULL * tg_exe_->loop_ * tg_exe_->rcnt_ * tg_exe_->bcnt_;
         return 0;
     }
 
-    // The test state has been configured. Run one test instance.
-    int run_mem_test(mem_tg *tg_exe_)
+    // The channels have been configured. Start them all and wait for
+    // them to finish.
+    int run_mem_test(std::vector<tg_channel> &channels)
     {
       int status = 0;
-	
-      // All threads do their set up and wait here for other threads so start write happens all at once
-      std::unique_lock<std::mutex> lock(tg_start_write_mutex);
-      tg_waiting_threads_counter++;
-      if(tg_waiting_threads_counter == tg_num_threads) {
-        tg_cv.notify_all(); 
-      } else {
-        tg_cv.wait(lock, [&](){ return tg_waiting_threads_counter == tg_num_threads; });
-      }
-      lock.unlock();
 
-      // write32 is not thread safe so we wrap it in a lock
-      lock.lock();
+      // There is no common start bit, so start the channels with
+      // back-to-back writes from this thread to keep the skew between
+      // them to a few MMIO writes.
       tg_exe_->logger_->debug("Start Test");
-      tg_exe_->write32(tg_exe_->tg_offset_ + TG_START, 0x1);
-      lock.unlock();
+      for (auto &ch : channels)
+        tg_exe_->write32(ch.tg_offset + TG_START, 0x1);
 
-      if (!tg_wait_test_completion(tg_exe_))
+      if (!tg_wait_test_completion(channels))
         status = -1;
 
-      tg_perf(tg_exe_);
+      for (auto &ch : channels) {
+        uint32_t mem_ch_offset = ch.channel << 0x3;
+        ch.num_ticks = tg_exe_->read64(MEM_TG_CLOCKS + mem_ch_offset);
+        tg_perf(ch);
+      }
 
       return status;
     }
 
-    int run_thread_single_channel(mem_tg *tg_exe_) {
-      auto ret = config_input_options(tg_exe_);
-      if (ret != 0) {
-        std::cerr << "Failed to configure TG input options" << std::endl;
-        return ret;
+    // The channels run concurrently, so the card's bandwidth is the
+    // total traffic over the time taken by the slowest channel.
+    void tg_aggregate(const std::vector<tg_channel> &channels,
+                      uint64_t &write_bytes, uint64_t &read_bytes,
+                      uint64_t &num_ticks)
+    {
+      write_bytes = 0;
+      read_bytes = 0;
+      num_ticks = 0;
+      for (auto &ch : channels) {
+        write_bytes += ch.write_bytes;
+        read_bytes += ch.read_bytes;
+        num_ticks = std::max(num_ticks, ch.num_ticks);
       }
-      return run_mem_test(tg_exe_);
+    }
+
+    void tg_json(std::ostream &os, const std::vector<tg_channel> &channels)
+    {
+      uint64_t write_bytes, read_bytes, num_ticks;
+      tg_aggregate(channels, write_bytes, read_bytes, num_ticks);
+
+      os << "{\n"
+         << "  \"mem_frequency_mhz\": " << tg_exe_->mem_speed_ << ",\n"
+         << "  \"loops\": " << tg_exe_->loop_ << ",\n"
+         << "  \"writes\": " << tg_exe_->wcnt_ << ",\n"
+         << "  \"reads\": " << tg_exe_->rcnt_ << ",\n"
+         << "  \"burst_length\": " << tg_exe_->bcnt_ << ",\n"
+         << "  \"channels\": [";
+      for (size_t i = 0; i < channels.size(); ++i) {
+        const tg_channel &ch = channels[i];
+        os << (i ? ",\n" : "\n")
+           << "    {\"channel\": " << ch.channel
+           << ", \"status\": \"" << status_str(ch.status) << "\""
+           << ", \"clocks\": " << ch.num_ticks
+           << ", \"write_bytes\": " << ch.write_bytes
+           << ", \"read_bytes\": " << ch.read_bytes
+           << ", \"write_gbps\": " << bw_calc(ch.write_bytes, ch.num_ticks)
+           << ", \"read_gbps\": " << bw_calc(ch.read_bytes, ch.num_ticks)
+           << "}";
+      }
+      os << "\n  ],\n"
+         << "  \"aggregate\": {\"clocks\": " << num_ticks
+         << ", \"write_gbps\": " << bw_calc(write_bytes, num_ticks)
+         << ", \"read_gbps\": " << bw_calc(read_bytes, num_ticks)
+         << ", \"total_gbps\": " << bw_calc(write_bytes + read_bytes, num_ticks)
+         << "}\n}\n";
     }
 
     virtual int run(test_afu *afu, CLI::App *app) override
@@ -227,85 +287,72 @@ public:
 
       if (0 == tg_exe_->mem_speed_) {
         tg_exe_->mem_speed_ = 300;
-        std::cout << "Memory channel clock frequency unknown. Assuming "
+        report() << "Memory channel clock frequency unknown. Assuming "
           << tg_exe_->mem_speed_ << " MHz." << std::endl;
       } else {
-        std::cout << "Memory clock from command line: "
+        report() << "Memory clock from command line: "
           << tg_exe_->mem_speed_ << " MHz" << std::endl;
       }
 
       if (0 >= (tg_exe_->mem_ch_).size()) {
-        std::cout << "Insufficient arguments provided" << std::endl;
+        report() << "Insufficient arguments provided" << std::endl;
         exit(1);
       }
 
-      // Parse mem_ch_ into array of selected channels and number of channels
-      int *channels = NULL;
-      int num_channels = 0;
-      if ((tg_exe_->mem_ch_[0]).find("all") == 0) {	
+      // Parse mem_ch_ into the selected channels. MEM_TG_STAT has a
+      // 4-bit status per channel, so there are at most 16.
+      std::vector<tg_channel> channels;
+      if ((tg_exe_->mem_ch_[0]).find("all") == 0) {
         uint64_t mem_capability = tg_exe_->read64(MEM_TG_CTRL);
-        channels = new int[sizeof(uint64_t)]; // size should be same as mem_capability 
-        for (uint32_t i = 0; i < sizeof(uint64_t); i++) { // number of iterations should be same as mem_capability 
-          if ((mem_capability & (1ULL << i)) != 0) {
-            channels[num_channels] = i;
-            num_channels += 1;
-          }
+        for (int i = 0; i < 16; i++) {
+          if ((mem_capability & (1ULL << i)) != 0)
+            channels.push_back(tg_channel{i, 0, 0, 0, 0, 0});
         }
-        channels[num_channels] = -1; // EOL
       } else {
-        channels = new int[tg_exe_->mem_ch_.size()];
-        num_channels = tg_exe_->mem_ch_.size();
-        try{
-          for (unsigned i = 0; i < tg_exe_->mem_ch_.size(); i++) {
-            channels[i] = std::stoi(tg_exe_->mem_ch_[i]);
+        try {
+          for (auto &ch : tg_exe_->mem_ch_) {
+            int i = std::stoi(ch);
+            if (i < 0 || i >= 16)
+              throw std::invalid_argument(ch);
+            channels.push_back(tg_channel{i, 0, 0, 0, 0, 0});
           }
-        } catch (std::invalid_argument &e) {
-          std::cerr << "Error: invalid argument to std::stoi";
-          delete[] channels;
+        } catch (std::exception &e) {
+          std::cerr << "Error: invalid memory channel" << std::endl;
           return 1;
         }
       }
-      
-      // Spawn threads for each channel:
-      mem_tg *thread_tg_exe_objects[num_channels];
-      std::vector<std::future<int>> futures;
-      std::vector<std::promise<int>> promises(num_channels);
-      std::vector<std::thread> threads;
-      tg_num_threads = num_channels;
-      tg_waiting_threads_counter = 0;
-      for (int i = 0; i < num_channels; i++) { 
-        if (channels[i] == -1) break;
-        thread_tg_exe_objects[i] = new mem_tg;
-        tg_exe_->duplicate(thread_tg_exe_objects[i]);
-        thread_tg_exe_objects[i]->mem_ch_.clear();
-        thread_tg_exe_objects[i]->mem_ch_.push_back(std::to_string(channels[i]));
-        futures.push_back(promises[i].get_future());
-        threads.emplace_back([&, i] { 
-          promises[i].set_value(run_thread_single_channel(thread_tg_exe_objects[i])); 
-        });
-      }
 
-      // Wait for all threads to exit then collect their exit statuses
-      for (auto &thread : threads) {
-        thread.join();
-      }
-      
-      std::vector<int> exit_codes;
-      for (auto &future : futures) {
-        exit_codes.push_back(future.get());
+      for (auto &ch : channels) {
+        if (config_input_options(ch)) {
+          std::cerr << "Failed to configure TG input options" << std::endl;
+          return -1;
+        }
       }
 
-      // Print message showing thread statuses
-      for (int i = 0; i < num_channels; i++) {
-        std::cout << "Thread on channel " << channels[i] << " exited with status " << (long)exit_codes[i] << std::endl;
+      int status = run_mem_test(channels);
+
+      uint64_t write_bytes, read_bytes, num_ticks;
+      tg_aggregate(channels, write_bytes, read_bytes, num_ticks);
+      report() << "Aggregate (" << channels.size() << " channels): "
+               << "Write BW: " << bw_calc(write_bytes, num_ticks) << " GB/s, "
+               << "Read BW: " << bw_calc(read_bytes, num_ticks) << " GB/s, "
+               << "Total BW: " << bw_calc(write_bytes + read_bytes, num_ticks) << " GB/s"
+               << std::endl;
+
+      if (!tg_exe_->json_.empty()) {
+        if (tg_exe_->json_ == "-") {
+          tg_json(std::cout, channels);
+        } else {
+          std::ofstream file(tg_exe_->json_);
+          if (!file.is_open()) {
+            std::cerr << "Failed to open " << tg_exe_->json_ << std::endl;
+            return -1;
+          }
+          tg_json(file, channels);
+        }
       }
 
-      // Delete dynamic allocations 
-      delete[] channels;
-      for (int i = 0; i < num_channels; i++) {
-        delete thread_tg_exe_objects[i];
-      }
-      return 0;
+      return status;
     }
 
 protected:
@@ -315,4 +362,3 @@ protected:
 };
 
 } // end of namespace mem_tg
-
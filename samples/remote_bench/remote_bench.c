@@ -0,0 +1,533 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file remote_bench.c
+ * @brief Measures the cost of OPAE calls against a host exerciser
+ * loopback (he_lpbk) AFU.
+ *
+ * The sample is meant for comparing ways of reaching a device: run
+ * it once against a local card, and once through libopae-remote and
+ * fpgaremoted, to see what the remote link adds. With no card at
+ * hand, the he_lpbk AFU of libopae-sim stands in for one; see the
+ * "Remote Devices" section of the plugin developer's guide. The
+ * loopback test polls a status word in buffer memory, so with
+ * copy-mode buffers (over TCP, or with "shm" false) it needs a
+ * nonzero "sync_usec" in the plugin configuration.
+ *
+ * It reports:
+ *
+ *  - MMIO read latency (fpgaReadMMIO64())
+ *  - MMIO write rate (fpgaWriteMMIO64(), which the remote plugin posts)
+ *  - batched MMIO read rate (fpgaReadMMIOBatch())
+ *  - loopback throughput, copying a buffer to another with the AFU
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <getopt.h>
+#include <time.h>
+
+#include <uuid/uuid.h>
+#include <opae/fpga.h>
+#include <argsfilter.h>
+#include "mock/opae_std.h"
+
+#define HE_LPBK_AFUID "56e203e9-864f-49a7-b94b-12284c31e02b"
+
+#define CL(x)              ((x) * 64)
+
+#define HE_DSM_BASEL       0x0110
+#define HE_DSM_BASEH       0x0114
+#define HE_SRC_ADDR        0x0120
+#define HE_DST_ADDR        0x0128
+#define HE_NUM_LINES       0x0130
+#define HE_CTL             0x0138
+#define HE_CFG             0x0140
+#define HE_INFO0           0x0180
+
+#define CTL_RESET_L        0x1
+#define CTL_START          0x2
+
+#define DSM_SIZE           4096
+#define LPBK_TIMEOUT_USEC  (10 * 1000 * 1000)
+
+#define ON_ERR_GOTO(res, label, desc)              \
+	do {                                       \
+		if ((res) != FPGA_OK) {            \
+			print_err((desc), (res));  \
+			goto label;                \
+		}                                  \
+	} while (0)
+
+void print_err(const char *s, fpga_result res)
+{
+	fprintf(stderr, "Error %s: %s\n", s, fpgaErrStr(res));
+}
+
+struct config {
+	int open_flags;
+	uint32_t iterations;
+	uint32_t batch;
+	uint32_t lines;
+	uint32_t loops;
+}
+
+config = {
+	.open_flags = 0,
+	.iterations = 10000,
+	.batch = 64,
+	.lines = 16384,
+	.loops = 100
+};
+
+void help(void)
+{
+	printf("\n"
+	       "remote_bench\n"
+	       "OPAE call latency and throughput, measured with he_lpbk\n"
+	       "\n"
+	       "Usage:\n"
+	       "        remote_bench [-hsv] [-i <n>] [-b <n>] [-l <n>] [-n <n>] [PCI_ADDR]\n"
+	       "\n"
+	       "                -s,--shared         Open accelerator in shared mode\n"
+	       "                -i,--iterations     MMIO accesses per test [%u]\n"
+	       "                -b,--batch          MMIO reads per fpgaReadMMIOBatch() [%u]\n"
+	       "                -l,--lines          Cache lines per loopback copy [%u]\n"
+	       "                -n,--loops          Loopback copies [%u]\n"
+	       "                -h,--help           Print this help\n"
+	       "                -v,--version        Print version info and exit\n"
+	       "\n",
+	       config.iterations, config.batch, config.lines, config.loops);
+}
+
+static int parse_u32(const char *s, uint32_t *v)
+{
+	char *endptr = NULL;
+	unsigned long n;
+
+	n = strtoul(s, &endptr, 0);
+	if (!endptr || *endptr || !n || n > UINT32_MAX)
+		return 1;
+
+	*v = (uint32_t)n;
+	return 0;
+}
+
+#define GETOPT_STRING "hsi:b:l:n:v"
+fpga_result parse_args(int argc, char *argv[])
+{
+	struct option longopts[] = {
+		{ "help",       no_argument,       NULL, 'h' },
+		{ "shared",     no_argument,       NULL, 's' },
+		{ "iterations", required_argument, NULL, 'i' },
+		{ "batch",      required_argument, NULL, 'b' },
+		{ "lines",      required_argument, NULL, 'l' },
+		{ "loops",      required_argument, NULL, 'n' },
+		{ "version",    no_argument,       NULL, 'v' },
+		{ NULL,         0,                 NULL,  0  }
+	};
+
+	int getopt_ret;
+	int option_index;
+	uint32_t *target;
+
+	char version[32];
+	char build[32];
+
+	while (-1 != (getopt_ret = getopt_long(argc, argv, GETOPT_STRING,
+						longopts, &option_index))) {
+		const char *tmp_optarg = optarg;
+
+		if ((optarg) && ('=' == *tmp_optarg)) {
+			++tmp_optarg;
+		}
+
+		switch (getopt_ret) {
+		case 'h':
+			help();
+			return -1;
+		case 's':
+			config.open_flags |= FPGA_OPEN_SHARED;
+			break;
+		case 'i':
+		case 'b':
+		case 'l':
+		case 'n':
+			target = getopt_ret == 'i' ? &config.iterations :
+				 getopt_ret == 'b' ? &config.batch :
+				 getopt_ret == 'l' ? &config.lines :
+				 &config.loops;
+			if (parse_u32(tmp_optarg, target)) {
+				fprintf(stderr, "invalid count: %s\n",
+					tmp_optarg);
+				return FPGA_INVALID_PARAM;
+			}
+			break;
+		case 'v':
+			fpgaGetOPAECVersionString(version, sizeof(version));
+			fpgaGetOPAECBuildString(build, sizeof(build));
+			printf("remote_bench %s %s\n",
+			       version, build);
+			return -1;
+
+		default: /* invalid option */
+			fprintf(stderr, "Invalid cmdline option \n");
+			return FPGA_EXCEPTION;
+		}
+	}
+
+	return FPGA_OK;
+}
+
+static uint64_t now_nsec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+fpga_result bench_read_latency(fpga_handle h)
+{
+	fpga_result res = FPGA_OK;
+	uint64_t *samples;
+	uint64_t total = 0;
+	uint64_t value;
+	uint32_t n = config.iterations;
+	uint32_t i;
+
+	samples = opae_calloc(n, sizeof(uint64_t));
+	if (!samples)
+		return FPGA_NO_MEMORY;
+
+	for (i = 0 ; i < n ; ++i) {
+		uint64_t start = now_nsec();
+
+		res = fpgaReadMMIO64(h, 0, HE_INFO0, &value);
+		samples[i] = now_nsec() - start;
+		ON_ERR_GOTO(res, out_free, "reading HE_INFO0");
+		total += samples[i];
+	}
+
+	qsort(samples, n, sizeof(uint64_t), cmp_u64);
+
+	printf("MMIO read64:     min %8.2f  avg %8.2f  p50 %8.2f  p99 %8.2f usec\n",
+	       samples[0] / 1000.0, total / 1000.0 / n,
+	       samples[n / 2] / 1000.0,
+	       samples[(uint64_t)n * 99 / 100] / 1000.0);
+
+out_free:
+	opae_free(samples);
+	return res;
+}
+
+fpga_result bench_write_rate(fpga_handle h)
+{
+	fpga_result res = FPGA_OK;
+	uint64_t start;
+	uint64_t elapsed;
+	uint64_t value;
+	uint32_t i;
+
+	start = now_nsec();
+
+	for (i = 0 ; i < config.iterations ; ++i) {
+		res = fpgaWriteMMIO64(h, 0, HE_CFG, 0);
+		ON_ERR_GOTO(res, out, "writing HE_CFG");
+	}
+
+	// Writes may be posted: a read waits for all of them to land.
+	res = fpgaReadMMIO64(h, 0, HE_CFG, &value);
+	ON_ERR_GOTO(res, out, "reading HE_CFG");
+
+	elapsed = now_nsec() - start;
+
+	printf("MMIO write64:    %10.0f writes/sec  (%.2f usec each)\n",
+	       config.iterations * 1e9 / elapsed,
+	       elapsed / 1000.0 / config.iterations);
+
+out:
+	return res;
+}
+
+fpga_result bench_batch_rate(fpga_handle h)
+{
+	fpga_result res = FPGA_OK;
+	fpga_mmio_op *ops;
+	uint64_t start;
+	uint64_t elapsed;
+	uint32_t batches;
+	uint32_t i;
+
+	ops = opae_calloc(config.batch, sizeof(fpga_mmio_op));
+	if (!ops)
+		return FPGA_NO_MEMORY;
+
+	for (i = 0 ; i < config.batch ; ++i) {
+		ops[i].mmio_num = 0;
+		ops[i].width = 64;
+		ops[i].offset = HE_INFO0;
+	}
+
+	batches = (config.iterations + config.batch - 1) / config.batch;
+
+	start = now_nsec();
+
+	for (i = 0 ; i < batches ; ++i) {
+		res = fpgaReadMMIOBatch(h, ops, config.batch);
+		ON_ERR_GOTO(res, out_free, "batch reading HE_INFO0");
+	}
+
+	elapsed = now_nsec() - start;
+
+	printf("MMIO read batch: %10.0f reads/sec   (%.2f usec per batch of %u)\n",
+	       (double)batches * config.batch * 1e9 / elapsed,
+	       elapsed / 1000.0 / batches, config.batch);
+
+out_free:
+	opae_free(ops);
+	return res;
+}
+
+static fpga_result prepare(fpga_handle h, uint64_t len,
+			   volatile uint64_t **virt, uint64_t *wsid,
+			   uint64_t *iova)
+{
+	fpga_result res;
+
+	res = fpgaPrepareBuffer(h, len, (void **)virt, wsid, 0);
+	if (res != FPGA_OK)
+		return res;
+
+	return fpgaGetIOAddress(h, *wsid, iova);
+}
+
+/*
+ * Copy lines of src to dst with the AFU, loops times. Each copy is
+ * complete once the AFU sets bit 0 of the first DSM word. A remote
+ * plugin that mirrors buffers may deliver the DSM before the data,
+ * so a register read separates the two before dst is checked.
+ */
+fpga_result bench_loopback(fpga_handle h)
+{
+	volatile uint64_t *dsm = NULL;
+	volatile uint64_t *src = NULL;
+	volatile uint64_t *dst = NULL;
+	uint64_t dsm_wsid = 0;
+	uint64_t src_wsid = 0;
+	uint64_t dst_wsid = 0;
+	uint64_t dsm_iova = 0;
+	uint64_t src_iova = 0;
+	uint64_t dst_iova = 0;
+	uint64_t len = CL((uint64_t)config.lines);
+	uint64_t start;
+	uint64_t elapsed;
+	uint64_t value;
+	fpga_result res;
+	fpga_result res2;
+	uint32_t i;
+	uint64_t j;
+
+	res = prepare(h, DSM_SIZE, &dsm, &dsm_wsid, &dsm_iova);
+	ON_ERR_GOTO(res, out, "allocating DSM buffer");
+	res = prepare(h, len, &src, &src_wsid, &src_iova);
+	ON_ERR_GOTO(res, out_free_dsm, "allocating source buffer");
+	res = prepare(h, len, &dst, &dst_wsid, &dst_iova);
+	ON_ERR_GOTO(res, out_free_src, "allocating destination buffer");
+
+	for (j = 0 ; j < len / sizeof(uint64_t) ; ++j) {
+		src[j] = j * 0x0101010101010101ULL;
+		dst[j] = 0;
+	}
+
+	// Reset the AFU, then program the addresses and copy length.
+	res = fpgaWriteMMIO32(h, 0, HE_CTL, 0);
+	ON_ERR_GOTO(res, out_free_dst, "writing HE_CTL");
+	res = fpgaWriteMMIO32(h, 0, HE_CTL, CTL_RESET_L);
+	ON_ERR_GOTO(res, out_free_dst, "writing HE_CTL");
+	res = fpgaWriteMMIO32(h, 0, HE_DSM_BASEL,
+			      (uint32_t)(dsm_iova / CL(1)));
+	ON_ERR_GOTO(res, out_free_dst, "writing HE_DSM_BASEL");
+	res = fpgaWriteMMIO32(h, 0, HE_DSM_BASEH,
+			      (uint32_t)((dsm_iova / CL(1)) >> 32));
+	ON_ERR_GOTO(res, out_free_dst, "writing HE_DSM_BASEH");
+	res = fpgaWriteMMIO64(h, 0, HE_SRC_ADDR, src_iova / CL(1));
+	ON_ERR_GOTO(res, out_free_dst, "writing HE_SRC_ADDR");
+	res = fpgaWriteMMIO64(h, 0, HE_DST_ADDR, dst_iova / CL(1));
+	ON_ERR_GOTO(res, out_free_dst, "writing HE_DST_ADDR");
+	res = fpgaWriteMMIO64(h, 0, HE_NUM_LINES, config.lines - 1);
+	ON_ERR_GOTO(res, out_free_dst, "writing HE_NUM_LINES");
+	res = fpgaWriteMMIO64(h, 0, HE_CFG, 0);
+	ON_ERR_GOTO(res, out_free_dst, "writing HE_CFG");
+
+	start = now_nsec();
+
+	for (i = 0 ; i < config.loops ; ++i) {
+		uint64_t deadline = now_nsec() + LPBK_TIMEOUT_USEC * 1000ULL;
+
+		dsm[0] = 0;
+
+		res = fpgaWriteMMIO32(h, 0, HE_CTL, CTL_RESET_L | CTL_START);
+		ON_ERR_GOTO(res, out_free_dst, "writing HE_CTL");
+
+		while (!(dsm[0] & 1)) {
+			if (now_nsec() > deadline) {
+				fprintf(stderr, "loopback timed out\n");
+				res = FPGA_EXCEPTION;
+				goto out_free_dst;
+			}
+		}
+	}
+
+	elapsed = now_nsec() - start;
+
+	res = fpgaReadMMIO64(h, 0, HE_INFO0, &value);
+	ON_ERR_GOTO(res, out_free_dst, "reading HE_INFO0");
+
+	if (dsm[0] >> 32) {
+		fprintf(stderr, "AFU reported an error\n");
+		res = FPGA_EXCEPTION;
+		goto out_free_dst;
+	}
+
+	for (j = 0 ; j < len / sizeof(uint64_t) ; ++j) {
+		if (dst[j] != src[j]) {
+			fprintf(stderr, "loopback mismatch at byte 0x%lx\n",
+				j * sizeof(uint64_t));
+			res = FPGA_EXCEPTION;
+			goto out_free_dst;
+		}
+	}
+
+	printf("Loopback:        %10.2f MB/sec     (%.2f usec per %lu byte copy)\n",
+	       (double)len * config.loops * 1e3 / elapsed,
+	       elapsed / 1000.0 / config.loops, len);
+
+out_free_dst:
+	res2 = fpgaReleaseBuffer(h, dst_wsid);
+	if (res == FPGA_OK)
+		res = res2;
+out_free_src:
+	res2 = fpgaReleaseBuffer(h, src_wsid);
+	if (res == FPGA_OK)
+		res = res2;
+out_free_dsm:
+	res2 = fpgaReleaseBuffer(h, dsm_wsid);
+	if (res == FPGA_OK)
+		res = res2;
+out:
+	return res;
+}
+
+int main(int argc, char *argv[])
+{
+	fpga_token         token = NULL;
+	fpga_handle        handle = NULL;
+	fpga_guid          guid;
+	uint32_t           num_matches = 0;
+	fpga_result        res1 = FPGA_OK;
+	fpga_result        res2 = FPGA_OK;
+	fpga_properties    filter = NULL;
+
+	res1 = fpgaGetProperties(NULL, &filter);
+	if (res1 != FPGA_OK) {
+		print_err("failed to allocate properties.\n", res1);
+		return 1;
+	}
+
+	if (opae_set_properties_from_args(filter,
+					  &res1,
+					  &argc,
+					  argv)) {
+		print_err("failed arg parse.\n", res1);
+		res1 = FPGA_EXCEPTION;
+		goto out_exit;
+	} else if (res1) {
+		print_err("failed to set properties.\n", res1);
+		goto out_exit;
+	}
+
+	res1 = parse_args(argc, argv);
+	if ((int)res1 < 0)
+		goto out_exit;
+	ON_ERR_GOTO(res1, out_exit, "parsing arguments");
+
+	if (uuid_parse(HE_LPBK_AFUID, guid) < 0) {
+		res1 = FPGA_EXCEPTION;
+		goto out_exit;
+	}
+
+	res1 = fpgaPropertiesSetObjectType(filter, FPGA_ACCELERATOR);
+	ON_ERR_GOTO(res1, out_exit, "setting object type");
+
+	res1 = fpgaPropertiesSetGUID(filter, guid);
+	ON_ERR_GOTO(res1, out_exit, "setting GUID");
+
+	res1 = fpgaEnumerate(&filter, 1, &token, 1, &num_matches);
+	ON_ERR_GOTO(res1, out_exit, "enumerating accelerators");
+
+	if (num_matches < 1) {
+		fprintf(stderr, "he_lpbk accelerator not found.\n");
+		res1 = FPGA_NOT_FOUND;
+		goto out_exit;
+	}
+
+	res1 = fpgaOpen(token, &handle, config.open_flags);
+	ON_ERR_GOTO(res1, out_destroy_tok, "opening accelerator");
+
+	res1 = bench_read_latency(handle);
+	if (res1 == FPGA_OK)
+		res1 = bench_write_rate(handle);
+	if (res1 == FPGA_OK)
+		res1 = bench_batch_rate(handle);
+	if (res1 == FPGA_OK)
+		res1 = bench_loopback(handle);
+
+	res2 = fpgaClose(handle);
+	ON_ERR_GOTO(res2, out_destroy_tok, "closing accelerator");
+
+out_destroy_tok:
+	res2 = fpgaDestroyToken(&token);
+	ON_ERR_GOTO(res2, out_exit, "destroying token");
+
+out_exit:
+	fpgaDestroyProperties(&filter);
+	return res1 != FPGA_OK ? res1 : res2;
+}
@@ -27,6 +27,8 @@
 #include <config.h>
 #endif // HAVE_CONFIG_H
 
+#include <fcntl.h>
+#include <sys/stat.h>
 #include "libbitstream/bitstream.h"
 
 extern "C" {
@@ -320,6 +322,91 @@ TEST_P(bitstream_c_p, load_ok0) {
   EXPECT_EQ(opae_unload_bitstream(&info), FPGA_OK);
 }
 
+/**
+ * @test       map_err0
+ * @brief      Test: opae_map_bitstream
+ * @details    When given a NULL parameter or a file that<br>
+ *             doesn't exist,<br>
+ *             the fn returns FPGA_INVALID_PARAM.<br>
+ */
+TEST_P(bitstream_c_p, map_err0) {
+  opae_bitstream_info info;
+  EXPECT_EQ(opae_map_bitstream(tmpnull_gbs_, nullptr), FPGA_INVALID_PARAM);
+  EXPECT_EQ(opae_map_bitstream(nullptr, &info), FPGA_INVALID_PARAM);
+  EXPECT_EQ(opae_map_bitstream("doesntexist", &info), FPGA_INVALID_PARAM);
+}
+
+/**
+ * @test       map_err1
+ * @brief      Test: opae_map_bitstream
+ * @details    When the file is empty or its GBS guid is invalid,<br>
+ *             the fn returns FPGA_INVALID_PARAM and leaves<br>
+ *             nothing mapped.<br>
+ */
+TEST_P(bitstream_c_p, map_err1) {
+  opae_bitstream_info info;
+
+  ASSERT_EQ(truncate(tmpnull_gbs_, 0), 0);
+  EXPECT_EQ(opae_map_bitstream(tmpnull_gbs_, &info), FPGA_INVALID_PARAM);
+
+  std::vector<uint8_t> bad(null_gbs_);
+  bad[0] ^= 0xff;
+  std::ofstream gbs;
+  gbs.open(tmpnull_gbs_, std::ios::out|std::ios::binary);
+  gbs.write((const char *) bad.data(), bad.size());
+  gbs.close();
+
+  EXPECT_EQ(opae_map_bitstream(tmpnull_gbs_, &info), FPGA_INVALID_PARAM);
+  EXPECT_EQ(info.data, nullptr);
+}
+
+/**
+ * @test       map_ok0
+ * @brief      Test: opae_map_bitstream, opae_unload_bitstream
+ * @details    When given a valid GBS,<br>
+ *             the fn maps it, parses its metadata in place<br>
+ *             and returns FPGA_OK. Mapping it again, before<br>
+ *             or after unloading, reuses the cached mapping<br>
+ *             until the file changes.<br>
+ */
+TEST_P(bitstream_c_p, map_ok0) {
+  opae_bitstream_info info;
+  opae_bitstream_info info2;
+
+  opae_bitstream_cache_flush();
+
+  ASSERT_EQ(opae_map_bitstream(tmpnull_gbs_, &info), FPGA_OK);
+  EXPECT_STREQ(tmpnull_gbs_, info.filename);
+  ASSERT_NE(info.data, nullptr);
+  EXPECT_EQ(info.data_len, null_gbs_.size());
+  EXPECT_EQ(memcmp(info.data, null_gbs_.data(), null_gbs_.size()), 0);
+  EXPECT_EQ(info.metadata_version, 1);
+  EXPECT_NE(info.parsed_metadata, nullptr);
+
+  ASSERT_EQ(opae_map_bitstream(tmpnull_gbs_, &info2), FPGA_OK);
+  EXPECT_EQ(info2.data, info.data);
+  EXPECT_EQ(info2.parsed_metadata, info.parsed_metadata);
+
+  uint8_t *data = info.data;
+  EXPECT_EQ(opae_unload_bitstream(&info), FPGA_OK);
+  EXPECT_EQ(info.data, nullptr);
+  EXPECT_EQ(opae_unload_bitstream(&info2), FPGA_OK);
+
+  ASSERT_EQ(opae_map_bitstream(tmpnull_gbs_, &info), FPGA_OK);
+  EXPECT_EQ(info.data, data);
+  EXPECT_EQ(opae_unload_bitstream(&info), FPGA_OK);
+
+  // A new modification time makes a new entry.
+  struct timespec times[2] = { { 0, UTIME_OMIT }, { 12345, 0 } };
+  ASSERT_EQ(utimensat(AT_FDCWD, tmpnull_gbs_, times, 0), 0);
+
+  ASSERT_EQ(opae_map_bitstream(tmpnull_gbs_, &info), FPGA_OK);
+  EXPECT_NE(info.data, data);
+  EXPECT_EQ(opae_unload_bitstream(&info), FPGA_OK);
+
+  opae_bitstream_cache_flush();
+}
+
 /**
  * @test       unload_err0
  * @brief      Test: opae_unload_bitstream
@@ -34,6 +34,13 @@
 
 extern "C" {
 
+#define MAX_TARGETS 64
+struct pci_address {
+  int segment;
+  int bus;
+  int device;
+  int function;
+};
 struct config {
   unsigned int verbosity;
   bool dry_run;
@@ -43,6 +50,9 @@ struct config {
        } mode;
   int flags;
   char *filename;
+  bool all;
+  uint32_t num_targets;
+  struct pci_address targets[MAX_TARGETS];
 };
 extern struct config config;
 
@@ -54,6 +64,8 @@ void print_msg(unsigned int verbosity, const char *s);
 
 int parse_args(int argc, char *argv[]);
 
+bool parse_pci_address(const char *s, struct pci_address *addr);
+
 int print_interface_id(fpga_properties device_filter,
                        fpga_guid actual_interface_id);
 
@@ -64,6 +76,15 @@ int find_fpga(fpga_properties device_filter,
 int program_bitstream(fpga_token token, uint32_t slot_num,
                       opae_bitstream_info *info, int flags);
 
+int find_fpgas(fpga_properties *device_filters,
+               uint32_t num_filters,
+               fpga_guid interface_id,
+               fpga_token **fpgas);
+
+int program_bitstreams(fpga_token *tokens, uint32_t num_tokens,
+                       uint32_t slot_num, opae_bitstream_info *info,
+                       int flags);
+
 int fpgaconf_main(int argc, char *argv[]);
 
 }
@@ -380,6 +401,63 @@ TEST_P(fpgaconf_c_p, find_fpga0) {
   EXPECT_EQ(fpgaDestroyProperties(&filter), FPGA_OK);
 }
 
+/**
+ * @test       pci_address
+ * @brief      Test: parse_pci_address
+ * @details    parse_pci_address accepts ssss:bb:dd.f and bb:dd.f,<br>
+ *             and rejects anything else, including trailing text.<br>
+ */
+TEST_P(fpgaconf_c_p, pci_address) {
+  struct pci_address addr;
+
+  EXPECT_TRUE(parse_pci_address("0001:5e:00.1", &addr));
+  EXPECT_EQ(addr.segment, 1);
+  EXPECT_EQ(addr.bus, 0x5e);
+  EXPECT_EQ(addr.device, 0);
+  EXPECT_EQ(addr.function, 1);
+
+  EXPECT_TRUE(parse_pci_address("3b:01.0", &addr));
+  EXPECT_EQ(addr.segment, 0);
+  EXPECT_EQ(addr.bus, 0x3b);
+  EXPECT_EQ(addr.device, 1);
+  EXPECT_EQ(addr.function, 0);
+
+  EXPECT_FALSE(parse_pci_address("3b:01.8", &addr));
+  EXPECT_FALSE(parse_pci_address("3b:01.0.gbs", &addr));
+  EXPECT_FALSE(parse_pci_address("nlb.gbs", &addr));
+}
+
+/**
+ * @test       parse_args_all
+ * @brief      Test: parse_args
+ * @details    When given --all followed by PCI addresses,<br>
+ *             parse_args records each address as a target<br>
+ *             and takes the first other argument as the GBS.<br>
+ */
+TEST_P(fpgaconf_c_p, parse_args_all) {
+  char zero[20];
+  char one[20];
+  char two[20];
+  char three[20];
+  char four[20];
+  strcpy(zero, "fpgaconf");
+  strcpy(one, "--all");
+  strcpy(two, "3b:00.0");
+  strcpy(three, "0000:5e:00.0");
+  strcpy(four, tmp_gbs_);
+
+  char *argv[] = { zero, one, two, three, four, NULL };
+
+  ASSERT_EQ(parse_args(5, argv), 0);
+  EXPECT_TRUE(config.all);
+  ASSERT_EQ(config.num_targets, 2u);
+  EXPECT_EQ(config.targets[0].bus, 0x3b);
+  EXPECT_EQ(config.targets[1].bus, 0x5e);
+  ASSERT_NE(config.filename, nullptr);
+  EXPECT_NE(strstr(config.filename, tmp_gbs_), nullptr);
+  opae_free(config.filename);
+}
+
 /**
  * @test       main0
  * @brief      Test: fpgaconf_main
@@ -436,6 +514,34 @@ TEST_P(fpgaconf_c_p, main1) {
   EXPECT_EQ(fpgaconf_main(11, argv), 0);
 }
 
+/**
+ * @test       main_all
+ * @brief      Test: fpgaconf_main
+ * @details    When given --all with a filter that matches<br>
+ *             a valid accelerator device,<br>
+ *             fpgaconf_main programs each matching device<br>
+ *             and returns 0.<br>
+ */
+TEST_P(fpgaconf_c_p, main_all) {
+  char zero[20];
+  char one[20];
+  char two[20];
+  char three[20];
+  char four[20];
+  char five[20];
+  strcpy(zero, "fpgaconf");
+  strcpy(one, "-n");
+  strcpy(two, "-a");
+  strcpy(three, "-B");
+  sprintf(four, "%d", platform_.devices[0].bus);
+  strcpy(five, tmp_gbs_);
+
+  char *argv[] = { zero, one, two, three, four,
+                   five, NULL };
+
+  EXPECT_EQ(fpgaconf_main(6, argv), 0);
+}
+
 /**
  * @test       main2
  * @brief      Test: fpgaconf_main
@@ -979,6 +1085,81 @@ TEST_P(fpgaconf_c_mock_p, prog_bs2) {
   EXPECT_EQ(fpgaDestroyProperties(&filter), FPGA_OK);
 }
 
+/**
+ * @test       prog_all0
+ * @brief      Test: find_fpgas, program_bitstreams
+ * @details    When one filter matches the device and another<br>
+ *             matches nothing, find_fpgas returns the one token.<br>
+ *             With config.dry_run set, program_bitstreams<br>
+ *             reports no failures.<br>
+ */
+TEST_P(fpgaconf_c_mock_p, prog_all0) {
+  fpga_properties filters[2] = { NULL, NULL };
+
+  ASSERT_EQ(fpgaGetProperties(NULL, &filters[0]), FPGA_OK);
+  ASSERT_EQ(fpgaPropertiesSetBus(filters[0], platform_.devices[0].bus), FPGA_OK);
+  ASSERT_EQ(fpgaGetProperties(NULL, &filters[1]), FPGA_OK);
+  ASSERT_EQ(fpgaPropertiesSetBus(filters[1], 0xff), FPGA_OK);
+
+  config.dry_run = true;
+
+  fpga_guid pr_ifc_id;
+  ASSERT_EQ(uuid_parse(platform_.devices[0].fme_guid, pr_ifc_id), 0);
+
+  opae_bitstream_info info;
+  ASSERT_EQ(opae_load_bitstream(tmp_gbs_, &info), FPGA_OK);
+
+  fpga_token *toks = nullptr;
+  ASSERT_EQ(find_fpgas(filters, 2, pr_ifc_id, &toks), 1);
+  ASSERT_NE(toks, nullptr);
+
+  EXPECT_EQ(program_bitstreams(toks, 1, 0, &info, 0), 0);
+
+  EXPECT_EQ(fpgaDestroyToken(&toks[0]), FPGA_OK);
+  opae_free(toks);
+
+  toks = nullptr;
+  EXPECT_EQ(find_fpgas(&filters[1], 1, pr_ifc_id, &toks), 0);
+  EXPECT_EQ(toks, nullptr);
+
+  EXPECT_EQ(opae_unload_bitstream(&info), FPGA_OK);
+  EXPECT_EQ(fpgaDestroyProperties(&filters[0]), FPGA_OK);
+  EXPECT_EQ(fpgaDestroyProperties(&filters[1]), FPGA_OK);
+}
+
+/**
+ * @test       prog_all1
+ * @brief      Test: program_bitstreams
+ * @details    When config.dry_run is set to false,<br>
+ *             and the PR fails on the device,<br>
+ *             program_bitstreams counts it as a failure.<br>
+ */
+TEST_P(fpgaconf_c_mock_p, prog_all1) {
+  fpga_properties filter = NULL;
+
+  ASSERT_EQ(fpgaGetProperties(NULL, &filter), FPGA_OK);
+  ASSERT_EQ(fpgaPropertiesSetBus(filter, platform_.devices[0].bus), FPGA_OK);
+
+  ASSERT_EQ(config.dry_run, false);
+
+  fpga_guid pr_ifc_id;
+  ASSERT_EQ(uuid_parse(platform_.devices[0].fme_guid, pr_ifc_id), 0);
+
+  opae_bitstream_info info;
+  ASSERT_EQ(opae_load_bitstream(tmp_gbs_, &info), FPGA_OK);
+
+  fpga_token *toks = nullptr;
+  ASSERT_EQ(find_fpgas(&filter, 1, pr_ifc_id, &toks), 1);
+
+  EXPECT_EQ(program_bitstreams(toks, 1, 0, &info, 0), 1);
+
+  EXPECT_EQ(fpgaDestroyToken(&toks[0]), FPGA_OK);
+  opae_free(toks);
+
+  EXPECT_EQ(opae_unload_bitstream(&info), FPGA_OK);
+  EXPECT_EQ(fpgaDestroyProperties(&filter), FPGA_OK);
+}
+
 GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(fpgaconf_c_mock_p);
 INSTANTIATE_TEST_SUITE_P(fpgaconf_c, fpgaconf_c_mock_p,
                          ::testing::ValuesIn(test_platform::mock_platforms({"skx-p"})));
@@ -27,10 +27,11 @@
 #include <config.h>
 #endif // HAVE_CONFIG_H
 
+#include <algorithm>
+#include <vector>
+
 extern "C" {
 #include "fpgad/api/opae_events_api.h"
-
-extern api_client_event_registry *event_registry_list;
 }
 
 #define NO_OPAE_C
@@ -40,6 +41,26 @@ using namespace opae::testing;
 
 class fpgad_opae_events_api_c_p : public opae_base_p<> {};
 
+static void collect_registry(api_client_event_registry *r, void *context)
+{
+  std::vector<api_client_event_registry *> *v =
+    reinterpret_cast<std::vector<api_client_event_registry *> *>(context);
+  v->push_back(r);
+}
+
+static std::vector<int> registered_sockets(fpga_event_type e,
+                                           uint64_t object_id)
+{
+  std::vector<api_client_event_registry *> v;
+  std::vector<int> socks;
+
+  opae_api_for_each_registration_of(e, object_id, collect_registry, &v);
+  for (auto r : v)
+    socks.push_back(r->conn_socket);
+  std::sort(socks.begin(), socks.end());
+  return socks;
+}
+
 /**
  * @test       events01
  * @brief      Test: opae_api_register_event
@@ -54,25 +75,23 @@ TEST_P(fpgad_opae_events_api_c_p, events01) {
  * @test       events02
  * @brief      Test: opae_api_unregister_event, opae_api_register_event
  * @details    Verifies the fn's ability to correctly remove<br>
- *             items from event_registry_list.<br>
+ *             items from the event registry.<br>
  */
 TEST_P(fpgad_opae_events_api_c_p, events02) {
   const int num = 4;
   int i;
   api_client_event_registry registries[] = {
-    { 0, -1, 0, FPGA_EVENT_ERROR, 0, NULL },
-    { 1, -1, 0, FPGA_EVENT_ERROR, 0, NULL },
-    { 2, -1, 0, FPGA_EVENT_ERROR, 0, NULL },
-    { 3, -1, 0, FPGA_EVENT_ERROR, 0, NULL },
+    { 0, -1, 0, FPGA_EVENT_ERROR, 0, NULL, NULL },
+    { 1, -1, 0, FPGA_EVENT_ERROR, 0, NULL, NULL },
+    { 2, -1, 0, FPGA_EVENT_ERROR, 0, NULL, NULL },
+    { 3, -1, 0, FPGA_EVENT_ERROR, 0, NULL, NULL },
   };
-  api_client_event_registry *l;
 
-  ASSERT_EQ(event_registry_list, (void *)NULL);
+  ASSERT_EQ(opae_api_num_registered_events(), 0);
   EXPECT_NE(opae_api_unregister_event(0,
                                       FPGA_EVENT_ERROR,
                                       0), 0);
 
-  // 3 -> 2 -> 1 -> 0
   for (i = 0 ; i < num ; ++i) {
     api_client_event_registry *r = &registries[i];
     EXPECT_EQ(opae_api_register_event(r->conn_socket,
@@ -80,6 +99,11 @@ TEST_P(fpgad_opae_events_api_c_p, events02) {
                                       r->event,
                                       r->object_id), 0);
   }
+  EXPECT_EQ(opae_api_num_registered_events(), 4);
+  EXPECT_EQ(registered_sockets(FPGA_EVENT_ERROR, 0),
+            std::vector<int>({ 0, 1, 2, 3 }));
+  EXPECT_TRUE(registered_sockets(FPGA_EVENT_ERROR, 1).empty());
+  EXPECT_TRUE(registered_sockets(FPGA_EVENT_POWER_THERMAL, 0).empty());
 
   // Try removing a registry that isn't there.
   EXPECT_NE(opae_api_unregister_event(4,
@@ -90,37 +114,29 @@ TEST_P(fpgad_opae_events_api_c_p, events02) {
   EXPECT_EQ(opae_api_unregister_event(2,
                                       FPGA_EVENT_ERROR,
                                       0), 0);
-  // 3 -> 1 -> 0
-  l = event_registry_list;
-  EXPECT_EQ(l->conn_socket, 3);
-  EXPECT_EQ(l->next->conn_socket, 1);
-  EXPECT_EQ(l->next->next->conn_socket, 0);
-  EXPECT_EQ(l->next->next->next, (void *)NULL);
+  EXPECT_EQ(registered_sockets(FPGA_EVENT_ERROR, 0),
+            std::vector<int>({ 0, 1, 3 }));
 
   // remove 3
   EXPECT_EQ(opae_api_unregister_event(3,
                                       FPGA_EVENT_ERROR,
                                       0), 0);
-   // 1 -> 0
-  l = event_registry_list;
-  EXPECT_EQ(l->conn_socket, 1);
-  EXPECT_EQ(l->next->conn_socket, 0);
-  EXPECT_EQ(l->next->next, (void *)NULL);
+  EXPECT_EQ(registered_sockets(FPGA_EVENT_ERROR, 0),
+            std::vector<int>({ 0, 1 }));
 
   // remove 0
   EXPECT_EQ(opae_api_unregister_event(0,
                                       FPGA_EVENT_ERROR,
                                       0), 0);
-  // 1 
-  l = event_registry_list;
-  EXPECT_EQ(l->conn_socket, 1);
-  EXPECT_EQ(l->next, (void *)NULL);
+  EXPECT_EQ(registered_sockets(FPGA_EVENT_ERROR, 0),
+            std::vector<int>({ 1 }));
 
   // remove 1
   EXPECT_EQ(opae_api_unregister_event(1,
                                       FPGA_EVENT_ERROR,
                                       0), 0);
-  EXPECT_EQ(event_registry_list, (void *)NULL);
+  EXPECT_TRUE(registered_sockets(FPGA_EVENT_ERROR, 0).empty());
+  EXPECT_EQ(opae_api_num_registered_events(), 0);
 }
 
 /**
@@ -131,10 +147,11 @@ TEST_P(fpgad_opae_events_api_c_p, events02) {
  */
 TEST_P(fpgad_opae_events_api_c_p, events03) {
   fpgad_monitored_device d;
+  std::vector<api_client_event_registry *> v;
   memset(&d, 0, sizeof(d));
   d.object_id = 43;
 
-  ASSERT_EQ(event_registry_list, (void *)NULL);
+  ASSERT_EQ(opae_api_num_registered_events(), 0);
 
   ASSERT_EQ(opae_api_register_event(0,
                                     -1,
@@ -143,12 +160,40 @@ TEST_P(fpgad_opae_events_api_c_p, events03) {
 
   opae_api_send_EVENT_ERROR(&d);
 
-  EXPECT_EQ(event_registry_list->data, 2);
+  opae_api_for_each_registration_of(FPGA_EVENT_ERROR, 43,
+                                    collect_registry, &v);
+  ASSERT_EQ(v.size(), 1);
+  EXPECT_EQ(v[0]->data, 2);
 
   EXPECT_EQ(opae_api_unregister_event(0,
                                       FPGA_EVENT_ERROR,
                                       43), 0);
-  EXPECT_EQ(event_registry_list, (void *)NULL);
+  EXPECT_EQ(opae_api_num_registered_events(), 0);
+}
+
+/**
+ * @test       events04
+ * @brief      Test: opae_api_unregister_all_events_for
+ * @details    Removes only the registrations of the given<br>
+ *             client, across events and objects.<br>
+ */
+TEST_P(fpgad_opae_events_api_c_p, events04) {
+  ASSERT_EQ(opae_api_register_event(5, -1, FPGA_EVENT_ERROR, 1), 0);
+  ASSERT_EQ(opae_api_register_event(5, -1, FPGA_EVENT_POWER_THERMAL, 1), 0);
+  ASSERT_EQ(opae_api_register_event(5, -1, FPGA_EVENT_ERROR, 2), 0);
+  ASSERT_EQ(opae_api_register_event(6, -1, FPGA_EVENT_ERROR, 1), 0);
+  EXPECT_EQ(opae_api_num_registered_events(), 4);
+
+  opae_api_unregister_all_events_for(5);
+
+  EXPECT_EQ(opae_api_num_registered_events(), 1);
+  EXPECT_EQ(registered_sockets(FPGA_EVENT_ERROR, 1),
+            std::vector<int>({ 6 }));
+  EXPECT_TRUE(registered_sockets(FPGA_EVENT_POWER_THERMAL, 1).empty());
+  EXPECT_TRUE(registered_sockets(FPGA_EVENT_ERROR, 2).empty());
+
+  opae_api_unregister_all_events();
+  EXPECT_EQ(opae_api_num_registered_events(), 0);
 }
 
 GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(fpgad_opae_events_api_c_p);
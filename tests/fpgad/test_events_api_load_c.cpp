@@ -0,0 +1,252 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "fpgad/api/logging.h"
+#include "fpgad/api/opae_events_api.h"
+#include "fpgad/events_api_thread.h"
+
+bool events_api_is_ready(void);
+}
+
+#define NO_OPAE_C
+#include "mock/opae_fixtures.h"
+
+using namespace opae::testing;
+
+typedef std::chrono::steady_clock bench_clock;
+
+class fpgad_events_api_load_c_p : public opae_base_p<> {
+ protected:
+
+  virtual void SetUp() override {
+    opae_base_p<>::SetUp();
+
+    strcpy(tmp_socket_, "tmp-fpgad-api-XXXXXX.sock");
+    close(mkstemps(tmp_socket_, 5));
+
+    log_ = fopen("/dev/null", "w");
+    log_set(log_);
+
+    memset(&config_, 0, sizeof(config_));
+    config_.running = true;
+    config_.api_socket = tmp_socket_;
+
+    thread_config_.global = &config_;
+    thread_config_.sched_policy = SCHED_OTHER;
+    thread_config_.sched_priority = 0;
+
+    ASSERT_EQ(pthread_create(&thread_, NULL,
+                             events_api_thread, &thread_config_), 0);
+    while (!events_api_is_ready())
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  virtual void TearDown() override {
+    config_.running = false;
+    pthread_join(thread_, NULL);
+
+    log_close();
+    unlink(tmp_socket_);
+
+    opae_base_p<>::TearDown();
+  }
+
+  // Each client costs four descriptors in this process: its socket,
+  // the server's end, its eventfd and the server's copy of it.
+  size_t max_clients(size_t wanted) const
+  {
+    struct rlimit rl;
+
+    if (getrlimit(RLIMIT_NOFILE, &rl))
+      return 0;
+    if (rl.rlim_cur < rl.rlim_max) {
+      rl.rlim_cur = rl.rlim_max;
+      setrlimit(RLIMIT_NOFILE, &rl);
+      getrlimit(RLIMIT_NOFILE, &rl);
+    }
+    if (rl.rlim_cur < 128)
+      return 0;
+    return std::min(wanted, (size_t)(rl.rlim_cur - 128) / 4);
+  }
+
+  int connect_client() const
+  {
+    struct sockaddr_un addr;
+    int s = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (s < 0)
+      return -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, tmp_socket_, sizeof(addr.sun_path) - 1);
+
+    if (connect(s, (struct sockaddr *)&addr, sizeof(addr))) {
+      close(s);
+      return -1;
+    }
+    return s;
+  }
+
+  int register_event(int s, int fd, uint64_t object_id) const
+  {
+    struct msghdr mh;
+    struct cmsghdr *cmh;
+    struct iovec iov[1];
+    struct event_request req;
+    char buf[CMSG_SPACE(sizeof(int))];
+
+    req.type = REGISTER_EVENT;
+    req.event = FPGA_EVENT_ERROR;
+    req.object_id = object_id;
+
+    iov[0].iov_base = &req;
+    iov[0].iov_len = sizeof(req);
+    memset(buf, 0, sizeof(buf));
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_iov = iov;
+    mh.msg_iovlen = 1;
+    mh.msg_control = buf;
+    mh.msg_controllen = CMSG_LEN(sizeof(int));
+    cmh = CMSG_FIRSTHDR(&mh);
+    cmh->cmsg_len = CMSG_LEN(sizeof(int));
+    cmh->cmsg_level = SOL_SOCKET;
+    cmh->cmsg_type = SCM_RIGHTS;
+    *((int *)CMSG_DATA(cmh)) = fd;
+
+    return sendmsg(s, &mh, 0) == sizeof(req) ? 0 : -1;
+  }
+
+  // Poll fn until it is true or about ten seconds have passed.
+  template <typename F>
+  bool wait_for(F fn) const
+  {
+    for (int i = 0 ; i < 10000 ; ++i) {
+      if (fn())
+        return true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return fn();
+  }
+
+  char tmp_socket_[32];
+  FILE *log_;
+  struct fpgad_config config_;
+  events_api_thread_config thread_config_;
+  pthread_t thread_;
+};
+
+/**
+ * @test       many_clients
+ * @brief      Test: events_api_thread
+ * @details    Connects thousands of clients that each register<br>
+ *             an eventfd for FPGA_EVENT_ERROR, then reports the<br>
+ *             registration rate and the time to signal them all.<br>
+ *             Every eventfd must be signalled, and every<br>
+ *             registration must be dropped on disconnect.<br>
+ */
+TEST_P(fpgad_events_api_load_c_p, many_clients) {
+  const uint64_t object_id = 0xfeed;
+  size_t num = max_clients(4096);
+  std::vector<int> socks;
+  std::vector<int> fds;
+  size_t i;
+
+  ASSERT_GT(num, 0);
+
+  auto start = bench_clock::now();
+
+  for (i = 0 ; i < num ; ++i) {
+    int s = connect_client();
+    ASSERT_GE(s, 0) << "client " << i;
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    ASSERT_GE(fd, 0);
+    socks.push_back(s);
+    fds.push_back(fd);
+    ASSERT_EQ(register_event(s, fd, object_id), 0);
+  }
+
+  ASSERT_TRUE(wait_for([num] {
+    return opae_api_num_registered_events() == num;
+  }));
+
+  auto registered = bench_clock::now();
+
+  fpgad_monitored_device d;
+  memset(&d, 0, sizeof(d));
+  d.object_id = object_id;
+
+  opae_api_send_EVENT_ERROR(&d);
+
+  auto signalled = bench_clock::now();
+
+  for (i = 0 ; i < num ; ++i) {
+    uint64_t value = 0;
+    EXPECT_EQ(read(fds[i], &value, sizeof(value)), sizeof(value));
+    EXPECT_NE(value, 0);
+  }
+
+  std::chrono::duration<double> reg_secs = registered - start;
+  std::chrono::duration<double, std::micro> send_usecs = signalled - registered;
+
+  std::cout << std::fixed << std::setprecision(1)
+            << "clients: " << num << std::endl
+            << "registrations/s: " << num / reg_secs.count() << std::endl
+            << "send latency: " << send_usecs.count() << " usec ("
+            << std::setprecision(3) << send_usecs.count() / num
+            << " usec/client)" << std::endl;
+
+  for (i = 0 ; i < num ; ++i) {
+    close(socks[i]);
+    close(fds[i]);
+  }
+
+  EXPECT_TRUE(wait_for([] {
+    return opae_api_num_registered_events() == 0;
+  }));
+}
+
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(fpgad_events_api_load_c_p);
+INSTANTIATE_TEST_SUITE_P(fpgad_events_api_c, fpgad_events_api_load_c_p,
+                         ::testing::ValuesIn(test_platform::platforms({ "skx-p" })));
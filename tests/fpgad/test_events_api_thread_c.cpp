@@ -27,20 +27,26 @@
 #include <config.h>
 #endif // HAVE_CONFIG_H
 
-#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
 
 extern "C" {
 #include "fpgad/api/logging.h"
 #include "fpgad/events_api_thread.h"
 
-#define MAX_CLIENT_CONNECTIONS 1023
-#define SRV_SOCKET             0
-#define FIRST_CLIENT_SOCKET    1
+typedef struct _api_client {
+	int conn_socket;
+	uint64_t num_requests;
+	struct _api_client *prev;
+	struct _api_client *next;
+} api_client;
 
-extern struct pollfd pollfds[MAX_CLIENT_CONNECTIONS+1];
-extern nfds_t num_fds;
+extern api_client *client_list;
+extern unsigned num_clients;
 
-void remove_client(int conn_socket);
+api_client *add_client(int conn_socket);
+void remove_client(api_client *client);
 }
 
 #define NO_OPAE_C
@@ -67,44 +73,62 @@ class fpgad_events_api_c_p : public opae_base_p<> {
 
 /**
  * @test       remove0
- * @brief      Test: remove_client
- * @details    Test the fn's ability to remove,<br>
- *             clients from various places in the array.<br>
+ * @brief      Test: add_client, remove_client
+ * @details    Test the fn's ability to remove<br>
+ *             clients from various places in the list.<br>
  */
 TEST_P(fpgad_events_api_c_p, remove0) {
-  int conn_socket = -1;
-
-  // (only one client)
-  pollfds[FIRST_CLIENT_SOCKET+0].fd = conn_socket;
-  num_fds = 2;
+  int sv[2];
+  int socks[3];
+  api_client *clients[3];
+  int i;
+
+  ASSERT_EQ(client_list, (void *)NULL);
+  ASSERT_EQ(num_clients, 0);
+
+  for (i = 0 ; i < 3 ; ++i) {
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+    close(sv[1]);
+    socks[i] = sv[0];
+    clients[i] = add_client(socks[i]);
+    ASSERT_NE(clients[i], (void *)NULL);
+  }
+  EXPECT_EQ(num_clients, 3);
 
-  remove_client(conn_socket);
-  EXPECT_EQ(num_fds, 1);
+  // 2 -> 1 -> 0
+  EXPECT_EQ(client_list, clients[2]);
 
   // (client in middle)
-  pollfds[FIRST_CLIENT_SOCKET+0].fd = 0;
-  pollfds[FIRST_CLIENT_SOCKET+1].fd = conn_socket;
-  pollfds[FIRST_CLIENT_SOCKET+2].fd = conn_socket;
-  pollfds[FIRST_CLIENT_SOCKET+3].fd = 3;
-  num_fds = 5;
-
-  remove_client(conn_socket);
-  EXPECT_EQ(num_fds, 3);
-  EXPECT_EQ(pollfds[FIRST_CLIENT_SOCKET+0].fd, 0);
-  EXPECT_EQ(pollfds[FIRST_CLIENT_SOCKET+1].fd, 3);
+  remove_client(clients[1]);
+  EXPECT_EQ(num_clients, 2);
+  EXPECT_EQ(client_list, clients[2]);
+  EXPECT_EQ(clients[2]->next, clients[0]);
+  EXPECT_EQ(clients[0]->prev, clients[2]);
+  EXPECT_EQ(fcntl(socks[1], F_GETFD), -1);
 
   // (client at end)
-  pollfds[FIRST_CLIENT_SOCKET+0].fd = 0;
-  pollfds[FIRST_CLIENT_SOCKET+1].fd = 1;
-  pollfds[FIRST_CLIENT_SOCKET+2].fd = conn_socket;
-  num_fds = 4;
+  remove_client(clients[0]);
+  EXPECT_EQ(num_clients, 1);
+  EXPECT_EQ(client_list, clients[2]);
+  EXPECT_EQ(clients[2]->next, (void *)NULL);
 
-  remove_client(conn_socket);
-  EXPECT_EQ(num_fds, 3);
-  EXPECT_EQ(pollfds[FIRST_CLIENT_SOCKET+0].fd, 0);
-  EXPECT_EQ(pollfds[FIRST_CLIENT_SOCKET+1].fd, 1);
+  // (only one client)
+  remove_client(clients[2]);
+  EXPECT_EQ(num_clients, 0);
+  EXPECT_EQ(client_list, (void *)NULL);
+}
 
-  num_fds = 1;
+/**
+ * @test       add_enomem
+ * @brief      Test: add_client
+ * @details    When calloc fails, the fn returns NULL<br>
+ *             and the client list is unchanged.<br>
+ */
+TEST_P(fpgad_events_api_c_p, add_enomem) {
+  system_->invalidate_calloc(0, "add_client");
+  EXPECT_EQ(add_client(0), (void *)NULL);
+  EXPECT_EQ(num_clients, 0);
+  EXPECT_EQ(client_list, (void *)NULL);
 }
 
 GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(fpgad_events_api_c_p);
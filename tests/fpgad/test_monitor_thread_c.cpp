@@ -51,8 +51,44 @@ void mon_queue_response(fpgad_detection_status status,
                         void *response_context);
 
 void mon_monitor(fpgad_monitored_device *d);
+
+typedef struct _mon_detection_stats {
+  uint64_t calls;
+  uint64_t detected;
+  uint64_t latency_nsec;
+  uint64_t max_latency_nsec;
+  uint64_t cpu_nsec;
+} mon_detection_stats;
+
+typedef struct _mon_wake_entry {
+  fpgad_monitored_device *device;
+  unsigned detection;
+  mon_detection_stats stats;
+} mon_wake_entry;
+
+typedef struct _mon_wake_source {
+  int fd;
+  uint32_t events;
+  uint32_t period_usec;
+  int timer_fd;
+  mon_wake_entry *entries;
+  unsigned num_entries;
+  mon_detection_stats interval;
+} mon_wake_source;
+
+extern mon_wake_source *mon_wake_sources;
+extern unsigned mon_num_wake_sources;
+extern fpgad_monitored_device *monitored_device_list;
+
+int mon_build_wake_sources(struct fpgad_config *c, int epfd);
+void mon_wake(mon_wake_source *src, bool timer, uint64_t wake_nsec);
+void mon_free_wake_sources(void);
+void mon_log_wake_stats(bool per_detection);
 }
 
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
 #define NO_OPAE_C
 #include "mock/opae_fixtures.h"
 
@@ -184,6 +220,93 @@ TEST_P(fpgad_monitor_c_p, null_response0) {
   normal_queue.tail = 0;
 }
 
+static fpgad_detection_status
+negative_detection(fpgad_monitored_device *dev,
+                   void *context)
+{
+  UNUSED_PARAM(dev);
+  UNUSED_PARAM(context);
+  return FPGAD_STATUS_NOT_DETECTED;
+}
+
+/**
+ * @test       wake_sources
+ * @brief      Test: mon_build_wake_sources, mon_wake
+ * @details    Detections that give the same fd and period share<br>
+ *             one wake source per device, timer-only detections<br>
+ *             share one source per period across devices, and a<br>
+ *             wake runs and counts only the detections of its source.<br>
+ */
+TEST_P(fpgad_monitor_c_p, wake_sources) {
+  struct fpgad_config config;
+  memset(&config, 0, sizeof(config));
+  config.poll_interval_usec = 100 * 1000;
+
+  int efd = eventfd(0, EFD_NONBLOCK);
+  ASSERT_GE(efd, 0);
+  int epfd = epoll_create1(0);
+  ASSERT_GE(epfd, 0);
+
+  fpgad_detect_event_t detections[] = {
+    negative_detection,
+    negative_detection,
+    negative_detection,
+    nullptr,
+  };
+
+  fpgad_detection_source sources[] = {
+    { efd, EPOLLIN, 1000 * 1000 },
+    { efd, EPOLLIN, 1000 * 1000 },
+    { -1,  0,       0 },
+  };
+
+  fpgad_monitored_device d0;
+  fpgad_monitored_device d1;
+  memset(&d0, 0, sizeof(d0));
+  memset(&d1, 0, sizeof(d1));
+  d0.type = d1.type = FPGAD_PLUGIN_TYPE_CALLBACK;
+  d0.detections = d1.detections = detections;
+  d0.detection_sources = sources;
+
+  d0.next = &d1;
+  monitored_device_list = &d0;
+
+  ASSERT_EQ(mon_build_wake_sources(&config, epfd), 0);
+
+  // d0: { 0, 1 } on efd; d0 2 and all of d1 on one 100 ms timer
+  ASSERT_EQ(mon_num_wake_sources, 2);
+  EXPECT_EQ(mon_wake_sources[0].fd, efd);
+  EXPECT_EQ(mon_wake_sources[0].num_entries, 2);
+  EXPECT_GE(mon_wake_sources[0].timer_fd, 0);
+  EXPECT_EQ(mon_wake_sources[1].fd, -1);
+  EXPECT_EQ(mon_wake_sources[1].period_usec, config.poll_interval_usec);
+  EXPECT_EQ(mon_wake_sources[1].num_entries, 4);
+
+  uint64_t one = 1;
+  ASSERT_EQ(write(efd, &one, sizeof(one)), (ssize_t)sizeof(one));
+
+  mon_wake(&mon_wake_sources[0], false, 0);
+  EXPECT_EQ(mon_wake_sources[0].interval.calls, 2);
+  EXPECT_EQ(mon_wake_sources[0].entries[1].stats.calls, 1);
+  EXPECT_EQ(mon_wake_sources[0].interval.detected, 0);
+  EXPECT_EQ(mon_wake_sources[1].interval.calls, 0);
+
+  // the eventfd was drained
+  uint64_t count = 0;
+  EXPECT_LT(read(efd, &count, sizeof(count)), 0);
+
+  mon_log_wake_stats(true);
+  EXPECT_EQ(mon_wake_sources[0].interval.calls, 0);
+  EXPECT_EQ(mon_wake_sources[0].entries[1].stats.calls, 1);
+
+  mon_free_wake_sources();
+  EXPECT_EQ(mon_num_wake_sources, 0);
+
+  monitored_device_list = NULL;
+  close(epfd);
+  close(efd);
+}
+
 GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(fpgad_monitor_c_p);
 INSTANTIATE_TEST_SUITE_P(fpgad_monitor_c, fpgad_monitor_c_p,
                          ::testing::ValuesIn(test_platform::platforms({ "skx-p" })));
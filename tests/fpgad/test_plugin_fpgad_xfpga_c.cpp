@@ -416,6 +416,41 @@ TEST_P(mock_port_fpgad_xfpga_c_p, configure) {
   fpgad_plugin_destroy(&d);
 }
 
+/**
+ * @test       configure_event_monitor
+ * @brief      Test: fpgad_plugin_configure, fpgad_plugin_destroy
+ * @details    When the daemon runs the event monitor,<br>
+ *             the plugin gives a wake source for each detection:<br>
+ *             the global poll interval for power state and AP6,<br>
+ *             and a longer period for the remaining errors.<br>
+ *             fpgad_plugin_destroy releases the sources. (Port)<br>
+ */
+TEST_P(mock_port_fpgad_xfpga_c_p, configure_event_monitor) {
+  fpgad_monitored_device d;
+  fpgad_config_data s;
+  struct fpgad_config config;
+  init_monitored_device(&d, &s);
+
+  memset(&config, 0, sizeof(config));
+  config.event_monitor = true;
+  d.config = &config;
+
+  EXPECT_EQ(fpgad_plugin_configure(&d, NULL), 0);
+
+  ASSERT_NE(d.detection_sources, nullptr);
+  for (unsigned i = 0 ; d.detections[i] ; ++i) {
+    EXPECT_EQ(d.detection_sources[i].fd, -1);
+
+    if (d.detections[i] == fpgad_xfpga_detect_Error)
+      EXPECT_GT(d.detection_sources[i].period_usec, 0);
+    else
+      EXPECT_EQ(d.detection_sources[i].period_usec, 0);
+  }
+
+  fpgad_plugin_destroy(&d);
+  EXPECT_EQ(d.detection_sources, nullptr);
+}
+
 GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(mock_port_fpgad_xfpga_c_p);
 INSTANTIATE_TEST_SUITE_P(fpgad_c, mock_port_fpgad_xfpga_c_p,
                          ::testing::ValuesIn(test_platform::mock_platforms({ "skx-p" })));
@@ -591,6 +626,40 @@ TEST_P(mock_fme_fpgad_xfpga_c_p, configure) {
   fpgad_plugin_destroy(&d);
 }
 
+/**
+ * @test       configure_event_monitor
+ * @brief      Test: fpgad_plugin_configure, fpgad_plugin_destroy
+ * @details    When the daemon runs the event monitor,<br>
+ *             FME errors wake on the FME error interrupt, when<br>
+ *             there is one, backed by a longer period. Without<br>
+ *             the interrupt, AP6 stays at the global poll interval.<br>
+ *             fpgad_plugin_destroy releases the sources. (FME)<br>
+ */
+TEST_P(mock_fme_fpgad_xfpga_c_p, configure_event_monitor) {
+  fpgad_monitored_device d;
+  fpgad_config_data s;
+  struct fpgad_config config;
+  init_monitored_device(&d, &s);
+
+  memset(&config, 0, sizeof(config));
+  config.event_monitor = true;
+  d.config = &config;
+
+  EXPECT_EQ(fpgad_plugin_configure(&d, NULL), 0);
+
+  ASSERT_NE(d.detection_sources, nullptr);
+  for (unsigned i = 0 ; d.detections[i] ; ++i) {
+    if (d.detection_sources[i].fd < 0 &&
+        d.responses[i] == fpgad_xfpga_respond_AP6)
+      EXPECT_EQ(d.detection_sources[i].period_usec, 0);
+    else
+      EXPECT_GT(d.detection_sources[i].period_usec, 0);
+  }
+
+  fpgad_plugin_destroy(&d);
+  EXPECT_EQ(d.detection_sources, nullptr);
+}
+
 GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(mock_fme_fpgad_xfpga_c_p);
 INSTANTIATE_TEST_SUITE_P(fpgad_c, mock_fme_fpgad_xfpga_c_p,
                          ::testing::ValuesIn(test_platform::mock_platforms({ "skx-p" })));
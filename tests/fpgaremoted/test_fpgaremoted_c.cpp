@@ -0,0 +1,240 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <getopt.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "fpgaremoted.h"
+
+int add_endpoint(struct remoted_config *c, const char *kind,
+                 const char *arg);
+int check_tcp_endpoints(struct remoted_config *c);
+int parse_args(struct remoted_config *c, int argc, char *argv[]);
+bool unix_peer_allowed(int sock);
+}
+
+class fpgaremoted_c_p : public ::testing::Test {
+ protected:
+  virtual void SetUp() override {
+    memset(&config_, 0, sizeof(config_));
+    memset(&remoted_config, 0, sizeof(remoted_config));
+    log_set(stdout);
+
+    strcpy(token_file_, "remoted-XXXXXX.token");
+    int fd = mkstemps(token_file_, 6);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, "sekrit\n", 7), 7);
+    close(fd);
+  }
+
+  virtual void TearDown() override {
+    unlink(token_file_);
+    log_close();
+  }
+
+  int parse(std::initializer_list<const char *> args) {
+    std::vector<char *> argv;
+
+    argv.push_back((char *)"fpgaremoted");
+    for (const char *a : args)
+      argv.push_back((char *)a);
+    argv.push_back(nullptr);
+
+    optind = 0;
+    return parse_args(&config_, (int)argv.size() - 1, argv.data());
+  }
+
+  struct remoted_config config_;
+  char token_file_[24];
+};
+
+/**
+ * @test       add_endpoint_loopback
+ * @brief      Test: add_endpoint
+ * @details    A TCP port with no host, or an empty one, listens on
+ *             127.0.0.1. An explicit host is kept, and UNIX socket
+ *             paths are prefixed.<br>
+ */
+TEST_F(fpgaremoted_c_p, add_endpoint_loopback) {
+  ASSERT_EQ(add_endpoint(&config_, "tcp", "5530"), 0);
+  ASSERT_EQ(add_endpoint(&config_, "tcp", ":5531"), 0);
+  ASSERT_EQ(add_endpoint(&config_, "tcp", "0.0.0.0:5532"), 0);
+  ASSERT_EQ(add_endpoint(&config_, "tcp", "[::1]:5533"), 0);
+  ASSERT_EQ(add_endpoint(&config_, "unix", "/tmp/remoted"), 0);
+  ASSERT_EQ(config_.num_endpoints, 5);
+
+  EXPECT_STREQ(config_.endpoints[0], "tcp:127.0.0.1:5530");
+  EXPECT_STREQ(config_.endpoints[1], "tcp:127.0.0.1:5531");
+  EXPECT_STREQ(config_.endpoints[2], "tcp:0.0.0.0:5532");
+  EXPECT_STREQ(config_.endpoints[3], "tcp:[::1]:5533");
+  EXPECT_STREQ(config_.endpoints[4], "unix:/tmp/remoted");
+}
+
+/**
+ * @test       add_endpoint_max
+ * @brief      Test: add_endpoint
+ * @details    At most REMOTED_LISTEN_MAX listeners are accepted.<br>
+ */
+TEST_F(fpgaremoted_c_p, add_endpoint_max) {
+  for (int i = 0; i < REMOTED_LISTEN_MAX; ++i)
+    ASSERT_EQ(add_endpoint(&config_, "tcp", "5530"), 0);
+  EXPECT_NE(add_endpoint(&config_, "tcp", "5530"), 0);
+  EXPECT_EQ(config_.num_endpoints, REMOTED_LISTEN_MAX);
+}
+
+/**
+ * @test       tcp_needs_token
+ * @brief      Test: check_tcp_endpoints
+ * @details    A TCP listener, even on the loopback address, needs a
+ *             token or an explicit opt-out. UNIX sockets need
+ *             neither.<br>
+ */
+TEST_F(fpgaremoted_c_p, tcp_needs_token) {
+  ASSERT_EQ(add_endpoint(&config_, "unix", "/tmp/remoted"), 0);
+  EXPECT_EQ(check_tcp_endpoints(&config_), 0);
+
+  ASSERT_EQ(add_endpoint(&config_, "tcp", "5530"), 0);
+  EXPECT_NE(check_tcp_endpoints(&config_), 0);
+
+  config_.tcp_insecure = true;
+  EXPECT_EQ(check_tcp_endpoints(&config_), 0);
+
+  config_.tcp_insecure = false;
+  config_.token_len = 1;
+  EXPECT_EQ(check_tcp_endpoints(&config_), 0);
+}
+
+/**
+ * @test       parse_token_file
+ * @brief      Test: parse_args
+ * @details    --tcp is refused without --token-file or --tcp-insecure,
+ *             in either order. The token is read less its newline,
+ *             and only from a file private to its owner.<br>
+ */
+TEST_F(fpgaremoted_c_p, parse_token_file) {
+  ASSERT_EQ(chmod(token_file_, 0600), 0);
+
+  EXPECT_NE(parse({ "--tcp", "5530" }), 0);
+
+  memset(&config_, 0, sizeof(config_));
+  EXPECT_EQ(parse({ "--tcp", "5530", "--tcp-insecure" }), 0);
+
+  memset(&config_, 0, sizeof(config_));
+  EXPECT_EQ(parse({ "--tcp", "5530", "--token-file", token_file_ }), 0);
+  ASSERT_EQ(config_.token_len, 6u);
+  EXPECT_EQ(memcmp(config_.token, "sekrit", 6), 0);
+
+  ASSERT_EQ(chmod(token_file_, 0640), 0);
+  memset(&config_, 0, sizeof(config_));
+  EXPECT_NE(parse({ "--token-file", token_file_, "--tcp", "5530" }), 0);
+}
+
+/**
+ * @test       unix_peer_self
+ * @brief      Test: unix_peer_allowed
+ * @details    A peer running as the daemon's own user is admitted.<br>
+ */
+TEST_F(fpgaremoted_c_p, unix_peer_self) {
+  int sv[2];
+
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+  EXPECT_TRUE(unix_peer_allowed(sv[0]));
+  close(sv[0]);
+  close(sv[1]);
+}
+
+/**
+ * @test       unix_peer_other
+ * @brief      Test: unix_peer_allowed
+ * @details    A peer running as another user is refused, unless it
+ *             belongs to the group given with --group. Needs root, to
+ *             create the peer as another user.<br>
+ */
+TEST_F(fpgaremoted_c_p, unix_peer_other) {
+  const uid_t nobody = 65534;
+  int sv[2];
+  int fd = -1;
+  int status = 0;
+  remote_buf b;
+  remote_msg_hdr h;
+
+  if (geteuid())
+    GTEST_SKIP();
+
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (!pid) {
+    // The credentials of a socket pair are those of its creator,
+    // so create one as nobody and hand one end to the parent.
+    int peer[2];
+    remote_buf msg;
+    size_t off;
+
+    close(sv[0]);
+    if (setgid(nobody) || setuid(nobody) ||
+        socketpair(AF_UNIX, SOCK_STREAM, 0, peer))
+      _exit(1);
+
+    remote_buf_init(&msg);
+    off = remote_msg_begin(&msg, REMOTE_OP_HELLO, 0, 1, 0);
+    remote_msg_end(&msg, off);
+    _exit(remote_send(sv[1], msg.data, msg.len, peer[0]) ? 1 : 0);
+  }
+
+  close(sv[1]);
+  remote_buf_init(&b);
+  EXPECT_EQ(remote_recv(sv[0], &h, &b, &fd), 0);
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  ASSERT_GE(fd, 0);
+
+  EXPECT_FALSE(unix_peer_allowed(fd));
+
+  remoted_config.have_group = true;
+  remoted_config.group = nobody;
+  EXPECT_TRUE(unix_peer_allowed(fd));
+
+  close(fd);
+  close(sv[0]);
+  remote_buf_free(&b);
+}
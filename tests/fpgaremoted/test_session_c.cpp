@@ -0,0 +1,619 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <opae/fpga.h>
+
+extern "C" {
+#include "fpgaremoted.h"
+}
+
+#define HE_LPBK_LINES 32
+
+/*
+ * A session served over a socket pair, standing in for the client
+ * library. libopae-sim provides the he_lpbk AFU behind it.
+ */
+class fpgaremoted_session_c_p : public ::testing::Test {
+ protected:
+  fpgaremoted_session_c_p()
+  : sock_(-1), next_seq_(0), posted_result_(FPGA_OK), data_msgs_(0),
+    token_id_(0), handle_id_(0) {}
+
+  static void SetUpTestCase() {
+    char cfg[] = "fpgaremoted-XXXXXX.cfg";
+    int fd = mkstemps(cfg, 4);
+
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    std::ofstream f(cfg);
+    f << "{ \"configurations\": { \"sim\": {"
+         " \"enabled\": true, \"platform\": \"libopae-sim\","
+         " \"devices\": [ { \"name\": \"opae_sim\","
+         " \"id\": [ \"0x8086\", \"0x0a5d\", \"0x8086\", \"0x0a5d\" ] } ],"
+         " \"opae\": { \"plugin\": [ { \"enabled\": true,"
+         " \"module\": \"" OPAE_SIM_PLUGIN "\","
+         " \"devices\": [ \"opae_sim\" ],"
+         " \"configuration\": { \"devices\": [ \"he_lpbk\" ] } } ],"
+         " \"fpgainfo\": [], \"fpgad\": [], \"rsu\": [], \"fpgareg\": [],"
+         " \"opae.io\": [] } } },"
+         " \"configs\": [ \"sim\" ] }\n";
+    f.close();
+
+    EXPECT_EQ(fpgaInitialize(cfg), FPGA_OK);
+    unlink(cfg);
+  }
+
+  virtual void SetUp() override {
+    memset(&remoted_config, 0, sizeof(remoted_config));
+    remoted_config.shm = true;
+    remoted_config.running = true;
+    remote_buf_init(&in_);
+  }
+
+  virtual void TearDown() override {
+    if (sock_ >= 0)
+      close(sock_);
+    session_stop_all();
+    remote_buf_free(&in_);
+  }
+
+  void start(bool is_unix) {
+    int sv[2];
+
+    if (sock_ >= 0)
+      close(sock_);
+    session_stop_all();
+
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv), 0);
+    sock_ = sv[0];
+    ASSERT_EQ(session_start(sv[1], is_unix), 0);
+  }
+
+  uint32_t send(uint16_t op, uint16_t flags, const remote_buf &req) {
+    remote_buf out;
+    size_t off;
+
+    remote_buf_init(&out);
+    off = remote_msg_begin(&out, op, flags, ++next_seq_, 0);
+    if (req.len)
+      remote_put_bytes(&out, req.data, req.len);
+    remote_msg_end(&out, off);
+    EXPECT_EQ(remote_send(sock_, out.data, out.len, -1), 0);
+    remote_buf_free(&out);
+
+    return next_seq_;
+  }
+
+  // Copy a server-to-client BUFFER_DATA message into its mirror.
+  void apply_data() {
+    remote_reader r;
+
+    remote_reader_init(&r, in_.data, in_.len);
+    remote_get_u64(&r);
+    uint64_t wsid = remote_get_u64(&r);
+    uint64_t offset = remote_get_u64(&r);
+    uint32_t len = remote_get_u32(&r);
+    const uint8_t *data = remote_get_bytes(&r, len);
+
+    ASSERT_EQ(r.err, 0);
+    ++data_msgs_;
+
+    auto m = mirrors_.find(wsid);
+    ASSERT_NE(m, mirrors_.end());
+    ASSERT_LE(offset + len, m->second.size());
+    memcpy(m->second.data() + offset, data, len);
+  }
+
+  /*
+   * Make a request and wait for its response. Buffer data that comes
+   * first is applied, and the failures of posted requests are kept
+   * in posted_result_.
+   */
+  fpga_result call(uint16_t op, const remote_buf &req,
+                   remote_buf *resp = nullptr, int *resp_fd = nullptr) {
+    uint32_t seq = send(op, 0, req);
+    remote_msg_hdr h;
+    int fd = -1;
+
+    while (!remote_recv(sock_, &h, &in_, &fd)) {
+      if (h.op == REMOTE_OP_BUFFER_DATA && !h.seq) {
+        apply_data();
+      } else if (h.flags & REMOTE_F_POSTED) {
+        posted_result_ = (fpga_result)h.result;
+      } else if (h.seq == seq) {
+        if (resp) {
+          resp->len = 0;
+          remote_put_bytes(resp, in_.data, in_.len);
+        }
+        if (resp_fd)
+          *resp_fd = fd;
+        else if (fd >= 0)
+          close(fd);
+        return (fpga_result)h.result;
+      } else {
+        ADD_FAILURE() << "unexpected message op " << h.op;
+      }
+
+      if (fd >= 0)
+        close(fd);
+      fd = -1;
+    }
+
+    return FPGA_NO_DAEMON;
+  }
+
+  fpga_result call(uint16_t op) {
+    remote_buf req;
+
+    remote_buf_init(&req);
+    fpga_result res = call(op, req);
+    remote_buf_free(&req);
+    return res;
+  }
+
+  // True when the session has dropped the connection.
+  bool disconnected() {
+    remote_msg_hdr h;
+    int fd = -1;
+
+    return remote_recv(sock_, &h, &in_, &fd) == 1;
+  }
+
+  fpga_result hello(uint32_t caps, const std::string &token = "",
+                    uint32_t *resp_caps = nullptr) {
+    remote_buf req, resp;
+    remote_reader r;
+
+    remote_buf_init(&req);
+    remote_buf_init(&resp);
+    remote_put_u32(&req, REMOTE_PROTO_MAGIC);
+    remote_put_u32(&req, REMOTE_PROTO_VERSION);
+    remote_put_u32(&req, caps);
+    remote_put_u32(&req, 0);
+    remote_put_u32(&req, token.size());
+    remote_put_bytes(&req, token.data(), token.size());
+
+    fpga_result res = call(REMOTE_OP_HELLO, req, &resp);
+    if (res == FPGA_OK && resp_caps) {
+      remote_reader_init(&r, resp.data, resp.len);
+      EXPECT_EQ(remote_get_u32(&r), (uint32_t)REMOTE_PROTO_VERSION);
+      *resp_caps = remote_get_u32(&r);
+    }
+
+    remote_buf_free(&req);
+    remote_buf_free(&resp);
+    return res;
+  }
+
+  void open_lpbk() {
+    remote_buf req, resp;
+    remote_reader r;
+    remote_props p;
+
+    remote_buf_init(&req);
+    remote_buf_init(&resp);
+
+    ASSERT_EQ(call(REMOTE_OP_ENUMERATE, req, &resp), FPGA_OK);
+    remote_reader_init(&r, resp.data, resp.len);
+    uint32_t count = remote_get_u32(&r);
+    for (uint32_t i = 0; i < count && !token_id_; ++i) {
+      uint64_t id = remote_get_u64(&r);
+      remote_get_props(&r, &p);
+      if (p.objtype == FPGA_ACCELERATOR)
+        token_id_ = id;
+    }
+    ASSERT_EQ(r.err, 0);
+    ASSERT_NE(token_id_, 0u);
+
+    remote_put_u64(&req, token_id_);
+    remote_put_u32(&req, 0);
+    ASSERT_EQ(call(REMOTE_OP_OPEN, req, &resp), FPGA_OK);
+    remote_reader_init(&r, resp.data, resp.len);
+    handle_id_ = remote_get_u64(&r);
+    ASSERT_EQ(r.err, 0);
+
+    remote_buf_free(&req);
+    remote_buf_free(&resp);
+  }
+
+  fpga_result prepare(uint64_t len, bool shm, uint64_t *wsid,
+                      uint64_t *iova, int *fd = nullptr,
+                      uint64_t *map_len = nullptr) {
+    remote_buf req, resp;
+    remote_reader r;
+
+    remote_buf_init(&req);
+    remote_buf_init(&resp);
+    remote_put_u64(&req, handle_id_);
+    remote_put_u64(&req, len);
+    remote_put_u32(&req, 0);
+    remote_put_u32(&req, shm ? REMOTE_BUF_SHM : 0);
+
+    fpga_result res = call(REMOTE_OP_PREPARE_BUFFER, req, &resp, fd);
+    if (res == FPGA_OK) {
+      remote_reader_init(&r, resp.data, resp.len);
+      *wsid = remote_get_u64(&r);
+      *iova = remote_get_u64(&r);
+      if (map_len)
+        *map_len = remote_get_u64(&r);
+      if (!shm)
+        mirrors_[*wsid] = std::vector<uint8_t>(len, 0);
+    }
+
+    remote_buf_free(&req);
+    remote_buf_free(&resp);
+    return res;
+  }
+
+  void buffer_data(uint64_t wsid, uint64_t offset, const void *data,
+                   uint32_t len, uint32_t claimed_len) {
+    remote_buf req;
+
+    remote_buf_init(&req);
+    remote_put_u64(&req, handle_id_);
+    remote_put_u64(&req, wsid);
+    remote_put_u64(&req, offset);
+    remote_put_u32(&req, claimed_len);
+    remote_put_bytes(&req, data, len);
+    send(REMOTE_OP_BUFFER_DATA, REMOTE_F_POSTED, req);
+    remote_buf_free(&req);
+  }
+
+  void write_mmio(uint64_t offset, uint64_t value) {
+    remote_buf req;
+
+    remote_buf_init(&req);
+    remote_put_u64(&req, handle_id_);
+    remote_put_u32(&req, 0);
+    remote_put_u64(&req, offset);
+    remote_put_u64(&req, value);
+    send(REMOTE_OP_WRITE_MMIO32, REMOTE_F_POSTED, req);
+    remote_buf_free(&req);
+  }
+
+  fpga_result read_mmio(uint64_t offset, uint64_t *value) {
+    remote_buf req, resp;
+    remote_reader r;
+
+    remote_buf_init(&req);
+    remote_buf_init(&resp);
+    remote_put_u64(&req, handle_id_);
+    remote_put_u32(&req, 0);
+    remote_put_u64(&req, offset);
+
+    fpga_result res = call(REMOTE_OP_READ_MMIO64, req, &resp);
+    if (res == FPGA_OK) {
+      remote_reader_init(&r, resp.data, resp.len);
+      *value = remote_get_u64(&r);
+    }
+
+    remote_buf_free(&req);
+    remote_buf_free(&resp);
+    return res;
+  }
+
+  // Copy HE_LPBK_LINES cache lines from src to dst, as in he_lpbk.
+  void start_lpbk(uint64_t dsm_io, uint64_t src_io, uint64_t dst_io) {
+    write_mmio(0x138, 0);
+    write_mmio(0x138, 1);
+    write_mmio(0x110, (uint32_t)(dsm_io / 64));
+    write_mmio(0x114, (uint32_t)((dsm_io / 64) >> 32));
+    write_mmio(0x120, src_io / 64);
+    write_mmio(0x128, dst_io / 64);
+    write_mmio(0x130, HE_LPBK_LINES - 1);
+    write_mmio(0x140, 0);
+    write_mmio(0x138, 3);
+  }
+
+  int sock_;
+  uint32_t next_seq_;
+  fpga_result posted_result_;
+  uint32_t data_msgs_;
+  uint64_t token_id_;
+  uint64_t handle_id_;
+  remote_buf in_;
+  std::map<uint64_t, std::vector<uint8_t>> mirrors_;
+};
+
+/**
+ * @test       hello_first
+ * @brief      Test: session_dispatch
+ * @details    A request before HELLO is refused, and the session
+ *             drops the connection. A second HELLO is rejected.<br>
+ */
+TEST_F(fpgaremoted_session_c_p, hello_first) {
+  start(true);
+  EXPECT_EQ(call(REMOTE_OP_ENUMERATE), FPGA_NO_ACCESS);
+  EXPECT_TRUE(disconnected());
+
+  start(true);
+  EXPECT_EQ(hello(0), FPGA_OK);
+  EXPECT_EQ(hello(0), FPGA_INVALID_PARAM);
+  EXPECT_EQ(call(REMOTE_OP_ENUMERATE), FPGA_OK);
+}
+
+/**
+ * @test       hello_token
+ * @brief      Test: op_hello
+ * @details    With a token configured, a TCP client must present it
+ *             and is dropped when it does not. UNIX clients, admitted
+ *             by their credentials, need none.<br>
+ */
+TEST_F(fpgaremoted_session_c_p, hello_token) {
+  memcpy(remoted_config.token, "sekrit", 6);
+  remoted_config.token_len = 6;
+
+  start(false);
+  EXPECT_EQ(hello(0, "sekrix"), FPGA_NO_ACCESS);
+  EXPECT_TRUE(disconnected());
+
+  start(false);
+  EXPECT_EQ(hello(0), FPGA_NO_ACCESS);
+
+  start(false);
+  EXPECT_EQ(hello(0, "sekrit"), FPGA_OK);
+  EXPECT_EQ(call(REMOTE_OP_ENUMERATE), FPGA_OK);
+
+  start(true);
+  EXPECT_EQ(hello(0), FPGA_OK);
+}
+
+/**
+ * @test       buffer_data_bounds
+ * @brief      Test: op_buffer_data
+ * @details    Data that would land outside the buffer, or that is
+ *             shorter than its stated length, is rejected; what fits
+ *             is accepted.<br>
+ */
+TEST_F(fpgaremoted_session_c_p, buffer_data_bounds) {
+  uint8_t data[16];
+  uint64_t wsid = 0, iova = 0, value = 0;
+
+  memset(data, 0xa5, sizeof(data));
+
+  start(true);
+  ASSERT_EQ(hello(0), FPGA_OK);
+  open_lpbk();
+  ASSERT_EQ(prepare(4096, false, &wsid, &iova), FPGA_OK);
+
+  struct { uint64_t wsid, offset; uint32_t len, claimed; } bad[] = {
+    { wsid, 4096, 8, 8 },
+    { wsid, 4088, 16, 16 },
+    { wsid, UINT64_MAX - 3, 8, 8 },
+    { wsid, 0, 8, 1000 },
+    { wsid + 1, 0, 8, 8 },
+  };
+
+  for (auto &b : bad) {
+    posted_result_ = FPGA_OK;
+    buffer_data(b.wsid, b.offset, data, b.len, b.claimed);
+    EXPECT_EQ(read_mmio(0x170, &value), FPGA_OK);
+    EXPECT_EQ(posted_result_, FPGA_INVALID_PARAM) << "offset " << b.offset;
+  }
+
+  posted_result_ = FPGA_OK;
+  buffer_data(wsid, 4088, data, 8, 8);
+  EXPECT_EQ(read_mmio(0x170, &value), FPGA_OK);
+  EXPECT_EQ(posted_result_, FPGA_OK);
+}
+
+/**
+ * @test       limits
+ * @brief      Test: op_mmio_batch, remote_recv
+ * @details    A batch of no accesses, of more than REMOTE_BATCH_MAX,
+ *             or shorter than its count is rejected. A message longer
+ *             than REMOTE_MSG_MAX ends the session.<br>
+ */
+TEST_F(fpgaremoted_session_c_p, limits) {
+  remote_buf req, resp;
+  uint8_t raw[REMOTE_HDR_SIZE];
+
+  remote_buf_init(&req);
+  remote_buf_init(&resp);
+
+  start(true);
+  ASSERT_EQ(hello(0), FPGA_OK);
+  open_lpbk();
+
+  for (uint32_t count : { 0u, (uint32_t)REMOTE_BATCH_MAX + 1, 2u }) {
+    req.len = 0;
+    remote_put_u64(&req, handle_id_);
+    remote_put_u32(&req, count);
+    remote_put_u32(&req, 0);
+    remote_put_u32(&req, 64);
+    remote_put_u64(&req, 0x170);
+    EXPECT_EQ(call(REMOTE_OP_READ_MMIO_BATCH, req, &resp),
+              FPGA_INVALID_PARAM) << "count " << count;
+  }
+
+  remote_put_u32(&req, 0);
+  remote_put_u32(&req, 64);
+  remote_put_u64(&req, 0x178);
+  EXPECT_EQ(call(REMOTE_OP_READ_MMIO_BATCH, req, &resp), FPGA_OK);
+  EXPECT_EQ(resp.len, 16u);
+
+  // Only the header of a message too long to accept.
+  req.len = 0;
+  remote_put_u32(&req, REMOTE_MSG_MAX + 1);
+  remote_put_u16(&req, REMOTE_OP_READ_MMIO64);
+  remote_put_u16(&req, 0);
+  remote_put_u32(&req, ++next_seq_);
+  remote_put_u32(&req, 0);
+  ASSERT_EQ(req.len, sizeof(raw));
+  EXPECT_EQ(remote_send(sock_, req.data, req.len, -1), 0);
+  EXPECT_TRUE(disconnected());
+
+  remote_buf_free(&req);
+  remote_buf_free(&resp);
+}
+
+/**
+ * @test       shm
+ * @brief      Test: op_prepare_buffer
+ * @details    In shared mode each buffer comes with a memfd, which the
+ *             client maps to see the AFU's writes directly; no buffer
+ *             data is sent.<br>
+ */
+TEST_F(fpgaremoted_session_c_p, shm) {
+  const uint64_t len = HE_LPBK_LINES * 64;
+  uint64_t wsid[3], io[3], map_len[3];
+  uint8_t *virt[3];
+  int fd[3];
+  uint32_t caps = 0;
+  uint64_t value = 0;
+  struct stat st;
+
+  start(true);
+  ASSERT_EQ(hello(REMOTE_CAP_SHM, "", &caps), FPGA_OK);
+  ASSERT_EQ(caps & REMOTE_CAP_SHM, (uint32_t)REMOTE_CAP_SHM);
+  open_lpbk();
+
+  for (int i = 0; i < 3; ++i) {
+    fd[i] = -1;
+    ASSERT_EQ(prepare(len, true, &wsid[i], &io[i], &fd[i], &map_len[i]),
+              FPGA_OK);
+    ASSERT_GE(fd[i], 0);
+    ASSERT_EQ(fstat(fd[i], &st), 0);
+    EXPECT_GE(map_len[i], len);
+    EXPECT_EQ((uint64_t)st.st_size, map_len[i]);
+    virt[i] = (uint8_t *)mmap(nullptr, map_len[i], PROT_READ | PROT_WRITE,
+                              MAP_SHARED, fd[i], 0);
+    ASSERT_NE(virt[i], MAP_FAILED);
+    close(fd[i]);
+  }
+
+  for (uint64_t i = 0; i < len; ++i)
+    virt[1][i] = (uint8_t)(i + 1);
+
+  start_lpbk(io[0], io[1], io[2]);
+
+  volatile uint64_t *status = (volatile uint64_t *)virt[0];
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (!(*status & 1) && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::yield();
+
+  ASSERT_TRUE(*status & 1);
+  EXPECT_EQ(memcmp(virt[1], virt[2], len), 0);
+  EXPECT_EQ(read_mmio(0x170, &value), FPGA_OK);
+  EXPECT_EQ(value, 0u);
+  EXPECT_EQ(data_msgs_, 0u);
+  EXPECT_EQ(posted_result_, FPGA_OK);
+
+  for (int i = 0; i < 3; ++i)
+    munmap(virt[i], map_len[i]);
+}
+
+/**
+ * @test       shm_local_only
+ * @brief      Test: op_hello, op_prepare_buffer
+ * @details    Shared buffers are refused to TCP clients and when the
+ *             daemon runs with --no-shm.<br>
+ */
+TEST_F(fpgaremoted_session_c_p, shm_local_only) {
+  uint64_t wsid = 0, iova = 0;
+  uint32_t caps = REMOTE_CAP_SHM;
+
+  remoted_config.tcp_insecure = true;
+  start(false);
+  ASSERT_EQ(hello(REMOTE_CAP_SHM, "", &caps), FPGA_OK);
+  EXPECT_EQ(caps, 0u);
+  open_lpbk();
+  EXPECT_EQ(prepare(4096, true, &wsid, &iova), FPGA_INVALID_PARAM);
+
+  remoted_config.shm = false;
+  caps = REMOTE_CAP_SHM;
+  start(true);
+  ASSERT_EQ(hello(REMOTE_CAP_SHM, "", &caps), FPGA_OK);
+  EXPECT_EQ(caps, 0u);
+}
+
+/**
+ * @test       copy_round_trip
+ * @brief      Test: op_buffer_data, session_request
+ * @details    Data the client sends reaches the AFU, and what the AFU
+ *             writes comes back ahead of the answer to an MMIO read,
+ *             but not ahead of answers that do not look for it.<br>
+ */
+TEST_F(fpgaremoted_session_c_p, copy_round_trip) {
+  const uint64_t len = HE_LPBK_LINES * 64;
+  uint64_t dsm_wsid = 0, src_wsid = 0, dst_wsid = 0;
+  uint64_t dsm_io = 0, src_io = 0, dst_io = 0;
+  std::vector<uint8_t> pattern(len);
+  remote_buf req;
+  uint64_t value = 0;
+
+  start(true);
+  ASSERT_EQ(hello(0), FPGA_OK);
+  open_lpbk();
+  ASSERT_EQ(prepare(4096, false, &dsm_wsid, &dsm_io), FPGA_OK);
+  ASSERT_EQ(prepare(len, false, &src_wsid, &src_io), FPGA_OK);
+  ASSERT_EQ(prepare(len, false, &dst_wsid, &dst_io), FPGA_OK);
+
+  for (uint64_t i = 0; i < len; ++i)
+    pattern[i] = (uint8_t)(i + 1);
+  buffer_data(src_wsid, 0, pattern.data(), len, len);
+
+  start_lpbk(dsm_io, src_io, dst_io);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  remote_buf_init(&req);
+  remote_put_u64(&req, token_id_);
+  EXPECT_EQ(call(REMOTE_OP_GET_PROPERTIES, req), FPGA_OK);
+  EXPECT_EQ(data_msgs_, 0u);
+  remote_buf_free(&req);
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  uint64_t status = 0;
+  while (!(status & 1) && std::chrono::steady_clock::now() < deadline) {
+    ASSERT_EQ(read_mmio(0x170, &value), FPGA_OK);
+    memcpy(&status, mirrors_[dsm_wsid].data(), sizeof(status));
+  }
+
+  ASSERT_TRUE(status & 1);
+  EXPECT_EQ(status >> 32, 0u);
+  EXPECT_GT(data_msgs_, 0u);
+  EXPECT_EQ(mirrors_[dst_wsid], pattern);
+  EXPECT_EQ(posted_result_, FPGA_OK);
+}
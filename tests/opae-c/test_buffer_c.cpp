@@ -98,6 +98,26 @@ TEST_P(buffer_c_p, ioaddr) {
   EXPECT_EQ(fpgaReleaseBuffer(accel_, wsid), FPGA_OK);
 }
 
+/**
+ * @test       numa_node
+ * @brief      Test: fpgaGetBufferNumaNode
+ * @details    When called with a valid wsid,<br>
+ *             fpgaGetBufferNumaNode retrieves the node backing the<br>
+ *             buffer, or -1 when it is unknown, and returns FPGA_OK.<br>
+ */
+TEST_P(buffer_c_p, numa_node) {
+  void *buf_addr = nullptr;
+  uint64_t wsid = 0;
+  int node = -2;
+  ASSERT_EQ(fpgaPrepareBuffer(accel_, (uint64_t) pg_size_,
+                              &buf_addr, &wsid, 0), FPGA_OK);
+  EXPECT_EQ(fpgaGetBufferNumaNode(accel_, wsid, &node), FPGA_OK);
+  EXPECT_GE(node, -1);
+  EXPECT_EQ(fpgaGetBufferNumaNode(accel_, wsid, NULL), FPGA_INVALID_PARAM);
+  EXPECT_EQ(fpgaGetBufferNumaNode(NULL, wsid, &node), FPGA_INVALID_PARAM);
+  EXPECT_EQ(fpgaReleaseBuffer(accel_, wsid), FPGA_OK);
+}
+
 /**
  * @test       fpgaGetIOAddress
  * @brief      Test: fpgaGetIOAddress_neg_test
@@ -737,6 +737,20 @@ TEST_P(enum_c_p, num_interrupts) {
   EXPECT_EQ(matches_, 0);
 }
 
+TEST_P(enum_c_p, refresh) {
+  uint32_t cached = 0;
+
+  EXPECT_EQ(fpgaEnumerate(nullptr, 0, nullptr, 0, &cached), FPGA_OK);
+
+  EXPECT_EQ(fpgaEnumerateRefresh(), FPGA_OK);
+
+  matches_ = 0;
+  EXPECT_EQ(fpgaEnumerate(nullptr, 0,
+                          tokens_.data(), tokens_.size(),
+                          &matches_), FPGA_OK);
+  EXPECT_EQ(matches_, cached);
+}
+
 TEST(wrapper, validate) {
   EXPECT_EQ(NULL, opae_validate_wrapped_token(NULL));
   EXPECT_EQ(NULL, opae_validate_wrapped_handle(NULL));
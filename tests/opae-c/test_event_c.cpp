@@ -28,6 +28,7 @@
 #endif // HAVE_CONFIG_H
 
 #include <poll.h>
+#include <unistd.h>
 #include "mock/opae_fpgad_fixtures.h"
 
 using namespace opae::testing;
@@ -196,6 +197,83 @@ TEST_P(event_c_p, destroy_err) {
                                 event_handle_), FPGA_OK);
 }
 
+/**
+ * @test       wait_events_err
+ * @brief      Test: fpgaWaitEvents, fpgaWaitEventsHybrid
+ * @details    When fpgaWaitEvents is called with a NULL pointer,<br>
+ *             zero events, an unregistered event handle, or the<br>
+ *             same event handle twice,<br>
+ *             the fn returns FPGA_INVALID_PARAM.<br>
+ */
+TEST_P(event_c_p, wait_events_err) {
+  uint64_t counts[2] = { 0, 0 };
+  uint32_t ready = 0;
+  uint64_t done = 0;
+  fpga_event_handle events[2] = { event_handle_, event_handle_ };
+
+  EXPECT_EQ(fpgaWaitEvents(nullptr, 1, 0, counts, &ready), FPGA_INVALID_PARAM);
+  EXPECT_EQ(fpgaWaitEvents(events, 1, 0, nullptr, &ready), FPGA_INVALID_PARAM);
+  EXPECT_EQ(fpgaWaitEvents(events, 1, 0, counts, nullptr), FPGA_INVALID_PARAM);
+  EXPECT_EQ(fpgaWaitEvents(events, 0, 0, counts, &ready), FPGA_INVALID_PARAM);
+  EXPECT_EQ(fpgaWaitEventsHybrid(events, 1, 0, counts, &ready, nullptr, 0),
+            FPGA_INVALID_PARAM);
+
+  EXPECT_EQ(fpgaWaitEvents(events, 1, 0, counts, &ready), FPGA_INVALID_PARAM);
+  EXPECT_EQ(fpgaWaitEventsHybrid(events, 1, 0, counts, &ready, &done, 0),
+            FPGA_INVALID_PARAM);
+
+  EXPECT_EQ(fpgaRegisterEvent(accel_, FPGA_EVENT_ERROR,
+                              event_handle_, 0), FPGA_OK);
+  EXPECT_EQ(fpgaWaitEvents(events, 2, 0, counts, &ready), FPGA_INVALID_PARAM);
+  EXPECT_EQ(fpgaUnregisterEvent(accel_, FPGA_EVENT_ERROR,
+                                event_handle_), FPGA_OK);
+}
+
+/**
+ * @test       wait_events
+ * @brief      Test: fpgaWaitEvents, fpgaWaitEventsHybrid
+ * @details    When a registered event has not fired,<br>
+ *             fpgaWaitEvents times out with no events ready.<br>
+ *             When it has fired twice, one call consumes both<br>
+ *             and returns a count of 2.<br>
+ *             When the completion word is already set,<br>
+ *             fpgaWaitEventsHybrid returns without consuming events.<br>
+ */
+TEST_P(event_c_p, wait_events) {
+  uint64_t count = 99;
+  uint32_t ready = 99;
+  uint64_t one = 1;
+  uint64_t done = 1;
+  int fd = -1;
+
+  ASSERT_EQ(fpgaRegisterEvent(accel_, FPGA_EVENT_ERROR,
+                              event_handle_, 0), FPGA_OK);
+  ASSERT_EQ(fpgaGetOSObjectFromEventHandle(event_handle_, &fd), FPGA_OK);
+
+  EXPECT_EQ(fpgaWaitEvents(&event_handle_, 1, 0, &count, &ready), FPGA_OK);
+  EXPECT_EQ(ready, 0);
+  EXPECT_EQ(count, 0);
+
+  ASSERT_EQ(write(fd, &one, sizeof(one)), sizeof(one));
+  ASSERT_EQ(write(fd, &one, sizeof(one)), sizeof(one));
+
+  EXPECT_EQ(fpgaWaitEventsHybrid(&event_handle_, 1, 0, &count, &ready,
+                                 &done, 0), FPGA_OK);
+  EXPECT_EQ(ready, 0);
+
+  done = 0;
+  EXPECT_EQ(fpgaWaitEventsHybrid(&event_handle_, 1, 100, &count, &ready,
+                                 &done, 10), FPGA_OK);
+  EXPECT_EQ(ready, 1);
+  EXPECT_EQ(count, 2);
+
+  EXPECT_EQ(fpgaWaitEvents(&event_handle_, 1, 0, &count, &ready), FPGA_OK);
+  EXPECT_EQ(ready, 0);
+
+  EXPECT_EQ(fpgaUnregisterEvent(accel_, FPGA_EVENT_ERROR,
+                                event_handle_), FPGA_OK);
+}
+
 GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(event_c_p);
 INSTANTIATE_TEST_SUITE_P(event_c, event_c_p, 
                          ::testing::ValuesIn(test_platform::platforms({})));
@@ -27,10 +27,16 @@
 #include <config.h>
 #endif // HAVE_CONFIG_H
 
+#include <stdint.h>
+
 extern "C" {
 char *find_ase_cfg();
 void opae_init(void);
 void opae_release(void);
+int opae_async_log_start(const char *name, uint32_t rate_limit);
+void opae_async_log_stop(void);
+bool opae_async_log_running(void);
+uint64_t opae_async_log_rate_limited(void);
 
 #define HOME_CFG_PATHS 3
 const char *_ase_home_configs[HOME_CFG_PATHS] = {
@@ -163,6 +169,73 @@ TEST(init, log_file) {
   unlink("opae_log.log");
 }
 
+/**
+ * @test       log_async
+ *
+ * @brief      When LIBOPAE_LOG_ASYNC is set, then opae_init starts
+ *             the async log thread, messages are written by that
+ *             thread, and opae_release flushes them before returning.
+ */
+TEST(init, log_async) {
+  ASSERT_EQ(0, putenv((char*)"LIBOPAE_LOG=1"));
+  ASSERT_EQ(0, putenv((char*)"LIBOPAE_LOG_ASYNC=1"));
+  opae_init();
+  EXPECT_TRUE(opae_async_log_running());
+
+  testing::internal::CaptureStdout();
+  testing::internal::CaptureStderr();
+
+  OPAE_ERR("Error log.");
+  OPAE_MSG("Message log.");
+  OPAE_DBG("Debug log.");
+
+  opae_release();
+  EXPECT_FALSE(opae_async_log_running());
+
+  std::string log_stdout = testing::internal::GetCapturedStdout();
+  std::string log_stderr = testing::internal::GetCapturedStderr();
+
+  EXPECT_TRUE(log_stderr.find("Error log.") != std::string::npos);
+  EXPECT_TRUE(log_stdout.find("Message log.") != std::string::npos);
+  EXPECT_FALSE(log_stdout.find("Debug log.") != std::string::npos);
+
+  EXPECT_EQ(0, unsetenv("LIBOPAE_LOG_ASYNC"));
+  EXPECT_EQ(0, unsetenv("LIBOPAE_LOG"));
+}
+
+/**
+ * @test       log_async_rate
+ *
+ * @brief      When the async logger is given a rate limit, then
+ *             messages from a single call site beyond that limit
+ *             are counted and discarded.
+ */
+TEST(init, log_async_rate) {
+  ASSERT_EQ(0, putenv((char*)"LIBOPAE_LOG=1"));
+  opae_init();
+  uint64_t limited = opae_async_log_rate_limited();
+  ASSERT_EQ(0, opae_async_log_start("opae-log-test", 5));
+
+  testing::internal::CaptureStdout();
+  testing::internal::CaptureStderr();
+
+  for (int i = 0 ; i < 20 ; ++i) {
+    OPAE_MSG("Rate limited log %d.", i);
+  }
+
+  opae_async_log_stop();
+
+  std::string log_stdout = testing::internal::GetCapturedStdout();
+  std::string log_stderr = testing::internal::GetCapturedStderr();
+
+  EXPECT_TRUE(log_stdout.find("Rate limited log 0.") != std::string::npos);
+  EXPECT_LT(limited, opae_async_log_rate_limited());
+  EXPECT_TRUE(log_stderr.find("rate limited") != std::string::npos);
+
+  opae_release();
+  EXPECT_EQ(0, unsetenv("LIBOPAE_LOG"));
+}
+
 /**
  * @test       find_ase_cfg
  *
@@ -162,6 +162,51 @@ TEST_P(mmio_c_p, mmio32_neg_test) {
                            CSR_SCRATCHPAD0, &val_read), FPGA_INVALID_PARAM);
 }
 
+/**
+ * @test       mmio_batch
+ * @brief      Test: fpgaWriteMMIOBatch, fpgaReadMMIOBatch
+ * @details    Write two scratchpad locations with one call to<br>
+ *             fpgaWriteMMIOBatch using 64- and 32-bit accesses,<br>
+ *             then read both back with one call to fpgaReadMMIOBatch.<br>
+ *             Values written should equal values read.<br>
+ */
+TEST_P(mmio_c_p, mmio_batch) {
+  fpga_mmio_op wr[2] = {
+    { which_mmio_, 64, CSR_SCRATCHPAD0, 0xdeadbeefdecafbad },
+    { which_mmio_, 32, CSR_SCRATCHPAD0 + 8, 0xc0cac01a }
+  };
+  EXPECT_EQ(fpgaWriteMMIOBatch(accel_, wr, 2), FPGA_OK);
+
+  fpga_mmio_op rd[2] = {
+    { which_mmio_, 64, CSR_SCRATCHPAD0, 0 },
+    { which_mmio_, 32, CSR_SCRATCHPAD0 + 8, 0 }
+  };
+  EXPECT_EQ(fpgaReadMMIOBatch(accel_, rd, 2), FPGA_OK);
+  EXPECT_EQ(wr[0].value, rd[0].value);
+  EXPECT_EQ(wr[1].value, rd[1].value);
+}
+
+/**
+ * @test       mmio_batch_neg_test
+ * @brief      Test: fpgaWriteMMIOBatch, fpgaReadMMIOBatch
+ * @details    When the handle is invalid, or when an element<br>
+ *             of the batch has a width other than 32 or 64,<br>
+ *             the API returns FPGA_INVALID_PARAM. An empty batch<br>
+ *             returns FPGA_OK.<br>
+ */
+TEST_P(mmio_c_p, mmio_batch_neg_test) {
+  fpga_mmio_op op = { which_mmio_, 64, CSR_SCRATCHPAD0, 0 };
+  EXPECT_EQ(fpgaWriteMMIOBatch(NULL, &op, 1), FPGA_INVALID_PARAM);
+  EXPECT_EQ(fpgaReadMMIOBatch(NULL, &op, 1), FPGA_INVALID_PARAM);
+
+  op.width = 16;
+  EXPECT_EQ(fpgaWriteMMIOBatch(accel_, &op, 1), FPGA_INVALID_PARAM);
+  EXPECT_EQ(fpgaReadMMIOBatch(accel_, &op, 1), FPGA_INVALID_PARAM);
+
+  EXPECT_EQ(fpgaWriteMMIOBatch(accel_, nullptr, 0), FPGA_OK);
+  EXPECT_EQ(fpgaReadMMIOBatch(accel_, nullptr, 0), FPGA_OK);
+}
+
 TEST_P(mmio_c_p, fpgaMapMMIO_neg_test) {
     uint64_t *mmio_ptr = nullptr;
     EXPECT_EQ(fpgaMapMMIO(NULL, which_mmio_, &mmio_ptr), FPGA_INVALID_PARAM);
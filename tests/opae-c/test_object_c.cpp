@@ -96,6 +96,26 @@ TEST_P(object_c_p, obj_read64) {
   EXPECT_EQ(val, 1ul);
 }
 
+/**
+ * @test       obj_read_many
+ * @brief      Test: fpgaObjectReadMany
+ * @details    When fpgaObjectReadMany is called with valid params,<br>
+ *             the fn retrieves the value of each object, in order,<br>
+ *             and returns FPGA_OK. A NULL array with a non-zero<br>
+ *             count returns FPGA_INVALID_PARAM.<br>
+ */
+TEST_P(object_c_p, obj_read_many) {
+  fpga_object objs[] = { token_obj_, handle_obj_ };
+  uint64_t values[2] = { 0xbad, 0xbad };
+  EXPECT_EQ(fpgaObjectReadMany(objs, values, 2, FPGA_OBJECT_SYNC), FPGA_OK);
+  EXPECT_EQ(values[0], 1ul);
+  EXPECT_EQ(values[1], 0ul);
+
+  EXPECT_EQ(fpgaObjectReadMany(nullptr, nullptr, 0, 0), FPGA_OK);
+  EXPECT_EQ(fpgaObjectReadMany(nullptr, values, 2, 0), FPGA_INVALID_PARAM);
+  EXPECT_EQ(fpgaObjectReadMany(objs, nullptr, 2, 0), FPGA_INVALID_PARAM);
+}
+
 /**
  * @test       obj_write64
  * @brief      Test: fpgaObjectWrite64
@@ -0,0 +1,165 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <dirent.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+extern "C" {
+#include "opae_int.h"
+#include "pluginmgr.h"
+#include "cfg-file.h"
+
+int opae_plugin_mgr_read_pci_ids(int dir_fd,
+                                 const char *name,
+                                 opae_pci_device *dev);
+}
+
+#include "mock/opae_fixtures.h"
+
+using namespace opae::testing;
+
+typedef std::chrono::steady_clock bench_clock;
+
+static const char *pci_devices = "/sys/bus/pci/devices";
+
+// The detection scheme that ran in the library constructor before
+// platform detection became lazy: a path walk, fopen() and fscanf()
+// for each of the four ID attributes of each device.
+static int legacy_read_pci_id(const std::string &dev, const char *attr,
+                              uint16_t *value) {
+  std::string path = std::string(pci_devices) + "/" + dev + "/" + attr;
+  unsigned int v = 0;
+  FILE *fp = fopen(path.c_str(), "r");
+
+  if (!fp)
+    return 1;
+
+  int res = fscanf(fp, "%x", &v);
+  fclose(fp);
+
+  *value = (uint16_t)v;
+  return res == 1 ? 0 : 1;
+}
+
+// Average microseconds to read the IDs of every PCI device, and the
+// number of devices read.
+static double scan_us(bool legacy, int iterations, int *devices) {
+  double total = 0.0;
+
+  for (int i = 0 ; i < iterations ; ++i) {
+    auto start = bench_clock::now();
+
+    DIR *dir = opendir(pci_devices);
+    if (!dir)
+      return 0.0;
+
+    struct dirent *dirent;
+    *devices = 0;
+    while ((dirent = readdir(dir)) != NULL) {
+      opae_pci_device dev = { NULL, 0, 0, 0, 0 };
+
+      if (dirent->d_name[0] == '.')
+        continue;
+
+      if (legacy) {
+        std::string name(dirent->d_name);
+        EXPECT_EQ(0, legacy_read_pci_id(name, "vendor", &dev.vendor_id));
+        EXPECT_EQ(0, legacy_read_pci_id(name, "device", &dev.device_id));
+        EXPECT_EQ(0, legacy_read_pci_id(name, "subsystem_vendor",
+                                        &dev.subsystem_vendor_id));
+        EXPECT_EQ(0, legacy_read_pci_id(name, "subsystem_device",
+                                        &dev.subsystem_device_id));
+      } else {
+        EXPECT_EQ(0, opae_plugin_mgr_read_pci_ids(dirfd(dir),
+                                                  dirent->d_name, &dev));
+      }
+      ++*devices;
+    }
+
+    closedir(dir);
+    total += std::chrono::duration<double, std::micro>(
+                 bench_clock::now() - start).count();
+  }
+
+  return total / iterations;
+}
+
+/**
+ * @test       read_pci_ids
+ * @brief      Test: opae_plugin_mgr_read_pci_ids
+ * @details    Compares the time taken to read the IDs of all PCI<br>
+ *             devices with one config space read per device against<br>
+ *             the four fopen()/fscanf() calls per device used before.<br>
+ */
+TEST(pluginmgr_bench, read_pci_ids) {
+  const int iterations = 100;
+  int devices = 0;
+
+  double legacy = scan_us(true, iterations, &devices);
+  double current = scan_us(false, iterations, &devices);
+
+  std::cout << std::fixed << std::setprecision(2)
+            << devices << " PCI devices: legacy " << legacy << " us"
+            << ", config " << current << " us"
+            << " (" << legacy / current << "x)" << std::endl;
+
+  EXPECT_LT(current, legacy);
+}
+
+/**
+ * @test       defer_initialize
+ * @brief      Test: opae_plugin_mgr_defer_initialize
+ * @details    Reports the load-time cost of initialization, which<br>
+ *             is now a deferral, against that of the eager<br>
+ *             platform detection and plugin load it replaces.<br>
+ */
+TEST(pluginmgr_bench, defer_initialize) {
+  EXPECT_EQ(0, opae_plugin_mgr_finalize_all());
+
+  auto start = bench_clock::now();
+  opae_plugin_mgr_defer_initialize();
+  double deferred = std::chrono::duration<double, std::micro>(
+                        bench_clock::now() - start).count();
+  EXPECT_EQ(0, opae_plugin_mgr_finalize_all());
+
+  start = bench_clock::now();
+  opae_plugin_mgr_initialize(NULL);
+  double eager = std::chrono::duration<double, std::micro>(
+                     bench_clock::now() - start).count();
+  EXPECT_EQ(0, opae_plugin_mgr_finalize_all());
+
+  std::cout << std::fixed << std::setprecision(2)
+            << "load time: eager " << eager << " us"
+            << ", deferred " << deferred << " us" << std::endl;
+
+  EXPECT_LT(deferred, eager);
+}
@@ -45,6 +45,7 @@ int opae_plugin_mgr_configure_plugin(opae_api_adapter_table *adapter,
 int process_cfg_buffer(const char *buffer, const char *filename);
 extern opae_api_adapter_table *adapter_list;
 extern int finalizing;
+extern int initialize_deferred;
 int opae_plugin_mgr_finalize_all(void);
 }
 
@@ -106,6 +107,38 @@ TEST(pluginmgr, multi_finalize) {
   finalizing = 0;
 }
 
+static int count_adapters(const opae_api_adapter_table *adapter,
+                          void *context) {
+  UNUSED_PARAM(adapter);
+  ++*(int *)context;
+  return OPAE_ENUM_CONTINUE;
+}
+
+/**
+ * @test       defer_initialize
+ * @brief      Test: opae_plugin_mgr_defer_initialize
+ * @details    When opae_plugin_mgr_defer_initialize is called,<br>
+ *             then no platform detection is done until the next<br>
+ *             call to opae_plugin_mgr_for_each_adapter,<br>
+ *             which performs the deferred initialization.<br>
+ */
+TEST(pluginmgr, defer_initialize) {
+  int count = 0;
+
+  EXPECT_EQ(0, opae_plugin_mgr_finalize_all());
+  EXPECT_EQ(nullptr, adapter_list);
+
+  opae_plugin_mgr_defer_initialize();
+  EXPECT_EQ(1, initialize_deferred);
+  EXPECT_EQ(nullptr, adapter_list);
+
+  opae_plugin_mgr_for_each_adapter(count_adapters, &count);
+  EXPECT_EQ(0, initialize_deferred);
+
+  EXPECT_EQ(0, opae_plugin_mgr_finalize_all());
+  EXPECT_EQ(0, initialize_deferred);
+}
+
 extern "C" {
 
 static int test_plugin_initialize_called;
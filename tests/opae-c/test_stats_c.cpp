@@ -0,0 +1,376 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <limits.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "mock/opae_fixtures.h"
+#include "cfg-file.h"
+#include "stats.h"
+
+extern "C" {
+void parse_stats_config(json_object *root);
+}
+
+using namespace opae::testing;
+
+class stats_c : public ::testing::Test {
+ protected:
+  virtual void SetUp() override {
+    strcpy(tmpfile_, "stats-XXXXXX.json");
+    close(mkstemps(tmpfile_, 5));
+  }
+
+  virtual void TearDown() override {
+    opae_stats_stop();
+    unlink(tmpfile_);
+  }
+
+  std::string read_dump() {
+    std::ifstream in(tmpfile_);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+  }
+
+  static size_t count(const std::string &s, const std::string &what) {
+    size_t n = 0;
+    for (size_t pos = s.find(what); pos != std::string::npos;
+         pos = s.find(what, pos + 1))
+      ++n;
+    return n;
+  }
+
+  char tmpfile_[32];
+};
+
+/**
+ * @test       bucket
+ * @brief      Test: opae_stats_bucket, opae_stats_bucket_min
+ * @details    Each latency falls in a bucket whose lowest value is at
+ *             most the latency, and whose next bucket starts above it.
+ *             Buckets are no wider than 1/8 of their lowest value.<br>
+ */
+TEST(stats, bucket) {
+  unsigned prev = 0;
+
+  for (uint64_t ns = 0; ns < (1ULL << OPAE_STATS_MAX_BITS);
+       ns = ns < 64 ? ns + 1 : ns + ns / 7) {
+    unsigned b = opae_stats_bucket(ns);
+
+    ASSERT_LT(b, (unsigned)OPAE_STATS_BUCKETS - 1);
+    EXPECT_GE(b, prev);
+    EXPECT_LE(opae_stats_bucket_min(b), ns);
+    EXPECT_GT(opae_stats_bucket_min(b + 1), ns);
+    if (ns >= OPAE_STATS_SUB_BUCKETS) {
+      EXPECT_LE(opae_stats_bucket_min(b + 1) - opae_stats_bucket_min(b),
+                opae_stats_bucket_min(b) / OPAE_STATS_SUB_BUCKETS);
+    }
+    prev = b;
+  }
+
+  EXPECT_EQ((unsigned)OPAE_STATS_BUCKETS - 1,
+            opae_stats_bucket(1ULL << OPAE_STATS_MAX_BITS));
+  EXPECT_EQ((unsigned)OPAE_STATS_BUCKETS - 1, opae_stats_bucket(UINT64_MAX));
+}
+
+/**
+ * @test       percentile
+ * @brief      Test: opae_stats_percentile
+ * @details    Percentiles are the top of the bucket that holds them,
+ *             clamped to the lowest and highest latency seen.<br>
+ */
+TEST(stats, percentile) {
+  opae_api_counters c;
+
+  memset(&c, 0, sizeof(c));
+  EXPECT_EQ(0, opae_stats_percentile(&c, 0.5));
+
+  c.calls = 100;
+  c.min_ns = 1000;
+  c.max_ns = 100000;
+  c.hist[opae_stats_bucket(1000)] = 90;
+  c.hist[opae_stats_bucket(100000)] = 10;
+
+  unsigned b = opae_stats_bucket(1000);
+  EXPECT_EQ(opae_stats_bucket_min(b + 1) - 1, opae_stats_percentile(&c, 0.5));
+  EXPECT_EQ(opae_stats_bucket_min(b + 1) - 1, opae_stats_percentile(&c, 0.9));
+  EXPECT_EQ(100000, opae_stats_percentile(&c, 0.99));
+  EXPECT_EQ(100000, opae_stats_percentile(&c, 0.999));
+}
+
+/**
+ * @test       parse_signal
+ * @brief      Test: opae_stats_parse_signal
+ * @details    Signals may be given by number or by name, with or
+ *             without the SIG prefix. Anything else gives 0.<br>
+ */
+TEST(stats, parse_signal) {
+  EXPECT_EQ(SIGUSR2, opae_stats_parse_signal("SIGUSR2"));
+  EXPECT_EQ(SIGUSR1, opae_stats_parse_signal("USR1"));
+  EXPECT_EQ(SIGHUP, opae_stats_parse_signal("sighup"));
+  EXPECT_EQ(SIGUSR2, opae_stats_parse_signal(std::to_string(SIGUSR2).c_str()));
+  EXPECT_EQ(0, opae_stats_parse_signal("SIGKILL"));
+  EXPECT_EQ(0, opae_stats_parse_signal("bogus"));
+  EXPECT_EQ(0, opae_stats_parse_signal("0"));
+  EXPECT_EQ(0, opae_stats_parse_signal(""));
+}
+
+/**
+ * @test       default_file
+ * @brief      Test: opae_stats_default_file
+ * @details    Signal dumps default to $XDG_RUNTIME_DIR, else to<br>
+ *             /tmp for anyone but root, who gets no default.<br>
+ */
+TEST(stats, default_file) {
+  char path[PATH_MAX];
+  const char *xdg = getenv("XDG_RUNTIME_DIR");
+  std::string saved = xdg ? xdg : "";
+
+  setenv("XDG_RUNTIME_DIR", "/run/user/1000", 1);
+  ASSERT_EQ(0, opae_stats_default_file(path, sizeof(path)));
+  EXPECT_STREQ("/run/user/1000/" OPAE_STATS_DEFAULT_NAME, path);
+  EXPECT_NE(0, opae_stats_default_file(path, 8));
+
+  unsetenv("XDG_RUNTIME_DIR");
+  if (geteuid()) {
+    ASSERT_EQ(0, opae_stats_default_file(path, sizeof(path)));
+    EXPECT_STREQ("/tmp/" OPAE_STATS_DEFAULT_NAME, path);
+  } else {
+    EXPECT_NE(0, opae_stats_default_file(path, sizeof(path)));
+  }
+
+  if (xdg)
+    setenv("XDG_RUNTIME_DIR", saved.c_str(), 1);
+}
+
+/**
+ * @test       disabled
+ * @brief      Test: opae_stats_plugin, fpgaGetStats, fpgaResetStats
+ * @details    When statistics are off, no scope is created,<br>
+ *             and the public API returns FPGA_NOT_SUPPORTED.<br>
+ */
+TEST_F(stats_c, disabled) {
+  uint32_t num = 0;
+
+  EXPECT_FALSE(opae_stats_enabled);
+  EXPECT_EQ(nullptr, opae_stats_plugin("libfoo.so"));
+  EXPECT_EQ(FPGA_NOT_SUPPORTED, fpgaGetStats(NULL, NULL, 0, &num));
+  EXPECT_EQ(FPGA_NOT_SUPPORTED, fpgaResetStats(NULL));
+  EXPECT_EQ(FPGA_INVALID_PARAM, fpgaGetStats(NULL, NULL, 0, NULL));
+}
+
+/**
+ * @test       record
+ * @brief      Test: opae_stats_record, opae_stats_sum, fpgaGetStats
+ * @details    Calls and errors are counted against both the plugin<br>
+ *             and the handle scope, and reported by fpgaGetStats.<br>
+ */
+TEST_F(stats_c, record) {
+  fpga_token_header hdr;
+  opae_api_counters c;
+  fpga_api_stats out[4];
+  uint32_t num = 0;
+
+  ASSERT_EQ(0, opae_stats_start(NULL, 0));
+  opae_stats *plugin = opae_stats_plugin("libfoo.so");
+  ASSERT_NE(nullptr, plugin);
+  EXPECT_EQ(plugin, opae_stats_plugin("libfoo.so"));
+
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.bus = 0x5e;
+  opae_stats *handle = opae_stats_handle(plugin, &hdr);
+  ASSERT_NE(nullptr, handle);
+  EXPECT_STREQ("0000:5e:00.0", handle->name);
+
+  for (int i = 0; i < 10; ++i)
+    opae_stats_record(plugin, handle, OPAE_STATS_fpgaReadMMIO64,
+                      i < 2 ? FPGA_EXCEPTION : FPGA_OK,
+                      opae_stats_now() - 1000);
+  opae_stats_record(plugin, NULL, OPAE_STATS_fpgaEnumerate, FPGA_OK,
+                    opae_stats_now());
+
+  ASSERT_TRUE(opae_stats_sum(handle, OPAE_STATS_fpgaReadMMIO64, &c));
+  EXPECT_EQ(10, c.calls);
+  EXPECT_EQ(2, c.errors);
+  EXPECT_GE(c.min_ns, 1000);
+  EXPECT_GE(c.max_ns, c.min_ns);
+  EXPECT_GE(c.total_ns, 10 * c.min_ns);
+  EXPECT_FALSE(opae_stats_sum(handle, OPAE_STATS_fpgaEnumerate, &c));
+  EXPECT_TRUE(opae_stats_sum(NULL, OPAE_STATS_fpgaEnumerate, &c));
+
+  EXPECT_EQ(FPGA_OK, fpgaGetStats(NULL, NULL, 0, &num));
+  EXPECT_EQ(2, num);
+  EXPECT_EQ(FPGA_OK, fpgaGetStats(NULL, out, 4, &num));
+  ASSERT_EQ(2, num);
+  EXPECT_STREQ("fpgaReadMMIO64", out[0].api);
+  EXPECT_EQ(10, out[0].calls);
+  EXPECT_EQ(2, out[0].errors);
+  EXPECT_LE(out[0].min_ns, out[0].p50_ns);
+  EXPECT_LE(out[0].p50_ns, out[0].p999_ns);
+  EXPECT_LE(out[0].p999_ns, out[0].max_ns);
+  EXPECT_STREQ("fpgaEnumerate", out[1].api);
+  EXPECT_EQ(1, out[1].calls);
+
+  EXPECT_EQ(FPGA_OK, fpgaResetStats(NULL));
+  EXPECT_FALSE(opae_stats_sum(handle, OPAE_STATS_fpgaReadMMIO64, &c));
+  EXPECT_EQ(FPGA_OK, fpgaGetStats(NULL, NULL, 0, &num));
+  EXPECT_EQ(0, num);
+}
+
+/**
+ * @test       dump
+ * @brief      Test: opae_stats_dump, opae_stats_stop
+ * @details    The dump lists each scope and API called,<br>
+ *             and opae_stats_stop() writes it to the dump file.<br>
+ */
+TEST_F(stats_c, dump) {
+  fpga_token_header hdr;
+
+  ASSERT_EQ(0, opae_stats_start(tmpfile_, 0));
+  opae_stats *plugin = opae_stats_plugin("libfoo.so");
+  memset(&hdr, 0, sizeof(hdr));
+  opae_stats *handle = opae_stats_handle(plugin, &hdr);
+
+  opae_stats_record(plugin, handle, OPAE_STATS_fpgaOpen, FPGA_OK,
+                    opae_stats_now());
+  opae_stats_handle_closed(handle);
+
+  ASSERT_EQ(0, opae_stats_dump(tmpfile_));
+  std::string dump = read_dump();
+  EXPECT_EQ(2, count(dump, "\"api\": \"fpgaOpen\""));
+  EXPECT_EQ(1, count(dump, "\"name\": \"libfoo.so\""));
+  EXPECT_EQ(1, count(dump, "\"device\": \"0000:00:00.0\""));
+  EXPECT_EQ(1, count(dump, "\"open\": false"));
+
+  unlink(tmpfile_);
+  opae_stats_stop();
+  EXPECT_FALSE(opae_stats_enabled);
+  EXPECT_EQ(2, count(read_dump(), "\"api\": \"fpgaOpen\""));
+}
+
+/**
+ * @test       dump_symlink
+ * @brief      Test: opae_stats_dump
+ * @details    A symlink at the dump file is replaced,<br>
+ *             and the file it points to is left alone.<br>
+ */
+TEST_F(stats_c, dump_symlink) {
+  char victim[32];
+  struct stat st;
+
+  strcpy(victim, "victim-XXXXXX");
+  close(mkstemp(victim));
+  unlink(tmpfile_);
+  ASSERT_EQ(0, symlink(victim, tmpfile_));
+
+  ASSERT_EQ(0, opae_stats_start(NULL, 0));
+  ASSERT_EQ(0, opae_stats_dump(tmpfile_));
+
+  ASSERT_EQ(0, stat(victim, &st));
+  EXPECT_EQ(0, st.st_size);
+  ASSERT_EQ(0, lstat(tmpfile_, &st));
+  EXPECT_TRUE(S_ISREG(st.st_mode));
+  EXPECT_EQ(0600, st.st_mode & 0777);
+  EXPECT_EQ(1, count(read_dump(), "\"pid\""));
+
+  unlink(victim);
+}
+
+/**
+ * @test       closed_handles
+ * @brief      Test: opae_stats_handle_closed
+ * @details    No more than OPAE_STATS_MAX_CLOSED closed handles<br>
+ *             are kept; open ones are all kept.<br>
+ */
+TEST_F(stats_c, closed_handles) {
+  fpga_token_header hdr;
+
+  ASSERT_EQ(0, opae_stats_start(NULL, 0));
+  memset(&hdr, 0, sizeof(hdr));
+
+  opae_stats *first = opae_stats_handle(NULL, &hdr);
+  for (int i = 0; i < 2 * OPAE_STATS_MAX_CLOSED; ++i)
+    opae_stats_handle_closed(opae_stats_handle(NULL, &hdr));
+
+  ASSERT_EQ(0, opae_stats_dump(tmpfile_));
+  std::string dump = read_dump();
+  EXPECT_EQ(OPAE_STATS_MAX_CLOSED, count(dump, "\"open\": false"));
+  EXPECT_EQ(1, count(dump, "\"open\": true"));
+  EXPECT_TRUE(first->open);
+}
+
+/**
+ * @test       signal
+ * @brief      Test: opae_stats_start
+ * @details    When a signal is given, the statistics are dumped<br>
+ *             each time the process receives it.<br>
+ */
+TEST_F(stats_c, signal) {
+  unlink(tmpfile_);
+  ASSERT_EQ(0, opae_stats_start(tmpfile_, SIGUSR2));
+  opae_stats_record(opae_stats_plugin("libfoo.so"), NULL,
+                    OPAE_STATS_fpgaClose, FPGA_OK, opae_stats_now());
+
+  ASSERT_EQ(0, kill(getpid(), SIGUSR2));
+  for (int i = 0; i < 200 && access(tmpfile_, F_OK); ++i)
+    usleep(10000);
+  EXPECT_EQ(1, count(read_dump(), "\"api\": \"fpgaClose\""));
+}
+
+/**
+ * @test       config
+ * @brief      Test: parse_stats_config
+ * @details    A "stats" section with "enabled": true turns<br>
+ *             statistics on; without it they stay off.<br>
+ */
+TEST_F(stats_c, config) {
+  json_object *root = json_tokener_parse(
+      "{ \"stats\": { \"enabled\": false, \"file\": \"x.json\" } }");
+  parse_stats_config(root);
+  json_object_put(root);
+  EXPECT_FALSE(opae_stats_enabled);
+
+  std::string cfg = std::string("{ \"stats\": { \"enabled\": true, "
+                                "\"file\": \"") + tmpfile_ + "\" } }";
+  root = json_tokener_parse(cfg.c_str());
+  parse_stats_config(root);
+  json_object_put(root);
+  EXPECT_TRUE(opae_stats_enabled);
+
+  unlink(tmpfile_);
+  opae_stats_stop();
+  EXPECT_EQ(0, access(tmpfile_, F_OK));
+}
@@ -0,0 +1,548 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <opae/fpga.h>
+
+extern "C" {
+#include "opae_remote.h"
+#include "props.h"
+
+fpga_result remote_fpgaOpen(fpga_token token, fpga_handle *handle, int flags);
+fpga_result remote_fpgaClose(fpga_handle handle);
+fpga_result remote_fpgaEnumerate(const fpga_properties *filters,
+                                 uint32_t num_filters, fpga_token *tokens,
+                                 uint32_t max_tokens, uint32_t *num_matches);
+fpga_result remote_fpgaDestroyToken(fpga_token *token);
+fpga_result remote_fpgaGetProperties(fpga_token token, fpga_properties *prop);
+fpga_result remote_fpgaReadMMIO64(fpga_handle handle, uint32_t mmio_num,
+                                  uint64_t offset, uint64_t *value);
+fpga_result remote_fpgaWriteMMIO64(fpga_handle handle, uint32_t mmio_num,
+                                   uint64_t offset, uint64_t value);
+fpga_result remote_fpgaReadMMIOBatch(fpga_handle handle, fpga_mmio_op *ops,
+                                     uint32_t num_ops);
+}
+
+/**
+ * @test       put_get
+ * @brief      Test: remote_put_*, remote_get_*
+ * @details    Values written to a remote_buf are read back in order,
+ *             little endian, and reading past the end sets err.<br>
+ */
+TEST(opae_remote_c, put_get) {
+  remote_buf b;
+  remote_reader r;
+
+  remote_buf_init(&b);
+  remote_put_u8(&b, 0x12);
+  remote_put_u16(&b, 0x3456);
+  remote_put_u32(&b, 0x789abcde);
+  remote_put_u64(&b, 0x0123456789abcdefULL);
+  remote_put_bytes(&b, "opae", 4);
+  ASSERT_EQ(b.err, 0);
+  ASSERT_EQ(b.len, 19u);
+  EXPECT_EQ(b.data[1], 0x56);
+
+  remote_reader_init(&r, b.data, b.len);
+  EXPECT_EQ(remote_get_u8(&r), 0x12);
+  EXPECT_EQ(remote_get_u16(&r), 0x3456);
+  EXPECT_EQ(remote_get_u32(&r), 0x789abcdeu);
+  EXPECT_EQ(remote_get_u64(&r), 0x0123456789abcdefULL);
+  EXPECT_EQ(memcmp(remote_get_bytes(&r, 4), "opae", 4), 0);
+  EXPECT_EQ(r.err, 0);
+
+  EXPECT_EQ(remote_get_u32(&r), 0u);
+  EXPECT_NE(r.err, 0);
+
+  remote_buf_free(&b);
+}
+
+/**
+ * @test       msg_hdr
+ * @brief      Test: remote_msg_begin, remote_msg_end
+ * @details    The header of a message records its payload length,
+ *             which remote_decode_hdr recovers.<br>
+ */
+TEST(opae_remote_c, msg_hdr) {
+  remote_buf b;
+  remote_msg_hdr h;
+  size_t off;
+
+  remote_buf_init(&b);
+  off = remote_msg_begin(&b, REMOTE_OP_OPEN, REMOTE_F_POSTED, 7,
+                         FPGA_BUSY);
+  remote_put_u64(&b, 42);
+  remote_msg_end(&b, off);
+  ASSERT_EQ(b.len, (size_t)REMOTE_HDR_SIZE + 8);
+
+  remote_decode_hdr(b.data, &h);
+  EXPECT_EQ(h.len, 8u);
+  EXPECT_EQ(h.op, REMOTE_OP_OPEN);
+  EXPECT_EQ(h.flags, REMOTE_F_POSTED);
+  EXPECT_EQ(h.seq, 7u);
+  EXPECT_EQ(h.result, FPGA_BUSY);
+
+  remote_buf_free(&b);
+}
+
+/**
+ * @test       props
+ * @brief      Test: remote_put_props, remote_get_props
+ * @details    The properties of an accelerator survive an encode
+ *             and decode round trip.<br>
+ */
+TEST(opae_remote_c, props) {
+  remote_props in;
+  remote_props out;
+  remote_buf b;
+  remote_reader r;
+
+  memset(&in, 0, sizeof(in));
+  in.valid_fields = 0x1234;
+  in.guid[0] = 0x56;
+  in.guid[15] = 0xe2;
+  in.objtype = FPGA_ACCELERATOR;
+  in.segment = 1;
+  in.bus = 0x5e;
+  in.device = 2;
+  in.function = 3;
+  in.object_id = 0xf00d;
+  in.vendor_id = 0x8086;
+  in.device_id = 0xbcce;
+  in.interface = FPGA_IFC_DFL;
+  in.state = FPGA_ACCELERATOR_UNASSIGNED;
+  in.num_mmio = 2;
+  in.num_interrupts = 4;
+
+  remote_buf_init(&b);
+  remote_put_props(&b, &in);
+  remote_reader_init(&r, b.data, b.len);
+  remote_get_props(&r, &out);
+  EXPECT_EQ(r.err, 0);
+  EXPECT_EQ(r.left, 0u);
+  EXPECT_EQ(memcmp(&in, &out, sizeof(in)), 0);
+
+  remote_buf_free(&b);
+}
+
+/**
+ * @test       buffer_diff
+ * @brief      Test: remote_put_buffer_diff, remote_merge_buffer
+ * @details    Only changed pages are queued, and merging them keeps
+ *             the words the receiver changed on its own.<br>
+ */
+TEST(opae_remote_c, buffer_diff) {
+  const size_t len = 4 * 4096;
+  std::string src(len, '\0'), src_shadow(len, '\0');
+  std::string dst(len, '\0'), dst_shadow(len, '\0');
+  remote_buf b;
+  remote_reader r;
+  remote_msg_hdr h;
+
+  remote_buf_init(&b);
+  EXPECT_EQ(remote_put_buffer_diff(&b, 1, 2, (uint8_t *)&src[0],
+                                   (uint8_t *)&src_shadow[0], len), 0u);
+  EXPECT_EQ(b.len, 0u);
+
+  src[4096 + 8] = 'a';
+  src[2 * 4096] = 'b';
+  dst[4096 + 16] = 'c'; // Changed by the receiver only.
+  EXPECT_EQ(remote_put_buffer_diff(&b, 1, 2, (uint8_t *)&src[0],
+                                   (uint8_t *)&src_shadow[0], len),
+            2 * 4096u);
+  EXPECT_EQ(src, src_shadow);
+
+  ASSERT_GE(b.len, (size_t)REMOTE_HDR_SIZE);
+  remote_decode_hdr(b.data, &h);
+  EXPECT_EQ(h.op, REMOTE_OP_BUFFER_DATA);
+  EXPECT_EQ(h.flags, REMOTE_F_POSTED);
+  ASSERT_EQ(b.len, REMOTE_HDR_SIZE + h.len);
+
+  remote_reader_init(&r, b.data + REMOTE_HDR_SIZE, h.len);
+  EXPECT_EQ(remote_get_u64(&r), 1u);
+  EXPECT_EQ(remote_get_u64(&r), 2u);
+  uint64_t offset = remote_get_u64(&r);
+  uint32_t run = remote_get_u32(&r);
+  EXPECT_EQ(offset, 4096u);
+  EXPECT_EQ(run, 2 * 4096u);
+  const uint8_t *data = remote_get_bytes(&r, run);
+  ASSERT_NE(data, nullptr);
+
+  remote_merge_buffer((uint8_t *)&dst[offset], (uint8_t *)&dst_shadow[offset],
+                      data, run);
+  EXPECT_EQ(dst[4096 + 8], 'a');
+  EXPECT_EQ(dst[2 * 4096], 'b');
+  EXPECT_EQ(dst[4096 + 16], 'c');
+
+  remote_buf_free(&b);
+}
+
+/**
+ * @test       parse_config
+ * @brief      Test: remote_parse_config
+ * @details    Malformed configurations are rejected.<br>
+ */
+TEST(opae_remote_c, parse_config) {
+  EXPECT_EQ(remote_parse_config(nullptr), 0);
+  EXPECT_EQ(remote_parse_config("{\"endpoints\":[\"tcp:host:5530\"]}"), 0);
+  EXPECT_NE(remote_parse_config("{"), 0);
+  EXPECT_NE(remote_parse_config("{\"shm\":1}"), 0);
+  EXPECT_NE(remote_parse_config("{\"sync_usec\":-1}"), 0);
+  EXPECT_NE(remote_parse_config("{\"endpoints\":[1]}"), 0);
+  remote_disconnect_all();
+}
+
+/**
+ * @test       send_fd
+ * @brief      Test: remote_send, remote_recv
+ * @details    A message sent with a file descriptor is received
+ *             whole, along with a descriptor for the same file.<br>
+ */
+TEST(opae_remote_c, send_fd) {
+  int sv[2];
+  int pipefd[2];
+  int fd = -1;
+  remote_buf b;
+  remote_msg_hdr h;
+  size_t off;
+  char c = 0;
+
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+  ASSERT_EQ(pipe(pipefd), 0);
+
+  remote_buf_init(&b);
+  off = remote_msg_begin(&b, REMOTE_OP_PREPARE_BUFFER, 0, 3, 0);
+  remote_put_u64(&b, 0x1000);
+  remote_msg_end(&b, off);
+  EXPECT_EQ(remote_send(sv[0], b.data, b.len, pipefd[1]), 0);
+
+  EXPECT_EQ(remote_recv(sv[1], &h, &b, &fd), 0);
+  EXPECT_EQ(h.op, REMOTE_OP_PREPARE_BUFFER);
+  EXPECT_EQ(h.seq, 3u);
+  ASSERT_EQ(b.len, 8u);
+  ASSERT_GE(fd, 0);
+  EXPECT_EQ(write(fd, "x", 1), 1);
+  EXPECT_EQ(read(pipefd[0], &c, 1), 1);
+  EXPECT_EQ(c, 'x');
+
+  close(sv[0]);
+  EXPECT_EQ(remote_recv(sv[1], &h, &b, &fd), 1);
+
+  remote_buf_free(&b);
+  close(fd);
+  close(pipefd[0]);
+  close(pipefd[1]);
+  close(sv[1]);
+}
+
+/*
+ * A scripted stand-in for fpgaremoted, serving one accelerator whose
+ * MMIO reads return twice the offset. Each open gets a new handle id.
+ * Writes at or beyond 0x1000 fail, as a posted request.
+ */
+class opae_remote_c_p : public ::testing::Test {
+ protected:
+  opae_remote_c_p()
+  : listen_(-1), next_id_(3), token_(nullptr), handle_(nullptr) {}
+
+  virtual void SetUp() override {
+    path_ = "/tmp/opae_remote_test_" + std::to_string(getpid());
+    std::string endpoint = "unix:" + path_;
+    std::string cfg = "{\"endpoints\":[\"" + endpoint + "\"],\"shm\":false}";
+
+    unlink(path_.c_str());
+    listen_ = remote_listen(endpoint.c_str());
+    ASSERT_GE(listen_, 0);
+    server_ = std::thread(&opae_remote_c_p::serve, this);
+
+    ASSERT_EQ(remote_parse_config(cfg.c_str()), 0);
+    ASSERT_EQ(remote_connect_all(), 0);
+  }
+
+  virtual void TearDown() override {
+    if (handle_) {
+      EXPECT_EQ(remote_fpgaClose(handle_), FPGA_OK);
+    }
+    if (token_) {
+      EXPECT_EQ(remote_fpgaDestroyToken(&token_), FPGA_OK);
+    }
+    remote_disconnect_all();
+    if (listen_ >= 0)
+      shutdown(listen_, SHUT_RDWR);
+    if (server_.joinable())
+      server_.join();
+    if (listen_ >= 0)
+      close(listen_);
+    unlink(path_.c_str());
+  }
+
+  void reply(int sock, const remote_msg_hdr &h, fpga_result result,
+             const remote_buf *payload) {
+    remote_buf out;
+    size_t off;
+
+    remote_buf_init(&out);
+    off = remote_msg_begin(&out, h.op, h.flags, h.seq, result);
+    if (payload)
+      remote_put_bytes(&out, payload->data, payload->len);
+    remote_msg_end(&out, off);
+    remote_send(sock, out.data, out.len, -1);
+    remote_buf_free(&out);
+  }
+
+  void put_props(remote_buf *b) {
+    remote_props p;
+
+    memset(&p, 0, sizeof(p));
+    p.valid_fields = (1ULL << FPGA_PROPERTY_OBJTYPE) |
+                     (1ULL << FPGA_PROPERTY_SEGMENT) |
+                     (1ULL << FPGA_PROPERTY_BUS) |
+                     (1ULL << FPGA_PROPERTY_OBJECTID);
+    p.objtype = FPGA_ACCELERATOR;
+    p.segment = 0x0001;
+    p.bus = 0x5e;
+    p.object_id = 9;
+    remote_put_props(b, &p);
+  }
+
+  void serve() {
+    remote_buf in, resp;
+    remote_msg_hdr h;
+    int fd = -1;
+    int sock = accept(listen_, nullptr, nullptr);
+
+    if (sock < 0)
+      return;
+
+    remote_buf_init(&in);
+    remote_buf_init(&resp);
+
+    while (!remote_recv(sock, &h, &in, &fd)) {
+      remote_reader r;
+      fpga_result result = FPGA_OK;
+
+      remote_reader_init(&r, in.data, in.len);
+      resp.len = 0;
+
+      switch (h.op) {
+        case REMOTE_OP_HELLO:
+          remote_put_u32(&resp, REMOTE_PROTO_VERSION);
+          remote_put_u32(&resp, 0);
+          break;
+        case REMOTE_OP_ENUMERATE:
+          remote_put_u32(&resp, 1);
+          remote_put_u64(&resp, 5);
+          put_props(&resp);
+          break;
+        case REMOTE_OP_GET_PROPERTIES:
+          EXPECT_EQ(remote_get_u64(&r), 5u);
+          put_props(&resp);
+          break;
+        case REMOTE_OP_OPEN:
+          EXPECT_EQ(remote_get_u64(&r), 5u);
+          remote_put_u64(&resp, next_id_++);
+          break;
+        case REMOTE_OP_CLOSE:
+          EXPECT_GE(remote_get_u64(&r), 3u);
+          break;
+        case REMOTE_OP_READ_MMIO64:
+          remote_get_u64(&r);
+          remote_get_u32(&r);
+          remote_put_u64(&resp, 2 * remote_get_u64(&r));
+          break;
+        case REMOTE_OP_WRITE_MMIO64:
+          remote_get_u64(&r);
+          remote_get_u32(&r);
+          if (remote_get_u64(&r) >= 0x1000)
+            result = FPGA_INVALID_PARAM;
+          break;
+        case REMOTE_OP_READ_MMIO_BATCH: {
+          uint32_t n;
+
+          remote_get_u64(&r);
+          n = remote_get_u32(&r);
+          for (uint32_t i = 0; i < n; ++i) {
+            remote_get_u32(&r);
+            remote_get_u32(&r);
+            remote_put_u64(&resp, 2 * remote_get_u64(&r));
+          }
+        } break;
+        default:
+          result = FPGA_NOT_SUPPORTED;
+          break;
+      }
+
+      if (!(h.flags & REMOTE_F_POSTED)) {
+        reply(sock, h, result, &resp);
+      } else if (result != FPGA_OK) {
+        // Name the handle of the failed request.
+        remote_reader_init(&r, in.data, in.len);
+        resp.len = 0;
+        remote_put_u64(&resp, remote_get_u64(&r));
+        reply(sock, h, result, &resp);
+      }
+    }
+
+    remote_buf_free(&in);
+    remote_buf_free(&resp);
+    close(sock);
+  }
+
+  std::string path_;
+  int listen_;
+  uint64_t next_id_;
+  std::thread server_;
+  fpga_token token_;
+  fpga_handle handle_;
+};
+
+/**
+ * @test       enumerate
+ * @brief      Test: remote_fpgaEnumerate
+ * @details    The server's accelerator is enumerated, and its
+ *             properties fetched, in segment 0xf0xx. Filters match
+ *             on that segment, not on the server's.<br>
+ */
+TEST_F(opae_remote_c_p, enumerate) {
+  fpga_properties filter = nullptr;
+  fpga_properties props = nullptr;
+  uint16_t segment = 0;
+  uint8_t bus = 0;
+  uint32_t matches = 0;
+
+  ASSERT_EQ(remote_fpgaEnumerate(nullptr, 0, &token_, 1, &matches), FPGA_OK);
+  ASSERT_EQ(matches, 1u);
+
+  ASSERT_EQ(remote_fpgaGetProperties(token_, &props), FPGA_OK);
+  EXPECT_EQ(fpgaPropertiesGetSegment(props, &segment), FPGA_OK);
+  EXPECT_EQ(segment, REMOTE_SEGMENT(0, 1));
+  EXPECT_EQ(fpgaPropertiesGetBus(props, &bus), FPGA_OK);
+  EXPECT_EQ(bus, 0x5e);
+  EXPECT_EQ(fpgaDestroyProperties(&props), FPGA_OK);
+
+  ASSERT_EQ(fpgaGetProperties(nullptr, &filter), FPGA_OK);
+  ASSERT_EQ(fpgaPropertiesSetSegment(filter, 1), FPGA_OK);
+  EXPECT_EQ(remote_fpgaEnumerate(&filter, 1, nullptr, 0, &matches), FPGA_OK);
+  EXPECT_EQ(matches, 0u);
+  ASSERT_EQ(fpgaPropertiesSetSegment(filter, REMOTE_SEGMENT(0, 1)), FPGA_OK);
+  EXPECT_EQ(remote_fpgaEnumerate(&filter, 1, nullptr, 0, &matches), FPGA_OK);
+  EXPECT_EQ(matches, 1u);
+  EXPECT_EQ(fpgaDestroyProperties(&filter), FPGA_OK);
+}
+
+/**
+ * @test       mmio
+ * @brief      Test: remote_fpgaReadMMIO64, remote_fpgaWriteMMIO64
+ * @details    Reads are answered by the server. A write that the
+ *             server rejects is reported by the next call.<br>
+ */
+TEST_F(opae_remote_c_p, mmio) {
+  uint32_t matches = 0;
+  uint64_t value = 0;
+
+  ASSERT_EQ(remote_fpgaEnumerate(nullptr, 0, &token_, 1, &matches), FPGA_OK);
+  ASSERT_EQ(remote_fpgaOpen(token_, &handle_, 0), FPGA_OK);
+
+  EXPECT_EQ(remote_fpgaReadMMIO64(handle_, 0, 0x180, &value), FPGA_OK);
+  EXPECT_EQ(value, 0x300u);
+
+  EXPECT_EQ(remote_fpgaWriteMMIO64(handle_, 0, 0x100, 1), FPGA_OK);
+  EXPECT_EQ(remote_fpgaReadMMIO64(handle_, 0, 0x8, &value), FPGA_OK);
+
+  EXPECT_EQ(remote_fpgaWriteMMIO64(handle_, 0, 0x1000, 1), FPGA_OK);
+  EXPECT_EQ(remote_fpgaReadMMIO64(handle_, 0, 0x8, &value),
+            FPGA_INVALID_PARAM);
+  EXPECT_EQ(remote_fpgaReadMMIO64(handle_, 0, 0x8, &value), FPGA_OK);
+  EXPECT_EQ(value, 0x10u);
+}
+
+/**
+ * @test       mmio_posted_per_handle
+ * @brief      Test: remote_fpgaWriteMMIO64, remote_fpgaReadMMIO64
+ * @details    A posted write that the server rejects is reported to
+ *             the handle that made it, not to another handle on the
+ *             same connection. A misaligned write fails at once.<br>
+ */
+TEST_F(opae_remote_c_p, mmio_posted_per_handle) {
+  fpga_handle other = nullptr;
+  uint32_t matches = 0;
+  uint64_t value = 0;
+
+  ASSERT_EQ(remote_fpgaEnumerate(nullptr, 0, &token_, 1, &matches), FPGA_OK);
+  ASSERT_EQ(remote_fpgaOpen(token_, &handle_, 0), FPGA_OK);
+  ASSERT_EQ(remote_fpgaOpen(token_, &other, 0), FPGA_OK);
+
+  EXPECT_EQ(remote_fpgaWriteMMIO64(handle_, 0, 0x1000, 1), FPGA_OK);
+  EXPECT_EQ(remote_fpgaReadMMIO64(other, 0, 0x8, &value), FPGA_OK);
+  EXPECT_EQ(value, 0x10u);
+  EXPECT_EQ(remote_fpgaReadMMIO64(handle_, 0, 0x8, &value),
+            FPGA_INVALID_PARAM);
+  EXPECT_EQ(remote_fpgaReadMMIO64(handle_, 0, 0x8, &value), FPGA_OK);
+
+  EXPECT_EQ(remote_fpgaWriteMMIO64(other, 0, 0x4, 1), FPGA_INVALID_PARAM);
+
+  EXPECT_EQ(remote_fpgaClose(other), FPGA_OK);
+}
+
+/**
+ * @test       batch
+ * @brief      Test: remote_fpgaReadMMIOBatch
+ * @details    A batch larger than REMOTE_BATCH_MAX is split across
+ *             requests and every read is answered in order.<br>
+ */
+TEST_F(opae_remote_c_p, batch) {
+  const uint32_t num_ops = REMOTE_BATCH_MAX + 10;
+  std::vector<fpga_mmio_op> ops(num_ops);
+  uint32_t matches = 0;
+
+  ASSERT_EQ(remote_fpgaEnumerate(nullptr, 0, &token_, 1, &matches), FPGA_OK);
+  ASSERT_EQ(remote_fpgaOpen(token_, &handle_, 0), FPGA_OK);
+
+  for (uint32_t i = 0; i < num_ops; ++i) {
+    ops[i].mmio_num = 0;
+    ops[i].width = 64;
+    ops[i].offset = 8 * i;
+    ops[i].value = 0;
+  }
+
+  ASSERT_EQ(remote_fpgaReadMMIOBatch(handle_, ops.data(), num_ops), FPGA_OK);
+  for (uint32_t i = 0; i < num_ops; ++i)
+    EXPECT_EQ(ops[i].value, 16u * i);
+}
@@ -0,0 +1,360 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <uuid/uuid.h>
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include <opae/fpga.h>
+
+extern "C" {
+#include "opae_sim.h"
+
+fpga_result sim_fpgaOpen(fpga_token token, fpga_handle *handle, int flags);
+fpga_result sim_fpgaClose(fpga_handle handle);
+fpga_result sim_fpgaEnumerate(const fpga_properties *filters,
+                              uint32_t num_filters, fpga_token *tokens,
+                              uint32_t max_tokens, uint32_t *num_matches);
+fpga_result sim_fpgaDestroyToken(fpga_token *token);
+fpga_result sim_fpgaGetProperties(fpga_token token, fpga_properties *prop);
+fpga_result sim_fpgaReset(fpga_handle handle);
+fpga_result sim_fpgaMapMMIO(fpga_handle handle, uint32_t mmio_num,
+                            uint64_t **mmio_ptr);
+fpga_result sim_fpgaReadMMIO64(fpga_handle handle, uint32_t mmio_num,
+                               uint64_t offset, uint64_t *value);
+fpga_result sim_fpgaWriteMMIO64(fpga_handle handle, uint32_t mmio_num,
+                                uint64_t offset, uint64_t value);
+fpga_result sim_fpgaWriteMMIO32(fpga_handle handle, uint32_t mmio_num,
+                                uint64_t offset, uint32_t value);
+fpga_result sim_fpgaPrepareBuffer(fpga_handle handle, uint64_t len,
+                                  void **buf_addr, uint64_t *wsid, int flags);
+fpga_result sim_fpgaReleaseBuffer(fpga_handle handle, uint64_t wsid);
+fpga_result sim_fpgaGetIOAddress(fpga_handle handle, uint64_t wsid,
+                                 uint64_t *ioaddr);
+fpga_result sim_fpgaCreateEventHandle(fpga_event_handle *event_handle);
+fpga_result sim_fpgaDestroyEventHandle(fpga_event_handle *event_handle);
+fpga_result sim_fpgaGetOSObjectFromEventHandle(const fpga_event_handle eh,
+                                               int *fd);
+fpga_result sim_fpgaRegisterEvent(fpga_handle handle,
+                                  fpga_event_type event_type,
+                                  fpga_event_handle event_handle,
+                                  uint32_t flags);
+fpga_result sim_fpgaUnregisterEvent(fpga_handle handle,
+                                    fpga_event_type event_type,
+                                    fpga_event_handle event_handle);
+}
+
+#define HE_LPBK_GUID "56e203e9-864f-49a7-b94b-12284c31e02b"
+
+class opae_sim_c_p : public ::testing::Test {
+ protected:
+  opae_sim_c_p() : handle_(nullptr), num_tokens_(0) {}
+
+  virtual void SetUp() override {
+    ASSERT_EQ(sim_parse_config(
+                  "{ \"devices\": [ \"he_lpbk\", \"dummy_afu\" ] }"), 0);
+    ASSERT_EQ(sim_create_devices(), 0);
+    ASSERT_EQ(sim_fpgaEnumerate(nullptr, 0, tokens_, 2, &num_tokens_),
+              FPGA_OK);
+    ASSERT_EQ(num_tokens_, 2u);
+  }
+
+  virtual void TearDown() override {
+    if (handle_) {
+      EXPECT_EQ(sim_fpgaClose(handle_), FPGA_OK);
+    }
+    for (uint32_t i = 0; i < num_tokens_; ++i)
+      EXPECT_EQ(sim_fpgaDestroyToken(&tokens_[i]), FPGA_OK);
+    sim_free_devices();
+  }
+
+  // Poll a location the emulated AFU writes, giving its
+  // worker thread up to a second to get there.
+  static bool wait_for(volatile uint64_t *p, uint64_t mask) {
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::seconds(1);
+    while (!(*p & mask)) {
+      if (std::chrono::steady_clock::now() > deadline)
+        return false;
+      std::this_thread::yield();
+    }
+    return true;
+  }
+
+  fpga_token tokens_[2];
+  fpga_handle handle_;
+  uint32_t num_tokens_;
+};
+
+/**
+ * @test       parse_config_err
+ * @brief      Test: sim_parse_config
+ * @details    Malformed JSON, a bad "poll_usec" and a non-string
+ *             model name are all rejected.<br>
+ */
+TEST(opae_sim_c, parse_config_err) {
+  EXPECT_NE(sim_parse_config("{ \"devices\": "), 0);
+  EXPECT_NE(sim_parse_config("{ \"poll_usec\": 0 }"), 0);
+  EXPECT_NE(sim_parse_config("{ \"devices\": [ 3 ] }"), 0);
+}
+
+/**
+ * @test       unknown_model
+ * @brief      Test: sim_create_devices
+ * @details    A configuration naming a model that is not built in
+ *             creates no devices.<br>
+ */
+TEST(opae_sim_c, unknown_model) {
+  uint32_t matches = 1;
+
+  ASSERT_EQ(sim_parse_config("{ \"devices\": [ \"no_such_afu\" ] }"), 0);
+  EXPECT_NE(sim_create_devices(), 0);
+  EXPECT_EQ(sim_fpgaEnumerate(nullptr, 0, nullptr, 0, &matches), FPGA_OK);
+  EXPECT_EQ(matches, 0u);
+}
+
+/**
+ * @test       enumerate_guid
+ * @brief      Test: sim_fpgaEnumerate
+ * @details    Filtering on the AFU ID of he_lpbk matches exactly one
+ *             emulated device, whose interface is FPGA_IFC_EMU.<br>
+ */
+TEST_F(opae_sim_c_p, enumerate_guid) {
+  fpga_properties filter = nullptr;
+  fpga_properties props = nullptr;
+  fpga_interface ifc = FPGA_IFC_DFL;
+  fpga_guid guid;
+  fpga_token token = nullptr;
+  uint32_t matches = 0;
+
+  ASSERT_EQ(uuid_parse(HE_LPBK_GUID, guid), 0);
+  ASSERT_EQ(fpgaGetProperties(nullptr, &filter), FPGA_OK);
+  ASSERT_EQ(fpgaPropertiesSetGUID(filter, guid), FPGA_OK);
+
+  EXPECT_EQ(sim_fpgaEnumerate(&filter, 1, &token, 1, &matches), FPGA_OK);
+  ASSERT_EQ(matches, 1u);
+
+  ASSERT_EQ(sim_fpgaGetProperties(token, &props), FPGA_OK);
+  EXPECT_EQ(fpgaPropertiesGetInterface(props, &ifc), FPGA_OK);
+  EXPECT_EQ(ifc, FPGA_IFC_EMU);
+
+  EXPECT_EQ(fpgaDestroyProperties(&props), FPGA_OK);
+  EXPECT_EQ(sim_fpgaDestroyToken(&token), FPGA_OK);
+  EXPECT_EQ(fpgaDestroyProperties(&filter), FPGA_OK);
+}
+
+/**
+ * @test       open_exclusive
+ * @brief      Test: sim_fpgaOpen
+ * @details    A device opened without FPGA_OPEN_SHARED refuses
+ *             a second open with FPGA_BUSY.<br>
+ */
+TEST_F(opae_sim_c_p, open_exclusive) {
+  fpga_handle h = nullptr;
+
+  ASSERT_EQ(sim_fpgaOpen(tokens_[0], &handle_, 0), FPGA_OK);
+  EXPECT_EQ(sim_fpgaOpen(tokens_[0], &h, FPGA_OPEN_SHARED), FPGA_BUSY);
+  EXPECT_EQ(sim_fpgaOpen(tokens_[0], &h, 0), FPGA_BUSY);
+}
+
+/**
+ * @test       afu_id
+ * @brief      Test: sim_fpgaReadMMIO64
+ * @details    The AFU DFH at offset 0 is followed by the AFU ID,
+ *             which matches the token's GUID.<br>
+ */
+TEST_F(opae_sim_c_p, afu_id) {
+  uint64_t dfh = 0, id_l = 0, id_h = 0;
+  fpga_guid guid;
+  char str[37];
+
+  ASSERT_EQ(sim_fpgaOpen(tokens_[0], &handle_, 0), FPGA_OK);
+  EXPECT_EQ(sim_fpgaReadMMIO64(handle_, 0, 0x0, &dfh), FPGA_OK);
+  EXPECT_EQ(dfh >> 60, 1u);
+  EXPECT_EQ(sim_fpgaReadMMIO64(handle_, 0, 0x8, &id_l), FPGA_OK);
+  EXPECT_EQ(sim_fpgaReadMMIO64(handle_, 0, 0x10, &id_h), FPGA_OK);
+
+  for (int i = 0; i < 8; ++i) {
+    guid[i] = (uint8_t)(id_h >> (56 - 8 * i));
+    guid[8 + i] = (uint8_t)(id_l >> (56 - 8 * i));
+  }
+  uuid_unparse(guid, str);
+  EXPECT_STREQ(str, HE_LPBK_GUID);
+
+  EXPECT_EQ(sim_fpgaReadMMIO64(handle_, 0, 0x3, &dfh), FPGA_INVALID_PARAM);
+  EXPECT_EQ(sim_fpgaReadMMIO64(handle_, 0, 0x1000, &dfh),
+            FPGA_INVALID_PARAM);
+}
+
+/**
+ * @test       he_lpbk
+ * @brief      Test: he_lpbk model
+ * @details    A loopback test programmed through MMIO copies the
+ *             source buffer to the destination buffer and reports
+ *             completion in the DSM.<br>
+ */
+TEST_F(opae_sim_c_p, he_lpbk) {
+  const uint64_t lines = 32;
+  void *dsm = nullptr, *src = nullptr, *dst = nullptr;
+  uint64_t dsm_wsid = 0, src_wsid = 0, dst_wsid = 0;
+  uint64_t dsm_io = 0, src_io = 0, dst_io = 0;
+  volatile uint64_t *status;
+  uint64_t error = 1;
+
+  ASSERT_EQ(sim_fpgaOpen(tokens_[0], &handle_, 0), FPGA_OK);
+
+  ASSERT_EQ(sim_fpgaPrepareBuffer(handle_, 4096, &dsm, &dsm_wsid, 0),
+            FPGA_OK);
+  ASSERT_EQ(sim_fpgaPrepareBuffer(handle_, lines * 64, &src, &src_wsid, 0),
+            FPGA_OK);
+  ASSERT_EQ(sim_fpgaPrepareBuffer(handle_, lines * 64, &dst, &dst_wsid, 0),
+            FPGA_OK);
+  ASSERT_EQ(sim_fpgaGetIOAddress(handle_, dsm_wsid, &dsm_io), FPGA_OK);
+  ASSERT_EQ(sim_fpgaGetIOAddress(handle_, src_wsid, &src_io), FPGA_OK);
+  ASSERT_EQ(sim_fpgaGetIOAddress(handle_, dst_wsid, &dst_io), FPGA_OK);
+
+  // IO addresses are not virtual addresses.
+  EXPECT_NE(src_io, (uint64_t)src);
+
+  memset(dsm, 0, 4096);
+  for (uint64_t i = 0; i < lines * 64; ++i)
+    ((uint8_t *)src)[i] = (uint8_t)i;
+  memset(dst, 0xff, lines * 64);
+
+  EXPECT_EQ(sim_fpgaWriteMMIO32(handle_, 0, 0x138, 0), FPGA_OK);
+  EXPECT_EQ(sim_fpgaWriteMMIO32(handle_, 0, 0x138, 1), FPGA_OK);
+  EXPECT_EQ(sim_fpgaWriteMMIO32(handle_, 0, 0x110,
+                                (uint32_t)(dsm_io / 64)), FPGA_OK);
+  EXPECT_EQ(sim_fpgaWriteMMIO32(handle_, 0, 0x114,
+                                (uint32_t)((dsm_io / 64) >> 32)), FPGA_OK);
+  EXPECT_EQ(sim_fpgaWriteMMIO64(handle_, 0, 0x120, src_io / 64), FPGA_OK);
+  EXPECT_EQ(sim_fpgaWriteMMIO64(handle_, 0, 0x128, dst_io / 64), FPGA_OK);
+  EXPECT_EQ(sim_fpgaWriteMMIO64(handle_, 0, 0x130, lines - 1), FPGA_OK);
+  EXPECT_EQ(sim_fpgaWriteMMIO64(handle_, 0, 0x140, 0), FPGA_OK);
+  EXPECT_EQ(sim_fpgaWriteMMIO32(handle_, 0, 0x138, 3), FPGA_OK);
+
+  status = (volatile uint64_t *)dsm;
+  ASSERT_TRUE(wait_for(status, 1));
+  EXPECT_EQ(*status >> 32, 0u);
+  EXPECT_EQ(memcmp(src, dst, lines * 64), 0);
+
+  EXPECT_EQ(sim_fpgaReadMMIO64(handle_, 0, 0x170, &error), FPGA_OK);
+  EXPECT_EQ(error, 0u);
+
+  EXPECT_EQ(sim_fpgaReleaseBuffer(handle_, dst_wsid), FPGA_OK);
+  EXPECT_EQ(sim_fpgaReleaseBuffer(handle_, src_wsid), FPGA_OK);
+  EXPECT_EQ(sim_fpgaReleaseBuffer(handle_, dsm_wsid), FPGA_OK);
+}
+
+/**
+ * @test       dummy_afu_interrupt
+ * @brief      Test: dummy_afu model
+ * @details    The memory test copies one cache line and signals
+ *             completion on the eventfd registered for vector 0.<br>
+ */
+TEST_F(opae_sim_c_p, dummy_afu_interrupt) {
+  fpga_event_handle eh = nullptr;
+  void *buf = nullptr;
+  uint64_t wsid = 0, io = 0, stat = 1, count = 0;
+  struct pollfd pfd;
+  int fd = -1;
+
+  ASSERT_EQ(sim_fpgaOpen(tokens_[1], &handle_, 0), FPGA_OK);
+  ASSERT_EQ(sim_fpgaCreateEventHandle(&eh), FPGA_OK);
+  ASSERT_EQ(sim_fpgaRegisterEvent(handle_, FPGA_EVENT_INTERRUPT, eh, 0),
+            FPGA_OK);
+  ASSERT_EQ(sim_fpgaGetOSObjectFromEventHandle(eh, &fd), FPGA_OK);
+
+  ASSERT_EQ(sim_fpgaPrepareBuffer(handle_, 4096, &buf, &wsid, 0), FPGA_OK);
+  ASSERT_EQ(sim_fpgaGetIOAddress(handle_, wsid, &io), FPGA_OK);
+  memset(buf, 0, 128);
+  memset(buf, 0x5a, 64);
+
+  EXPECT_EQ(sim_fpgaWriteMMIO64(handle_, 0, 0x2050, io), FPGA_OK);
+  EXPECT_EQ(sim_fpgaWriteMMIO64(handle_, 0, 0x2058, io + 64), FPGA_OK);
+  EXPECT_EQ(sim_fpgaWriteMMIO64(handle_, 0, 0x2040, 1), FPGA_OK);
+
+  pfd.fd = fd;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  ASSERT_EQ(poll(&pfd, 1, 1000), 1);
+  EXPECT_EQ(read(fd, &count, sizeof(count)), (ssize_t)sizeof(count));
+  EXPECT_EQ(count, 1u);
+
+  EXPECT_EQ(sim_fpgaReadMMIO64(handle_, 0, 0x2048, &stat), FPGA_OK);
+  EXPECT_EQ(stat, 0u);
+  EXPECT_EQ(memcmp(buf, (uint8_t *)buf + 64, 64), 0);
+
+  EXPECT_EQ(sim_fpgaUnregisterEvent(handle_, FPGA_EVENT_INTERRUPT, eh),
+            FPGA_OK);
+  EXPECT_EQ(sim_fpgaDestroyEventHandle(&eh), FPGA_OK);
+  EXPECT_EQ(sim_fpgaReleaseBuffer(handle_, wsid), FPGA_OK);
+}
+
+/**
+ * @test       dummy_afu_ddr_rerun
+ * @brief      Test: dummy_afu model
+ * @details    Bank status is cleared by reset and by starting
+ *             a DDR test, so a second run in the same process
+ *             starts from zero and passes again.<br>
+ */
+TEST_F(opae_sim_c_p, dummy_afu_ddr_rerun) {
+  uint64_t *mmio = nullptr;
+
+  ASSERT_EQ(sim_fpgaOpen(tokens_[1], &handle_, 0), FPGA_OK);
+  ASSERT_EQ(sim_fpgaMapMMIO(handle_, 0, &mmio), FPGA_OK);
+
+  // DDR_TEST_BANK0_STAT..BANK3_STAT
+  volatile uint64_t *banks = mmio + 0x3010 / 8;
+
+  for (int run = 0; run < 2; ++run) {
+    ASSERT_EQ(sim_fpgaReset(handle_), FPGA_OK);
+    for (int i = 0; i < 4; ++i)
+      EXPECT_EQ(banks[i] & 0x7, 0u) << "run " << run << " bank " << i;
+
+    EXPECT_EQ(sim_fpgaWriteMMIO64(handle_, 0, 0x3000, 0xf), FPGA_OK);
+    for (int i = 0; i < 4; ++i)
+      EXPECT_TRUE(wait_for(&banks[i], 0x1)) << "run " << run << " bank " << i;
+  }
+
+  // Starting bank 0 alone clears the others' status.
+  EXPECT_EQ(sim_fpgaWriteMMIO64(handle_, 0, 0x3000, 0x1), FPGA_OK);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (banks[3] && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::yield();
+  EXPECT_TRUE(wait_for(&banks[0], 0x1));
+  for (int i = 1; i < 4; ++i)
+    EXPECT_EQ(banks[i] & 0x7, 0u) << "bank " << i;
+}
@@ -62,6 +62,10 @@ fpga_result uio_fpgaReadMMIO32(fpga_handle handle, uint32_t mmio_num,
                                uint64_t offset, uint32_t *value);
 fpga_result uio_fpgaWriteMMIO512(fpga_handle handle, uint32_t mmio_num,
                                  uint64_t offset, const void *value);
+fpga_result uio_fpgaReadMMIOBatch(fpga_handle handle, fpga_mmio_op *ops,
+                                  uint32_t num_ops);
+fpga_result uio_fpgaWriteMMIOBatch(fpga_handle handle, const fpga_mmio_op *ops,
+                                   uint32_t num_ops);
 fpga_result uio_fpgaMapMMIO(fpga_handle handle, uint32_t mmio_num,
                             uint64_t **mmio_ptr);
 fpga_result uio_fpgaUnmapMMIO(fpga_handle handle, uint32_t mmio_num);
@@ -151,6 +155,8 @@ TEST(opae_u, uio_plugin_config)
   EXPECT_EQ(uio_fpgaWriteMMIO32, adapter.fpgaWriteMMIO32);
   EXPECT_EQ(uio_fpgaReadMMIO32, adapter.fpgaReadMMIO32);
   EXPECT_EQ(uio_fpgaWriteMMIO512, adapter.fpgaWriteMMIO512);
+  EXPECT_EQ(uio_fpgaReadMMIOBatch, adapter.fpgaReadMMIOBatch);
+  EXPECT_EQ(uio_fpgaWriteMMIOBatch, adapter.fpgaWriteMMIOBatch);
   EXPECT_EQ(uio_fpgaMapMMIO, adapter.fpgaMapMMIO);
   EXPECT_EQ(uio_fpgaUnmapMMIO, adapter.fpgaUnmapMMIO);
   EXPECT_EQ(uio_fpgaEnumerate, adapter.fpgaEnumerate);
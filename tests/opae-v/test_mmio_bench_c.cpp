@@ -0,0 +1,153 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "mock/opae_std.h"
+
+extern "C" {
+#include "opae_vfio.h"
+
+fpga_result vfio_fpgaWriteMMIO64(fpga_handle handle, uint32_t mmio_num,
+                                uint64_t offset, uint64_t value);
+fpga_result vfio_fpgaReadMMIO64(fpga_handle handle, uint32_t mmio_num,
+                               uint64_t offset, uint64_t *value);
+
+#define VFIO_TOKEN_MAGIC 0xEF1010FE
+#define VFIO_HANDLE_MAGIC ~VFIO_TOKEN_MAGIC
+}
+
+/*
+ * Microbenchmark for the vfio plugin MMIO path. Several threads
+ * share one handle (backed by an ordinary memory buffer standing in
+ * for the device BAR) and each issues a fixed number of 64-bit
+ * write/read pairs to its own CSR. The reported ns/op should stay
+ * roughly flat as the thread count grows.
+ */
+class vfio_mmio_bench_f : public ::testing::Test
+{
+  protected:
+
+  vfio_mmio_bench_f()
+  {}
+
+  virtual void SetUp() override
+  {
+    memset(&device_, 0, sizeof(device_));
+
+    memset(&token_, 0, sizeof(token_));
+    token_.hdr.magic = VFIO_TOKEN_MAGIC;
+    token_.hdr.objtype = FPGA_ACCELERATOR;
+    token_.user_mmio_count = 1;
+    token_.user_mmio[0] = 0;
+    token_.device = &device_;
+
+    memset(mmio_, 0, sizeof(mmio_));
+
+    memset(&handle_, 0, sizeof(handle_));
+    handle_.magic = VFIO_HANDLE_MAGIC;
+    handle_.token = &token_;
+    handle_.mmio_base = mmio_;
+    handle_.mmio_size = sizeof(mmio_);
+    handle_.lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+  }
+
+  double run(unsigned num_threads, uint64_t ops_per_thread)
+  {
+    std::atomic<bool> go(false);
+    std::atomic<uint64_t> errors(0);
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0 ; t < num_threads ; ++t) {
+      workers.emplace_back([&, t]() {
+        // Keep each thread's CSR on its own cache line.
+        const uint64_t offset = t * 64;
+        uint64_t value = 0;
+
+        while (!go.load(std::memory_order_acquire))
+          ;
+
+        for (uint64_t i = 0 ; i < ops_per_thread ; ++i) {
+          if (vfio_fpgaWriteMMIO64(&handle_, 0, offset, i) != FPGA_OK ||
+              vfio_fpgaReadMMIO64(&handle_, 0, offset, &value) != FPGA_OK ||
+              value != i)
+            ++errors;
+        }
+      });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+
+    for (auto &w : workers)
+      w.join();
+    auto end = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(0, errors.load());
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    // Each iteration is one write plus one read.
+    return ns / (2.0 * ops_per_thread);
+  }
+
+  vfio_pci_device_t device_;
+  vfio_token token_;
+  uint8_t mmio_[4096];
+  vfio_handle handle_;
+};
+
+/**
+ * @test    mmio64_threads
+ * @brief   Bench: vfio_fpgaWriteMMIO64(), vfio_fpgaReadMMIO64()
+ * @details Measures the per-operation latency of the<br>
+ *          64-bit MMIO accessors for 1..N threads sharing<br>
+ *          a single handle, where N is the number of<br>
+ *          online CPUs (capped at 16).
+ */
+TEST_F(vfio_mmio_bench_f, mmio64_threads)
+{
+  const uint64_t ops_per_thread = 200000;
+  unsigned max_threads = std::thread::hardware_concurrency();
+
+  if (max_threads < 1)
+    max_threads = 1;
+  else if (max_threads > 16)
+    max_threads = 16;
+
+  for (unsigned n = 1 ; n <= max_threads ; n <<= 1) {
+    double ns_per_op = run(n, ops_per_thread);
+    std::cout << "vfio mmio64 threads: " << n
+              << " ns/op (per thread): " << ns_per_op << std::endl;
+  }
+}
@@ -89,6 +89,10 @@ fpga_result vfio_fpgaReadMMIO32(fpga_handle handle, uint32_t mmio_num,
                                uint64_t offset, uint32_t *value);
 fpga_result vfio_fpgaWriteMMIO512(fpga_handle handle, uint32_t mmio_num,
                                  uint64_t offset, const void *value);
+fpga_result vfio_fpgaReadMMIOBatch(fpga_handle handle, fpga_mmio_op *ops,
+                                  uint32_t num_ops);
+fpga_result vfio_fpgaWriteMMIOBatch(fpga_handle handle, const fpga_mmio_op *ops,
+                                   uint32_t num_ops);
 fpga_result vfio_fpgaMapMMIO(fpga_handle handle, uint32_t mmio_num,
                             uint64_t **mmio_ptr);
 fpga_result vfio_fpgaUnmapMMIO(fpga_handle handle, uint32_t mmio_num);
@@ -121,6 +125,9 @@ fpga_result vfio_fpgaReleaseBuffer(fpga_handle handle, uint64_t wsid);
 fpga_result vfio_fpgaGetIOAddress(fpga_handle handle,
                                   uint64_t wsid,
                                   uint64_t *ioaddr);
+fpga_result vfio_fpgaGetBufferNumaNode(fpga_handle handle,
+                                       uint64_t wsid,
+                                       int *node);
 
 fpga_result vfio_fpgaCreateEventHandle(fpga_event_handle *event_handle);
 fpga_result vfio_fpgaDestroyEventHandle(fpga_event_handle *event_handle);
@@ -2146,6 +2153,74 @@ TEST_F(vfio_mmio_f, vfio_fpgaWriteMMIO512_ok)
   EXPECT_EQ(0, memcmp(values, mmio_, sizeof(values)));
 }
 
+/**
+ * @test    vfio_fpgaMMIOBatch_err0
+ * @brief   Test: vfio_fpgaWriteMMIOBatch(), vfio_fpgaReadMMIOBatch()
+ * @details When the objtype field of the token<br>
+ *          header is FPGA_DEVICE, then the functions<br>
+ *          return FPGA_NOT_SUPPORTED.
+ */
+TEST_F(vfio_mmio_f, vfio_fpgaMMIOBatch_err0)
+{
+  fpga_mmio_op op = { 0, 64, 0, 0xdeadbeefc0cac01a };
+  token_.hdr.objtype = FPGA_DEVICE;
+  EXPECT_EQ(FPGA_NOT_SUPPORTED, vfio_fpgaWriteMMIOBatch(&handle_, &op, 1));
+  EXPECT_EQ(FPGA_NOT_SUPPORTED, vfio_fpgaReadMMIOBatch(&handle_, &op, 1));
+}
+
+/**
+ * @test    vfio_fpgaMMIOBatch_err1
+ * @brief   Test: vfio_fpgaWriteMMIOBatch(), vfio_fpgaReadMMIOBatch()
+ * @details When an element has an out of bounds mmio_num<br>
+ *          or an invalid width, the functions stop at<br>
+ *          that element and return FPGA_INVALID_PARAM.
+ */
+TEST_F(vfio_mmio_f, vfio_fpgaMMIOBatch_err1)
+{
+  fpga_mmio_op ops[2] = {
+    { 0, 64, 0, 0xdeadbeefc0cac01a },
+    { USER_MMIO_MAX, 64, 8, 0 } // <- out of bounds
+  };
+  EXPECT_EQ(FPGA_INVALID_PARAM, vfio_fpgaWriteMMIOBatch(&handle_, ops, 2));
+  EXPECT_EQ(ops[0].value, *(uint64_t *)mmio_);
+
+  ops[1].mmio_num = 0;
+  ops[1].width = 8; // <- invalid width
+  EXPECT_EQ(FPGA_INVALID_PARAM, vfio_fpgaReadMMIOBatch(&handle_, ops, 2));
+}
+
+/**
+ * @test    vfio_fpgaMMIOBatch_ok
+ * @brief   Test: vfio_fpgaWriteMMIOBatch(), vfio_fpgaReadMMIOBatch()
+ * @details When the parameters are valid, then the<br>
+ *          functions perform each access in order<br>
+ *          and return FPGA_OK.
+ */
+TEST_F(vfio_mmio_f, vfio_fpgaMMIOBatch_ok)
+{
+  fpga_mmio_op wr[3] = {
+    { 0, 64, 0, 0xdeadbeefc0cac01a },
+    { 0, 32, 8, 0xfeedbeef },
+    { 0, 64, 16, 0xdecafbadbaadf00d }
+  };
+  EXPECT_EQ(FPGA_OK, vfio_fpgaWriteMMIOBatch(&handle_, wr, 3));
+
+  uint64_t *p = (uint64_t *)mmio_;
+  EXPECT_EQ(wr[0].value, p[0]);
+  EXPECT_EQ(wr[1].value, (uint64_t)*(uint32_t *)&p[1]);
+  EXPECT_EQ(wr[2].value, p[2]);
+
+  fpga_mmio_op rd[3] = {
+    { 0, 64, 0, 0 },
+    { 0, 32, 8, 0 },
+    { 0, 64, 16, 0 }
+  };
+  EXPECT_EQ(FPGA_OK, vfio_fpgaReadMMIOBatch(&handle_, rd, 3));
+  EXPECT_EQ(wr[0].value, rd[0].value);
+  EXPECT_EQ(wr[1].value, rd[1].value);
+  EXPECT_EQ(wr[2].value, rd[2].value);
+}
+
 /**
  * @test    vfio_fpgaMapMMIO_err0
  * @brief   Test: vfio_fpgaMapMMIO()
@@ -3079,6 +3154,37 @@ TEST(opae_v, prepare_buffer_err2)
   EXPECT_EQ(FPGA_EXCEPTION, vfio_fpgaPrepareBuffer(&handle, len, &buf_addr, &wsid, flags));
 }
 
+/**
+ * @test    prepare_buffer_err3
+ * @brief   Test: vfio_fpgaPrepareBuffer()
+ * @details When allocating a buffer larger than 2MB,<br>
+ *          with or without FPGA_BUF_SCATTER_GATHER,<br>
+ *          but the handle's vfio_pair is invalid,<br>
+ *          then the 1GB attempt and its scatter-gather<br>
+ *          retry both fail,<br>
+ *          and the function returns FPGA_EXCEPTION.
+ */
+TEST(opae_v, prepare_buffer_err3)
+{
+  uint64_t wsid = 0;
+  void *buf_addr = nullptr;
+  uint64_t len = 3 * 1024 * 1024;
+
+  vfio_pair_t pair;
+  memset(&pair, 0, sizeof(pair));
+
+  vfio_handle handle;
+  memset(&handle, 0, sizeof(handle));
+  handle.magic = VFIO_HANDLE_MAGIC;
+  handle.lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+  handle.vfio_pair = &pair;
+
+  EXPECT_EQ(FPGA_EXCEPTION, vfio_fpgaPrepareBuffer(&handle, len, &buf_addr, &wsid, 0));
+  EXPECT_EQ(FPGA_EXCEPTION, vfio_fpgaPrepareBuffer(&handle, len, &buf_addr, &wsid,
+                                                   FPGA_BUF_SCATTER_GATHER));
+  EXPECT_EQ(nullptr, buf_addr);
+}
+
 /**
  * @test    release_buffer_err0
  * @brief   Test: vfio_fpgaReleaseBuffer()
@@ -3125,6 +3231,58 @@ TEST(opae_v, get_io_addr_ok)
   EXPECT_EQ(0xdeadbeefdecafbad, ioaddr);
 }
 
+/**
+ * @test    get_numa_node_err0
+ * @brief   Test: vfio_fpgaGetBufferNumaNode()
+ * @details When the node pointer or the handle is invalid,<br>
+ *          then the function returns FPGA_INVALID_PARAM.
+ */
+TEST(opae_v, get_numa_node_err0)
+{
+  struct opae_vfio_buffer binfo;
+  memset(&binfo, 0, sizeof(binfo));
+
+  int node = 0;
+
+  EXPECT_EQ(FPGA_INVALID_PARAM, vfio_fpgaGetBufferNumaNode(nullptr, (uint64_t)&binfo, nullptr));
+  EXPECT_EQ(FPGA_INVALID_PARAM, vfio_fpgaGetBufferNumaNode(nullptr, (uint64_t)&binfo, &node));
+}
+
+/**
+ * @test    get_numa_node_ok
+ * @brief   Test: vfio_fpgaGetBufferNumaNode()
+ * @details When the parameters are valid,<br>
+ *          then the function reports the node backing the buffer,<br>
+ *          or -1 when the system has no NUMA support,<br>
+ *          and returns FPGA_OK.
+ */
+TEST(opae_v, get_numa_node_ok)
+{
+  struct opae_vfio v;
+  memset(&v, 0, sizeof(v));
+
+  vfio_pair_t pair;
+  memset(&pair, 0, sizeof(pair));
+  pair.device = &v;
+
+  vfio_handle handle;
+  memset(&handle, 0, sizeof(handle));
+  handle.magic = VFIO_HANDLE_MAGIC;
+  handle.lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+  handle.vfio_pair = &pair;
+
+  std::vector<uint8_t> page(4096, 0);
+
+  struct opae_vfio_buffer binfo;
+  memset(&binfo, 0, sizeof(binfo));
+  binfo.buffer_ptr = page.data();
+
+  int node = -2;
+
+  EXPECT_EQ(FPGA_OK, vfio_fpgaGetBufferNumaNode(&handle, (uint64_t)&binfo, &node));
+  EXPECT_GE(node, -1);
+}
+
 
 /**
  * @test    create_event_err0
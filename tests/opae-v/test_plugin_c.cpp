@@ -62,12 +62,17 @@ fpga_result vfio_fpgaReadMMIO32(fpga_handle handle, uint32_t mmio_num,
                                 uint64_t offset, uint32_t *value);
 fpga_result vfio_fpgaWriteMMIO512(fpga_handle handle, uint32_t mmio_num,
                                   uint64_t offset, const void *value);
+fpga_result vfio_fpgaReadMMIOBatch(fpga_handle handle, fpga_mmio_op *ops,
+                                  uint32_t num_ops);
+fpga_result vfio_fpgaWriteMMIOBatch(fpga_handle handle, const fpga_mmio_op *ops,
+                                   uint32_t num_ops);
 fpga_result vfio_fpgaMapMMIO(fpga_handle handle, uint32_t mmio_num,
                              uint64_t **mmio_ptr);
 fpga_result vfio_fpgaUnmapMMIO(fpga_handle handle, uint32_t mmio_num);
 fpga_result vfio_fpgaEnumerate(const fpga_properties *filters,
                                uint32_t num_filters, fpga_token *tokens,
                                uint32_t max_tokens, uint32_t *num_matches);
+fpga_result vfio_fpgaEnumerateRefresh(void);
 fpga_result vfio_fpgaCloneToken(fpga_token src, fpga_token *dst);
 fpga_result vfio_fpgaDestroyToken(fpga_token *token);
 fpga_result vfio_fpgaPrepareBuffer(fpga_handle handle,
@@ -79,6 +84,9 @@ fpga_result vfio_fpgaReleaseBuffer(fpga_handle handle, uint64_t wsid);
 fpga_result vfio_fpgaGetIOAddress(fpga_handle handle,
                                   uint64_t wsid,
                                   uint64_t *ioaddr);
+fpga_result vfio_fpgaGetBufferNumaNode(fpga_handle handle,
+                                       uint64_t wsid,
+                                       int *node);
 fpga_result vfio_fpgaCreateEventHandle(fpga_event_handle *event_handle);
 fpga_result vfio_fpgaDestroyEventHandle(fpga_event_handle *event_handle);
 fpga_result vfio_fpgaGetOSObjectFromEventHandle(const fpga_event_handle eh,
@@ -160,14 +168,18 @@ TEST(opae_v, vfio_plugin_config)
   EXPECT_EQ(vfio_fpgaWriteMMIO32, adapter.fpgaWriteMMIO32);
   EXPECT_EQ(vfio_fpgaReadMMIO32, adapter.fpgaReadMMIO32);
   EXPECT_EQ(vfio_fpgaWriteMMIO512, adapter.fpgaWriteMMIO512);
+  EXPECT_EQ(vfio_fpgaReadMMIOBatch, adapter.fpgaReadMMIOBatch);
+  EXPECT_EQ(vfio_fpgaWriteMMIOBatch, adapter.fpgaWriteMMIOBatch);
   EXPECT_EQ(vfio_fpgaMapMMIO, adapter.fpgaMapMMIO);
   EXPECT_EQ(vfio_fpgaUnmapMMIO, adapter.fpgaUnmapMMIO);
   EXPECT_EQ(vfio_fpgaEnumerate, adapter.fpgaEnumerate);
+  EXPECT_EQ(vfio_fpgaEnumerateRefresh, adapter.fpgaEnumerateRefresh);
   EXPECT_EQ(vfio_fpgaCloneToken, adapter.fpgaCloneToken);
   EXPECT_EQ(vfio_fpgaDestroyToken, adapter.fpgaDestroyToken);
   EXPECT_EQ(vfio_fpgaPrepareBuffer, adapter.fpgaPrepareBuffer);
   EXPECT_EQ(vfio_fpgaReleaseBuffer, adapter.fpgaReleaseBuffer);
   EXPECT_EQ(vfio_fpgaGetIOAddress, adapter.fpgaGetIOAddress);
+  EXPECT_EQ(vfio_fpgaGetBufferNumaNode, adapter.fpgaGetBufferNumaNode);
   EXPECT_EQ(vfio_fpgaCreateEventHandle, adapter.fpgaCreateEventHandle);
   EXPECT_EQ(vfio_fpgaDestroyEventHandle, adapter.fpgaDestroyEventHandle);
   EXPECT_EQ(vfio_fpgaGetOSObjectFromEventHandle, adapter.fpgaGetOSObjectFromEventHandle);
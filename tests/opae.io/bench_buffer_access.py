@@ -0,0 +1,149 @@
+# Copyright(c) 2026, Intel Corporation
+#
+# Redistribution  and  use  in source  and  binary  forms,  with  or  without
+# modification, are permitted provided that the following conditions are met:
+#
+# * Redistributions of  source code  must retain the  above copyright notice,
+#   this list of conditions and the following disclaimer.
+# * Redistributions in binary form must reproduce the above copyright notice,
+#   this list of conditions and the following disclaimer in the documentation
+#   and/or other materials provided with the distribution.
+# * Neither the name  of Intel Corporation  nor the names of its contributors
+#   may be used to  endorse or promote  products derived  from this  software
+#   without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+# IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+# LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+# CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+# SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+# INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+# CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""Compare per-element and bulk access to opae.io buffers and MMIO.
+
+The device must already be bound to vfio-pci (opae.io init). Example:
+
+    python3 bench_buffer_access.py 0000:b1:00.0 --size 1G
+"""
+
+import argparse
+import time
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+import libvfio
+
+
+def parse_size(text):
+    units = {'K': 1 << 10, 'M': 1 << 20, 'G': 1 << 30}
+    if text[-1].upper() in units:
+        return int(text[:-1], 0) * units[text[-1].upper()]
+    return int(text, 0)
+
+
+def timed(label, nbytes, fn):
+    begin = time.perf_counter()
+    result = fn()
+    secs = time.perf_counter() - begin
+    print('{:<36} {:>10.3f} ms {:>10.1f} MB/s'.format(
+          label, secs * 1e3, nbytes / secs / 1e6 if secs else 0.0))
+    return result
+
+
+def bench_buffer(device, size, sample):
+    buf = device.allocate(size)
+    if not buf:
+        raise SystemExit('could not allocate a {} byte buffer'.format(size))
+    size = buf.size
+
+    # Per-element access is far too slow for a large buffer, so time a
+    # sample of it and scale.
+    sample = min(sample, size)
+
+    def fill_scalar():
+        for offset in range(0, sample, 8):
+            buf[offset] = 0xc0c0cafe
+
+    timed('system_buffer __setitem__ ({}B)'.format(sample), sample,
+          fill_scalar)
+    timed('system_buffer read64 ({}B)'.format(sample), sample,
+          lambda: [buf.read64(offset) for offset in range(0, sample, 8)])
+
+    if np is not None:
+        arr = np.frombuffer(buf, dtype=np.uint64)
+
+        def fill():
+            arr[:] = 0xc0c0cafe
+
+        timed('numpy fill ({}B)'.format(size), size, fill)
+        ok = timed('numpy compare ({}B)'.format(size), size,
+                   lambda: bool((arr == 0xc0c0cafe).all()))
+        print('buffer check: {}'.format('ok' if ok else 'MISMATCH'))
+    else:
+        view = memoryview(buf).cast('Q')
+
+        def fill():
+            view[:] = memoryview(
+                (0xc0c0cafe).to_bytes(8, 'little') * (size // 8)).cast('Q')
+
+        timed('memoryview fill ({}B)'.format(size), size, fill)
+
+
+def bench_mmio(device, index, size):
+    region = [r for r in device.regions if r.index() == index]
+    if not region:
+        raise SystemExit('no region {}'.format(index))
+    region = region[0]
+    size = min(size, len(region))
+
+    timed('region read64 ({}B)'.format(size), size,
+          lambda: [region.read64(offset) for offset in range(0, size, 8)])
+    timed('region read_block ({}B)'.format(size), size,
+          lambda: region.read_block(0, size))
+
+    out = bytearray(size)
+    timed('region read_block into ({}B)'.format(size), size,
+          lambda: region.read_block(0, out))
+
+    if np is not None:
+        timed('numpy frombuffer of view(64) ({}B)'.format(len(region)),
+              len(region),
+              lambda: np.frombuffer(region.view(64), dtype=np.uint64))
+        timed('numpy DFH walk view(64, 0x1000)', len(region) // 0x1000 * 8,
+              lambda: np.array(region.view(64, 0x1000)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('pci_address')
+    parser.add_argument('--size', type=parse_size, default='64M',
+                        help='system buffer size (default 64M)')
+    parser.add_argument('--sample', type=parse_size, default='1M',
+                        help='bytes accessed per element (default 1M)')
+    parser.add_argument('--region', type=int, default=0,
+                        help='MMIO region index (default 0)')
+    parser.add_argument('--mmio-size', type=parse_size, default='4K',
+                        help='MMIO bytes read (default 4K)')
+    args = parser.parse_args()
+
+    device = libvfio.device.open(args.pci_address)
+    if not device:
+        raise SystemExit('could not open {}'.format(args.pci_address))
+
+    try:
+        bench_buffer(device, args.size, args.sample)
+        bench_mmio(device, args.region, args.mmio_size)
+    finally:
+        device.close()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,113 @@
+# Copyright(c) 2026, Intel Corporation
+#
+# Redistribution  and  use  in source  and  binary  forms,  with  or  without
+# modification, are permitted provided that the following conditions are met:
+#
+# * Redistributions of  source code  must retain the  above copyright notice,
+#   this list of conditions and the following disclaimer.
+# * Redistributions in binary form must reproduce the above copyright notice,
+#   this list of conditions and the following disclaimer in the documentation
+#   and/or other materials provided with the distribution.
+# * Neither the name  of Intel Corporation  nor the names of its contributors
+#   may be used to  endorse or promote  products derived  from this  software
+#   without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+# IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+# LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+# CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+# SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+# INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+# CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""Functional tests of region.view() and region.read_block().
+
+They need a device bound to vfio-pci (opae.io init), given by the
+OPAE_IO_TEST_DEVICE environment variable, e.g.
+
+    OPAE_IO_TEST_DEVICE=0000:b1:00.0 python3 -m pytest test_region_view.py
+
+and are skipped otherwise.
+"""
+
+import os
+import struct
+import unittest
+
+try:
+    import libvfio
+except ImportError:
+    libvfio = None
+
+TEST_DEVICE = os.environ.get('OPAE_IO_TEST_DEVICE')
+
+
+@unittest.skipIf(libvfio is None or not TEST_DEVICE,
+                 'needs libvfio and OPAE_IO_TEST_DEVICE')
+class TestRegionView(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.device = libvfio.device.open(TEST_DEVICE)
+        assert cls.device, 'could not open {}'.format(TEST_DEVICE)
+        cls.region = [r for r in cls.device.regions if r.index() == 0][0]
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.device.close()
+
+    def test_view64_is_a_contiguous_copy(self):
+        mv = memoryview(self.region.view(64))
+        assert mv.readonly
+        assert mv.format == 'Q'
+        assert mv.itemsize == 8
+        assert mv.strides == (8,)
+        assert mv.c_contiguous
+        assert len(mv) == len(self.region) // 8
+
+    def test_view64_dfh_walk(self):
+        mv = memoryview(self.region.view(64, 0x1000))
+        assert len(mv) == (len(self.region) - 8) // 0x1000 + 1
+        assert mv.strides == (8,)
+        for i in range(min(len(mv), 16)):
+            assert mv[i] == self.region.read64(i * 0x1000)
+
+    def test_view32(self):
+        mv = memoryview(self.region.view(32))
+        assert mv.format == 'I'
+        assert mv.itemsize == 4
+        assert len(mv) == len(self.region) // 4
+        for i in range(4):
+            assert mv[i] == self.region.read32(i * 4)
+
+    def test_view_matches_read_block(self):
+        mv = memoryview(self.region.view(64, 8))
+        block = self.region.read_block(0, 64)
+        assert mv[:8].tobytes() == block
+        assert struct.unpack('<8Q', block)[0] == self.region.read64(0)
+
+    def test_view_bad_width(self):
+        with self.assertRaises(ValueError):
+            self.region.view(16)
+
+    def test_view_bad_stride(self):
+        with self.assertRaises(ValueError):
+            self.region.view(64, 12)
+
+    def test_read_block_into(self):
+        out = bytearray(64)
+        self.region.read_block(0, out)
+        assert bytes(out) == self.region.read_block(0, 64)
+
+    def test_read_block_bounds(self):
+        with self.assertRaises(ValueError):
+            self.region.read_block(2, 8)
+        with self.assertRaises(IndexError):
+            self.region.read_block(len(self.region), 8)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -26,119 +26,100 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <time.h>
 #include <assert.h>
 
 #include <opae/mem_alloc.h>
 
+struct range {
+	uint64_t address;
+	uint64_t size;
+};
+
+static int walk(struct mem_tree *t, size_t offset,
+		struct range *r, int i, int max)
+{
+	struct mem_link *l;
+
+	if (!t)
+		return i;
+
+	i = walk(t->left, offset, r, i, max);
+
+	l = (struct mem_link *)((char *)t - offset);
+	assert(i < max);
+	r[i].address = l->address;
+	r[i].size = l->size;
+	++i;
+
+	return walk(t->right, offset, r, i, max);
+}
+
+/* Assert that the free ranges of m, in address order, are exactly r. */
+static void check_free(struct mem_alloc *m, const struct range *r, int n)
+{
+	struct range found[64];
+	int count;
+	int i;
+
+	count = walk(m->free_by_addr, offsetof(struct mem_link, by_addr),
+		     found, 0, 64);
+	assert(count == n);
+
+	for (i = 0 ; i < n ; ++i) {
+		assert(found[i].address == r[i].address);
+		assert(found[i].size == r[i].size);
+	}
+
+	count = walk(m->free_by_size, offsetof(struct mem_link, by_size),
+		     found, 0, 64);
+	assert(count == n);
+}
+
 void test_insert_basic(void)
 {
 	struct mem_alloc m;
-	struct mem_link *a;
-	struct mem_link *b;
+	const struct range r0[] = { { 0x0000, 4096 } };
+	const struct range r1[] = { { 0x1000, 4096 } };
+	const struct range r01[] = { { 0x0000, 2 * 4096 } };
+	const struct range r012[] = { { 0x0000, 3 * 4096 } };
+	const struct range r0_2[] = { { 0x0000, 4096 }, { 0x2000, 4096 } };
 
 	mem_alloc_init(&m);
 
 	mem_alloc_add_free(&m, 0x1000, 4096);
-	a = m.free.next;
-	assert(a);
-	assert(a->address == 0x1000);
-	assert(a->size == 4096);
-	assert(a->prev == &m.free);
-	assert(a->next == &m.free);
-	assert(m.free.next == a);
-	assert(m.free.prev == a);
+	check_free(&m, r1, 1);
 
 	mem_alloc_add_free(&m, 0x0000, 4096);
-	a = m.free.next;
-	assert(a);
-	assert(a->address == 0x0000);
-	assert(a->size == 2 * 4096);
-	assert(a->prev == &m.free);
-	assert(a->next == &m.free);
-	assert(m.free.next == a);
-	assert(m.free.prev == a);
+	check_free(&m, r01, 1);
 
 	mem_alloc_add_free(&m, 0x2000, 4096);
-	a = m.free.next;
-	assert(a);
-	assert(a->address == 0x0000);
-	assert(a->size == 3 * 4096);
-	assert(a->prev == &m.free);
-	assert(a->next == &m.free);
-	assert(m.free.next == a);
-	assert(m.free.prev == a);
+	check_free(&m, r012, 1);
 
 	mem_alloc_destroy(&m);
 
 
 	mem_alloc_add_free(&m, 0x0000, 4096);
-	a = m.free.next;
-	assert(a);
-	assert(a->address == 0x0000);
-	assert(a->size == 4096);
-	assert(a->prev == &m.free);
-	assert(a->next == &m.free);
-	assert(m.free.next == a);
-	assert(m.free.prev == a);
+	check_free(&m, r0, 1);
 
 	mem_alloc_add_free(&m, 0x2000, 4096);
-	a = m.free.next;
-	b = m.free.prev;
-	assert(a);
-	assert(a->address == 0x0000);
-	assert(a->size == 4096);
-	assert(b->address == 0x2000);
-	assert(b->size == 4096);
-	assert(a->prev == &m.free);
-	assert(a->next == b);
-	assert(b->prev == a);
-	assert(b->next == &m.free);
-	assert(m.free.prev == b);
-	assert(m.free.next == a);
+	check_free(&m, r0_2, 2);
 
 	mem_alloc_add_free(&m, 0x1000, 4096);
-	a = m.free.next;
-	assert(a);
-	assert(a->address == 0x0000);
-	assert(a->size == 3 * 4096);
-	assert(a->prev == &m.free);
-	assert(a->next == &m.free);
-	assert(m.free.next == a);
-	assert(m.free.prev == a);
+	check_free(&m, r012, 1);
 
 	mem_alloc_destroy(&m);
 
 
 	mem_alloc_add_free(&m, 0x0000, 4096);
-	a = m.free.next;
-	assert(a);
-	assert(a->address == 0x0000);
-	assert(a->size == 4096);
-	assert(a->prev == &m.free);
-	assert(a->next == &m.free);
-	assert(m.free.next == a);
-	assert(m.free.prev == a);
+	check_free(&m, r0, 1);
 
 	mem_alloc_add_free(&m, 0x1000, 4096);
-	a = m.free.next;
-	assert(a);
-	assert(a->address == 0x0000);
-	assert(a->size == 2 * 4096);
-	assert(a->prev == &m.free);
-	assert(a->next == &m.free);
-	assert(m.free.next == a);
-	assert(m.free.prev == a);
+	check_free(&m, r01, 1);
 
 	mem_alloc_add_free(&m, 0x2000, 4096);
-	a = m.free.next;
-	assert(a);
-	assert(a->address == 0x0000);
-	assert(a->size == 3 * 4096);
-	assert(a->prev == &m.free);
-	assert(a->next == &m.free);
-	assert(m.free.next == a);
-	assert(m.free.prev == a);
+	check_free(&m, r012, 1);
 
 	mem_alloc_destroy(&m);
 }
@@ -161,6 +142,7 @@ void test_insert_stress(int iters)
 		{ 0x9000, 4096 }
 	};
 	int addrs = sizeof(addresses) / sizeof(addresses[0]);
+	const struct range all[] = { { 0x0000, 10 * 4096 } };
 
 	int i;
 	int j;
@@ -168,7 +150,6 @@ void test_insert_stress(int iters)
 	uint64_t temp;
 
 	struct mem_alloc m;
-	struct mem_link *a;
 
 	mem_alloc_init(&m);
 
@@ -181,26 +162,11 @@ void test_insert_stress(int iters)
 			addresses[j].address = temp;
 		}
 
-		/*
-		printf("----\n");
 		for (j = 0 ; j < addrs ; ++j) {
-			printf("0x%lx\n", addresses[j].address);
-		}
-		*/
-
-		for (j = 0 ; j < addrs ; ++j) {
-			//printf("addr: 0x%lx\n", addresses[j].address);
 			assert(0 == mem_alloc_add_free(&m, addresses[j].address, addresses[j].size));
 		}
 
-		a = m.free.next;
-		assert(a);
-		assert(a->address == 0x0000);
-		assert(a->size == 10 * 4096);
-		assert(a->prev == &m.free);
-		assert(a->next == &m.free);
-		assert(m.free.next == a);
-		assert(m.free.prev == a);
+		check_free(&m, all, 1);
 
 		mem_alloc_destroy(&m);
 	}
@@ -220,6 +186,13 @@ void test_alloc_free_stress(int iters)
 		{ 0x8000, 4096 }
 	};
 	int addrs = sizeof(addresses) / sizeof(addresses[0]);
+	const struct range all[] = {
+		{ 0x0000, 4096 },
+		{ 0x2000, 4096 },
+		{ 0x4000, 4096 },
+		{ 0x6000, 4096 },
+		{ 0x8000, 4096 }
+	};
 
 	int i;
 	int j;
@@ -227,8 +200,6 @@ void test_alloc_free_stress(int iters)
 	int r;
 
 	struct mem_alloc m;
-	struct mem_link *a;
-	struct mem_link *b;
 
 	uint64_t size = 1024;
 	uint64_t allocated[addrs * 4];
@@ -241,42 +212,7 @@ void test_alloc_free_stress(int iters)
 			assert(0 == mem_alloc_add_free(&m, addresses[j].address, addresses[j].size));
 		}
 
-		a = m.free.next;
-		assert(a);
-		assert(a->address == 0x0000);
-		assert(a->size == 4096);
-		assert(a->prev == &m.free);
-
-		b = a->next;
-		assert(b);
-		assert(b->address == 0x2000);
-		assert(b->size == 4096);
-		assert(b->prev == a);
-
-		a = b;
-		b = b->next;
-		assert(b);
-		assert(b->address == 0x4000);
-		assert(b->size == 4096);
-		assert(b->prev == a);
-
-		a = b;
-		b = b->next;
-		assert(b);
-		assert(b->address == 0x6000);
-		assert(b->size == 4096);
-		assert(b->prev == a);
-
-		a = b;
-		b = b->next;
-		assert(b);
-		assert(b->address == 0x8000);
-		assert(b->size == 4096);
-		assert(b->prev == a);
-
-		assert(b->next == &m.free);
-		assert(m.free.prev == b);
-
+		check_free(&m, all, addrs);
 
 		k = 0;
 		while (0 == mem_alloc_get(&m, &allocated[k], size)) {
@@ -285,8 +221,8 @@ void test_alloc_free_stress(int iters)
 
 		assert(k == addrs * 4);
 
-		assert(m.free.next == &m.free);
-		assert(m.free.prev == &m.free);
+		assert(m.free_by_addr == NULL);
+		assert(m.free_by_size == NULL);
 
 		for (j = k - 1 ; j > 0 ; --j) {
 			r = rand() % j;
@@ -298,44 +234,9 @@ void test_alloc_free_stress(int iters)
 		}
 		assert(0 == mem_alloc_put(&m, allocated[0]));
 
-		assert(m.allocated.next == &m.allocated);
-		assert(m.allocated.prev == &m.allocated);
-
-		a = m.free.next;
-		assert(a);
-		assert(a->address == 0x0000);
-		assert(a->size == 4096);
-		assert(a->prev == &m.free);
-
-		b = a->next;
-		assert(b);
-		assert(b->address == 0x2000);
-		assert(b->size == 4096);
-		assert(b->prev == a);
-
-		a = b;
-		b = b->next;
-		assert(b);
-		assert(b->address == 0x4000);
-		assert(b->size == 4096);
-		assert(b->prev == a);
-
-		a = b;
-		b = b->next;
-		assert(b);
-		assert(b->address == 0x6000);
-		assert(b->size == 4096);
-		assert(b->prev == a);
-
-		a = b;
-		b = b->next;
-		assert(b);
-		assert(b->address == 0x8000);
-		assert(b->size == 4096);
-		assert(b->prev == a);
-
-		assert(b->next == &m.free);
-		assert(m.free.prev == b);
+		assert(m.allocated == NULL);
+
+		check_free(&m, all, addrs);
 
 		mem_alloc_destroy(&m);
 	}
@@ -0,0 +1,133 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <opae/hash_map.h>
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double ns_per_op(bench_clock::time_point start, size_t ops)
+{
+  return std::chrono::duration<double, std::nano>(
+             bench_clock::now() - start).count() / ops;
+}
+
+struct op_times {
+  double add_ns;
+  double find_ns;
+  double remove_ns;
+};
+
+// Add, find (repeatedly) and remove keys that look like the
+// page-aligned buffer addresses libopaevfio stores in cont_buffers.
+// Lookups use a different order than adds, so that neither map
+// benefits from walking its storage in allocation order.
+static op_times bench(int flags, uint32_t num_buckets,
+                      const std::vector<uint64_t> &keys,
+                      const std::vector<uint64_t> &lookups)
+{
+  const int find_rounds = 10;
+  opae_hash_map hm;
+  op_times t;
+  void *value = nullptr;
+
+  EXPECT_EQ(opae_hash_map_init(&hm, num_buckets, 0, flags,
+                               opae_u64_key_hash, opae_u64_key_compare,
+                               nullptr, nullptr), FPGA_OK);
+
+  auto start = bench_clock::now();
+  for (uint64_t k : keys)
+    EXPECT_EQ(opae_hash_map_add(&hm, (void *)k, (void *)k), FPGA_OK);
+  t.add_ns = ns_per_op(start, keys.size());
+
+  start = bench_clock::now();
+  for (int r = 0 ; r < find_rounds ; ++r)
+    for (uint64_t k : lookups)
+      EXPECT_EQ(opae_hash_map_find(&hm, (void *)k, &value), FPGA_OK);
+  t.find_ns = ns_per_op(start, keys.size() * find_rounds);
+
+  start = bench_clock::now();
+  for (uint64_t k : lookups)
+    EXPECT_EQ(opae_hash_map_remove(&hm, (void *)k), FPGA_OK);
+  t.remove_ns = ns_per_op(start, keys.size());
+
+  EXPECT_TRUE(opae_hash_map_is_empty(&hm));
+  EXPECT_EQ(opae_hash_map_destroy(&hm), FPGA_OK);
+  return t;
+}
+
+/**
+ * @test    buffers
+ * @brief   Test: opae_hash_map_add, opae_hash_map_find, opae_hash_map_remove
+ * @details Reports ns/op for add, find and remove of 64-20k<br>
+ *          buffer addresses, for the chained map as libopaevfio<br>
+ *          used to configure it (19441 buckets) and for the<br>
+ *          open-addressing map it uses now.
+ */
+TEST(hash_map_bench, buffers)
+{
+  const size_t counts[] = { 64, 1024, 20000 };
+  const int unique = OPAE_HASH_MAP_UNIQUE_KEYSPACE;
+  std::mt19937 rng(0);
+
+  std::cout << std::setw(8) << "buffers" << std::setw(12) << "map"
+            << std::setw(10) << "add ns" << std::setw(10) << "find ns"
+            << std::setw(12) << "remove ns" << std::endl;
+
+  for (size_t n : counts) {
+    std::vector<uint64_t> keys(n);
+    for (size_t i = 0 ; i < n ; ++i)
+      keys[i] = 0x7f0000000000ULL + (i << 21);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::vector<uint64_t> lookups(keys);
+    std::shuffle(lookups.begin(), lookups.end(), rng);
+
+    op_times chained = bench(unique, 19441, keys, lookups);
+    op_times open = bench(unique | OPAE_HASH_MAP_OPEN_ADDRESSING,
+                          1024, keys, lookups);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << std::setw(8) << n << std::setw(12) << "chained"
+              << std::setw(10) << chained.add_ns
+              << std::setw(10) << chained.find_ns
+              << std::setw(12) << chained.remove_ns << std::endl
+              << std::setw(8) << n << std::setw(12) << "open"
+              << std::setw(10) << open.add_ns
+              << std::setw(10) << open.find_ns
+              << std::setw(12) << open.remove_ns << std::endl;
+  }
+}
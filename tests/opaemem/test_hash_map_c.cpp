@@ -0,0 +1,210 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "mock/opae_std.h"
+
+#include <opae/hash_map.h>
+
+static uint32_t custom_key_hash(uint32_t num_buckets,
+                                uint32_t hash_seed,
+                                void *key)
+{
+  // Deliberately poor: forces long probe sequences and chains.
+  return (uint32_t)(((uint64_t)key >> 12) % 7 + hash_seed) % num_buckets;
+}
+
+static int custom_key_compare(void *keya, void *keyb)
+{
+  return opae_u64_key_compare(keya, keyb);
+}
+
+static int cleanups;
+
+static void count_cleanup(void *value, void *context)
+{
+  (void)value;
+  (void)context;
+  ++cleanups;
+}
+
+class hash_map_p : public ::testing::TestWithParam<int> {
+ protected:
+  virtual void SetUp() override
+  {
+    cleanups = 0;
+  }
+
+  void init(bool u64)
+  {
+    ASSERT_EQ(opae_hash_map_init(&hm_, 11, 0, GetParam(),
+                                 u64 ? opae_u64_key_hash : custom_key_hash,
+                                 u64 ? opae_u64_key_compare :
+                                       custom_key_compare,
+                                 nullptr, count_cleanup), FPGA_OK);
+  }
+
+  virtual void TearDown() override
+  {
+    EXPECT_EQ(opae_hash_map_destroy(&hm_), FPGA_OK);
+  }
+
+  opae_hash_map hm_;
+};
+
+/**
+ * @test    add_find_remove
+ * @brief   Test: opae_hash_map_add, opae_hash_map_find, opae_hash_map_remove
+ * @details Keys added to the map are found with their values,<br>
+ *          including across table growth, and removing a key<br>
+ *          calls value_cleanup and leaves the other keys intact.
+ */
+TEST_P(hash_map_p, add_find_remove)
+{
+  const uint64_t num = 1000;
+  uint64_t i;
+  void *value = nullptr;
+
+  for (bool u64 : { true, false }) {
+    init(u64);
+    EXPECT_TRUE(opae_hash_map_is_empty(&hm_));
+
+    for (i = 0 ; i < num ; ++i)
+      ASSERT_EQ(opae_hash_map_add(&hm_, (void *)((i + 1) << 12),
+                                  (void *)i), FPGA_OK);
+    EXPECT_FALSE(opae_hash_map_is_empty(&hm_));
+
+    for (i = 0 ; i < num ; ++i) {
+      ASSERT_EQ(opae_hash_map_find(&hm_, (void *)((i + 1) << 12),
+                                   &value), FPGA_OK);
+      EXPECT_EQ(value, (void *)i);
+    }
+    EXPECT_EQ(opae_hash_map_find(&hm_, (void *)1, &value), FPGA_NOT_FOUND);
+
+    // Remove the even keys.
+    for (i = 0 ; i < num ; i += 2)
+      ASSERT_EQ(opae_hash_map_remove(&hm_, (void *)((i + 1) << 12)),
+                FPGA_OK);
+    EXPECT_EQ(cleanups, (int)num / 2);
+    EXPECT_EQ(opae_hash_map_remove(&hm_, (void *)(1 << 12)), FPGA_NOT_FOUND);
+
+    for (i = 0 ; i < num ; ++i)
+      EXPECT_EQ(opae_hash_map_find(&hm_, (void *)((i + 1) << 12), nullptr),
+                (i & 1) ? FPGA_OK : FPGA_NOT_FOUND);
+
+    EXPECT_EQ(opae_hash_map_destroy(&hm_), FPGA_OK);
+    EXPECT_EQ(cleanups, (int)num);
+    cleanups = 0;
+  }
+
+  init(true);
+}
+
+/**
+ * @test    replace
+ * @brief   Test: opae_hash_map_add
+ * @details Without OPAE_HASH_MAP_UNIQUE_KEYSPACE, adding an<br>
+ *          existing key replaces its value and cleans up<br>
+ *          the old one.
+ */
+TEST_P(hash_map_p, replace)
+{
+  void *value = nullptr;
+
+  init(true);
+
+  if (GetParam() & OPAE_HASH_MAP_UNIQUE_KEYSPACE)
+    return;
+
+  ASSERT_EQ(opae_hash_map_add(&hm_, (void *)0x1000, (void *)1), FPGA_OK);
+  ASSERT_EQ(opae_hash_map_add(&hm_, (void *)0x1000, (void *)2), FPGA_OK);
+  EXPECT_EQ(cleanups, 1);
+
+  ASSERT_EQ(opae_hash_map_find(&hm_, (void *)0x1000, &value), FPGA_OK);
+  EXPECT_EQ(value, (void *)2);
+
+  ASSERT_EQ(opae_hash_map_remove(&hm_, (void *)0x1000), FPGA_OK);
+  EXPECT_TRUE(opae_hash_map_is_empty(&hm_));
+}
+
+INSTANTIATE_TEST_SUITE_P(hash_map_c, hash_map_p,
+                         ::testing::Values(0,
+                                           OPAE_HASH_MAP_UNIQUE_KEYSPACE,
+                                           OPAE_HASH_MAP_OPEN_ADDRESSING,
+                                           OPAE_HASH_MAP_OPEN_ADDRESSING |
+                                           OPAE_HASH_MAP_UNIQUE_KEYSPACE));
+
+/**
+ * @test    churn
+ * @brief   Test: opae_hash_map_add, opae_hash_map_remove
+ * @details Random add/remove traffic against an open-addressing<br>
+ *          map agrees with a reference set.
+ */
+TEST(hash_map, churn)
+{
+  opae_hash_map hm;
+  std::vector<bool> present(4096, false);
+  int i;
+
+  ASSERT_EQ(opae_hash_map_init(&hm, 8, 0, OPAE_HASH_MAP_OPEN_ADDRESSING,
+                               opae_u64_key_hash, opae_u64_key_compare,
+                               nullptr, nullptr), FPGA_OK);
+
+  srand(0);
+  for (i = 0 ; i < 100000 ; ++i) {
+    uint64_t k = rand() % present.size();
+    void *key = (void *)((k + 1) << 21);
+
+    if (present[k]) {
+      ASSERT_EQ(opae_hash_map_remove(&hm, key), FPGA_OK);
+      present[k] = false;
+    } else {
+      ASSERT_EQ(opae_hash_map_add(&hm, key, key), FPGA_OK);
+      present[k] = true;
+    }
+  }
+
+  uint32_t count = 0;
+  for (size_t k = 0 ; k < present.size() ; ++k) {
+    void *key = (void *)((k + 1) << 21);
+    void *value = nullptr;
+    if (present[k]) {
+      ++count;
+      ASSERT_EQ(opae_hash_map_find(&hm, key, &value), FPGA_OK);
+      EXPECT_EQ(value, key);
+    } else {
+      EXPECT_EQ(opae_hash_map_find(&hm, key, &value), FPGA_NOT_FOUND);
+    }
+  }
+  EXPECT_EQ(hm.num_items, count);
+
+  EXPECT_EQ(opae_hash_map_destroy(&hm), FPGA_OK);
+}
@@ -0,0 +1,270 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <opae/mem_alloc.h>
+
+// The sorted linked-list allocator that mem_alloc replaced, kept here
+// as the baseline: first fit, linear scans and one malloc per node.
+namespace list_alloc {
+
+struct node {
+  uint64_t address;
+  uint64_t size;
+  node *prev;
+  node *next;
+};
+
+struct alloc {
+  node free;
+  node allocated;
+};
+
+static void init(alloc *m)
+{
+  m->free.prev = m->free.next = &m->free;
+  m->allocated.prev = m->allocated.next = &m->allocated;
+}
+
+static void destroy(alloc *m)
+{
+  for (node *head : { &m->free, &m->allocated }) {
+    for (node *p = head->next ; p != head ; ) {
+      node *trash = p;
+      p = p->next;
+      free(trash);
+    }
+  }
+  init(m);
+}
+
+static node *make(uint64_t address, uint64_t size)
+{
+  node *n = (node *)malloc(sizeof(node));
+  n->address = address;
+  n->size = size;
+  return n;
+}
+
+static void link_before(node *a, node *b)
+{
+  a->prev = b->prev;
+  a->next = b;
+  b->prev = a;
+  a->prev->next = a;
+}
+
+static void unlink(node *x)
+{
+  x->next->prev = x->prev;
+  x->prev->next = x->next;
+}
+
+static void add_free(alloc *m, uint64_t address, uint64_t size)
+{
+  node *n = make(address, size);
+  node *p = m->free.next;
+
+  while (p != &m->free && p->address < address)
+    p = p->next;
+  link_before(n, p);
+
+  if (n->prev != &m->free &&
+      n->prev->address + n->prev->size == n->address) {
+    node *prev = n->prev;
+    n->address = prev->address;
+    n->size += prev->size;
+    unlink(prev);
+    free(prev);
+  }
+  if (n->next != &m->free &&
+      n->address + n->size == n->next->address) {
+    n->next->address = n->address;
+    n->next->size += n->size;
+    unlink(n);
+    free(n);
+  }
+}
+
+static int get(alloc *m, uint64_t *address, uint64_t size)
+{
+  for (node *p = m->free.next ; p != &m->free ; p = p->next) {
+    uint64_t aligned = (p->address + size - 1) & ~(size - 1);
+    if (aligned + size > p->address + p->size)
+      continue;
+    if (aligned != p->address) {
+      node *head = make(p->address, aligned - p->address);
+      link_before(head, p);
+      p->address = aligned;
+      p->size -= head->size;
+    }
+    node *a = make(p->address, size);
+    link_before(a, &m->allocated);
+    p->address += size;
+    p->size -= size;
+    if (!p->size) {
+      unlink(p);
+      free(p);
+    }
+    *address = a->address;
+    return 0;
+  }
+  return 1;
+}
+
+static int put(alloc *m, uint64_t address)
+{
+  for (node *p = m->allocated.next ; p != &m->allocated ; p = p->next) {
+    if (p->address == address) {
+      uint64_t size = p->size;
+      unlink(p);
+      free(p);
+      add_free(m, address, size);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+} // end of namespace list_alloc
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double elapsed_ms(bench_clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(
+             bench_clock::now() - start).count();
+}
+
+struct phase_times {
+  double get_ms;
+  double put_ms;
+};
+
+// Allocate num_ranges 4K ranges, then free them in random order.
+static phase_times bench_tree(size_t num_ranges,
+                              const std::vector<size_t> &order)
+{
+  struct mem_alloc m;
+  std::vector<uint64_t> addrs(num_ranges);
+  phase_times t;
+
+  mem_alloc_init(&m);
+  EXPECT_EQ(mem_alloc_add_free(&m, 0x100000, num_ranges * 4096), 0);
+
+  auto start = bench_clock::now();
+  for (size_t i = 0 ; i < num_ranges ; ++i)
+    EXPECT_EQ(mem_alloc_get(&m, &addrs[i], 4096), 0);
+  t.get_ms = elapsed_ms(start);
+
+  start = bench_clock::now();
+  for (size_t i : order)
+    EXPECT_EQ(mem_alloc_put(&m, addrs[i]), 0);
+  t.put_ms = elapsed_ms(start);
+
+  EXPECT_EQ(m.allocated, nullptr);
+  mem_alloc_destroy(&m);
+  return t;
+}
+
+static phase_times bench_list(size_t num_ranges,
+                              const std::vector<size_t> &order)
+{
+  list_alloc::alloc m;
+  std::vector<uint64_t> addrs(num_ranges);
+  phase_times t;
+
+  list_alloc::init(&m);
+  list_alloc::add_free(&m, 0x100000, num_ranges * 4096);
+
+  auto start = bench_clock::now();
+  for (size_t i = 0 ; i < num_ranges ; ++i)
+    EXPECT_EQ(list_alloc::get(&m, &addrs[i], 4096), 0);
+  t.get_ms = elapsed_ms(start);
+
+  start = bench_clock::now();
+  for (size_t i : order)
+    EXPECT_EQ(list_alloc::put(&m, addrs[i]), 0);
+  t.put_ms = elapsed_ms(start);
+
+  list_alloc::destroy(&m);
+  return t;
+}
+
+/**
+ * @test    get_put
+ * @brief   Test: mem_alloc_get(), mem_alloc_put()
+ * @details Reports the time to allocate 10k-1M 4K ranges and<br>
+ *          free them in random order, for mem_alloc and for the<br>
+ *          linked-list allocator it replaced. The list allocator<br>
+ *          is quadratic, so it is only run up to 10k ranges.
+ */
+TEST(mem_alloc_bench, get_put)
+{
+  const size_t counts[] = { 10000, 100000, 1000000 };
+  const size_t max_list_ranges = 10000;
+  std::mt19937 rng(0);
+
+  std::cout << std::setw(10) << "ranges"
+            << std::setw(16) << "tree get ms"
+            << std::setw(16) << "tree put ms"
+            << std::setw(16) << "list get ms"
+            << std::setw(16) << "list put ms" << std::endl;
+
+  for (size_t n : counts) {
+    std::vector<size_t> order(n);
+    for (size_t i = 0 ; i < n ; ++i)
+      order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+
+    phase_times tree = bench_tree(n, order);
+
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(2)
+              << std::setw(16) << tree.get_ms
+              << std::setw(16) << tree.put_ms;
+
+    if (n <= max_list_ranges) {
+      phase_times list = bench_list(n, order);
+      std::cout << std::setw(16) << list.get_ms
+                << std::setw(16) << list.put_ms;
+    } else {
+      std::cout << std::setw(16) << "-" << std::setw(16) << "-";
+    }
+    std::cout << std::endl;
+  }
+}
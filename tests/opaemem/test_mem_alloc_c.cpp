@@ -1,4 +1,4 @@
-// Copyright(c) 2021-2022, Intel Corporation
+// Copyright(c) 2021-2026, Intel Corporation
 //
 // Redistribution  and  use  in source  and  binary  forms,  with  or  without
 // modification, are permitted provided that the following conditions are met:
@@ -27,27 +27,70 @@
 #include <config.h>
 #endif // HAVE_CONFIG_H
 
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "mock/opae_std.h"
 
 #include <opae/mem_alloc.h>
 
-#define ALIGNED(__addr, __size) ((__addr + __size - 1) & ~(__size - 1))
-
 extern "C" {
-struct mem_link *mem_link_alloc(uint64_t address, uint64_t size);
-void mem_alloc_coalesce(struct mem_link *head, struct mem_link *l);
-int mem_alloc_allocate_node(struct mem_alloc *m,
-                            struct mem_link *node,
-                            uint64_t *address,
-                            uint64_t size);
-int mem_alloc_allocate_split_node(struct mem_alloc *m,
-				  struct mem_link *node,
-				  uint64_t aligned_addr,
-				  uint64_t *address,
-				  uint64_t size);
-int mem_alloc_free_node(struct mem_alloc *m,
-                        struct mem_link *node);
+struct mem_link *mem_link_alloc(struct mem_alloc *m,
+                                uint64_t address,
+                                uint64_t size);
+void mem_link_free(struct mem_alloc *m, struct mem_link *l);
+}
+
+struct range {
+  uint64_t address;
+  uint64_t size;
+};
+
+static void collect(struct mem_tree *t, size_t offset,
+                    std::vector<range> &v)
+{
+  if (!t)
+    return;
+  collect(t->left, offset, v);
+  struct mem_link *l = (struct mem_link *)((char *)t - offset);
+  v.push_back({ l->address, l->size });
+  collect(t->right, offset, v);
+}
+
+static std::vector<range> free_ranges(struct mem_alloc *m)
+{
+  std::vector<range> v;
+  collect(m->free_by_addr, offsetof(struct mem_link, by_addr), v);
+  return v;
+}
+
+static std::vector<range> free_ranges_by_size(struct mem_alloc *m)
+{
+  std::vector<range> v;
+  collect(m->free_by_size, offsetof(struct mem_link, by_size), v);
+  return v;
+}
+
+static std::vector<range> allocated_ranges(struct mem_alloc *m)
+{
+  std::vector<range> v;
+  collect(m->allocated, offsetof(struct mem_link, by_addr), v);
+  return v;
+}
+
+// Returns the height of t, or -1 if t is not a valid AVL tree.
+static int avl_height(struct mem_tree *t)
+{
+  if (!t)
+    return 0;
+  int l = avl_height(t->left);
+  int r = avl_height(t->right);
+  if (l < 0 || r < 0 || std::abs(l - r) > 1)
+    return -1;
+  int h = 1 + (l > r ? l : r);
+  return h == t->height ? h : -1;
 }
 
 /**
@@ -60,226 +103,107 @@ TEST(mem_alloc, init)
 {
   struct mem_alloc m;
 
+  memset(&m, 0xff, sizeof(m));
   mem_alloc_init(&m);
 
-  EXPECT_EQ(m.free.prev, &m.free);
-  EXPECT_EQ(m.free.next, &m.free);
-
-  EXPECT_EQ(m.allocated.prev, &m.allocated);
-  EXPECT_EQ(m.allocated.next, &m.allocated);
+  EXPECT_EQ(m.free_by_addr, nullptr);
+  EXPECT_EQ(m.free_by_size, nullptr);
+  EXPECT_EQ(m.allocated, nullptr);
+  EXPECT_EQ(m.spare, nullptr);
+  EXPECT_EQ(m.blocks, nullptr);
 }
 
 /**
  * @test    destroy
  * @brief   Test: mem_alloc_destroy()
- * @details mem_alloc_destroy() correctly<br>
- *          releases the given struct mem_alloc.
+ * @details mem_alloc_destroy() releases the node<br>
+ *          storage and re-initializes the allocator.
  */
 TEST(mem_alloc, destroy)
 {
   struct mem_alloc m;
+  uint64_t addr = 0;
 
-  struct mem_link *free_link = (struct mem_link *)
-	  opae_malloc(sizeof(struct mem_link));
-  struct mem_link *allocated_link = (struct mem_link *)
-	  opae_malloc(sizeof(struct mem_link));
-
-  ASSERT_NE(free_link, nullptr);
-  ASSERT_NE(allocated_link, nullptr);
-
-  m.free.prev = free_link;
-  m.free.next = free_link;
-  free_link->prev = &m.free;
-  free_link->next = &m.free;
+  mem_alloc_init(&m);
 
-  m.allocated.prev = allocated_link;
-  m.allocated.next = allocated_link;
-  allocated_link->prev = &m.allocated;
-  allocated_link->next = &m.allocated;
+  ASSERT_EQ(mem_alloc_add_free(&m, 0, 8192), 0);
+  ASSERT_EQ(mem_alloc_get(&m, &addr, 4096), 0);
+  EXPECT_NE(m.blocks, nullptr);
 
   mem_alloc_destroy(&m);
 
-  EXPECT_EQ(m.free.prev, &m.free);
-  EXPECT_EQ(m.free.next, &m.free);
-
-  EXPECT_EQ(m.allocated.prev, &m.allocated);
-  EXPECT_EQ(m.allocated.next, &m.allocated);
+  EXPECT_EQ(m.free_by_addr, nullptr);
+  EXPECT_EQ(m.free_by_size, nullptr);
+  EXPECT_EQ(m.allocated, nullptr);
+  EXPECT_EQ(m.spare, nullptr);
+  EXPECT_EQ(m.blocks, nullptr);
 }
 
 /**
  * @test    link_alloc
- * @brief   Test: mem_link_alloc()
+ * @brief   Test: mem_link_alloc(), mem_link_free()
  * @details mem_link_alloc() correctly<br>
- *          allocates and initializes a new<br>
- *          struct mem_link.
+ *          initializes a node taken from the node pool,<br>
+ *          and mem_link_free() returns it for reuse.
  */
 TEST(mem_alloc, link_alloc)
 {
-  const uint64_t addr = 1UL;
-  const uint64_t size = 2UL;
-  struct mem_link *link = mem_link_alloc(addr, size);
-
-  ASSERT_NE(link, nullptr);
-  EXPECT_EQ(link->address, addr);
-  EXPECT_EQ(link->size, size);
-  EXPECT_EQ(link->prev, link);
-  EXPECT_EQ(link->next, link);
-
-  opae_free(link);
-}
+  struct mem_alloc m;
+  const uint64_t addr = 0xdeadbeef;
+  const uint64_t size = 0xc0cac01a;
 
-/**
- * @test    coalesce0
- * @brief   Test: mem_alloc_coalesce()
- * @details When the l (2nd) parameter<br>
- *          is equal to the head (1st)<br>
- *          parameter, the fn simply returns.
- */
-TEST(mem_alloc, coalesce0)
-{
-  const uint64_t addr = 1UL;
-  const uint64_t size = 2UL;
-  struct mem_link *link = mem_link_alloc(addr, size);
+  mem_alloc_init(&m);
 
+  struct mem_link *link = mem_link_alloc(&m, addr, size);
   ASSERT_NE(link, nullptr);
-  EXPECT_EQ(link->address, addr);
-  EXPECT_EQ(link->size, size);
-  EXPECT_EQ(link->prev, link);
-  EXPECT_EQ(link->next, link);
-
-  mem_alloc_coalesce(link, link);
+  EXPECT_NE(m.blocks, nullptr);
+  EXPECT_NE(m.spare, nullptr);
 
   EXPECT_EQ(link->address, addr);
   EXPECT_EQ(link->size, size);
-  EXPECT_EQ(link->prev, link);
-  EXPECT_EQ(link->next, link);
 
-  opae_free(link);
-}
+  mem_link_free(&m, link);
+  EXPECT_EQ(m.spare, link);
+  EXPECT_EQ(mem_link_alloc(&m, 0, 0), link);
 
-/**
- * @test    coalesce1
- * @brief   Test: mem_alloc_coalesce()
- * @details When the node prior to the l<br>
- *          (2nd) parameter in the list is not<br>
- *          the list head, and when the prior node<br>
- *          meets the criteria for coalescing, the fn<br>
- *          coalesces the previous node into the l node.
- */
-TEST(mem_alloc, coalesce1)
-{
-  struct mem_link head;
-  struct mem_link *zero = mem_link_alloc(0, 1024);
-  struct mem_link *one = mem_link_alloc(1024, 1024);
-
-  ASSERT_NE(zero, nullptr);
-  ASSERT_NE(one, nullptr);
-
-  head.next = zero;
-  zero->prev = &head;
-  
-  zero->next = one;
-  one->prev = zero;
-
-  one->next = &head;
-  head.prev = one;
-
-  // head -> zero -> one
-  mem_alloc_coalesce(&head, one);
-
-  // head -> one
-  // (zero has been freed)
-  EXPECT_EQ(head.prev, one);
-  EXPECT_EQ(head.next, one);
-  EXPECT_EQ(one->prev, &head);
-  EXPECT_EQ(one->next, &head);
-  EXPECT_EQ(one->address, 0);
-  EXPECT_EQ(one->size, 2048);
-
-  opae_free(one);
-}
-
-/**
- * @test    coalesce2
- * @brief   Test: mem_alloc_coalesce()
- * @details When the node just after the l<br>
- *          (2nd) parameter in the list is not<br>
- *          the list head, and when the next node<br>
- *          meets the criteria for coalescing, the fn<br>
- *          coalesces l into the next node.
- */
-TEST(mem_alloc, coalesce2)
-{
-  struct mem_link head;
-  struct mem_link *zero = mem_link_alloc(0, 1024);
-  struct mem_link *one = mem_link_alloc(1024, 1024);
-
-  ASSERT_NE(zero, nullptr);
-  ASSERT_NE(one, nullptr);
-
-  head.next = zero;
-  zero->prev = &head;
-  
-  zero->next = one;
-  one->prev = zero;
-
-  one->next = &head;
-  head.prev = one;
-
-  // head -> zero -> one
-  mem_alloc_coalesce(&head, zero);
-
-  // head -> one
-  // (zero has been freed)
- 
-  EXPECT_EQ(head.prev, one);
-  EXPECT_EQ(head.next, one);
-  EXPECT_EQ(one->prev, &head);
-  EXPECT_EQ(one->next, &head);
-  EXPECT_EQ(one->address, 0);
-  EXPECT_EQ(one->size, 2048);
-
-  opae_free(one);
+  mem_alloc_destroy(&m);
 }
 
 /**
  * @test    add_free0
  * @brief   Test: mem_alloc_add_free()
- * @details When the allocator's free list is empty,<br>
+ * @details When the allocator's free tree is empty,<br>
  *          the fn adds a single mem_link for the<br>
  *          given address and size, returning 0.
  */
 TEST(mem_alloc, add_free0)
 {
   struct mem_alloc allocator;
-  struct mem_link *l;
+  std::vector<range> v;
 
   mem_alloc_init(&allocator);
 
   ASSERT_EQ(mem_alloc_add_free(&allocator, 0, 1024), 0);
 
-  EXPECT_NE(allocator.free.prev, &allocator.free);
-  EXPECT_NE(allocator.free.next, &allocator.free);
-
-  l = allocator.free.next;
-  EXPECT_EQ(l->prev, &allocator.free);
-  EXPECT_EQ(l->next, &allocator.free);
-  EXPECT_EQ(l->address, 0);
-  EXPECT_EQ(l->size, 1024);
+  v = free_ranges(&allocator);
+  ASSERT_EQ(v.size(), 1);
+  EXPECT_EQ(v[0].address, 0);
+  EXPECT_EQ(v[0].size, 1024);
+  EXPECT_EQ(free_ranges_by_size(&allocator).size(), 1);
 
-  opae_free(l);
+  mem_alloc_destroy(&allocator);
 }
 
 /**
  * @test    add_free1
  * @brief   Test: mem_alloc_add_free()
- * @details The fn maintains the free list in<br>
+ * @details The fn maintains the free tree in<br>
  *          ascending order, based on the address.<br>
  */
 TEST(mem_alloc, add_free1)
 {
   struct mem_alloc allocator;
-  struct mem_link *l, *trash;
+  std::vector<range> v;
   const uint64_t size = 1024UL;
 
   mem_alloc_init(&allocator);
@@ -290,424 +214,351 @@ TEST(mem_alloc, add_free1)
   ASSERT_EQ(mem_alloc_add_free(&allocator, 0, size), 0);
   ASSERT_EQ(mem_alloc_add_free(&allocator, 2048, size), 0);
 
-  EXPECT_NE(allocator.free.prev, &allocator.free);
-  EXPECT_NE(allocator.free.next, &allocator.free);
+  v = free_ranges(&allocator);
+  ASSERT_EQ(v.size(), 3);
+  EXPECT_EQ(v[0].address, 0);
+  EXPECT_EQ(v[0].size, size);
+  EXPECT_EQ(v[1].address, 2048);
+  EXPECT_EQ(v[1].size, size);
+  EXPECT_EQ(v[2].address, 4096);
+  EXPECT_EQ(v[2].size, size);
 
-  l = allocator.free.next;
-
-  EXPECT_EQ(l->prev, &allocator.free);
-  EXPECT_EQ(l->address, 0);
-  EXPECT_EQ(l->size, size);
-
-  trash = l;
-  l = l->next;
-  opae_free(trash);
-
-  EXPECT_EQ(l->prev, trash);
-  EXPECT_EQ(l->address, 2048);
-  EXPECT_EQ(l->size, size);
-
-  trash =l;
-  l = l->next;
-  opae_free(trash);
-
-  EXPECT_EQ(l->prev, trash);
-  EXPECT_EQ(l->next, &allocator.free);
-  EXPECT_EQ(l->address, 4096);
-  EXPECT_EQ(l->size, size);
-
-  opae_free(l);
+  mem_alloc_destroy(&allocator);
 }
 
 /**
  * @test    add_free2
  * @brief   Test: mem_alloc_add_free()
- * @details The fn detects double-free's and<br>
- *          returns non-zero.
+ * @details The fn detects double-free's and overlapping<br>
+ *          ranges and returns non-zero.
  */
 TEST(mem_alloc, add_free2)
 {
   struct mem_alloc allocator;
-  struct mem_link *l;
   const uint64_t size = 1024UL;
 
   mem_alloc_init(&allocator);
 
   ASSERT_EQ(mem_alloc_add_free(&allocator, 4096, size), 0);
   EXPECT_NE(mem_alloc_add_free(&allocator, 4096, size), 0);
+  EXPECT_NE(mem_alloc_add_free(&allocator, 4096 - 512, size), 0);
+  EXPECT_NE(mem_alloc_add_free(&allocator, 4096 + 512, size), 0);
+
+  EXPECT_EQ(free_ranges(&allocator).size(), 1);
+  EXPECT_EQ(free_ranges_by_size(&allocator).size(), 1);
 
-  l = allocator.free.next;
-  opae_free(l);
+  mem_alloc_destroy(&allocator);
 }
 
 /**
- * @test    allocate_node0
- * @brief   Test: mem_alloc_allocate_node()
- * @details When the given node has a size that matches<br>
- *          the requested size, the node is unlinked<br>
- *          from the free list and added to the<br>
- *          allocated list.
+ * @test    coalesce
+ * @brief   Test: mem_alloc_add_free()
+ * @details Adjacent free ranges are merged with<br>
+ *          their predecessor and successor.
  */
-TEST(mem_alloc, allocate_node0)
+TEST(mem_alloc, coalesce)
 {
   struct mem_alloc allocator;
-  struct mem_link *l;
-  const uint64_t size = 1024UL;
-  uint64_t addr = 8192;
+  std::vector<range> v;
 
   mem_alloc_init(&allocator);
 
-  EXPECT_EQ(mem_alloc_add_free(&allocator, 0, size), 0);
-  EXPECT_EQ(mem_alloc_allocate_node(&allocator,
-                                    allocator.free.next,
-                                    &addr,
-				    size), 0);
+  ASSERT_EQ(mem_alloc_add_free(&allocator, 0, 1024), 0);
+  ASSERT_EQ(mem_alloc_add_free(&allocator, 2048, 1024), 0);
+  EXPECT_EQ(free_ranges(&allocator).size(), 2);
 
-  EXPECT_EQ(allocator.free.prev, &allocator.free);
-  EXPECT_EQ(allocator.free.next, &allocator.free);
+  ASSERT_EQ(mem_alloc_add_free(&allocator, 1024, 1024), 0);
 
-  EXPECT_NE(allocator.allocated.prev, &allocator.allocated);
-  EXPECT_NE(allocator.allocated.next, &allocator.allocated);
+  v = free_ranges(&allocator);
+  ASSERT_EQ(v.size(), 1);
+  EXPECT_EQ(v[0].address, 0);
+  EXPECT_EQ(v[0].size, 3072);
 
-  l = allocator.allocated.next;
-  EXPECT_EQ(l->prev, &allocator.allocated);
-  EXPECT_EQ(l->next, &allocator.allocated);
-  EXPECT_EQ(l->address, 0);
-  EXPECT_EQ(l->size, size);
+  v = free_ranges_by_size(&allocator);
+  ASSERT_EQ(v.size(), 1);
+  EXPECT_EQ(v[0].size, 3072);
 
-  opae_free(l);
+  mem_alloc_destroy(&allocator);
 }
 
 /**
- * @test    allocate_node1
- * @brief   Test: mem_alloc_allocate_node()
- * @details When the given node has a size that is<br>
- *          greater or equal to the requested size,<br>
- *          that node is adjusted to account for the allocation,<br>
- *          and a new node is allocated and added to the<br>
- *          allocated list.
+ * @test    get0
+ * @brief   Test: mem_alloc_get()
+ * @details The fn allocates from the free tree<br>
+ *          using a best fit algorithm.
  */
-TEST(mem_alloc, allocate_node1)
+TEST(mem_alloc, get0)
 {
   struct mem_alloc allocator;
-  struct mem_link *l;
-  const uint64_t size = 1024UL;
+  std::vector<range> v;
   uint64_t addr = 8192;
 
   mem_alloc_init(&allocator);
 
-  EXPECT_EQ(mem_alloc_add_free(&allocator, 0, size), 0);
-
-  l = allocator.free.next;
-  EXPECT_EQ(mem_alloc_allocate_node(&allocator,
-                                    allocator.free.next,
-                                    &addr,
-                                    512), 0);
-
-  EXPECT_EQ(allocator.free.prev, l);
-  EXPECT_EQ(allocator.free.next, l);
-  EXPECT_EQ(l->prev, &allocator.free);
-  EXPECT_EQ(l->next, &allocator.free);
-  EXPECT_EQ(l->address, 512);
-  EXPECT_EQ(l->size, 512);
-
-  opae_free(l);
-  l = allocator.allocated.next;
-
-  EXPECT_EQ(allocator.allocated.prev, l);
-  EXPECT_EQ(allocator.allocated.next, l);
-  EXPECT_EQ(l->prev, &allocator.allocated);
-  EXPECT_EQ(l->next, &allocator.allocated);
-  EXPECT_EQ(l->address, 0);
-  EXPECT_EQ(l->size, 512);
-
-  opae_free(l);
-}
+  EXPECT_EQ(mem_alloc_add_free(&allocator, 0, 1024), 0);
+  EXPECT_EQ(mem_alloc_add_free(&allocator, 2048, 512), 0);
 
-/**
- * @test    alloc_split_node0
- * @brief   Test: mem_alloc_allocate_split_node()
- * @details When the given node has an aligned size that matches<br>
- *          the requested size, the node is readjusted to meet<br>
- *          the alignment requirement, and a new node is added to<br>
- *          the allocated list.
- */
-TEST(mem_alloc, alloc_split_node0)
-{
-  struct mem_alloc allocator;
-  struct mem_link *l;
-  const uint64_t fourK = 4096UL;
-  const uint64_t twoM = 2 * 1024UL * 1024UL;
-  uint64_t addr = 0;
+  // address: 0, 1024, 2048, 2560
+  //          x           x
 
-  mem_alloc_init(&allocator);
+  EXPECT_EQ(mem_alloc_get(&allocator, &addr, 512), 0);
+  EXPECT_EQ(addr, 2048);
 
-  EXPECT_EQ(mem_alloc_add_free(&allocator, 0x1000, (2 * twoM) - fourK), 0);
+  v = free_ranges(&allocator);
+  ASSERT_EQ(v.size(), 1);
+  EXPECT_EQ(v[0].address, 0);
+  EXPECT_EQ(v[0].size, 1024);
 
-  l = allocator.free.next;
-  EXPECT_EQ(mem_alloc_allocate_split_node(&allocator,
-                                          allocator.free.next,
-                                          ALIGNED(0x1000, twoM),
-                                          &addr,
-                                          twoM), 0);
-
-  EXPECT_EQ(allocator.free.prev, l);
-  EXPECT_EQ(allocator.free.next, l);
-  EXPECT_EQ(l->prev, &allocator.free);
-  EXPECT_EQ(l->next, &allocator.free);
-  EXPECT_EQ(l->address, 0x1000);
-  EXPECT_EQ(l->size, twoM - fourK);
-  EXPECT_EQ(addr, twoM);
+  EXPECT_EQ(mem_alloc_get(&allocator, &addr, 512), 0);
+  EXPECT_EQ(addr, 0);
 
-  opae_free(l);
-  l = allocator.allocated.next;
+  v = free_ranges(&allocator);
+  ASSERT_EQ(v.size(), 1);
+  EXPECT_EQ(v[0].address, 512);
+  EXPECT_EQ(v[0].size, 512);
 
-  EXPECT_EQ(allocator.allocated.prev, l);
-  EXPECT_EQ(allocator.allocated.next, l);
-  EXPECT_EQ(l->prev, &allocator.allocated);
-  EXPECT_EQ(l->next, &allocator.allocated);
-  EXPECT_EQ(l->address, twoM);
-  EXPECT_EQ(l->size, twoM);
+  v = allocated_ranges(&allocator);
+  ASSERT_EQ(v.size(), 2);
+  EXPECT_EQ(v[0].address, 0);
+  EXPECT_EQ(v[0].size, 512);
+  EXPECT_EQ(v[1].address, 2048);
+  EXPECT_EQ(v[1].size, 512);
 
-  opae_free(l);
+  mem_alloc_destroy(&allocator);
 }
 
 /**
- * @test    alloc_split_node1
- * @brief   Test: mem_alloc_allocate_split_node()
- * @details When the given node has an aligned size that is greater than<br>
- *          the requested size, the node is split into two allocated nodes<br>
- *          and the allocation is made from the aligned address.
+ * @test    get1
+ * @brief   Test: mem_alloc_get()
+ * @details When the free tree has no block large<br>
+ *          enough to satisfy the request,<br>
+ *          the fn returns a non-zero value<br>
+ *          to indicate the out-of-memory condition.
  */
-TEST(mem_alloc, alloc_split_node1)
+TEST(mem_alloc, get1)
 {
   struct mem_alloc allocator;
-  struct mem_link *l;
-  struct mem_link *m;
-  const uint64_t fourK = 4096UL;
-  const uint64_t twoM = 2 * 1024UL * 1024UL;
-  uint64_t addr = 0;
+  const uint64_t size = 1024UL;
+  uint64_t addr = 8192;
 
   mem_alloc_init(&allocator);
 
-  EXPECT_EQ(mem_alloc_add_free(&allocator, 0x1000, (3 * twoM) - fourK), 0);
-
-  l = allocator.free.next;
-  EXPECT_EQ(mem_alloc_allocate_split_node(&allocator,
-                                          allocator.free.next,
-                                          ALIGNED(0x1000, twoM),
-                                          &addr,
-                                          twoM), 0);
-  m = l->next;
-
-  EXPECT_EQ(allocator.free.prev, m);
-  EXPECT_EQ(allocator.free.next, l);
-  EXPECT_EQ(l->prev, &allocator.free);
-  EXPECT_EQ(l->next, m);
-  EXPECT_EQ(m->prev, l);
-  EXPECT_EQ(m->next, &allocator.free);
-  EXPECT_EQ(l->address, 0x1000);
-  EXPECT_EQ(l->size, twoM - fourK);
-  EXPECT_EQ(m->address, 2 * twoM);
-  EXPECT_EQ(m->size, twoM);
-  EXPECT_EQ(addr, twoM);
-
-  opae_free(l);
-  opae_free(m);
-  l = allocator.allocated.next;
+  EXPECT_EQ(mem_alloc_add_free(&allocator, 0, size), 0);
 
-  EXPECT_EQ(allocator.allocated.prev, l);
-  EXPECT_EQ(allocator.allocated.next, l);
-  EXPECT_EQ(l->prev, &allocator.allocated);
-  EXPECT_EQ(l->next, &allocator.allocated);
-  EXPECT_EQ(l->address, twoM);
-  EXPECT_EQ(l->size, twoM);
+  EXPECT_NE(mem_alloc_get(&allocator, &addr, size * 2), 0);
+  EXPECT_NE(mem_alloc_get(&allocator, &addr, 0), 0);
 
-  opae_free(l);
+  mem_alloc_destroy(&allocator);
 }
 
 /**
- * @test    get0
+ * @test    get_aligned0
  * @brief   Test: mem_alloc_get()
- * @details The fn allocates from the free list<br>
- *          using a first fit algorithm.
+ * @details When the aligned request ends at the end<br>
+ *          of the free block, the block is trimmed to<br>
+ *          the unaligned head.
  */
-TEST(mem_alloc, get0)
+TEST(mem_alloc, get_aligned0)
 {
   struct mem_alloc allocator;
-  struct mem_link *l, *trash;
-  const uint64_t size = 1024UL;
-  uint64_t addr = 8192;
+  std::vector<range> v;
+  const uint64_t fourK = 4096UL;
+  const uint64_t twoM = 2 * 1024UL * 1024UL;
+  uint64_t addr = 0;
 
   mem_alloc_init(&allocator);
 
-  EXPECT_EQ(mem_alloc_add_free(&allocator, 0, size), 0);
-  EXPECT_EQ(mem_alloc_add_free(&allocator, 2048, size), 0);
-
-  // address: 0, 1024, 2048
-  //          x           x
-
-  EXPECT_EQ(mem_alloc_get(&allocator, &addr, 512), 0);
-  EXPECT_EQ(addr, 0);
-
-  l = allocator.free.next;
-  EXPECT_EQ(l->address, 512);
-  EXPECT_EQ(l->size, 512);
-
-  trash = l;
-  l = l->next;
-  opae_free(trash);
-
-  EXPECT_EQ(l->address, 2048);
-  EXPECT_EQ(l->size, size);
+  EXPECT_EQ(mem_alloc_add_free(&allocator, 0x1000, (2 * twoM) - fourK), 0);
+  EXPECT_EQ(mem_alloc_get(&allocator, &addr, twoM), 0);
+  EXPECT_EQ(addr, twoM);
 
-  opae_free(l);
-  l = allocator.allocated.next;
+  v = free_ranges(&allocator);
+  ASSERT_EQ(v.size(), 1);
+  EXPECT_EQ(v[0].address, 0x1000);
+  EXPECT_EQ(v[0].size, twoM - fourK);
 
-  EXPECT_EQ(l->address, 0);
-  EXPECT_EQ(l->size, 512);
+  v = allocated_ranges(&allocator);
+  ASSERT_EQ(v.size(), 1);
+  EXPECT_EQ(v[0].address, twoM);
+  EXPECT_EQ(v[0].size, twoM);
 
-  opae_free(l);
+  mem_alloc_destroy(&allocator);
 }
 
 /**
- * @test    get1
+ * @test    get_aligned1
  * @brief   Test: mem_alloc_get()
- * @details When the free list has no block large<br>
- *          enough to satisfy the request,<br>
- *          the fn returns a non-zero value<br>
- *          to indicate the out-of-memory condition.
+ * @details When the aligned request falls in the middle<br>
+ *          of the free block, the block is split in two<br>
+ *          around the allocation.
  */
-TEST(mem_alloc, get1)
+TEST(mem_alloc, get_aligned1)
 {
   struct mem_alloc allocator;
-  const uint64_t size = 1024UL;
-  uint64_t addr = 8192;
+  std::vector<range> v;
+  const uint64_t fourK = 4096UL;
+  const uint64_t twoM = 2 * 1024UL * 1024UL;
+  uint64_t addr = 0;
 
   mem_alloc_init(&allocator);
 
-  EXPECT_EQ(mem_alloc_add_free(&allocator, 0, size), 0);
+  EXPECT_EQ(mem_alloc_add_free(&allocator, 0x1000, (3 * twoM) - fourK), 0);
+  EXPECT_EQ(mem_alloc_get(&allocator, &addr, twoM), 0);
+  EXPECT_EQ(addr, twoM);
 
-  EXPECT_NE(mem_alloc_get(&allocator, &addr, size * 2), 0);
+  v = free_ranges(&allocator);
+  ASSERT_EQ(v.size(), 2);
+  EXPECT_EQ(v[0].address, 0x1000);
+  EXPECT_EQ(v[0].size, twoM - fourK);
+  EXPECT_EQ(v[1].address, 2 * twoM);
+  EXPECT_EQ(v[1].size, twoM);
+  EXPECT_EQ(free_ranges_by_size(&allocator).size(), 2);
 
-  opae_free(allocator.free.next);
+  mem_alloc_destroy(&allocator);
 }
 
 /**
- * @test    free_node
- * @brief   Test: mem_alloc_free_node()
- * @details When the allocated list contains the<br>
- *          target node, that node is freed, and<br>
- *          the address and size are added back<br>
- *          to the free list in a new node.
+ * @test    get_aligned2
+ * @brief   Test: mem_alloc_get()
+ * @details A smaller free block that cannot hold the<br>
+ *          aligned request is passed over in favor of<br>
+ *          a larger one that can.
  */
-TEST(mem_alloc, free_node)
+TEST(mem_alloc, get_aligned2)
 {
   struct mem_alloc allocator;
-  const uint64_t addr = 0;
-  const uint64_t size = 1024;
-  struct mem_link *node = mem_link_alloc(addr, size);
-
-  ASSERT_NE(node, nullptr);
+  const uint64_t twoM = 2 * 1024UL * 1024UL;
+  uint64_t addr = 0;
 
   mem_alloc_init(&allocator);
 
-  allocator.allocated.next = node;
-  allocator.allocated.prev = node;
-  node->prev = &allocator.allocated;
-  node->next = &allocator.allocated;
+  // Large enough, but not 2M-aligned.
+  EXPECT_EQ(mem_alloc_add_free(&allocator, 0x1000, twoM), 0);
+  EXPECT_EQ(mem_alloc_add_free(&allocator, 8 * twoM, 4 * twoM), 0);
 
-  EXPECT_EQ(mem_alloc_free_node(&allocator, node), 0);
-  EXPECT_EQ(allocator.allocated.prev, &allocator.allocated);
-  EXPECT_EQ(allocator.allocated.next, &allocator.allocated);
+  EXPECT_EQ(mem_alloc_get(&allocator, &addr, twoM), 0);
+  EXPECT_EQ(addr, 8 * twoM);
 
-  EXPECT_NE(allocator.free.prev, &allocator.free);
-  EXPECT_NE(allocator.free.next, &allocator.free);
-
-  node = allocator.free.next;
-  EXPECT_EQ(node->prev, &allocator.free);
-  EXPECT_EQ(node->next, &allocator.free);
-  EXPECT_EQ(node->address, addr);
-  EXPECT_EQ(node->size, size);
-
-  opae_free(node);
+  mem_alloc_destroy(&allocator);
 }
 
 /**
  * @test    put0
  * @brief   Test: mem_alloc_put()
- * @details When the allocated list contains the<br>
- *          target address, that node is freed, and<br>
- *          the address and size are added back<br>
- *          to the free list in a new node.
+ * @details When the allocated tree contains the<br>
+ *          target address, that node is moved back<br>
+ *          to the free tree and coalesced.
  */
 TEST(mem_alloc, put0)
 {
   struct mem_alloc allocator;
-  const uint64_t addr = 0;
-  const uint64_t size = 1024;
-  struct mem_link *node = mem_link_alloc(addr, size);
-
-  ASSERT_NE(node, nullptr);
+  std::vector<range> v;
+  uint64_t a = 0;
+  uint64_t b = 0;
 
   mem_alloc_init(&allocator);
 
-  allocator.allocated.next = node;
-  allocator.allocated.prev = node;
-  node->prev = &allocator.allocated;
-  node->next = &allocator.allocated;
-
-  EXPECT_EQ(mem_alloc_put(&allocator, addr), 0);
-
-  EXPECT_EQ(allocator.allocated.prev, &allocator.allocated);
-  EXPECT_EQ(allocator.allocated.next, &allocator.allocated);
+  ASSERT_EQ(mem_alloc_add_free(&allocator, 0, 4096), 0);
+  ASSERT_EQ(mem_alloc_get(&allocator, &a, 1024), 0);
+  ASSERT_EQ(mem_alloc_get(&allocator, &b, 1024), 0);
 
-  EXPECT_NE(allocator.free.prev, &allocator.free);
-  EXPECT_NE(allocator.free.next, &allocator.free);
+  EXPECT_EQ(mem_alloc_put(&allocator, a), 0);
+  EXPECT_EQ(allocated_ranges(&allocator).size(), 1);
+  EXPECT_EQ(free_ranges(&allocator).size(), 2);
 
-  node = allocator.free.next;
+  EXPECT_EQ(mem_alloc_put(&allocator, b), 0);
+  EXPECT_EQ(allocator.allocated, nullptr);
 
-  EXPECT_EQ(node->prev, &allocator.free);
-  EXPECT_EQ(node->next, &allocator.free);
-  EXPECT_EQ(node->address, addr);
-  EXPECT_EQ(node->size, size);
+  v = free_ranges(&allocator);
+  ASSERT_EQ(v.size(), 1);
+  EXPECT_EQ(v[0].address, 0);
+  EXPECT_EQ(v[0].size, 4096);
 
-  opae_free(node);
+  mem_alloc_destroy(&allocator);
 }
 
 /**
  * @test    put1
  * @brief   Test: mem_alloc_put()
  * @details When the given address is not found<br>
- *          in the allocated list,<br>
+ *          in the allocated tree,<br>
  *          the fn returns non-zero to indicate<br>
  *          an error.
  */
 TEST(mem_alloc, put1)
 {
   struct mem_alloc allocator;
-  const uint64_t addr = 0;
-  const uint64_t size = 1024;
-  struct mem_link *node = mem_link_alloc(addr, size);
-
-  ASSERT_NE(node, nullptr);
+  uint64_t addr = 0;
 
   mem_alloc_init(&allocator);
 
-  allocator.allocated.prev = node;
-  allocator.allocated.next = node;
-  node->prev = &allocator.allocated;
-  node->next = &allocator.allocated;
+  ASSERT_EQ(mem_alloc_add_free(&allocator, 0, 1024), 0);
+  ASSERT_EQ(mem_alloc_get(&allocator, &addr, 1024), 0);
 
   EXPECT_NE(mem_alloc_put(&allocator, 4096), 0);
 
-  EXPECT_EQ(allocator.free.prev, &allocator.free);
-  EXPECT_EQ(allocator.free.next, &allocator.free);
+  EXPECT_EQ(allocator.free_by_addr, nullptr);
+  EXPECT_EQ(allocated_ranges(&allocator).size(), 1);
 
-  EXPECT_EQ(allocator.allocated.prev, node);
-  EXPECT_EQ(allocator.allocated.next, node);
-  EXPECT_EQ(node->prev, &allocator.allocated);
-  EXPECT_EQ(node->next, &allocator.allocated);
+  EXPECT_EQ(mem_alloc_put(&allocator, addr), 0);
+  EXPECT_NE(mem_alloc_put(&allocator, addr), 0);
+
+  mem_alloc_destroy(&allocator);
+}
+
+/**
+ * @test    random
+ * @brief   Test: mem_alloc_get(), mem_alloc_put()
+ * @details Under random allocate/free traffic, the trees<br>
+ *          stay balanced, allocations never overlap, and<br>
+ *          freeing everything restores the original range.
+ */
+TEST(mem_alloc, random)
+{
+  struct mem_alloc allocator;
+  std::vector<uint64_t> live;
+  std::vector<range> v;
+  const uint64_t base = 0x100000;
+  const uint64_t span = 1024ULL * 1024 * 1024;
+  int i;
+
+  srand(0);
+  mem_alloc_init(&allocator);
 
-  opae_free(node);
+  ASSERT_EQ(mem_alloc_add_free(&allocator, base, span), 0);
+
+  for (i = 0 ; i < 20000 ; ++i) {
+    if (live.empty() || (rand() % 3)) {
+      uint64_t size = 4096ULL << (rand() % 6);
+      uint64_t addr = 0;
+      if (!mem_alloc_get(&allocator, &addr, size)) {
+        EXPECT_EQ(addr % size, 0);
+        live.push_back(addr);
+      }
+    } else {
+      size_t j = rand() % live.size();
+      ASSERT_EQ(mem_alloc_put(&allocator, live[j]), 0);
+      live[j] = live.back();
+      live.pop_back();
+    }
+  }
+
+  EXPECT_GE(avl_height(allocator.free_by_addr), 0);
+  EXPECT_GE(avl_height(allocator.free_by_size), 0);
+  EXPECT_GE(avl_height(allocator.allocated), 0);
+
+  v = allocated_ranges(&allocator);
+  ASSERT_EQ(v.size(), live.size());
+  for (i = 1 ; i < (int)v.size() ; ++i)
+    EXPECT_LE(v[i - 1].address + v[i - 1].size, v[i].address);
+
+  for (uint64_t addr : live)
+    ASSERT_EQ(mem_alloc_put(&allocator, addr), 0);
+
+  v = free_ranges(&allocator);
+  ASSERT_EQ(v.size(), 1);
+  EXPECT_EQ(v[0].address, base);
+  EXPECT_EQ(v[0].size, span);
+
+  mem_alloc_destroy(&allocator);
 }
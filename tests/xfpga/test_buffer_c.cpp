@@ -249,6 +249,58 @@ TEST_P(buffer_prepare, not_aligned) {
   EXPECT_EQ(xfpga_fpgaReleaseBuffer(handle_, wsid), FPGA_OK);
 }
 
+/**
+ * @test       numa_node
+ *
+ * @brief      When a buffer was prepared, with or without
+ *             FPGA_BUF_NUMA_ANY, xfpga_fpgaGetBufferNumaNode reports
+ *             the node backing it, or -1 when the system has no NUMA
+ *             support. Unknown wsids give FPGA_NOT_FOUND.
+ *
+ */
+TEST_P(buffer_prepare, numa_node) {
+  void *buf_addr = nullptr;
+  uint64_t wsid = 0;
+  int node = -2;
+
+  ASSERT_EQ(xfpga_fpgaPrepareBuffer(handle_, KiB(4), &buf_addr, &wsid, 0),
+            FPGA_OK);
+  EXPECT_EQ(xfpga_fpgaGetBufferNumaNode(handle_, wsid, &node), FPGA_OK);
+  EXPECT_GE(node, -1);
+  EXPECT_EQ(xfpga_fpgaGetBufferNumaNode(handle_, wsid, nullptr),
+            FPGA_INVALID_PARAM);
+  EXPECT_EQ(xfpga_fpgaReleaseBuffer(handle_, wsid), FPGA_OK);
+
+  EXPECT_EQ(xfpga_fpgaGetBufferNumaNode(handle_, wsid, &node),
+            FPGA_NOT_FOUND);
+
+  node = -2;
+  buf_addr = nullptr;
+  ASSERT_EQ(xfpga_fpgaPrepareBuffer(handle_, KiB(4), &buf_addr, &wsid,
+                                    FPGA_BUF_NUMA_ANY), FPGA_OK);
+  EXPECT_EQ(xfpga_fpgaGetBufferNumaNode(handle_, wsid, &node), FPGA_OK);
+  EXPECT_GE(node, -1);
+  EXPECT_EQ(xfpga_fpgaReleaseBuffer(handle_, wsid), FPGA_OK);
+}
+
+/**
+ * @test       scatter_gather
+ *
+ * @brief      Given FPGA_BUF_SCATTER_GATHER, xfpga_fpgaPrepareBuffer
+ *             returns FPGA_NOT_SUPPORTED, because the port DMA map
+ *             can't place discontiguous pages behind one IOVA.
+ *
+ */
+TEST_P(buffer_prepare, scatter_gather) {
+  void *buf_addr = nullptr;
+  uint64_t wsid = 0;
+
+  EXPECT_EQ(xfpga_fpgaPrepareBuffer(handle_, MiB(4), &buf_addr, &wsid,
+                                    FPGA_BUF_SCATTER_GATHER),
+            FPGA_NOT_SUPPORTED);
+  EXPECT_EQ(buf_addr, nullptr);
+}
+
 /**
  * @test       write_read
  *
@@ -0,0 +1,124 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#define NO_OPAE_C
+#include "mock/opae_fixtures.h"
+KEEP_XFPGA_SYMBOLS
+
+extern "C" {
+int xfpga_plugin_initialize(void);
+int xfpga_plugin_finalize(void);
+}
+#include "xfpga.h"
+
+using namespace opae::testing;
+
+typedef std::chrono::steady_clock bench_clock;
+
+class enum_bench_c_p : public opae_base_p<xfpga_> {
+ protected:
+
+  virtual void OPAEInitialize() override
+  {
+    ASSERT_EQ(xfpga_plugin_initialize(), 0);
+  }
+
+  virtual void OPAEFinalize() override
+  {
+    ASSERT_EQ(xfpga_plugin_finalize(), 0);
+  }
+
+  // Average microseconds per enumeration of all tokens. When cold is
+  // true, the enumeration cache is dropped before each iteration.
+  double enumerate_us(bool cold, int iterations)
+  {
+    std::vector<fpga_token> tokens;
+    uint32_t matches = 0;
+
+    EXPECT_EQ(xfpga_fpgaEnumerate(nullptr, 0, nullptr, 0, &matches), FPGA_OK);
+    tokens.resize(matches, nullptr);
+
+    double total = 0.0;
+    for (int i = 0 ; i < iterations ; ++i) {
+      if (cold) {
+        EXPECT_EQ(xfpga_fpgaEnumerateRefresh(), FPGA_OK);
+      }
+
+      auto start = bench_clock::now();
+      EXPECT_EQ(xfpga_fpgaEnumerate(nullptr, 0,
+                                    tokens.data(), tokens.size(),
+                                    &matches), FPGA_OK);
+      total += std::chrono::duration<double, std::micro>(
+                   bench_clock::now() - start).count();
+
+      for (auto &t : tokens) {
+        if (t) {
+          EXPECT_EQ(xfpga_fpgaDestroyToken(&t), FPGA_OK);
+        }
+      }
+    }
+
+    return total / iterations;
+  }
+};
+
+/**
+ * @test       cold_warm
+ * @brief      Test: xfpga_fpgaEnumerate()
+ * @details    Compares the latency of enumerating all tokens after
+ *             xfpga_fpgaEnumerateRefresh() (a full sysfs scan) with
+ *             that of enumerating from the populated cache.<br>
+ */
+TEST_P(enum_bench_c_p, cold_warm) {
+  const int iterations = 200;
+
+  double cold = enumerate_us(true, iterations);
+  double warm = enumerate_us(false, iterations);
+
+  std::cout << std::fixed << std::setprecision(2)
+            << GetParam() << ": cold " << cold << " us"
+            << ", warm " << warm << " us"
+            << " (" << cold / warm << "x)" << std::endl;
+
+  EXPECT_LT(warm, cold);
+}
+
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(enum_bench_c_p);
+INSTANTIATE_TEST_SUITE_P(enum_bench_c, enum_bench_c_p,
+                         ::testing::ValuesIn(test_platform::platforms({
+                                                                        "dfl-n3000",
+                                                                        "dfl-d5005",
+                                                                        "dfl-n6000-sku0",
+                                                                        "dfl-n6000-sku1"
+                                                                      })));
@@ -1272,6 +1272,78 @@ TEST_P(enum_mock_only, remove_port) {
   EXPECT_EQ(fpgaDestroyProperties(&filterp), FPGA_OK);
 }
 
+/**
+ * @test       remove_port_refresh
+ *
+ * @brief      Given I have a system with at least one FPGA And I
+ *             enumerate with a filter of objtype of FPGA_ACCELERATOR
+ *             and I get one token for that accelerator
+ *             When I remove the port device from the system
+ *             And I call xfpga_fpgaEnumerateRefresh()
+ *             And I enumerate again with the same filter
+ *             Then I get zero tokens as the result.
+ *
+ */
+TEST_P(enum_mock_only, remove_port_refresh) {
+  fpga_properties filterp = NULL;
+
+  ASSERT_EQ(xfpga_fpgaGetProperties(NULL, &filterp), FPGA_OK);
+  EXPECT_EQ(fpgaPropertiesSetObjectType(filterp, FPGA_ACCELERATOR), FPGA_OK);
+  matches_ = 0;
+  EXPECT_EQ(xfpga_fpgaEnumerate(&filterp, 1,
+                                tokens_.data(), tokens_.size(),
+                                &matches_), FPGA_OK);
+  EXPECT_GE(matches_, 1);
+  DestroyTokens();
+  const char *sysfs_port = "/sys/class/fpga_region/region0/dfl-port.0";
+
+  EXPECT_EQ(system_->remove_sysfs_dir(sysfs_port), 0)
+      << "error removing dfl-port.0: " << strerror(errno);
+  EXPECT_EQ(xfpga_fpgaEnumerateRefresh(), FPGA_OK);
+  EXPECT_EQ(xfpga_fpgaEnumerate(&filterp, 1,
+                                tokens_.data(), tokens_.size(),
+                                &matches_), FPGA_OK);
+  EXPECT_EQ(matches_, 0);
+  EXPECT_EQ(fpgaDestroyProperties(&filterp), FPGA_OK);
+}
+
+/**
+ * @test       remove_port_uncached
+ *
+ * @brief      Given I have disabled the enumeration cache
+ *             And I enumerate with a filter of objtype of
+ *             FPGA_ACCELERATOR and I get one token for that accelerator
+ *             When I remove the port device from the system
+ *             And I enumerate again with the same filter
+ *             Then I get zero tokens as the result.
+ *
+ */
+TEST_P(enum_mock_only, remove_port_uncached) {
+  fpga_properties filterp = NULL;
+
+  setenv("LIBOPAE_ENUM_CACHE", "0", 1);
+  ASSERT_EQ(xfpga_plugin_initialize(), 0);
+  unsetenv("LIBOPAE_ENUM_CACHE");
+
+  ASSERT_EQ(xfpga_fpgaGetProperties(NULL, &filterp), FPGA_OK);
+  EXPECT_EQ(fpgaPropertiesSetObjectType(filterp, FPGA_ACCELERATOR), FPGA_OK);
+  matches_ = 0;
+  EXPECT_EQ(xfpga_fpgaEnumerate(&filterp, 1,
+                                tokens_.data(), tokens_.size(),
+                                &matches_), FPGA_OK);
+  EXPECT_GE(matches_, 1);
+  DestroyTokens();
+  const char *sysfs_port = "/sys/class/fpga_region/region0/dfl-port.0";
+
+  EXPECT_EQ(system_->remove_sysfs_dir(sysfs_port), 0)
+      << "error removing dfl-port.0: " << strerror(errno);
+  EXPECT_EQ(xfpga_fpgaEnumerate(&filterp, 1,
+                                tokens_.data(), tokens_.size(),
+                                &matches_), FPGA_OK);
+  EXPECT_EQ(matches_, 0);
+  EXPECT_EQ(fpgaDestroyProperties(&filterp), FPGA_OK);
+}
+
 GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(enum_mock_only);
 INSTANTIATE_TEST_SUITE_P(enum_c, enum_mock_only,
                          ::testing::ValuesIn(test_platform::mock_platforms({
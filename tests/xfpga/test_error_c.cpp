@@ -69,6 +69,9 @@ struct dev_list {
         struct dev_list *next;
         struct dev_list *parent;
         struct dev_list *fme;
+
+        struct error_list *errors = nullptr;
+        bool synced = false;
 };
 
 using namespace opae::testing;
@@ -0,0 +1,131 @@
+// Copyright(c) 2026, Intel Corporation
+//
+// Redistribution  and  use  in source  and  binary  forms,  with  or  without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of  source code  must retain the  above copyright notice,
+//   this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// * Neither the name  of Intel Corporation  nor the names of its contributors
+//   may be used to  endorse or promote  products derived  from this  software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+// IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT  SHALL THE COPYRIGHT OWNER  OR CONTRIBUTORS BE
+// LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR
+// CONSEQUENTIAL  DAMAGES  (INCLUDING,  BUT  NOT LIMITED  TO,  PROCUREMENT  OF
+// SUBSTITUTE GOODS OR SERVICES;  LOSS OF USE,  DATA, OR PROFITS;  OR BUSINESS
+// INTERRUPTION)  HOWEVER CAUSED  AND ON ANY THEORY  OF LIABILITY,  WHETHER IN
+// CONTRACT,  STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE  OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,  EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#define NO_OPAE_C
+#include "mock/opae_fixtures.h"
+KEEP_XFPGA_SYMBOLS
+
+extern "C" {
+#include "types_int.h"
+#include "metrics/metrics_int.h"
+#include "metrics/vector.h"
+
+int xfpga_plugin_initialize(void);
+int xfpga_plugin_finalize(void);
+}
+#include "xfpga.h"
+
+using namespace opae::testing;
+
+typedef std::chrono::steady_clock bench_clock;
+
+class metrics_bench_c_p : public opae_device_p<xfpga_> {
+ protected:
+
+  virtual void OPAEInitialize() override
+  {
+    ASSERT_EQ(xfpga_plugin_initialize(), 0);
+  }
+
+  virtual void OPAEFinalize() override
+  {
+    ASSERT_EQ(xfpga_plugin_finalize(), 0);
+  }
+
+  // Metrics per second when polling every metric by name, with the
+  // given snapshot TTL (nullptr leaves the snapshot disabled).
+  double metrics_per_sec(const char *ttl_ms, int iterations)
+  {
+    struct _fpga_handle *_handle = (struct _fpga_handle *)device_;
+    std::vector<fpga_metric_info> info;
+    std::vector<char *> names;
+    std::vector<fpga_metric> values;
+    uint64_t num_metrics = 0;
+
+    free_fpga_enum_metrics_vector(_handle);
+    if (ttl_ms)
+      EXPECT_EQ(setenv(METRICS_SNAPSHOT_TTL_ENV, ttl_ms, 1), 0);
+    else
+      unsetenv(METRICS_SNAPSHOT_TTL_ENV);
+
+    EXPECT_EQ(xfpga_fpgaGetNumMetrics(device_, &num_metrics), FPGA_OK);
+    info.resize(num_metrics);
+    EXPECT_EQ(xfpga_fpgaGetMetricsInfo(device_, info.data(), &num_metrics),
+              FPGA_OK);
+    for (auto &i : info)
+      names.push_back(i.metric_name);
+    values.resize(num_metrics);
+
+    auto start = bench_clock::now();
+    for (int i = 0 ; i < iterations ; ++i) {
+      EXPECT_EQ(xfpga_fpgaGetMetricsByName(device_, names.data(),
+                                           names.size(), values.data()),
+                FPGA_OK);
+    }
+    double secs = std::chrono::duration<double>(
+                      bench_clock::now() - start).count();
+
+    unsetenv(METRICS_SNAPSHOT_TTL_ENV);
+    free_fpga_enum_metrics_vector(_handle);
+
+    return (double)(num_metrics * iterations) / secs;
+  }
+};
+
+/**
+ * @test       by_name
+ * @brief      Test: xfpga_fpgaGetMetricsByName()
+ * @details    Compares the metrics per second of polling every
+ *             metric by name with a fresh read per query against
+ *             polling with a 1 second snapshot TTL.<br>
+ */
+TEST_P(metrics_bench_c_p, by_name) {
+  const int iterations = 200;
+
+  double fresh = metrics_per_sec(nullptr, iterations);
+  double cached = metrics_per_sec("1000", iterations);
+
+  std::cout << std::fixed << std::setprecision(0)
+            << GetParam() << ": fresh " << fresh << " metrics/s"
+            << ", snapshot " << cached << " metrics/s"
+            << std::setprecision(2)
+            << " (" << cached / fresh << "x)" << std::endl;
+
+  EXPECT_GT(cached, fresh);
+}
+
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(metrics_bench_c_p);
+INSTANTIATE_TEST_SUITE_P(metrics_bench_c, metrics_bench_c_p,
+                         ::testing::ValuesIn(test_platform::mock_platforms({"dcp-rc"})));
@@ -255,6 +255,99 @@ TEST_P(metrics_c_p, test_metric_04) {
   opae_free(metric_array_search);
 }
 
+/**
+* @test    test_metric_05
+* @brief   Tests: metric_snapshot_find_name
+* @details Validates that the hashed name index resolves every
+*          enumerated metric, regardless of case, to the same
+*          metric number as parse_metric_num_name.
+*
+*/
+TEST_P(metrics_c_p, test_metric_05) {
+  struct _fpga_handle *_handle = (struct _fpga_handle *)device_;
+  uint64_t num_metrics = 0;
+
+  ASSERT_EQ(FPGA_OK, xfpga_fpgaGetNumMetrics(device_, &num_metrics));
+  ASSERT_EQ(FPGA_OK, metric_snapshot_init(device_));
+  ASSERT_NE(nullptr, _handle->metric_snapshot);
+
+  for (uint64_t i = 0; i < num_metrics; ++i) {
+    struct _fpga_enum_metric *m = (struct _fpga_enum_metric *)
+        fpga_vector_get(&_handle->fpga_enum_metric_vector, i);
+    ASSERT_NE(nullptr, m);
+
+    uint64_t expected = 0;
+    uint64_t hashed = 0;
+    EXPECT_EQ(FPGA_OK, parse_metric_num_name(m->metric_name,
+                           &_handle->fpga_enum_metric_vector, &expected));
+    EXPECT_EQ(FPGA_OK, metric_snapshot_find_name(_handle, m->metric_name,
+                                                 &hashed));
+    EXPECT_EQ(expected, hashed);
+
+    std::string upper(m->metric_name);
+    for (auto &c : upper)
+      c = toupper(c);
+    EXPECT_EQ(FPGA_OK, metric_snapshot_find_name(_handle, upper.c_str(),
+                                                 &hashed));
+    EXPECT_EQ(expected, hashed);
+  }
+
+  uint64_t metric_num = 0;
+  EXPECT_EQ(FPGA_NOT_FOUND,
+            metric_snapshot_find_name(_handle, "no:such:metric", &metric_num));
+  EXPECT_EQ(FPGA_INVALID_PARAM,
+            metric_snapshot_find_name(_handle, NULL, &metric_num));
+
+  free_fpga_enum_metrics_vector(_handle);
+  EXPECT_EQ(nullptr, _handle->metric_snapshot);
+}
+
+/**
+* @test    test_metric_06
+* @brief   Tests: xfpga_fpgaGetMetricsByIndex
+* @details When LIBOPAE_METRICS_TTL_MS is set, the first query
+*          reads every metric into the snapshot and later queries
+*          within the TTL are served from it.
+*
+*/
+TEST_P(metrics_c_p, test_metric_06) {
+  struct _fpga_handle *_handle = (struct _fpga_handle *)device_;
+  uint64_t id_array[] = {1, 5, 30, 35, 10};
+  struct fpga_metric first[5];
+  struct fpga_metric second[5];
+
+  free_fpga_enum_metrics_vector(_handle);
+  ASSERT_EQ(0, setenv(METRICS_SNAPSHOT_TTL_ENV, "60000", 1));
+
+  memset(first, 0, sizeof(first));
+  EXPECT_EQ(FPGA_OK, xfpga_fpgaGetMetricsByIndex(device_, id_array, 5, first));
+
+  ASSERT_NE(nullptr, _handle->metric_snapshot);
+  EXPECT_NE(nullptr, _handle->metric_snapshot->samples);
+  EXPECT_TRUE(_handle->metric_snapshot->valid);
+  uint64_t timestamp = _handle->metric_snapshot->timestamp_nsec;
+
+  memset(second, 0, sizeof(second));
+  EXPECT_EQ(FPGA_OK, xfpga_fpgaGetMetricsByIndex(device_, id_array, 5, second));
+  EXPECT_EQ(timestamp, _handle->metric_snapshot->timestamp_nsec);
+
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(first[i].metric_num, second[i].metric_num);
+    EXPECT_EQ(first[i].isvalid, second[i].isvalid);
+    EXPECT_EQ(first[i].value.ivalue, second[i].value.ivalue);
+  }
+
+  // an expired snapshot is re-read on the next query
+  _handle->metric_snapshot->timestamp_nsec -=
+    _handle->metric_snapshot->ttl_nsec;
+  EXPECT_EQ(FPGA_OK, xfpga_fpgaGetMetricsByIndex(device_, id_array, 5, second));
+  EXPECT_NE(timestamp - _handle->metric_snapshot->ttl_nsec,
+            _handle->metric_snapshot->timestamp_nsec);
+
+  unsetenv(METRICS_SNAPSHOT_TTL_ENV);
+  free_fpga_enum_metrics_vector(_handle);
+}
+
 GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(metrics_c_p);
 INSTANTIATE_TEST_SUITE_P(metrics_c, metrics_c_p,
                          ::testing::ValuesIn(test_platform::mock_platforms({"dcp-rc"})));
@@ -178,6 +178,69 @@ TEST_P(sysobject_mock_p, xfpga_fpgaObjectRead) {
   EXPECT_EQ(xfpga_fpgaDestroyObject(&object), FPGA_OK);
 }
 
+/**
+ * @test       xfpga_fpgaObjectReadMany
+ * @brief      Test: xfpga_fpgaObjectReadMany, sync_object
+ * @details    A synced object keeps its file open and re-reads<br>
+ *             it in place, growing its buffer when the file<br>
+ *             outgrows it. Containers are rejected.<br>
+ */
+TEST_P(sysobject_mock_p, xfpga_fpgaObjectReadMany) {
+  _fpga_token *tk = static_cast<_fpga_token *>(device_token_);
+  std::string syspath(tk->sysfspath);
+  syspath += "/testdata";
+  auto fp = system_->register_file(syspath);
+  ASSERT_NE(fp, nullptr) << strerror(errno);
+  fputs("0x1\n", fp);
+  fflush(fp);
+
+  fpga_object object;
+  ASSERT_EQ(xfpga_fpgaTokenGetObject(device_token_, "testdata", &object, 0),
+            FPGA_OK);
+  _fpga_object *obj = static_cast<_fpga_object *>(object);
+  // Creating the object reads it without keeping the file open.
+  EXPECT_EQ(obj->fd, -1);
+
+  uint64_t value = 0;
+  EXPECT_EQ(xfpga_fpgaObjectReadMany(&object, &value, 1, FPGA_OBJECT_SYNC),
+            FPGA_OK);
+  EXPECT_EQ(value, 1);
+  int fd = obj->fd;
+  EXPECT_GE(fd, 0);
+
+  rewind(fp);
+  fputs("0x2\n", fp);
+  fflush(fp);
+  EXPECT_EQ(xfpga_fpgaObjectReadMany(&object, &value, 1, FPGA_OBJECT_SYNC),
+            FPGA_OK);
+  EXPECT_EQ(value, 2);
+  EXPECT_EQ(obj->fd, fd);
+
+  // Outgrow the minimum buffer size.
+  std::string big = "0x3\n" + std::string(1000, 'x');
+  rewind(fp);
+  fwrite(big.c_str(), big.size(), 1, fp);
+  fflush(fp);
+  opae_fclose(fp);
+  EXPECT_EQ(xfpga_fpgaObjectReadMany(&object, &value, 1, FPGA_OBJECT_SYNC),
+            FPGA_OK);
+  EXPECT_EQ(value, 3);
+  EXPECT_EQ(obj->size, big.size());
+
+  fpga_object group;
+  ASSERT_EQ(xfpga_fpgaTokenGetObject(device_token_, "errors", &group, 0),
+            FPGA_OK);
+  fpga_object objs[] = { object, group };
+  uint64_t values[2];
+  EXPECT_EQ(xfpga_fpgaObjectReadMany(objs, values, 2, 0), FPGA_INVALID_PARAM);
+  EXPECT_EQ(values[0], 3);
+
+  EXPECT_EQ(xfpga_fpgaObjectReadMany(nullptr, values, 2, 0),
+            FPGA_INVALID_PARAM);
+  EXPECT_EQ(xfpga_fpgaDestroyObject(&group), FPGA_OK);
+  EXPECT_EQ(xfpga_fpgaDestroyObject(&object), FPGA_OK);
+}
+
 TEST_P(sysobject_mock_p, xfpga_fpgaObjectWrite64) {
   _fpga_handle *h = static_cast<_fpga_handle *>(device_);
   _fpga_token *tok = static_cast<_fpga_token *>(h->token);